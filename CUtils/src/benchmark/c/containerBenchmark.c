@@ -0,0 +1,848 @@
+/*
+ * containerBenchmark.c
+ *
+ * Measure the core operations of the containers and of the graph algorithms of the library.
+ *
+ * Usage: ContainerBenchmark [-q] [-l] [-p] [-f filter] [-o prefix]
+ * 	-q only small sizes, useful to check the benchmark itself;
+ * 	-l run with 10 and 100 million items as well. Use it with -f: it requires several GB of memory;
+ * 	-p plot the results with gnuplot as well;
+ * 	-f run only the cases whose name contains the given string (e.g. "tree");
+ * 	-o prefix of the generated files (default "containerBenchmark");
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: koldar
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <string.h>
+#include <limits.h>
+#include "benchmark.h"
+#include "log.h"
+#include "macros.h"
+#include "errors.h"
+#include "defaultFunctions.h"
+#include "hashtable.h"
+#include "hash_set.h"
+#include "list.h"
+#include "heap.h"
+#include "priority_queue.h"
+#include "naive_queue.h"
+#include "radix_heap.h"
+#include "redBlackTree.h"
+#include "b_tree.h"
+#include "dynamic_stack.h"
+#include "predsuccgraph.h"
+#include "scc.h"
+#include "topologicalOrder.h"
+#include "multithreading.h"
+#include "oldPriorityQueue.h"
+#include "cutilsConfig.h"
+
+/**
+ * The state of a run: the container under test, the keys to use and what the measured code produces
+ */
+struct benchmark_state {
+	void* container;
+	///keys from 1 to size in random order
+	int* keys;
+	void* output;
+};
+
+typedef void (*container_destructor)(void* container);
+
+static int* generateKeys(int size);
+static struct benchmark_state* newState(int size, void* container);
+static void destroyState(struct benchmark_state* state, container_destructor destroyContainer);
+
+static int* generateKeys(int size) {
+	int* keys = malloc(sizeof(int) * size);
+	if (keys == NULL) {
+		ERROR_MALLOC();
+	}
+	for (int i=0; i<size; i++) {
+		keys[i] = i + 1;
+	}
+	//the same permutation is used by every run
+	unsigned int seed = size;
+	for (int i=size-1; i>0; i--) {
+		int j = rand_r(&seed) % (i + 1);
+		int tmp = keys[i];
+		keys[i] = keys[j];
+		keys[j] = tmp;
+	}
+	return keys;
+}
+
+static struct benchmark_state* newState(int size, void* container) {
+	struct benchmark_state* result = CU_MALLOC(struct benchmark_state);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+	result->container = container;
+	result->keys = generateKeys(size);
+	result->output = NULL;
+	return result;
+}
+
+static void destroyState(struct benchmark_state* state, container_destructor destroyContainer) {
+	destroyContainer(state->container);
+	CU_FREE(state->keys);
+	CU_FREE(state);
+}
+
+// ******************* HT *******************
+
+static void destroyHT(void* container) {
+	cuHTDestroy(container, NULL);
+}
+
+static void* setupEmptyHT(int size, const struct var_args* context) {
+	return newState(size, cuHTNew());
+}
+
+static void* setupFullHT(int size, const struct var_args* context) {
+	struct benchmark_state* state = setupEmptyHT(size, context);
+	for (int i=0; i<size; i++) {
+		cuHTAddItem(state->container, state->keys[i], CU_CAST_INT2PTR(i));
+	}
+	return state;
+}
+
+static void teardownHT(void* state, const struct var_args* context) {
+	destroyState(state, destroyHT);
+}
+
+static void runHTAdd(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	for (int i=0; i<size; i++) {
+		cuHTAddItem(state->container, state->keys[i], CU_CAST_INT2PTR(i));
+	}
+}
+
+static void runHTGet(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	volatile void* result;
+	for (int i=0; i<size; i++) {
+		result = cuHTGetItem(state->container, state->keys[i]);
+	}
+}
+
+static void runHTRemove(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	for (int i=0; i<size; i++) {
+		cuHTRemoveItem(state->container, state->keys[i]);
+	}
+}
+
+// ******************* HASH SET *******************
+
+static void destroyHashSet(void* container) {
+	cuHashSetDestroy(container, NULL);
+}
+
+static void* setupEmptyHashSet(int size, const struct var_args* context) {
+	return newState(size, cuHashSetNew(cuPayloadFunctionsIntValue()));
+}
+
+static void* setupFullHashSet(int size, const struct var_args* context) {
+	struct benchmark_state* state = setupEmptyHashSet(size, context);
+	for (int i=0; i<size; i++) {
+		cuHashSetAddItem(state->container, CU_CAST_INT2PTR(state->keys[i]));
+	}
+	return state;
+}
+
+static void teardownHashSet(void* state, const struct var_args* context) {
+	destroyState(state, destroyHashSet);
+}
+
+static void runHashSetAdd(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	for (int i=0; i<size; i++) {
+		cuHashSetAddItem(state->container, CU_CAST_INT2PTR(state->keys[i]));
+	}
+}
+
+static void runHashSetContains(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	volatile bool result;
+	for (int i=0; i<size; i++) {
+		result = cuHashSetContainsItem(state->container, CU_CAST_INT2PTR(state->keys[i]));
+	}
+}
+
+// ******************* LIST *******************
+
+static void destroyList(void* container) {
+	cuListDestroy(container, NULL);
+}
+
+static void* setupEmptyList(int size, const struct var_args* context) {
+	return newState(size, cuListNew(cuPayloadFunctionsIntValue()));
+}
+
+static void* setupFullList(int size, const struct var_args* context) {
+	struct benchmark_state* state = setupEmptyList(size, context);
+	for (int i=0; i<size; i++) {
+		cuListAddTail(state->container, CU_CAST_INT2PTR(state->keys[i]));
+	}
+	return state;
+}
+
+static void teardownList(void* state, const struct var_args* context) {
+	destroyState(state, destroyList);
+}
+
+static void runListAddTail(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	for (int i=0; i<size; i++) {
+		cuListAddTail(state->container, CU_CAST_INT2PTR(state->keys[i]));
+	}
+}
+
+static void runListPopHead(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	for (int i=0; i<size; i++) {
+		cuListPopFrom(state->container);
+	}
+}
+
+static void runListSort(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	cuListSort(state->container, CU_AS_ORDERER(cuDefaultFunctionsOrdererIntValue));
+}
+
+// ******************* HEAP *******************
+
+static void destroyHeap(void* container) {
+	cuHeapDestroy(container, NULL);
+}
+
+static void* setupEmptyHeap(int size, const struct var_args* context) {
+	return newState(size, cuHeapNew(CU_HEAP_UNBOUNDED, cuPayloadFunctionsIntValue()));
+}
+
+static void* setupFullHeap(int size, const struct var_args* context) {
+	struct benchmark_state* state = setupEmptyHeap(size, context);
+	for (int i=0; i<size; i++) {
+		cuHeapInsertItem(state->container, CU_CAST_INT2PTR(state->keys[i]));
+	}
+	return state;
+}
+
+static void teardownHeap(void* state, const struct var_args* context) {
+	destroyState(state, destroyHeap);
+}
+
+static void runHeapInsert(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	for (int i=0; i<size; i++) {
+		cuHeapInsertItem(state->container, CU_CAST_INT2PTR(state->keys[i]));
+	}
+}
+
+static void runHeapRemoveMin(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	for (int i=0; i<size; i++) {
+		cuHeapRemoveMinItem(state->container);
+	}
+}
+
+static void runHeapInsertItems(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	void** items = malloc(sizeof(void*) * size);
+	if (items == NULL) {
+		ERROR_MALLOC();
+	}
+	for (int i=0; i<size; i++) {
+		items[i] = CU_CAST_INT2PTR(state->keys[i]);
+	}
+	cuHeapInsertItems(state->container, items, size);
+	CU_FREE(items);
+}
+
+static void runHeapPopK(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	//the best 10% of the items
+	int k = size / 10 > 0 ? size / 10 : 1;
+	void** output = malloc(sizeof(void*) * k);
+	if (output == NULL) {
+		ERROR_MALLOC();
+	}
+	cuHeapPopK(state->container, k, output);
+	CU_FREE(output);
+}
+
+// ******************* PRIORITY QUEUE *******************
+
+static void destroyPriorityQueue(void* container) {
+	cuPriorityQueueDestroy(container, NULL);
+}
+
+static void* setupEmptyPriorityQueue(int size, const struct var_args* context) {
+	return newState(size, cuPriorityQueueNew(cuPayloadFunctionsIntValue()));
+}
+
+static void* setupFullPriorityQueue(int size, const struct var_args* context) {
+	struct benchmark_state* state = setupEmptyPriorityQueue(size, context);
+	for (int i=0; i<size; i++) {
+		cuPriorityQueueAddItem(state->container, CU_CAST_INT2PTR(state->keys[i]), state->keys[i]);
+	}
+	return state;
+}
+
+static void teardownPriorityQueue(void* state, const struct var_args* context) {
+	destroyState(state, destroyPriorityQueue);
+}
+
+static void runPriorityQueueAdd(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	for (int i=0; i<size; i++) {
+		cuPriorityQueueAddItem(state->container, CU_CAST_INT2PTR(state->keys[i]), state->keys[i]);
+	}
+}
+
+static void runPriorityQueuePop(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	for (int i=0; i<size; i++) {
+		_cuPriorityQueuePopItem(state->container);
+	}
+}
+
+// ******************* RED BLACK TREE *******************
+
+static void destroyRedBlackTree(void* container) {
+	cuRedBlackTreeDestroy(container, NULL);
+}
+
+static void* setupEmptyRedBlackTree(int size, const struct var_args* context) {
+	return newState(size, cuRedBlackTreeNew(cuPayloadFunctionsIntValue()));
+}
+
+static void* setupFullRedBlackTree(int size, const struct var_args* context) {
+	struct benchmark_state* state = setupEmptyRedBlackTree(size, context);
+	for (int i=0; i<size; i++) {
+		cuRedBlackTreeAddItem(state->container, CU_CAST_INT2PTR(state->keys[i]));
+	}
+	return state;
+}
+
+static void teardownRedBlackTree(void* state, const struct var_args* context) {
+	destroyState(state, destroyRedBlackTree);
+}
+
+static void runRedBlackTreeAdd(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	for (int i=0; i<size; i++) {
+		cuRedBlackTreeAddItem(state->container, CU_CAST_INT2PTR(state->keys[i]));
+	}
+}
+
+static void runRedBlackTreeContains(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	volatile bool result;
+	for (int i=0; i<size; i++) {
+		result = cuRedBlackTreeContainsItem(state->container, CU_CAST_INT2PTR(state->keys[i]));
+	}
+}
+
+static void runRedBlackTreeRemove(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	for (int i=0; i<size; i++) {
+		cuRedBlackTreeRemoveItem(state->container, CU_CAST_INT2PTR(state->keys[i]));
+	}
+}
+
+// ******************* B TREE *******************
+
+static void destroyBTree(void* container) {
+	cuBTreeDestroy(container, NULL);
+}
+
+static void* setupEmptyBTree(int size, const struct var_args* context) {
+	return newState(size, cuBTreeNew(cuPayloadFunctionsIntValue()));
+}
+
+static void* setupFullBTree(int size, const struct var_args* context) {
+	struct benchmark_state* state = setupEmptyBTree(size, context);
+	for (int i=0; i<size; i++) {
+		cuBTreeAddItem(state->container, CU_CAST_INT2PTR(state->keys[i]));
+	}
+	return state;
+}
+
+static void teardownBTree(void* state, const struct var_args* context) {
+	destroyState(state, destroyBTree);
+}
+
+static void runBTreeAdd(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	for (int i=0; i<size; i++) {
+		cuBTreeAddItem(state->container, CU_CAST_INT2PTR(state->keys[i]));
+	}
+}
+
+static void runBTreeContains(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	volatile bool result;
+	for (int i=0; i<size; i++) {
+		result = cuBTreeContainsItem(state->container, CU_CAST_INT2PTR(state->keys[i]));
+	}
+}
+
+static void runBTreeRemove(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	for (int i=0; i<size; i++) {
+		cuBTreeRemoveItem(state->container, CU_CAST_INT2PTR(state->keys[i]));
+	}
+}
+
+static void runBTreeScan(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	volatile long sum = 0;
+	CU_ITERATE_OVER_BTREE(state->container, item, void*) {
+		sum += CU_CAST_PTR2INT(item);
+	}
+}
+
+static void runBTreeBulkLoad(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	//the keys are a permutation of 1..size
+	void** items = malloc(sizeof(void*) * size);
+	if (items == NULL) {
+		ERROR_MALLOC();
+	}
+	for (int i=0; i<size; i++) {
+		items[i] = CU_CAST_INT2PTR(i + 1);
+	}
+	cuBTreeBulkLoad(state->container, items, size);
+	CU_FREE(items);
+}
+
+// ******************* DYNAMIC STACK *******************
+
+static void destroyDynamicStack(void* container) {
+	cuDynamicStackDestroy(container, NULL);
+}
+
+static void* setupEmptyDynamicStack(int size, const struct var_args* context) {
+	return newState(size, cuDynamicStackNew(16, 16, cuPayloadFunctionsIntValue()));
+}
+
+static void* setupFullDynamicStack(int size, const struct var_args* context) {
+	struct benchmark_state* state = setupEmptyDynamicStack(size, context);
+	for (int i=0; i<size; i++) {
+		cuDynamicStackPushItem(state->container, CU_CAST_INT2PTR(state->keys[i]));
+	}
+	return state;
+}
+
+static void teardownDynamicStack(void* state, const struct var_args* context) {
+	destroyState(state, destroyDynamicStack);
+}
+
+static void runDynamicStackPush(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	for (int i=0; i<size; i++) {
+		cuDynamicStackPushItem(state->container, CU_CAST_INT2PTR(state->keys[i]));
+	}
+}
+
+static void runDynamicStackPop(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	for (int i=0; i<size; i++) {
+		cuDynamicStackPopItem(state->container);
+	}
+}
+
+// ******************* SHORTEST PATHS *******************
+
+/**
+ * number of outgoing edges of each vertex of the graphs used by the shortest path cases
+ */
+#define SHORTEST_PATH_DEGREE 4
+/**
+ * the weights of the edges of the graphs used by the shortest path cases are in [1, SHORTEST_PATH_MAX_WEIGHT]
+ */
+#define SHORTEST_PATH_MAX_WEIGHT 100
+
+/**
+ * A random graph stored as adjacency arrays, where we compute the distances from vertex 0
+ */
+struct shortest_path_state {
+	int size;
+	///the successors of vertex @c i are in cells [i*SHORTEST_PATH_DEGREE, (i+1)*SHORTEST_PATH_DEGREE)
+	int* targets;
+	int* weights;
+	int* distances;
+	bool* closed;
+};
+
+/**
+ * used by the ::naive_queue to compute the priority of a vertex
+ */
+static int evaluateVertexDistance(const void* vertex, const struct var_args* context) {
+	const struct shortest_path_state* state = cuVarArgsGetItem(context, 0, struct shortest_path_state*);
+	return state->distances[CU_CAST_PTR2INT(vertex)];
+}
+
+static void* setupShortestPath(int size, const struct var_args* context) {
+	struct shortest_path_state* state = CU_MALLOC(struct shortest_path_state);
+	if (state == NULL) {
+		ERROR_MALLOC();
+	}
+	state->size = size;
+	state->targets = malloc(sizeof(int) * size * SHORTEST_PATH_DEGREE);
+	state->weights = malloc(sizeof(int) * size * SHORTEST_PATH_DEGREE);
+	state->distances = malloc(sizeof(int) * size);
+	state->closed = malloc(sizeof(bool) * size);
+	if (state->targets == NULL || state->weights == NULL || state->distances == NULL || state->closed == NULL) {
+		ERROR_MALLOC();
+	}
+	unsigned int seed = size;
+	for (int i=0; i<size; i++) {
+		//the first edge makes every vertex reachable from 0
+		state->targets[i * SHORTEST_PATH_DEGREE] = (i + 1) % size;
+		state->weights[i * SHORTEST_PATH_DEGREE] = 1 + rand_r(&seed) % SHORTEST_PATH_MAX_WEIGHT;
+		for (int j=1; j<SHORTEST_PATH_DEGREE; j++) {
+			state->targets[i * SHORTEST_PATH_DEGREE + j] = rand_r(&seed) % size;
+			state->weights[i * SHORTEST_PATH_DEGREE + j] = 1 + rand_r(&seed) % SHORTEST_PATH_MAX_WEIGHT;
+		}
+		state->distances[i] = INT_MAX;
+		state->closed[i] = false;
+	}
+	state->distances[0] = 0;
+	return state;
+}
+
+static void teardownShortestPath(void* s, const struct var_args* context) {
+	struct shortest_path_state* state = s;
+	CU_FREE(state->targets);
+	CU_FREE(state->weights);
+	CU_FREE(state->distances);
+	CU_FREE(state->closed);
+	CU_FREE(state);
+}
+
+/**
+ * Dijkstra's algorithm with lazy deletion: a vertex is added every time its distance improves and
+ * the stale copies are ignored when they are popped
+ */
+#define DIJKSTRA(state, addVertex, isEmpty, popVertex) \
+	addVertex(0); \
+	while (!(isEmpty)) { \
+		int vertex = (popVertex); \
+		if (state->closed[vertex]) { \
+			continue; \
+		} \
+		state->closed[vertex] = true; \
+		for (int j=vertex*SHORTEST_PATH_DEGREE; j<(vertex+1)*SHORTEST_PATH_DEGREE; j++) { \
+			int target = state->targets[j]; \
+			int distance = state->distances[vertex] + state->weights[j]; \
+			if (distance < state->distances[target]) { \
+				state->distances[target] = distance; \
+				addVertex(target); \
+			} \
+		} \
+	}
+
+static void runShortestPathNaiveQueue(void* s, int size, const struct var_args* context) {
+	struct shortest_path_state* state = s;
+	cuInitVarArgsOnStack(va, state);
+	naive_queue* q = cuNaiveQueueNew(cuPayloadFunctionsIntValue(), evaluateVertexDistance, va);
+#	define ADD_VERTEX(v) cuNaiveQueueAddItem(q, CU_CAST_INT2PTR(v))
+	DIJKSTRA(state, ADD_VERTEX, cuNaiveQueueIsEmpty(q), CU_CAST_PTR2INT(cuNaiveQueuePopItem(q, void*)));
+#	undef ADD_VERTEX
+	cuNaiveQueueDestroy(q, NULL);
+}
+
+static void runShortestPathPriorityQueue(void* s, int size, const struct var_args* context) {
+	struct shortest_path_state* state = s;
+	priority_queue* q = cuPriorityQueueNew(cuPayloadFunctionsIntValue());
+#	define ADD_VERTEX(v) cuPriorityQueueAddItem(q, CU_CAST_INT2PTR(v), state->distances[v])
+	DIJKSTRA(state, ADD_VERTEX, cuPriorityQueueIsEmpty(q), CU_CAST_PTR2INT(_cuPriorityQueuePopItem(q)));
+#	undef ADD_VERTEX
+	cuPriorityQueueDestroy(q, NULL);
+}
+
+static void runShortestPathRadixHeap(void* s, int size, const struct var_args* context) {
+	struct shortest_path_state* state = s;
+	radix_heap* q = cuRadixHeapNew(cuPayloadFunctionsIntValue());
+#	define ADD_VERTEX(v) cuRadixHeapAddItemWithEvaluation(q, CU_CAST_INT2PTR(v), state->distances[v])
+	DIJKSTRA(state, ADD_VERTEX, cuRadixHeapIsEmpty(q), CU_CAST_PTR2INT(cuRadixHeapPopItem(q, void*)));
+#	undef ADD_VERTEX
+	cuRadixHeapDestroy(q, NULL);
+}
+
+/**
+ * Dijkstra's algorithm changing the priority of the queued vertices whose distance improves. The algorithm stops after
+ * @c operations queue operations (adds, pops and priority changes)
+ */
+#define DIJKSTRA_DECREASE_KEY(state, operations, addVertex, decreaseVertex, isEmpty, popVertex) { \
+	int done = 1; \
+	addVertex(0); \
+	while (done < (operations) && !(isEmpty)) { \
+		int vertex = (popVertex); \
+		done++; \
+		state->closed[vertex] = true; \
+		for (int j=vertex*SHORTEST_PATH_DEGREE; j<(vertex+1)*SHORTEST_PATH_DEGREE && done < (operations); j++) { \
+			int target = state->targets[j]; \
+			int distance = state->distances[vertex] + state->weights[j]; \
+			if (distance < state->distances[target]) { \
+				bool queued = state->distances[target] != INT_MAX; \
+				state->distances[target] = distance; \
+				if (queued) { \
+					decreaseVertex(target); \
+				} else { \
+					addVertex(target); \
+				} \
+				done++; \
+			} \
+		} \
+	} \
+}
+
+/**
+ * A graph for ::DIJKSTRA_DECREASE_KEY which needs @c size queue operations
+ *
+ * Every vertex is added and popped once, so with @c size/2 + 1 vertices the queue never empties before @c size operations
+ */
+static void* setupDecreaseKeyShortestPath(int size, const struct var_args* context) {
+	return setupShortestPath(size / 2 + 1, context);
+}
+
+static void runDecreaseKeyPriorityQueue(void* s, int size, const struct var_args* context) {
+	struct shortest_path_state* state = s;
+	priority_queue* q = cuPriorityQueueNew(cuPayloadFunctionsIntValue());
+#	define ADD_VERTEX(v) cuPriorityQueueAddItem(q, CU_CAST_INT2PTR(v), state->distances[v])
+#	define DECREASE_VERTEX(v) cuPriorityQueueChangePriority(q, CU_CAST_INT2PTR(v), state->distances[v])
+	DIJKSTRA_DECREASE_KEY(state, size, ADD_VERTEX, DECREASE_VERTEX, cuPriorityQueueIsEmpty(q), CU_CAST_PTR2INT(_cuPriorityQueuePopItem(q)));
+#	undef ADD_VERTEX
+#	undef DECREASE_VERTEX
+	cuPriorityQueueDestroy(q, NULL);
+}
+
+/**
+ * The old queue needed the user to find the cell of an item: like a user would, we keep the cell of each vertex in an array
+ */
+static void runDecreaseKeyOldPriorityQueue(void* s, int size, const struct var_args* context) {
+	struct shortest_path_state* state = s;
+	old_priority_queue* q = oldPriorityQueueNew();
+	old_priority_queue_cell** cells = malloc(sizeof(old_priority_queue_cell*) * state->size);
+	if (cells == NULL) {
+		ERROR_MALLOC();
+	}
+#	define ADD_VERTEX(v) cells[v] = oldPriorityQueueAddItem(q, CU_CAST_INT2PTR(v), state->distances[v])
+#	define DECREASE_VERTEX(v) oldPriorityQueueChangePriority(q, cells[v], state->distances[v])
+	DIJKSTRA_DECREASE_KEY(state, size, ADD_VERTEX, DECREASE_VERTEX, oldPriorityQueueIsEmpty(q), CU_CAST_PTR2INT(oldPriorityQueuePopItem(q)));
+#	undef ADD_VERTEX
+#	undef DECREASE_VERTEX
+	CU_FREE(cells);
+	oldPriorityQueueDestroy(q);
+}
+
+// ******************* GRAPHS *******************
+
+static void destroyGraph(void* container) {
+	cuPredSuccGraphDestroyWithElements(container, NULL);
+}
+
+/**
+ * A graph with @c size vertices and about 3 outgoing edges per vertex
+ *
+ * @param[in] acyclic if true the edges go only from a vertex to vertices with a greater id
+ */
+static struct benchmark_state* setupGraph(int size, bool acyclic) {
+	struct benchmark_state* state = newState(size, cuPredSuccGraphNew());
+	for (int i=0; i<size; i++) {
+		cuPredSuccGraphAddNodeInGraphById(state->container, i, NULL);
+	}
+	for (int i=0; i<size; i++) {
+		//keys are a permutation of 1..size
+		int targets[3] = {i + 1, state->keys[i] - 1, (i + state->keys[i]) % size};
+		for (int j=0; j<3; j++) {
+			int target = targets[j];
+			if (target >= size || target == i || (acyclic && target < i)) {
+				continue;
+			}
+			if (cuPredSuccGraphGetEdgeInGraph(state->container, i, target) == NULL) {
+				cuPredSuccGraphAddEdge(state->container, i, target, NULL);
+			}
+		}
+	}
+	return state;
+}
+
+static void* setupCyclicGraph(int size, const struct var_args* context) {
+	return setupGraph(size, false);
+}
+
+static void* setupAcyclicGraph(int size, const struct var_args* context) {
+	return setupGraph(size, true);
+}
+
+static void runSCC(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	state->output = cuStronglyConnectedComponentsGraphNew(state->container, edge_traverser_alwaysAccept, false, NULL);
+}
+
+static void runIterativeSCC(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	state->output = cuStronglyConnectedComponentsGraphNew(state->container, edge_traverser_alwaysAccept, false, NULL, SCC_ITERATIVE_TARJAN);
+}
+
+/**
+ * @param[in] context the ::cu_parallel_thread_pool computing the sccs
+ */
+static void runParallelSCC(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	cu_parallel_thread_pool* pool = cuVarArgsGetItem(context, 0, cu_parallel_thread_pool*);
+	state->output = cuStronglyConnectedComponentsGraphNew(state->container, edge_traverser_alwaysAccept, false, NULL, SCC_PARALLEL, pool);
+}
+
+static void teardownSCC(void* s, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	cuStronglyConnectedComponentsGraphDestroy(state->output, NULL);
+	destroyState(state, destroyGraph);
+}
+
+static void runTopologicalOrder(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	state->output = cuListNew();
+	cuStaticTopologicalOrderDoWith(TO_CORMEN, state->container, state->output);
+}
+
+static void runKahnTopologicalOrder(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	state->output = cuListNew();
+	cuStaticTopologicalOrderDoWith(TO_KAHN, state->container, state->output);
+}
+
+/**
+ * @param[in] context the ::cu_parallel_thread_pool computing the levels
+ */
+static void runParallelLevelsTopologicalOrder(void* s, int size, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	cu_parallel_thread_pool* pool = cuVarArgsGetItem(context, 0, cu_parallel_thread_pool*);
+	state->output = cuListNew();
+	cuStaticTopologicalOrderDoWith(TO_PARALLEL_LEVELS, state->container, state->output, pool);
+}
+
+static void teardownTopologicalOrder(void* s, const struct var_args* context) {
+	struct benchmark_state* state = s;
+	cuListDestroy(state->output, NULL);
+	destroyState(state, destroyGraph);
+}
+
+/**
+ * A case of the benchmark
+ */
+struct benchmark_case {
+	const char* name;
+	cu_benchmark_setup setup;
+	cu_benchmark_function function;
+	cu_benchmark_teardown teardown;
+	///the biggest size the case is run with. 0 means no limit
+	int maxSize;
+};
+
+static const struct benchmark_case cases[] = {
+		{"HT add", setupEmptyHT, runHTAdd, teardownHT, 0},
+		{"HT get", setupFullHT, runHTGet, teardownHT, 0},
+		{"HT remove", setupFullHT, runHTRemove, teardownHT, 0},
+		{"hash_set add", setupEmptyHashSet, runHashSetAdd, teardownHashSet, 0},
+		{"hash_set contains", setupFullHashSet, runHashSetContains, teardownHashSet, 0},
+		{"list add tail", setupEmptyList, runListAddTail, teardownList, 0},
+		{"list pop head", setupFullList, runListPopHead, teardownList, 0},
+		{"list sort", setupFullList, runListSort, teardownList, 0},
+		{"heap insert", setupEmptyHeap, runHeapInsert, teardownHeap, 0},
+		{"heap insert items", setupEmptyHeap, runHeapInsertItems, teardownHeap, 0},
+		{"heap remove min", setupFullHeap, runHeapRemoveMin, teardownHeap, 0},
+		{"heap pop k", setupFullHeap, runHeapPopK, teardownHeap, 0},
+		{"priority_queue add", setupEmptyPriorityQueue, runPriorityQueueAdd, teardownPriorityQueue, 0},
+		{"priority_queue pop", setupFullPriorityQueue, runPriorityQueuePop, teardownPriorityQueue, 0},
+		{"rb_tree add", setupEmptyRedBlackTree, runRedBlackTreeAdd, teardownRedBlackTree, 0},
+		{"rb_tree contains", setupFullRedBlackTree, runRedBlackTreeContains, teardownRedBlackTree, 0},
+		{"rb_tree remove", setupFullRedBlackTree, runRedBlackTreeRemove, teardownRedBlackTree, 0},
+		{"b_tree add", setupEmptyBTree, runBTreeAdd, teardownBTree, 0},
+		{"b_tree contains", setupFullBTree, runBTreeContains, teardownBTree, 0},
+		{"b_tree remove", setupFullBTree, runBTreeRemove, teardownBTree, 0},
+		{"b_tree scan", setupFullBTree, runBTreeScan, teardownBTree, 0},
+		{"b_tree bulk load", setupEmptyBTree, runBTreeBulkLoad, teardownBTree, 0},
+		{"dynamic_stack push", setupEmptyDynamicStack, runDynamicStackPush, teardownDynamicStack, 0},
+		{"dynamic_stack pop", setupFullDynamicStack, runDynamicStackPop, teardownDynamicStack, 0},
+		//the naive queue looks for the insertion point linearly, so it is quadratic
+		{"dijkstra naive_queue", setupShortestPath, runShortestPathNaiveQueue, teardownShortestPath, 10000},
+		{"dijkstra priority_queue", setupShortestPath, runShortestPathPriorityQueue, teardownShortestPath, 0},
+		{"dijkstra radix_heap", setupShortestPath, runShortestPathRadixHeap, teardownShortestPath, 0},
+		//the size is the number of queue operations: with -l they stop at 10 million operations
+		{"dijkstra decrease-key priority_queue", setupDecreaseKeyShortestPath, runDecreaseKeyPriorityQueue, teardownShortestPath, 10000000},
+		{"dijkstra decrease-key old priority_queue", setupDecreaseKeyShortestPath, runDecreaseKeyOldPriorityQueue, teardownShortestPath, 10000000},
+		//both algorithms support graphs with less than CUTILS_ARRAY_SIZE vertices
+		{"scc", setupCyclicGraph, runSCC, teardownSCC, CUTILS_ARRAY_SIZE - 1},
+		{"scc iterative tarjan", setupCyclicGraph, runIterativeSCC, teardownSCC, 0},
+		{"scc parallel", setupCyclicGraph, runParallelSCC, teardownSCC, 0},
+		{"topological order", setupAcyclicGraph, runTopologicalOrder, teardownTopologicalOrder, CUTILS_ARRAY_SIZE - 1},
+		{"topological order kahn", setupAcyclicGraph, runKahnTopologicalOrder, teardownTopologicalOrder, 0},
+		{"topological order parallel levels", setupAcyclicGraph, runParallelLevelsTopologicalOrder, teardownTopologicalOrder, 0},
+};
+
+int main(int argc, char* argv[]) {
+	bool quick = false;
+	bool large = false;
+	bool plot = false;
+	const char* filter = NULL;
+	const char* prefix = "containerBenchmark";
+	int option;
+
+	while ((option = getopt(argc, argv, "qlpf:o:")) != -1) {
+		switch (option) {
+		case 'q': quick = true; break;
+		case 'l': large = true; break;
+		case 'p': plot = true; break;
+		case 'f': filter = optarg; break;
+		case 'o': prefix = optarg; break;
+		default:
+			fprintf(stderr, "Usage: %s [-q] [-l] [-p] [-f filter] [-o prefix]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	const int casesNumber = sizeof(cases) / sizeof(cases[0]);
+	const int sizes[] = {100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+	const int sizesNumber = quick ? 3 : (large ? 7 : 5);
+	char buffer[200];
+
+	setLevel(LOG_WARNING);
+	//the parallel cases share a worker for each online core
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(0);
+	cuInitVarArgsOnStack(context, pool);
+	cu_benchmark* b = cuBenchmarkNew("containers", quick ? 1 : 3, quick ? 3 : 10);
+	for (int c=0; c<casesNumber; c++) {
+		if (filter != NULL && strstr(cases[c].name, filter) == NULL) {
+			continue;
+		}
+		for (int s=0; s<sizesNumber; s++) {
+			if (cases[c].maxSize > 0 && sizes[s] > cases[c].maxSize) {
+				continue;
+			}
+			const cu_benchmark_result* r = cuBenchmarkRun(b, cases[c].name, sizes[s], cases[c].setup, cases[c].function, cases[c].teardown, context);
+			fprintf(stderr, "%s with %d items: %.3f ms\n", r->caseName, r->size, r->average / 1e6);
+		}
+	}
+
+	cuBenchmarkPrint(b, stdout);
+	snprintf(buffer, 200, "%s.csv", prefix);
+	cuBenchmarkSaveCSV(b, buffer);
+	if (plot) {
+		cuBenchmarkPlot(b, prefix);
+	}
+	cuBenchmarkDestroy(b, NULL);
+	cuParallelThreadPoolDestroy(pool, NULL);
+
+	return 0;
+}
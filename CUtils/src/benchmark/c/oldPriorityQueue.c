@@ -0,0 +1,283 @@
+/*
+ * oldPriorityQueue.c
+ *
+ * The pointer based priority queue, as it was before ::priority_queue moved to an array.
+ * The only change is the removal of the dot dump of the heap at every swap of percolateUp.
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: koldar
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include "oldPriorityQueue.h"
+#include "errors.h"
+
+// a queue is implemented as an infinite heap
+
+struct old_priority_queue_cell {
+	void* payload;
+	int priority;
+
+	struct old_priority_queue_cell* parent;
+	struct old_priority_queue_cell* left;
+	struct old_priority_queue_cell* right;
+};
+
+struct old_priority_queue {
+	struct old_priority_queue_cell* min;
+	int size;
+	int nextCellAvailable;
+};
+
+static void gotoCellWithId(CU_NOTNULL const old_priority_queue* q, int idToRead, CU_NOTNULL struct old_priority_queue_cell** pointerOfCellReached, CU_NOTNULL struct old_priority_queue_cell** pointerOfParentCell, CU_NOTNULL struct old_priority_queue_cell*** pointerOfParentReachingNode);
+static void swapQueueCells(CU_NOTNULL old_priority_queue* q, CU_NOTNULL struct old_priority_queue_cell* a, CU_NOTNULL struct old_priority_queue_cell* b);
+static void percolateUp(CU_NOTNULL old_priority_queue* q, CU_NOTNULL struct old_priority_queue_cell* qc);
+static void percolateDown(CU_NOTNULL old_priority_queue* q, CU_NOTNULL struct old_priority_queue_cell* qc);
+static void clearQueue(CU_NULLABLE const struct old_priority_queue_cell* qc);
+
+CU_NOTNULL old_priority_queue* oldPriorityQueueNew() {
+	old_priority_queue* result = CU_MALLOC(old_priority_queue);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+
+	result->min = NULL;
+	result->size = 0;
+	result->nextCellAvailable = 1;
+
+	return result;
+}
+
+void oldPriorityQueueDestroy(CU_NOTNULL const old_priority_queue* q) {
+	clearQueue(q->min);
+	CU_FREE(q);
+}
+
+CU_NOTNULL old_priority_queue_cell* oldPriorityQueueAddItem(CU_NOTNULL old_priority_queue* q, CU_NULLABLE const void* data, int priority) {
+	struct old_priority_queue_cell* qc = NULL;
+	struct old_priority_queue_cell* parent = NULL;
+	struct old_priority_queue_cell** parentPointer = NULL;
+
+	//we do that now because gotoCellWithId needs that
+	q->size += 1;
+
+	//the new payload is positioned on the last leaf
+	gotoCellWithId(q, q->nextCellAvailable, &qc, &parent, &parentPointer);
+
+	qc = CU_MALLOC(struct old_priority_queue_cell);
+	if (qc == NULL) {
+		ERROR_MALLOC();
+	}
+	*parentPointer = qc;
+	qc->payload = (void*)data;
+	qc->priority = priority;
+	qc->parent = parent;
+	qc->left = NULL;
+	qc->right = NULL;
+
+	q->nextCellAvailable += 1;
+
+	percolateUp(q, qc);
+
+	return qc;
+}
+
+CU_NULLABLE void* oldPriorityQueuePopItem(CU_NOTNULL old_priority_queue* q) {
+	if (oldPriorityQueueIsEmpty(q)) {
+		ERROR_OBJECT_IS_EMPTY("queue", "%p", q);
+	}
+
+	q->size -= 1;
+	q->nextCellAvailable -= 1;
+	struct old_priority_queue_cell* oldMin = q->min;
+	void* retVal = oldMin->payload;
+
+	//remember: we have just decreased size by 1!
+	if (q->size == 0) {
+		CU_FREE(oldMin);
+		q->min = NULL;
+		return retVal;
+	}
+
+	struct old_priority_queue_cell* qc;
+	struct old_priority_queue_cell* parent;
+	struct old_priority_queue_cell** pointerOfParent;
+
+	//move the last leaf on the top of the heap, then detach the old top (which is now the last leaf)
+	gotoCellWithId(q, q->nextCellAvailable, &qc, &parent, &pointerOfParent);
+	swapQueueCells(q, oldMin, qc);
+	if (oldMin->parent->left == oldMin) {
+		oldMin->parent->left = NULL;
+	} else {
+		oldMin->parent->right = NULL;
+	}
+	CU_FREE(oldMin);
+
+	percolateDown(q, q->min);
+
+	return retVal;
+}
+
+bool oldPriorityQueueIsEmpty(CU_NOTNULL const old_priority_queue* q) {
+	return q->size == 0;
+}
+
+void oldPriorityQueueChangePriority(CU_NOTNULL old_priority_queue* q, CU_NOTNULL old_priority_queue_cell* qc, int newPriority) {
+	int oldPriority = qc->priority;
+	qc->priority = newPriority;
+
+	if (oldPriority > newPriority) {
+		//this is a minheap: the item may go towards the root
+		percolateUp(q, qc);
+	} else if (oldPriority < newPriority) {
+		percolateDown(q, qc);
+	}
+}
+
+/**
+ * Reach the cell with the given id. The root has id 1 and the children of the cell @c i have ids @c 2i and @c 2i+1
+ *
+ * At level i, all the nodes in the left branch have the i-th bit (counting from the right) set to 0,
+ * all the nodes in the right branch have it set to 1
+ */
+static void gotoCellWithId(CU_NOTNULL const old_priority_queue* q, int idToRead, CU_NOTNULL struct old_priority_queue_cell** pointerOfCellReached, CU_NOTNULL struct old_priority_queue_cell** pointerOfParentCell, CU_NOTNULL struct old_priority_queue_cell*** pointerOfParentReachingNode) {
+	int qcId = 1;
+	struct old_priority_queue_cell* const* parentPointer = &q->min;
+	const struct old_priority_queue_cell* qc = q->min;
+	int level = 0;
+	int size = (int) floor(log2(idToRead));
+
+	*pointerOfParentCell = NULL;
+
+	while (qcId != idToRead) {
+		*pointerOfParentCell = (struct old_priority_queue_cell*)qc;
+		if ((idToRead & (1 << (size - level - 1))) > 0) {
+			parentPointer = &qc->right;
+			qc = qc->right;
+			qcId = 2 * qcId + 1;
+		} else {
+			parentPointer = &qc->left;
+			qc = qc->left;
+			qcId = 2 * qcId + 0;
+		}
+		level++;
+	}
+	*pointerOfCellReached = (struct old_priority_queue_cell*)qc;
+	*pointerOfParentReachingNode = (struct old_priority_queue_cell**)parentPointer;
+}
+
+static void clearQueue(CU_NULLABLE const struct old_priority_queue_cell* qc) {
+	if (qc == NULL) {
+		return;
+	}
+	clearQueue(qc->left);
+	clearQueue(qc->right);
+	CU_FREE(qc);
+}
+
+static CU_NULLABLE struct old_priority_queue_cell** getQueueCellPtr(CU_NOTNULL const struct old_priority_queue_cell* qc) {
+	if (qc->parent == NULL) {
+		return NULL;
+	}
+	return qc->parent->left == qc ? &qc->parent->left : &qc->parent->right;
+}
+
+/**
+ * swap 2 queue cells in the binary tree which is the heap, by relinking them
+ *
+ * The cells are relinked rather than swapping their contents since the cells are handed out to the user.
+ *
+ * @pre
+ *  @li @c a is nearer to the root than @c b
+ *
+ * @param[in] q the queue holding these cells
+ * @param[in] a queue cell to swap (it is near the root)
+ * @param[in] b queue cell to swap (it is near the leaves)
+ */
+static void swapQueueCells(CU_NOTNULL old_priority_queue* q, CU_NOTNULL struct old_priority_queue_cell* a, CU_NOTNULL struct old_priority_queue_cell* b) {
+	struct old_priority_queue_cell* parentA = a->parent;
+	struct old_priority_queue_cell** parentLinkA = getQueueCellPtr(a);
+	struct old_priority_queue_cell* leftChildA = a->left;
+	struct old_priority_queue_cell* rightChildA = a->right;
+
+	struct old_priority_queue_cell* parentB = b->parent;
+	struct old_priority_queue_cell** parentLinkB = getQueueCellPtr(b);
+	struct old_priority_queue_cell* leftChildB = b->left;
+	struct old_priority_queue_cell* rightChildB = b->right;
+
+	bool isAParentOfB = b->parent == a;
+
+	//parent of A now links to B
+	if (parentA != NULL) {
+		*parentLinkA = b;
+		b->parent = parentA;
+	} else {
+		q->min = b;
+		b->parent = NULL;
+	}
+	//children of A now are children of B: note a child of A might be B!
+	if (leftChildA != b) {
+		b->left = leftChildA;
+		if (leftChildA != NULL) {
+			leftChildA->parent = b;
+		}
+	} else {
+		b->left = a;
+		a->parent = b;
+	}
+	if (rightChildA != b) {
+		b->right = rightChildA;
+		if (rightChildA != NULL) {
+			rightChildA->parent = b;
+		}
+	} else {
+		b->right = a;
+		a->parent = b;
+	}
+
+	//parent of B now points to A (we already set the parent if B is a child of A)
+	if (!isAParentOfB && parentB != NULL) {
+		*parentLinkB = a;
+		a->parent = parentB;
+	}
+	//children of B now are children of A
+	a->left = leftChildB;
+	if (leftChildB != NULL) {
+		leftChildB->parent = a;
+	}
+	a->right = rightChildB;
+	if (rightChildB != NULL) {
+		rightChildB->parent = a;
+	}
+}
+
+static void percolateUp(CU_NOTNULL old_priority_queue* q, CU_NOTNULL struct old_priority_queue_cell* qc) {
+	if (q->min == qc) {
+		return;
+	}
+	if (qc->priority >= qc->parent->priority) {
+		return;
+	}
+	swapQueueCells(q, qc->parent, qc);
+	percolateUp(q, qc);
+}
+
+static void percolateDown(CU_NOTNULL old_priority_queue* q, CU_NOTNULL struct old_priority_queue_cell* qc) {
+	if (qc->left == NULL) {
+		return;
+	}
+
+	struct old_priority_queue_cell* small;
+	if (qc->right == NULL || qc->left->priority < qc->right->priority) {
+		small = qc->left;
+	} else {
+		small = qc->right;
+	}
+
+	if (qc->priority < small->priority) {
+		return;
+	}
+	swapQueueCells(q, qc, small);
+	percolateDown(q, qc);
+}
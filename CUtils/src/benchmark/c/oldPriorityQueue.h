@@ -0,0 +1,72 @@
+/**
+ * @file
+ *
+ * The pointer based implementation ::priority_queue had before it was backed by an array
+ *
+ * It is kept in the benchmark only to compare the two implementations. The queue is a binary heap where every
+ * cell is allocated on its own and linked to its parent and children: adding and popping an item walk the tree
+ * from the root along the bits of the id of the last cell. The old queue looked up the cell of an item
+ * through functions provided by the user, so here ::oldPriorityQueueAddItem returns the cell and
+ * ::oldPriorityQueueChangePriority takes it.
+ *
+ * @date Oct 16, 2026
+ * @author koldar
+ */
+
+#ifndef OLDPRIORITYQUEUE_H_
+#define OLDPRIORITYQUEUE_H_
+
+#include <stdbool.h>
+#include "macros.h"
+
+typedef struct old_priority_queue old_priority_queue;
+typedef struct old_priority_queue_cell old_priority_queue_cell;
+
+/**
+ * Creates an empty queue
+ *
+ * @return the new queue
+ */
+CU_NOTNULL old_priority_queue* oldPriorityQueueNew();
+
+/**
+ * Destroy the queue, without touching the payloads
+ *
+ * @param[in] q the queue to destroy
+ */
+void oldPriorityQueueDestroy(CU_NOTNULL const old_priority_queue* q);
+
+/**
+ * Adds an item in the queue
+ *
+ * @param[inout] q the queue involved
+ * @param[in] data the item to add
+ * @param[in] priority the priority of @c data. Lower values are popped first
+ * @return the cell of @c data. It is valid until @c data is popped
+ */
+CU_NOTNULL old_priority_queue_cell* oldPriorityQueueAddItem(CU_NOTNULL old_priority_queue* q, CU_NULLABLE const void* data, int priority);
+
+/**
+ * Remove the item with the lowest priority from the queue
+ *
+ * @param[inout] q the queue involved. It can't be empty
+ * @return the item removed
+ */
+CU_NULLABLE void* oldPriorityQueuePopItem(CU_NOTNULL old_priority_queue* q);
+
+/**
+ * @param[in] q the queue involved
+ * @return true if there are no items in @c q
+ */
+bool oldPriorityQueueIsEmpty(CU_NOTNULL const old_priority_queue* q);
+
+/**
+ * Change the priority of an item inside the queue
+ *
+ * @param[inout] q the queue involved
+ * @param[inout] qc the cell of the item, returned by ::oldPriorityQueueAddItem
+ * @param[in] newPriority the new priority of the item
+ */
+void oldPriorityQueueChangePriority(CU_NOTNULL old_priority_queue* q, CU_NOTNULL old_priority_queue_cell* qc, int newPriority);
+
+#endif /* OLDPRIORITYQUEUE_H_ */
@@ -0,0 +1,414 @@
+/**
+ * @file
+ *
+ * Arenas are lists of chunks: blocks are carved from the last chunk by incrementing an offset.
+ * Slabs are lists of chunks as well, but each chunk is divided in blocks of the same size; released blocks
+ * are threaded in a free list through their first bytes.
+ *
+ * @author koldar
+ * @date Oct 16, 2026
+ */
+
+#include "allocator.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "errors.h"
+
+/**
+ * every block returned by an arena is aligned to this value
+ */
+#define ALLOCATOR_ALIGNMENT 16
+/**
+ * the blocks sizes ::cuAllocatorThreadCache caches are multiple of this value
+ */
+#define THREAD_CACHE_CLASS_GRANULARITY 16
+#define THREAD_CACHE_CLASSES (CU_ALLOCATOR_THREAD_CACHE_MAX_SIZE / THREAD_CACHE_CLASS_GRANULARITY)
+/**
+ * maximum number of blocks of a given size each thread caches
+ */
+#define THREAD_CACHE_MAX_BLOCKS 1024
+
+/**
+ * A chunk of memory the arenas and the slabs request to the system.
+ *
+ * The memory available follows the header
+ */
+struct allocator_chunk {
+	struct allocator_chunk* next;
+	///the number of usable bytes following the header
+	size_t capacity;
+	///forces the memory after the header to be aligned
+	_Alignas(ALLOCATOR_ALIGNMENT) unsigned char memory[];
+};
+
+struct cu_arena {
+	///must be the first field: ::cu_allocator pointers are casted to ::cu_arena
+	cu_allocator allocator;
+	size_t chunkSize;
+	///the first chunk. It is never released until the arena is destroyed
+	struct allocator_chunk* first;
+	///the chunk where we are currently carving blocks from
+	struct allocator_chunk* current;
+	///number of bytes used in ::cu_arena::current
+	size_t offset;
+	///chunks of allocations bigger than ::cu_arena::chunkSize
+	struct allocator_chunk* bigChunks;
+	size_t allocatedBytes;
+};
+
+struct cu_slab {
+	///must be the first field: ::cu_allocator pointers are casted to ::cu_slab
+	cu_allocator allocator;
+	size_t blockSize;
+	size_t blocksPerChunk;
+	struct allocator_chunk* first;
+	///the chunk where we are currently carving blocks from. NULL if we need a new chunk
+	struct allocator_chunk* current;
+	///number of bytes used in ::cu_slab::current
+	size_t offset;
+	///blocks released and not reused yet. Each block contains the pointer to the next one
+	void* freeBlocks;
+};
+
+/**
+ * The blocks a thread has cached for ::cuAllocatorThreadCache
+ */
+struct thread_cache {
+	///@c heads[i] is the list of the cached blocks of size <tt>(i+1) * THREAD_CACHE_CLASS_GRANULARITY</tt>
+	void* heads[THREAD_CACHE_CLASSES];
+	unsigned int counts[THREAD_CACHE_CLASSES];
+	///true if the thread has registered the destructor of the cache
+	bool registered;
+};
+
+static __thread struct thread_cache threadCache;
+static pthread_key_t threadCacheKey;
+static pthread_once_t threadCacheKeyOnce = PTHREAD_ONCE_INIT;
+
+static struct allocator_chunk* newChunk(size_t capacity);
+static void* defaultAllocate(cu_allocator* allocator, size_t size);
+static void defaultDeallocate(cu_allocator* allocator, void* p, size_t size);
+static void* arenaAllocate(cu_allocator* allocator, size_t size);
+static void arenaDeallocate(cu_allocator* allocator, void* p, size_t size);
+static void* slabAllocate(cu_allocator* allocator, size_t size);
+static void slabDeallocate(cu_allocator* allocator, void* p, size_t size);
+static void* threadCacheAllocate(cu_allocator* allocator, size_t size);
+static void threadCacheDeallocate(cu_allocator* allocator, void* p, size_t size);
+static void createThreadCacheKey();
+static void flushThreadCache(void* cache);
+
+static cu_allocator defaultAllocator = {defaultAllocate, defaultDeallocate, false};
+static cu_allocator threadCacheAllocator = {threadCacheAllocate, threadCacheDeallocate, false};
+
+CU_NOTNULL cu_allocator* cuAllocatorDefault() {
+	return &defaultAllocator;
+}
+
+CU_NOTNULL cu_allocator* cuAllocatorThreadCache() {
+	return &threadCacheAllocator;
+}
+
+void cuAllocatorThreadCacheFlush() {
+	flushThreadCache(&threadCache);
+}
+
+CU_NOTNULL void* cuAllocatorAllocate(CU_NULLABLE cu_allocator* allocator, size_t size) {
+	void* result = allocator == NULL ? malloc(size) : allocator->allocate(allocator, size);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+	return result;
+}
+
+void cuAllocatorDeallocate(CU_NULLABLE cu_allocator* allocator, CU_NULLABLE const void* p, size_t size) {
+	if (p == NULL) {
+		return;
+	}
+	if (allocator == NULL) {
+		free((void*)p);
+	} else {
+		allocator->deallocate(allocator, (void*)p, size);
+	}
+}
+
+bool cuAllocatorReleasesInBulk(CU_NULLABLE const cu_allocator* allocator) {
+	return allocator != NULL && allocator->releasesInBulk;
+}
+
+CU_NOTNULL cu_arena* cuArenaNew(size_t chunkSize) {
+	if (chunkSize == 0) {
+		ERROR_ON_CONSTRUCTION("arena chunk size", "%zu", chunkSize);
+	}
+	cu_arena* result = CU_MALLOC(cu_arena);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+
+	result->allocator.allocate = arenaAllocate;
+	result->allocator.deallocate = arenaDeallocate;
+	result->allocator.releasesInBulk = true;
+	result->chunkSize = chunkSize;
+	result->first = newChunk(chunkSize);
+	result->current = result->first;
+	result->offset = 0;
+	result->bigChunks = NULL;
+	result->allocatedBytes = 0;
+
+	return result;
+}
+
+CU_DEFINE_DEFAULT_VALUES(cuArenaNew,
+		64*1024
+);
+
+void cuArenaDestroy(CU_NOTNULL const cu_arena* arena, CU_NULLABLE const struct var_args* context) {
+	cu_arena* a = (cu_arena*) arena;
+	cuArenaReset(a);
+	CU_FREE(a->first);
+	CU_FREE(a);
+}
+
+CU_NOTNULL void* cuArenaAllocate(CU_NOTNULL cu_arena* arena, size_t size) {
+	//round the size to keep the next block aligned
+	size = (size + ALLOCATOR_ALIGNMENT - 1) & ~((size_t)ALLOCATOR_ALIGNMENT - 1);
+	arena->allocatedBytes += size;
+
+	if (size > arena->chunkSize) {
+		struct allocator_chunk* big = newChunk(size);
+		big->next = arena->bigChunks;
+		arena->bigChunks = big;
+		return big->memory;
+	}
+
+	if (arena->offset + size > arena->current->capacity) {
+		struct allocator_chunk* chunk = newChunk(arena->chunkSize);
+		arena->current->next = chunk;
+		arena->current = chunk;
+		arena->offset = 0;
+	}
+
+	void* result = arena->current->memory + arena->offset;
+	arena->offset += size;
+	return result;
+}
+
+void cuArenaReset(CU_NOTNULL cu_arena* arena) {
+	struct allocator_chunk* chunk = arena->first->next;
+	while (chunk != NULL) {
+		struct allocator_chunk* next = chunk->next;
+		CU_FREE(chunk);
+		chunk = next;
+	}
+	chunk = arena->bigChunks;
+	while (chunk != NULL) {
+		struct allocator_chunk* next = chunk->next;
+		CU_FREE(chunk);
+		chunk = next;
+	}
+
+	arena->first->next = NULL;
+	arena->current = arena->first;
+	arena->offset = 0;
+	arena->bigChunks = NULL;
+	arena->allocatedBytes = 0;
+}
+
+size_t cuArenaGetAllocatedBytes(CU_NOTNULL const cu_arena* arena) {
+	return arena->allocatedBytes;
+}
+
+CU_NOTNULL cu_allocator* cuArenaGetAllocator(CU_NOTNULL cu_arena* arena) {
+	return &arena->allocator;
+}
+
+CU_NOTNULL cu_slab* cuSlabNew(size_t blockSize, size_t blocksPerChunk) {
+	if (blocksPerChunk == 0) {
+		ERROR_ON_CONSTRUCTION("slab blocks per chunk", "%zu", blocksPerChunk);
+	}
+	cu_slab* result = CU_MALLOC(cu_slab);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+
+	//each block needs to contain at least the pointer of the free list and to keep the next block aligned
+	if (blockSize < sizeof(void*)) {
+		blockSize = sizeof(void*);
+	}
+	blockSize = (blockSize + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+
+	result->allocator.allocate = slabAllocate;
+	result->allocator.deallocate = slabDeallocate;
+	result->allocator.releasesInBulk = false;
+	result->blockSize = blockSize;
+	result->blocksPerChunk = blocksPerChunk;
+	result->first = NULL;
+	result->current = NULL;
+	result->offset = 0;
+	result->freeBlocks = NULL;
+
+	return result;
+}
+
+CU_DEFINE_DEFAULT_VALUES(cuSlabNew,
+		,
+		1024
+);
+
+void cuSlabDestroy(CU_NOTNULL const cu_slab* slab, CU_NULLABLE const struct var_args* context) {
+	struct allocator_chunk* chunk = slab->first;
+	while (chunk != NULL) {
+		struct allocator_chunk* next = chunk->next;
+		CU_FREE(chunk);
+		chunk = next;
+	}
+	CU_FREE(slab);
+}
+
+CU_NOTNULL void* cuSlabAllocate(CU_NOTNULL cu_slab* slab) {
+	if (slab->freeBlocks != NULL) {
+		void* result = slab->freeBlocks;
+		slab->freeBlocks = *((void**)result);
+		return result;
+	}
+
+	if (slab->current == NULL || slab->offset + slab->blockSize > slab->current->capacity) {
+		//reuse the chunks kept by cuSlabReset before requesting new ones
+		struct allocator_chunk* next = slab->current == NULL ? slab->first : slab->current->next;
+		if (next == NULL) {
+			next = newChunk(slab->blockSize * slab->blocksPerChunk);
+			if (slab->current == NULL) {
+				slab->first = next;
+			} else {
+				slab->current->next = next;
+			}
+		}
+		slab->current = next;
+		slab->offset = 0;
+	}
+
+	void* result = slab->current->memory + slab->offset;
+	slab->offset += slab->blockSize;
+	return result;
+}
+
+void cuSlabFree(CU_NOTNULL cu_slab* slab, CU_NOTNULL const void* p) {
+	*((void**)p) = slab->freeBlocks;
+	slab->freeBlocks = (void*)p;
+}
+
+void cuSlabReset(CU_NOTNULL cu_slab* slab) {
+	slab->current = NULL;
+	slab->offset = 0;
+	slab->freeBlocks = NULL;
+}
+
+size_t cuSlabGetBlockSize(CU_NOTNULL const cu_slab* slab) {
+	return slab->blockSize;
+}
+
+CU_NOTNULL cu_allocator* cuSlabGetAllocator(CU_NOTNULL cu_slab* slab) {
+	return &slab->allocator;
+}
+
+static struct allocator_chunk* newChunk(size_t capacity) {
+	struct allocator_chunk* result = malloc(sizeof(struct allocator_chunk) + capacity);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+	result->next = NULL;
+	result->capacity = capacity;
+	return result;
+}
+
+static void* defaultAllocate(cu_allocator* allocator, size_t size) {
+	return malloc(size);
+}
+
+static void defaultDeallocate(cu_allocator* allocator, void* p, size_t size) {
+	free(p);
+}
+
+static void* arenaAllocate(cu_allocator* allocator, size_t size) {
+	return cuArenaAllocate((cu_arena*)allocator, size);
+}
+
+static void arenaDeallocate(cu_allocator* allocator, void* p, size_t size) {
+	//memory is released only by cuArenaReset
+}
+
+static void* slabAllocate(cu_allocator* allocator, size_t size) {
+	cu_slab* slab = (cu_slab*) allocator;
+	if (size > slab->blockSize) {
+		return malloc(size);
+	}
+	return cuSlabAllocate(slab);
+}
+
+static void slabDeallocate(cu_allocator* allocator, void* p, size_t size) {
+	cu_slab* slab = (cu_slab*) allocator;
+	if (size > slab->blockSize) {
+		free(p);
+	} else {
+		cuSlabFree(slab, p);
+	}
+}
+
+static void* threadCacheAllocate(cu_allocator* allocator, size_t size) {
+	if (size == 0 || size > CU_ALLOCATOR_THREAD_CACHE_MAX_SIZE) {
+		return malloc(size);
+	}
+	int sizeClass = (size - 1) / THREAD_CACHE_CLASS_GRANULARITY;
+	void* result = threadCache.heads[sizeClass];
+	if (result != NULL) {
+		threadCache.heads[sizeClass] = *((void**)result);
+		threadCache.counts[sizeClass] -= 1;
+		return result;
+	}
+	//the block needs to be big enough to be reused by any allocation of its class
+	return malloc((sizeClass + 1) * THREAD_CACHE_CLASS_GRANULARITY);
+}
+
+static void threadCacheDeallocate(cu_allocator* allocator, void* p, size_t size) {
+	if (size == 0 || size > CU_ALLOCATOR_THREAD_CACHE_MAX_SIZE) {
+		free(p);
+		return;
+	}
+	int sizeClass = (size - 1) / THREAD_CACHE_CLASS_GRANULARITY;
+	if (threadCache.counts[sizeClass] >= THREAD_CACHE_MAX_BLOCKS) {
+		free(p);
+		return;
+	}
+	if (!threadCache.registered) {
+		//ensure the blocks cached by this thread are released when the thread terminates
+		pthread_once(&threadCacheKeyOnce, createThreadCacheKey);
+		pthread_setspecific(threadCacheKey, &threadCache);
+		threadCache.registered = true;
+	}
+	*((void**)p) = threadCache.heads[sizeClass];
+	threadCache.heads[sizeClass] = p;
+	threadCache.counts[sizeClass] += 1;
+}
+
+static void createThreadCacheKey() {
+	pthread_key_create(&threadCacheKey, flushThreadCache);
+}
+
+/**
+ * Release all the blocks inside a ::thread_cache
+ *
+ * @param[in] cache the ::thread_cache to flush
+ */
+static void flushThreadCache(void* cache) {
+	struct thread_cache* tc = cache;
+	for (int i=0; i<THREAD_CACHE_CLASSES; i++) {
+		void* block = tc->heads[i];
+		while (block != NULL) {
+			void* next = *((void**)block);
+			free(block);
+			block = next;
+		}
+		tc->heads[i] = NULL;
+		tc->counts[i] = 0;
+	}
+}
@@ -0,0 +1,606 @@
+/*
+ * b_tree.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: koldar
+ */
+
+#include "b_tree.h"
+#include <string.h>
+#include "errors.h"
+#include "log.h"
+
+/**
+ * bytes of a node not used by the items: the size, the leaf flag and, for the leaves, the links to the siblings
+ */
+#define BTREE_NODE_HEADER (2 * sizeof(int) + 2 * sizeof(void*))
+/**
+ * maximum number of items in a leaf
+ */
+#define LEAF_CAPACITY ((int)((CU_BTREE_NODE_SIZE - BTREE_NODE_HEADER) / sizeof(void*)))
+/**
+ * maximum number of keys in an inner node. An inner node has one child more than its keys
+ */
+#define INNER_CAPACITY ((int)((CU_BTREE_NODE_SIZE - 2 * sizeof(int) - sizeof(void*)) / (2 * sizeof(void*))))
+/**
+ * minimum number of items in a leaf which is not the root
+ */
+#define LEAF_MINIMUM (LEAF_CAPACITY / 2)
+/**
+ * minimum number of keys in an inner node which is not the root
+ */
+#define INNER_MINIMUM (INNER_CAPACITY / 2)
+
+/**
+ * A node of the tree
+ *
+ * Leaves and inner nodes have the same size, so they can be created by the same ::cu_allocator
+ *
+ * In an inner node, every item in the subtree of @c children[i] is not greater than @c keys[i],
+ * which in turn is not greater than any item in the subtree of @c children[i+1]
+ */
+struct b_tree_node {
+	///number of items of a leaf or number of keys of an inner node
+	int size;
+	bool leaf;
+	union {
+		struct {
+			struct b_tree_node* next;
+			struct b_tree_node* previous;
+			void* items[LEAF_CAPACITY];
+		} leaf;
+		struct {
+			void* keys[INNER_CAPACITY];
+			struct b_tree_node* children[INNER_CAPACITY + 1];
+		} inner;
+	} data;
+};
+
+struct b_tree {
+	struct b_tree_node* root;
+	///the leftmost leaf. It is never released until the tree is destroyed
+	struct b_tree_node* first;
+	///the rightmost leaf
+	struct b_tree_node* last;
+	///the number of items inside the tree
+	int size;
+	payload_functions functions;
+	///where the nodes of the tree are allocated. NULL means malloc
+	cu_allocator* allocator;
+};
+
+static struct b_tree_node* newNode(CU_NOTNULL b_tree* tree, bool leaf);
+static void destroyNode(CU_NOTNULL const b_tree* tree, CU_NOTNULL struct b_tree_node* node, bool withElements, CU_NULLABLE const struct var_args* context);
+static int getLowerBound(CU_NOTNULL const b_tree* tree, void* const* array, int size, CU_NULLABLE const void* payload);
+static int getUpperBound(CU_NOTNULL const b_tree* tree, void* const* array, int size, CU_NULLABLE const void* payload);
+static void findLowerBound(CU_NOTNULL const b_tree* tree, CU_NULLABLE const void* payload, const struct b_tree_node** leaf, int* index);
+static bool insertInNode(CU_NOTNULL b_tree* tree, CU_NOTNULL struct b_tree_node* node, CU_NULLABLE void* payload, void** separator, struct b_tree_node** newNodeOutput);
+static bool removeFromNode(CU_NOTNULL b_tree* tree, CU_NOTNULL struct b_tree_node* node, CU_NULLABLE const void* payload, bool withElement);
+static void fixChild(CU_NOTNULL b_tree* tree, CU_NOTNULL struct b_tree_node* node, int childIndex);
+static void mergeChildren(CU_NOTNULL b_tree* tree, CU_NOTNULL struct b_tree_node* node, int leftIndex);
+static bool removeItem(CU_NOTNULL b_tree* tree, CU_NULLABLE const void* payload, bool withElement);
+
+b_tree* cuBTreeNew(payload_functions functions, CU_NULLABLE cu_allocator* allocator) {
+	b_tree* result = CU_MALLOC(b_tree);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+
+	result->functions = functions;
+	result->allocator = allocator;
+	result->size = 0;
+	result->root = newNode(result, true);
+	result->first = result->root;
+	result->last = result->root;
+
+	return result;
+}
+
+CU_DEFINE_DEFAULT_VALUES(cuBTreeNew,
+		,
+		NULL
+);
+
+void cuBTreeDestroy(CU_NOTNULL const b_tree* tree, CU_NULLABLE const struct var_args* context) {
+	destroyNode(tree, tree->root, false, context);
+	CU_FREE(tree);
+}
+
+void cuBTreeDestroyWithElements(CU_NOTNULL const b_tree* tree, CU_NULLABLE const struct var_args* context) {
+	destroyNode(tree, tree->root, true, context);
+	CU_FREE(tree);
+}
+
+bool cuBTreeAddItem(CU_NOTNULL b_tree* tree, CU_NULLABLE void* payload) {
+	void* separator;
+	struct b_tree_node* right;
+
+	if (insertInNode(tree, tree->root, payload, &separator, &right)) {
+		//the root has been split: the tree grows by one level
+		struct b_tree_node* root = newNode(tree, false);
+		root->size = 1;
+		root->data.inner.keys[0] = separator;
+		root->data.inner.children[0] = tree->root;
+		root->data.inner.children[1] = right;
+		tree->root = root;
+	}
+	tree->size += 1;
+	return true;
+}
+
+void cuBTreeBulkLoad(CU_NOTNULL b_tree* tree, CU_NOTNULL void* const* items, int n) {
+	if (tree->size > 0) {
+		ERROR_ON_APPLICATION("bulk load of items", "%d", n, "not empty B tree with size", "%d", tree->size);
+	}
+	for (int i=1; i<n; i++) {
+		if (tree->functions.order(items[i-1], items[i]) > 0) {
+			ERROR_ON_APPLICATION("bulk load", "%s", "not sorted items", "B tree with items at index", "%d", i);
+		}
+	}
+	if (n == 0) {
+		return;
+	}
+
+	//build the leaves, distributing the items evenly so that each leaf is at least half full
+	int levelSize = (n + LEAF_CAPACITY - 1) / LEAF_CAPACITY;
+	struct b_tree_node** level = malloc(sizeof(struct b_tree_node*) * levelSize);
+	void** minimums = malloc(sizeof(void*) * levelSize);
+	if (level == NULL || minimums == NULL) {
+		ERROR_MALLOC();
+	}
+	int nextItem = 0;
+	struct b_tree_node* previous = NULL;
+	for (int i=0; i<levelSize; i++) {
+		struct b_tree_node* leaf = i == 0 ? tree->first : newNode(tree, true);
+		leaf->size = n / levelSize + (i < (n % levelSize) ? 1 : 0);
+		memcpy(leaf->data.leaf.items, &items[nextItem], sizeof(void*) * leaf->size);
+		nextItem += leaf->size;
+		if (previous != NULL) {
+			leaf->data.leaf.previous = previous;
+			previous->data.leaf.next = leaf;
+		}
+		level[i] = leaf;
+		minimums[i] = leaf->data.leaf.items[0];
+		previous = leaf;
+	}
+	//n > 0, so there is at least one leaf
+	tree->last = previous;
+
+	//build the inner nodes level by level. The minimum of each subtree is the key separating it from its left sibling
+	while (levelSize > 1) {
+		int parentsSize = (levelSize + INNER_CAPACITY) / (INNER_CAPACITY + 1);
+		int nextChild = 0;
+		for (int i=0; i<parentsSize; i++) {
+			struct b_tree_node* parent = newNode(tree, false);
+			int children = levelSize / parentsSize + (i < (levelSize % parentsSize) ? 1 : 0);
+			void* minimum = minimums[nextChild];
+			parent->size = children - 1;
+			for (int j=0; j<children; j++) {
+				parent->data.inner.children[j] = level[nextChild + j];
+				if (j > 0) {
+					parent->data.inner.keys[j-1] = minimums[nextChild + j];
+				}
+			}
+			nextChild += children;
+			level[i] = parent;
+			minimums[i] = minimum;
+		}
+		levelSize = parentsSize;
+	}
+	tree->root = level[0];
+	tree->size = n;
+
+	CU_FREE(level);
+	CU_FREE(minimums);
+}
+
+int cuBTreeGetSize(CU_NOTNULL const b_tree* tree) {
+	return tree->size;
+}
+
+bool cuBTreeIsEmpty(CU_NOTNULL const b_tree* tree) {
+	return tree->size == 0;
+}
+
+bool cuBTreeContainsItem(CU_NOTNULL const b_tree* tree, CU_NULLABLE const void* payload) {
+	const struct b_tree_node* leaf;
+	int index;
+
+	findLowerBound(tree, payload, &leaf, &index);
+	return leaf != NULL && tree->functions.order(leaf->data.leaf.items[index], payload) == 0;
+}
+
+void* cuBTreeGetMinimum(CU_NOTNULL const b_tree* tree) {
+	if (tree->size == 0) {
+		return NULL;
+	}
+	return tree->first->data.leaf.items[0];
+}
+
+void* cuBTreeGetMaximum(CU_NOTNULL const b_tree* tree) {
+	if (tree->size == 0) {
+		return NULL;
+	}
+	return tree->last->data.leaf.items[tree->last->size - 1];
+}
+
+bool cuBTreeRemoveItem(CU_NOTNULL b_tree* tree, CU_NULLABLE const void* payload) {
+	return removeItem(tree, payload, false);
+}
+
+bool cuBTreeRemoveItemWithElement(CU_NOTNULL b_tree* tree, CU_NULLABLE const void* payload) {
+	return removeItem(tree, payload, true);
+}
+
+b_tree_cursor _cuBTreeGetFirstCursor(CU_NOTNULL const b_tree* tree) {
+	b_tree_cursor result = {tree->size > 0 ? tree->first : NULL, 0, false, NULL, NULL};
+	return result;
+}
+
+b_tree_cursor _cuBTreeGetRangeCursor(CU_NOTNULL const b_tree* tree, CU_NULLABLE const void* from, CU_NULLABLE const void* to) {
+	b_tree_cursor result = {NULL, 0, true, to, NULL};
+	findLowerBound(tree, from, &result.leaf, &result.index);
+	return result;
+}
+
+bool _cuBTreeMoveCursor(CU_NOTNULL const b_tree* tree, CU_NOTNULL b_tree_cursor* cursor) {
+	if (cursor->leaf == NULL) {
+		return false;
+	}
+	void* item = cursor->leaf->data.leaf.items[cursor->index];
+	if (cursor->bounded && tree->functions.order(item, cursor->to) >= 0) {
+		cursor->leaf = NULL;
+		return false;
+	}
+	cursor->item = item;
+	cursor->index += 1;
+	if (cursor->index == cursor->leaf->size) {
+		cursor->leaf = cursor->leaf->data.leaf.next;
+		cursor->index = 0;
+	}
+	return true;
+}
+
+/**
+ * Allocate an empty node
+ *
+ * @param[in] tree the tree which will own the node
+ * @param[in] leaf true if we need to create a leaf
+ * @return the node created
+ */
+static struct b_tree_node* newNode(CU_NOTNULL b_tree* tree, bool leaf) {
+	struct b_tree_node* result = CU_ALLOCATOR_NEW(tree->allocator, struct b_tree_node);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+	result->size = 0;
+	result->leaf = leaf;
+	if (leaf) {
+		result->data.leaf.next = NULL;
+		result->data.leaf.previous = NULL;
+	}
+	return result;
+}
+
+/**
+ * Release a subtree
+ *
+ * @param[in] tree the tree owning the subtree
+ * @param[in] node the root of the subtree
+ * @param[in] withElements if true we release the items as well
+ * @param[in] context passed to the destructor of the items
+ */
+static void destroyNode(CU_NOTNULL const b_tree* tree, CU_NOTNULL struct b_tree_node* node, bool withElements, CU_NULLABLE const struct var_args* context) {
+	if (node->leaf) {
+		if (withElements) {
+			for (int i=0; i<node->size; i++) {
+				tree->functions.destroy(node->data.leaf.items[i], context);
+			}
+		}
+	} else {
+		for (int i=0; i<=node->size; i++) {
+			destroyNode(tree, node->data.inner.children[i], withElements, context);
+		}
+	}
+	CU_ALLOCATOR_FREE(tree->allocator, struct b_tree_node, node);
+}
+
+/**
+ * @param[in] tree the tree involved
+ * @param[in] array a sorted array
+ * @param[in] size the number of cells of @c array
+ * @param[in] payload the item to look for
+ * @return the index of the first cell of @c array which is not less than @c payload. @c size if there is no such cell
+ */
+static int getLowerBound(CU_NOTNULL const b_tree* tree, void* const* array, int size, CU_NULLABLE const void* payload) {
+	int low = 0;
+	int high = size;
+	while (low < high) {
+		int middle = (low + high) / 2;
+		if (tree->functions.order(array[middle], payload) < 0) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+/**
+ * @param[in] tree the tree involved
+ * @param[in] array a sorted array
+ * @param[in] size the number of cells of @c array
+ * @param[in] payload the item to look for
+ * @return the index of the first cell of @c array which is greater than @c payload. @c size if there is no such cell
+ */
+static int getUpperBound(CU_NOTNULL const b_tree* tree, void* const* array, int size, CU_NULLABLE const void* payload) {
+	int low = 0;
+	int high = size;
+	while (low < high) {
+		int middle = (low + high) / 2;
+		if (tree->functions.order(array[middle], payload) <= 0) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+/**
+ * Look for the first item of the tree which is not less than @c payload
+ *
+ * @param[in] tree the tree involved
+ * @param[in] payload the item to look for
+ * @param[out] leaf the leaf containing the item found. NULL if every item is less than @c payload
+ * @param[out] index the position of the item found inside @c leaf
+ */
+static void findLowerBound(CU_NOTNULL const b_tree* tree, CU_NULLABLE const void* payload, const struct b_tree_node** leaf, int* index) {
+	const struct b_tree_node* node = tree->root;
+	while (!node->leaf) {
+		node = node->data.inner.children[getLowerBound(tree, node->data.inner.keys, node->size, payload)];
+	}
+	int i = getLowerBound(tree, node->data.leaf.items, node->size, payload);
+	if (i == node->size) {
+		//every item in the leaf is less than payload: the lower bound, if any, is the first item of the next leaf
+		node = node->data.leaf.next;
+		i = 0;
+	}
+	*leaf = node;
+	*index = i;
+}
+
+/**
+ * Add an item in a subtree
+ *
+ * @param[inout] tree the tree involved
+ * @param[inout] node the root of the subtree
+ * @param[in] payload the item to add
+ * @param[out] separator if @c node has been split, the key separating @c node and @c newNodeOutput
+ * @param[out] newNode if @c node has been split, the node containing the upper half of @c node
+ * @return true if @c node has been split
+ */
+static bool insertInNode(CU_NOTNULL b_tree* tree, CU_NOTNULL struct b_tree_node* node, CU_NULLABLE void* payload, void** separator, struct b_tree_node** newNodeOutput) {
+	if (node->leaf) {
+		int position = getUpperBound(tree, node->data.leaf.items, node->size, payload);
+		if (node->size < LEAF_CAPACITY) {
+			memmove(&node->data.leaf.items[position + 1], &node->data.leaf.items[position], sizeof(void*) * (node->size - position));
+			node->data.leaf.items[position] = payload;
+			node->size += 1;
+			return false;
+		}
+
+		//the leaf is full: we move its upper half in a new leaf
+		void* items[LEAF_CAPACITY + 1];
+		memcpy(items, node->data.leaf.items, sizeof(void*) * position);
+		items[position] = payload;
+		memcpy(&items[position + 1], &node->data.leaf.items[position], sizeof(void*) * (node->size - position));
+
+		struct b_tree_node* right = newNode(tree, true);
+		int leftSize = (LEAF_CAPACITY + 1) / 2;
+		node->size = leftSize;
+		right->size = LEAF_CAPACITY + 1 - leftSize;
+		memcpy(node->data.leaf.items, items, sizeof(void*) * node->size);
+		memcpy(right->data.leaf.items, &items[leftSize], sizeof(void*) * right->size);
+
+		right->data.leaf.next = node->data.leaf.next;
+		right->data.leaf.previous = node;
+		if (node->data.leaf.next != NULL) {
+			node->data.leaf.next->data.leaf.previous = right;
+		} else {
+			tree->last = right;
+		}
+		node->data.leaf.next = right;
+
+		*separator = right->data.leaf.items[0];
+		*newNodeOutput = right;
+		return true;
+	}
+
+	int childIndex = getUpperBound(tree, node->data.inner.keys, node->size, payload);
+	void* childSeparator;
+	struct b_tree_node* childRight;
+	if (!insertInNode(tree, node->data.inner.children[childIndex], payload, &childSeparator, &childRight)) {
+		return false;
+	}
+
+	if (node->size < INNER_CAPACITY) {
+		memmove(&node->data.inner.keys[childIndex + 1], &node->data.inner.keys[childIndex], sizeof(void*) * (node->size - childIndex));
+		memmove(&node->data.inner.children[childIndex + 2], &node->data.inner.children[childIndex + 1], sizeof(struct b_tree_node*) * (node->size - childIndex));
+		node->data.inner.keys[childIndex] = childSeparator;
+		node->data.inner.children[childIndex + 1] = childRight;
+		node->size += 1;
+		return false;
+	}
+
+	//the inner node is full: the middle key goes up to the parent
+	void* keys[INNER_CAPACITY + 1];
+	struct b_tree_node* children[INNER_CAPACITY + 2];
+	memcpy(keys, node->data.inner.keys, sizeof(void*) * childIndex);
+	keys[childIndex] = childSeparator;
+	memcpy(&keys[childIndex + 1], &node->data.inner.keys[childIndex], sizeof(void*) * (node->size - childIndex));
+	memcpy(children, node->data.inner.children, sizeof(struct b_tree_node*) * (childIndex + 1));
+	children[childIndex + 1] = childRight;
+	memcpy(&children[childIndex + 2], &node->data.inner.children[childIndex + 1], sizeof(struct b_tree_node*) * (node->size - childIndex));
+
+	struct b_tree_node* right = newNode(tree, false);
+	int middle = (INNER_CAPACITY + 1) / 2;
+	node->size = middle;
+	right->size = INNER_CAPACITY - middle;
+	memcpy(node->data.inner.keys, keys, sizeof(void*) * node->size);
+	memcpy(node->data.inner.children, children, sizeof(struct b_tree_node*) * (node->size + 1));
+	memcpy(right->data.inner.keys, &keys[middle + 1], sizeof(void*) * right->size);
+	memcpy(right->data.inner.children, &children[middle + 1], sizeof(struct b_tree_node*) * (right->size + 1));
+
+	*separator = keys[middle];
+	*newNodeOutput = right;
+	return true;
+}
+
+/**
+ * Remove an item from a subtree
+ *
+ * @param[inout] tree the tree involved
+ * @param[inout] node the root of the subtree. After the call it may contain less items than the minimum allowed
+ * @param[in] payload the item to remove
+ * @param[in] withElement if true, we release the item removed as well
+ * @return true if we have found the item
+ */
+static bool removeFromNode(CU_NOTNULL b_tree* tree, CU_NOTNULL struct b_tree_node* node, CU_NULLABLE const void* payload, bool withElement) {
+	if (node->leaf) {
+		int position = getLowerBound(tree, node->data.leaf.items, node->size, payload);
+		if (position == node->size || tree->functions.order(node->data.leaf.items[position], payload) != 0) {
+			return false;
+		}
+		if (withElement) {
+			tree->functions.destroy(node->data.leaf.items[position], NULL);
+		}
+		memmove(&node->data.leaf.items[position], &node->data.leaf.items[position + 1], sizeof(void*) * (node->size - position - 1));
+		node->size -= 1;
+		return true;
+	}
+
+	int childIndex = getLowerBound(tree, node->data.inner.keys, node->size, payload);
+	bool found = removeFromNode(tree, node->data.inner.children[childIndex], payload, withElement);
+	if (!found && childIndex < node->size && tree->functions.order(node->data.inner.keys[childIndex], payload) == 0) {
+		//the subtree on the right may start with payload
+		childIndex += 1;
+		found = removeFromNode(tree, node->data.inner.children[childIndex], payload, withElement);
+	}
+	if (found) {
+		fixChild(tree, node, childIndex);
+	}
+	return found;
+}
+
+/**
+ * Restore the minimum number of items of a child by borrowing an item from a sibling or by merging it with a sibling
+ *
+ * @param[inout] tree the tree involved
+ * @param[inout] node the parent of the child
+ * @param[in] childIndex the index of the child to fix
+ */
+static void fixChild(CU_NOTNULL b_tree* tree, CU_NOTNULL struct b_tree_node* node, int childIndex) {
+	struct b_tree_node* child = node->data.inner.children[childIndex];
+	struct b_tree_node* left = childIndex > 0 ? node->data.inner.children[childIndex - 1] : NULL;
+	struct b_tree_node* right = childIndex < node->size ? node->data.inner.children[childIndex + 1] : NULL;
+	int minimum = child->leaf ? LEAF_MINIMUM : INNER_MINIMUM;
+
+	if (child->size >= minimum) {
+		return;
+	}
+
+	if (left != NULL && left->size > minimum) {
+		//move the greatest item of the left sibling in the child
+		if (child->leaf) {
+			memmove(&child->data.leaf.items[1], &child->data.leaf.items[0], sizeof(void*) * child->size);
+			child->data.leaf.items[0] = left->data.leaf.items[left->size - 1];
+			node->data.inner.keys[childIndex - 1] = child->data.leaf.items[0];
+		} else {
+			memmove(&child->data.inner.keys[1], &child->data.inner.keys[0], sizeof(void*) * child->size);
+			memmove(&child->data.inner.children[1], &child->data.inner.children[0], sizeof(struct b_tree_node*) * (child->size + 1));
+			child->data.inner.keys[0] = node->data.inner.keys[childIndex - 1];
+			child->data.inner.children[0] = left->data.inner.children[left->size];
+			node->data.inner.keys[childIndex - 1] = left->data.inner.keys[left->size - 1];
+		}
+		child->size += 1;
+		left->size -= 1;
+	} else if (right != NULL && right->size > minimum) {
+		//move the smallest item of the right sibling in the child
+		if (child->leaf) {
+			child->data.leaf.items[child->size] = right->data.leaf.items[0];
+			memmove(&right->data.leaf.items[0], &right->data.leaf.items[1], sizeof(void*) * (right->size - 1));
+			node->data.inner.keys[childIndex] = right->data.leaf.items[0];
+		} else {
+			child->data.inner.keys[child->size] = node->data.inner.keys[childIndex];
+			child->data.inner.children[child->size + 1] = right->data.inner.children[0];
+			node->data.inner.keys[childIndex] = right->data.inner.keys[0];
+			memmove(&right->data.inner.keys[0], &right->data.inner.keys[1], sizeof(void*) * (right->size - 1));
+			memmove(&right->data.inner.children[0], &right->data.inner.children[1], sizeof(struct b_tree_node*) * right->size);
+		}
+		child->size += 1;
+		right->size -= 1;
+	} else if (left != NULL) {
+		mergeChildren(tree, node, childIndex - 1);
+	} else if (right != NULL) {
+		mergeChildren(tree, node, childIndex);
+	}
+}
+
+/**
+ * Merge 2 adjacent children of a node. The right one is released
+ *
+ * @pre
+ *  @li the items of the 2 children fit in a single node;
+ *
+ * @param[inout] tree the tree involved
+ * @param[inout] node the parent of the children
+ * @param[in] leftIndex the index of the left child to merge
+ */
+static void mergeChildren(CU_NOTNULL b_tree* tree, CU_NOTNULL struct b_tree_node* node, int leftIndex) {
+	struct b_tree_node* left = node->data.inner.children[leftIndex];
+	struct b_tree_node* right = node->data.inner.children[leftIndex + 1];
+
+	if (left->leaf) {
+		memcpy(&left->data.leaf.items[left->size], right->data.leaf.items, sizeof(void*) * right->size);
+		left->size += right->size;
+		left->data.leaf.next = right->data.leaf.next;
+		if (right->data.leaf.next != NULL) {
+			right->data.leaf.next->data.leaf.previous = left;
+		} else {
+			tree->last = left;
+		}
+	} else {
+		left->data.inner.keys[left->size] = node->data.inner.keys[leftIndex];
+		memcpy(&left->data.inner.keys[left->size + 1], right->data.inner.keys, sizeof(void*) * right->size);
+		memcpy(&left->data.inner.children[left->size + 1], right->data.inner.children, sizeof(struct b_tree_node*) * (right->size + 1));
+		left->size += right->size + 1;
+	}
+	CU_ALLOCATOR_FREE(tree->allocator, struct b_tree_node, right);
+
+	memmove(&node->data.inner.keys[leftIndex], &node->data.inner.keys[leftIndex + 1], sizeof(void*) * (node->size - leftIndex - 1));
+	memmove(&node->data.inner.children[leftIndex + 1], &node->data.inner.children[leftIndex + 2], sizeof(struct b_tree_node*) * (node->size - leftIndex - 1));
+	node->size -= 1;
+}
+
+/**
+ * Remove an item from the tree
+ *
+ * @param[inout] tree the tree involved
+ * @param[in] payload the item to remove
+ * @param[in] withElement if true, we release the item removed as well
+ * @return true if we have found the item
+ */
+static bool removeItem(CU_NOTNULL b_tree* tree, CU_NULLABLE const void* payload, bool withElement) {
+	if (!removeFromNode(tree, tree->root, payload, withElement)) {
+		return false;
+	}
+	if (!tree->root->leaf && tree->root->size == 0) {
+		//the root has only one child: the tree shrinks by one level
+		struct b_tree_node* oldRoot = tree->root;
+		tree->root = oldRoot->data.inner.children[0];
+		CU_ALLOCATOR_FREE(tree->allocator, struct b_tree_node, oldRoot);
+	}
+	tree->size -= 1;
+	return true;
+}
@@ -0,0 +1,253 @@
+/*
+ * benchmark.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: koldar
+ */
+
+#include "benchmark.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "timeMeasurement.h"
+#include "online_statistics.h"
+#include "csvProducer.h"
+#include "plot2DProducer.h"
+#include "errors.h"
+#include "log.h"
+
+struct cu_benchmark {
+	char* name;
+	int warmupRuns;
+	int runs;
+	///the results of the cases measured so far
+	cu_benchmark_result* results;
+	int resultsNumber;
+	int resultsCapacity;
+	///buffer where the timings of the runs of a case are stored. Has ::cu_benchmark::runs cells
+	double* samples;
+};
+
+static int compareDoubles(const void* a, const void* b);
+static double getPercentile(const double* sortedSamples, int n, double percentile);
+static int getCaseIndex(const cu_benchmark* b, const char* caseName, int before);
+
+cu_benchmark* cuBenchmarkNew(CU_NOTNULL const char* name, int warmupRuns, int runs) {
+	if (runs <= 0) {
+		ERROR_ON_CONSTRUCTION("benchmark", "%s", name);
+	}
+	cu_benchmark* result = CU_MALLOC(cu_benchmark);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+
+	result->name = strdup(name);
+	result->warmupRuns = warmupRuns;
+	result->runs = runs;
+	result->results = NULL;
+	result->resultsNumber = 0;
+	result->resultsCapacity = 0;
+	result->samples = malloc(sizeof(double) * runs);
+	if (result->name == NULL || result->samples == NULL) {
+		ERROR_MALLOC();
+	}
+
+	return result;
+}
+
+CU_DEFINE_DEFAULT_VALUES(cuBenchmarkNew,
+		,
+		3,
+		10
+);
+
+void cuBenchmarkDestroy(CU_NOTNULL const cu_benchmark* b, CU_NULLABLE const struct var_args* context) {
+	for (int i=0; i<b->resultsNumber; i++) {
+		CU_FREE(b->results[i].caseName);
+	}
+	CU_FREE(b->results);
+	CU_FREE(b->samples);
+	CU_FREE(b->name);
+	CU_FREE(b);
+}
+
+const cu_benchmark_result* cuBenchmarkRun(CU_NOTNULL cu_benchmark* b, CU_NOTNULL const char* caseName, int size, CU_NULLABLE cu_benchmark_setup setup, CU_NOTNULL cu_benchmark_function function, CU_NULLABLE cu_benchmark_teardown teardown, CU_NULLABLE const struct var_args* context) {
+	online_statistics* statistics = cuOnlineStatisticsNew();
+
+	for (int run=-b->warmupRuns; run<b->runs; run++) {
+		void* state = setup != NULL ? setup(size, context) : NULL;
+		CU_PROFILE_TIME_CODE(elapsed, TM_NANO) {
+			function(state, size, context);
+		}
+		if (teardown != NULL) {
+			teardown(state, context);
+		}
+		if (run >= 0) {
+			b->samples[run] = elapsed;
+			cuOnlineStatisticsUpdate(statistics, elapsed);
+		}
+	}
+	qsort(b->samples, b->runs, sizeof(double), compareDoubles);
+
+	if (b->resultsNumber == b->resultsCapacity) {
+		b->resultsCapacity = b->resultsCapacity == 0 ? 16 : 2 * b->resultsCapacity;
+		b->results = realloc(b->results, sizeof(cu_benchmark_result) * b->resultsCapacity);
+		if (b->results == NULL) {
+			ERROR_MALLOC();
+		}
+	}
+	cu_benchmark_result* result = &b->results[b->resultsNumber++];
+	result->caseName = strdup(caseName);
+	if (result->caseName == NULL) {
+		ERROR_MALLOC();
+	}
+	result->size = size;
+	result->runs = b->runs;
+	result->average = cuOnlineStatisticsGetAverage(statistics);
+	result->standardDeviation = b->runs > 1 ? cuOnlineStatisticsGetStandardDeviation(statistics) : 0;
+	result->min = b->samples[0];
+	result->max = b->samples[b->runs - 1];
+	result->p50 = getPercentile(b->samples, b->runs, 50);
+	result->p90 = getPercentile(b->samples, b->runs, 90);
+	result->p99 = getPercentile(b->samples, b->runs, 99);
+
+	cuOnlineStatisticsDestroy(statistics, NULL);
+	return result;
+}
+
+int cuBenchmarkGetResultsNumber(CU_NOTNULL const cu_benchmark* b) {
+	return b->resultsNumber;
+}
+
+const cu_benchmark_result* cuBenchmarkGetResult(CU_NOTNULL const cu_benchmark* b, int index) {
+	if (index < 0 || index >= b->resultsNumber) {
+		ERROR_OBJECT_NOT_FOUND("benchmark result", "%d", index);
+	}
+	return &b->results[index];
+}
+
+void cuBenchmarkPrint(CU_NOTNULL const cu_benchmark* b, CU_NOTNULL FILE* f) {
+	fprintf(f, "benchmark %s (%d warm-up runs, %d runs, times in us)\n", b->name, b->warmupRuns, b->runs);
+	fprintf(f, "%-40s %10s %12s %12s %12s %12s %12s %12s %12s %10s\n", "case", "size", "average", "stddev", "min", "p50", "p90", "p99", "max", "ns/item");
+	for (int i=0; i<b->resultsNumber; i++) {
+		const cu_benchmark_result* r = &b->results[i];
+		fprintf(f, "%-40s %10d %12.1f %12.1f %12.1f %12.1f %12.1f %12.1f %12.1f %10.2f\n",
+				r->caseName, r->size,
+				r->average / 1000, r->standardDeviation / 1000, r->min / 1000, r->p50 / 1000, r->p90 / 1000, r->p99 / 1000, r->max / 1000,
+				r->average / (r->size > 0 ? r->size : 1)
+		);
+	}
+	fflush(f);
+}
+
+void cuBenchmarkSaveCSV(CU_NOTNULL const cu_benchmark* b, CU_NOTNULL const char* filePath) {
+	const char* header[] = {"benchmark", "case", "size", "runs", "average", "stddev", "min", "p50", "p90", "p99", "max", "nsPerItem"};
+	csv_helper* csv = cuCSVHelperNew(filePath, ',', '\n', "%s %s %d %d %.1f %.1f %.1f %.1f %.1f %.1f %.1f %.3f", header, "w");
+	for (int i=0; i<b->resultsNumber; i++) {
+		const cu_benchmark_result* r = &b->results[i];
+		cuCSVHelperprintDataRow(csv,
+				b->name, r->caseName, r->size, r->runs,
+				r->average, r->standardDeviation, r->min, r->p50, r->p90, r->p99, r->max,
+				r->average / (r->size > 0 ? r->size : 1)
+		);
+	}
+	cuCSVHelperDestroy(csv, NULL);
+}
+
+void cuBenchmarkPlot(CU_NOTNULL const cu_benchmark* b, CU_NOTNULL const char* output) {
+	if (b->resultsNumber == 0) {
+		return;
+	}
+
+	//the indices of the first result of each case and of each size
+	int cases[b->resultsNumber];
+	int casesNumber = 0;
+	int sizes[b->resultsNumber];
+	int sizesNumber = 0;
+
+	for (int i=0; i<b->resultsNumber; i++) {
+		if (getCaseIndex(b, b->results[i].caseName, i) == -1) {
+			cases[casesNumber++] = i;
+		}
+		bool newSize = true;
+		for (int j=0; j<sizesNumber; j++) {
+			if (b->results[sizes[j]].size == b->results[i].size) {
+				newSize = false;
+				break;
+			}
+		}
+		if (newSize) {
+			sizes[sizesNumber++] = i;
+		}
+	}
+
+	plot_2d_helper* helper = cuPlot2DHelperNew(output);
+	cuPlot2DHelperSetTitle(helper, "%s", b->name);
+	cuPlot2DHelperSetXLabelName(helper, "size");
+	cuPlot2DHelperSetYLabelName(helper, "ns per item");
+	cuPlot2DHelperSetXAxisType(helper, AT_LOGARITMIC);
+	cuPlot2DHelperSetGrid(helper, true);
+	for (int i=0; i<casesNumber; i++) {
+		cuPlot2DHelperAddSeries(helper, b->results[cases[i]].caseName, PS_LINESPOINTS);
+	}
+	double ys[casesNumber];
+	for (int s=0; s<sizesNumber; s++) {
+		int size = b->results[sizes[s]].size;
+		for (int c=0; c<casesNumber; c++) {
+			ys[c] = NAN;
+			//the last measurement of a case with a given size wins
+			for (int i=0; i<b->resultsNumber; i++) {
+				const cu_benchmark_result* r = &b->results[i];
+				if (r->size == size && strcmp(r->caseName, b->results[cases[c]].caseName) == 0) {
+					ys[c] = r->average / (size > 0 ? size : 1);
+				}
+			}
+		}
+		cuPlot2DHelperAddPoints(helper, size, ys);
+	}
+	cuPlot2DHelperPlot(helper);
+	cuPlot2DHelperDestroy(helper, NULL);
+}
+
+/**
+ * Order 2 doubles, to be used with @c qsort
+ */
+static int compareDoubles(const void* a, const void* b) {
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * Compute a percentile with the nearest-rank method
+ *
+ * @param[in] sortedSamples the samples, sorted in ascending order
+ * @param[in] n the number of samples
+ * @param[in] percentile the percentile to compute, between 0 and 100
+ * @return the smallest sample such that at least @c percentile percent of the samples are not greater than it
+ */
+static double getPercentile(const double* sortedSamples, int n, double percentile) {
+	int rank = (int) ceil(percentile / 100 * n);
+	if (rank < 1) {
+		rank = 1;
+	}
+	if (rank > n) {
+		rank = n;
+	}
+	return sortedSamples[rank - 1];
+}
+
+/**
+ * @param[in] b the benchmark involved
+ * @param[in] caseName the case to look for
+ * @param[in] before only the results whose index is less than this value are considered
+ * @return the index of the first result of the case or -1 if such case has not been measured
+ */
+static int getCaseIndex(const cu_benchmark* b, const char* caseName, int before) {
+	for (int i=0; i<before; i++) {
+		if (strcmp(b->results[i].caseName, caseName) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,1760 @@
+/**
+ * @file
+ *
+ * @author koldar
+ * @date Oct 16, 2026
+ */
+
+#include "csr_graph.h"
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "errors.h"
+#include "utility.h"
+
+///the first bytes of every file created by ::cuCSRGraphSave
+#define CSR_GRAPH_FILE_MAGIC "CUGRAPH"
+///used to detect files created on a machine with a different endianness
+#define CSR_GRAPH_FILE_BYTE_ORDER 0x01020304
+///number of arrays stored in a graph file
+#define CSR_GRAPH_FILE_SECTIONS 8
+///the initial value of the checksum (the FNV-1a offset basis)
+#define CSR_GRAPH_FILE_CHECKSUM_SEED 0xcbf29ce484222325ULL
+///number of vertices a worker of ::cuCSRGraphParallelBFS takes at once
+#define CSR_BFS_CHUNK_SIZE 1024
+///number of vertices a worker of ::cuCSRGraphParallelBFS reaches before appending them to the next frontier
+#define CSR_BFS_LOCAL_BUFFER_SIZE 256
+///::cuCSRGraphParallelBFS goes bottom up when the out edges of the frontier are more than the edges left to explore divided by this number
+#define CSR_BFS_ALPHA 14
+///::cuCSRGraphParallelBFS goes back top down when the frontier has less vertices than the graph divided by this number
+#define CSR_BFS_BETA 24
+///number of vertices a worker of ::cuCSRGraphParallelComputeSCC takes at once
+#define CSR_SCC_CHUNK_SIZE 1024
+///::cuCSRGraphParallelComputeSCC stops colouring and runs Tarjan algorithm on the calling thread when less vertices than this are left
+#define CSR_SCC_SERIAL_THRESHOLD 10000
+///the component of a vertex which has not been assigned to a component yet
+#define CSR_SCC_ACTIVE UINT_MAX
+///the component of a vertex not included in the computation
+#define CSR_SCC_EXCLUDED (UINT_MAX - 1)
+///number of vertices of a level processed by a worker in ::cuCSRGraphParallelComputeTopologicalLevels before fetching other ones
+#define CSR_TOPOLOGICAL_CHUNK_SIZE 1024
+
+/**
+ * The beginning of a file created by ::cuCSRGraphSave
+ *
+ * After the header there are the arrays of the snapshot, in the order given by ::getSections. Each array is padded with zeros
+ * to a multiple of 8 bytes, so every array in the mapping is correctly aligned
+ */
+struct csr_graph_file_header {
+	///::CSR_GRAPH_FILE_MAGIC
+	char magic[8];
+	///::CU_CSR_GRAPH_FILE_VERSION
+	uint32_t version;
+	///::CSR_GRAPH_FILE_BYTE_ORDER
+	uint32_t byteOrder;
+	///size of ::NodeId
+	uint32_t idSize;
+	///size of a pointer (a payload is stored as a pointer)
+	uint32_t pointerSize;
+	///::csr_graph::size
+	uint64_t size;
+	///::csr_graph::edgesNumber
+	uint64_t edgesNumber;
+	///checksum of everything after the header. See ::updateChecksum
+	uint64_t checksum;
+};
+
+/**
+ * A level of a visit performed by ::cuCSRGraphParallelBFS
+ */
+struct csr_bfs_job {
+	const csr_graph* g;
+	bool (*traverser)(const Edge* edge);
+	///true if the level is visited bottom up, false if it is visited top down
+	bool bottomUp;
+	///the distance of the frontier from the source
+	int level;
+	int* distances;
+	///can be NULL
+	unsigned int* parents;
+	///the vertices reached so far, level after level. The frontier is in <tt>[frontierStart, frontierEnd)</tt>
+	unsigned int* order;
+	unsigned int frontierStart;
+	unsigned int frontierEnd;
+	///the end of the next frontier in ::csr_bfs_job::order. Updated atomically
+	unsigned int tail;
+	///the out edges of the next frontier. Updated atomically
+	unsigned long nextEdges;
+	///the chunks of ::CSR_BFS_CHUNK_SIZE vertices to visit in this level
+	cu_parallel_for loop;
+};
+
+/**
+ * The steps of ::cuCSRGraphParallelComputeSCC performed by the workers
+ *
+ * Some steps work on every vertex of the graph, the others only on the vertices in ::csr_scc_job::frontier.
+ * The steps working on the frontier append the vertices to process in the following step in ::csr_scc_job::nextFrontier
+ */
+enum csr_scc_step {
+	///count the in and out edges of every active vertex coming from or going to other active vertices
+	CSR_SCC_DEGREES,
+	///assign every active vertex with no in edge or no out edge to a component on its own
+	CSR_SCC_SEED,
+	///propagate the removal of the vertices in the frontier to their neighbours, trimming the ones left without in or out edges
+	CSR_SCC_TRIM,
+	///look for the active vertex with the highest product between in and out degree
+	CSR_SCC_PIVOT,
+	///reach the active successors of the frontier
+	CSR_SCC_FORWARD,
+	///reach the predecessors of the frontier reached by the forward visit, assigning them to the component of the pivot
+	CSR_SCC_BACKWARD,
+	///give every active vertex its own dense index as colour
+	CSR_SCC_INIT_COLORS,
+	///push the colours of the frontier to their successors, when they are higher
+	CSR_SCC_PROPAGATE_COLORS,
+	///build the component of every active vertex whose colour is its own dense index
+	CSR_SCC_COLLECT_COLORS
+};
+
+/**
+ * A strongly connected component computation performed by ::cuCSRGraphParallelComputeSCC
+ *
+ * While the computation is ongoing, each component is labelled by the dense index of one of its vertices. The labels are turned into the final
+ * numbering at the end
+ */
+struct csr_scc_job {
+	const csr_graph* g;
+	///the edges which can be traversed. Can be NULL
+	const bool* traversable;
+	///the label of the component of each vertex. ::CSR_SCC_ACTIVE if the vertex has not been assigned yet
+	unsigned int* components;
+	enum csr_scc_step step;
+	///the chunks of ::CSR_SCC_CHUNK_SIZE vertices to process in this step
+	cu_parallel_for loop;
+	///number of vertices assigned to a component so far. Updated atomically
+	unsigned int assigned;
+	///the number of active in edges of each vertex. Updated atomically
+	unsigned int* inDegrees;
+	///the number of active out edges of each vertex. Updated atomically
+	unsigned int* outDegrees;
+	///the best pivot found so far: the score in the upper 32 bits, the dense index in the lower ones. 0 if no pivot has been found. Updated atomically
+	uint64_t pivot;
+	///the label of the component built by the backward visit
+	unsigned int component;
+	///true for the vertices reached by the forward visit or, while colouring, for the vertices in the frontier
+	unsigned char* marks;
+	///the colour of each vertex
+	unsigned int* colors;
+	unsigned int* frontier;
+	unsigned int frontierSize;
+	unsigned int* nextFrontier;
+	///the end of ::csr_scc_job::nextFrontier. Updated atomically
+	unsigned int tail;
+	///the workers. NULL if the computation is performed by the calling thread
+	cu_parallel_thread_pool* pool;
+};
+
+/**
+ * A level of a topological sort performed by ::cuCSRGraphParallelComputeTopologicalLevels
+ */
+struct csr_topological_job {
+	const csr_graph* g;
+	///the number of in edges coming from vertices not sorted yet. Updated atomically
+	unsigned int* inDegrees;
+	///the vertices sorted so far, level after level. The current level is in <tt>[levelStart, levelEnd)</tt>
+	unsigned int* order;
+	unsigned int levelStart;
+	unsigned int levelEnd;
+	///the end of the next level in ::csr_topological_job::order. Updated atomically
+	unsigned int tail;
+	///the chunks of ::CSR_TOPOLOGICAL_CHUNK_SIZE vertices in the current level
+	cu_parallel_for loop;
+};
+
+/**
+ * The state of a worker during a step of ::cuCSRGraphParallelComputeSCC
+ */
+struct csr_scc_worker {
+	///vertices to append to ::csr_scc_job::nextFrontier
+	unsigned int buffer[CSR_BFS_LOCAL_BUFFER_SIZE];
+	unsigned int bufferSize;
+	///number of vertices the worker has assigned to a component
+	unsigned int assigned;
+	///the best pivot found by the worker
+	uint64_t pivot;
+	///stack of the backward visits of ::CSR_SCC_COLLECT_COLORS
+	unsigned int* stack;
+	unsigned int stackCapacity;
+};
+
+static int compareNodeIds(const void* a, const void* b);
+static int compareSinks(const void* a, const void* b);
+static bool canTraverse(CU_NOTNULL const csr_graph* g, CU_NULLABLE bool (*traverser)(const Edge* edge), unsigned int edgeIndex);
+static void getSectionSizes(uint64_t size, uint64_t edgesNumber, size_t* bytes);
+static size_t getPaddedSize(size_t bytes);
+static bool isStructureValid(uint64_t size, uint64_t edgesNumber, CU_NOTNULL const char** sections);
+static uint64_t updateChecksum(uint64_t checksum, const void* data, size_t bytes);
+static enum thread_loop_state visitLevelTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va);
+static void appendToNextFrontier(CU_NOTNULL struct csr_bfs_job* job, CU_NOTNULL const unsigned int* buffer, unsigned int size);
+static void runSCCStep(CU_NOTNULL struct csr_scc_job* job, enum csr_scc_step step, unsigned int work);
+static void swapSCCFrontiers(CU_NOTNULL struct csr_scc_job* job);
+static void trimVertices(CU_NOTNULL struct csr_scc_job* job);
+static void computeSCCByTarjan(CU_NOTNULL struct csr_scc_job* job);
+static unsigned int sortComponentsTopologically(CU_NOTNULL struct csr_scc_job* job);
+static enum thread_loop_state sccStepTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va);
+static void processSCCVertex(CU_NOTNULL struct csr_scc_job* job, CU_NOTNULL struct csr_scc_worker* worker, unsigned int vertex);
+static void collectColor(CU_NOTNULL struct csr_scc_job* job, CU_NOTNULL struct csr_scc_worker* worker, unsigned int root);
+static void pushToNextSCCFrontier(CU_NOTNULL struct csr_scc_job* job, CU_NOTNULL struct csr_scc_worker* worker, unsigned int vertex);
+static void flushSCCWorker(CU_NOTNULL struct csr_scc_job* job, CU_NOTNULL struct csr_scc_worker* worker);
+static bool isSCCEdgeTraversable(CU_NOTNULL const struct csr_scc_job* job, unsigned int edgeIndex);
+static enum thread_loop_state topologicalLevelTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va);
+static int compareDenseIndices(const void* a, const void* b);
+
+/**
+ * Used to sort the out edges of a vertex by sink while building the snapshot
+ */
+struct csr_out_edge {
+	unsigned int sink;
+	Edge* edge;
+};
+
+CU_NOTNULL csr_graph* cuPredSuccGraphFreeze(CU_NOTNULL const PredSuccGraph* g) {
+	csr_graph* result = CU_MALLOC(csr_graph);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+
+	unsigned int size = (unsigned int) cuPredSuccGraphGetVertexNumber(g);
+	result->size = size;
+	result->ids = cuUtilsMallocArray(size, sizeof(NodeId));
+	result->vertexPayloads = cuUtilsMallocArray(size, sizeof(void*));
+	result->successorOffsets = cuUtilsMallocArray(size + 1, sizeof(unsigned int));
+	result->predecessorOffsets = cuUtilsMallocArray(size + 1, sizeof(unsigned int));
+	result->indexOfId = cuFlatHTNew(cuPayloadFunctionsIntValue());
+	cuFlatHTReserve(result->indexOfId, size);
+
+	//dense indices follow the order of the ids, so the snapshot does not depend on the hashtable layout
+	unsigned int i = 0;
+	CU_ITERATE_OVER_HT_VALUES(g->nodes, node, Node*) {
+		result->ids[i] = node->id;
+		i++;
+	}
+	qsort(result->ids, size, sizeof(NodeId), compareNodeIds);
+
+	unsigned int edgesNumber = 0;
+	for (i=0; i<size; i++) {
+		Node* node = cuPredSuccGraphGetNodeById(g, result->ids[i]);
+		cuFlatHTAddItem(result->indexOfId, result->ids[i], CU_CAST_INT2PTR(i + 1));
+		result->vertexPayloads[i] = node->payload;
+		result->successorOffsets[i] = edgesNumber;
+		edgesNumber += (unsigned int) cuHTGetSize(node->successors);
+	}
+	result->successorOffsets[size] = edgesNumber;
+	result->edgesNumber = edgesNumber;
+
+	result->successors = cuUtilsMallocArray(edgesNumber, sizeof(unsigned int));
+	result->edgePayloads = cuUtilsMallocArray(edgesNumber, sizeof(void*));
+	result->edges = cuUtilsMallocArray(edgesNumber, sizeof(Edge*));
+	result->predecessors = cuUtilsMallocArray(edgesNumber, sizeof(unsigned int));
+	result->predecessorEdges = cuUtilsMallocArray(edgesNumber, sizeof(unsigned int));
+
+	//fill the successors
+	struct csr_out_edge* buffer = NULL;
+	size_t bufferSize = 0;
+	unsigned int* inDegree = calloc(size + 1, sizeof(unsigned int));
+	if (inDegree == NULL) {
+		ERROR_MALLOC();
+	}
+	for (i=0; i<size; i++) {
+		Node* node = cuPredSuccGraphGetNodeById(g, result->ids[i]);
+		size_t outDegree = result->successorOffsets[i + 1] - result->successorOffsets[i];
+		if (outDegree > bufferSize) {
+			bufferSize = outDegree * 2;
+			buffer = realloc(buffer, sizeof(struct csr_out_edge) * bufferSize);
+			if (buffer == NULL) {
+				ERROR_MALLOC();
+			}
+		}
+		size_t j = 0;
+		CU_ITERATE_OVER_HT_VALUES(node->successors, edge, Edge*) {
+			buffer[j].sink = (unsigned int)(CU_CAST_PTR2INT(cuFlatHTGetItem(result->indexOfId, edge->sink->id)) - 1);
+			buffer[j].edge = edge;
+			j++;
+		}
+		qsort(buffer, outDegree, sizeof(struct csr_out_edge), compareSinks);
+		for (j=0; j<outDegree; j++) {
+			unsigned int edgeIndex = result->successorOffsets[i] + j;
+			result->successors[edgeIndex] = buffer[j].sink;
+			result->edges[edgeIndex] = buffer[j].edge;
+			result->edgePayloads[edgeIndex] = buffer[j].edge->payload;
+			inDegree[buffer[j].sink] += 1;
+		}
+	}
+	CU_FREE(buffer);
+
+	//fill the predecessors by counting sort: since we scan the sources in order, the predecessors of each vertex are sorted as well
+	unsigned int offset = 0;
+	for (i=0; i<size; i++) {
+		result->predecessorOffsets[i] = offset;
+		offset += inDegree[i];
+		inDegree[i] = result->predecessorOffsets[i];
+	}
+	result->predecessorOffsets[size] = offset;
+	for (i=0; i<size; i++) {
+		for (unsigned int e=result->successorOffsets[i]; e<result->successorOffsets[i + 1]; e++) {
+			unsigned int sink = result->successors[e];
+			result->predecessors[inDegree[sink]] = i;
+			result->predecessorEdges[inDegree[sink]] = e;
+			inDegree[sink] += 1;
+		}
+	}
+	CU_FREE(inDegree);
+
+	result->mapping = NULL;
+	result->mappingSize = 0;
+
+	return result;
+}
+
+void cuCSRGraphSave(CU_NOTNULL const csr_graph* g, CU_NOTNULL const char* filePath) {
+	const void* sections[CSR_GRAPH_FILE_SECTIONS] = {
+			g->ids, g->vertexPayloads, g->successorOffsets, g->successors,
+			g->edgePayloads, g->predecessorOffsets, g->predecessors, g->predecessorEdges
+	};
+	size_t bytes[CSR_GRAPH_FILE_SECTIONS];
+	getSectionSizes(g->size, g->edgesNumber, bytes);
+
+	struct csr_graph_file_header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CSR_GRAPH_FILE_MAGIC, sizeof(CSR_GRAPH_FILE_MAGIC));
+	header.version = CU_CSR_GRAPH_FILE_VERSION;
+	header.byteOrder = CSR_GRAPH_FILE_BYTE_ORDER;
+	header.idSize = sizeof(NodeId);
+	header.pointerSize = sizeof(void*);
+	header.size = g->size;
+	header.edgesNumber = g->edgesNumber;
+	header.checksum = CSR_GRAPH_FILE_CHECKSUM_SEED;
+	for (int i=0; i<CSR_GRAPH_FILE_SECTIONS; i++) {
+		header.checksum = updateChecksum(header.checksum, sections[i], bytes[i]);
+	}
+
+	FILE* f = fopen(filePath, "wb");
+	if (f == NULL) {
+		ERROR_FILE(filePath);
+	}
+	static const char padding[8] = {0};
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+	for (int i=0; ok && i<CSR_GRAPH_FILE_SECTIONS; i++) {
+		ok = fwrite(sections[i], 1, bytes[i], f) == bytes[i];
+		size_t paddingSize = getPaddedSize(bytes[i]) - bytes[i];
+		ok = ok && fwrite(padding, 1, paddingSize, f) == paddingSize;
+	}
+	if (fclose(f) != 0 || !ok) {
+		ERROR_FILE(filePath);
+	}
+}
+
+CU_NULLABLE csr_graph* cuCSRGraphMap(CU_NOTNULL const char* filePath, bool verifyChecksum) {
+	int fd = open(filePath, O_RDONLY);
+	if (fd < 0) {
+		ERROR_FILE(filePath);
+	}
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0) {
+		ERROR_FILE(filePath);
+	}
+	size_t fileSize = fileStat.st_size;
+	if (fileSize < sizeof(struct csr_graph_file_header)) {
+		close(fd);
+		return NULL;
+	}
+	void* mapping = mmap(NULL, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED) {
+		ERROR_FILE(filePath);
+	}
+
+	const struct csr_graph_file_header* header = mapping;
+	bool valid = memcmp(header->magic, CSR_GRAPH_FILE_MAGIC, sizeof(CSR_GRAPH_FILE_MAGIC)) == 0
+			&& header->version == CU_CSR_GRAPH_FILE_VERSION
+			&& header->byteOrder == CSR_GRAPH_FILE_BYTE_ORDER
+			&& header->idSize == sizeof(NodeId)
+			&& header->pointerSize == sizeof(void*)
+			&& header->size < UINT32_MAX
+			&& header->edgesNumber <= UINT32_MAX;
+
+	size_t bytes[CSR_GRAPH_FILE_SECTIONS];
+	const char* sections[CSR_GRAPH_FILE_SECTIONS];
+	if (valid) {
+		getSectionSizes(header->size, header->edgesNumber, bytes);
+		size_t expectedSize = sizeof(struct csr_graph_file_header);
+		for (int i=0; i<CSR_GRAPH_FILE_SECTIONS; i++) {
+			sections[i] = ((const char*) mapping) + expectedSize;
+			expectedSize += getPaddedSize(bytes[i]);
+		}
+		valid = expectedSize == fileSize;
+	}
+	//the algorithms index the arrays with the offsets and the dense indices: a corrupted file must not make them read outside the mapping
+	valid = valid && isStructureValid(header->size, header->edgesNumber, sections);
+	if (valid && verifyChecksum) {
+		uint64_t checksum = CSR_GRAPH_FILE_CHECKSUM_SEED;
+		for (int i=0; i<CSR_GRAPH_FILE_SECTIONS; i++) {
+			checksum = updateChecksum(checksum, sections[i], bytes[i]);
+		}
+		valid = checksum == header->checksum;
+	}
+	if (!valid) {
+		munmap(mapping, fileSize);
+		return NULL;
+	}
+
+	csr_graph* result = CU_MALLOC(csr_graph);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+	result->size = (unsigned int) header->size;
+	result->edgesNumber = (unsigned int) header->edgesNumber;
+	result->ids = (NodeId*) sections[0];
+	result->vertexPayloads = (void**) sections[1];
+	result->successorOffsets = (unsigned int*) sections[2];
+	result->successors = (unsigned int*) sections[3];
+	result->edgePayloads = (void**) sections[4];
+	result->predecessorOffsets = (unsigned int*) sections[5];
+	result->predecessors = (unsigned int*) sections[6];
+	result->predecessorEdges = (unsigned int*) sections[7];
+	result->indexOfId = NULL;
+	result->edges = NULL;
+	result->mapping = mapping;
+	result->mappingSize = fileSize;
+
+	return result;
+}
+
+CU_DEFINE_DEFAULT_VALUES(cuCSRGraphMap,
+		,
+		true
+);
+
+CU_NOTNULL PredSuccGraph* cuCSRGraphThaw(CU_NOTNULL const csr_graph* g, bool enablePredecessors, payload_functions vertexPayload, payload_functions edgePayload) {
+	PredSuccGraph* result = cuPredSuccGraphNew(enablePredecessors, vertexPayload, edgePayload);
+	Node** nodes = cuUtilsMallocArray(g->size, sizeof(Node*));
+
+	for (unsigned int i=0; i<g->size; i++) {
+		nodes[i] = cuPredSuccGraphAddNodeInGraphById(result, g->ids[i], g->vertexPayloads[i]);
+	}
+	for (unsigned int i=0; i<g->size; i++) {
+		CU_ITERATE_OVER_CSR_SUCCESSORS(g, i, sink, e) {
+			_cuPredSuccGraphAddEdge(nodes[i], nodes[sink], g->edgePayloads[e]);
+		}
+	}
+
+	CU_FREE(nodes);
+	return result;
+}
+
+void cuCSRGraphDestroy(CU_NOTNULL const csr_graph* g, CU_NULLABLE const struct var_args* context) {
+	if (g->mapping != NULL) {
+		//the arrays live inside the file
+		munmap(g->mapping, g->mappingSize);
+		CU_FREE(g);
+		return;
+	}
+	cuFlatHTDestroy(g->indexOfId, context);
+	CU_FREE(g->ids);
+	CU_FREE(g->vertexPayloads);
+	CU_FREE(g->successorOffsets);
+	CU_FREE(g->successors);
+	CU_FREE(g->edgePayloads);
+	CU_FREE(g->edges);
+	CU_FREE(g->predecessorOffsets);
+	CU_FREE(g->predecessors);
+	CU_FREE(g->predecessorEdges);
+	CU_FREE(g);
+}
+
+long cuCSRGraphGetIndexOfVertex(CU_NOTNULL const csr_graph* g, NodeId id) {
+	if (g->indexOfId == NULL) {
+		//ids are sorted
+		unsigned int low = 0;
+		unsigned int high = g->size;
+		while (low < high) {
+			unsigned int middle = low + (high - low) / 2;
+			if (g->ids[middle] < id) {
+				low = middle + 1;
+			} else {
+				high = middle;
+			}
+		}
+		return (low < g->size && g->ids[low] == id) ? (long) low : -1;
+	}
+	return ((long) CU_CAST_PTR2INT(cuFlatHTGetItem(g->indexOfId, id))) - 1;
+}
+
+unsigned int cuCSRGraphGetOutDegree(CU_NOTNULL const csr_graph* g, unsigned int index) {
+	return g->successorOffsets[index + 1] - g->successorOffsets[index];
+}
+
+unsigned int cuCSRGraphGetInDegree(CU_NOTNULL const csr_graph* g, unsigned int index) {
+	return g->predecessorOffsets[index + 1] - g->predecessorOffsets[index];
+}
+
+unsigned int cuCSRGraphBFS(CU_NOTNULL const csr_graph* g, unsigned int source, CU_NULLABLE bool (*traverser)(const Edge* edge), CU_NOTNULL unsigned int* order, CU_NULLABLE int* distances) {
+	bool* visited = calloc(g->size, sizeof(bool));
+	if (visited == NULL) {
+		ERROR_MALLOC();
+	}
+	if (distances != NULL) {
+		for (unsigned int i=0; i<g->size; i++) {
+			distances[i] = -1;
+		}
+		distances[source] = 0;
+	}
+
+	//order is used as the queue of the visit itself
+	unsigned int head = 0;
+	unsigned int tail = 0;
+	order[tail++] = source;
+	visited[source] = true;
+	while (head < tail) {
+		unsigned int current = order[head++];
+		CU_ITERATE_OVER_CSR_SUCCESSORS(g, current, sink, e) {
+			if (visited[sink] || !canTraverse(g, traverser, e)) {
+				continue;
+			}
+			visited[sink] = true;
+			if (distances != NULL) {
+				distances[sink] = distances[current] + 1;
+			}
+			order[tail++] = sink;
+		}
+	}
+
+	CU_FREE(visited);
+	return tail;
+}
+
+unsigned int cuCSRGraphParallelBFS(CU_NOTNULL const csr_graph* g, unsigned int source, CU_NULLABLE cu_bfs_edge_filter traverser, CU_NULLABLE cu_parallel_thread_pool* pool, CU_NULLABLE unsigned int* order, CU_NULLABLE int* distances, CU_NULLABLE unsigned int* parents, CU_NULLABLE cu_bfs_level_visitor visitor, CU_NULLABLE const struct var_args* context) {
+	struct csr_bfs_job job;
+	job.g = g;
+	job.traverser = traverser;
+	job.bottomUp = false;
+	job.level = 0;
+	job.distances = distances != NULL ? distances : cuUtilsMallocArray(g->size, sizeof(int));
+	job.parents = parents;
+	job.order = order != NULL ? order : cuUtilsMallocArray(g->size, sizeof(unsigned int));
+	for (unsigned int i=0; i<g->size; i++) {
+		job.distances[i] = -1;
+	}
+	if (parents != NULL) {
+		for (unsigned int i=0; i<g->size; i++) {
+			parents[i] = UINT_MAX;
+		}
+		parents[source] = source;
+	}
+	job.distances[source] = 0;
+	job.order[0] = source;
+	job.frontierStart = 0;
+	job.frontierEnd = 1;
+
+	struct csr_bfs_job* jobPtr = &job;
+	cuInitVarArgsOnStack(va, jobPtr);
+
+	unsigned long frontierEdges = cuCSRGraphGetOutDegree(g, source);
+	//edges going out of the vertices not reached yet
+	unsigned long unexploredEdges = g->edgesNumber - frontierEdges;
+	unsigned int previousFrontierSize = 0;
+	while (job.frontierStart < job.frontierEnd) {
+		unsigned int frontierSize = job.frontierEnd - job.frontierStart;
+		if (visitor != NULL && !visitor(g, job.level, &job.order[job.frontierStart], frontierSize, context)) {
+			break;
+		}
+
+		bool growing = frontierSize > previousFrontierSize;
+		if (!job.bottomUp && growing && frontierEdges > (unexploredEdges / CSR_BFS_ALPHA)) {
+			job.bottomUp = true;
+		} else if (job.bottomUp && !growing && frontierSize < (g->size / CSR_BFS_BETA)) {
+			job.bottomUp = false;
+		}
+
+		unsigned int work = job.bottomUp ? g->size : frontierSize;
+		job.tail = job.frontierEnd;
+		job.nextEdges = 0;
+		cuParallelThreadPoolFor(pool, visitLevelTask, va, &job.loop, (work + CSR_BFS_CHUNK_SIZE - 1) / CSR_BFS_CHUNK_SIZE);
+
+		previousFrontierSize = frontierSize;
+		frontierEdges = job.nextEdges;
+		unexploredEdges -= frontierEdges;
+		job.frontierStart = job.frontierEnd;
+		job.frontierEnd = job.tail;
+		job.level++;
+	}
+
+	if (distances == NULL) {
+		CU_FREE(job.distances);
+	}
+	if (order == NULL) {
+		CU_FREE(job.order);
+	}
+	return job.frontierEnd;
+}
+
+CU_DEFINE_DEFAULT_VALUES(cuCSRGraphParallelBFS,
+		,
+		,
+		NULL,
+		NULL,
+		NULL,
+		NULL,
+		NULL,
+		NULL,
+		NULL
+);
+
+unsigned int cuPredSuccGraphParallelBFS(CU_NOTNULL const PredSuccGraph* g, NodeId sourceId, CU_NULLABLE cu_bfs_edge_filter traverser, CU_NULLABLE cu_parallel_thread_pool* pool, CU_NULLABLE pint_ht* distances, CU_NULLABLE pint_ht* parents, CU_NULLABLE const csr_graph* snapshot) {
+	const csr_graph* csr = snapshot != NULL ? snapshot : cuPredSuccGraphFreeze(g);
+	long source = cuCSRGraphGetIndexOfVertex(csr, sourceId);
+	if (source < 0) {
+		ERROR_OBJECT_NOT_FOUND("source", "%ld", sourceId);
+	}
+
+	unsigned int* order = cuUtilsMallocArray(csr->size, sizeof(unsigned int));
+	int* csrDistances = cuUtilsMallocArray(csr->size, sizeof(int));
+	unsigned int* csrParents = parents != NULL ? cuUtilsMallocArray(csr->size, sizeof(unsigned int)) : NULL;
+	unsigned int result = cuCSRGraphParallelBFS(csr, source, traverser, pool, order, csrDistances, csrParents);
+
+	for (unsigned int i=0; i<result; i++) {
+		unsigned int vertex = order[i];
+		if (distances != NULL) {
+			cuHTAddOrUpdateItem(distances, csr->ids[vertex], CU_CAST_INT2PTR(csrDistances[vertex]));
+		}
+		if (parents != NULL) {
+			cuHTAddOrUpdateItem(parents, csr->ids[vertex], CU_CAST_UL2PTR(csr->ids[csrParents[vertex]]));
+		}
+	}
+
+	if (csrParents != NULL) {
+		CU_FREE(csrParents);
+	}
+	CU_FREE(csrDistances);
+	CU_FREE(order);
+	if (snapshot == NULL) {
+		cuCSRGraphDestroy(csr, NULL);
+	}
+	return result;
+}
+
+CU_DEFINE_DEFAULT_VALUES(cuPredSuccGraphParallelBFS,
+		,
+		,
+		NULL,
+		NULL,
+		NULL,
+		NULL,
+		NULL
+);
+
+unsigned int cuCSRGraphDFS(CU_NOTNULL const csr_graph* g, unsigned int source, CU_NULLABLE bool (*traverser)(const Edge* edge), CU_NOTNULL unsigned int* order) {
+	bool* visited = calloc(g->size, sizeof(bool));
+	//the stack contains the vertices whose successors are still to be scanned. nextEdge[i] is the next edge of the i-th vertex in the stack to scan
+	unsigned int* stack = cuUtilsMallocArray(g->size, sizeof(unsigned int));
+	unsigned int* nextEdge = cuUtilsMallocArray(g->size, sizeof(unsigned int));
+	if (visited == NULL) {
+		ERROR_MALLOC();
+	}
+
+	unsigned int visitedNumber = 0;
+	unsigned int top = 0;
+	stack[top] = source;
+	nextEdge[top] = g->successorOffsets[source];
+	top++;
+	visited[source] = true;
+	order[visitedNumber++] = source;
+	while (top > 0) {
+		unsigned int current = stack[top - 1];
+		unsigned int e = nextEdge[top - 1];
+		if (e == g->successorOffsets[current + 1]) {
+			top--;
+			continue;
+		}
+		nextEdge[top - 1] = e + 1;
+		unsigned int sink = g->successors[e];
+		if (visited[sink] || !canTraverse(g, traverser, e)) {
+			continue;
+		}
+		visited[sink] = true;
+		order[visitedNumber++] = sink;
+		stack[top] = sink;
+		nextEdge[top] = g->successorOffsets[sink];
+		top++;
+	}
+
+	CU_FREE(nextEdge);
+	CU_FREE(stack);
+	CU_FREE(visited);
+	return visitedNumber;
+}
+
+bool cuCSRGraphIsVertexReachableFromVertex(CU_NOTNULL const csr_graph* g, NodeId sourceId, NodeId sinkId, CU_NULLABLE bool (*traverser)(const Edge* edge)) {
+	long source = cuCSRGraphGetIndexOfVertex(g, sourceId);
+	if (source < 0) {
+		ERROR_OBJECT_NOT_FOUND("source", "%ld", sourceId);
+	}
+	long sink = cuCSRGraphGetIndexOfVertex(g, sinkId);
+	if (sink < 0) {
+		ERROR_OBJECT_NOT_FOUND("sink", "%ld", sinkId);
+	}
+	if (source == sink) {
+		return true;
+	}
+
+	bool result = false;
+	bool* visited = calloc(g->size, sizeof(bool));
+	unsigned int* queue = cuUtilsMallocArray(g->size, sizeof(unsigned int));
+	if (visited == NULL) {
+		ERROR_MALLOC();
+	}
+
+	unsigned int head = 0;
+	unsigned int tail = 0;
+	queue[tail++] = (unsigned int) source;
+	visited[source] = true;
+	while (head < tail && !result) {
+		unsigned int current = queue[head++];
+		CU_ITERATE_OVER_CSR_SUCCESSORS(g, current, next, e) {
+			if (visited[next] || !canTraverse(g, traverser, e)) {
+				continue;
+			}
+			if (next == sink) {
+				result = true;
+				break;
+			}
+			visited[next] = true;
+			queue[tail++] = next;
+		}
+	}
+
+	CU_FREE(queue);
+	CU_FREE(visited);
+	return result;
+}
+
+unsigned int cuCSRGraphComputeSCC(CU_NOTNULL const csr_graph* g, CU_NOTNULL unsigned int* components) {
+	const unsigned int UNVISITED = 0;
+	unsigned int size = g->size;
+	//index[v] is the DFS discovery time of v plus 1 (0 if not visited yet)
+	unsigned int* index = calloc(size, sizeof(unsigned int));
+	unsigned int* lowLink = cuUtilsMallocArray(size, sizeof(unsigned int));
+	bool* onStack = calloc(size, sizeof(bool));
+	//the vertices waiting to be assigned to a component
+	unsigned int* sccStack = cuUtilsMallocArray(size, sizeof(unsigned int));
+	//the DFS call stack: the vertex and the next out edge to scan
+	unsigned int* callStack = cuUtilsMallocArray(size, sizeof(unsigned int));
+	unsigned int* nextEdge = cuUtilsMallocArray(size, sizeof(unsigned int));
+	if (index == NULL || onStack == NULL) {
+		ERROR_MALLOC();
+	}
+
+	unsigned int nextIndex = 1;
+	unsigned int sccTop = 0;
+	unsigned int componentsNumber = 0;
+
+	for (unsigned int root=0; root<size; root++) {
+		if (index[root] != UNVISITED) {
+			continue;
+		}
+
+		unsigned int callTop = 0;
+		callStack[callTop] = root;
+		nextEdge[callTop] = g->successorOffsets[root];
+		callTop++;
+		index[root] = lowLink[root] = nextIndex++;
+		sccStack[sccTop++] = root;
+		onStack[root] = true;
+
+		while (callTop > 0) {
+			unsigned int v = callStack[callTop - 1];
+			unsigned int e = nextEdge[callTop - 1];
+
+			if (e < g->successorOffsets[v + 1]) {
+				nextEdge[callTop - 1] = e + 1;
+				unsigned int w = g->successors[e];
+				if (index[w] == UNVISITED) {
+					//"recursive call" on w
+					index[w] = lowLink[w] = nextIndex++;
+					sccStack[sccTop++] = w;
+					onStack[w] = true;
+					callStack[callTop] = w;
+					nextEdge[callTop] = g->successorOffsets[w];
+					callTop++;
+				} else if (onStack[w] && index[w] < lowLink[v]) {
+					lowLink[v] = index[w];
+				}
+				continue;
+			}
+
+			//every successor of v has been scanned
+			if (lowLink[v] == index[v]) {
+				unsigned int w;
+				do {
+					w = sccStack[--sccTop];
+					onStack[w] = false;
+					components[w] = componentsNumber;
+				} while (w != v);
+				componentsNumber++;
+			}
+			callTop--;
+			if (callTop > 0) {
+				unsigned int parent = callStack[callTop - 1];
+				if (lowLink[v] < lowLink[parent]) {
+					lowLink[parent] = lowLink[v];
+				}
+			}
+		}
+	}
+
+	CU_FREE(nextEdge);
+	CU_FREE(callStack);
+	CU_FREE(sccStack);
+	CU_FREE(onStack);
+	CU_FREE(lowLink);
+	CU_FREE(index);
+	return componentsNumber;
+}
+
+unsigned int cuCSRGraphParallelComputeSCC(CU_NOTNULL const csr_graph* g, CU_NULLABLE const bool* included, CU_NULLABLE const bool* traversable, CU_NULLABLE cu_parallel_thread_pool* pool, CU_NOTNULL unsigned int* components) {
+	struct csr_scc_job job;
+	job.g = g;
+	job.traversable = traversable;
+	job.components = components;
+	job.assigned = 0;
+	job.pool = pool;
+
+	unsigned int total = 0;
+	for (unsigned int i=0; i<g->size; i++) {
+		if (included == NULL || included[i]) {
+			components[i] = CSR_SCC_ACTIVE;
+			total++;
+		} else {
+			components[i] = CSR_SCC_EXCLUDED;
+		}
+	}
+
+	if (pool != NULL && cuParallelThreadPoolGetThreadsNumber(pool) > 1 && total > CSR_SCC_SERIAL_THRESHOLD) {
+		job.inDegrees = cuUtilsMallocArray(g->size, sizeof(unsigned int));
+		job.outDegrees = cuUtilsMallocArray(g->size, sizeof(unsigned int));
+		job.marks = calloc(g->size > 0 ? g->size : 1, sizeof(unsigned char));
+		if (job.marks == NULL) {
+			ERROR_MALLOC();
+		}
+		job.frontier = cuUtilsMallocArray(g->size, sizeof(unsigned int));
+		job.nextFrontier = cuUtilsMallocArray(g->size, sizeof(unsigned int));
+
+		trimVertices(&job);
+
+		//the component of the pivot is the intersection between the vertices reachable from it and the ones reaching it
+		if (job.assigned < total) {
+			job.pivot = 0;
+			runSCCStep(&job, CSR_SCC_PIVOT, g->size);
+			unsigned int pivot = (unsigned int) (job.pivot & UINT_MAX);
+			job.marks[pivot] = true;
+			job.frontier[0] = pivot;
+			job.frontierSize = 1;
+			while (job.frontierSize > 0) {
+				runSCCStep(&job, CSR_SCC_FORWARD, job.frontierSize);
+				swapSCCFrontiers(&job);
+			}
+			job.component = pivot;
+			components[pivot] = pivot;
+			job.assigned++;
+			job.frontier[0] = pivot;
+			job.frontierSize = 1;
+			while (job.frontierSize > 0) {
+				runSCCStep(&job, CSR_SCC_BACKWARD, job.frontierSize);
+				swapSCCFrontiers(&job);
+			}
+			trimVertices(&job);
+		}
+
+		//each colour is the highest dense index reaching a vertex. The vertices of a colour reaching back the vertex with such index are a component
+		if ((total - job.assigned) > CSR_SCC_SERIAL_THRESHOLD) {
+			job.colors = cuUtilsMallocArray(g->size, sizeof(unsigned int));
+			memset(job.marks, 0, sizeof(unsigned char) * g->size);
+			while ((total - job.assigned) > CSR_SCC_SERIAL_THRESHOLD) {
+				runSCCStep(&job, CSR_SCC_INIT_COLORS, g->size);
+				swapSCCFrontiers(&job);
+				while (job.frontierSize > 0) {
+					runSCCStep(&job, CSR_SCC_PROPAGATE_COLORS, job.frontierSize);
+					swapSCCFrontiers(&job);
+				}
+				runSCCStep(&job, CSR_SCC_COLLECT_COLORS, g->size);
+				trimVertices(&job);
+			}
+			CU_FREE(job.colors);
+		}
+
+		CU_FREE(job.nextFrontier);
+		CU_FREE(job.frontier);
+		CU_FREE(job.marks);
+		CU_FREE(job.outDegrees);
+		CU_FREE(job.inDegrees);
+	}
+
+	if (job.assigned < total) {
+		computeSCCByTarjan(&job);
+	}
+	return sortComponentsTopologically(&job);
+}
+
+bool cuCSRGraphComputeTopologicalOrder(CU_NOTNULL const csr_graph* g, CU_NOTNULL unsigned int* order) {
+	unsigned int* inDegree = cuUtilsMallocArray(g->size, sizeof(unsigned int));
+
+	//order is used as the queue of the vertices with no incoming edges left
+	unsigned int head = 0;
+	unsigned int tail = 0;
+	for (unsigned int i=0; i<g->size; i++) {
+		inDegree[i] = cuCSRGraphGetInDegree(g, i);
+		if (inDegree[i] == 0) {
+			order[tail++] = i;
+		}
+	}
+	while (head < tail) {
+		unsigned int current = order[head++];
+		CU_ITERATE_OVER_CSR_SUCCESSORS(g, current, sink, e) {
+			inDegree[sink] -= 1;
+			if (inDegree[sink] == 0) {
+				order[tail++] = sink;
+			}
+		}
+	}
+
+	CU_FREE(inDegree);
+	return tail == g->size;
+}
+
+bool cuCSRGraphParallelComputeTopologicalLevels(CU_NOTNULL const csr_graph* g, CU_NULLABLE cu_parallel_thread_pool* pool, CU_NOTNULL unsigned int* order, CU_NOTNULL unsigned int* levels, CU_NOTNULL unsigned int* levelsNumber) {
+	struct csr_topological_job job;
+	job.g = g;
+	job.inDegrees = cuUtilsMallocArray(g->size, sizeof(unsigned int));
+	job.order = order;
+	job.levelStart = 0;
+	job.levelEnd = 0;
+	for (unsigned int i=0; i<g->size; i++) {
+		job.inDegrees[i] = cuCSRGraphGetInDegree(g, i);
+		if (job.inDegrees[i] == 0) {
+			order[job.levelEnd++] = i;
+		}
+	}
+
+	struct csr_topological_job* jobPtr = &job;
+	cuInitVarArgsOnStack(va, jobPtr);
+
+	*levelsNumber = 0;
+	while (job.levelStart < job.levelEnd) {
+		levels[(*levelsNumber)++] = job.levelStart;
+
+		job.tail = job.levelEnd;
+		cuParallelThreadPoolFor(pool, topologicalLevelTask, va, &job.loop, (job.levelEnd - job.levelStart + CSR_TOPOLOGICAL_CHUNK_SIZE - 1) / CSR_TOPOLOGICAL_CHUNK_SIZE);
+
+		//the workers append the vertices in any order
+		qsort(&order[job.levelEnd], job.tail - job.levelEnd, sizeof(unsigned int), compareDenseIndices);
+		job.levelStart = job.levelEnd;
+		job.levelEnd = job.tail;
+	}
+	levels[*levelsNumber] = job.levelEnd;
+
+	CU_FREE(job.inDegrees);
+	return job.levelEnd == g->size;
+}
+
+static int compareNodeIds(const void* a, const void* b) {
+	NodeId ida = *((const NodeId*)a);
+	NodeId idb = *((const NodeId*)b);
+	return (ida > idb) - (ida < idb);
+}
+
+static int compareDenseIndices(const void* a, const void* b) {
+	unsigned int ia = *((const unsigned int*)a);
+	unsigned int ib = *((const unsigned int*)b);
+	return (ia > ib) - (ia < ib);
+}
+
+static int compareSinks(const void* a, const void* b) {
+	unsigned int sa = ((const struct csr_out_edge*)a)->sink;
+	unsigned int sb = ((const struct csr_out_edge*)b)->sink;
+	return (sa > sb) - (sa < sb);
+}
+
+/**
+ * @private
+ *
+ * @param[in] g the snapshot involved
+ * @param[in] traverser the function to check. Can be NULL
+ * @param[in] edgeIndex the index of the edge in the snapshot
+ * @return true if the edge can be traversed
+ */
+static bool canTraverse(CU_NOTNULL const csr_graph* g, CU_NULLABLE bool (*traverser)(const Edge* edge), unsigned int edgeIndex) {
+	if (traverser == NULL) {
+		return true;
+	}
+	if (g->edges != NULL) {
+		return traverser(g->edges[edgeIndex]);
+	}
+
+	//the snapshot has been mapped from a file: there is no edge, so we build a temporary one. The source is the last vertex whose out edges start before edgeIndex
+	unsigned int low = 0;
+	unsigned int high = g->size;
+	while ((high - low) > 1) {
+		unsigned int middle = low + (high - low) / 2;
+		if (g->successorOffsets[middle] <= edgeIndex) {
+			low = middle;
+		} else {
+			high = middle;
+		}
+	}
+	unsigned int sinkIndex = g->successors[edgeIndex];
+	Node source = {.id = g->ids[low], .successors = NULL, .predecessors = NULL, .payload = g->vertexPayloads[low], .allocator = NULL};
+	Node sink = {.id = g->ids[sinkIndex], .successors = NULL, .predecessors = NULL, .payload = g->vertexPayloads[sinkIndex], .allocator = NULL};
+	Edge edge = {.source = &source, .sink = &sink, .payload = g->edgePayloads[edgeIndex]};
+	return traverser(&edge);
+}
+
+/**
+ * @private
+ *
+ * @param[in] size the number of vertices of the snapshot
+ * @param[in] edgesNumber the number of edges of the snapshot
+ * @param[out] bytes an array of ::CSR_GRAPH_FILE_SECTIONS cells. When the function returns, it contains the size of each array in a graph file, without padding
+ */
+static void getSectionSizes(uint64_t size, uint64_t edgesNumber, size_t* bytes) {
+	bytes[0] = size * sizeof(NodeId);
+	bytes[1] = size * sizeof(void*);
+	bytes[2] = (size + 1) * sizeof(unsigned int);
+	bytes[3] = edgesNumber * sizeof(unsigned int);
+	bytes[4] = edgesNumber * sizeof(void*);
+	bytes[5] = (size + 1) * sizeof(unsigned int);
+	bytes[6] = edgesNumber * sizeof(unsigned int);
+	bytes[7] = edgesNumber * sizeof(unsigned int);
+}
+
+/**
+ * @private
+ *
+ * @param[in] bytes size of an array
+ * @return the size of the array in a graph file, namely @c bytes rounded up to a multiple of 8
+ */
+static size_t getPaddedSize(size_t bytes) {
+	return (bytes + 7) & ~((size_t) 7);
+}
+
+/**
+ * Check that the arrays of a graph file describe a well formed snapshot
+ *
+ * The offsets need to start from 0, be non decreasing and end with the number of edges, the dense indices need to be less than the number
+ * of vertices and the ids need to be sorted, since ::cuCSRGraphGetIndexOfVertex binary searches them. Payloads are not checked.
+ *
+ * @private
+ *
+ * @param[in] size the number of vertices stored in the header
+ * @param[in] edgesNumber the number of edges stored in the header
+ * @param[in] sections the beginning of each array inside the mapping
+ * @return true if the arrays can be safely used by the algorithms
+ */
+static bool isStructureValid(uint64_t size, uint64_t edgesNumber, CU_NOTNULL const char** sections) {
+	const NodeId* ids = (const NodeId*) sections[0];
+	const unsigned int* successorOffsets = (const unsigned int*) sections[2];
+	const unsigned int* successors = (const unsigned int*) sections[3];
+	const unsigned int* predecessorOffsets = (const unsigned int*) sections[5];
+	const unsigned int* predecessors = (const unsigned int*) sections[6];
+	const unsigned int* predecessorEdges = (const unsigned int*) sections[7];
+
+	if (successorOffsets[0] != 0 || successorOffsets[size] != edgesNumber || predecessorOffsets[0] != 0 || predecessorOffsets[size] != edgesNumber) {
+		return false;
+	}
+	for (uint64_t i=0; i<size; i++) {
+		if (successorOffsets[i] > successorOffsets[i + 1] || predecessorOffsets[i] > predecessorOffsets[i + 1]) {
+			return false;
+		}
+		if (i > 0 && ids[i - 1] >= ids[i]) {
+			return false;
+		}
+	}
+	for (uint64_t e=0; e<edgesNumber; e++) {
+		if (successors[e] >= size || predecessors[e] >= size || predecessorEdges[e] >= edgesNumber) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Add an array to the checksum of a graph file
+ *
+ * The checksum is FNV-1a working on 8 bytes words rather than on single bytes, so it can be computed on huge files quickly.
+ * The last word of the array is padded with zeros, like in the file
+ *
+ * @private
+ *
+ * @param[in] checksum the checksum so far
+ * @param[in] data the array to add
+ * @param[in] bytes size of @c data
+ * @return the new checksum
+ */
+static uint64_t updateChecksum(uint64_t checksum, const void* data, size_t bytes) {
+	const char* p = data;
+	uint64_t word;
+	size_t i = 0;
+	for (; (i + sizeof(word)) <= bytes; i += sizeof(word)) {
+		memcpy(&word, p + i, sizeof(word));
+		checksum = (checksum ^ word) * 0x100000001b3ULL;
+	}
+	if (i < bytes) {
+		word = 0;
+		memcpy(&word, p + i, bytes - i);
+		checksum = (checksum ^ word) * 0x100000001b3ULL;
+	}
+	return checksum;
+}
+
+/**
+ * @private
+ *
+ * Visit the chunks of the current level of a ::csr_bfs_job until there are no more
+ *
+ * Top down, a chunk is a part of the frontier: the sinks not reached yet are claimed with a compare and swap on their distance, so each vertex
+ * ends up in the next frontier once. Bottom up, a chunk is a range of dense indices: only the worker owning the chunk writes the distances of its vertices.
+ */
+static enum thread_loop_state visitLevelTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va) {
+	struct csr_bfs_job* job = cuVarArgsGetItem(va, 0, struct csr_bfs_job*);
+	const csr_graph* g = job->g;
+	int nextLevel = job->level + 1;
+	unsigned int buffer[CSR_BFS_LOCAL_BUFFER_SIZE];
+	unsigned int bufferSize = 0;
+	unsigned long nextEdges = 0;
+
+	unsigned int chunk;
+	while (cuParallelForGetNextChunk(&job->loop, &chunk)) {
+		unsigned int start = chunk * CSR_BFS_CHUNK_SIZE;
+		if (!job->bottomUp) {
+			unsigned int end = job->frontierEnd - job->frontierStart;
+			end = (start + CSR_BFS_CHUNK_SIZE) < end ? (start + CSR_BFS_CHUNK_SIZE) : end;
+			for (unsigned int i=job->frontierStart + start; i<job->frontierStart + end; i++) {
+				unsigned int current = job->order[i];
+				CU_ITERATE_OVER_CSR_SUCCESSORS(g, current, sink, e) {
+					if (job->distances[sink] != -1 || !canTraverse(g, job->traverser, e)) {
+						continue;
+					}
+					if (!__sync_bool_compare_and_swap(&job->distances[sink], -1, nextLevel)) {
+						//another worker reached the sink first
+						continue;
+					}
+					if (job->parents != NULL) {
+						job->parents[sink] = current;
+					}
+					nextEdges += cuCSRGraphGetOutDegree(g, sink);
+					buffer[bufferSize++] = sink;
+					if (bufferSize == CSR_BFS_LOCAL_BUFFER_SIZE) {
+						appendToNextFrontier(job, buffer, bufferSize);
+						bufferSize = 0;
+					}
+				}
+			}
+		} else {
+			unsigned int end = (start + CSR_BFS_CHUNK_SIZE) < g->size ? (start + CSR_BFS_CHUNK_SIZE) : g->size;
+			for (unsigned int vertex=start; vertex<end; vertex++) {
+				if (job->distances[vertex] != -1) {
+					continue;
+				}
+				CU_ITERATE_OVER_CSR_PREDECESSORS(g, vertex, predecessor, e) {
+					if (job->distances[predecessor] != job->level || !canTraverse(g, job->traverser, e)) {
+						continue;
+					}
+					job->distances[vertex] = nextLevel;
+					if (job->parents != NULL) {
+						job->parents[vertex] = predecessor;
+					}
+					nextEdges += cuCSRGraphGetOutDegree(g, vertex);
+					buffer[bufferSize++] = vertex;
+					if (bufferSize == CSR_BFS_LOCAL_BUFFER_SIZE) {
+						appendToNextFrontier(job, buffer, bufferSize);
+						bufferSize = 0;
+					}
+					break;
+				}
+			}
+		}
+	}
+
+	appendToNextFrontier(job, buffer, bufferSize);
+	__sync_fetch_and_add(&job->nextEdges, nextEdges);
+	return TLS_STOP;
+}
+
+/**
+ * @private
+ *
+ * Add some vertices at the end of ::csr_bfs_job::order
+ *
+ * @param[inout] job the visit involved
+ * @param[in] buffer the vertices to add
+ * @param[in] size the number of vertices in @c buffer
+ */
+static void appendToNextFrontier(CU_NOTNULL struct csr_bfs_job* job, CU_NOTNULL const unsigned int* buffer, unsigned int size) {
+	if (size == 0) {
+		return;
+	}
+	unsigned int position = __sync_fetch_and_add(&job->tail, size);
+	memcpy(&job->order[position], buffer, sizeof(unsigned int) * size);
+}
+
+/**
+ * @private
+ *
+ * Let the workers perform a step of a ::csr_scc_job
+ *
+ * @param[inout] job the computation involved
+ * @param[in] step the step to perform
+ * @param[in] work the number of vertices to process, either the ones in the frontier or all the vertices of the graph
+ */
+static void runSCCStep(CU_NOTNULL struct csr_scc_job* job, enum csr_scc_step step, unsigned int work) {
+	job->step = step;
+	job->tail = 0;
+
+	cuInitVarArgsOnStack(va, job);
+	cuParallelThreadPoolFor(job->pool, sccStepTask, va, &job->loop, (work + CSR_SCC_CHUNK_SIZE - 1) / CSR_SCC_CHUNK_SIZE);
+}
+
+/**
+ * @private
+ *
+ * Make the vertices appended during the last step the frontier of the next one
+ *
+ * @param[inout] job the computation involved
+ */
+static void swapSCCFrontiers(CU_NOTNULL struct csr_scc_job* job) {
+	unsigned int* tmp = job->frontier;
+	job->frontier = job->nextFrontier;
+	job->nextFrontier = tmp;
+	job->frontierSize = job->tail;
+}
+
+/**
+ * @private
+ *
+ * Assign to a component on its own every active vertex which is not in a cycle made of active vertices
+ *
+ * A vertex is trimmed when it has no in edge or no out edge left. The removal is propagated via the degrees of the neighbours,
+ * so chains are trimmed in a time proportional to their length, whatever the order of their dense indices
+ *
+ * @param[inout] job the computation involved
+ */
+static void trimVertices(CU_NOTNULL struct csr_scc_job* job) {
+	runSCCStep(job, CSR_SCC_DEGREES, job->g->size);
+	runSCCStep(job, CSR_SCC_SEED, job->g->size);
+	swapSCCFrontiers(job);
+	while (job->frontierSize > 0) {
+		runSCCStep(job, CSR_SCC_TRIM, job->frontierSize);
+		swapSCCFrontiers(job);
+	}
+}
+
+/**
+ * @private
+ *
+ * Assign every active vertex to its component via an iterative Tarjan algorithm run on the calling thread
+ *
+ * Each component is labelled with the dense index of its root
+ *
+ * @param[inout] job the computation involved
+ */
+static void computeSCCByTarjan(CU_NOTNULL struct csr_scc_job* job) {
+	const csr_graph* g = job->g;
+	unsigned int* components = job->components;
+	unsigned int size = g->size;
+	//index[v] is the DFS discovery time of v plus 1 (0 if not visited yet)
+	unsigned int* index = calloc(size > 0 ? size : 1, sizeof(unsigned int));
+	unsigned int* lowLink = cuUtilsMallocArray(size, sizeof(unsigned int));
+	bool* onStack = calloc(size > 0 ? size : 1, sizeof(bool));
+	unsigned int* sccStack = cuUtilsMallocArray(size, sizeof(unsigned int));
+	unsigned int* callStack = cuUtilsMallocArray(size, sizeof(unsigned int));
+	unsigned int* nextEdge = cuUtilsMallocArray(size, sizeof(unsigned int));
+	if (index == NULL || onStack == NULL) {
+		ERROR_MALLOC();
+	}
+
+	unsigned int nextIndex = 1;
+	unsigned int sccTop = 0;
+	for (unsigned int root=0; root<size; root++) {
+		if (index[root] != 0 || components[root] != CSR_SCC_ACTIVE) {
+			continue;
+		}
+
+		unsigned int callTop = 0;
+		callStack[callTop] = root;
+		nextEdge[callTop] = g->successorOffsets[root];
+		callTop++;
+		index[root] = lowLink[root] = nextIndex++;
+		sccStack[sccTop++] = root;
+		onStack[root] = true;
+
+		while (callTop > 0) {
+			unsigned int v = callStack[callTop - 1];
+			unsigned int e = nextEdge[callTop - 1];
+
+			if (e < g->successorOffsets[v + 1]) {
+				nextEdge[callTop - 1] = e + 1;
+				unsigned int w = g->successors[e];
+				if (!isSCCEdgeTraversable(job, e)) {
+					continue;
+				}
+				if (index[w] == 0) {
+					if (components[w] != CSR_SCC_ACTIVE) {
+						//w has been assigned before Tarjan started or it is excluded
+						continue;
+					}
+					index[w] = lowLink[w] = nextIndex++;
+					sccStack[sccTop++] = w;
+					onStack[w] = true;
+					callStack[callTop] = w;
+					nextEdge[callTop] = g->successorOffsets[w];
+					callTop++;
+				} else if (onStack[w] && index[w] < lowLink[v]) {
+					lowLink[v] = index[w];
+				}
+				continue;
+			}
+
+			if (lowLink[v] == index[v]) {
+				unsigned int w;
+				do {
+					w = sccStack[--sccTop];
+					onStack[w] = false;
+					components[w] = v;
+					job->assigned++;
+				} while (w != v);
+			}
+			callTop--;
+			if (callTop > 0) {
+				unsigned int parent = callStack[callTop - 1];
+				if (lowLink[v] < lowLink[parent]) {
+					lowLink[parent] = lowLink[v];
+				}
+			}
+		}
+	}
+
+	CU_FREE(nextEdge);
+	CU_FREE(callStack);
+	CU_FREE(sccStack);
+	CU_FREE(onStack);
+	CU_FREE(lowLink);
+	CU_FREE(index);
+}
+
+/**
+ * @private
+ *
+ * Replace the labels of the components with numbers in reverse topological order
+ *
+ * The components are numbered in the post order of a depth first visit of the condensation. The visits start from the component of
+ * the vertex with the lowest dense index not numbered yet, hence the result depends only on the graph and on the partition in components
+ *
+ * @param[inout] job the computation involved. Every included vertex needs to be assigned to a component
+ * @return the number of components
+ */
+static unsigned int sortComponentsTopologically(CU_NOTNULL struct csr_scc_job* job) {
+	const csr_graph* g = job->g;
+	unsigned int* components = job->components;
+	unsigned int size = g->size;
+
+	//the condensation, indexed by the labels of the components. There may be duplicate edges, but they do not harm the visit
+	unsigned int* offsets = calloc(size + 1, sizeof(unsigned int));
+	if (offsets == NULL) {
+		ERROR_MALLOC();
+	}
+	for (unsigned int v=0; v<size; v++) {
+		if (components[v] >= CSR_SCC_EXCLUDED) {
+			continue;
+		}
+		CU_ITERATE_OVER_CSR_SUCCESSORS(g, v, w, e) {
+			if (components[w] < CSR_SCC_EXCLUDED && components[w] != components[v] && isSCCEdgeTraversable(job, e)) {
+				offsets[components[v] + 1] += 1;
+			}
+		}
+	}
+	for (unsigned int i=0; i<size; i++) {
+		offsets[i + 1] += offsets[i];
+	}
+	unsigned int* sinks = cuUtilsMallocArray(offsets[size], sizeof(unsigned int));
+	//used as the cursor of each component while filling sinks, then as the next edge to scan during the visit
+	unsigned int* nextEdge = cuUtilsMallocArray(size, sizeof(unsigned int));
+	memcpy(nextEdge, offsets, sizeof(unsigned int) * size);
+	for (unsigned int v=0; v<size; v++) {
+		if (components[v] >= CSR_SCC_EXCLUDED) {
+			continue;
+		}
+		CU_ITERATE_OVER_CSR_SUCCESSORS(g, v, w, e) {
+			if (components[w] < CSR_SCC_EXCLUDED && components[w] != components[v] && isSCCEdgeTraversable(job, e)) {
+				sinks[nextEdge[components[v]]++] = components[w];
+			}
+		}
+	}
+	memcpy(nextEdge, offsets, sizeof(unsigned int) * size);
+
+	//CSR_SCC_ACTIVE means not visited yet, CSR_SCC_EXCLUDED means being visited
+	unsigned int* numbers = cuUtilsMallocArray(size, sizeof(unsigned int));
+	unsigned int* stack = cuUtilsMallocArray(size, sizeof(unsigned int));
+	for (unsigned int i=0; i<size; i++) {
+		numbers[i] = CSR_SCC_ACTIVE;
+	}
+	unsigned int componentsNumber = 0;
+	for (unsigned int v=0; v<size; v++) {
+		unsigned int root = components[v];
+		if (root >= CSR_SCC_EXCLUDED || numbers[root] != CSR_SCC_ACTIVE) {
+			continue;
+		}
+		unsigned int top = 0;
+		stack[top++] = root;
+		numbers[root] = CSR_SCC_EXCLUDED;
+		while (top > 0) {
+			unsigned int current = stack[top - 1];
+			if (nextEdge[current] < offsets[current + 1]) {
+				unsigned int sink = sinks[nextEdge[current]++];
+				if (numbers[sink] == CSR_SCC_ACTIVE) {
+					numbers[sink] = CSR_SCC_EXCLUDED;
+					stack[top++] = sink;
+				}
+				continue;
+			}
+			numbers[current] = componentsNumber++;
+			top--;
+		}
+	}
+
+	for (unsigned int v=0; v<size; v++) {
+		components[v] = components[v] < CSR_SCC_EXCLUDED ? numbers[components[v]] : UINT_MAX;
+	}
+
+	CU_FREE(stack);
+	CU_FREE(numbers);
+	CU_FREE(nextEdge);
+	CU_FREE(sinks);
+	CU_FREE(offsets);
+	return componentsNumber;
+}
+
+/**
+ * @private
+ *
+ * Process the chunks of the current step of a ::csr_scc_job until there are no more
+ */
+static enum thread_loop_state sccStepTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va) {
+	struct csr_scc_job* job = cuVarArgsGetItem(va, 0, struct csr_scc_job*);
+	struct csr_scc_worker worker;
+	worker.bufferSize = 0;
+	worker.assigned = 0;
+	worker.pivot = 0;
+	worker.stack = NULL;
+	worker.stackCapacity = 0;
+
+	bool onFrontier = job->step == CSR_SCC_TRIM || job->step == CSR_SCC_FORWARD || job->step == CSR_SCC_BACKWARD || job->step == CSR_SCC_PROPAGATE_COLORS;
+	unsigned int work = onFrontier ? job->frontierSize : job->g->size;
+	unsigned int chunk;
+	while (cuParallelForGetNextChunk(&job->loop, &chunk)) {
+		unsigned int start = chunk * CSR_SCC_CHUNK_SIZE;
+		unsigned int end = (start + CSR_SCC_CHUNK_SIZE) < work ? (start + CSR_SCC_CHUNK_SIZE) : work;
+		for (unsigned int i=start; i<end; i++) {
+			processSCCVertex(job, &worker, onFrontier ? job->frontier[i] : i);
+		}
+	}
+
+	flushSCCWorker(job, &worker);
+	__sync_fetch_and_add(&job->assigned, worker.assigned);
+	uint64_t best = job->pivot;
+	while (worker.pivot > best) {
+		uint64_t previous = __sync_val_compare_and_swap(&job->pivot, best, worker.pivot);
+		if (previous == best) {
+			break;
+		}
+		best = previous;
+	}
+	if (worker.stack != NULL) {
+		CU_FREE(worker.stack);
+	}
+	return TLS_STOP;
+}
+
+/**
+ * @private
+ *
+ * Perform the current step of a ::csr_scc_job on a vertex
+ *
+ * @param[inout] job the computation involved
+ * @param[inout] worker the worker processing the vertex
+ * @param[in] vertex either a vertex of the frontier or any vertex of the graph, depending on the step
+ */
+static void processSCCVertex(CU_NOTNULL struct csr_scc_job* job, CU_NOTNULL struct csr_scc_worker* worker, unsigned int vertex) {
+	const csr_graph* g = job->g;
+	unsigned int* components = job->components;
+
+	switch (job->step) {
+	case CSR_SCC_DEGREES: {
+		if (components[vertex] != CSR_SCC_ACTIVE) {
+			return;
+		}
+		unsigned int outDegree = 0;
+		CU_ITERATE_OVER_CSR_SUCCESSORS(g, vertex, w, e) {
+			if (w != vertex && components[w] == CSR_SCC_ACTIVE && isSCCEdgeTraversable(job, e)) {
+				outDegree++;
+			}
+		}
+		unsigned int inDegree = 0;
+		CU_ITERATE_OVER_CSR_PREDECESSORS(g, vertex, w, e) {
+			if (w != vertex && components[w] == CSR_SCC_ACTIVE && isSCCEdgeTraversable(job, e)) {
+				inDegree++;
+			}
+		}
+		job->outDegrees[vertex] = outDegree;
+		job->inDegrees[vertex] = inDegree;
+		break;
+	}
+	case CSR_SCC_SEED: {
+		//the degrees are final here, so only this worker can assign the vertex
+		if (components[vertex] == CSR_SCC_ACTIVE && (job->inDegrees[vertex] == 0 || job->outDegrees[vertex] == 0)) {
+			components[vertex] = vertex;
+			worker->assigned++;
+			pushToNextSCCFrontier(job, worker, vertex);
+		}
+		break;
+	}
+	case CSR_SCC_TRIM: {
+		//the vertex has been removed: its neighbours lose an edge
+		CU_ITERATE_OVER_CSR_SUCCESSORS(g, vertex, w, e) {
+			if (w == vertex || components[w] != CSR_SCC_ACTIVE || !isSCCEdgeTraversable(job, e)) {
+				continue;
+			}
+			if (__sync_sub_and_fetch(&job->inDegrees[w], 1) == 0 && __sync_bool_compare_and_swap(&components[w], CSR_SCC_ACTIVE, w)) {
+				worker->assigned++;
+				pushToNextSCCFrontier(job, worker, w);
+			}
+		}
+		CU_ITERATE_OVER_CSR_PREDECESSORS(g, vertex, w, e) {
+			if (w == vertex || components[w] != CSR_SCC_ACTIVE || !isSCCEdgeTraversable(job, e)) {
+				continue;
+			}
+			if (__sync_sub_and_fetch(&job->outDegrees[w], 1) == 0 && __sync_bool_compare_and_swap(&components[w], CSR_SCC_ACTIVE, w)) {
+				worker->assigned++;
+				pushToNextSCCFrontier(job, worker, w);
+			}
+		}
+		break;
+	}
+	case CSR_SCC_PIVOT: {
+		if (components[vertex] != CSR_SCC_ACTIVE) {
+			return;
+		}
+		uint64_t score = ((uint64_t) cuCSRGraphGetInDegree(g, vertex)) * cuCSRGraphGetOutDegree(g, vertex);
+		//plus 1 so that any active vertex is better than no pivot at all
+		score = score < (UINT_MAX - 1) ? score + 1 : UINT_MAX;
+		uint64_t candidate = (score << 32) | vertex;
+		if (candidate > worker->pivot) {
+			worker->pivot = candidate;
+		}
+		break;
+	}
+	case CSR_SCC_FORWARD: {
+		CU_ITERATE_OVER_CSR_SUCCESSORS(g, vertex, w, e) {
+			if (job->marks[w] || components[w] != CSR_SCC_ACTIVE || !isSCCEdgeTraversable(job, e)) {
+				continue;
+			}
+			if (__sync_bool_compare_and_swap(&job->marks[w], false, true)) {
+				pushToNextSCCFrontier(job, worker, w);
+			}
+		}
+		break;
+	}
+	case CSR_SCC_BACKWARD: {
+		CU_ITERATE_OVER_CSR_PREDECESSORS(g, vertex, w, e) {
+			if (!job->marks[w] || components[w] != CSR_SCC_ACTIVE || !isSCCEdgeTraversable(job, e)) {
+				continue;
+			}
+			if (__sync_bool_compare_and_swap(&components[w], CSR_SCC_ACTIVE, job->component)) {
+				worker->assigned++;
+				pushToNextSCCFrontier(job, worker, w);
+			}
+		}
+		break;
+	}
+	case CSR_SCC_INIT_COLORS: {
+		if (components[vertex] == CSR_SCC_ACTIVE) {
+			job->colors[vertex] = vertex;
+			job->marks[vertex] = true;
+			pushToNextSCCFrontier(job, worker, vertex);
+		}
+		break;
+	}
+	case CSR_SCC_PROPAGATE_COLORS: {
+		//unmark the vertex before reading its colour: if the colour increases later, the vertex is put back in the frontier
+		__sync_bool_compare_and_swap(&job->marks[vertex], true, false);
+		unsigned int color = job->colors[vertex];
+		CU_ITERATE_OVER_CSR_SUCCESSORS(g, vertex, w, e) {
+			if (w == vertex || components[w] != CSR_SCC_ACTIVE || !isSCCEdgeTraversable(job, e)) {
+				continue;
+			}
+			unsigned int sinkColor = job->colors[w];
+			while (sinkColor < color) {
+				unsigned int previous = __sync_val_compare_and_swap(&job->colors[w], sinkColor, color);
+				if (previous == sinkColor) {
+					if (__sync_bool_compare_and_swap(&job->marks[w], false, true)) {
+						pushToNextSCCFrontier(job, worker, w);
+					}
+					break;
+				}
+				sinkColor = previous;
+			}
+		}
+		break;
+	}
+	case CSR_SCC_COLLECT_COLORS: {
+		if (components[vertex] == CSR_SCC_ACTIVE && job->colors[vertex] == vertex) {
+			collectColor(job, worker, vertex);
+		}
+		break;
+	}
+	default: {
+		ERROR_UNHANDLED_CASE("csr_scc_step", job->step);
+	}
+	}
+}
+
+/**
+ * @private
+ *
+ * Assign to the component of @c root all the vertices with the same colour reaching @c root
+ *
+ * Vertices with different colours are never touched, so several workers can collect different colours at the same time
+ *
+ * @param[inout] job the computation involved
+ * @param[inout] worker the worker collecting the colour
+ * @param[in] root an active vertex whose colour is its own dense index
+ */
+static void collectColor(CU_NOTNULL struct csr_scc_job* job, CU_NOTNULL struct csr_scc_worker* worker, unsigned int root) {
+	const csr_graph* g = job->g;
+	unsigned int* components = job->components;
+	unsigned int top = 0;
+
+	components[root] = root;
+	worker->assigned++;
+	if (worker->stackCapacity == 0) {
+		worker->stackCapacity = CSR_BFS_LOCAL_BUFFER_SIZE;
+		worker->stack = cuUtilsMallocArray(worker->stackCapacity, sizeof(unsigned int));
+	}
+	worker->stack[top++] = root;
+	while (top > 0) {
+		unsigned int current = worker->stack[--top];
+		CU_ITERATE_OVER_CSR_PREDECESSORS(g, current, w, e) {
+			if (components[w] != CSR_SCC_ACTIVE || job->colors[w] != root || !isSCCEdgeTraversable(job, e)) {
+				continue;
+			}
+			components[w] = root;
+			worker->assigned++;
+			if (top == worker->stackCapacity) {
+				worker->stackCapacity *= 2;
+				worker->stack = realloc(worker->stack, sizeof(unsigned int) * worker->stackCapacity);
+				if (worker->stack == NULL) {
+					ERROR_MALLOC();
+				}
+			}
+			worker->stack[top++] = w;
+		}
+	}
+}
+
+/**
+ * @private
+ *
+ * Add a vertex to the next frontier of a ::csr_scc_job
+ *
+ * The vertices are buffered by the worker and appended in blocks, so the workers rarely contend on ::csr_scc_job::tail
+ *
+ * @param[inout] job the computation involved
+ * @param[inout] worker the worker adding the vertex
+ * @param[in] vertex the vertex to add
+ */
+static void pushToNextSCCFrontier(CU_NOTNULL struct csr_scc_job* job, CU_NOTNULL struct csr_scc_worker* worker, unsigned int vertex) {
+	worker->buffer[worker->bufferSize++] = vertex;
+	if (worker->bufferSize == CSR_BFS_LOCAL_BUFFER_SIZE) {
+		flushSCCWorker(job, worker);
+	}
+}
+
+/**
+ * @private
+ *
+ * Append the vertices buffered by a worker to ::csr_scc_job::nextFrontier
+ *
+ * @param[inout] job the computation involved
+ * @param[inout] worker the worker involved
+ */
+static void flushSCCWorker(CU_NOTNULL struct csr_scc_job* job, CU_NOTNULL struct csr_scc_worker* worker) {
+	if (worker->bufferSize == 0) {
+		return;
+	}
+	unsigned int position = __sync_fetch_and_add(&job->tail, worker->bufferSize);
+	memcpy(&job->nextFrontier[position], worker->buffer, sizeof(unsigned int) * worker->bufferSize);
+	worker->bufferSize = 0;
+}
+
+/**
+ * @private
+ *
+ * @param[in] job the computation involved
+ * @param[in] edgeIndex the index of the edge in the snapshot
+ * @return true if the edge can be traversed
+ */
+static bool isSCCEdgeTraversable(CU_NOTNULL const struct csr_scc_job* job, unsigned int edgeIndex) {
+	return job->traversable == NULL || job->traversable[edgeIndex];
+}
+
+/**
+ * @private
+ *
+ * Process the chunks of the current level of a ::csr_topological_job until there are no more
+ *
+ * The worker removing the last in edge of a vertex is the only one appending it to the next level
+ */
+static enum thread_loop_state topologicalLevelTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va) {
+	struct csr_topological_job* job = cuVarArgsGetItem(va, 0, struct csr_topological_job*);
+	const csr_graph* g = job->g;
+	unsigned int buffer[CSR_BFS_LOCAL_BUFFER_SIZE];
+	unsigned int bufferSize = 0;
+
+	unsigned int chunk;
+	while (cuParallelForGetNextChunk(&job->loop, &chunk)) {
+		unsigned int start = job->levelStart + chunk * CSR_TOPOLOGICAL_CHUNK_SIZE;
+		unsigned int end = (start + CSR_TOPOLOGICAL_CHUNK_SIZE) < job->levelEnd ? (start + CSR_TOPOLOGICAL_CHUNK_SIZE) : job->levelEnd;
+		for (unsigned int i=start; i<end; i++) {
+			CU_ITERATE_OVER_CSR_SUCCESSORS(g, job->order[i], sink, e) {
+				if (__sync_sub_and_fetch(&job->inDegrees[sink], 1) != 0) {
+					continue;
+				}
+				buffer[bufferSize++] = sink;
+				if (bufferSize == CSR_BFS_LOCAL_BUFFER_SIZE) {
+					unsigned int position = __sync_fetch_and_add(&job->tail, bufferSize);
+					memcpy(&job->order[position], buffer, sizeof(unsigned int) * bufferSize);
+					bufferSize = 0;
+				}
+			}
+		}
+	}
+
+	if (bufferSize > 0) {
+		unsigned int position = __sync_fetch_and_add(&job->tail, bufferSize);
+		memcpy(&job->order[position], buffer, sizeof(unsigned int) * bufferSize);
+	}
+	return TLS_STOP;
+}
@@ -10,15 +10,97 @@
 #include <stdlib.h>
 #include <stdarg.h>
 #include <string.h>
+#include <math.h>
+#include <pthread.h>
 #include "utility.h"
 #include "log.h"
 #include "errors.h"
+#include "cutilsConfig.h"
+
+/**
+ * the greatest precision of the \c %.Nf columns formatted without \c snprintf
+ */
+#define CSV_MAX_FAST_PRECISION 9
+
+/**
+ * the number of characters enough to contain any integer, long or \c %.Nf number formatted without \c snprintf
+ */
+#define CSV_MAX_NUMBER_LENGTH 48
+
+/**
+ * How a column of the csv is formatted
+ */
+enum csv_column_format {
+	///an \c int printed with \c %d
+	CSV_FORMAT_INT,
+	///a \c long printed with \c %ld
+	CSV_FORMAT_LONG,
+	///a \c double printed with \c %f or \c %.Nf
+	CSV_FORMAT_FIXED,
+	///a string printed with \c %s
+	CSV_FORMAT_STRING,
+	///an \c int printed via \c snprintf
+	CSV_FORMAT_GENERIC_INT,
+	///a \c long printed via \c snprintf
+	CSV_FORMAT_GENERIC_LONG,
+	///a \c double printed via \c snprintf
+	CSV_FORMAT_GENERIC_DOUBLE,
+	///a string printed via \c snprintf
+	CSV_FORMAT_GENERIC_STRING,
+};
+
+struct csv_column {
+	enum csv_column_format format;
+	///the number of digits after the dot of a ::CSV_FORMAT_FIXED column
+	int precision;
+	///the printf specifier of the column
+	char specifier[BUFFER_SIZE];
+};
+
+/**
+ * The buffer used to print the rows of a ::csv_helper
+ */
+struct csv_buffered_writer {
+	///the columns of the csv, computed from ::csv_helper::actualTemplate
+	struct csv_column* columns;
+	///the buffer where the rows are formatted
+	char* data;
+	///number of bytes in ::csv_buffered_writer::data
+	size_t length;
+	///size of ::csv_buffered_writer::data and of ::csv_buffered_writer::spare
+	size_t size;
+	///true if the buffer is written by ::csv_buffered_writer::thread
+	bool background;
+	///the buffer written by ::csv_buffered_writer::thread, while ::csv_buffered_writer::data is filled
+	char* spare;
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t condition;
+	///the buffer ::csv_buffered_writer::thread needs to write. NULL if the thread is idle
+	char* pending;
+	size_t pendingLength;
+	///true if ::csv_buffered_writer::thread needs to terminate
+	bool stop;
+	///the file where to write
+	FILE* file;
+};
 
 static int getSymbolTimesInString(const char* str, char symbol);
 static void replaceSpacesWithDelimiterInTemplate(char* template, char delimiter);
 static bool hasCSVExtension(const char* f);
 static const char** cloneHeader(int headerSize, const char* header[]);
 static void destroyHeader(int headerSize, const char* header[]);
+static void printHeader(CU_NOTNULL csv_helper* csvHelper);
+static void computeColumn(CU_NOTNULL const csv_helper* csvHelper, int n, CU_NOTNULL struct csv_column* column);
+static struct csv_buffered_writer* getWriter(CU_NOTNULL csv_helper* csvHelper);
+static void destroyWriter(CU_NOTNULL struct csv_buffered_writer* writer);
+static void* writeBuffers(void* w);
+static void writeBuffer(CU_NOTNULL struct csv_buffered_writer* writer, bool wait);
+static void appendBytes(CU_NOTNULL struct csv_buffered_writer* writer, CU_NOTNULL const char* bytes, size_t length);
+static void appendCell(CU_NOTNULL struct csv_buffered_writer* writer, CU_NOTNULL const struct csv_column* column, csv_cell cell);
+static char* formatUnsigned(CU_NOTNULL char* buffer, unsigned long value);
+static char* formatLong(CU_NOTNULL char* buffer, long value);
+static char* formatFixed(CU_NOTNULL char* buffer, double value, int precision);
 
 csv_helper* cuCSVHelperNew(const char* filePath, char delimiter, char carriageReturn, const char* template, const char* header[], const char* openFormat) {
 	csv_helper* retVal = (csv_helper*) malloc(sizeof(csv_helper));
@@ -46,6 +128,7 @@ csv_helper* cuCSVHelperNew(const char* filePath, char delimiter, char carriageRe
 		ERROR_FILE(buffer);
 	}
 	retVal->nextColumnIndex = 0;
+	retVal->writer = NULL;
 
 	retVal->actualTemplate = strdup(template);
 	replaceSpacesWithDelimiterInTemplate(retVal->actualTemplate, retVal->delimiter);
@@ -66,9 +149,13 @@ csv_helper* cuCSVHelperNew(const char* filePath, char delimiter, char carriageRe
  * @param[in] csvHelper the structure to remove from the memory
  */
 void cuCSVHelperDestroy(CU_NOTNULL const csv_helper* csvHelper, CU_NULLABLE const struct var_args* context) {
-	if (csvHelper != NULL) {
-		fclose(csvHelper->csvFile);
+	if (csvHelper == NULL) {
+		return;
+	}
+	if (csvHelper->writer != NULL) {
+		destroyWriter(csvHelper->writer);
 	}
+	fclose(csvHelper->csvFile);
 	destroyHeader(csvHelper->headerSize, csvHelper->headerNames);
 	free((void*)csvHelper->filePath);
 	free((void*)csvHelper->actualTemplate);
@@ -97,7 +184,7 @@ static void destroyHeader(int headerSize, const char* header[]) {
  */
 static const char** cloneHeader(int headerSize, const char* header[]) {
 	const char** headerClone = malloc(sizeof(char*) * headerSize);
-	if (header == NULL) {
+	if (headerClone == NULL) {
 		ERROR_MALLOC();
 	}
 
@@ -108,25 +195,113 @@ static const char** cloneHeader(int headerSize, const char* header[]) {
 	return headerClone;
 }
 
-/**
- * Prints a data row inside the csv
- *
- * @param[in] csvHelper the structure that allows you to easily print data on the csv
- */
+void cuCSVHelperEnableBuffering(CU_NOTNULL csv_helper* csvHelper, size_t bufferSize, bool backgroundFlush) {
+	if (csvHelper->writer != NULL) {
+		ERROR_ON_APPLICATION("buffer size", "%zu", bufferSize, "csv helper already buffered", "%s", csvHelper->filePath);
+	}
+	if (bufferSize < CSV_MAX_NUMBER_LENGTH) {
+		ERROR_ON_CONSTRUCTION("csv buffer size", "%zu", bufferSize);
+	}
+
+	struct csv_buffered_writer* writer = CU_MALLOC(struct csv_buffered_writer);
+	if (writer == NULL) {
+		ERROR_MALLOC();
+	}
+	writer->columns = malloc(sizeof(struct csv_column) * csvHelper->headerSize);
+	writer->data = malloc(bufferSize);
+	if (writer->columns == NULL || writer->data == NULL) {
+		ERROR_MALLOC();
+	}
+	for (int i=0; i<csvHelper->headerSize; i++) {
+		computeColumn(csvHelper, i, &writer->columns[i]);
+	}
+	writer->length = 0;
+	writer->size = bufferSize;
+	writer->background = backgroundFlush;
+	writer->spare = NULL;
+	writer->pending = NULL;
+	writer->pendingLength = 0;
+	writer->stop = false;
+	writer->file = csvHelper->csvFile;
+	if (backgroundFlush) {
+		writer->spare = malloc(bufferSize);
+		if (writer->spare == NULL) {
+			ERROR_MALLOC();
+		}
+		pthread_mutex_init(&writer->mutex, NULL);
+		pthread_cond_init(&writer->condition, NULL);
+		if (pthread_create(&writer->thread, NULL, writeBuffers, writer) != 0) {
+			ERROR_ON_CONSTRUCTION("csv writer", "%s", csvHelper->filePath);
+		}
+	}
+
+	csvHelper->writer = writer;
+}
+
+void cuCSVHelperPrintRow(CU_NOTNULL csv_helper* csvHelper, ...) {
+	struct csv_buffered_writer* writer = getWriter(csvHelper);
+	if (!csvHelper->alreadyPrintedHeader) {
+		printHeader(csvHelper);
+	}
+
+	va_list ap;
+	va_start(ap, csvHelper);
+	for (int i=0; i<csvHelper->headerSize; i++) {
+		const struct csv_column* column = &writer->columns[i];
+		csv_cell cell;
+		switch (column->format) {
+		case CSV_FORMAT_INT:
+		case CSV_FORMAT_GENERIC_INT: { cell.i = va_arg(ap, int); break; }
+		case CSV_FORMAT_LONG:
+		case CSV_FORMAT_GENERIC_LONG: { cell.l = va_arg(ap, long); break; }
+		case CSV_FORMAT_FIXED:
+		case CSV_FORMAT_GENERIC_DOUBLE: { cell.d = va_arg(ap, double); break; }
+		case CSV_FORMAT_STRING:
+		case CSV_FORMAT_GENERIC_STRING: { cell.s = va_arg(ap, const char*); break; }
+		default: {
+			ERROR_IMPOSSIBLE_SCENARIO("invalid column format %d", column->format);
+		}
+		}
+		appendCell(writer, column, cell);
+		char separator = (i + 1) < csvHelper->headerSize ? csvHelper->delimiter : csvHelper->carriageReturn;
+		appendBytes(writer, &separator, 1);
+	}
+	va_end(ap);
+}
+
+void cuCSVHelperPrintRows(CU_NOTNULL csv_helper* csvHelper, CU_NOTNULL const csv_cell* cells, int rows) {
+	struct csv_buffered_writer* writer = getWriter(csvHelper);
+	if (!csvHelper->alreadyPrintedHeader) {
+		printHeader(csvHelper);
+	}
+
+	const csv_cell* cell = cells;
+	for (int row=0; row<rows; row++) {
+		for (int i=0; i<csvHelper->headerSize; i++, cell++) {
+			appendCell(writer, &writer->columns[i], *cell);
+			char separator = (i + 1) < csvHelper->headerSize ? csvHelper->delimiter : csvHelper->carriageReturn;
+			appendBytes(writer, &separator, 1);
+		}
+	}
+}
+
+void cuCSVHelperFlush(CU_NOTNULL csv_helper* csvHelper) {
+	if (csvHelper->writer != NULL) {
+		writeBuffer(csvHelper->writer, true);
+	}
+	fflush(csvHelper->csvFile);
+}
 
 void _cuCSVHelperTryPrintHeader(csv_helper* csvHelper) {
+	if (csvHelper->writer != NULL) {
+		//the rows we're going to print directly in the file need to come after the buffered ones
+		writeBuffer(csvHelper->writer, true);
+	}
 	if (!csvHelper->alreadyPrintedHeader) {
-		//sep options
-		fprintf(csvHelper->csvFile, "sep=%c%c", csvHelper->delimiter, csvHelper->carriageReturn);
-		//header print
-		for (int i=0; i<csvHelper->headerSize; i++) {
-			fprintf(csvHelper->csvFile, "%s", csvHelper->headerNames[i]);
-			if ((i+1) < csvHelper->headerSize) {
-				fprintf(csvHelper->csvFile, "%c", csvHelper->delimiter);
-			}
+		printHeader(csvHelper);
+		if (csvHelper->writer != NULL) {
+			writeBuffer(csvHelper->writer, true);
 		}
-		fprintf(csvHelper->csvFile, "%c", csvHelper->carriageReturn);
-		csvHelper->alreadyPrintedHeader = true;
 	}
 }
 
@@ -203,3 +378,413 @@ static bool hasCSVExtension(const char* f) {
 	return (f[l-4] == '.') && (f[l-3] == 'c') && (f[l-2] == 's') && (f[l-1] == 'v');
 }
 
+
+/**
+ * Print the sep option and the header of the csv
+ *
+ * If the csv is buffered, they are put in the buffer
+ *
+ * @param[inout] csvHelper the helper referencing a CSV file
+ */
+static void printHeader(CU_NOTNULL csv_helper* csvHelper) {
+	if (csvHelper->writer == NULL) {
+		//sep options
+		fprintf(csvHelper->csvFile, "sep=%c%c", csvHelper->delimiter, csvHelper->carriageReturn);
+		//header print
+		for (int i=0; i<csvHelper->headerSize; i++) {
+			fprintf(csvHelper->csvFile, "%s", csvHelper->headerNames[i]);
+			if ((i+1) < csvHelper->headerSize) {
+				fprintf(csvHelper->csvFile, "%c", csvHelper->delimiter);
+			}
+		}
+		fprintf(csvHelper->csvFile, "%c", csvHelper->carriageReturn);
+	} else {
+		char buffer[] = {'s', 'e', 'p', '=', csvHelper->delimiter, csvHelper->carriageReturn};
+		appendBytes(csvHelper->writer, buffer, sizeof(buffer));
+		for (int i=0; i<csvHelper->headerSize; i++) {
+			appendBytes(csvHelper->writer, csvHelper->headerNames[i], strlen(csvHelper->headerNames[i]));
+			char separator = (i + 1) < csvHelper->headerSize ? csvHelper->delimiter : csvHelper->carriageReturn;
+			appendBytes(csvHelper->writer, &separator, 1);
+		}
+	}
+	csvHelper->alreadyPrintedHeader = true;
+}
+
+/**
+ * Compute how the n-th column of the csv needs to be formatted
+ *
+ * @param[in] csvHelper the helper involved
+ * @param[in] n the index of the column
+ * @param[out] column the structure to fill
+ */
+static void computeColumn(CU_NOTNULL const csv_helper* csvHelper, int n, CU_NOTNULL struct csv_column* column) {
+	cuCSVHelperComputeNColumnSpecifier(csvHelper, n, column->specifier);
+	const char* specifier = column->specifier;
+	size_t length = strlen(specifier);
+	if (length < 2 || specifier[0] != '%') {
+		ERROR_ON_CONSTRUCTION("csv column", "%s", specifier);
+	}
+
+	char conversion = specifier[length - 1];
+	bool isLong = length >= 3 && specifier[length - 2] == 'l';
+	column->precision = 0;
+	switch (conversion) {
+	case 'd':
+	case 'i': {
+		if (strcmp(specifier, "%d") == 0 || strcmp(specifier, "%i") == 0) {
+			column->format = CSV_FORMAT_INT;
+		} else if (strcmp(specifier, "%ld") == 0 || strcmp(specifier, "%li") == 0) {
+			column->format = CSV_FORMAT_LONG;
+		} else {
+			column->format = isLong ? CSV_FORMAT_GENERIC_LONG : CSV_FORMAT_GENERIC_INT;
+		}
+		break;
+	}
+	case 'u':
+	case 'x':
+	case 'X':
+	case 'o':
+	case 'c': {
+		column->format = isLong ? CSV_FORMAT_GENERIC_LONG : CSV_FORMAT_GENERIC_INT;
+		break;
+	}
+	case 'f':
+	case 'F':
+	case 'e':
+	case 'E':
+	case 'g':
+	case 'G':
+	case 'a':
+	case 'A': {
+		column->format = CSV_FORMAT_GENERIC_DOUBLE;
+		if (strcmp(specifier, "%f") == 0) {
+			column->format = CSV_FORMAT_FIXED;
+			column->precision = 6;
+		} else if (conversion == 'f' && length == 4 && specifier[1] == '.' && specifier[2] >= '0' && specifier[2] <= ('0' + CSV_MAX_FAST_PRECISION)) {
+			column->format = CSV_FORMAT_FIXED;
+			column->precision = specifier[2] - '0';
+		}
+		break;
+	}
+	case 's': {
+		column->format = length == 2 ? CSV_FORMAT_STRING : CSV_FORMAT_GENERIC_STRING;
+		break;
+	}
+	default: {
+		ERROR_ON_CONSTRUCTION("csv column", "%s", specifier);
+	}
+	}
+}
+
+/**
+ * @param[inout] csvHelper the helper involved
+ * @return the buffer of the helper. If it doesn't exist, it is created
+ */
+static struct csv_buffered_writer* getWriter(CU_NOTNULL csv_helper* csvHelper) {
+	if (csvHelper->writer == NULL) {
+		cuCSVHelperEnableBuffering(csvHelper, CU_CSV_BUFFER_SIZE, false);
+	}
+	return csvHelper->writer;
+}
+
+/**
+ * Write the buffered rows in the file and release the buffer from the memory
+ *
+ * @param[in] writer the buffer to destroy
+ */
+static void destroyWriter(CU_NOTNULL struct csv_buffered_writer* writer) {
+	writeBuffer(writer, true);
+	if (writer->background) {
+		pthread_mutex_lock(&writer->mutex);
+		writer->stop = true;
+		pthread_cond_broadcast(&writer->condition);
+		pthread_mutex_unlock(&writer->mutex);
+		pthread_join(writer->thread, NULL);
+		pthread_cond_destroy(&writer->condition);
+		pthread_mutex_destroy(&writer->mutex);
+		CU_FREE(writer->spare);
+	}
+	CU_FREE(writer->columns);
+	CU_FREE(writer->data);
+	CU_FREE(writer);
+}
+
+/**
+ * The body of the thread writing the buffers in the file
+ *
+ * @param[inout] w the ::csv_buffered_writer involved
+ * @return NULL
+ */
+static void* writeBuffers(void* w) {
+	struct csv_buffered_writer* writer = w;
+
+	pthread_mutex_lock(&writer->mutex);
+	while (true) {
+		while (writer->pending == NULL && !writer->stop) {
+			pthread_cond_wait(&writer->condition, &writer->mutex);
+		}
+		if (writer->pending == NULL) {
+			break;
+		}
+		char* buffer = writer->pending;
+		size_t length = writer->pendingLength;
+		pthread_mutex_unlock(&writer->mutex);
+
+		fwrite(buffer, sizeof(char), length, writer->file);
+
+		pthread_mutex_lock(&writer->mutex);
+		writer->pending = NULL;
+		pthread_cond_broadcast(&writer->condition);
+	}
+	pthread_mutex_unlock(&writer->mutex);
+	return NULL;
+}
+
+/**
+ * Write the content of ::csv_buffered_writer::data in the file
+ *
+ * If the writer flushes in background, ::csv_buffered_writer::data is given to ::csv_buffered_writer::thread and the spare buffer
+ * becomes the one to fill.
+ *
+ * @param[inout] writer the buffer involved
+ * @param[in] wait if true, when the function returns the content of the buffer has been written in the file
+ */
+static void writeBuffer(CU_NOTNULL struct csv_buffered_writer* writer, bool wait) {
+	if (!writer->background) {
+		fwrite(writer->data, sizeof(char), writer->length, writer->file);
+		writer->length = 0;
+		return;
+	}
+
+	pthread_mutex_lock(&writer->mutex);
+	//the spare buffer can be filled only when the thread has written it
+	while (writer->pending != NULL) {
+		pthread_cond_wait(&writer->condition, &writer->mutex);
+	}
+	if (writer->length > 0) {
+		writer->pending = writer->data;
+		writer->pendingLength = writer->length;
+		writer->data = writer->spare;
+		writer->spare = writer->pending;
+		writer->length = 0;
+		pthread_cond_broadcast(&writer->condition);
+	}
+	while (wait && writer->pending != NULL) {
+		pthread_cond_wait(&writer->condition, &writer->mutex);
+	}
+	pthread_mutex_unlock(&writer->mutex);
+}
+
+/**
+ * Append some bytes in the buffer
+ *
+ * If they don't fit in the buffer, the buffer is written in the file first. If they are more than the buffer size, they are written
+ * directly in the file
+ *
+ * @param[inout] writer the buffer involved
+ * @param[in] bytes the bytes to add
+ * @param[in] length the number of bytes in @c bytes
+ */
+static void appendBytes(CU_NOTNULL struct csv_buffered_writer* writer, CU_NOTNULL const char* bytes, size_t length) {
+	if (writer->length + length > writer->size) {
+		writeBuffer(writer, false);
+		if (length > writer->size) {
+			writeBuffer(writer, true);
+			fwrite(bytes, sizeof(char), length, writer->file);
+			return;
+		}
+	}
+	memcpy(writer->data + writer->length, bytes, length);
+	writer->length += length;
+}
+
+/**
+ * Format a cell in the buffer
+ *
+ * @param[inout] writer the buffer involved
+ * @param[in] column how the cell needs to be formatted
+ * @param[in] cell the value to format
+ */
+static void appendCell(CU_NOTNULL struct csv_buffered_writer* writer, CU_NOTNULL const struct csv_column* column, csv_cell cell) {
+	switch (column->format) {
+	case CSV_FORMAT_STRING: {
+		appendBytes(writer, cell.s, strlen(cell.s));
+		return;
+	}
+	case CSV_FORMAT_INT:
+	case CSV_FORMAT_LONG:
+	case CSV_FORMAT_FIXED: {
+		if (writer->length + CSV_MAX_NUMBER_LENGTH > writer->size) {
+			writeBuffer(writer, false);
+		}
+		char* start = writer->data + writer->length;
+		char* end = NULL;
+		switch (column->format) {
+		case CSV_FORMAT_INT: { end = formatLong(start, cell.i); break; }
+		case CSV_FORMAT_LONG: { end = formatLong(start, cell.l); break; }
+		default: { end = formatFixed(start, cell.d, column->precision); break; }
+		}
+		if (end != NULL) {
+			writer->length += end - start;
+			return;
+		}
+		//the number can't be formatted without snprintf
+		break;
+	}
+	default: {
+		break;
+	}
+	}
+
+	char* start = writer->data + writer->length;
+	size_t available = writer->size - writer->length;
+	int length;
+	for (int attempt=0; ; attempt++) {
+		switch (column->format) {
+		case CSV_FORMAT_INT:
+		case CSV_FORMAT_GENERIC_INT: { length = snprintf(start, available, column->specifier, cell.i); break; }
+		case CSV_FORMAT_LONG:
+		case CSV_FORMAT_GENERIC_LONG: { length = snprintf(start, available, column->specifier, cell.l); break; }
+		case CSV_FORMAT_FIXED:
+		case CSV_FORMAT_GENERIC_DOUBLE: { length = snprintf(start, available, column->specifier, cell.d); break; }
+		default: { length = snprintf(start, available, column->specifier, cell.s); break; }
+		}
+		if (length < 0) {
+			ERROR_ON_APPLICATION("csv column", "%s", column->specifier, "csv buffer", "%p", writer);
+		}
+		if (((size_t) length) < available) {
+			writer->length += length;
+			return;
+		}
+		if (attempt > 0 || ((size_t) length) >= writer->size) {
+			break;
+		}
+		//try again with an empty buffer
+		writeBuffer(writer, false);
+		start = writer->data;
+		available = writer->size;
+	}
+
+	//the cell is bigger than the whole buffer
+	char* cellBuffer = malloc(length + 1);
+	if (cellBuffer == NULL) {
+		ERROR_MALLOC();
+	}
+	switch (column->format) {
+	case CSV_FORMAT_INT:
+	case CSV_FORMAT_GENERIC_INT: { snprintf(cellBuffer, length + 1, column->specifier, cell.i); break; }
+	case CSV_FORMAT_LONG:
+	case CSV_FORMAT_GENERIC_LONG: { snprintf(cellBuffer, length + 1, column->specifier, cell.l); break; }
+	case CSV_FORMAT_FIXED:
+	case CSV_FORMAT_GENERIC_DOUBLE: { snprintf(cellBuffer, length + 1, column->specifier, cell.d); break; }
+	default: { snprintf(cellBuffer, length + 1, column->specifier, cell.s); break; }
+	}
+	appendBytes(writer, cellBuffer, length);
+	CU_FREE(cellBuffer);
+}
+
+/**
+ * Print an unsigned number in decimal
+ *
+ * @param[out] buffer where to print the number. No '\0' is added
+ * @param[in] value the number to print
+ * @return the position after the last digit printed
+ */
+static char* formatUnsigned(CU_NOTNULL char* buffer, unsigned long value) {
+	static const char digitPairs[] =
+			"00010203040506070809"
+			"10111213141516171819"
+			"20212223242526272829"
+			"30313233343536373839"
+			"40414243444546474849"
+			"50515253545556575859"
+			"60616263646566676869"
+			"70717273747576777879"
+			"80818283848586878889"
+			"90919293949596979899";
+	char digits[CSV_MAX_NUMBER_LENGTH];
+	char* p = digits + CSV_MAX_NUMBER_LENGTH;
+	while (value >= 100) {
+		unsigned long pair = value % 100;
+		value /= 100;
+		p -= 2;
+		p[0] = digitPairs[2 * pair];
+		p[1] = digitPairs[2 * pair + 1];
+	}
+	if (value >= 10) {
+		p -= 2;
+		p[0] = digitPairs[2 * value];
+		p[1] = digitPairs[2 * value + 1];
+	} else {
+		p -= 1;
+		p[0] = '0' + value;
+	}
+	size_t length = digits + CSV_MAX_NUMBER_LENGTH - p;
+	memcpy(buffer, p, length);
+	return buffer + length;
+}
+
+/**
+ * Print a number like \c printf with \c %ld
+ *
+ * @param[out] buffer where to print the number. No '\0' is added
+ * @param[in] value the number to print
+ * @return the position after the last character printed
+ */
+static char* formatLong(CU_NOTNULL char* buffer, long value) {
+	if (value < 0) {
+		*buffer = '-';
+		buffer++;
+		//works for LONG_MIN as well
+		return formatUnsigned(buffer, 0UL - (unsigned long) value);
+	}
+	return formatUnsigned(buffer, (unsigned long) value);
+}
+
+/**
+ * Print a number like \c printf with \c %.Nf
+ *
+ * The number is rounded like \c printf does in the default rounding mode: to the nearest multiple of \f$ 10^{-N} \f$ of the exact value
+ * stored in the double and, when the value is exactly halfway, to the even digit.
+ *
+ * @param[out] buffer where to print the number. No '\0' is added
+ * @param[in] value the number to print
+ * @param[in] precision the number of digits after the dot. At most ::CSV_MAX_FAST_PRECISION
+ * @return
+ *  @li the position after the last character printed;
+ *  @li NULL if the number is too big or it is not finite. Nothing is printed
+ */
+static char* formatFixed(CU_NOTNULL char* buffer, double value, int precision) {
+	static const unsigned long powersOf10[] = {1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL};
+	if (!isfinite(value)) {
+		return NULL;
+	}
+	double scaled = fabs(value) * powersOf10[precision];
+	//from 2^52 the doubles can't represent the halves anymore
+	if (scaled >= 4503599627370496.0) {
+		return NULL;
+	}
+
+	//the product above is rounded: fma tells exactly on which side of the halfway point the actual value is
+	double integral = floor(scaled);
+	double distanceFromHalf = fma(fabs(value), (double) powersOf10[precision], -(integral + 0.5));
+	unsigned long digits = (unsigned long) integral;
+	if (distanceFromHalf > 0 || (distanceFromHalf == 0 && (digits % 2) == 1)) {
+		digits++;
+	}
+	if (signbit(value)) {
+		*buffer = '-';
+		buffer++;
+	}
+	buffer = formatUnsigned(buffer, digits / powersOf10[precision]);
+	if (precision > 0) {
+		*buffer = '.';
+		unsigned long fraction = digits % powersOf10[precision];
+		for (int i=precision; i>0; i--) {
+			buffer[i] = '0' + (fraction % 10);
+			fraction /= 10;
+		}
+		buffer += precision + 1;
+	}
+	return buffer;
+}
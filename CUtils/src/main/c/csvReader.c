@@ -0,0 +1,420 @@
+/*
+ * csvReader.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: koldar
+ */
+
+#include "csvReader.h"
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "conversions.h"
+#include "cutilsConfig.h"
+#include "errors.h"
+
+/**
+ * the minimum number of bytes indexed by a single task. Smaller files are indexed by less tasks
+ */
+#define CSV_READER_MIN_CHUNK_SIZE (1 << 20)
+
+struct csv_reader {
+	///the content of the file, memory mapped. NULL if the file is empty
+	const char* data;
+	///the number of bytes in ::csv_reader::data
+	size_t size;
+	///the character between two fields
+	char delimiter;
+	///the character at the end of each row
+	char terminator;
+	///number of columns of the csv
+	int columns;
+	///the names of the columns. NULL if the file has no header
+	char** names;
+	///number of data rows
+	int rows;
+	/**
+	 * For each row, ::csv_reader::columns + 1 offsets in ::csv_reader::data: the first ::csv_reader::columns are the starts of the fields,
+	 * the last one is just after the end of the last field (namely the delimiter or the terminator which ends it plus 1)
+	 */
+	size_t* offsets;
+};
+
+/**
+ * The work needed to index the rows of a file
+ */
+struct csv_index_job {
+	csv_reader* reader;
+	///number of chunks the file has been split in
+	int chunksNumber;
+	///the start of each chunk. It contains ::csv_index_job::chunksNumber + 1 cells: the last one is the end of the file
+	const char** chunkStarts;
+	///the index of the first row of each chunk
+	int* firstRows;
+	///the chunks handed out to the tasks
+	cu_parallel_for loop;
+};
+
+static const char* getNextRow(CU_NOTNULL const csv_reader* reader, CU_NOTNULL const char* row, CU_NOTNULL const char** rowEnd);
+static void indexRow(CU_NOTNULL csv_reader* reader, int row, CU_NOTNULL const char* start, CU_NOTNULL const char* end);
+static enum thread_loop_state countRowsTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va);
+static enum thread_loop_state indexRowsTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va);
+static bool copyField(CU_NOTNULL const csv_reader* reader, int row, int column, CU_NOTNULL char* buffer);
+
+csv_reader* cuCSVReaderNew(CU_NOTNULL const char* filePath, CU_NULLABLE cu_parallel_thread_pool* pool, char delimiter, bool hasHeader) {
+	csv_reader* retVal = CU_MALLOC(csv_reader);
+	if (retVal == NULL) {
+		ERROR_MALLOC();
+	}
+
+	int fd = open(filePath, O_RDONLY);
+	if (fd < 0) {
+		ERROR_FILE(filePath);
+	}
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0) {
+		ERROR_FILE(filePath);
+	}
+	retVal->size = fileStat.st_size;
+	retVal->data = NULL;
+	if (retVal->size > 0) {
+		void* data = mmap(NULL, retVal->size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED) {
+			ERROR_FILE(filePath);
+		}
+		retVal->data = data;
+	}
+	close(fd);
+
+	const char* body = retVal->data;
+	const char* end = retVal->data + retVal->size;
+	retVal->delimiter = delimiter;
+	retVal->terminator = '\n';
+	//the preamble generated by ::csv_helper
+	if (retVal->size >= 6 && strncmp(body, "sep=", 4) == 0) {
+		retVal->delimiter = body[4];
+		retVal->terminator = body[5] == '\r' ? '\n' : body[5];
+		const char* preambleEnd = memchr(body + 4, retVal->terminator, end - (body + 4));
+		body = preambleEnd == NULL ? end : preambleEnd + 1;
+	}
+
+	//the first row determines the number of columns
+	const char* firstRowEnd = NULL;
+	const char* afterFirstRow = body;
+	while (afterFirstRow < end) {
+		body = afterFirstRow;
+		afterFirstRow = getNextRow(retVal, body, &firstRowEnd);
+		if (firstRowEnd > body) {
+			break;
+		}
+	}
+	retVal->columns = 0;
+	retVal->names = NULL;
+	if (firstRowEnd != NULL && firstRowEnd > body) {
+		retVal->columns = 1;
+		for (const char* p = body; (p = memchr(p, retVal->delimiter, firstRowEnd - p)) != NULL; p++) {
+			retVal->columns++;
+		}
+	}
+	if (hasHeader) {
+		if (retVal->columns > 0) {
+			retVal->names = malloc(sizeof(char*) * retVal->columns);
+			if (retVal->names == NULL) {
+				ERROR_MALLOC();
+			}
+			const char* p = body;
+			for (int i=0; i<retVal->columns; i++) {
+				const char* q = memchr(p, retVal->delimiter, firstRowEnd - p);
+				if (q == NULL) {
+					q = firstRowEnd;
+				}
+				retVal->names[i] = strndup(p, q - p);
+				if (retVal->names[i] == NULL) {
+					ERROR_MALLOC();
+				}
+				p = q + 1;
+			}
+		}
+		body = afterFirstRow;
+	}
+
+	//split the rows in chunks
+	struct csv_index_job job;
+	job.reader = retVal;
+	job.chunksNumber = 1;
+	if (pool != NULL) {
+		size_t chunks = (end - body) / CSV_READER_MIN_CHUNK_SIZE;
+		job.chunksNumber = chunks < cuParallelThreadPoolGetThreadsNumber(pool) ? chunks : cuParallelThreadPoolGetThreadsNumber(pool);
+		if (job.chunksNumber < 1) {
+			job.chunksNumber = 1;
+		}
+	}
+	job.chunkStarts = malloc(sizeof(char*) * (job.chunksNumber + 1));
+	job.firstRows = malloc(sizeof(int) * (job.chunksNumber + 1));
+	if (job.chunkStarts == NULL || job.firstRows == NULL) {
+		ERROR_MALLOC();
+	}
+	job.chunkStarts[0] = body;
+	for (int i=1; i<job.chunksNumber; i++) {
+		const char* start = body + ((end - body) / job.chunksNumber) * i;
+		//a chunk starts at the beginning of a row
+		if (start[-1] != retVal->terminator) {
+			start = memchr(start, retVal->terminator, end - start);
+			start = start == NULL ? end : start + 1;
+		}
+		job.chunkStarts[i] = start > job.chunkStarts[i - 1] ? start : job.chunkStarts[i - 1];
+	}
+	job.chunkStarts[job.chunksNumber] = end;
+
+	struct csv_index_job* jobPtr = &job;
+	cuInitVarArgsOnStack(va, jobPtr);
+
+	//first we count the rows in each chunk, then each chunk indexes its rows in the right place
+	cuParallelThreadPoolFor(pool, countRowsTask, va, &job.loop, job.chunksNumber);
+	int rows = 0;
+	for (int i=0; i<job.chunksNumber; i++) {
+		int chunkRows = job.firstRows[i];
+		job.firstRows[i] = rows;
+		rows += chunkRows;
+	}
+	retVal->rows = rows;
+	retVal->offsets = malloc(sizeof(size_t) * (retVal->columns + 1) * (rows > 0 ? rows : 1));
+	if (retVal->offsets == NULL) {
+		ERROR_MALLOC();
+	}
+	cuParallelThreadPoolFor(pool, indexRowsTask, va, &job.loop, job.chunksNumber);
+
+	CU_FREE(job.chunkStarts);
+	CU_FREE(job.firstRows);
+
+	return retVal;
+}
+
+CU_DEFINE_DEFAULT_VALUES(cuCSVReaderNew,
+		,
+		NULL,
+		',',
+		true
+);
+
+void cuCSVReaderDestroy(CU_NOTNULL const csv_reader* reader, CU_NULLABLE const struct var_args* context) {
+	if (reader->data != NULL) {
+		munmap((void*) reader->data, reader->size);
+	}
+	if (reader->names != NULL) {
+		for (int i=0; i<reader->columns; i++) {
+			CU_FREE(reader->names[i]);
+		}
+		CU_FREE(reader->names);
+	}
+	CU_FREE(reader->offsets);
+	CU_FREE(reader);
+}
+
+int cuCSVReaderGetRowsNumber(CU_NOTNULL const csv_reader* reader) {
+	return reader->rows;
+}
+
+int cuCSVReaderGetColumnsNumber(CU_NOTNULL const csv_reader* reader) {
+	return reader->columns;
+}
+
+char cuCSVReaderGetDelimiter(CU_NOTNULL const csv_reader* reader) {
+	return reader->delimiter;
+}
+
+const char* cuCSVReaderGetColumnName(CU_NOTNULL const csv_reader* reader, int column) {
+	return reader->names == NULL ? NULL : reader->names[column];
+}
+
+int cuCSVReaderGetColumnIndex(CU_NOTNULL const csv_reader* reader, CU_NOTNULL const char* name) {
+	if (reader->names == NULL) {
+		return -1;
+	}
+	for (int i=0; i<reader->columns; i++) {
+		if (strcmp(reader->names[i], name) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+csv_field cuCSVReaderGetField(CU_NOTNULL const csv_reader* reader, int row, int column) {
+	const size_t* offsets = &reader->offsets[((size_t) row) * (reader->columns + 1) + column];
+	csv_field retVal;
+	retVal.start = reader->data + offsets[0];
+	//missing fields start after the end of the row
+	retVal.length = offsets[1] > offsets[0] ? (int) (offsets[1] - offsets[0] - 1) : 0;
+	return retVal;
+}
+
+bool cuCSVReaderGetInt(CU_NOTNULL const csv_reader* reader, int row, int column, CU_NOTNULL int* output) {
+	char buffer[BUFFER_SIZE];
+	return copyField(reader, row, column, buffer) && cuConvertString2Int(buffer, output);
+}
+
+bool cuCSVReaderGetLong(CU_NOTNULL const csv_reader* reader, int row, int column, CU_NOTNULL long* output) {
+	char buffer[BUFFER_SIZE];
+	return copyField(reader, row, column, buffer) && cuConvertString2Long(buffer, output);
+}
+
+bool cuCSVReaderGetDouble(CU_NOTNULL const csv_reader* reader, int row, int column, CU_NOTNULL double* output) {
+	char buffer[BUFFER_SIZE];
+	return copyField(reader, row, column, buffer) && cuConvertString2Double(buffer, output);
+}
+
+int cuCSVReaderGetIntColumn(CU_NOTNULL const csv_reader* reader, int column, CU_NOTNULL int* output) {
+	int retVal = 0;
+	for (int row=0; row<reader->rows; row++) {
+		if (!cuCSVReaderGetInt(reader, row, column, &output[row])) {
+			retVal++;
+		}
+	}
+	return retVal;
+}
+
+int cuCSVReaderGetLongColumn(CU_NOTNULL const csv_reader* reader, int column, CU_NOTNULL long* output) {
+	int retVal = 0;
+	for (int row=0; row<reader->rows; row++) {
+		if (!cuCSVReaderGetLong(reader, row, column, &output[row])) {
+			retVal++;
+		}
+	}
+	return retVal;
+}
+
+int cuCSVReaderGetDoubleColumn(CU_NOTNULL const csv_reader* reader, int column, CU_NOTNULL double* output) {
+	int retVal = 0;
+	for (int row=0; row<reader->rows; row++) {
+		if (!cuCSVReaderGetDouble(reader, row, column, &output[row])) {
+			retVal++;
+		}
+	}
+	return retVal;
+}
+
+/**
+ * Find the end of a row
+ *
+ * @param[in] reader the reader involved
+ * @param[in] row the first character of the row
+ * @param[out] rowEnd the position just after the last character of the row. The terminator and a '\r' before a '\n' terminator are not
+ * 	part of the row
+ * @return the first character of the next row or the end of the file
+ */
+static const char* getNextRow(CU_NOTNULL const csv_reader* reader, CU_NOTNULL const char* row, CU_NOTNULL const char** rowEnd) {
+	const char* end = reader->data + reader->size;
+	const char* terminator = memchr(row, reader->terminator, end - row);
+	const char* retVal = terminator == NULL ? end : terminator + 1;
+	if (terminator == NULL) {
+		terminator = end;
+	}
+	if (reader->terminator == '\n' && terminator > row && terminator[-1] == '\r') {
+		terminator--;
+	}
+	*rowEnd = terminator;
+	return retVal;
+}
+
+/**
+ * Compute the offsets of the fields of a row
+ *
+ * @param[inout] reader the reader involved
+ * @param[in] row the index of the row
+ * @param[in] start the first character of the row
+ * @param[in] end the position just after the last character of the row
+ */
+static void indexRow(CU_NOTNULL csv_reader* reader, int row, CU_NOTNULL const char* start, CU_NOTNULL const char* end) {
+	size_t* offsets = &reader->offsets[((size_t) row) * (reader->columns + 1)];
+	const char* p = start;
+	const char* delimiter = NULL;
+	int column = 0;
+	while (column < reader->columns) {
+		offsets[column] = p - reader->data;
+		column++;
+		delimiter = memchr(p, reader->delimiter, end - p);
+		if (delimiter == NULL) {
+			break;
+		}
+		p = delimiter + 1;
+	}
+	if (delimiter == NULL) {
+		//the last field ends with the row. The missing fields are after the end of the row
+		for (; column<=reader->columns; column++) {
+			offsets[column] = (end - reader->data) + 1;
+		}
+	} else {
+		//the row may have more fields than the header: we ignore them
+		offsets[reader->columns] = p - reader->data;
+	}
+}
+
+/**
+ * Count the non empty rows in the chunks of a ::csv_index_job
+ *
+ * The numbers are put in ::csv_index_job::firstRows
+ */
+static enum thread_loop_state countRowsTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va) {
+	struct csv_index_job* job = cuVarArgsGetItem(va, 0, struct csv_index_job*);
+	unsigned int i;
+	while (cuParallelForGetNextChunk(&job->loop, &i)) {
+		const char* row = job->chunkStarts[i];
+		const char* rowEnd;
+		int rows = 0;
+		while (row < job->chunkStarts[i + 1]) {
+			const char* next = getNextRow(job->reader, row, &rowEnd);
+			if (rowEnd > row) {
+				rows++;
+			}
+			row = next;
+		}
+		job->firstRows[i] = rows;
+	}
+	return TLS_STOP;
+}
+
+/**
+ * Index the non empty rows in the chunks of a ::csv_index_job
+ */
+static enum thread_loop_state indexRowsTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va) {
+	struct csv_index_job* job = cuVarArgsGetItem(va, 0, struct csv_index_job*);
+	unsigned int i;
+	while (cuParallelForGetNextChunk(&job->loop, &i)) {
+		const char* row = job->chunkStarts[i];
+		const char* rowEnd;
+		int rowIndex = job->firstRows[i];
+		while (row < job->chunkStarts[i + 1]) {
+			const char* next = getNextRow(job->reader, row, &rowEnd);
+			if (rowEnd > row) {
+				indexRow(job->reader, rowIndex, row, rowEnd);
+				rowIndex++;
+			}
+			row = next;
+		}
+	}
+	return TLS_STOP;
+}
+
+/**
+ * Copy a field in a string
+ *
+ * @param[in] reader the reader involved
+ * @param[in] row the index of the data row
+ * @param[in] column the index of the column
+ * @param[out] buffer a buffer of ::BUFFER_SIZE characters which will contain the field, terminated by '\0'
+ * @return
+ *  @li true if the field has been copied;
+ *  @li false if the field is too long
+ */
+static bool copyField(CU_NOTNULL const csv_reader* reader, int row, int column, CU_NOTNULL char* buffer) {
+	csv_field field = cuCSVReaderGetField(reader, row, column);
+	if (field.length >= BUFFER_SIZE) {
+		return false;
+	}
+	memcpy(buffer, field.start, field.length);
+	buffer[field.length] = '\0';
+	return true;
+}
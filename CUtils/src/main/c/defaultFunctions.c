@@ -262,4 +262,8 @@ unsigned long hashString(const char* str) {
 		return hash;
 }
 
+unsigned long cuDefaultFunctionsHashString(CU_NOTNULL const char* str, CU_NULLABLE const struct var_args* context) {
+	return hashString(str);
+}
+
 
@@ -17,10 +17,7 @@
 #include "errors.h"
 
 Edge* newEdge(const struct Node* restrict source, const struct Node* restrict sink, const void* payload) {
-	Edge* retVal = (Edge*) malloc(sizeof(Edge));
-	if (retVal == NULL) {
-		ERROR_MALLOC();
-	}
+	Edge* retVal = CU_ALLOCATOR_NEW(source->allocator, Edge);
 
 	retVal->source = (struct Node*) source;
 	retVal->sink = (struct Node*) sink;
@@ -38,7 +35,7 @@ Edge* cloneEdgeWithPayload(const Edge* e, cloner payloadCloner) {
 }
 
 void destroyEdge(const Edge* _e, CU_NULLABLE const struct var_args* context) {
-	free((void*)_e);
+	CU_ALLOCATOR_FREE(_e->source->allocator, Edge, _e);
 }
 
 void destroyEdgeWithPayload(const Edge* e, destructor payloadDestructor) {
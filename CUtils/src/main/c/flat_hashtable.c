@@ -0,0 +1,375 @@
+/**
+ * @file
+ *
+ * Robin Hood hashing: each key is inserted as close as possible to its home slot, but an entry
+ * far from its home slot can steal the position of an entry closer to its own home. This keeps the probe sequences
+ * short and of similar length. Removals shift the following entries back by one slot, so no tombstone is ever needed.
+ *
+ * @author koldar
+ * @date Oct 16, 2026
+ */
+
+#include "flat_hashtable.h"
+#include <string.h>
+#include "errors.h"
+
+/**
+ * the capacity of the array when the first entry is added
+ */
+#define FLATHT_INITIAL_CAPACITY 16
+/**
+ * The array is doubled when \f$ \frac{size}{capacity} \f$ would exceed \f$ \frac{NUMERATOR}{DENOMINATOR} \f$
+ */
+#define FLATHT_MAX_LOAD_NUMERATOR 7
+#define FLATHT_MAX_LOAD_DENOMINATOR 8
+
+struct flat_ht {
+	///the array of slots. NULL if ::flat_ht::capacity is 0
+	flat_ht_slot* slots;
+	///number of slots in ::flat_ht::slots. Always a power of 2
+	size_t capacity;
+	///number of non empty slots in ::flat_ht::slots
+	size_t size;
+	payload_functions functions;
+};
+
+static unsigned long hashKey(unsigned long key);
+static flat_ht_slot* findSlot(CU_NOTNULL const flat_ht* ht, unsigned long key);
+static void insertNewKey(CU_NOTNULL flat_ht* ht, unsigned long key, CU_NULLABLE void* value);
+static void removeSlot(CU_NOTNULL flat_ht* ht, CU_NOTNULL flat_ht_slot* slot);
+static void resize(CU_NOTNULL flat_ht* ht, size_t newCapacity);
+static void growIfNeeded(CU_NOTNULL flat_ht* ht, size_t size);
+
+flat_ht* cuFlatHTNew(payload_functions functions) {
+	flat_ht* result = CU_MALLOC(flat_ht);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+
+	result->slots = NULL;
+	result->capacity = 0;
+	result->size = 0;
+	result->functions = functions;
+
+	return result;
+}
+
+CU_DEFINE_DEFAULT_VALUES(cuFlatHTNew,
+		cuPayloadFunctionsDefault()
+);
+
+void cuFlatHTDestroy(CU_NOTNULL const flat_ht* ht, CU_NULLABLE const struct var_args* context) {
+	CU_FREE(ht->slots);
+	CU_FREE(ht);
+}
+
+void cuFlatHTDestroyWithElements(CU_NOTNULL const flat_ht* ht, CU_NULLABLE const struct var_args* context) {
+	for (size_t i=0; i<ht->capacity; i++) {
+		if (ht->slots[i].distance != 0) {
+			ht->functions.destroy(ht->slots[i].value, context);
+		}
+	}
+	cuFlatHTDestroy(ht, context);
+}
+
+void cuFlatHTReserve(CU_NOTNULL flat_ht* ht, size_t size) {
+	growIfNeeded(ht, size);
+}
+
+size_t cuFlatHTGetSize(CU_NOTNULL const flat_ht* ht) {
+	return ht->size;
+}
+
+size_t cuFlatHTGetCapacity(CU_NOTNULL const flat_ht* ht) {
+	return ht->capacity;
+}
+
+bool cuFlatHTIsEmpty(CU_NOTNULL const flat_ht* ht) {
+	return ht->size == 0;
+}
+
+CU_NULLABLE void* cuFlatHTGetItem(CU_NOTNULL const flat_ht* ht, unsigned long key) {
+	flat_ht_slot* slot = findSlot(ht, key);
+	if (slot == NULL) {
+		return NULL;
+	}
+	return slot->value;
+}
+
+bool cuFlatHTContainsItem(CU_NOTNULL const flat_ht* ht, unsigned long key) {
+	return findSlot(ht, key) != NULL;
+}
+
+bool cuFlatHTAddOrUpdateItem(CU_NOTNULL flat_ht* ht, unsigned long key, CU_NULLABLE const void* data) {
+	flat_ht_slot* slot = findSlot(ht, key);
+	if (slot != NULL) {
+		slot->value = (void*) data;
+		return false;
+	}
+
+	growIfNeeded(ht, ht->size + 1);
+	insertNewKey(ht, key, (void*) data);
+	return true;
+}
+
+void cuFlatHTAddItem(CU_NOTNULL flat_ht* ht, unsigned long key, CU_NULLABLE const void* data) {
+	cuFlatHTAddOrUpdateItem(ht, key, data);
+}
+
+bool cuFlatHTUpdateItem(CU_NOTNULL flat_ht* ht, unsigned long key, CU_NULLABLE const void* data) {
+	flat_ht_slot* slot = findSlot(ht, key);
+	if (slot == NULL) {
+		return false;
+	}
+	slot->value = (void*) data;
+	return true;
+}
+
+bool cuFlatHTRemoveItem(CU_NOTNULL flat_ht* ht, unsigned long key) {
+	flat_ht_slot* slot = findSlot(ht, key);
+	if (slot == NULL) {
+		return false;
+	}
+	removeSlot(ht, slot);
+	return true;
+}
+
+bool cuFlatHTRemoveItemWithElement(CU_NOTNULL flat_ht* ht, unsigned long key) {
+	flat_ht_slot* slot = findSlot(ht, key);
+	if (slot == NULL) {
+		return false;
+	}
+	ht->functions.destroy(slot->value, NULL);
+	removeSlot(ht, slot);
+	return true;
+}
+
+void cuFlatHTClear(CU_NOTNULL flat_ht* ht) {
+	if (ht->slots != NULL) {
+		memset(ht->slots, 0, sizeof(flat_ht_slot) * ht->capacity);
+	}
+	ht->size = 0;
+}
+
+void cuFlatHTClearWithElements(CU_NOTNULL flat_ht* ht) {
+	for (size_t i=0; i<ht->capacity; i++) {
+		if (ht->slots[i].distance != 0) {
+			ht->functions.destroy(ht->slots[i].value, NULL);
+		}
+	}
+	cuFlatHTClear(ht);
+}
+
+CU_NULLABLE void* cuFlatHTGetFirstItem(CU_NOTNULL const flat_ht* ht) {
+	const flat_ht_slot* slot = _cuFlatHTGetFirstSlot(ht);
+	if (slot == NULL) {
+		return NULL;
+	}
+	return slot->value;
+}
+
+CU_NOTNULL flat_ht* cuFlatHTClone(CU_NOTNULL const flat_ht* ht) {
+	flat_ht* result = cuFlatHTNew(ht->functions);
+
+	if (ht->capacity > 0) {
+		result->slots = malloc(sizeof(flat_ht_slot) * ht->capacity);
+		if (result->slots == NULL) {
+			ERROR_MALLOC();
+		}
+		memcpy(result->slots, ht->slots, sizeof(flat_ht_slot) * ht->capacity);
+	}
+	result->capacity = ht->capacity;
+	result->size = ht->size;
+
+	return result;
+}
+
+int cuFlatHTBufferString(CU_NOTNULL const flat_ht* ht, CU_NOTNULL char* buffer) {
+	int i = 0;
+	size_t j = 0;
+
+	i += sprintf(&buffer[i], "{");
+	CU_ITERATE_OVER_FLATHT(ht, key, value, void*) {
+		j++;
+		i += sprintf(&buffer[i], "<%lu: ", key);
+		i += ht->functions.bufferString(value, &buffer[i]);
+		i += sprintf(&buffer[i], ">");
+		if (j < ht->size) {
+			i += sprintf(&buffer[i], ",");
+		}
+	}
+	i += sprintf(&buffer[i], "}");
+	return i;
+}
+
+CU_NULLABLE const flat_ht_slot* _cuFlatHTGetFirstSlot(CU_NOTNULL const flat_ht* ht) {
+	if (ht->size == 0) {
+		return NULL;
+	}
+	for (size_t i=0; i<ht->capacity; i++) {
+		if (ht->slots[i].distance != 0) {
+			return &ht->slots[i];
+		}
+	}
+	return NULL;
+}
+
+CU_NULLABLE const flat_ht_slot* _cuFlatHTGetNextSlot(CU_NOTNULL const flat_ht* ht, CU_NOTNULL const flat_ht_slot* slot) {
+	const flat_ht_slot* end = ht->slots + ht->capacity;
+	for (slot = slot + 1; slot < end; slot++) {
+		if (slot->distance != 0) {
+			return slot;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Scrambles the bits of the key
+ *
+ * Keys are often sequential ids: since the slot is computed by masking the lower bits of the hash we need
+ * every bit of the key to influence the lower bits. We use the finalizer of splitmix64.
+ *
+ * @param[in] key the key to hash
+ * @return the hash of @c key
+ */
+static unsigned long hashKey(unsigned long key) {
+	unsigned long long x = key;
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ULL;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+	return (unsigned long) x;
+}
+
+/**
+ * Look for the slot containing @c key
+ *
+ * Thanks to the Robin Hood invariant we can stop as soon as we reach a slot whose entry is closer to its home
+ * than we are to ours: if @c key were in the table, it would have taken that slot.
+ *
+ * @param[in] ht the hashtable involved
+ * @param[in] key the key to look for
+ * @return
+ *  @li the slot containing @c key;
+ *  @li NULL if @c key is not in the hashtable
+ */
+static flat_ht_slot* findSlot(CU_NOTNULL const flat_ht* ht, unsigned long key) {
+	if (ht->size == 0) {
+		return NULL;
+	}
+
+	size_t mask = ht->capacity - 1;
+	size_t i = hashKey(key) & mask;
+	unsigned int distance = 1;
+
+	while (true) {
+		flat_ht_slot* slot = &ht->slots[i];
+		if (slot->distance < distance) {
+			//either the slot is empty or the key would have stolen this slot
+			return NULL;
+		}
+		if (slot->key == key) {
+			return slot;
+		}
+		i = (i + 1) & mask;
+		distance++;
+	}
+}
+
+/**
+ * Add a new entry in the array
+ *
+ * @pre
+ *  @li @c key is not in the hashtable;
+ *  @li there is room for another entry;
+ *
+ * @param[inout] ht the hashtable involved
+ * @param[in] key the key to add
+ * @param[in] value the value to add
+ */
+static void insertNewKey(CU_NOTNULL flat_ht* ht, unsigned long key, CU_NULLABLE void* value) {
+	size_t mask = ht->capacity - 1;
+	size_t i = hashKey(key) & mask;
+	flat_ht_slot toInsert = {key, value, 1};
+
+	while (true) {
+		flat_ht_slot* slot = &ht->slots[i];
+		if (slot->distance == 0) {
+			*slot = toInsert;
+			ht->size += 1;
+			return;
+		}
+		if (slot->distance < toInsert.distance) {
+			//the entry in the slot is richer than us: steal its place and keep on inserting the evicted entry
+			flat_ht_slot tmp = *slot;
+			*slot = toInsert;
+			toInsert = tmp;
+		}
+		i = (i + 1) & mask;
+		toInsert.distance++;
+	}
+}
+
+/**
+ * Remove the entry in @c slot by shifting back all the following entries which are not in their home slot
+ *
+ * @param[inout] ht the hashtable involved
+ * @param[in] slot the slot to empty
+ */
+static void removeSlot(CU_NOTNULL flat_ht* ht, CU_NOTNULL flat_ht_slot* slot) {
+	size_t mask = ht->capacity - 1;
+	size_t i = slot - ht->slots;
+	size_t next = (i + 1) & mask;
+
+	while (ht->slots[next].distance > 1) {
+		ht->slots[i] = ht->slots[next];
+		ht->slots[i].distance--;
+		i = next;
+		next = (next + 1) & mask;
+	}
+	ht->slots[i].distance = 0;
+	ht->size -= 1;
+}
+
+/**
+ * Reallocate the slot array and rehash every entry
+ *
+ * @param[inout] ht the hashtable involved
+ * @param[in] newCapacity the new number of slots. Needs to be a power of 2
+ */
+static void resize(CU_NOTNULL flat_ht* ht, size_t newCapacity) {
+	flat_ht_slot* oldSlots = ht->slots;
+	size_t oldCapacity = ht->capacity;
+
+	ht->slots = calloc(newCapacity, sizeof(flat_ht_slot));
+	if (ht->slots == NULL) {
+		ERROR_MALLOC();
+	}
+	ht->capacity = newCapacity;
+	ht->size = 0;
+
+	for (size_t i=0; i<oldCapacity; i++) {
+		if (oldSlots[i].distance != 0) {
+			insertNewKey(ht, oldSlots[i].key, oldSlots[i].value);
+		}
+	}
+	CU_FREE(oldSlots);
+}
+
+/**
+ * Make sure the hashtable can contain @c size entries without exceeding the maximum load factor
+ *
+ * @param[inout] ht the hashtable involved
+ * @param[in] size the number of entries the hashtable needs to contain
+ */
+static void growIfNeeded(CU_NOTNULL flat_ht* ht, size_t size) {
+	size_t newCapacity = ht->capacity == 0 ? FLATHT_INITIAL_CAPACITY : ht->capacity;
+	while ((size * FLATHT_MAX_LOAD_DENOMINATOR) > (newCapacity * FLATHT_MAX_LOAD_NUMERATOR)) {
+		newCapacity *= 2;
+	}
+	if (newCapacity != ht->capacity) {
+		resize(ht, newCapacity);
+	}
+}
@@ -0,0 +1,479 @@
+/*
+ * graph_loader.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: koldar
+ */
+
+#include "graph_loader.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "errors.h"
+
+/**
+ * the minimum number of bytes parsed by a single task. Smaller files are parsed by less tasks
+ */
+#define GRAPH_LOADER_MIN_CHUNK_SIZE (1 << 20)
+
+/**
+ * An edge read from the file
+ */
+struct loaded_edge {
+	NodeId source;
+	NodeId sink;
+	long weight;
+};
+
+/**
+ * A part of the file parsed by a single task
+ */
+struct graph_parse_chunk {
+	///the first character of the chunk. It is the beginning of a line
+	const char* start;
+	///the character after the last one of the chunk
+	const char* end;
+	///the edges found in the chunk, in the order they appear
+	struct loaded_edge* edges;
+	///number of edges in ::graph_parse_chunk::edges
+	size_t size;
+	///number of cells of ::graph_parse_chunk::edges
+	size_t capacity;
+	///true if the chunk contains a line we couldn't parse
+	bool malformed;
+};
+
+/**
+ * The work needed to parse a file
+ */
+struct graph_parse_job {
+	enum graph_file_format format;
+	///::GFF_MATRIX_MARKET only: true if each off diagonal entry generates the edges in both directions
+	bool symmetric;
+	///::GFF_MATRIX_MARKET only: the weight of the transposed edge is the weight of the entry multiplied by this number
+	int transposedSign;
+	///::GFF_MATRIX_MARKET only: true if the entries have an integer value
+	bool integerValues;
+	///number of vertices declared in the header of the file. 0 if the header does not declare them
+	unsigned long declaredVertices;
+	///the chunks of the file
+	struct graph_parse_chunk* chunks;
+	int chunksNumber;
+	///the chunks handed out to the tasks
+	cu_parallel_for loop;
+};
+
+static const char* parseHeader(CU_NOTNULL struct graph_parse_job* job, CU_NOTNULL const char* data, CU_NOTNULL const char* end);
+static const char* parseNumber(CU_NOTNULL const char* p, CU_NOTNULL const char* end, CU_NOTNULL long* output);
+static void parseLine(CU_NOTNULL const struct graph_parse_job* job, CU_NOTNULL struct graph_parse_chunk* chunk, CU_NOTNULL const char* line, CU_NOTNULL const char* end);
+static void addLoadedEdge(CU_NOTNULL struct graph_parse_chunk* chunk, NodeId source, NodeId sink, long weight);
+static enum thread_loop_state parseChunkTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va);
+static Node* getOrAddNode(CU_NOTNULL PredSuccGraph* g, NodeId id);
+
+CU_NULLABLE PredSuccGraph* cuPredSuccGraphLoad(CU_NOTNULL const char* filePath, enum graph_file_format format, CU_NULLABLE cu_parallel_thread_pool* pool, bool enablePredecessors) {
+	int fd = open(filePath, O_RDONLY);
+	if (fd < 0) {
+		ERROR_FILE(filePath);
+	}
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0) {
+		ERROR_FILE(filePath);
+	}
+	size_t size = fileStat.st_size;
+	//an empty file can't be mapped
+	const char* data = "";
+	if (size > 0) {
+		void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping == MAP_FAILED) {
+			ERROR_FILE(filePath);
+		}
+		data = mapping;
+	}
+	close(fd);
+	const char* end = data + size;
+
+	struct graph_parse_job job;
+	job.format = format;
+	job.symmetric = false;
+	job.transposedSign = 1;
+	job.integerValues = false;
+	job.declaredVertices = 0;
+	job.chunks = NULL;
+	const char* body = parseHeader(&job, data, end);
+	if (body == NULL) {
+		if (size > 0) {
+			munmap((void*) data, size);
+		}
+		return NULL;
+	}
+
+	//split the body in chunks starting at the beginning of a line
+	job.chunksNumber = 1;
+	if (pool != NULL) {
+		size_t chunks = (end - body) / GRAPH_LOADER_MIN_CHUNK_SIZE;
+		job.chunksNumber = chunks < cuParallelThreadPoolGetThreadsNumber(pool) ? chunks : cuParallelThreadPoolGetThreadsNumber(pool);
+		if (job.chunksNumber < 1) {
+			job.chunksNumber = 1;
+		}
+	}
+	job.chunks = malloc(sizeof(struct graph_parse_chunk) * job.chunksNumber);
+	if (job.chunks == NULL) {
+		ERROR_MALLOC();
+	}
+	const char* start = body;
+	for (int i=0; i<job.chunksNumber; i++) {
+		const char* chunkEnd = end;
+		if ((i + 1) < job.chunksNumber) {
+			chunkEnd = body + ((end - body) / job.chunksNumber) * (i + 1);
+			if (chunkEnd < start) {
+				chunkEnd = start;
+			}
+			if (chunkEnd > body && chunkEnd[-1] != '\n') {
+				chunkEnd = memchr(chunkEnd, '\n', end - chunkEnd);
+				chunkEnd = chunkEnd == NULL ? end : chunkEnd + 1;
+			}
+		}
+		job.chunks[i].start = start;
+		job.chunks[i].end = chunkEnd;
+		job.chunks[i].edges = NULL;
+		job.chunks[i].size = 0;
+		job.chunks[i].capacity = 0;
+		job.chunks[i].malformed = false;
+		start = chunkEnd;
+	}
+
+	//parse the chunks
+	struct graph_parse_job* jobPtr = &job;
+	cuInitVarArgsOnStack(va, jobPtr);
+	cuParallelThreadPoolFor(pool, parseChunkTask, va, &job.loop, job.chunksNumber);
+
+	bool malformed = false;
+	size_t edgesNumber = 0;
+	for (int i=0; i<job.chunksNumber; i++) {
+		malformed = malformed || job.chunks[i].malformed;
+		edgesNumber += job.chunks[i].size;
+	}
+
+	//bulk insert the vertices and the edges
+	PredSuccGraph* result = NULL;
+	if (!malformed) {
+		result = cuPredSuccGraphNew(enablePredecessors, cuPayloadFunctionsIntValue(), cuPayloadFunctionsIntValue());
+		Node** nodes = NULL;
+		if (job.declaredVertices > 0) {
+			cuHTReserve(result->nodes, job.declaredVertices);
+			nodes = malloc(sizeof(Node*) * (job.declaredVertices + 1));
+			if (nodes == NULL) {
+				ERROR_MALLOC();
+			}
+			for (NodeId id=1; id<=job.declaredVertices; id++) {
+				nodes[id] = cuPredSuccGraphAddNodeInGraphById(result, id, NULL);
+			}
+		} else {
+			//an estimate: sparse graphs have about as many vertices as edges
+			cuHTReserve(result->nodes, edgesNumber < INT_MAX ? (int) edgesNumber : INT_MAX);
+		}
+
+		for (int i=0; i<job.chunksNumber && !malformed; i++) {
+			const struct graph_parse_chunk* chunk = &job.chunks[i];
+			Node* source = NULL;
+			for (size_t e=0; e<chunk->size; e++) {
+				const struct loaded_edge* edge = &chunk->edges[e];
+				if (nodes != NULL && (edge->source == 0 || edge->source > job.declaredVertices || edge->sink == 0 || edge->sink > job.declaredVertices)) {
+					malformed = true;
+					break;
+				}
+				if (source == NULL || source->id != edge->source) {
+					//edges are usually grouped by source: size the successors of the source for all its edges in this group
+					source = nodes != NULL ? nodes[edge->source] : getOrAddNode(result, edge->source);
+					size_t groupEnd = e + 1;
+					while (groupEnd < chunk->size && chunk->edges[groupEnd].source == edge->source) {
+						groupEnd++;
+					}
+					cuHTReserve(source->successors, cuHTGetSize(source->successors) + (groupEnd - e));
+				}
+				Node* sink = nodes != NULL ? nodes[edge->sink] : getOrAddNode(result, edge->sink);
+				_cuPredSuccGraphAddEdge(source, sink, CU_CAST_INT2PTR(edge->weight));
+			}
+		}
+
+		if (nodes != NULL) {
+			CU_FREE(nodes);
+		}
+		if (malformed) {
+			cuPredSuccGraphDestroyWithElements(result, NULL);
+			result = NULL;
+		}
+	}
+
+	for (int i=0; i<job.chunksNumber; i++) {
+		if (job.chunks[i].edges != NULL) {
+			CU_FREE(job.chunks[i].edges);
+		}
+	}
+	CU_FREE(job.chunks);
+	if (size > 0) {
+		munmap((void*) data, size);
+	}
+
+	return result;
+}
+
+CU_DEFINE_DEFAULT_VALUES(cuPredSuccGraphLoad,
+		,
+		,
+		NULL,
+		false
+);
+
+/**
+ * Read the part of the file before the edges
+ *
+ * @param[inout] job the job to setup with the information in the header
+ * @param[in] data the beginning of the file
+ * @param[in] end the end of the file
+ * @return
+ *  @li the first character which may contain an edge;
+ *  @li NULL if the header is not valid
+ */
+static const char* parseHeader(CU_NOTNULL struct graph_parse_job* job, CU_NOTNULL const char* data, CU_NOTNULL const char* end) {
+	switch (job->format) {
+	case GFF_EDGE_LIST: {
+		return data;
+	}
+	case GFF_DIMACS: {
+		//the "p sp n m" line is before the arcs. The other lines are ignored while parsing the arcs
+		const char* line = data;
+		while (line < end && *line != 'a') {
+			const char* lineEnd = memchr(line, '\n', end - line);
+			lineEnd = lineEnd == NULL ? end : lineEnd;
+			if (*line == 'p') {
+				const char* p = line + 1;
+				//skip the problem name
+				while (p < lineEnd && (*p == ' ' || *p == '\t')) {
+					p++;
+				}
+				while (p < lineEnd && *p != ' ' && *p != '\t') {
+					p++;
+				}
+				long vertices;
+				if (parseNumber(p, lineEnd, &vertices) == NULL || vertices < 0) {
+					return NULL;
+				}
+				job->declaredVertices = vertices;
+			}
+			line = lineEnd + 1;
+		}
+		return data;
+	}
+	case GFF_MATRIX_MARKET: {
+		char banner[BUFFER_SIZE];
+		char object[BUFFER_SIZE];
+		char matrixFormat[BUFFER_SIZE];
+		char field[BUFFER_SIZE];
+		char symmetry[BUFFER_SIZE];
+		const char* lineEnd = memchr(data, '\n', end - data);
+		lineEnd = lineEnd == NULL ? end : lineEnd;
+		if ((lineEnd - data) >= BUFFER_SIZE) {
+			return NULL;
+		}
+		memcpy(banner, data, lineEnd - data);
+		banner[lineEnd - data] = '\0';
+		if (sscanf(banner, "%%%%MatrixMarket %299s %299s %299s %299s", object, matrixFormat, field, symmetry) != 4) {
+			return NULL;
+		}
+		if (strcasecmp(object, "matrix") != 0 || strcasecmp(matrixFormat, "coordinate") != 0) {
+			return NULL;
+		}
+		job->integerValues = strcasecmp(field, "integer") == 0;
+		if (strcasecmp(symmetry, "general") == 0) {
+			job->symmetric = false;
+		} else if (strcasecmp(symmetry, "symmetric") == 0 || strcasecmp(symmetry, "hermitian") == 0) {
+			job->symmetric = true;
+		} else if (strcasecmp(symmetry, "skew-symmetric") == 0) {
+			job->symmetric = true;
+			job->transposedSign = -1;
+		} else {
+			return NULL;
+		}
+
+		//skip the comments, then read the size line
+		const char* line = lineEnd + 1;
+		while (line < end) {
+			lineEnd = memchr(line, '\n', end - line);
+			lineEnd = lineEnd == NULL ? end : lineEnd;
+			long rows;
+			long columns;
+			const char* p;
+			if (*line == '%' || (p = parseNumber(line, lineEnd, &rows)) == NULL) {
+				line = lineEnd + 1;
+				continue;
+			}
+			if ((p = parseNumber(p, lineEnd, &columns)) == NULL || rows < 0 || columns < 0) {
+				return NULL;
+			}
+			job->declaredVertices = rows > columns ? rows : columns;
+			return lineEnd < end ? lineEnd + 1 : end;
+		}
+		return NULL;
+	}
+	default: {
+		ERROR_UNHANDLED_CASE("graph file format", job->format);
+	}
+	}
+	return NULL;
+}
+
+/**
+ * Parse an integer
+ *
+ * @param[in] p where to start parsing. Spaces and tabs are skipped
+ * @param[in] end the end of the line
+ * @param[out] output the number parsed
+ * @return
+ *  @li the character after the number;
+ *  @li NULL if there is no integer at @c p (or if the number is followed by something which is not a space)
+ */
+static const char* parseNumber(CU_NOTNULL const char* p, CU_NOTNULL const char* end, CU_NOTNULL long* output) {
+	while (p < end && (*p == ' ' || *p == '\t')) {
+		p++;
+	}
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+')) {
+		negative = *p == '-';
+		p++;
+	}
+	const char* digits = p;
+	long value = 0;
+	while (p < end && *p >= '0' && *p <= '9') {
+		value = value * 10 + (*p - '0');
+		p++;
+	}
+	if (p == digits || (p < end && *p != ' ' && *p != '\t' && *p != '\r')) {
+		return NULL;
+	}
+	*output = negative ? -value : value;
+	return p;
+}
+
+/**
+ * Parse a line of the file, adding the edges found in the chunk
+ *
+ * @param[in] job the job involved
+ * @param[inout] chunk the chunk containing the line
+ * @param[in] line the first character of the line
+ * @param[in] end the end of the line
+ */
+static void parseLine(CU_NOTNULL const struct graph_parse_job* job, CU_NOTNULL struct graph_parse_chunk* chunk, CU_NOTNULL const char* line, CU_NOTNULL const char* end) {
+	const char* p = line;
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+		p++;
+	}
+	if (p == end) {
+		return;
+	}
+
+	long source;
+	long sink;
+	long weight = 0;
+	switch (job->format) {
+	case GFF_EDGE_LIST: {
+		if (*p == '#' || *p == '%') {
+			return;
+		}
+		break;
+	}
+	case GFF_DIMACS: {
+		if (*p != 'a') {
+			return;
+		}
+		p++;
+		break;
+	}
+	case GFF_MATRIX_MARKET: {
+		if (*p == '%') {
+			return;
+		}
+		break;
+	}
+	default: {
+		ERROR_UNHANDLED_CASE("graph file format", job->format);
+	}
+	}
+
+	if ((p = parseNumber(p, end, &source)) == NULL || (p = parseNumber(p, end, &sink)) == NULL || source < 0 || sink < 0) {
+		chunk->malformed = true;
+		return;
+	}
+	if (job->format != GFF_MATRIX_MARKET || job->integerValues) {
+		//an optional integer weight
+		if (parseNumber(p, end, &weight) == NULL) {
+			weight = 0;
+		}
+	}
+
+	addLoadedEdge(chunk, source, sink, weight);
+	if (job->symmetric && source != sink) {
+		addLoadedEdge(chunk, sink, source, job->transposedSign * weight);
+	}
+}
+
+/**
+ * Put an edge in the buffer of a chunk
+ *
+ * @param[inout] chunk the chunk involved
+ * @param[in] source the id of the source
+ * @param[in] sink the id of the sink
+ * @param[in] weight the weight of the edge
+ */
+static void addLoadedEdge(CU_NOTNULL struct graph_parse_chunk* chunk, NodeId source, NodeId sink, long weight) {
+	if (chunk->size == chunk->capacity) {
+		//an edge takes at least 4 characters
+		size_t capacity = chunk->capacity == 0 ? ((chunk->end - chunk->start) / 8 + 16) : chunk->capacity * 2;
+		chunk->edges = realloc(chunk->edges, sizeof(struct loaded_edge) * capacity);
+		if (chunk->edges == NULL) {
+			ERROR_MALLOC();
+		}
+		chunk->capacity = capacity;
+	}
+	chunk->edges[chunk->size].source = source;
+	chunk->edges[chunk->size].sink = sink;
+	chunk->edges[chunk->size].weight = weight;
+	chunk->size++;
+}
+
+/**
+ * Parse the chunks of a ::graph_parse_job
+ */
+static enum thread_loop_state parseChunkTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va) {
+	struct graph_parse_job* job = cuVarArgsGetItem(va, 0, struct graph_parse_job*);
+	unsigned int i;
+	while (cuParallelForGetNextChunk(&job->loop, &i)) {
+		struct graph_parse_chunk* chunk = &job->chunks[i];
+		const char* line = chunk->start;
+		while (line < chunk->end && !chunk->malformed) {
+			const char* lineEnd = memchr(line, '\n', chunk->end - line);
+			lineEnd = lineEnd == NULL ? chunk->end : lineEnd;
+			parseLine(job, chunk, line, lineEnd);
+			line = lineEnd + 1;
+		}
+	}
+	return TLS_STOP;
+}
+
+/**
+ * @param[inout] g the graph involved
+ * @param[in] id the id of the vertex to fetch
+ * @return the vertex with the given id. If there is no such vertex, it is added in the graph
+ */
+static Node* getOrAddNode(CU_NOTNULL PredSuccGraph* g, NodeId id) {
+	Node* result = cuPredSuccGraphGetNodeById(g, id);
+	if (result == NULL) {
+		result = cuPredSuccGraphAddNodeInGraphById(g, id, NULL);
+	}
+	return result;
+}
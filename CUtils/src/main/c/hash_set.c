@@ -6,57 +6,126 @@
  */
 
 #include "hash_set.h"
-#include "hashtable.h"
+#include <string.h>
 #include "macros.h"
 #include "log.h"
 #include "errors.h"
 
+/**
+ * the capacity of the array when the first item is added
+ */
+#define HASHSET_INITIAL_CAPACITY 16
+/**
+ * The array is doubled when \f$ \frac{size}{capacity} \f$ would exceed \f$ \frac{NUMERATOR}{DENOMINATOR} \f$
+ */
+#define HASHSET_MAX_LOAD_NUMERATOR 7
+#define HASHSET_MAX_LOAD_DENOMINATOR 8
+/**
+ * bit set in the hash of every non empty slot. A slot whose ::hash_set_slot::hash is 0 is empty
+ */
+#define HASHSET_OCCUPIED (1UL << (sizeof(unsigned long) * 8 - 1))
+
+/**
+ * A slot of the array of a ::hash_set
+ *
+ * The distance between the slot and the home slot of its item is computed from the hash, so a slot is just 2 words
+ */
+typedef struct hash_set_slot {
+	///the hash of ::hash_set_slot::item, with ::HASHSET_OCCUPIED set. 0 if the slot is empty
+	unsigned long hash;
+	void* item;
+} hash_set_slot;
+
 struct hash_set {
-	HT* hashTable;
+	///the array of slots. NULL if ::hash_set::capacity is 0
+	hash_set_slot* slots;
+	///number of slots in ::hash_set::slots. Always a power of 2
+	size_t capacity;
+	///number of items in the set
+	size_t size;
 	payload_functions functions;
+	///function hashing the items. NULL if items are compared by pointer
+	hashfunction_t hash;
 };
 
+static unsigned long hashItem(CU_NOTNULL const hash_set* set, const void* item);
+static bool areEqual(CU_NOTNULL const hash_set* set, const void* a, const void* b);
+static size_t getDistance(CU_NOTNULL const hash_set* set, size_t index);
+static hash_set_slot* findSlot(CU_NOTNULL const hash_set* set, const void* item);
+static void insertNewItem(CU_NOTNULL hash_set* set, unsigned long hash, void* item);
+static void removeSlot(CU_NOTNULL hash_set* set, CU_NOTNULL hash_set_slot* slot);
+static void resize(CU_NOTNULL hash_set* set, size_t newCapacity);
+static void growIfNeeded(CU_NOTNULL hash_set* set, size_t size);
 
-hash_set* cuHashSetNew(payload_functions functions) {
+hash_set* cuHashSetNew(payload_functions functions, CU_NULLABLE hashfunction_t hash) {
 	hash_set* retVal = malloc(sizeof(hash_set));
 	if (retVal == NULL) {
 		ERROR_MALLOC();
 	}
 
-	retVal->hashTable = cuHTNew();
+	retVal->slots = NULL;
+	retVal->capacity = 0;
+	retVal->size = 0;
 	retVal->functions = functions;
+	retVal->hash = hash;
 
 	return retVal;
 }
 
+CU_DEFINE_DEFAULT_VALUES(cuHashSetNew,
+		cuPayloadFunctionsDefault(),
+		NULL
+);
+
 bool cuHashSetAddItem(CU_NOTNULL hash_set* set, const void* item) {
-	return cuHTAddOrUpdateItem(set->hashTable, (unsigned long)item, item);
+	if (findSlot(set, item) != NULL) {
+		return false;
+	}
+	growIfNeeded(set, set->size + 1);
+	insertNewItem(set, hashItem(set, item), (void*) item);
+	return true;
+}
+
+CU_NULLABLE void* cuHashSetGetItem(CU_NOTNULL const hash_set* set, const void* item) {
+	hash_set_slot* slot = findSlot(set, item);
+	return slot == NULL ? NULL : slot->item;
 }
 
 bool cuHashSetContainsItem(CU_NOTNULL const hash_set* set, const void* item) {
-	return cuHTContainsItem(set->hashTable, (unsigned long)item);
+	return findSlot(set, item) != NULL;
 }
 
 void cuHashSetRemoveItem(CU_NOTNULL hash_set* set, const void* item) {
-	cuHTRemoveItem(set->hashTable, (unsigned long)item);
+	hash_set_slot* slot = findSlot(set, item);
+	if (slot != NULL) {
+		removeSlot(set, slot);
+	}
 }
 
 void cuHashSetDestroy(CU_NOTNULL const hash_set* set, CU_NULLABLE const struct var_args* context) {
-	cuHTDestroy(set->hashTable, context);
+	CU_FREE(set->slots);
 	CU_FREE(set);
 }
 
 void cuHashSetDestroyWithElements(const CU_NOTNULL hash_set* set, CU_NULLABLE const struct var_args* context) {
-	cuHTDestroyWithElements(set->hashTable, set->functions.destroy);
-	CU_FREE(set);
+	for (size_t i=0; i<set->capacity; i++) {
+		if (set->slots[i].hash != 0) {
+			set->functions.destroy(set->slots[i].item, context);
+		}
+	}
+	cuHashSetDestroy(set, context);
+}
+
+void cuHashSetReserve(CU_NOTNULL hash_set* set, size_t size) {
+	growIfNeeded(set, size);
 }
 
 size_t cuHashSetGetSize(CU_NOTNULL const hash_set* set) {
-	return cuHTGetSize(set->hashTable);
+	return set->size;
 }
 
 bool cuHashSetIsEmpty(CU_NOTNULL const hash_set* set) {
-	return cuHTIsEmpty(set->hashTable);
+	return set->size == 0;
 }
 
 hash_set* cuHashSetGetUnionOfHashSets(CU_NOTNULL hash_set* restrict set1, CU_NOTNULL const hash_set* restrict set2, bool inPlace) {
@@ -99,7 +168,7 @@ hash_set* cuHashSetGetIntersectionOfHashSets(CU_NOTNULL hash_set* restrict set1,
 			}
 		}
 	} else {
-		retVal = cuHashSetNew(set1->functions);
+		retVal = cuHashSetNew(set1->functions, set1->hash);
 
 		//the ">=" handle the scenario where the sets have the same size
 		const hash_set* minSizedSet = cuHashSetGetSize(set1) < cuHashSetGetSize(set2) ? set1 : set2;
@@ -137,11 +206,19 @@ hash_set* cuHashSetGetDifferenceOfHashSets(CU_NOTNULL hash_set* restrict set1, C
 }
 
 void cuHashSetClear(const hash_set* set) {
-	cuHTClear(set->hashTable);
+	if (set->slots != NULL) {
+		memset(set->slots, 0, sizeof(hash_set_slot) * set->capacity);
+	}
+	((hash_set*)set)->size = 0;
 }
 
 void cuHashSetClearWithElements(CU_NOTNULL const hash_set* set) {
-	cuHTClearWithElements(set->hashTable, set->functions.destroy);
+	for (size_t i=0; i<set->capacity; i++) {
+		if (set->slots[i].hash != 0) {
+			set->functions.destroy(set->slots[i].item, NULL);
+		}
+	}
+	cuHashSetClear(set);
 }
 
 int cuHashSetGetBufferString(CU_NOTNULL const hash_set* set, char* buffer) {
@@ -164,29 +241,281 @@ int cuHashSetGetBufferString(CU_NOTNULL const hash_set* set, char* buffer) {
 }
 
 hash_set* cuHashSetCloneByReference(CU_NOTNULL const hash_set* set) {
-	hash_set* retVal = cuHashSetNew(set->functions);
+	hash_set* retVal = cuHashSetNew(set->functions, set->hash);
 
-	CU_ITERATE_OVER_HASHSET(set, var, void*) {
-		cuHashSetAddItem(retVal, var);
+	if (set->capacity > 0) {
+		retVal->slots = malloc(sizeof(hash_set_slot) * set->capacity);
+		if (retVal->slots == NULL) {
+			ERROR_MALLOC();
+		}
+		memcpy(retVal->slots, set->slots, sizeof(hash_set_slot) * set->capacity);
 	}
+	retVal->capacity = set->capacity;
+	retVal->size = set->size;
 
 	return retVal;
 }
 
 hash_set* cuHashSetClone(CU_NOTNULL const hash_set* set) {
-	hash_set* retVal = cuHashSetNew(set->functions);
+	if (set->hash != NULL) {
+		//the items are hashed by content: the clones have the same hash of the originals, so they can stay in the same slots
+		hash_set* retVal = cuHashSetCloneByReference(set);
+		for (size_t i=0; i<retVal->capacity; i++) {
+			if (retVal->slots[i].hash != 0) {
+				retVal->slots[i].item = set->functions.clone(retVal->slots[i].item);
+			}
+		}
+		return retVal;
+	}
 
-	CU_ITERATE_OVER_HASHSET(set, var, void*) {
-		cuHashSetAddItem(retVal, set->functions.clone(var));
+	//the items are hashed by address: each clone needs its own slot
+	hash_set* retVal = cuHashSetNew(set->functions, set->hash);
+	if (set->capacity > 0) {
+		retVal->slots = calloc(set->capacity, sizeof(hash_set_slot));
+		if (retVal->slots == NULL) {
+			ERROR_MALLOC();
+		}
+		retVal->capacity = set->capacity;
+	}
+	for (size_t i=0; i<set->capacity; i++) {
+		if (set->slots[i].hash != 0) {
+			void* clone = set->functions.clone(set->slots[i].item);
+			insertNewItem(retVal, hashItem(retVal, clone), clone);
+		}
 	}
 
 	return retVal;
 }
 
 void* cuHashSetGetAnItem(CU_NOTNULL const hash_set* set) {
-	return cuHTGetFirstItem(set->hashTable);
+	if (set->size == 0) {
+		return NULL;
+	}
+	for (size_t i=0; i<set->capacity; i++) {
+		if (set->slots[i].hash != 0) {
+			return set->slots[i].item;
+		}
+	}
+	return NULL;
+}
+
+hash_set_cursor _cuHashSetGetFirstCursor(CU_NOTNULL const hash_set* set) {
+	hash_set_cursor result = {0, 0, 0, NULL, false};
+
+	if (set->size == 0) {
+		return result;
+	}
+	//the load factor is less than 1, so there is always an empty slot
+	size_t empty = 0;
+	while (set->slots[empty].hash != 0) {
+		empty++;
+	}
+	result.next = (empty + 1) & (set->capacity - 1);
+	result.remaining = set->capacity - 1;
+	return result;
+}
+
+bool _cuHashSetMoveCursor(CU_NOTNULL const hash_set* set, CU_NOTNULL hash_set_cursor* cursor) {
+	size_t mask = set->capacity - 1;
+
+	if (cursor->returned && (set->slots[cursor->current].hash == 0 || set->slots[cursor->current].item != cursor->item)) {
+		//the last item has been removed: its slot may now contain an item we have not visited yet
+		cursor->next = cursor->current;
+		cursor->remaining++;
+	}
+	while (cursor->remaining > 0) {
+		size_t i = cursor->next;
+		cursor->next = (cursor->next + 1) & mask;
+		cursor->remaining--;
+		if (set->slots[i].hash != 0) {
+			cursor->current = i;
+			cursor->item = set->slots[i].item;
+			cursor->returned = true;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Compute the hash of an item
+ *
+ * The hash computed by the user function is scrambled (we mask its lower bits to get the home slot of the item, so all its bits
+ * need to influence the lower ones) and marked with ::HASHSET_OCCUPIED
+ *
+ * @param[in] set the set involved
+ * @param[in] item the item to hash
+ * @return the value to store in ::hash_set_slot::hash
+ */
+static unsigned long hashItem(CU_NOTNULL const hash_set* set, const void* item) {
+	unsigned long long x = set->hash != NULL ? set->hash(item, NULL) : (unsigned long) item;
+	//finalizer of splitmix64
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ULL;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+	return ((unsigned long) x) | HASHSET_OCCUPIED;
 }
 
-HT* _cuHashSetGetUnderlyingHashTable(CU_NOTNULL const hash_set* set) {
-	return set->hashTable;
+/**
+ * @param[in] set the set involved
+ * @param[in] a the first item
+ * @param[in] b the second item
+ * @return true if the set considers @c a and @c b the same item
+ */
+static bool areEqual(CU_NOTNULL const hash_set* set, const void* a, const void* b) {
+	if (a == b) {
+		return true;
+	}
+	if (set->hash == NULL) {
+		return false;
+	}
+	return set->functions.compare(a, b);
+}
+
+/**
+ * @param[in] set the set involved
+ * @param[in] index the index of a non empty slot
+ * @return the distance between the slot and the slot where its item would be if there were no collisions
+ */
+static size_t getDistance(CU_NOTNULL const hash_set* set, size_t index) {
+	size_t mask = set->capacity - 1;
+	return (index - (set->slots[index].hash & mask)) & mask;
+}
+
+/**
+ * Look for the slot containing @c item
+ *
+ * Thanks to the Robin Hood invariant we can stop as soon as we reach a slot whose item is closer to its home
+ * than we are to ours. Cached hashes are compared before calling the (possibly expensive) comparator.
+ *
+ * @param[in] set the set involved
+ * @param[in] item the item to look for
+ * @return
+ *  @li the slot containing an item equal to @c item;
+ *  @li NULL if there is no such item
+ */
+static hash_set_slot* findSlot(CU_NOTNULL const hash_set* set, const void* item) {
+	if (set->size == 0) {
+		return NULL;
+	}
+
+	unsigned long hash = hashItem(set, item);
+	size_t mask = set->capacity - 1;
+	size_t i = hash & mask;
+	size_t distance = 0;
+
+	while (true) {
+		hash_set_slot* slot = &set->slots[i];
+		if (slot->hash == 0 || getDistance(set, i) < distance) {
+			return NULL;
+		}
+		if (slot->hash == hash && areEqual(set, slot->item, item)) {
+			return slot;
+		}
+		i = (i + 1) & mask;
+		distance++;
+	}
+}
+
+/**
+ * Add a new item in the array
+ *
+ * @pre
+ *  @li @c item is not in the set;
+ *  @li there is room for another item;
+ *
+ * @param[inout] set the set involved
+ * @param[in] hash the value returned by ::hashItem for @c item
+ * @param[in] item the item to add
+ */
+static void insertNewItem(CU_NOTNULL hash_set* set, unsigned long hash, void* item) {
+	size_t mask = set->capacity - 1;
+	size_t i = hash & mask;
+	size_t distance = 0;
+	hash_set_slot toInsert = {hash, item};
+
+	while (true) {
+		hash_set_slot* slot = &set->slots[i];
+		if (slot->hash == 0) {
+			*slot = toInsert;
+			set->size += 1;
+			return;
+		}
+		size_t slotDistance = getDistance(set, i);
+		if (slotDistance < distance) {
+			//the item in the slot is richer than us: steal its place and keep on inserting the evicted item
+			hash_set_slot tmp = *slot;
+			*slot = toInsert;
+			toInsert = tmp;
+			distance = slotDistance;
+		}
+		i = (i + 1) & mask;
+		distance++;
+	}
+}
+
+/**
+ * Remove the item in @c slot by shifting back all the following items which are not in their home slot
+ *
+ * @param[inout] set the set involved
+ * @param[in] slot the slot to empty
+ */
+static void removeSlot(CU_NOTNULL hash_set* set, CU_NOTNULL hash_set_slot* slot) {
+	size_t mask = set->capacity - 1;
+	size_t i = slot - set->slots;
+	size_t next = (i + 1) & mask;
+
+	while (set->slots[next].hash != 0 && getDistance(set, next) > 0) {
+		set->slots[i] = set->slots[next];
+		i = next;
+		next = (next + 1) & mask;
+	}
+	set->slots[i].hash = 0;
+	set->slots[i].item = NULL;
+	set->size -= 1;
+}
+
+/**
+ * Reallocate the slot array and put every item in its new slot
+ *
+ * Hashes are cached in the slots, hence the hash function is never called
+ *
+ * @param[inout] set the set involved
+ * @param[in] newCapacity the new number of slots. Needs to be a power of 2
+ */
+static void resize(CU_NOTNULL hash_set* set, size_t newCapacity) {
+	hash_set_slot* oldSlots = set->slots;
+	size_t oldCapacity = set->capacity;
+
+	set->slots = calloc(newCapacity, sizeof(hash_set_slot));
+	if (set->slots == NULL) {
+		ERROR_MALLOC();
+	}
+	set->capacity = newCapacity;
+	set->size = 0;
+
+	for (size_t i=0; i<oldCapacity; i++) {
+		if (oldSlots[i].hash != 0) {
+			insertNewItem(set, oldSlots[i].hash, oldSlots[i].item);
+		}
+	}
+	CU_FREE(oldSlots);
+}
+
+/**
+ * Make sure the set can contain @c size items without exceeding the maximum load factor
+ *
+ * @param[inout] set the set involved
+ * @param[in] size the number of items the set needs to contain
+ */
+static void growIfNeeded(CU_NOTNULL hash_set* set, size_t size) {
+	size_t newCapacity = set->capacity == 0 ? HASHSET_INITIAL_CAPACITY : set->capacity;
+	while ((size * HASHSET_MAX_LOAD_DENOMINATOR) > (newCapacity * HASHSET_MAX_LOAD_NUMERATOR)) {
+		newCapacity *= 2;
+	}
+	if (newCapacity != set->capacity) {
+		resize(set, newCapacity);
+	}
 }
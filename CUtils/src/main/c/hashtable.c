@@ -13,12 +13,18 @@
 struct HT {
 	HTCell* cell;
 	payload_functions functions;
+	///where the cells of the hashtable are allocated. NULL means malloc
+	cu_allocator* allocator;
+	///the number of entries requested by ::cuHTReserve while the hashtable was still empty
+	int reserved;
 };
 
-static HTCell* newHTCell(CU_NULLABLE const void* e, unsigned long key);
-static void destroyHTCell(CU_NOTNULL const HTCell* htCell, CU_NULLABLE const struct var_args* context);
+static HTCell* newHTCell(CU_NOTNULL HT* ht, CU_NULLABLE const void* e, unsigned long key);
+static void destroyHTCell(CU_NOTNULL HT* ht, CU_NOTNULL const HTCell* htCell, CU_NULLABLE const struct var_args* context);
+static void destroyAllHTCells(CU_NOTNULL HT* ht);
+static void expandBuckets(CU_NOTNULL HT* ht, int size);
 
-CU_NOTNULL HT* cuHTNew(payload_functions functions) {
+CU_NOTNULL HT* cuHTNew(payload_functions functions, CU_NULLABLE cu_allocator* allocator) {
 	HT* retVal = CU_MALLOC(HT);
 	if (retVal == NULL) {
 		ERROR_MALLOC();
@@ -26,12 +32,15 @@ CU_NOTNULL HT* cuHTNew(payload_functions functions) {
 
 	retVal->functions = functions;
 	retVal->cell = NULL;
+	retVal->allocator = allocator;
+	retVal->reserved = 0;
 
 	return retVal;
 }
 
 CU_DEFINE_DEFAULT_VALUES(cuHTNew,
-		cuPayloadFunctionsDefault()
+		cuPayloadFunctionsDefault(),
+		NULL
 );
 
 int cuHTGetSize(CU_NOTNULL const HT* ht) {
@@ -80,20 +89,26 @@ bool cuHTUpdateItem(CU_NOTNULL HT* ht, unsigned long key, CU_NULLABLE const void
 	return true;
 }
 
+void cuHTReserve(CU_NOTNULL HT* ht, int size) {
+	if (ht->cell == NULL) {
+		//uthash creates the buckets with the first entry
+		ht->reserved = size;
+	} else {
+		expandBuckets(ht, size);
+	}
+}
+
 void cuHTAddItem(CU_NOTNULL HT* ht, unsigned long key, CU_NULLABLE const void* data) {
-	HTCell* add = newHTCell(data, key);
+	HTCell* add = newHTCell(ht, data, key);
 	HASH_ADD(hh, ht->cell, id, sizeof(unsigned long), add);
+	if (ht->reserved > 0) {
+		expandBuckets(ht, ht->reserved);
+		ht->reserved = 0;
+	}
 }
 
 void cuHTDestroy(CU_NOTNULL HT* ht, CU_NULLABLE const struct var_args* context) {
-
-	HTCell* s;
-	HTCell* tmp;
-
-	HASH_ITER(hh, ht->cell, s, tmp) {
-		HASH_DEL(ht->cell, s);
-		destroyHTCell(s, context);
-	}
+	destroyAllHTCells(ht);
 	CU_FREE(ht);
 }
 
@@ -104,7 +119,7 @@ void cuHTDestroyWithElements(CU_NOTNULL HT* ht, destructor d) {
 	HASH_ITER(hh, ht->cell, s, tmp) {
 		HASH_DEL(ht->cell, s);
 		d(s->data, NULL); //TODO context null
-		destroyHTCell(s, NULL); //TODO contrext null
+		destroyHTCell(ht, s, NULL); //TODO contrext null
 	}
 	free(ht);
 }
@@ -117,14 +132,14 @@ void cuHTDestroyWithElements2(CU_NOTNULL const HT* _ht, CU_NULLABLE const struct
 	HASH_ITER(hh, ht->cell, s, tmp) {
 		HASH_DEL(ht->cell, s);
 		ht->functions.destroy(s->data, context);
-		destroyHTCell(s, context);
+		destroyHTCell(ht, s, context);
 	}
 	CU_FREE(ht);
 }
 
 void cuHTDestroyCell(CU_NOTNULL HT* ht, CU_NOTNULL HTCell* htCell) {
 	HASH_DEL(ht->cell, htCell);
-	destroyHTCell(htCell, NULL); //TODO context null
+	destroyHTCell(ht, htCell, NULL); //TODO context null
 }
 
 void cuHTDestroyCellWithElement(CU_NOTNULL HTCell* htCell, destructor d) {
@@ -140,7 +155,7 @@ bool cuHTRemoveItem(CU_NOTNULL HT* ht, unsigned long key) {
 		return false;
 	}
 	HASH_DEL(ht->cell, tmp);
-	destroyHTCell(tmp, NULL); //TODO context null
+	destroyHTCell(ht, tmp, NULL); //TODO context null
 	return true;
 }
 
@@ -153,7 +168,7 @@ bool cuHTRemoveItemWithElement(CU_NOTNULL HT* ht, unsigned long key, destructor
 	}
 	HASH_DEL(ht->cell, tmp);
 	d(tmp->data, NULL); //TODO context null
-	destroyHTCell(tmp, NULL); //TODO context null
+	destroyHTCell(ht, tmp, NULL); //TODO context null
 	return true;
 }
 
@@ -255,13 +270,7 @@ CU_NOTNULL HT* cuHTLoadFromFile(CU_NOTNULL FILE* f, payload_functions functions)
 }
 
 void cuHTClear(CU_NOTNULL HT* ht) {
-	HTCell* s;
-		HTCell* tmp;
-
-	HASH_ITER(hh, ht->cell, s, tmp) {
-		HASH_DEL(ht->cell, s);
-		destroyHTCell(s, NULL); //TODO context null
-	}
+	destroyAllHTCells(ht);
 	ht->cell = NULL;
 }
 
@@ -272,7 +281,7 @@ void cuHTClearWithElements(CU_NOTNULL HT* ht, destructor d) {
 	HASH_ITER(hh, ht->cell, s, tmp) {
 		HASH_DEL(ht->cell, s);
 		d(s->data, NULL); //TODO context nulkl
-		destroyHTCell(s, NULL); //TODO context null
+		destroyHTCell(ht, s, NULL); //TODO context null
 	}
 	ht->cell = NULL;
 }
@@ -350,7 +359,7 @@ CU_NULLABLE HTCell* _cuHTCellGetNext(CU_NOTNULL const HTCell* cell) {
 }
 
 CU_NOTNULL HT* cuHTClone(CU_NOTNULL const HT* ht) {
-	HT* retVal = cuHTNew();
+	HT* retVal = cuHTNew(ht->functions, ht->allocator);
 	HTCell* cell;
 	HTCell* tmp;
 
@@ -362,7 +371,7 @@ CU_NOTNULL HT* cuHTClone(CU_NOTNULL const HT* ht) {
 }
 
 CU_NOTNULL HT* cuHTCloneWithElements(CU_NOTNULL const HT* ht) {
-	HT* retVal = cuHTNew();
+	HT* retVal = cuHTNew(ht->functions, ht->allocator);
 
 	HTCell* el;
 	HTCell* tmp;
@@ -379,15 +388,13 @@ CU_NOTNULL HT* cuHTCloneWithElements(CU_NOTNULL const HT* ht) {
  * \note
  * The data is added in the cell <b>by reference</b>
  *
+ * @param[in] ht the hashtable which will contain the cell
  * @param[in] e the data to put inside the cell
  * @param[in] f a function with one parameter <tt>void*</tt> returning the hash of the value, aka an int
  * @return a cell of an hash table. You still need to manually add it in the hash table though
  */
-static HTCell* newHTCell(const void* e, unsigned long key) {
-	HTCell* retVal = malloc(sizeof(HTCell));
-	if (retVal == NULL) {
-		ERROR_MALLOC();
-	}
+static HTCell* newHTCell(CU_NOTNULL HT* ht, const void* e, unsigned long key) {
+	HTCell* retVal = CU_ALLOCATOR_NEW(ht->allocator, HTCell);
 
 	retVal->id = key;
 	retVal->data = (void*) e;
@@ -401,8 +408,43 @@ static HTCell* newHTCell(const void* e, unsigned long key) {
  * \attention
  * the function <b>won't free the pointer</b> ::HTCell::data
  *
+ * @param[in] ht the hashtable which contained the cell
  * @param[in] htCell the cell to remove from the memory
  */
-static void destroyHTCell(CU_NOTNULL const HTCell* htCell, CU_NULLABLE const struct var_args* context) {
-	CU_FREE(htCell);
+static void destroyHTCell(CU_NOTNULL HT* ht, CU_NOTNULL const HTCell* htCell, CU_NULLABLE const struct var_args* context) {
+	CU_ALLOCATOR_FREE(ht->allocator, HTCell, htCell);
+}
+
+/**
+ * Remove all the cells from the hashtable, without touching their data
+ *
+ * If the allocator of the hashtable releases the memory in bulk, the cells are not even visited
+ *
+ * @param[inout] ht the hashtable to empty
+ */
+static void destroyAllHTCells(CU_NOTNULL HT* ht) {
+	if (cuAllocatorReleasesInBulk(ht->allocator)) {
+		HASH_CLEAR(hh, ht->cell);
+		return;
+	}
+
+	HTCell* s;
+	HTCell* tmp;
+	HASH_ITER(hh, ht->cell, s, tmp) {
+		HASH_DEL(ht->cell, s);
+		destroyHTCell(ht, s, NULL);
+	}
+}
+
+/**
+ * Double the buckets of the hash table until @c size entries don't make uthash expand the buckets by itself
+ *
+ * @param[inout] ht the hashtable involved. It needs to have at least one entry
+ * @param[in] size the number of entries the hash table should be able to hold
+ */
+static void expandBuckets(CU_NOTNULL HT* ht, int size) {
+	UT_hash_table* table = ht->cell->hh.tbl;
+	while ((table->num_buckets * HASH_BKT_CAPACITY_THRESH) < (unsigned) size) {
+		HASH_EXPAND_BUCKETS(table);
+	}
 }
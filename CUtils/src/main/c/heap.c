@@ -8,30 +8,30 @@
 #include "heap.h"
 #include "macros.h"
 #include <stdlib.h>
-#include <math.h>
+#include <string.h>
 #include "log.h"
 #include "defaultFunctions.h"
 #include "errors.h"
 
 /**
- * Represents the id to return if the given cell doesn't have the requested cell
- * (ie root can't have parent node or leaf node can't have right child).
+ * the number of cells allocated when the heap is created
  */
-#define H_NOID -1
+#define HEAP_INITIAL_CAPACITY 16
+
+/**
+ * the maximum depth of the tree explored by ::cuHeapContainsItem: an heap with at most INT_MAX elements has 31 levels
+ */
+#define HEAP_MAX_DEPTH 64
 
 struct heap {
 	/**
-	 * The maximum number of values that can be added in the heap
+	 * The maximum number of values that can be added in the heap. ::CU_HEAP_UNBOUNDED if there is no limit
 	 */
 	int maxSize;
 	/**
-	 * Represents the index fo the first leaf node in the heap.
-	 *
-	 * leaves are all at the end of the heap. So knowing the id of the first leaf
-	 * means you can detect whether a node is a leaf or not very quickly by simply comparing
-	 * its id with this variable
+	 * The number of cells allocated in ::heap::elements, excluding the cell 0
 	 */
-	int firstLeafNodeIndex;
+	int capacity;
 	/**
 	 * The number of elements inside this data structure
 	 */
@@ -40,47 +40,49 @@ struct heap {
 	 * A set of functions which are used to generally handle the payload
 	 */
 	payload_functions payloadFunctions;
-	/**
-	 * Represents the index of a cell in ::heap::elements that should be filled with a new value next
-	 */
-	int nextCellAvailable;
 	/**
 	 * An array of elements
 	 *
-	 * The array is ::heap::maxSize long
+	 * The array is ::heap::capacity + 1 long and its content starts from 1, not from 0:
+	 * if the root has index 1, every left child has id equal to 2*parentNode while
+	 * every right node has id equal to 2*parentNode + 1. Cells after ::heap::size are not initialized
 	 */
 	void** elements;
 };
 
-static bool isIndexRoot(const heap* h, int index);
-static bool isLeafNode(const heap* h, int index);
-static int getParentCell(const heap* h, int index);
-static int getNewNextCellAvailable(const heap* h);
-static int getLeftChild(const heap* h, int index);
-static int getRightChild(const heap* h, int index);
+static bool canContain(const heap* h, int size);
+static void ensureCapacity(heap* h, int size);
 static void percolateUp(heap* h, int index);
-static void percolateDown(heap* h, int parentIndex);
-static bool containsItemInHeapRecursive(CU_NOTNULL const heap* h, int currentId, const void* lookedFor);
+static void percolateDown(heap* h, int index);
+static void heapify(heap* h);
 
 heap* cuHeapNew(int maxSize, payload_functions functions) {
-	heap* retVal = malloc(sizeof(heap));
+	heap* retVal = CU_MALLOC(heap);
 	if (retVal == NULL) {
 		ERROR_MALLOC();
 	}
 
 	retVal->maxSize = maxSize;
-	retVal->firstLeafNodeIndex = pow(2, floor(log2(retVal->maxSize)));
+	retVal->capacity = 0;
 	retVal->size = 0;
 	retVal->payloadFunctions = functions;
-	retVal->nextCellAvailable = 1;
-	//for implementation convenience, this array content start from 1, not from 0.
-	//this because if the root has index 1, every left child has id equal to 2*parentNode while
-	//every right node has id equal to 2*parentNode + 1
-	retVal->elements = malloc(sizeof(void*) * (maxSize + 1));
-	if (retVal == NULL) {
-		ERROR_MALLOC();
+	retVal->elements = NULL;
+	ensureCapacity(retVal, (maxSize != CU_HEAP_UNBOUNDED && maxSize < HEAP_INITIAL_CAPACITY) ? maxSize : HEAP_INITIAL_CAPACITY);
+
+	return retVal;
+}
+
+heap* cuHeapNewFromArray(int maxSize, payload_functions functions, CU_NOTNULL void* const* items, int n) {
+	heap* retVal = cuHeapNew(maxSize, functions);
+	if (!canContain(retVal, n)) {
+		ERROR_OBJECT_IS_FULL("heap", maxSize);
 	}
 
+	ensureCapacity(retVal, n);
+	memcpy(&retVal->elements[1], items, sizeof(void*) * n);
+	retVal->size = n;
+	heapify(retVal);
+
 	return retVal;
 }
 
@@ -98,7 +100,6 @@ void cuHeapDestroyWithElements(CU_NOTNULL const heap* h, CU_NULLABLE const struc
 
 void cuHeapClear(CU_NOTNULL heap* h) {
 	h->size = 0;
-	h->nextCellAvailable = 1;
 }
 
 bool cuHeapInsertItem(CU_NOTNULL heap* h, CU_NULLABLE const void* item) {
@@ -106,14 +107,30 @@ bool cuHeapInsertItem(CU_NOTNULL heap* h, CU_NULLABLE const void* item) {
 		critical("Cannot add item %p inside heap %p because the heap is full", item, h);
 		return false;
 	}
-	//TODO adds a parameter which determine if we need to check the insertion of the heap
-	if (cuHeapContainsItem(h, item)) {
+	ensureCapacity(h, h->size + 1);
+	h->size++;
+	CU_SAFE_ASSIGN(h->elements[h->size], item);
+	percolateUp(h, h->size);
+	return true;
+}
+
+bool cuHeapInsertItems(CU_NOTNULL heap* h, CU_NOTNULL void* const* items, int k) {
+	if (!canContain(h, h->size + k)) {
+		critical("Cannot add %d items inside heap %p because the heap would be full", k, h);
 		return false;
 	}
-	CU_SAFE_ASSIGN(h->elements[h->nextCellAvailable], item);
-	h->nextCellAvailable = getNewNextCellAvailable(h);
-	h->size++;
-	percolateUp(h, h->nextCellAvailable - 1);
+	ensureCapacity(h, h->size + k);
+	memcpy(&h->elements[h->size + 1], items, sizeof(void*) * k);
+	if (k >= h->size) {
+		//rebuilding the heap costs O(size + k), which is at most O(2k): cheaper than percolating up every item
+		h->size += k;
+		heapify(h);
+	} else {
+		for (int i=0; i<k; i++) {
+			h->size++;
+			percolateUp(h, h->size);
+		}
+	}
 	return true;
 }
 
@@ -122,7 +139,7 @@ bool cuHeapIsEmpty(CU_NOTNULL const heap* h) {
 }
 
 bool cuHeapIsFull(CU_NOTNULL const heap* h) {
-	return h->size == h->maxSize;
+	return !canContain(h, h->size + 1);
 }
 
 void* cuHeapPeekMinItem(CU_NOTNULL const heap* h) {
@@ -135,11 +152,34 @@ void* cuHeapRemoveMinItem(CU_NOTNULL heap* h) {
 	}
 
 	void* retVal = h->elements[1];
-	SWAP(h->elements[1], h->elements[h->nextCellAvailable - 1], void*);
-	h->nextCellAvailable--;
+	void* last = h->elements[h->size];
 	h->size--;
-	//percolate down from the root
-	percolateDown(h, 1);
+	if (h->size == 0) {
+		return retVal;
+	}
+	//move the hole left by the root down to a leaf, always following the least child. Then fill it with the last element.
+	//The last element comes from the bottom of the heap, so it is very likely to stay there: this requires half the comparisons
+	//of percolating it down from the root
+	int index = 1;
+	int child;
+	while ((child = 2*index) <= h->size) {
+		if (child < h->size && h->payloadFunctions.order(h->elements[child + 1], h->elements[child]) < 0) {
+			child++;
+		}
+		h->elements[index] = h->elements[child];
+		index = child;
+	}
+	h->elements[index] = last;
+	percolateUp(h, index);
+	return retVal;
+}
+
+int cuHeapPopK(CU_NOTNULL heap* h, int k, CU_NOTNULL void** output) {
+	int retVal = 0;
+	while (retVal < k && !cuHeapIsEmpty(h)) {
+		output[retVal] = cuHeapRemoveMinItem(h);
+		retVal++;
+	}
 	return retVal;
 }
 
@@ -152,7 +192,32 @@ int cuHeapGetMaxSize(CU_NOTNULL const heap* h) {
 }
 
 bool cuHeapContainsItem(CU_NOTNULL const heap* h, const CU_NULLABLE void* item) {
-	return containsItemInHeapRecursive(h, 1, item);
+	//depth first visit of the heap. The stack contains at most a right child per level plus the left child being visited next
+	int stack[HEAP_MAX_DEPTH];
+	int top = 0;
+	if (h->size > 0) {
+		stack[top++] = 1;
+	}
+	while (top > 0) {
+		int current = stack[--top];
+		//FIXME here there should be a comparator to check if the value are the same, not an orderer. If you want, you should put an flag in the constructor telling if you want to use a comprator at all
+		int i = h->payloadFunctions.order(item, h->elements[current]);
+		if (i == 0) {
+			return true;
+		}
+		if (i < 0) {
+			//the element we're look for is smaller than the current node, then we won't bother searching in this subtree, since all the nodes
+			//there are bigger than the current node nethertheless.
+			continue;
+		}
+		if ((2*current + 1) <= h->size) {
+			stack[top++] = 2*current + 1;
+		}
+		if ((2*current) <= h->size) {
+			stack[top++] = 2*current;
+		}
+	}
+	return false;
 }
 
 void* _cuHeapGetNthItem(CU_NOTNULL const heap* h, int i) {
@@ -173,132 +238,63 @@ int cuHeapGetBufferString(CU_NOTNULL const heap* h, CU_NOTNULL char* buffer) {
 heap* cuHeapClone(CU_NOTNULL const heap* h) {
 	heap* retVal = cuHeapNew(h->maxSize, h->payloadFunctions);
 
-	CU_ITERATE_THROUGH_HEAP(h, payload, void*) {
-		cuHeapInsertItem(retVal, h->payloadFunctions.clone(payload));
+	//the clone has the same layout of the original heap, hence there is no need to restore the heap property
+	ensureCapacity(retVal, h->size);
+	for (int i=1; i<=h->size; i++) {
+		retVal->elements[i] = h->payloadFunctions.clone(h->elements[i]);
 	}
+	retVal->size = h->size;
 
 	return retVal;
 }
 
 void cuHeapMoveItems(CU_NOTNULL heap* restrict dst,CU_NOTNULL heap* restrict src) {
-	while (!cuHeapIsEmpty(src)) {
-		cuHeapInsertItem(dst, cuHeapRemoveMinItem(src));
-	}
-}
-
-static bool containsItemInHeapRecursive(CU_NOTNULL const heap* h, int currentId, const CU_NOTNULL void* lookedFor) {
-	//we have arrived to a cell in the heap that is not initialized yet. We have reached the end fo the heap for
-	//this path
-	if (currentId == H_NOID || currentId >= h->nextCellAvailable) {
-		return false;
-	}
-
-	finest("currentId set to %d. NextCellAvailable is %d", currentId, h->nextCellAvailable);
-	//FIXME here there should be a comparator to check if the value are the same, not an orderer. If you want, you should put an flag in the constructor telling if you want to use a comprator at all
-	int i = h->payloadFunctions.order(lookedFor, h->elements[currentId]);
-	if (i == 0) {
-		//we found our values
-		return true;
-	}
-
-	if (i < 0) {
-		//the element we're look for is smaller than the current node, then we won't bother searching in this subtree, since all the nodes
-		//there are bigger than the current node nethertheless.
-		return false;
-	}
-
-	if (i > 0) {
-		//ok, maybe in the subtree there is something
-		if (containsItemInHeapRecursive(h, getLeftChild(h, currentId), lookedFor)) {
-			return true;
-		}
-		if (containsItemInHeapRecursive(h, getRightChild(h, currentId), lookedFor)) {
-			return true;
-		}
-
-		return false;
+	if (!cuHeapInsertItems(dst, &src->elements[1], src->size)) {
+		ERROR_OBJECT_IS_FULL("heap", dst->maxSize);
 	}
-
-	ERROR_IMPOSSIBLE_SCENARIO("this shouldn't happen");
-	return false;
+	cuHeapClear(src);
 }
 
 /**
  * @param[in] h the heap analyzed
- * @param[in] index the index to handle
+ * @param[in] size a number of elements
  * @return
- * 	\li true if \c index represents the id of the root;
+ * 	\li true if \c h is allowed to contain \c size elements;
  * 	\li false otherwise
  */
-static bool isIndexRoot(const heap* h, int index) {
-	return index == 1;
+static bool canContain(const heap* h, int size) {
+	return h->maxSize == CU_HEAP_UNBOUNDED || size <= h->maxSize;
 }
 
 /**
- * @param[in] h the heap analyzed
- * @param[in] index the index to handle
- * @return
- * 	\li true if \c index lead to a leaf node;
- * 	\li false otherwise;
- */
-static bool isLeafNode(const heap* h, int index) {
-	return (index < h->maxSize) && (index >= h->firstLeafNodeIndex);
-}
-
-/**
- * Fetch the id of the parent node of a given node
+ * Enlarge ::heap::elements such that it can contain at least \c size elements
  *
- * @param[in] h the heap analyzed
- * @param[in] index the position of the cell considered
- * @return
- * 	\li the id of the parent node of the heap;
- * 	\li ::H_NOID if such node doesn't exist
- */
-static int getParentCell(const heap* h, int index) {
-	return isIndexRoot(h, index) ? H_NOID : index/2;
-}
-
-/**
- * Fetch the id of the left child node of a given node
+ * The capacity is at least doubled, hence adding items one by one takes amortized constant time
  *
- * @param[in] h the heap analyzed
- * @param[in] index the position of the cell considered
- * @return
- * 	\li the id of the left child node;
- * 	\li ::H_NOID if such node doesn't exist
+ * @param[inout] h the heap to alter
+ * @param[in] size the number of elements the heap needs to contain
  */
-static int getLeftChild(const heap* h, int index) {
-	if (isLeafNode(h, index)) {
-		return H_NOID;
-	}
-	if (h->size < 2*index) {
-		return H_NOID;
+static void ensureCapacity(heap* h, int size) {
+	if (size <= h->capacity && h->elements != NULL) {
+		return;
 	}
-	return 2*index;
-}
-
-/**
- * Fetch the id of the right child node of a given node
- *
- * @param[in] h the heap analyzed
- * @param[in] index the position of the cell considered
- * @return
- * 	\li the id of the right child node;
- * 	\li ::H_NOID if such node doesn't exist
- */
-static int getRightChild(const heap* h, int index) {
-	if (isLeafNode(h, index)) {
-		return H_NOID;
+	int capacity = 2 * h->capacity > size ? 2 * h->capacity : size;
+	if (h->maxSize != CU_HEAP_UNBOUNDED && capacity > h->maxSize) {
+		capacity = h->maxSize;
 	}
-	if (h->size < (2*index + 1)) {
-		return H_NOID;
+	h->elements = realloc(h->elements, sizeof(void*) * (capacity + 1));
+	if (h->elements == NULL) {
+		ERROR_MALLOC();
 	}
-	return (2*index + 1);
+	h->capacity = capacity;
 }
 
 /**
  * Perform heap percolate operation
  *
+ * The element is moved up until its parent is not greater than it. Instead of swapping it at every level, the parents are moved
+ * down and the element is written only once in its final position.
+ *
  * \note
  * After the operation, the heap is correctly repaired
  *
@@ -306,54 +302,52 @@ static int getRightChild(const heap* h, int index) {
  * @param[in] index the index when starting to percolate up
  */
 static void percolateUp(heap* h, int index) {
-	register int parentId = getParentCell(h, index);
-	if (parentId == H_NOID) {
-		return;
-	}
-	if (h->payloadFunctions.order(h->elements[index], h->elements[parentId]) < 0 ) {
-		//the child is less than the parent. We need to swap
-		SWAP(h->elements[index], h->elements[parentId], void*);
+	void* item = h->elements[index];
+	while (index > 1) {
+		int parent = index / 2;
+		if (h->payloadFunctions.order(item, h->elements[parent]) >= 0) {
+			break;
+		}
+		h->elements[index] = h->elements[parent];
+		index = parent;
 	}
-	percolateUp(h, parentId);
+	h->elements[index] = item;
 }
 
-static void percolateDown(heap* h, int parentIndex) {
-	if (isLeafNode(h, parentIndex)) {
-		return;
-	}
-
-	register int lc = getLeftChild(h, parentIndex);
-	register int rc = getRightChild(h, parentIndex);
-	register int small = 0;
-
-	if (rc == H_NOID) {
-		if (lc == H_NOID) {
-			//both left and right children don't exist. We do nothing
-			return;
+/**
+ * Perform heap percolate down operation
+ *
+ * The element is moved down until none of its children is less than it
+ *
+ * @param[in] h the heap to repair
+ * @param[in] index the index when starting to percolate down
+ */
+static void percolateDown(heap* h, int index) {
+	void* item = h->elements[index];
+	int child;
+	while ((child = 2*index) <= h->size) {
+		if (child < h->size && h->payloadFunctions.order(h->elements[child + 1], h->elements[child]) < 0) {
+			child++;
 		}
-		//right child doesn't exist, but left does. We swap parent with the left child
-		small = lc;
-		finer("parent %d(%p) lc[small] = %d(%p) size = %d", parentIndex, h->elements[parentIndex], lc, h->elements[lc], h->size);
-	} else {
-		//both children exist. We need to determin which one we need to swap with.
-		info("parent %d(%p) lc = %d(%p) rc = %d(%p) size = %d", parentIndex, h->elements[parentIndex], lc, h->elements[lc], rc, h->elements[rc], h->size);
-		if (h->payloadFunctions.order(h->elements[lc], h->elements[rc]) < 0) {
-			//left is less than right
-			small = lc;
-		} else {
-			//right is less than left
-			small = rc;
+		if (h->payloadFunctions.order(item, h->elements[child]) <= 0) {
+			break;
 		}
+		h->elements[index] = h->elements[child];
+		index = child;
 	}
-	if (h->payloadFunctions.order(h->elements[parentIndex], h->elements[small]) < 0) {
-		return;
-	}
-	SWAP(h->elements[small], h->elements[parentIndex], void*);
-	percolateDown(h, small);
+	h->elements[index] = item;
 }
 
-static int getNewNextCellAvailable(const heap* h) {
-	return h->nextCellAvailable + 1;
+/**
+ * Restore the heap property over the whole array (Floyd's algorithm)
+ *
+ * Each internal node is percolated down, starting from the last one. This takes \f$ O(n) \f$ time since most nodes are
+ * near the leaves
+ *
+ * @param[inout] h the heap to repair
+ */
+static void heapify(heap* h) {
+	for (int i=h->size/2; i>0; i--) {
+		percolateDown(h, i);
+	}
 }
-
-
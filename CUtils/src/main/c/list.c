@@ -16,6 +16,7 @@
 #include "random_utils.h"
 #include "defaultFunctions.h"
 #include "errors.h"
+#include "allocator.h"
 
 struct list_cell {
 	///represents the paylaod inside this cell of the list
@@ -35,11 +36,53 @@ struct list {
 	 * A set of functions used to easily manupilate each content of each cell
 	 */
 	payload_functions payloadFunctions;
+	///where the cells of the list are allocated. NULL means malloc
+	cu_allocator* allocator;
 };
 
-static list_cell* newListCell(const void* p, const list_cell* next);
+/**
+ * lists shorter than this are sorted by a single thread in ::cuListParallelSort
+ */
+#define LIST_PARALLEL_SORT_THRESHOLD 10000
+/**
+ * number of bins used by ::mergeSortCells. The last bin can hold any number of cells, so there is no limit on the size of the list
+ */
+#define LIST_SORT_BINS 64
+
+/**
+ * A sorted sublist
+ */
+struct list_sort_run {
+	///first cell of the sublist
+	list_cell* head;
+	///last cell of the sublist. Its next is NULL
+	list_cell* tail;
+};
 
-list* cuListNew(payload_functions payloadFunctions) {
+/**
+ * The state shared by the tasks of ::cuListParallelSort
+ */
+struct list_sort_job {
+	///the sublists to sort
+	struct list_sort_run* runs;
+	///number of elements in ::list_sort_job::runs
+	int runsNumber;
+	///the order of the list
+	orderer order;
+	///in the merge phase, the distance between 2 runs to merge. 0 in the sort phase
+	int step;
+	///the sublists to sort or the pairs of sublists to merge in the current phase
+	cu_parallel_for loop;
+};
+
+static list_cell* newListCell(CU_NOTNULL list* l, const void* p, const list_cell* next);
+static list_cell* mergeSortCells(CU_NOTNULL list_cell* head, orderer order, CU_NOTNULL list_cell** tail);
+static list_cell* mergeCells(CU_NULLABLE list_cell* a, CU_NULLABLE list_cell* b, orderer order, CU_NULLABLE list_cell** tail);
+static unsigned long nextRandom(CU_NOTNULL unsigned long* state);
+static enum thread_loop_state sortRunTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va);
+static enum thread_loop_state mergeRunsTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va);
+
+list* cuListNew(payload_functions payloadFunctions, CU_NULLABLE cu_allocator* allocator) {
 	list* retVal = malloc(sizeof(list));
 	if (retVal == NULL) {
 		ERROR_MALLOC();
@@ -49,16 +92,20 @@ list* cuListNew(payload_functions payloadFunctions) {
 	retVal->size = 0;
 	retVal->tail = NULL;
 	retVal->payloadFunctions = payloadFunctions;
+	retVal->allocator = allocator;
 
 	return retVal;
 }
 CU_DEFINE_DEFAULT_VALUES(cuListNew,
-		cuPayloadFunctionsDefault()
+		cuPayloadFunctionsDefault(),
+		NULL
 );
 
 void cuListDestroy(CU_NOTNULL const list* lst, CU_NULLABLE const struct var_args* context) {
-	CU_ITERATE_OVER_LIST(lst, cell, value, void*) {
-		free(cell);
+	if (!cuAllocatorReleasesInBulk(lst->allocator)) {
+		CU_ITERATE_OVER_LIST(lst, cell, value, void*) {
+			CU_ALLOCATOR_FREE(lst->allocator, list_cell, cell);
+		}
 	}
 	free((void*)lst);
 }
@@ -66,17 +113,26 @@ void cuListDestroy(CU_NOTNULL const list* lst, CU_NULLABLE const struct var_args
 void cuListDestroyWithElement(CU_NOTNULL const list* _lst, CU_NULLABLE const struct var_args* context) {
 	list* lst = (list*) _lst;
 
-	CU_ITERATE_OVER_LIST(lst, cell, value, void*) {
-		debug("deleting payload!!!!");
-		_lst->payloadFunctions.destroy(cell->payload, context);
-		free(cell);
+	if (!cuAllocatorReleasesInBulk(lst->allocator)) {
+		CU_ITERATE_OVER_LIST(lst, cell, value, void*) {
+			debug("deleting payload!!!!");
+			_lst->payloadFunctions.destroy(cell->payload, context);
+			CU_ALLOCATOR_FREE(lst->allocator, list_cell, cell);
+		}
+	} else if (lst->payloadFunctions.destroy != cuDefaultFunctionDestructorNOP) {
+		//the cells go away with the allocator: we only need to destroy the payloads
+		CU_ITERATE_OVER_LIST(lst, cell, value, void*) {
+			_lst->payloadFunctions.destroy(value, context);
+		}
 	}
 	CU_FREE(lst);
 }
 
 void cuListClear(CU_NOTNULL list* l) {
-	CU_ITERATE_OVER_LIST(l, cell, value, void*) {
-		free(cell);
+	if (!cuAllocatorReleasesInBulk(l->allocator)) {
+		CU_ITERATE_OVER_LIST(l, cell, value, void*) {
+			CU_ALLOCATOR_FREE(l->allocator, list_cell, cell);
+		}
 	}
 	l->head = NULL;
 	l->size = 0;
@@ -84,9 +140,15 @@ void cuListClear(CU_NOTNULL list* l) {
 }
 
 void cuListClearWithElements(CU_NOTNULL list* l) {
-	CU_ITERATE_OVER_LIST(l, cell, value, void*) {
-		l->payloadFunctions.destroy(cell->payload, NULL);
-		free(cell);
+	if (!cuAllocatorReleasesInBulk(l->allocator)) {
+		CU_ITERATE_OVER_LIST(l, cell, value, void*) {
+			l->payloadFunctions.destroy(cell->payload, NULL);
+			CU_ALLOCATOR_FREE(l->allocator, list_cell, cell);
+		}
+	} else if (l->payloadFunctions.destroy != cuDefaultFunctionDestructorNOP) {
+		CU_ITERATE_OVER_LIST(l, cell, value, void*) {
+			l->payloadFunctions.destroy(value, NULL);
+		}
 	}
 
 	l->head = NULL;
@@ -95,7 +157,7 @@ void cuListClearWithElements(CU_NOTNULL list* l) {
 }
 
 list* cuListCloneWithElements(CU_NOTNULL const list* l) {
-	list* retVal = cuListNew();
+	list* retVal = cuListNew(l->payloadFunctions, l->allocator);
 	CU_ITERATE_OVER_LIST(l, cell, payload, void*) {
 		cuListAddTail(retVal, l->payloadFunctions.clone(payload));
 	}
@@ -103,7 +165,7 @@ list* cuListCloneWithElements(CU_NOTNULL const list* l) {
 }
 
 list* cuListClone(CU_NOTNULL const list* l) {
-	list* retVal = cuListNew();
+	list* retVal = cuListNew(l->payloadFunctions, l->allocator);
 	CU_ITERATE_OVER_LIST(l, cell, payload, void*) {
 		cuListAddTail(retVal, payload);
 	}
@@ -111,10 +173,7 @@ list* cuListClone(CU_NOTNULL const list* l) {
 }
 
 void cuListAddHead(CU_NOTNULL list* l, CU_NULLABLE const void* el) {
-	list_cell* new_cell = malloc(sizeof(list_cell));
-	if (new_cell == NULL) {
-		ERROR_MALLOC();
-	}
+	list_cell* new_cell = CU_ALLOCATOR_NEW(l->allocator, list_cell);
 
 	new_cell->payload = (void*) el;
 	new_cell->next = l->head;
@@ -127,10 +186,7 @@ void cuListAddHead(CU_NOTNULL list* l, CU_NULLABLE const void* el) {
 }
 
 void cuListAddTail(CU_NOTNULL list* l, CU_NULLABLE const void* el) {
-	list_cell* new_cell = malloc(sizeof(list_cell));
-	if (new_cell == NULL) {
-		ERROR_MALLOC();
-	}
+	list_cell* new_cell = CU_ALLOCATOR_NEW(l->allocator, list_cell);
 
 	new_cell->payload = (void*)el;
 	new_cell->next = NULL;
@@ -151,6 +207,15 @@ int cuListGetSize(const list* l) {
 }
 
 void cuListMoveContent(CU_NOTNULL list* restrict dst, CU_NOTNULL list* restrict src) {
+	if (dst->allocator != src->allocator) {
+		//the cells of src can't be owned by dst, so we need to copy them
+		CU_ITERATE_OVER_LIST(src, cell, payload, void*) {
+			cuListAddTail(dst, payload);
+		}
+		cuListClear(src);
+		return;
+	}
+
 	//*********** DST **********
 	dst->size += cuListGetSize(src);
 	if (dst->head == NULL) {
@@ -190,7 +255,7 @@ void* cuListPopFrom(CU_NOTNULL list* l) {
 		l->tail = NULL;
 	}
 
-	free(cell);
+	CU_ALLOCATOR_FREE(l->allocator, list_cell, cell);
 	return retVal;
 }
 
@@ -222,7 +287,7 @@ void* cuListGetTail0(CU_NOTNULL const list* l) {
 list_cell* cuListAddItemAfter(CU_NOTNULL list* l, CU_NOTNULL list_cell* cell, CU_NULLABLE const void* item) {
 	CU_ITERATE_OVER_LIST(l, acell, v, void*) {
 		if (acell == cell) {
-			list_cell* retVal = newListCell(item, acell->next);
+			list_cell* retVal = newListCell(l, item, acell->next);
 			acell->next = retVal;
 			l->size += 1;
 
@@ -252,7 +317,7 @@ void cuListAddItemAt(CU_NOTNULL list* l, int index, CU_NULLABLE const void* item
 				cuListAddTail(l, item);
 			} else {
 				//add in the middle
-				list_cell* newCell = newListCell(item, NULL);
+				list_cell* newCell = newListCell(l, item, NULL);
 				prevCell->next = newCell;
 				newCell->next = cell;
 				l->size += 1;
@@ -451,60 +516,105 @@ void cuListRemoveItemInListCell(CU_NOTNULL list* l, CU_NOTNULL list_cell** restr
 		previous->next = NULL;
 		lst->size--;
 		lst->tail = previous;
-		free(cellToRemove);
+		CU_ALLOCATOR_FREE(lst->allocator, list_cell, cellToRemove);
 	} else {
 		debug("removing middle element %p %p", previous, cellToRemove);
 		debug("nexts are %p %p", previous->next, cellToRemove->next);
 		//we're removing an element inside the list
 		previous->next = cellToRemove->next;
 		lst->size--;
-		free(cellToRemove);
+		CU_ALLOCATOR_FREE(lst->allocator, list_cell, cellToRemove);
 	}
 
 	*previousCell = NULL;
 }
 
 void cuListScramble(CU_NOTNULL list* l) {
-	//to scramble the list, we apply a bubble sort on the list with a random comparator
-	list_cell* cell2;
-	CU_ITERATE_OVER_LIST(l, cell1, payload1, void*) {
-		if (cell1->next == NULL) {
-			return;
-		}
-		cell2 = cell1->next;
+	cuListScrambleWithSeed(l, (((unsigned long)rand()) << 31) ^ ((unsigned long)rand()));
+}
 
-		while (cell2 != NULL) {
-			if ((rand() % 2) == 0) {
-				SWAP(cell1->payload, cell2->payload, void*);
-			}
-			cell2 = cell2->next;
-		}
+void cuListScrambleWithSeed(CU_NOTNULL list* l, unsigned long seed) {
+	if (l->size < 2) {
+		return;
+	}
+
+	list_cell** cells = malloc(sizeof(list_cell*) * l->size);
+	if (cells == NULL) {
+		ERROR_MALLOC();
 	}
+	int i = 0;
+	for (list_cell* cell = l->head; cell != NULL; cell = cell->next) {
+		cells[i++] = cell;
+	}
+
+	//Fisher-Yates
+	unsigned long state = seed;
+	for (i = l->size - 1; i > 0; i--) {
+		int j = (int)(nextRandom(&state) % (unsigned long)(i + 1));
+		SWAP(cells[i], cells[j], list_cell*);
+	}
+
+	for (i = 0; i < l->size - 1; i++) {
+		cells[i]->next = cells[i + 1];
+	}
+	cells[l->size - 1]->next = NULL;
+	l->head = cells[0];
+	l->tail = cells[l->size - 1];
+
+	free(cells);
 }
 
 void cuListSort(CU_NOTNULL list* l, orderer order) {
-	if (cuListGetSize(l) < 2) {
+	if (l->size < 2) {
 		return;
 	}
 
-	list_cell* cell1 = l->head;
-	list_cell* cell2 = NULL;;
+	l->head = mergeSortCells(l->head, order, &l->tail);
+}
 
-	while (cell1 != NULL) {
-		if (cell1->next == NULL) {
-			return;
-		}
-		cell2 = cell1->next;
+void cuListParallelSort(CU_NOTNULL list* l, orderer order, CU_NOTNULL cu_parallel_thread_pool* pool) {
+	int runsNumber = cuParallelThreadPoolGetThreadsNumber(pool);
+	if (l->size < LIST_PARALLEL_SORT_THRESHOLD || runsNumber < 2) {
+		cuListSort(l, order);
+		return;
+	}
 
-		while (cell2 != NULL) {
-			if (order(cell1->payload, cell2->payload) > 0) {
-				SWAP(cell1->payload, cell2->payload, void*);
-			}
-			cell2 = cell2->next;
+	struct list_sort_job job;
+	job.runs = malloc(sizeof(struct list_sort_run) * runsNumber);
+	if (job.runs == NULL) {
+		ERROR_MALLOC();
+	}
+	job.runsNumber = runsNumber;
+	job.order = order;
+
+	//split the list in sublists of about the same size
+	list_cell* cell = l->head;
+	for (int i=0; i<runsNumber; i++) {
+		int size = l->size / runsNumber + (i < (l->size % runsNumber) ? 1 : 0);
+		job.runs[i].head = cell;
+		for (int j=1; j<size; j++) {
+			cell = cell->next;
 		}
+		job.runs[i].tail = cell;
+		cell = cell->next;
+		job.runs[i].tail->next = NULL;
+	}
 
-		cell1 = cell1->next;
+	struct list_sort_job* jobPtr = &job;
+	cuInitVarArgsOnStack(va, jobPtr);
+
+	job.step = 0;
+	cuParallelThreadPoolFor(pool, sortRunTask, va, &job.loop, runsNumber);
+
+	//merge run i with run i+step, for increasing steps
+	for (job.step = 1; job.step < runsNumber; job.step *= 2) {
+		cuParallelThreadPoolFor(pool, mergeRunsTask, va, &job.loop, (runsNumber + 2 * job.step - 1) / (2 * job.step));
 	}
+
+	l->head = job.runs[0].head;
+	l->tail = job.runs[0].tail;
+
+	free(job.runs);
 }
 
 void* cuListPickRandomItem(CU_NOTNULL const list* l) {
@@ -566,14 +676,140 @@ list_cell* _cuListGetHeadCell(CU_NOTNULL const list* l) {
 }
 
 
-static list_cell* newListCell(const void* p, const list_cell* next) {
-	list_cell* retVal = malloc(sizeof(list_cell));
-	if (retVal == NULL) {
-		ERROR_MALLOC();
-	}
+static list_cell* newListCell(CU_NOTNULL list* l, const void* p, const list_cell* next) {
+	list_cell* retVal = CU_ALLOCATOR_NEW(l->allocator, list_cell);
 
 	retVal->payload = (void*) p;
 	retVal->next = (struct list_cell*) next;
 
 	return retVal;
 }
+
+/**
+ * Sort a chain of cells with a merge sort
+ *
+ * The cells are taken one by one from the chain. ::LIST_SORT_BINS holds sorted chains: the chain in bin @c k, if any,
+ * has \f$ 2^k \f$ cells. Each new cell is merged with the chain in bin 0, the result with the chain in bin 1 and so on,
+ * until an empty bin is found, just like a carry propagating in a binary counter. Compared to merging runs of doubling
+ * width over the whole chain, the cells merged are the ones visited last, which are likely still in cache.
+ *
+ * @param[in] head the first cell of the chain. The chain ends with the cell whose next is NULL
+ * @param[in] order the order of the cells
+ * @param[out] tail the last cell of the sorted chain
+ * @return the first cell of the sorted chain
+ */
+static list_cell* mergeSortCells(CU_NOTNULL list_cell* head, orderer order, CU_NOTNULL list_cell** tail) {
+	list_cell* bins[LIST_SORT_BINS] = {NULL};
+	int binsUsed = 0;
+
+	while (head != NULL) {
+		list_cell* carry = head;
+		head = head->next;
+		carry->next = NULL;
+
+		int k = 0;
+		//the chains in the bins contain cells before the carry, so they go first to keep the sort stable
+		while (k < binsUsed && bins[k] != NULL) {
+			carry = mergeCells(bins[k], carry, order, NULL);
+			bins[k] = NULL;
+			k++;
+		}
+		if (k == LIST_SORT_BINS) {
+			k--;
+		}
+		bins[k] = carry;
+		if (k == binsUsed) {
+			binsUsed++;
+		}
+	}
+
+	//higher bins contain earlier cells
+	list_cell* result = NULL;
+	for (int k=0; k<binsUsed; k++) {
+		result = mergeCells(bins[k], result, order, NULL);
+	}
+
+	list_cell* last = result;
+	while (last->next != NULL) {
+		last = last->next;
+	}
+	*tail = last;
+	return result;
+}
+
+/**
+ * Merge 2 sorted chains of cells
+ *
+ * @param[in] a the first chain. Can be NULL
+ * @param[in] b the second chain. Can be NULL. On ties, cells of @c a come first
+ * @param[in] order the order of the cells
+ * @param[out] tail if not NULL, the last cell of the merged chain. Untouched if both chains are empty
+ * @return the first cell of the merged chain
+ */
+static list_cell* mergeCells(CU_NULLABLE list_cell* a, CU_NULLABLE list_cell* b, orderer order, CU_NULLABLE list_cell** tail) {
+	list_cell head;
+	list_cell* last = &head;
+	while (a != NULL && b != NULL) {
+		if (order(a->payload, b->payload) <= 0) {
+			last->next = a;
+			a = a->next;
+		} else {
+			last->next = b;
+			b = b->next;
+		}
+		last = last->next;
+	}
+	last->next = (a != NULL) ? a : b;
+	if (tail != NULL) {
+		while (last->next != NULL) {
+			last = last->next;
+		}
+		if (last != &head) {
+			*tail = last;
+		}
+	}
+	return head.next;
+}
+
+/**
+ * A splitmix64 generator
+ *
+ * @param[inout] state the state of the generator
+ * @return the next pseudo random number
+ */
+static unsigned long nextRandom(CU_NOTNULL unsigned long* state) {
+	unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return (unsigned long)(z ^ (z >> 31));
+}
+
+/**
+ * Sort the sublists of a ::list_sort_job
+ */
+static enum thread_loop_state sortRunTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va) {
+	struct list_sort_job* job = cuVarArgsGetItem(va, 0, struct list_sort_job*);
+	unsigned int i;
+	while (cuParallelForGetNextChunk(&job->loop, &i)) {
+		struct list_sort_run* run = &job->runs[i];
+		run->head = mergeSortCells(run->head, job->order, &run->tail);
+	}
+	return TLS_STOP;
+}
+
+/**
+ * Merge the pairs of sublists of a ::list_sort_job
+ */
+static enum thread_loop_state mergeRunsTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va) {
+	struct list_sort_job* job = cuVarArgsGetItem(va, 0, struct list_sort_job*);
+	unsigned int pair;
+	while (cuParallelForGetNextChunk(&job->loop, &pair)) {
+		int i = pair * 2 * job->step;
+		if ((i + job->step) < job->runsNumber) {
+			struct list_sort_run* a = &job->runs[i];
+			struct list_sort_run* b = &job->runs[i + job->step];
+			a->head = mergeCells(a->head, b->head, job->order, &a->tail);
+		}
+	}
+	return TLS_STOP;
+}
@@ -7,15 +7,16 @@
 
 #include "log.h"
 #include "macros.h"
-#include "string_utils.h"
-#include "path_utils.h"
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdbool.h>
 #include <string.h>
-#include <libgen.h>
 #include <stdlib.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
 #include "errors.h"
+#include "flat_hashtable.h"
 
 const char* LOGLEVEL_TO_STRING[LOG_LEVEL_SIZE] = {
 		"ALL",
@@ -30,153 +31,445 @@ const char* LOGLEVEL_TO_STRING[LOG_LEVEL_SIZE] = {
 		"NOLOG"
 };
 
-typedef struct Names {
+/**
+ * the maximum length of the file and function names stored in a ::log_record
+ */
+#define LOG_RECORD_NAME_SIZE 64
+/**
+ * the maximum length of a message logged asynchronously. Longer messages are truncated
+ */
+#define LOG_RECORD_MESSAGE_SIZE 1024
+
+/**
+ * A log entry waiting to be written by the background thread
+ */
+struct log_record {
+	LogLevel level;
+	int lineNo;
+	char fileName[LOG_RECORD_NAME_SIZE];
+	char functionName[LOG_RECORD_NAME_SIZE];
+	char message[LOG_RECORD_MESSAGE_SIZE];
+};
+
+/**
+ * A cell of the ring buffer used by the asynchronous logging
+ *
+ * The ring is a bounded multi-producer queue: a cell can be written by the producer which has reserved position @c p
+ * when its sequence is @c p and can be read by the background thread when its sequence is @c p+1
+ */
+struct log_ring_cell {
+	volatile size_t sequence;
+	struct log_record record;
+};
+
+/**
+ * An appender calling an ::appenderFunction
+ */
+struct function_appender {
+	log_appender appender;
+	appenderFunction function;
+};
+
+/**
+ * An appender writing on a file
+ */
+struct file_appender {
+	log_appender appender;
+	///serializes the writes and the rotations, since several threads may log at the same time
+	pthread_mutex_t mutex;
+	FILE* file;
+	char* path;
+	size_t size;
+	size_t maxBytes;
+	int maxFiles;
+};
+
+/**
+ * An appender keeping the last entries in memory
+ */
+struct memory_appender {
+	log_appender appender;
+	pthread_mutex_t mutex;
+	///circular array of entries
+	char** entries;
+	int capacity;
+	///number of entries in ::memory_appender::entries
+	int size;
+	///index of the oldest entry
+	int first;
+};
+
+/**
+ * A logger excluded via ::excludeLogger
+ */
+struct excluded_logger {
 	char* name;
-	//the hash of the name
-	unsigned long hashName;
-	struct Names* next;
-} Names;
+	///next excluded logger whose name has the same hash
+	struct excluded_logger* nextSameHash;
+};
 
 /**
  * The level our log is operating on
  */
 static LogLevel logLevel = LOG_ALL;
 /**
- * List of loggers (aka files) that we won't track
+ * Loggers (aka files) that we won't track, indexed by the hash of their name. Each value is a list of ::excluded_logger.
+ * NULL if no logger has ever been excluded
  */
-static Names* excludedLoggers = NULL;
+static flat_ht* excludedLoggers = NULL;
 /**
  * The default buffer used by log module to emit logs into  log destination
  */
-char __default_log_buffer[LOG_BUFFER_SIZE];
+__thread char __default_log_buffer[LOG_BUFFER_SIZE];
 
-static void logToStdOut(const char* fileName, const char* functionName, const int lineNo, const LogLevel level, const char* message);
-static void logToDevNull(const char* fileName, const char* functionName, const int lineNo, const LogLevel level, const char* message);
-static void addHeadInNames(Names** names, const char* name);
-static void removeFromNames(Names** names, const char* name);
-static void removeAllNames(Names** names);
-static bool isExcluded(Names** names, const char* name);
+static void appendToStdOut(log_appender* appender, const char* fileName, const char* functionName, int lineNo, LogLevel level, const char* message);
+static void flushStdOut(log_appender* appender);
+static void destroyHeapAppender(log_appender* appender);
+static void appendToFunction(log_appender* appender, const char* fileName, const char* functionName, int lineNo, LogLevel level, const char* message);
+static void appendToFile(log_appender* appender, const char* fileName, const char* functionName, int lineNo, LogLevel level, const char* message);
+static void flushFile(log_appender* appender);
+static void destroyFileAppender(log_appender* appender);
+static void rotateFile(struct file_appender* appender);
+static void appendToMemory(log_appender* appender, const char* fileName, const char* functionName, int lineNo, LogLevel level, const char* message);
+static void destroyMemoryAppender(log_appender* appender);
+static void dispatch(const char* fileName, const char* functionName, int lineNo, LogLevel level, const char* message);
+static void flushAppenders();
+static const char* getBaseName(const char* path);
+static bool isExcluded(const char* name);
 static unsigned long hashDjb2(const char *str);
+static void pushRecord(LogLevel level, const char* fileName, const char* functionName, int lineNo, const char* message);
+static bool popRecord(struct log_record* record);
+static void* writeRecords(void* arg);
+static void copyName(char* destination, const char* source);
 
 /**
- * A function we will use to log the message to the physical storage (either a database, the network or a file)
+ * The appender writing on the standard output registered at startup
  */
-static appenderFunction appenders = &logToStdOut;
+static log_appender stdOutAppender = {appendToStdOut, flushStdOut, NULL};
 
+/**
+ * The destinations of the logs
+ */
+static log_appender* appenders[LOG_MAX_APPENDERS] = {&stdOutAppender};
+static int appendersNumber = 1;
 
+/**
+ * The state of the asynchronous logging
+ */
+static struct {
+	///true if the logs are written by ::async::writer
+	bool enabled;
+	///true if the writer needs to terminate once the ring is empty
+	volatile bool stop;
+	///true if atexit has already been called
+	bool exitHandlerRegistered;
+	pthread_t writer;
+	///the ring buffer. Its size is ::async::mask + 1
+	struct log_ring_cell* ring;
+	size_t mask;
+	///the next position a producer will reserve. Updated atomically
+	size_t enqueuePosition;
+	///the next position the writer will read. Touched only by the writer
+	size_t dequeuePosition;
+	///all the entries before this position have been written and flushed
+	volatile size_t flushedPosition;
+	///number of threads which may be pushing an entry in the ring. Updated atomically
+	size_t producers;
+} async = {false, false, false};
 
 void setLevel(LogLevel level) {
 	logLevel = level;
 }
 
-/**
- * Avoid to print everything coming from a particular logger
- *
- * @param[in] logger the logger that from this time until ::includeLogger call won't be tracked down at all
- */
 void excludeLogger(const char* logger) {
-	addHeadInNames(&excludedLoggers, logger);
+	if (isExcluded(logger)) {
+		return;
+	}
+	if (excludedLoggers == NULL) {
+		excludedLoggers = cuFlatHTNew();
+	}
+	unsigned long hash = hashDjb2(logger);
+	struct excluded_logger* excluded = CU_MALLOC(struct excluded_logger);
+	if (excluded == NULL) {
+		ERROR_MALLOC();
+	}
+	excluded->name = strdup(logger);
+	if (excluded->name == NULL) {
+		ERROR_MALLOC();
+	}
+	excluded->nextSameHash = cuFlatHTGetItem(excludedLoggers, hash);
+	cuFlatHTAddOrUpdateItem(excludedLoggers, hash, excluded);
 }
 
-/**
- * Include in the logging the logs coming from this logger
- *
- * @param[in] logger the logger to include in the log output
- */
 void includeLogger(const char* logger) {
-	removeFromNames(&excludedLoggers, logger);
+	if (excludedLoggers == NULL) {
+		return;
+	}
+	unsigned long hash = hashDjb2(logger);
+	struct excluded_logger* previous = NULL;
+	for (struct excluded_logger* excluded = cuFlatHTGetItem(excludedLoggers, hash); excluded != NULL; excluded = excluded->nextSameHash) {
+		if (strcmp(excluded->name, logger) != 0) {
+			previous = excluded;
+			continue;
+		}
+		if (previous != NULL) {
+			previous->nextSameHash = excluded->nextSameHash;
+		} else if (excluded->nextSameHash != NULL) {
+			cuFlatHTUpdateItem(excludedLoggers, hash, excluded->nextSameHash);
+		} else {
+			cuFlatHTRemoveItem(excludedLoggers, hash);
+		}
+		CU_FREE(excluded->name);
+		CU_FREE(excluded);
+		return;
+	}
 }
 
 void clearExcludedLoggers() {
-	removeAllNames(&excludedLoggers);
+	if (excludedLoggers == NULL) {
+		return;
+	}
+	for (struct excluded_logger* excluded = cuFlatHTGetFirstItem(excludedLoggers); excluded != NULL; excluded = cuFlatHTGetFirstItem(excludedLoggers)) {
+		includeLogger(excluded->name);
+	}
 }
 
 void clearAppenders() {
-	appenders = &logToDevNull;
+	flushLogs();
+	for (int i=0; i<appendersNumber; i++) {
+		cuLogAppenderDestroy(appenders[i], NULL);
+	}
+	appendersNumber = 0;
 }
 
-void __generic_log_function(const LogLevel level, const char* absoluteFilePath, const char* functionName, const int lineNo, int logBufferSize, char* logBuffer, const char* format, ...) {
-	if (level < logLevel) {
-		return;
+void addAppender(appenderFunction appender) {
+	struct function_appender* result = CU_MALLOC(struct function_appender);
+	if (result == NULL) {
+		ERROR_MALLOC();
 	}
-	static char _baseNameBuffer[BUFFER_SIZE];
-	char* fileName = cu_computeFileBaseName(absoluteFilePath, _baseNameBuffer);
-	if (isExcluded(&excludedLoggers, fileName)) {
-		return;
+	result->appender.append = appendToFunction;
+	result->appender.flush = NULL;
+	result->appender.destroy = destroyHeapAppender;
+	result->function = appender;
+	addLogAppender(&result->appender);
+}
+
+void addLogAppender(CU_NOTNULL log_appender* appender) {
+	if (appendersNumber == LOG_MAX_APPENDERS) {
+		ERROR_OBJECT_IS_FULL("appenders", appendersNumber);
 	}
-	va_list argList;
-	va_start(argList, format);
-	vsnprintf(logBuffer, logBufferSize, format, argList);
-	va_end(argList);
-	appenders(fileName, functionName, lineNo, level, logBuffer);
+	flushLogs();
+	appenders[appendersNumber++] = appender;
+}
 
+log_appender* cuLogAppenderStdOutNew() {
+	log_appender* result = CU_MALLOC(log_appender);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+	result->append = appendToStdOut;
+	result->flush = flushStdOut;
+	result->destroy = destroyHeapAppender;
+	return result;
 }
 
+log_appender* cuLogAppenderFileNew(CU_NOTNULL const char* path, size_t maxBytes, int maxFiles) {
+	struct file_appender* result = CU_MALLOC(struct file_appender);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+	result->appender.append = appendToFile;
+	result->appender.flush = flushFile;
+	result->appender.destroy = destroyFileAppender;
+	pthread_mutex_init(&result->mutex, NULL);
+	result->path = strdup(path);
+	if (result->path == NULL) {
+		ERROR_MALLOC();
+	}
+	result->file = fopen(path, "a");
+	if (result->file == NULL) {
+		ERROR_FILE(path);
+	}
+	fseek(result->file, 0, SEEK_END);
+	result->size = ftell(result->file);
+	result->maxBytes = maxBytes;
+	result->maxFiles = maxFiles;
+	return &result->appender;
+}
 
-static void addHeadInNames(Names** names, const char* name) {
-	Names* retVal = malloc(sizeof(Names));
-	if (retVal == NULL) {
-		return;
+log_appender* cuLogAppenderMemoryNew(int capacity) {
+	struct memory_appender* result = CU_MALLOC(struct memory_appender);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+	result->appender.append = appendToMemory;
+	result->appender.flush = NULL;
+	result->appender.destroy = destroyMemoryAppender;
+	pthread_mutex_init(&result->mutex, NULL);
+	result->entries = calloc(capacity, sizeof(char*));
+	if (result->entries == NULL) {
+		ERROR_MALLOC();
+	}
+	result->capacity = capacity;
+	result->size = 0;
+	result->first = 0;
+	return &result->appender;
+}
+
+int cuLogAppenderMemoryGetSize(CU_NOTNULL log_appender* appender) {
+	struct memory_appender* a = (struct memory_appender*) appender;
+	pthread_mutex_lock(&a->mutex);
+	int result = a->size;
+	pthread_mutex_unlock(&a->mutex);
+	return result;
+}
+
+void cuLogAppenderMemoryGetEntry(CU_NOTNULL log_appender* appender, int index, CU_NOTNULL char* buffer, size_t bufferSize) {
+	struct memory_appender* a = (struct memory_appender*) appender;
+	pthread_mutex_lock(&a->mutex);
+	if (index < 0 || index >= a->size) {
+		pthread_mutex_unlock(&a->mutex);
+		ERROR_OBJECT_NOT_FOUND("log entry", "%d", index);
+	}
+	snprintf(buffer, bufferSize, "%s", a->entries[(a->first + index) % a->capacity]);
+	pthread_mutex_unlock(&a->mutex);
+}
+
+void cuLogAppenderDestroy(CU_NOTNULL const log_appender* appender, CU_NULLABLE const struct var_args* context) {
+	if (appender->destroy != NULL) {
+		appender->destroy((log_appender*) appender);
 	}
-	char* nameCopy = malloc(strlen(name)+1);
-	if (nameCopy == NULL) {
+}
+
+void enableAsyncLogging(int capacity) {
+	if (async.enabled) {
 		return;
 	}
-	strcpy(nameCopy, name);
-	retVal->name = nameCopy;
-	retVal->hashName = hashDjb2(retVal->name);
-	retVal->next = NULL;
 
-	if (*names != NULL) {
-		retVal->next = (*names);
+	size_t size = 1;
+	while (size < (size_t)capacity) {
+		size *= 2;
+	}
+	async.ring = malloc(sizeof(struct log_ring_cell) * size);
+	if (async.ring == NULL) {
+		ERROR_MALLOC();
+	}
+	for (size_t i=0; i<size; i++) {
+		async.ring[i].sequence = i;
+	}
+	async.mask = size - 1;
+	async.enqueuePosition = 0;
+	async.dequeuePosition = 0;
+	async.flushedPosition = 0;
+	async.producers = 0;
+	async.stop = false;
+	if (pthread_create(&async.writer, NULL, writeRecords, NULL) != 0) {
+		ERROR_ON_CONSTRUCTION("log writer", "capacity %d", capacity);
+	}
+	__sync_synchronize();
+	async.enabled = true;
+
+	if (!async.exitHandlerRegistered) {
+		atexit(disableAsyncLogging);
+		async.exitHandlerRegistered = true;
 	}
-	(*names) = retVal;
 }
 
-static void removeAllNames(Names** names) {
-	Names* tmp = *names;
-	Names* tmp2 = NULL;
-	while(tmp != NULL) {
-		tmp2 = tmp->next;
-		free(tmp->name);
-		free(tmp);
-		tmp = tmp2;
+void disableAsyncLogging() {
+	if (!async.enabled) {
+		return;
 	}
-	*names = NULL;
+	//the new entries are logged synchronously. We wait for the threads which are still pushing in the ring before tearing it down
+	async.enabled = false;
+	__sync_synchronize();
+	while (__sync_add_and_fetch(&async.producers, 0) > 0) {
+		sched_yield();
+	}
+	async.stop = true;
+	pthread_join(async.writer, NULL);
+	free(async.ring);
+	async.ring = NULL;
 }
 
-static void removeFromNames(Names** names, const char* name) {
-	Names* tmp = *names;
-	Names* old = NULL;
-	unsigned long hashName = hashDjb2(name);
+void flushLogs() {
+	if (!async.enabled) {
+		flushAppenders();
+		return;
+	}
+	size_t target = __sync_add_and_fetch(&async.enqueuePosition, 0);
+	while (async.flushedPosition < target) {
+		sched_yield();
+	}
+}
 
-	while (tmp != NULL) {
-		if ( tmp->hashName == hashName) {
-			if (old == NULL) {//we need to remove the head
-				(*names) = tmp->next;
-			} else {
-				old->next = tmp->next;
-				free(tmp->name);
-				free(tmp);
-			}
+void __generic_log_function(const LogLevel level, const char* absoluteFilePath, const char* functionName, const int lineNo, int logBufferSize, char* logBuffer, const char* format, ...) {
+	if (level < logLevel) {
+		return;
+	}
+	const char* fileName = getBaseName(absoluteFilePath);
+	if (isExcluded(fileName)) {
+		return;
+	}
+	va_list argList;
+	va_start(argList, format);
+	vsnprintf(logBuffer, logBufferSize, format, argList);
+	va_end(argList);
 
+	if (async.enabled) {
+		__sync_add_and_fetch(&async.producers, 1);
+		//check again: ::disableAsyncLogging may have started while we were registering as a producer
+		if (async.enabled) {
+			pushRecord(level, fileName, functionName, lineNo, logBuffer);
+			__sync_sub_and_fetch(&async.producers, 1);
+			return;
 		}
-		old = tmp;
-		tmp = tmp->next;
+		__sync_sub_and_fetch(&async.producers, 1);
 	}
+	dispatch(fileName, functionName, lineNo, level, logBuffer);
+	flushAppenders();
 }
 
-static bool isExcluded(Names** names, const char* name) {
-	if (*names == NULL) {
+/**
+ * Give a log entry to every appender
+ */
+static void dispatch(const char* fileName, const char* functionName, int lineNo, LogLevel level, const char* message) {
+	for (int i=0; i<appendersNumber; i++) {
+		appenders[i]->append(appenders[i], fileName, functionName, lineNo, level, message);
+	}
+}
+
+/**
+ * Flush every appender
+ */
+static void flushAppenders() {
+	for (int i=0; i<appendersNumber; i++) {
+		if (appenders[i]->flush != NULL) {
+			appenders[i]->flush(appenders[i]);
+		}
+	}
+}
+
+/**
+ * @param[in] path a path
+ * @return the last component of @c path. It is a pointer inside @c path, so no buffer is needed
+ */
+static const char* getBaseName(const char* path) {
+	const char* result = strrchr(path, '/');
+	return result == NULL ? path : result + 1;
+}
+
+/**
+ * @param[in] name the name of a logger
+ * @return true if the logger has been excluded via ::excludeLogger
+ */
+static bool isExcluded(const char* name) {
+	if (excludedLoggers == NULL || cuFlatHTIsEmpty(excludedLoggers)) {
 		return false;
 	}
-	Names* tmp = *names;
-	unsigned long hashName = hashDjb2(name);
-	while (tmp != NULL) {
-		if (tmp->hashName == hashName) {
+	for (struct excluded_logger* excluded = cuFlatHTGetItem(excludedLoggers, hashDjb2(name)); excluded != NULL; excluded = excluded->nextSameHash) {
+		if (strcmp(excluded->name, name) == 0) {
 			return true;
 		}
-		tmp = tmp->next;
 	}
 	return false;
 }
@@ -192,17 +485,212 @@ static bool isExcluded(Names** names, const char* name) {
 static unsigned long hashDjb2(const char *str) {
 	unsigned long hash = 5381;
 	int c;
-	while (c = *str++)
+	while ((c = *str++))
 		hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
 	return hash;
 }
 
-static void logToStdOut(const char* fileName, const char* functionName, const int lineNo, const LogLevel level, const char* message) {
+/**
+ * Put a log entry in the ring of the asynchronous logging
+ *
+ * If the ring is full, the function waits until the writer makes room
+ */
+static void pushRecord(LogLevel level, const char* fileName, const char* functionName, int lineNo, const char* message) {
+	size_t position = __sync_add_and_fetch(&async.enqueuePosition, 0);
+	struct log_ring_cell* cell;
+	while (true) {
+		cell = &async.ring[position & async.mask];
+		size_t sequence = cell->sequence;
+		__sync_synchronize();
+		if (sequence == position) {
+			if (__sync_bool_compare_and_swap(&async.enqueuePosition, position, position + 1)) {
+				break;
+			}
+			position = __sync_add_and_fetch(&async.enqueuePosition, 0);
+		} else if (sequence < position) {
+			//the ring is full
+			sched_yield();
+			position = __sync_add_and_fetch(&async.enqueuePosition, 0);
+		} else {
+			position = __sync_add_and_fetch(&async.enqueuePosition, 0);
+		}
+	}
+
+	cell->record.level = level;
+	cell->record.lineNo = lineNo;
+	copyName(cell->record.fileName, fileName);
+	copyName(cell->record.functionName, functionName);
+	snprintf(cell->record.message, LOG_RECORD_MESSAGE_SIZE, "%s", message);
+	__sync_synchronize();
+	cell->sequence = position + 1;
+}
+
+/**
+ * Get the oldest entry from the ring of the asynchronous logging
+ *
+ * @param[out] record where to copy the entry
+ * @return true if there was an entry, false if the ring is empty
+ */
+static bool popRecord(struct log_record* record) {
+	struct log_ring_cell* cell = &async.ring[async.dequeuePosition & async.mask];
+	size_t sequence = cell->sequence;
+	__sync_synchronize();
+	if (sequence != async.dequeuePosition + 1) {
+		return false;
+	}
+	memcpy(record, &cell->record, sizeof(struct log_record));
+	__sync_synchronize();
+	cell->sequence = async.dequeuePosition + async.mask + 1;
+	async.dequeuePosition++;
+	return true;
+}
+
+/**
+ * The body of the background thread of the asynchronous logging
+ *
+ * The thread gives the entries to the appenders in batches of at most a ring worth of entries, flushing them after each batch:
+ * in this way ::flushLogs returns even if other threads keep logging
+ */
+static void* writeRecords(void* arg) {
+	struct log_record record;
+	struct timespec pause = {0, 0};
+	while (true) {
+		size_t batch = 0;
+		while (batch <= async.mask && popRecord(&record)) {
+			dispatch(record.fileName, record.functionName, record.lineNo, record.level, record.message);
+			batch++;
+		}
+		if (async.flushedPosition != async.dequeuePosition) {
+			flushAppenders();
+			__sync_synchronize();
+			async.flushedPosition = async.dequeuePosition;
+		}
+		if (batch > 0) {
+			pause.tv_nsec = 0;
+			continue;
+		}
+		if (async.stop && __sync_add_and_fetch(&async.enqueuePosition, 0) == async.dequeuePosition) {
+			break;
+		}
+		//back off up to 1ms while the ring is empty
+		pause.tv_nsec = pause.tv_nsec == 0 ? 10000 : (pause.tv_nsec < 1000000 ? pause.tv_nsec * 2 : pause.tv_nsec);
+		nanosleep(&pause, NULL);
+	}
+	return NULL;
+}
+
+/**
+ * Copy a file or a function name in a ::log_record, truncating it if needed
+ */
+static void copyName(char* destination, const char* source) {
+	size_t length = strlen(source);
+	if (length >= LOG_RECORD_NAME_SIZE) {
+		length = LOG_RECORD_NAME_SIZE - 1;
+	}
+	memcpy(destination, source, length);
+	destination[length] = '\0';
+}
+
+static void appendToStdOut(log_appender* appender, const char* fileName, const char* functionName, int lineNo, LogLevel level, const char* message) {
 	printf("%s:%s:%d[%s] %s\n", fileName, functionName, lineNo, LOGLEVEL_TO_STRING[level], message);
+}
+
+static void flushStdOut(log_appender* appender) {
 	fflush(stdout);
 }
 
-static void logToDevNull(const char* fileName, const char* functionName, const int lineNo, const LogLevel level, const char* message) {
+static void destroyHeapAppender(log_appender* appender) {
+	CU_FREE(appender);
+}
+
+static void appendToFunction(log_appender* appender, const char* fileName, const char* functionName, int lineNo, LogLevel level, const char* message) {
+	((struct function_appender*)appender)->function(fileName, functionName, lineNo, level, message);
+}
+
+static void appendToFile(log_appender* appender, const char* fileName, const char* functionName, int lineNo, LogLevel level, const char* message) {
+	struct file_appender* a = (struct file_appender*) appender;
+	pthread_mutex_lock(&a->mutex);
+	int written = fprintf(a->file, "%s:%s:%d[%s] %s\n", fileName, functionName, lineNo, LOGLEVEL_TO_STRING[level], message);
+	if (written > 0) {
+		a->size += written;
+	}
+	if (a->maxBytes > 0 && a->size >= a->maxBytes) {
+		rotateFile(a);
+	}
+	pthread_mutex_unlock(&a->mutex);
+}
+
+static void flushFile(log_appender* appender) {
+	struct file_appender* a = (struct file_appender*) appender;
+	pthread_mutex_lock(&a->mutex);
+	fflush(a->file);
+	pthread_mutex_unlock(&a->mutex);
+}
+
+static void destroyFileAppender(log_appender* appender) {
+	struct file_appender* a = (struct file_appender*) appender;
+	fclose(a->file);
+	pthread_mutex_destroy(&a->mutex);
+	CU_FREE(a->path);
+	CU_FREE(a);
+}
+
+/**
+ * Shift the rotated files of a file appender by one and start a new file
+ *
+ * The caller needs to hold ::file_appender::mutex
+ */
+static void rotateFile(struct file_appender* appender) {
+	size_t bufferSize = strlen(appender->path) + 16;
+	char from[bufferSize];
+	char to[bufferSize];
+
+	fclose(appender->file);
+	if (appender->maxFiles > 0) {
+		snprintf(to, bufferSize, "%s.%d", appender->path, appender->maxFiles);
+		remove(to);
+		for (int i=appender->maxFiles - 1; i>0; i--) {
+			snprintf(from, bufferSize, "%s.%d", appender->path, i);
+			snprintf(to, bufferSize, "%s.%d", appender->path, i + 1);
+			rename(from, to);
+		}
+		snprintf(to, bufferSize, "%s.1", appender->path);
+		rename(appender->path, to);
+	}
+	appender->file = fopen(appender->path, "w");
+	if (appender->file == NULL) {
+		ERROR_FILE(appender->path);
+	}
+	appender->size = 0;
+}
+
+static void appendToMemory(log_appender* appender, const char* fileName, const char* functionName, int lineNo, LogLevel level, const char* message) {
+	struct memory_appender* a = (struct memory_appender*) appender;
+	int length = snprintf(NULL, 0, "%s:%s:%d[%s] %s", fileName, functionName, lineNo, LOGLEVEL_TO_STRING[level], message);
+	char* entry = malloc(length + 1);
+	if (entry == NULL) {
+		ERROR_MALLOC();
+	}
+	snprintf(entry, length + 1, "%s:%s:%d[%s] %s", fileName, functionName, lineNo, LOGLEVEL_TO_STRING[level], message);
 
+	pthread_mutex_lock(&a->mutex);
+	if (a->size == a->capacity) {
+		free(a->entries[a->first]);
+		a->entries[a->first] = entry;
+		a->first = (a->first + 1) % a->capacity;
+	} else {
+		a->entries[(a->first + a->size) % a->capacity] = entry;
+		a->size++;
+	}
+	pthread_mutex_unlock(&a->mutex);
 }
 
+static void destroyMemoryAppender(log_appender* appender) {
+	struct memory_appender* a = (struct memory_appender*) appender;
+	for (int i=0; i<a->size; i++) {
+		free(a->entries[(a->first + i) % a->capacity]);
+	}
+	free(a->entries);
+	pthread_mutex_destroy(&a->mutex);
+	CU_FREE(a);
+}
@@ -9,7 +9,10 @@
 #include <pthread.h>
 #include <stdlib.h>
 #include "log.h"
-#include "dynamic_array.h"
+#include <unistd.h>
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
 #include "errors.h"
 
 enum thread_state {
@@ -39,6 +42,22 @@ static void* cuAbstractRunnable(void* arguments);
 static void setThreadState(CU_NOTNULL cu_thread* thread, enum thread_state state);
 static cu_mutex cuSetupMutex(bool recursive);
 
+struct work_deque;
+struct pool_worker;
+static enum thread_loop_state cuPoolWorkerRunnable(CU_NOTNULL const cu_thread* thread, const struct var_args* va);
+static cu_future* fetchTask(CU_NOTNULL struct pool_worker* worker);
+static void runTask(CU_NOTNULL struct pool_worker* worker, CU_NOTNULL cu_future* task);
+static void notifyNewTask(CU_NOTNULL cu_parallel_thread_pool* pool);
+static void releaseFuture(CU_NOTNULL cu_future* future);
+static struct timespec computeDeadline(long msToWait);
+static bool isDeadlinePassed(struct timespec deadline);
+static void initWorkDeque(CU_NOTNULL struct work_deque* deque);
+static void growWorkDeque(CU_NOTNULL struct work_deque* deque);
+static void pushBottom(CU_NOTNULL struct work_deque* deque, CU_NOTNULL cu_future* task);
+static void pushTop(CU_NOTNULL struct work_deque* deque, CU_NOTNULL cu_future* task);
+static cu_future* popBottom(CU_NOTNULL struct work_deque* deque);
+static cu_future* popTop(CU_NOTNULL struct work_deque* deque);
+
 cu_thread* cuThreadNew(CU_NOTNULL cu_runnable runnable, const struct var_args* varargs) {
 	cu_thread* result = CU_MALLOC(struct cu_thread);
 	if (result == NULL) {
@@ -235,44 +254,533 @@ static void* cuAbstractRunnable(void* arguments) {
 	pthread_exit(NULL);
 }
 
-typedef dynamic_1D_array cu_thread_dynamic_1d_array;
+/**
+ * A double ended queue of tasks owned by a worker
+ *
+ * The owner pushes and pops from the bottom while thieves steal from the top
+ */
+struct work_deque {
+	pthread_mutex_t lock;
+	///circular buffer of tasks
+	cu_future** tasks;
+	///size of ::work_deque::tasks. Always a power of 2
+	size_t capacity;
+	///index of the top of the queue (the oldest task)
+	size_t head;
+	///number of tasks in the queue
+	size_t size;
+};
 
-struct cu_parallel_thread_pool {
-	cu_mutex foundMutex;
-	cu_thread_dynamic_1d_array* threads;
+struct pool_worker {
+	cu_parallel_thread_pool* pool;
+	int id;
+	cu_thread* thread;
+	///the arguments of ::cuPoolWorkerRunnable
+	var_args* arguments;
+	struct work_deque deque;
+	///seed used to choose the workers to steal from
+	unsigned int seed;
+};
+
+struct cu_future {
+	cu_parallel_thread_pool* pool;
 	cu_runnable runnable;
+	const struct var_args* arguments;
+	pthread_mutex_t mutex;
+	pthread_cond_t completed;
+	bool done;
+	///number of owners of this structure: the user and the pool
+	int references;
+};
+
+struct cu_parallel_thread_pool {
+	struct pool_worker* workers;
+	int totalThreads;
+	///tasks which are in a queue but not yet taken by any worker
+	int queued;
+	///tasks submitted but not yet completed
+	int unfinished;
+	///worker which will receive the next task submitted from outside the pool
+	unsigned int nextWorker;
+	bool shutdown;
+	///mutex protecting ::cu_parallel_thread_pool::workAvailable and ::cu_parallel_thread_pool::allDone
+	pthread_mutex_t mutex;
+	pthread_cond_t workAvailable;
+	pthread_cond_t allDone;
 };
 
-cu_parallel_thread_pool* cuNewParallelThreadPool(int totalThreads, CU_NOTNULL cu_runnable runnable, const var_args* va) {
-	struct cu_parallel_thread_pool* result = CU_MALLOC(cu_parallel_thread_pool);
+/**
+ * The worker of the pool the current thread is, NULL if the thread is not a worker of any pool
+ */
+static __thread struct pool_worker* currentWorker = NULL;
+
+#define WORK_DEQUE_INITIAL_CAPACITY 64
+
+cu_parallel_thread_pool* cuParallelThreadPoolNew(int totalThreads) {
+	cu_parallel_thread_pool* result = CU_MALLOC(cu_parallel_thread_pool);
 	if (result == NULL) {
 		ERROR_MALLOC();
 	}
 
-	pthread_mutex_init(&result->foundMutex.mutex, NULL);
-	//the last thread is the timing one
-	result->threads = cuDynamicArrayNew(cu_thread*, totalThreads + 1);
+	if (totalThreads <= 0) {
+		totalThreads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+		if (totalThreads <= 0) {
+			totalThreads = 1;
+		}
+	}
+
+	result->totalThreads = totalThreads;
+	result->queued = 0;
+	result->unfinished = 0;
+	result->nextWorker = 0;
+	result->shutdown = false;
+	pthread_mutex_init(&result->mutex, NULL);
+	pthread_cond_init(&result->workAvailable, NULL);
+	pthread_cond_init(&result->allDone, NULL);
+
+	result->workers = calloc(totalThreads, sizeof(struct pool_worker));
+	if (result->workers == NULL) {
+		ERROR_MALLOC();
+	}
 	for (int i=0; i<totalThreads; i++) {
-		cuDynamicArraySetCellTo(result->threads, i, cu_thread*, cuThreadNew(runnable, va));
+		struct pool_worker* worker = &result->workers[i];
+		worker->pool = result;
+		worker->id = i;
+		worker->seed = (unsigned int)(i + 1) * 2654435761u;
+		initWorkDeque(&worker->deque);
+		cuNewVarArgsOnHeap(va, result, i);
+		worker->arguments = va;
+		worker->thread = cuThreadNew(cuPoolWorkerRunnable, worker->arguments);
 	}
+	for (int i=0; i<totalThreads; i++) {
+		cuThreadRequestStart(result->workers[i].thread);
+	}
+
+	return result;
+}
+
+CU_DEFINE_DEFAULT_VALUES(cuParallelThreadPoolNew,
+		0
+);
+
+void cuParallelThreadPoolDestroy(CU_NOTNULL const cu_parallel_thread_pool* pool, CU_NULLABLE const struct var_args* context) {
+	cu_parallel_thread_pool* p = (cu_parallel_thread_pool*) pool;
+
+	cuParallelThreadPoolWaitAll(p, -1);
+
+	pthread_mutex_lock(&p->mutex);
+	p->shutdown = true;
+	pthread_cond_broadcast(&p->workAvailable);
+	pthread_mutex_unlock(&p->mutex);
+
+	for (int i=0; i<p->totalThreads; i++) {
+		struct pool_worker* worker = &p->workers[i];
+		cuThreadWaitForCompletition(worker->thread);
+		cuThreadDestroy(worker->thread, context);
+		cuDestroyVarArgs(worker->arguments, context);
+		CU_FREE(worker->deque.tasks);
+		pthread_mutex_destroy(&worker->deque.lock);
+	}
+	CU_FREE(p->workers);
+
+	pthread_cond_destroy(&p->workAvailable);
+	pthread_cond_destroy(&p->allDone);
+	pthread_mutex_destroy(&p->mutex);
+	CU_FREE(p);
+}
+
+int cuParallelThreadPoolGetThreadsNumber(CU_NOTNULL const cu_parallel_thread_pool* pool) {
+	return pool->totalThreads;
+}
+
+cu_future* cuParallelThreadPoolSubmit(CU_NOTNULL cu_parallel_thread_pool* pool, CU_NOTNULL cu_runnable runnable, CU_NULLABLE const struct var_args* varargs) {
+	cu_future* result = CU_MALLOC(cu_future);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+
+	result->pool = pool;
 	result->runnable = runnable;
+	result->arguments = varargs;
+	pthread_mutex_init(&result->mutex, NULL);
+	pthread_cond_init(&result->completed, NULL);
+	result->done = false;
+	result->references = 2;
+
+	__sync_add_and_fetch(&pool->unfinished, 1);
+	if (currentWorker != NULL && currentWorker->pool == pool) {
+		pushBottom(&currentWorker->deque, result);
+	} else {
+		unsigned int index = __sync_fetch_and_add(&pool->nextWorker, 1) % pool->totalThreads;
+		pushBottom(&pool->workers[index].deque, result);
+	}
+	notifyNewTask(pool);
+
+	return result;
+}
+
+bool cuParallelThreadPoolWaitAll(CU_NOTNULL cu_parallel_thread_pool* pool, long msToWait) {
+	struct timespec deadline = computeDeadline(msToWait);
+	bool result = true;
+
+	pthread_mutex_lock(&pool->mutex);
+	while (__sync_add_and_fetch(&pool->unfinished, 0) > 0) {
+		if (msToWait < 0) {
+			pthread_cond_wait(&pool->allDone, &pool->mutex);
+		} else if (pthread_cond_timedwait(&pool->allDone, &pool->mutex, &deadline) == ETIMEDOUT) {
+			result = __sync_add_and_fetch(&pool->unfinished, 0) == 0;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&pool->mutex);
 
 	return result;
 }
 
-void cuParallelThreadPoolRequestStart(CU_NOTNULL cu_parallel_thread_pool* executor) {
-	CU_ITERATE_THROUGH_DYNAMIC_ARRAY(executor->threads, i, t, cu_thread*) {
-		cuThreadRequestStart(t);
+void cuParallelThreadPoolFor(CU_NULLABLE cu_parallel_thread_pool* pool, CU_NOTNULL cu_runnable task, CU_NULLABLE const struct var_args* va, CU_NOTNULL cu_parallel_for* loop, unsigned int chunksNumber) {
+	loop->chunksNumber = chunksNumber;
+	loop->next = 0;
+
+	unsigned int tasks = pool != NULL ? (unsigned int) pool->totalThreads : 1;
+	if (chunksNumber < tasks) {
+		tasks = chunksNumber;
+	}
+	if (tasks <= 1) {
+		task(NULL, va);
+		return;
+	}
+
+	cu_future* futures[tasks];
+	for (unsigned int i=0; i<tasks; i++) {
+		futures[i] = cuParallelThreadPoolSubmit(pool, task, va);
+	}
+	for (unsigned int i=0; i<tasks; i++) {
+		cuFutureWait(futures[i], -1);
+		cuFutureDestroy(futures[i], NULL);
+	}
+}
+
+bool cuParallelForGetNextChunk(CU_NOTNULL cu_parallel_for* loop, CU_NOTNULL unsigned int* chunk) {
+	//a fast check first, so the counter does not grow forever once the loop is over
+	if (loop->next >= loop->chunksNumber) {
+		return false;
+	}
+	*chunk = __sync_fetch_and_add(&loop->next, 1);
+	return *chunk < loop->chunksNumber;
+}
+
+bool cuFutureWait(CU_NOTNULL cu_future* future, long msToWait) {
+	struct timespec deadline = computeDeadline(msToWait);
+
+	if (currentWorker != NULL && currentWorker->pool == future->pool) {
+		//we're inside a task: instead of blocking the worker, we help the pool
+		while (!cuFutureIsDone(future)) {
+			if (msToWait >= 0 && isDeadlinePassed(deadline)) {
+				return false;
+			}
+			cu_future* task = fetchTask(currentWorker);
+			if (task != NULL) {
+				runTask(currentWorker, task);
+			} else {
+				sched_yield();
+			}
+		}
+		return true;
+	}
+
+	bool result = true;
+	pthread_mutex_lock(&future->mutex);
+	while (!future->done) {
+		if (msToWait < 0) {
+			pthread_cond_wait(&future->completed, &future->mutex);
+		} else if (pthread_cond_timedwait(&future->completed, &future->mutex, &deadline) == ETIMEDOUT) {
+			result = future->done;
+			break;
+		}
 	}
-	ERROR_NOT_IMPLEMENTED();
+	pthread_mutex_unlock(&future->mutex);
+
+	return result;
+}
+
+bool cuFutureIsDone(CU_NOTNULL const cu_future* future) {
+	__sync_synchronize();
+	return *((volatile const bool*)&future->done);
 }
 
-void* cuParallelThreadPoolWaitResult(CU_NOTNULL cu_parallel_thread_pool* executor, long msToWait, void* defaultValue) {
-	ERROR_NOT_IMPLEMENTED();
+void cuFutureDestroy(CU_NOTNULL const cu_future* future, CU_NULLABLE const struct var_args* context) {
+	releaseFuture((cu_future*) future);
 }
 
-void* cuDestroyParallelThreadPool(CU_NOTNULL cu_parallel_thread_pool* executor) {
-	ERROR_NOT_IMPLEMENTED();
+/**
+ * The code each worker of a ::cu_parallel_thread_pool runs
+ *
+ * Each loop executes at most one task
+ *
+ * @private
+ *
+ * @param[in] thread the thread of the worker
+ * @param[in] va a pointer to the pool and the index of the worker inside it
+ */
+static enum thread_loop_state cuPoolWorkerRunnable(CU_NOTNULL const cu_thread* thread, const struct var_args* va) {
+	cu_parallel_thread_pool* pool = cuVarArgsGetItem(va, 0, cu_parallel_thread_pool*);
+	int id = cuVarArgsGetItem(va, 1, int);
+	struct pool_worker* worker = &pool->workers[id];
+
+	currentWorker = worker;
+
+	cu_future* task = fetchTask(worker);
+	if (task != NULL) {
+		runTask(worker, task);
+		return TLS_CONTINUE;
+	}
+
+	//nothing to do: sleep until a new task is submitted
+	enum thread_loop_state result = TLS_CONTINUE;
+	pthread_mutex_lock(&pool->mutex);
+	while (__sync_add_and_fetch(&pool->queued, 0) == 0 && !pool->shutdown) {
+		pthread_cond_wait(&pool->workAvailable, &pool->mutex);
+	}
+	if (pool->shutdown && __sync_add_and_fetch(&pool->queued, 0) == 0) {
+		result = TLS_STOP;
+	}
+	pthread_mutex_unlock(&pool->mutex);
+
+	return result;
+}
+
+/**
+ * Take a task from the bottom of the queue of @c worker or, if empty, steal one from the top of the queue of another worker
+ *
+ * @private
+ *
+ * @param[inout] worker the worker looking for a task
+ * @return
+ *  @li the task to execute;
+ *  @li NULL if no task is available
+ */
+static cu_future* fetchTask(CU_NOTNULL struct pool_worker* worker) {
+	cu_parallel_thread_pool* pool = worker->pool;
+	cu_future* result = popBottom(&worker->deque);
+
+	if (result == NULL && pool->totalThreads > 1) {
+		//xorshift to choose the first victim
+		worker->seed ^= worker->seed << 13;
+		worker->seed ^= worker->seed >> 17;
+		worker->seed ^= worker->seed << 5;
+		int start = worker->seed % pool->totalThreads;
+		for (int i=0; i<pool->totalThreads && result == NULL; i++) {
+			int victim = (start + i) % pool->totalThreads;
+			if (victim != worker->id) {
+				result = popTop(&pool->workers[victim].deque);
+			}
+		}
+	}
+
+	if (result != NULL) {
+		__sync_sub_and_fetch(&pool->queued, 1);
+	}
+	return result;
+}
+
+/**
+ * Execute one step of a task
+ *
+ * @private
+ *
+ * @param[inout] worker the worker executing the task
+ * @param[inout] task the task to execute
+ */
+static void runTask(CU_NOTNULL struct pool_worker* worker, CU_NOTNULL cu_future* task) {
+	cu_parallel_thread_pool* pool = worker->pool;
+
+	if (task->runnable(worker->thread, task->arguments) == TLS_CONTINUE) {
+		//put the task where the thieves steal from, so the other tasks in the queue are not starved
+		pushTop(&worker->deque, task);
+		notifyNewTask(pool);
+		return;
+	}
+
+	pthread_mutex_lock(&task->mutex);
+	task->done = true;
+	pthread_cond_broadcast(&task->completed);
+	pthread_mutex_unlock(&task->mutex);
+	releaseFuture(task);
+
+	if (__sync_sub_and_fetch(&pool->unfinished, 1) == 0) {
+		pthread_mutex_lock(&pool->mutex);
+		pthread_cond_broadcast(&pool->allDone);
+		pthread_mutex_unlock(&pool->mutex);
+	}
+}
+
+/**
+ * Tell the sleeping workers that a new task is available
+ *
+ * @private
+ *
+ * @param[inout] pool the pool involved
+ */
+static void notifyNewTask(CU_NOTNULL cu_parallel_thread_pool* pool) {
+	__sync_add_and_fetch(&pool->queued, 1);
+	pthread_mutex_lock(&pool->mutex);
+	pthread_cond_signal(&pool->workAvailable);
+	pthread_mutex_unlock(&pool->mutex);
+}
+
+/**
+ * Drop a reference of the future. When no one references the future anymore, it is released from memory
+ *
+ * @private
+ *
+ * @param[inout] future the future involved
+ */
+static void releaseFuture(CU_NOTNULL cu_future* future) {
+	if (__sync_sub_and_fetch(&future->references, 1) == 0) {
+		pthread_cond_destroy(&future->completed);
+		pthread_mutex_destroy(&future->mutex);
+		CU_FREE(future);
+	}
+}
+
+/**
+ * @private
+ *
+ * @param[in] msToWait milliseconds from now. If negative, the return value is meaningless
+ * @return the absolute time after @c msToWait milliseconds from now, as required by @c pthread_cond_timedwait
+ */
+static struct timespec computeDeadline(long msToWait) {
+	struct timespec result;
+	clock_gettime(CLOCK_REALTIME, &result);
+	if (msToWait > 0) {
+		result.tv_sec += msToWait / 1000;
+		result.tv_nsec += (msToWait % 1000) * 1000000L;
+		if (result.tv_nsec >= 1000000000L) {
+			result.tv_sec += 1;
+			result.tv_nsec -= 1000000000L;
+		}
+	}
+	return result;
+}
+
+/**
+ * @private
+ *
+ * @param[in] deadline a time generated by ::computeDeadline
+ * @return true if @c deadline is in the past
+ */
+static bool isDeadlinePassed(struct timespec deadline) {
+	struct timespec now;
+	clock_gettime(CLOCK_REALTIME, &now);
+	return (now.tv_sec > deadline.tv_sec) || (now.tv_sec == deadline.tv_sec && now.tv_nsec >= deadline.tv_nsec);
+}
+
+/**
+ * @private
+ *
+ * @param[out] deque the queue to initialize
+ */
+static void initWorkDeque(CU_NOTNULL struct work_deque* deque) {
+	pthread_mutex_init(&deque->lock, NULL);
+	deque->capacity = WORK_DEQUE_INITIAL_CAPACITY;
+	deque->head = 0;
+	deque->size = 0;
+	deque->tasks = malloc(sizeof(cu_future*) * deque->capacity);
+	if (deque->tasks == NULL) {
+		ERROR_MALLOC();
+	}
+}
+
+/**
+ * Double the capacity of the queue
+ *
+ * @private
+ *
+ * @pre
+ *  @li the lock of @c deque is held
+ *
+ * @param[inout] deque the queue to grow
+ */
+static void growWorkDeque(CU_NOTNULL struct work_deque* deque) {
+	cu_future** tasks = malloc(sizeof(cu_future*) * deque->capacity * 2);
+	if (tasks == NULL) {
+		ERROR_MALLOC();
+	}
+	for (size_t i=0; i<deque->size; i++) {
+		tasks[i] = deque->tasks[(deque->head + i) & (deque->capacity - 1)];
+	}
+	CU_FREE(deque->tasks);
+	deque->tasks = tasks;
+	deque->head = 0;
+	deque->capacity *= 2;
+}
+
+/**
+ * @private
+ *
+ * @param[inout] deque the queue involved
+ * @param[in] task the task to add as the newest one
+ */
+static void pushBottom(CU_NOTNULL struct work_deque* deque, CU_NOTNULL cu_future* task) {
+	pthread_mutex_lock(&deque->lock);
+	if (deque->size == deque->capacity) {
+		growWorkDeque(deque);
+	}
+	deque->tasks[(deque->head + deque->size) & (deque->capacity - 1)] = task;
+	deque->size += 1;
+	pthread_mutex_unlock(&deque->lock);
+}
+
+/**
+ * @private
+ *
+ * @param[inout] deque the queue involved
+ * @param[in] task the task to add as the oldest one
+ */
+static void pushTop(CU_NOTNULL struct work_deque* deque, CU_NOTNULL cu_future* task) {
+	pthread_mutex_lock(&deque->lock);
+	if (deque->size == deque->capacity) {
+		growWorkDeque(deque);
+	}
+	deque->head = (deque->head + deque->capacity - 1) & (deque->capacity - 1);
+	deque->tasks[deque->head] = task;
+	deque->size += 1;
+	pthread_mutex_unlock(&deque->lock);
+}
+
+/**
+ * @private
+ *
+ * @param[inout] deque the queue involved
+ * @return the newest task of the queue or NULL if the queue is empty
+ */
+static cu_future* popBottom(CU_NOTNULL struct work_deque* deque) {
+	cu_future* result = NULL;
+	pthread_mutex_lock(&deque->lock);
+	if (deque->size > 0) {
+		deque->size -= 1;
+		result = deque->tasks[(deque->head + deque->size) & (deque->capacity - 1)];
+	}
+	pthread_mutex_unlock(&deque->lock);
+	return result;
+}
+
+/**
+ * @private
+ *
+ * @param[inout] deque the queue involved
+ * @return the oldest task of the queue or NULL if the queue is empty
+ */
+static cu_future* popTop(CU_NOTNULL struct work_deque* deque) {
+	cu_future* result = NULL;
+	pthread_mutex_lock(&deque->lock);
+	if (deque->size > 0) {
+		result = deque->tasks[deque->head];
+		deque->head = (deque->head + 1) & (deque->capacity - 1);
+		deque->size -= 1;
+	}
+	pthread_mutex_unlock(&deque->lock);
+	return result;
 }
 
 /**
@@ -8,6 +8,7 @@
 #include "naive_queue.h"
 #include "defaultFunctions.h"
 #include "errors.h"
+#include "allocator.h"
 
 struct naive_queue_cell {
 	int evaluation;
@@ -22,13 +23,16 @@ struct naive_queue {
 	payload_functions functions;
 	evaluator_function f;
 	const var_args* va;
+	///where the cells of the queue are allocated. NULL means malloc
+	cu_allocator* allocator;
 };
 
-static struct naive_queue_cell* newNaiveQueueCell(int evaluation, CU_NULLABLE const void* payload, CU_NULLABLE struct naive_queue_cell* before,  CU_NULLABLE struct naive_queue_cell* next);
-static void destroyNaiveQueueCell(CU_NOTNULL const struct naive_queue_cell* nqc, destructor payloadDestructor);
+static struct naive_queue_cell* newNaiveQueueCell(CU_NOTNULL naive_queue* q, int evaluation, CU_NULLABLE const void* payload, CU_NULLABLE struct naive_queue_cell* before,  CU_NULLABLE struct naive_queue_cell* next);
+static void destroyNaiveQueueCell(CU_NOTNULL const naive_queue* q, CU_NOTNULL const struct naive_queue_cell* nqc, destructor payloadDestructor, CU_NULLABLE const var_args* context);
+static void releaseNaiveQueueCells(CU_NOTNULL const naive_queue* q, destructor payloadDestructor, CU_NULLABLE const var_args* context);
 static void* _cuNaiveQueueRemoveItemPrivate(CU_NOTNULL naive_queue* q, finder f, CU_NULLABLE const var_args* va, destructor d);
 
-naive_queue* cuNaiveQueueNew(payload_functions functions, evaluator_function f, CU_NULLABLE const var_args* va) {
+naive_queue* cuNaiveQueueNew(payload_functions functions, evaluator_function f, CU_NULLABLE const var_args* va, CU_NULLABLE cu_allocator* allocator) {
 	naive_queue* retVal = (naive_queue*) malloc(sizeof(naive_queue));
 	if (retVal == NULL) {
 		ERROR_MALLOC();
@@ -39,27 +43,25 @@ naive_queue* cuNaiveQueueNew(payload_functions functions, evaluator_function f,
 	retVal->functions = functions;
 	retVal->size = 0;
 	retVal->head = NULL;
+	retVal->allocator = allocator;
 
 	return retVal;
 }
 
+CU_DEFINE_DEFAULT_VALUES(cuNaiveQueueNew,
+		,
+		,
+		,
+		NULL
+);
+
 void cuNaiveQueueDestroy(CU_NOTNULL const naive_queue* nq, CU_NULLABLE const struct var_args* context) {
-	struct naive_queue_cell* nqc = nq->head;
-	while (nqc != NULL) {
-		struct naive_queue_cell* tmp = nqc->next;
-		destroyNaiveQueueCell(nqc, cuDefaultFunctionDestructorNOP);
-		nqc = tmp;
-	}
+	releaseNaiveQueueCells(nq, cuDefaultFunctionDestructorNOP, context);
 	free((void*)nq);
 }
 
 void cuNaiveQueueDestroyWithElements(CU_NOTNULL const naive_queue* nq, CU_NULLABLE const struct var_args* context) {
-	struct naive_queue_cell* nqc = nq->head;
-	while (nqc != NULL) {
-		struct naive_queue_cell* tmp = nqc->next;
-		destroyNaiveQueueCell(nqc, nq->functions.destroy);
-		nqc = tmp;
-	}
+	releaseNaiveQueueCells(nq, nq->functions.destroy, context);
 	free((void*)nq);
 }
 
@@ -69,7 +71,7 @@ void cuNaiveQueueAddItem(CU_NOTNULL naive_queue* q, CU_NULLABLE const void* el)
 	int elEvaluation = q->f(el, q->va);
 	if (nqc == NULL) {
 		//the queue is actually empty
-		struct naive_queue_cell* add = newNaiveQueueCell(elEvaluation, el, NULL, NULL);
+		struct naive_queue_cell* add = newNaiveQueueCell(q, elEvaluation, el, NULL, NULL);
 		q->head = add;
 		goto exit;
 	}
@@ -84,14 +86,14 @@ void cuNaiveQueueAddItem(CU_NOTNULL naive_queue* q, CU_NULLABLE const void* el)
 			continue;
 		}
 
-		struct naive_queue_cell* add = newNaiveQueueCell(elEvaluation, el, before, nqc);
+		struct naive_queue_cell* add = newNaiveQueueCell(q, elEvaluation, el, before, nqc);
 		nqc->before = add;
 		*prevPointer = add;
 		goto exit;
 	}
 
 	//add to the end of the queue
-	struct naive_queue_cell* add = newNaiveQueueCell(elEvaluation, el, before, NULL);
+	struct naive_queue_cell* add = newNaiveQueueCell(q, elEvaluation, el, before, NULL);
 	*prevPointer = add;
 
 	exit:;
@@ -147,7 +149,7 @@ void cuNaiveQueueRemoveCell(CU_NOTNULL naive_queue* q, const naive_queue_cell* q
 		queueCell->next->before = queueCell->before;
 	}
 	q->size -= 1;
-	destroyNaiveQueueCell(queueCell, cuDefaultFunctionDestructorNOP);
+	destroyNaiveQueueCell(q, queueCell, cuDefaultFunctionDestructorNOP, NULL);
 }
 
 void cuNaiveQueueRemoveCellWithElements(CU_NOTNULL naive_queue* q, const naive_queue_cell* queueCell) {
@@ -174,25 +176,13 @@ int cuNaiveQueueGetSize(CU_NOTNULL const naive_queue* q) {
 }
 
 void cuNaiveQueueClear(CU_NOTNULL naive_queue* q) {
-	struct naive_queue_cell* nqc = q->head;
-	while (nqc != NULL) {
-		struct naive_queue_cell* tmp = nqc->next;
-		destroyNaiveQueueCell(nqc, cuDefaultFunctionDestructorNOP);
-		CU_FREE(nqc);
-		nqc = tmp;
-	}
+	releaseNaiveQueueCells(q, cuDefaultFunctionDestructorNOP, NULL);
 	q->size = 0;
 	q->head = NULL;
 }
 
 void cuNaiveQueueClearWithElements(CU_NOTNULL naive_queue* q) {
-	struct naive_queue_cell* nqc = q->head;
-	while (nqc != NULL) {
-		struct naive_queue_cell* tmp = nqc->next;
-		destroyNaiveQueueCell(nqc, q->functions.destroy);
-		CU_FREE(nqc);
-		nqc = tmp;
-	}
+	releaseNaiveQueueCells(q, q->functions.destroy, NULL);
 	q->size = 0;
 	q->head = NULL;
 }
@@ -236,8 +226,8 @@ void* _cuNaiveQueueGetPayloadOfCell(const struct naive_queue_cell* nqc) {
 }
 
 void cuNaiveQueueAddContainer(CU_NOTNULL naive_queue* queue, CU_NOTNULL const list* l) {
-	CU_ITERATE_OVER_LIST(l, cell, payload, void*) {
-		cuNaiveQueueAddItem(queue, payload);
+	for (list_cell* cell=_cuListGetHeadCell(l); cell != NULL; cell=_cuListGetNextOfCell(cell)) {
+		cuNaiveQueueAddItem(queue, _cuListGetPayloadOfCell(cell));
 	}
 }
 
@@ -266,11 +256,8 @@ static void* _cuNaiveQueueRemoveItemPrivate(CU_NOTNULL naive_queue* q, finder f,
 	return NULL;
 }
 
-static struct naive_queue_cell* newNaiveQueueCell(int evaluation, CU_NULLABLE const void* payload, CU_NULLABLE struct naive_queue_cell* before,  CU_NULLABLE struct naive_queue_cell* next) {
-	struct naive_queue_cell* result = (struct naive_queue_cell*) malloc(sizeof(struct naive_queue_cell));
-	if (result == NULL) {
-		ERROR_MALLOC();
-	}
+static struct naive_queue_cell* newNaiveQueueCell(CU_NOTNULL naive_queue* q, int evaluation, CU_NULLABLE const void* payload, CU_NULLABLE struct naive_queue_cell* before,  CU_NULLABLE struct naive_queue_cell* next) {
+	struct naive_queue_cell* result = CU_ALLOCATOR_NEW(q->allocator, struct naive_queue_cell);
 
 	result->evaluation = evaluation;
 	result->before = before;
@@ -280,7 +267,32 @@ static struct naive_queue_cell* newNaiveQueueCell(int evaluation, CU_NULLABLE co
 	return result;
 }
 
-static void destroyNaiveQueueCell(CU_NOTNULL const struct naive_queue_cell* nqc, destructor payloadDestructor) {
-	payloadDestructor(nqc->payload, NULL); //TODO context null
-	free((void*)nqc);
+static void destroyNaiveQueueCell(CU_NOTNULL const naive_queue* q, CU_NOTNULL const struct naive_queue_cell* nqc, destructor payloadDestructor, CU_NULLABLE const var_args* context) {
+	payloadDestructor(nqc->payload, context);
+	CU_ALLOCATOR_FREE(q->allocator, struct naive_queue_cell, nqc);
+}
+
+/**
+ * Release every cell of the queue, calling @c payloadDestructor on each payload
+ *
+ * If the allocator of the queue releases its memory in bulk, the cells are not freed one by one and, when there is no payload to destroy either,
+ * the cells are not visited at all
+ *
+ * @param[in] q the queue whose cells we need to release
+ * @param[in] payloadDestructor the function to call on each payload
+ * @param[in] context the context passed to @c payloadDestructor
+ */
+static void releaseNaiveQueueCells(CU_NOTNULL const naive_queue* q, destructor payloadDestructor, CU_NULLABLE const var_args* context) {
+	if (!cuAllocatorReleasesInBulk(q->allocator)) {
+		struct naive_queue_cell* nqc = q->head;
+		while (nqc != NULL) {
+			struct naive_queue_cell* tmp = nqc->next;
+			destroyNaiveQueueCell(q, nqc, payloadDestructor, context);
+			nqc = tmp;
+		}
+	} else if (payloadDestructor != cuDefaultFunctionDestructorNOP) {
+		for (struct naive_queue_cell* nqc=q->head; nqc != NULL; nqc=nqc->next) {
+			payloadDestructor(nqc->payload, context);
+		}
+	}
 }
@@ -18,20 +18,25 @@ Node* newNode(const NodeId id) {
 	return newPredSuccNode(id, NULL, false);
 }
 
-CU_NOTNULL Node* newPredSuccNode(NodeId id, CU_NULLABLE const void* payload, bool predecessorsEnable) {
-	Node* result = (Node*) malloc(sizeof(Node));
-	if (result == NULL) {
-		ERROR_MALLOC();
-	}
+CU_NOTNULL Node* newPredSuccNode(NodeId id, CU_NULLABLE const void* payload, bool predecessorsEnable, CU_NULLABLE cu_allocator* allocator) {
+	Node* result = CU_ALLOCATOR_NEW(allocator, Node);
 
 	result->id = id;
 	result->payload = (void*) payload;
-	result->successors = cuHTNew();
-	result->predecessors = predecessorsEnable ? cuHTNew() : NULL;
+	result->allocator = allocator;
+	result->successors = cuHTNew(cuPayloadFunctionsDefault(), allocator);
+	result->predecessors = predecessorsEnable ? cuHTNew(cuPayloadFunctionsDefault(), allocator) : NULL;
 
 	return result;
 }
 
+CU_DEFINE_DEFAULT_VALUES(newPredSuccNode,
+		,
+		,
+		,
+		NULL
+);
+
 Node* newNodeAuto() {
 	return newNode(autoId++);
 }
@@ -53,7 +58,7 @@ void destroyNodeWithPayload(const Node* node, destructor nodePayloadDestructor,
 	if (node->payload != NULL) {
 		nodePayloadDestructor(node->payload, NULL); //TODO context null
 	}
-	free((void*)node);
+	CU_ALLOCATOR_FREE(node->allocator, Node, node);
 }
 
 EdgeList* getEdgeListOfNode(const Node* source) {
@@ -74,6 +79,10 @@ CU_NOTNULL Edge* addEdgeInNode(CU_NOTNULL Node* restrict source, const CU_NOTNUL
 }
 
 CU_NOTNULL Edge* addEdgeDirectlyInNode(CU_NOTNULL Node* source, const CU_NOTNULL Edge* e) {
+	if (nodeHasPredecessorsActive(e->sink)) {
+		//the previous edge between source and sink (if any) is about to be destroyed: it can't stay among the predecessors of sink
+		cuHTRemoveItem(e->sink->predecessors, source->id);
+	}
 	cuHTRemoveItemWithElement(source->successors, e->sink->id, CU_AS_DESTRUCTOR(destroyEdge));
 	cuHTAddItem(source->successors, e->sink->id, (const void*)e);
 	if (nodeHasPredecessorsActive(e->sink)) {
@@ -86,7 +95,8 @@ CU_NOTNULL Edge* addEdgeDirectlyInNode(CU_NOTNULL Node* source, const CU_NOTNULL
 void removeEdgeInNode(Node* restrict source, Node* restrict sink) {
 	cuHTRemoveItemWithElement(source->successors, sink->id, CU_AS_DESTRUCTOR(destroyEdge));
 	if (nodeHasPredecessorsActive(sink)) {
-		cuHTRemoveItemWithElement(sink->predecessors, source->id, CU_AS_DESTRUCTOR(destroyEdge));
+		//the edge has already been destroyed while removing it from the successors of source
+		cuHTRemoveItem(sink->predecessors, source->id);
 	}
 }
 
@@ -121,11 +131,11 @@ int getHashOfNode(const Node* n) {
 
 
 Node* cloneNode(const Node* n) {
-	return newPredSuccNode(n->id, n->payload, nodeHasPredecessorsActive(n));
+	return newPredSuccNode(n->id, n->payload, nodeHasPredecessorsActive(n), n->allocator);
 }
 
 Node* cloneNodeWithPayload(const Node* n, cloner payloadCloner) {
-	return newPredSuccNode(n->id, payloadCloner(n->payload), nodeHasPredecessorsActive(n));
+	return newPredSuccNode(n->id, payloadCloner(n->payload), nodeHasPredecessorsActive(n), n->allocator);
 }
 
 bool compareNodes(const Node* a, const Node* b, comparator payloadComparator) {
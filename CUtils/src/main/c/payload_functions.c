@@ -69,10 +69,10 @@ payload_functions cuPayloadFunctionsString() {
 	result.destroy = CU_AS_DESTRUCTOR(cuDefaultFunctionDestructorNOP);
 	result.clone = CU_AS_CLONER(cuDefaultFunctionsClonerObject);
 	result.bufferString = CU_AS_BUFFERSTRINGER(cuDefaultFunctionsBufferStringerString);
-	result.order = CU_AS_ORDERER(cuDefaultFunctionsOrdererIntValue);
-	result.compare = CU_AS_COMPARER(cuDefaultFunctionsComparatorIntValue);
-	result.serialize = CU_AS_SERIALIZER(cuDefaultFunctionsSerializerIntValue);
-	result.deserialize = CU_AS_DESERIALIZER(cuDefaultFunctionsDeserializerIntValue);
+	result.order = CU_AS_ORDERER(cuDefaultFunctionsOrdererString);
+	result.compare = CU_AS_COMPARER(cuDefaultFunctionsComparatorString);
+	result.serialize = CU_AS_SERIALIZER(cuDefaultFunctionsSerializerString);
+	result.deserialize = CU_AS_DESERIALIZER(cuDefaultFunctionsDeserializerString);
 
 	return result;
 }
@@ -19,6 +19,7 @@
 #include "dynamic_array.h"
 #include "errors.h"
 #include "string_utils.h"
+#include "cutilsConfig.h"
 
 typedef struct Series {
 	const char* name;
@@ -125,6 +126,49 @@ struct plot_2d_helper {
 	 * If you when we create the actual png plot we will create a CSV containing all the data plotted.
 	 */
 	bool createDataCSVFile;
+	/**
+	 * true if the data file contains doubles rather than text
+	 */
+	bool binaryData;
+	/**
+	 * the values not yet written in the binary data file. NULL if ::plot_2d_helper::binaryData is false
+	 */
+	double* binaryBuffer;
+	/**
+	 * number of values inside ::plot_2d_helper::binaryBuffer
+	 */
+	int binaryBufferSize;
+	/**
+	 * maximum number of buckets used to reduce the points. 0 if the points are not reduced
+	 */
+	int downsamplingBuckets;
+	/**
+	 * number of buckets currently used
+	 */
+	int bucketsNumber;
+	/**
+	 * number of points which are put in each bucket
+	 */
+	long bucketWidth;
+	/**
+	 * number of points already put in the last bucket
+	 */
+	long pointsInLastBucket;
+	/**
+	 * number of points added so far
+	 */
+	long pointsNumber;
+	/**
+	 * The points kept by each bucket
+	 *
+	 * Each bucket contains 2 points per series: the one where the series has its minimum and the one where it has its maximum.
+	 * Each point is the x followed by the y of every series.
+	 */
+	double* bucketPoints;
+	/**
+	 * for each point in ::plot_2d_helper::bucketPoints, the order in which the point has been added
+	 */
+	long* bucketPointsOrder;
 };
 
 static const char* plotStyleToString[] = {
@@ -153,6 +197,12 @@ static void processAxisType(FILE* f, enum axis_type at, char axis);
 static void processTitleAndSubtitle(FILE* f, const plot_2d_helper* helper);
 static void generateDataCSV(const plot_2d_helper* helper, const char* format, ...);
 static payload_functions payloadFunctionsOfSeries();
+static void writeDataRow(plot_2d_helper* helper, double x, const double* ys);
+static void flushBinaryBuffer(plot_2d_helper* helper);
+static bool readDataRow(const plot_2d_helper* helper, FILE* f, double* row);
+static void addPointInBuckets(plot_2d_helper* helper, double x, const double* ys);
+static void mergeBuckets(plot_2d_helper* helper);
+static void writeBuckets(plot_2d_helper* helper);
 
 plot_2d_helper* cuPlot2DHelperNew(const char* output)  {
 	plot_2d_helper* result = CU_MALLOC(plot_2d_helper);
@@ -184,6 +234,16 @@ plot_2d_helper* cuPlot2DHelperNew(const char* output)  {
 	result->subtitle = NULL;
 	result->reduceSubtitleFont = false;
 	result->createDataCSVFile = false;
+	result->binaryData = false;
+	result->binaryBuffer = NULL;
+	result->binaryBufferSize = 0;
+	result->downsamplingBuckets = 0;
+	result->bucketsNumber = 0;
+	result->bucketWidth = 1;
+	result->pointsInLastBucket = 0;
+	result->pointsNumber = 0;
+	result->bucketPoints = NULL;
+	result->bucketPointsOrder = NULL;
 
 	return result;
 }
@@ -206,15 +266,11 @@ void cuPlot2DHelperAddPoint(plot_2d_helper* helper, double x, double y) {
 }
 
 void cuPlot2DHelperAddPoints(plot_2d_helper* helper, double x, double* ys) {
-	fprintf(helper->datFile, "%.3f ", x);
-
-	for (int i=0; i<cuListGetSize(helper->series); i++) {
-		fprintf(helper->datFile, "%.3f", ys[i]);
-		if ((i+1) < cuListGetSize(helper->series)) {
-			fprintf(helper->datFile, " ");
-		}
+	if (helper->downsamplingBuckets > 0) {
+		addPointInBuckets(helper, x, ys);
+	} else {
+		writeDataRow(helper, x, ys);
 	}
-	fprintf(helper->datFile, "\n");
 }
 
 void cuPlot2DHelperSetXAxisType(plot_2d_helper* helper, enum axis_type type) {
@@ -236,6 +292,12 @@ void cuPlot2DHelperPlot(plot_2d_helper* helper) {
 }
 
 void cuPlot2DHelperPlotWith(plot_2d_helper* helper, bool drawAlsoLogarithmScale) {
+	if (helper->downsamplingBuckets > 0) {
+		writeBuckets(helper);
+	}
+	if (helper->binaryData) {
+		flushBinaryBuffer(helper);
+	}
 	fclose(helper->datFile);
 
 	//create the csv file
@@ -274,6 +336,32 @@ void cuPlot2DHelperCreateDataCSV(plot_2d_helper* helper, bool create) {
 	helper->createDataCSVFile = create;
 }
 
+void cuPlot2DHelperSetBinaryData(plot_2d_helper* helper, bool binary) {
+	helper->binaryData = binary;
+	if (binary && helper->binaryBuffer == NULL) {
+		helper->binaryBuffer = malloc(sizeof(double) * CU_PLOT_BUFFER_SIZE);
+		if (helper->binaryBuffer == NULL) {
+			ERROR_MALLOC();
+		}
+		helper->binaryBufferSize = 0;
+	}
+}
+
+void cuPlot2DHelperSetDownsampling(plot_2d_helper* helper, int buckets) {
+	helper->downsamplingBuckets = buckets;
+	if (buckets > 0) {
+		int series = cuListGetSize(helper->series);
+		helper->bucketPoints = realloc(helper->bucketPoints, sizeof(double) * buckets * 2 * series * (series + 1));
+		helper->bucketPointsOrder = realloc(helper->bucketPointsOrder, sizeof(long) * buckets * 2 * series);
+		if (helper->bucketPoints == NULL || helper->bucketPointsOrder == NULL) {
+			ERROR_MALLOC();
+		}
+	}
+	helper->bucketsNumber = 0;
+	helper->bucketWidth = 1;
+	helper->pointsInLastBucket = 0;
+}
+
 void setCommentStartCharacters(plot_2d_helper* helper, const char* strings) {
 	helper->commentCharacters = strings;
 }
@@ -339,6 +427,13 @@ void cuPlot2DHelperDestroy(const plot_2d_helper* plotHelper, CU_NULLABLE const s
 	if (plotHelper->temporaryValues != NULL) {
 		free(plotHelper->temporaryValues);
 	}
+	if (plotHelper->binaryBuffer != NULL) {
+		CU_FREE(plotHelper->binaryBuffer);
+	}
+	if (plotHelper->bucketPoints != NULL) {
+		CU_FREE(plotHelper->bucketPoints);
+		CU_FREE(plotHelper->bucketPointsOrder);
+	}
 	if (plotHelper->title != NULL) {
 		CU_FREE(plotHelper->title);
 	}
@@ -493,25 +588,15 @@ static void generateDataCSV(const plot_2d_helper* helper, const char* format, ..
 	}
 
 	// *************** WRITE CSV DATA ******************
-	double value = -1;
-	int elementsRead = 0;
-	while(true) {
-		//read x
-		elementsRead = fscanf(fin, "%lf%*[ \n\t]", &value);
-		if (elementsRead == EOF) {
-			//reached the end of the input
-			break;
-		}
-		if (elementsRead != 1) {
-			ERROR_IMPOSSIBLE_SCENARIO("file dat is not valid! Read %d elements", elementsRead);
-		}
-		fprintf(fout, "%f, ", value);
+	double* row = malloc(sizeof(double) * (cuListGetSize(helper->series) + 1));
+	if (row == NULL) {
+		ERROR_MALLOC();
+	}
+	while (readDataRow(helper, fin, row)) {
+		fprintf(fout, "%f, ", row[0]);
 
 		for (int series_id=0;  series_id<cuListGetSize(helper->series); series_id++) {
-			//read y value
-			if ((elementsRead = fscanf(fin, "%lf%*[ \n\t]", &value)) != 1) {
-				ERROR_IMPOSSIBLE_SCENARIO("file dat is not valid! Read %d elements", elementsRead);
-			}
+			double value = row[series_id + 1];
 			if (helper->enableCumulativeXAxis) {
 				float oldValue = cuDynamicArrayGetCellValue(temporaryCumulativeValues, series_id, float);
 				float newValue = oldValue + value;
@@ -523,11 +608,13 @@ static void generateDataCSV(const plot_2d_helper* helper, const char* format, ..
 			fprintf(fout, "%s", ((series_id+1) == cuListGetSize(helper->series)) ? "\n" : ", ");
 		}
 	}
+	CU_FREE(row);
 
 	if (helper->enableCumulativeXAxis) {
 		cuDynamicArrayDestroy(temporaryCumulativeValues, NULL); //TODO context null
 	}
 
+	fclose(fin);
 	fclose(fout);
 }
 
@@ -573,7 +660,16 @@ static void generateGnuPlotScript(plot_2d_helper* helper, const char* suffixName
 
 	int i = 0;
 	CU_ITERATE_OVER_LIST(helper->series, cell, s, Series*) {
-		fprintf(gnuPlotFile, "\"%s.dat\" using 1:%d title \"%s\" with %s", helper->fileNameTemplate, (i+2), s->name, getStringOfPlotStyle(s->style));
+		fprintf(gnuPlotFile, "\"%s.dat\"", helper->fileNameTemplate);
+		if (helper->binaryData) {
+			//every row is the x followed by the values of all the series
+			fprintf(gnuPlotFile, " binary format=\"");
+			for (int j=0; j<=cuListGetSize(helper->series); j++) {
+				fprintf(gnuPlotFile, "%%double");
+			}
+			fprintf(gnuPlotFile, "\"");
+		}
+		fprintf(gnuPlotFile, " using 1:%d title \"%s\" with %s", (i+2), s->name, getStringOfPlotStyle(s->style));
 		if ((i+1) < cuListGetSize(helper->series)) {
 			fprintf(gnuPlotFile, ", ");
 		} else {
@@ -584,3 +680,233 @@ static void generateGnuPlotScript(plot_2d_helper* helper, const char* suffixName
 
 	fclose(gnuPlotFile);
 }
+
+/**
+ * Write a point in the data file
+ *
+ * @param[inout] helper the helper involved
+ * @param[in] x the x of the point
+ * @param[in] ys the y of the point in every series
+ */
+static void writeDataRow(plot_2d_helper* helper, double x, const double* ys) {
+	int series = cuListGetSize(helper->series);
+
+	if (!helper->binaryData) {
+		fprintf(helper->datFile, "%.3f ", x);
+
+		for (int i=0; i<series; i++) {
+			fprintf(helper->datFile, "%.3f", ys[i]);
+			if ((i+1) < series) {
+				fprintf(helper->datFile, " ");
+			}
+		}
+		fprintf(helper->datFile, "\n");
+		return;
+	}
+
+	if ((helper->binaryBufferSize + series + 1) > CU_PLOT_BUFFER_SIZE) {
+		flushBinaryBuffer(helper);
+		if ((series + 1) > CU_PLOT_BUFFER_SIZE) {
+			//the row doesn't fit in the buffer at all
+			fwrite(&x, sizeof(double), 1, helper->datFile);
+			fwrite(ys, sizeof(double), series, helper->datFile);
+			return;
+		}
+	}
+	helper->binaryBuffer[helper->binaryBufferSize] = x;
+	memcpy(&helper->binaryBuffer[helper->binaryBufferSize + 1], ys, sizeof(double) * series);
+	helper->binaryBufferSize += series + 1;
+}
+
+/**
+ * Write all the values in ::plot_2d_helper::binaryBuffer in the data file
+ *
+ * @param[inout] helper the helper involved
+ */
+static void flushBinaryBuffer(plot_2d_helper* helper) {
+	if (helper->binaryBufferSize > 0) {
+		if (fwrite(helper->binaryBuffer, sizeof(double), helper->binaryBufferSize, helper->datFile) != helper->binaryBufferSize) {
+			ERROR_FILE(helper->fileNameTemplate);
+		}
+		helper->binaryBufferSize = 0;
+	}
+}
+
+/**
+ * Read a point from the data file
+ *
+ * @param[in] helper the helper involved
+ * @param[inout] f the data file, opened in read mode
+ * @param[out] row an array of series number + 1 cells. It will contain the x followed by the y of every series
+ * @return
+ *  @li true if a point has been read;
+ *  @li false if we have reached the end of the file
+ */
+static bool readDataRow(const plot_2d_helper* helper, FILE* f, double* row) {
+	int series = cuListGetSize(helper->series);
+
+	if (helper->binaryData) {
+		size_t elementsRead = fread(row, sizeof(double), series + 1, f);
+		if (elementsRead == 0) {
+			return false;
+		}
+		if (elementsRead != (series + 1)) {
+			ERROR_IMPOSSIBLE_SCENARIO("file dat is not valid! Read %zu elements", elementsRead);
+		}
+		return true;
+	}
+
+	//read x
+	int elementsRead = fscanf(f, "%lf%*[ \n\t]", &row[0]);
+	if (elementsRead == EOF) {
+		//reached the end of the input
+		return false;
+	}
+	if (elementsRead != 1) {
+		ERROR_IMPOSSIBLE_SCENARIO("file dat is not valid! Read %d elements", elementsRead);
+	}
+	for (int series_id=0;  series_id<series; series_id++) {
+		//read y value
+		if ((elementsRead = fscanf(f, "%lf%*[ \n\t]", &row[series_id + 1])) != 1) {
+			ERROR_IMPOSSIBLE_SCENARIO("file dat is not valid! Read %d elements", elementsRead);
+		}
+	}
+	return true;
+}
+
+/**
+ * Put a point in the last bucket of the downsampler
+ *
+ * If the last bucket is full, a new one is created. If there is no space for a new bucket, the buckets are merged
+ *
+ * @param[inout] helper the helper involved
+ * @param[in] x the x of the point
+ * @param[in] ys the y of the point in every series
+ */
+static void addPointInBuckets(plot_2d_helper* helper, double x, const double* ys) {
+	int series = cuListGetSize(helper->series);
+	int pointSize = series + 1;
+
+	if (helper->bucketsNumber == 0 || helper->pointsInLastBucket == helper->bucketWidth) {
+		if (helper->bucketsNumber == helper->downsamplingBuckets) {
+			mergeBuckets(helper);
+		}
+	}
+	if (helper->bucketsNumber == 0 || helper->pointsInLastBucket == helper->bucketWidth) {
+		//the point is both the minimum and the maximum of every series in the new bucket
+		int bucket = helper->bucketsNumber;
+		for (int i=0; i<(2 * series); i++) {
+			double* point = &helper->bucketPoints[((bucket * 2 * series) + i) * pointSize];
+			point[0] = x;
+			memcpy(&point[1], ys, sizeof(double) * series);
+			helper->bucketPointsOrder[(bucket * 2 * series) + i] = helper->pointsNumber;
+		}
+		helper->bucketsNumber++;
+		helper->pointsInLastBucket = 1;
+		helper->pointsNumber++;
+		return;
+	}
+
+	int bucket = helper->bucketsNumber - 1;
+	for (int s=0; s<series; s++) {
+		double* minimum = &helper->bucketPoints[((bucket * 2 * series) + 2 * s) * pointSize];
+		double* maximum = minimum + pointSize;
+		if (ys[s] < minimum[s + 1]) {
+			minimum[0] = x;
+			memcpy(&minimum[1], ys, sizeof(double) * series);
+			helper->bucketPointsOrder[(bucket * 2 * series) + 2 * s] = helper->pointsNumber;
+		}
+		if (ys[s] > maximum[s + 1]) {
+			maximum[0] = x;
+			memcpy(&maximum[1], ys, sizeof(double) * series);
+			helper->bucketPointsOrder[(bucket * 2 * series) + 2 * s + 1] = helper->pointsNumber;
+		}
+	}
+	helper->pointsInLastBucket++;
+	helper->pointsNumber++;
+}
+
+/**
+ * Merge every couple of adjacent buckets of the downsampler, doubling the width of the buckets
+ *
+ * @param[inout] helper the helper involved
+ */
+static void mergeBuckets(plot_2d_helper* helper) {
+	int series = cuListGetSize(helper->series);
+	int pointSize = series + 1;
+	int bucketPoints = 2 * series;
+
+	for (int b=0; b<(helper->bucketsNumber / 2); b++) {
+		for (int i=0; i<bucketPoints; i++) {
+			int s = i / 2;
+			bool isMaximum = (i % 2) == 1;
+			int first = ((2 * b) * bucketPoints) + i;
+			int second = ((2 * b + 1) * bucketPoints) + i;
+			double firstValue = helper->bucketPoints[first * pointSize + s + 1];
+			double secondValue = helper->bucketPoints[second * pointSize + s + 1];
+			//with the same value we keep the earliest point
+			int source = (isMaximum ? (secondValue > firstValue) : (secondValue < firstValue)) ? second : first;
+			int destination = (b * bucketPoints) + i;
+			if (source != destination) {
+				memcpy(&helper->bucketPoints[destination * pointSize], &helper->bucketPoints[source * pointSize], sizeof(double) * pointSize);
+				helper->bucketPointsOrder[destination] = helper->bucketPointsOrder[source];
+			}
+		}
+	}
+
+	long oldWidth = helper->bucketWidth;
+	helper->bucketWidth *= 2;
+	if ((helper->bucketsNumber % 2) == 1) {
+		//the last bucket has no one to merge with: it still contains the points of the old width
+		int source = (helper->bucketsNumber - 1) * bucketPoints;
+		int destination = (helper->bucketsNumber / 2) * bucketPoints;
+		if (source != destination) {
+			memcpy(&helper->bucketPoints[destination * pointSize], &helper->bucketPoints[source * pointSize], sizeof(double) * pointSize * bucketPoints);
+			memcpy(&helper->bucketPointsOrder[destination], &helper->bucketPointsOrder[source], sizeof(long) * bucketPoints);
+		}
+		helper->pointsInLastBucket = oldWidth;
+		helper->bucketsNumber = helper->bucketsNumber / 2 + 1;
+	} else {
+		helper->pointsInLastBucket = helper->bucketWidth;
+		helper->bucketsNumber = helper->bucketsNumber / 2;
+	}
+}
+
+/**
+ * Write the points kept by the downsampler in the data file, in the order they have been added
+ *
+ * @param[inout] helper the helper involved
+ */
+static void writeBuckets(plot_2d_helper* helper) {
+	int series = cuListGetSize(helper->series);
+	int pointSize = series + 1;
+	int bucketPoints = 2 * series;
+	int* indices = malloc(sizeof(int) * bucketPoints);
+	if (indices == NULL) {
+		ERROR_MALLOC();
+	}
+
+	for (int b=0; b<helper->bucketsNumber; b++) {
+		//sort the points of the bucket by the order they have been added (insertion sort: the points are few)
+		for (int i=0; i<bucketPoints; i++) {
+			int index = (b * bucketPoints) + i;
+			int j = i;
+			while (j > 0 && helper->bucketPointsOrder[indices[j - 1]] > helper->bucketPointsOrder[index]) {
+				indices[j] = indices[j - 1];
+				j--;
+			}
+			indices[j] = index;
+		}
+		for (int i=0; i<bucketPoints; i++) {
+			//the same point may be the minimum or the maximum of several series
+			if (i > 0 && helper->bucketPointsOrder[indices[i]] == helper->bucketPointsOrder[indices[i - 1]]) {
+				continue;
+			}
+			const double* point = &helper->bucketPoints[indices[i] * pointSize];
+			writeDataRow(helper, point[0], &point[1]);
+		}
+	}
+	helper->bucketsNumber = 0;
+
+	CU_FREE(indices);
+}
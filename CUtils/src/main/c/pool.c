@@ -0,0 +1,375 @@
+/**
+ * @file
+ *
+ * The elements of the pool are allocated in chunks. Each element is preceded by a small header used to link it
+ * either in a list of free elements or in the chain of the values added via ::cuPoolAddItem with the same hash.
+ *
+ * There are 2 lists of free elements. The thread owning the pool acquires and releases elements through a plain
+ * singly linked list, without any atomic operation. The other threads release elements by pushing them in a P99 LIFO,
+ * which the owner empties in one shot only when its own list is exhausted. This keeps the common case as cheap as
+ * a pointer swap: the LIFO is lock-free only where P99 has a double-word compare and swap, otherwise it protects its tagged pointers
+ * with a spin lock.
+ *
+ * @author koldar
+ * @date Oct 16, 2026
+ */
+
+#include "pool.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <P99/p99_threads.h>
+#include <P99/p99_lifo.h>
+#include "flat_hashtable.h"
+#include "errors.h"
+
+/**
+ * the alignment of every element of the pool
+ */
+#define POOL_ALIGNMENT 16
+/**
+ * round a size up to the next multiple of ::POOL_ALIGNMENT
+ */
+#define POOL_ALIGN(size) ((((size) + POOL_ALIGNMENT - 1) / POOL_ALIGNMENT) * POOL_ALIGNMENT)
+
+typedef struct pool_element pool_element;
+typedef pool_element* pool_element_ptr;
+
+/**
+ * The header in front of every element of the pool
+ */
+struct pool_element {
+	///the next element in the list of the free elements. The name is required by P99
+	pool_element_ptr p99_lifo;
+	///the next element added via ::cuPoolAddItem whose value has the same hash of this one
+	pool_element* nextSameHash;
+};
+
+P99_LIFO_DECLARE(pool_element_ptr);
+
+/**
+ * A block of contiguous elements
+ */
+struct pool_chunk {
+	///the next chunk of the pool
+	struct pool_chunk* next;
+	///the number of elements in the chunk
+	size_t elements;
+};
+
+/**
+ * the bytes between the start of a chunk and its first element
+ */
+#define POOL_CHUNK_HEADER_SIZE POOL_ALIGN(sizeof(struct pool_chunk))
+/**
+ * the bytes between the start of an element header and the memory given to the user
+ */
+#define POOL_ELEMENT_HEADER_SIZE POOL_ALIGN(sizeof(pool_element))
+
+struct pool {
+	///the free elements released by the owner thread
+	pool_element* localFreeElements;
+	///the free elements released by the other threads
+	P99_LIFO(pool_element_ptr) remoteFreeElements;
+	///the thread which has created the pool
+	pthread_t owner;
+	///the chunks allocated so far
+	struct pool_chunk* chunks;
+	///the minimum number of elements allocated when the pool grows
+	size_t poolSize;
+	///the size of the elements as requested by the user
+	size_t elementSize;
+	///the distance between 2 consecutive elements of the same chunk
+	size_t stride;
+	///number of elements in all the chunks
+	size_t capacity;
+	///number of elements not in ::pool::localFreeElements, including the ones in ::pool::remoteFreeElements
+	size_t inUse;
+	///number of elements released by the other threads not yet removed from ::pool::inUse. Updated atomically
+	size_t remoteReleases;
+	///the maximum value ::cuPoolGetInUse has ever returned after an acquisition
+	size_t highWaterMark;
+	///the hash function used by ::cuPoolAddItem. NULL to hash the bytes of the values
+	hashfunction_t hashFunction;
+	///maps the hash of each value added via ::cuPoolAddItem to the first element having that hash. NULL if no value has ever been added
+	flat_ht* items;
+};
+
+static void growPool(CU_NOTNULL struct pool* p, size_t elements);
+static pool_element* fetchRemoteElements(CU_NOTNULL struct pool* p);
+static void* getElementData(CU_NOTNULL const pool_element* element);
+static pool_element* getElementHeader(CU_NOTNULL const void* data);
+static unsigned long hashItem(CU_NOTNULL const struct pool* p, CU_NOTNULL const void* item, CU_NULLABLE const struct var_args* context);
+static pool_element* findItem(CU_NOTNULL const struct pool* p, CU_NOTNULL const void* item, unsigned long hash, CU_NULLABLE pool_element** previous);
+
+struct pool* _cuPoolNew(int poolSize, size_t elementSize, CU_NULLABLE hashfunction_t hashFunction) {
+	if (poolSize <= 0) {
+		ERROR_ON_CONSTRUCTION("pool", "pool size %d", poolSize);
+	}
+
+	struct pool* result = CU_MALLOC(struct pool);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+
+	result->localFreeElements = NULL;
+	p99_lifo_init(&result->remoteFreeElements, NULL);
+	result->owner = pthread_self();
+	result->chunks = NULL;
+	result->poolSize = poolSize;
+	result->elementSize = elementSize;
+	result->stride = POOL_ELEMENT_HEADER_SIZE + POOL_ALIGN(elementSize > 0 ? elementSize : 1);
+	result->capacity = 0;
+	result->inUse = 0;
+	result->remoteReleases = 0;
+	result->highWaterMark = 0;
+	result->hashFunction = hashFunction;
+	result->items = NULL;
+
+	return result;
+}
+
+void cuPoolDestroy(CU_NOTNULL const struct pool* p, CU_NULLABLE const struct var_args* context) {
+	struct pool_chunk* chunk = p->chunks;
+	while (chunk != NULL) {
+		struct pool_chunk* next = chunk->next;
+		CU_FREE(chunk);
+		chunk = next;
+	}
+	if (p->items != NULL) {
+		cuFlatHTDestroy(p->items, context);
+	}
+	CU_FREE(p);
+}
+
+void* cuPoolAcquire(CU_NOTNULL struct pool* p) {
+	pool_element* element = p->localFreeElements;
+	if (element == NULL) {
+		element = fetchRemoteElements(p);
+	}
+	if (element == NULL) {
+		growPool(p, p->capacity > p->poolSize ? p->capacity : p->poolSize);
+		element = p->localFreeElements;
+	}
+
+	p->localFreeElements = element->p99_lifo;
+	p->inUse++;
+	//::pool::inUse overestimates the elements in use, so the atomic read is needed only when it exceeds the mark
+	if (p->inUse > p->highWaterMark) {
+		size_t inUse = cuPoolGetInUse(p);
+		if (inUse > p->highWaterMark) {
+			p->highWaterMark = inUse;
+		}
+	}
+	return getElementData(element);
+}
+
+void cuPoolRelease(CU_NOTNULL struct pool* p, CU_NOTNULL const void* element) {
+	pool_element* header = getElementHeader(element);
+	if (pthread_equal(pthread_self(), p->owner)) {
+		header->p99_lifo = p->localFreeElements;
+		p->localFreeElements = header;
+		p->inUse--;
+	} else {
+		//count before pushing, so that the owner never fetches an element not counted yet
+		__sync_add_and_fetch(&p->remoteReleases, 1);
+		P99_LIFO_PUSH(&p->remoteFreeElements, header);
+	}
+}
+
+void cuPoolReserve(CU_NOTNULL struct pool* p, size_t elements) {
+	size_t freeElements = p->capacity - cuPoolGetInUse(p);
+	if (freeElements < elements) {
+		growPool(p, elements - freeElements);
+	}
+}
+
+void* cuPoolAddItem(CU_NOTNULL struct pool* p, CU_NOTNULL const void* item, CU_NULLABLE const struct var_args* context) {
+	unsigned long hash = hashItem(p, item, context);
+	pool_element* result = findItem(p, item, hash, NULL);
+	if (result != NULL) {
+		return getElementData(result);
+	}
+
+	if (p->items == NULL) {
+		p->items = cuFlatHTNew();
+	}
+	void* data = cuPoolAcquire(p);
+	memcpy(data, item, p->elementSize);
+	result = getElementHeader(data);
+	result->nextSameHash = cuFlatHTGetItem(p->items, hash);
+	cuFlatHTAddOrUpdateItem(p->items, hash, result);
+
+	return data;
+}
+
+bool cuPoolHasItem(CU_NOTNULL const struct pool* p, CU_NOTNULL const void* item, CU_NULLABLE const struct var_args* context) {
+	return findItem(p, item, hashItem(p, item, context), NULL) != NULL;
+}
+
+bool cuPoolRemoveItem(CU_NOTNULL struct pool* p, CU_NOTNULL const void* item, CU_NULLABLE const struct var_args* context) {
+	unsigned long hash = hashItem(p, item, context);
+	pool_element* previous = NULL;
+	pool_element* element = findItem(p, item, hash, &previous);
+	if (element == NULL) {
+		return false;
+	}
+
+	if (previous != NULL) {
+		previous->nextSameHash = element->nextSameHash;
+	} else if (element->nextSameHash != NULL) {
+		cuFlatHTUpdateItem(p->items, hash, element->nextSameHash);
+	} else {
+		cuFlatHTRemoveItem(p->items, hash);
+	}
+	cuPoolRelease(p, getElementData(element));
+	return true;
+}
+
+void cuPoolClear(CU_NOTNULL struct pool* p) {
+	P99_LIFO_CLEAR(&p->remoteFreeElements);
+	p->localFreeElements = NULL;
+	for (struct pool_chunk* chunk = p->chunks; chunk != NULL; chunk = chunk->next) {
+		char* first = ((char*)chunk) + POOL_CHUNK_HEADER_SIZE;
+		for (size_t i=chunk->elements; i>0; i--) {
+			pool_element* element = (pool_element*)(first + (i - 1) * p->stride);
+			element->p99_lifo = p->localFreeElements;
+			p->localFreeElements = element;
+		}
+	}
+	if (p->items != NULL) {
+		cuFlatHTClear(p->items);
+	}
+	p->inUse = 0;
+	p->remoteReleases = 0;
+	p->highWaterMark = 0;
+}
+
+size_t cuPoolGetElementSize(CU_NOTNULL const struct pool* p) {
+	return p->elementSize;
+}
+
+size_t cuPoolGetCapacity(CU_NOTNULL const struct pool* p) {
+	return p->capacity;
+}
+
+size_t cuPoolGetInUse(CU_NOTNULL const struct pool* p) {
+	return p->inUse - __sync_add_and_fetch((size_t*)&p->remoteReleases, 0);
+}
+
+size_t cuPoolGetHighWaterMark(CU_NOTNULL const struct pool* p) {
+	return p->highWaterMark;
+}
+
+/**
+ * Allocate a new chunk and put all its elements in the list of the free elements of the owner
+ *
+ * @param[inout] p the pool involved
+ * @param[in] elements the number of elements of the new chunk
+ */
+static void growPool(CU_NOTNULL struct pool* p, size_t elements) {
+	struct pool_chunk* chunk = malloc(POOL_CHUNK_HEADER_SIZE + elements * p->stride);
+	if (chunk == NULL) {
+		ERROR_MALLOC();
+	}
+	chunk->elements = elements;
+	chunk->next = p->chunks;
+	p->chunks = chunk;
+	p->capacity += elements;
+
+	//push in reverse order so that the elements are acquired in address order
+	char* first = ((char*)chunk) + POOL_CHUNK_HEADER_SIZE;
+	for (size_t i=elements; i>0; i--) {
+		pool_element* element = (pool_element*)(first + (i - 1) * p->stride);
+		element->p99_lifo = p->localFreeElements;
+		p->localFreeElements = element;
+	}
+}
+
+/**
+ * Move the elements released by the other threads in the list of the free elements of the owner
+ *
+ * @param[inout] p the pool involved
+ * @return the first free element of the owner or NULL if no thread has released any element
+ */
+static pool_element* fetchRemoteElements(CU_NOTNULL struct pool* p) {
+	pool_element* result = P99_LIFO_CLEAR(&p->remoteFreeElements);
+	size_t fetched = 0;
+	pool_element* last = NULL;
+	for (pool_element* element = result; element != NULL; element = element->p99_lifo) {
+		last = element;
+		fetched++;
+	}
+	if (last != NULL) {
+		last->p99_lifo = p->localFreeElements;
+		p->localFreeElements = result;
+		p->inUse -= fetched;
+		__sync_sub_and_fetch(&p->remoteReleases, fetched);
+	}
+	return p->localFreeElements;
+}
+
+/**
+ * @param[in] element the header of an element
+ * @return the memory of the element given to the user
+ */
+static void* getElementData(CU_NOTNULL const pool_element* element) {
+	return ((char*)element) + POOL_ELEMENT_HEADER_SIZE;
+}
+
+/**
+ * @param[in] data the memory of an element given to the user
+ * @return the header of the element
+ */
+static pool_element* getElementHeader(CU_NOTNULL const void* data) {
+	return (pool_element*)(((char*)data) - POOL_ELEMENT_HEADER_SIZE);
+}
+
+/**
+ * Hash a value with the hash function of the pool, or with FNV-1a on its bytes if the pool has none
+ *
+ * @param[in] p the pool involved
+ * @param[in] item the value to hash
+ * @param[in] context passed to the hash function
+ * @return the hash of @c item
+ */
+static unsigned long hashItem(CU_NOTNULL const struct pool* p, CU_NOTNULL const void* item, CU_NULLABLE const struct var_args* context) {
+	if (p->hashFunction != NULL) {
+		return p->hashFunction(item, context);
+	}
+
+	unsigned long result = 2166136261UL;
+	const unsigned char* bytes = item;
+	for (size_t i=0; i<p->elementSize; i++) {
+		result = (result ^ bytes[i]) * 16777619UL;
+	}
+	return result;
+}
+
+/**
+ * Look for a value added via ::cuPoolAddItem
+ *
+ * @param[in] p the pool involved
+ * @param[in] item the value to look for
+ * @param[in] hash the hash of @c item
+ * @param[out] previous if not NULL, the element before the one found in the chain of the elements with hash @c hash.
+ * 	NULL if the element found is the first one of the chain
+ * @return the element containing a value equal to @c item or NULL if there is none
+ */
+static pool_element* findItem(CU_NOTNULL const struct pool* p, CU_NOTNULL const void* item, unsigned long hash, CU_NULLABLE pool_element** previous) {
+	if (p->items == NULL) {
+		return NULL;
+	}
+
+	pool_element* before = NULL;
+	for (pool_element* element = cuFlatHTGetItem(p->items, hash); element != NULL; element = element->nextSameHash) {
+		if (memcmp(getElementData(element), item, p->elementSize) == 0) {
+			if (previous != NULL) {
+				*previous = before;
+			}
+			return element;
+		}
+		before = element;
+	}
+	return NULL;
+}
@@ -23,18 +23,20 @@ static bool _getFirstNodeWhichIsNotDescendantOf(CU_NOTNULL const PredSuccGraph*
 CU_DEFINE_DEFAULT_VALUES(cuPredSuccGraphNew,
 		false,
 		cuPayloadFunctionsDefault(),
-		cuPayloadFunctionsDefault()
+		cuPayloadFunctionsDefault(),
+		NULL
 );
 
 
-PredSuccGraph* cuPredSuccGraphNew(bool enablePredecessors, payload_functions vertexPayload, payload_functions edgePayload) {
+PredSuccGraph* cuPredSuccGraphNew(bool enablePredecessors, payload_functions vertexPayload, payload_functions edgePayload, CU_NULLABLE cu_allocator* allocator) {
 	PredSuccGraph* retVal = (PredSuccGraph*) malloc(sizeof(PredSuccGraph));
 	if (retVal == NULL) {
 		ERROR_MALLOC();
 	}
 	retVal->size = 0;
-	retVal->nodes = cuHTNew();
+	retVal->nodes = cuHTNew(cuPayloadFunctionsDefault(), allocator);
 	retVal->enablePredecessors = enablePredecessors;
+	retVal->allocator = allocator;
 
 	retVal->nodeFunctions = vertexPayload;
 	retVal->edgeFunctions = edgePayload;
@@ -70,7 +72,7 @@ void cuPredSuccGraphDestroyWithElements(const PredSuccGraph* g, CU_NULLABLE cons
 }
 
 PredSuccGraph* cuPredSuccGraphClone(CU_NOTNULL const PredSuccGraph* graph) {
-	PredSuccGraph* cloned = cuPredSuccGraphNew();
+	PredSuccGraph* cloned = cuPredSuccGraphNew(graph->enablePredecessors, graph->nodeFunctions, graph->edgeFunctions, graph->allocator);
 	Node* source = NULL;
 	Node* sink = NULL;
 
@@ -83,7 +85,7 @@ PredSuccGraph* cuPredSuccGraphClone(CU_NOTNULL const PredSuccGraph* graph) {
 		if (source == NULL) {
 			ERROR_OBJECT_NOT_FOUND("node", "%ld", nodeId);
 		}
-		_cuPredSuccGraphAddVertexInstanceInGraph(cloned, newPredSuccNode(nodeId, graph->nodeFunctions.clone(source->payload), graph->enablePredecessors));
+		_cuPredSuccGraphAddVertexInstanceInGraph(cloned, newPredSuccNode(nodeId, graph->nodeFunctions.clone(source->payload), graph->enablePredecessors, cloned->allocator));
 	}
 	debug("done");
 
@@ -124,7 +126,7 @@ void _cuPredSuccGraphAddVertexInstanceInGraph(CU_NOTNULL PredSuccGraph* g, CU_NO
 }
 
 CU_NOTNULL Node* cuPredSuccGraphAddNodeInGraphById(CU_NOTNULL PredSuccGraph* g, NodeId id, CU_NULLABLE const void* payload) {
-	Node* n = newPredSuccNode(id, payload, g->enablePredecessors);
+	Node* n = newPredSuccNode(id, payload, g->enablePredecessors, g->allocator);
 	_cuPredSuccGraphAddVertexInstanceInGraph(g, n);
 	return n;
 }
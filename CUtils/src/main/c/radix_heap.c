@@ -0,0 +1,260 @@
+/*
+ * radix_heap.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: koldar
+ */
+
+#include "radix_heap.h"
+#include <stdlib.h>
+#include <limits.h>
+#include "errors.h"
+
+/**
+ * number of buckets: one for the items equal to the last extracted one and one per bit of the evaluations
+ */
+#define RADIX_HEAP_BUCKETS (sizeof(unsigned int) * CHAR_BIT + 1)
+
+/**
+ * the capacity of a bucket when the first item is added in it
+ */
+#define RADIX_HEAP_BUCKET_INITIAL_CAPACITY 8
+
+struct radix_heap_item {
+	///the evaluation of the item, mapped to an unsigned value preserving the order. See ::toKey
+	unsigned int key;
+	void* payload;
+};
+
+struct radix_heap_bucket {
+	struct radix_heap_item* items;
+	int size;
+	int capacity;
+};
+
+struct radix_heap {
+	struct radix_heap_bucket buckets[RADIX_HEAP_BUCKETS];
+	///the key of the last item peeked or popped. Every key in the queue is not less than this
+	unsigned int last;
+	int size;
+	payload_functions functions;
+	evaluator_function f;
+	const var_args* va;
+};
+
+static unsigned int toKey(int evaluation);
+static int toEvaluation(unsigned int key);
+static int getBucketIndex(unsigned int key, unsigned int last);
+static void pushInBucket(CU_NOTNULL struct radix_heap_bucket* bucket, unsigned int key, CU_NULLABLE const void* payload);
+static void refillFirstBucket(CU_NOTNULL radix_heap* h);
+static void clearRadixHeap(CU_NOTNULL radix_heap* h, bool destroyPayloads);
+
+radix_heap* cuRadixHeapNew(payload_functions functions, CU_NULLABLE evaluator_function f, CU_NULLABLE const var_args* va) {
+	radix_heap* retVal = CU_MALLOC(radix_heap);
+	if (retVal == NULL) {
+		ERROR_MALLOC();
+	}
+
+	for (int i=0; i<RADIX_HEAP_BUCKETS; i++) {
+		retVal->buckets[i].items = NULL;
+		retVal->buckets[i].size = 0;
+		retVal->buckets[i].capacity = 0;
+	}
+	retVal->last = 0;
+	retVal->size = 0;
+	retVal->functions = functions;
+	retVal->f = f;
+	retVal->va = va;
+
+	return retVal;
+}
+
+CU_DEFINE_DEFAULT_VALUES(cuRadixHeapNew,
+		,
+		NULL,
+		NULL
+);
+
+void cuRadixHeapDestroy(CU_NOTNULL const radix_heap* h, CU_NULLABLE const struct var_args* context) {
+	for (int i=0; i<RADIX_HEAP_BUCKETS; i++) {
+		CU_FREE(h->buckets[i].items);
+	}
+	CU_FREE(h);
+}
+
+void cuRadixHeapDestroyWithElements(CU_NOTNULL const radix_heap* h, CU_NULLABLE const struct var_args* context) {
+	for (int i=0; i<RADIX_HEAP_BUCKETS; i++) {
+		for (int j=0; j<h->buckets[i].size; j++) {
+			h->functions.destroy(h->buckets[i].items[j].payload, context);
+		}
+	}
+	cuRadixHeapDestroy(h, context);
+}
+
+void cuRadixHeapAddItem(CU_NOTNULL radix_heap* h, CU_NULLABLE const void* el) {
+	if (h->f == NULL) {
+		ERROR_NULL("radix heap evaluator function");
+	}
+	cuRadixHeapAddItemWithEvaluation(h, el, h->f(el, h->va));
+}
+
+void cuRadixHeapAddItemWithEvaluation(CU_NOTNULL radix_heap* h, CU_NULLABLE const void* el, int evaluation) {
+	unsigned int key = toKey(evaluation);
+	if (key < h->last) {
+		ERROR_ON_APPLICATION("evaluation", "%d", evaluation, "radix heap whose last extracted evaluation is", "%d", toEvaluation(h->last));
+	}
+	pushInBucket(&h->buckets[getBucketIndex(key, h->last)], key, el);
+	h->size += 1;
+}
+
+CU_NULLABLE void* _cuRadixHeapPeekItem(CU_NOTNULL const radix_heap* h) {
+	if (h->size == 0) {
+		return NULL;
+	}
+	//the content of the queue does not change: only its internal layout does
+	refillFirstBucket((radix_heap*)h);
+	const struct radix_heap_bucket* first = &h->buckets[0];
+	return first->items[first->size - 1].payload;
+}
+
+CU_NULLABLE void* _cuRadixHeapPopItem(CU_NOTNULL radix_heap* h) {
+	if (h->size == 0) {
+		return NULL;
+	}
+	refillFirstBucket(h);
+	struct radix_heap_bucket* first = &h->buckets[0];
+	first->size -= 1;
+	h->size -= 1;
+	return first->items[first->size].payload;
+}
+
+int cuRadixHeapPeekEvaluation(CU_NOTNULL const radix_heap* h) {
+	if (h->size == 0) {
+		ERROR_OBJECT_IS_EMPTY("radix heap", "%p", h);
+	}
+	refillFirstBucket((radix_heap*)h);
+	return toEvaluation(h->last);
+}
+
+bool cuRadixHeapIsEmpty(CU_NOTNULL const radix_heap* h) {
+	return h->size == 0;
+}
+
+int cuRadixHeapGetSize(CU_NOTNULL const radix_heap* h) {
+	return h->size;
+}
+
+void cuRadixHeapClear(CU_NOTNULL radix_heap* h) {
+	clearRadixHeap(h, false);
+}
+
+void cuRadixHeapClearWithElements(CU_NOTNULL radix_heap* h) {
+	clearRadixHeap(h, true);
+}
+
+/**
+ * Map an evaluation to an unsigned integer such that the order is preserved
+ *
+ * @param[in] evaluation the evaluation to convert
+ * @return the key of the evaluation. ::INT_MIN is mapped to 0
+ */
+static unsigned int toKey(int evaluation) {
+	return ((unsigned int) evaluation) ^ (1U << (sizeof(unsigned int) * CHAR_BIT - 1));
+}
+
+/**
+ * The inverse of ::toKey
+ *
+ * @param[in] key the key to convert
+ * @return the evaluation of the key
+ */
+static int toEvaluation(unsigned int key) {
+	return (int) (key ^ (1U << (sizeof(unsigned int) * CHAR_BIT - 1)));
+}
+
+/**
+ * @param[in] key the key of an item
+ * @param[in] last the key of the last item extracted
+ * @return
+ *  @li 0 if @c key is equal to @c last;
+ *  @li the position (starting from 1) of the most significant bit where @c key and @c last differ otherwise
+ */
+static int getBucketIndex(unsigned int key, unsigned int last) {
+	return key == last ? 0 : (int)(sizeof(unsigned int) * CHAR_BIT) - __builtin_clz(key ^ last);
+}
+
+/**
+ * Append an item at the end of a bucket
+ *
+ * @param[inout] bucket the bucket to alter
+ * @param[in] key the key of the item
+ * @param[in] payload the item to add
+ */
+static void pushInBucket(CU_NOTNULL struct radix_heap_bucket* bucket, unsigned int key, CU_NULLABLE const void* payload) {
+	if (bucket->size == bucket->capacity) {
+		bucket->capacity = bucket->capacity == 0 ? RADIX_HEAP_BUCKET_INITIAL_CAPACITY : 2 * bucket->capacity;
+		bucket->items = realloc(bucket->items, sizeof(struct radix_heap_item) * bucket->capacity);
+		if (bucket->items == NULL) {
+			ERROR_MALLOC();
+		}
+	}
+	bucket->items[bucket->size].key = key;
+	bucket->items[bucket->size].payload = (void*) payload;
+	bucket->size += 1;
+}
+
+/**
+ * Ensure the bucket 0 contains the items with the minimum evaluation
+ *
+ * If bucket 0 is empty, we pick the first non empty bucket, we set ::radix_heap::last to its minimum key and we
+ * redistribute its items. Since all its items share the bits more significant than its index with the new minimum,
+ * each of them goes in a bucket with a lower index.
+ *
+ * @pre
+ *  @li @c h not empty
+ *
+ * @param[inout] h the queue involved
+ */
+static void refillFirstBucket(CU_NOTNULL radix_heap* h) {
+	if (h->buckets[0].size > 0) {
+		return;
+	}
+
+	int i = 1;
+	while (h->buckets[i].size == 0) {
+		i++;
+	}
+	struct radix_heap_bucket* bucket = &h->buckets[i];
+
+	unsigned int min = bucket->items[0].key;
+	for (int j=1; j<bucket->size; j++) {
+		if (bucket->items[j].key < min) {
+			min = bucket->items[j].key;
+		}
+	}
+	h->last = min;
+
+	for (int j=0; j<bucket->size; j++) {
+		pushInBucket(&h->buckets[getBucketIndex(bucket->items[j].key, min)], bucket->items[j].key, bucket->items[j].payload);
+	}
+	bucket->size = 0;
+}
+
+/**
+ * Remove all the items from the queue
+ *
+ * @param[inout] h the queue involved
+ * @param[in] destroyPayloads if true, we release the items from the memory as well
+ */
+static void clearRadixHeap(CU_NOTNULL radix_heap* h, bool destroyPayloads) {
+	for (int i=0; i<RADIX_HEAP_BUCKETS; i++) {
+		if (destroyPayloads) {
+			for (int j=0; j<h->buckets[i].size; j++) {
+				h->functions.destroy(h->buckets[i].items[j].payload, NULL);
+			}
+		}
+		h->buckets[i].size = 0;
+	}
+	h->last = 0;
+	h->size = 0;
+}
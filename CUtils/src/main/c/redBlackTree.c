@@ -12,6 +12,7 @@
 #include "log.h"
 #include "errors.h"
 #include "var_args.h"
+#include "allocator.h"
 
 typedef enum {
 	RED,
@@ -36,6 +37,8 @@ struct rb_tree {
 	 * Set of functions to easily manage the payload of the red black tree
 	 */
 	payload_functions functions;
+	///where the nodes of the tree are allocated. NULL means malloc
+	cu_allocator* allocator;
 };
 
 /**
@@ -55,10 +58,10 @@ static rb_node _NIL = {NULL, NULL, NULL, BLACK, NULL};
  */
 static rb_node* NIL = &_NIL;
 
-static rb_node* newRedBlackNode(CU_NULLABLE const void* payload);
+static rb_node* newRedBlackNode(CU_NOTNULL rb_tree* tree, CU_NULLABLE const void* payload);
 static void leftRotate(CU_NOTNULL rb_tree* tree, CU_NOTNULL rb_node* y);
 static void rightRotate(CU_NOTNULL rb_tree* tree, CU_NOTNULL rb_node* y);
-static void destroyRedBlackNode(CU_NOTNULL rb_node* n, bool withElements, CU_NULLABLE destructor d);
+static void destroyRedBlackNode(CU_NOTNULL const rb_tree* tree, CU_NOTNULL rb_node* n, bool withElements, CU_NULLABLE destructor d);
 static void redBlackInsertFixUp(CU_NOTNULL rb_tree* tree, CU_NOTNULL rb_node* z);
 static void redBlackTransplant(CU_NOTNULL rb_tree* tree, CU_NOTNULL rb_node* replaced, CU_NOTNULL rb_node* replacer);
 static rb_node* getMinimumInRedBlackNode(CU_NOTNULL rb_node* n);
@@ -66,13 +69,14 @@ static void redBlackDeleteFixUp(CU_NOTNULL rb_tree* tree, CU_NOTNULL rb_node* x)
 static bool _removeItemInRedBlackTree(CU_NOTNULL rb_tree* tree, CU_NULLABLE void* payload, bool withElement);
 static rb_node* getMaximumInRedBlackNode(CU_NOTNULL rb_node* n);
 
-rb_tree* cuRedBlackTreeNew(payload_functions functions) {
+rb_tree* cuRedBlackTreeNew(payload_functions functions, CU_NULLABLE cu_allocator* allocator) {
 	rb_tree* retVal = CU_MALLOC(rb_tree);
 	if (retVal == NULL) {
 		ERROR_MALLOC();
 	}
 
 	retVal->functions = functions;
+	retVal->allocator = allocator;
 
 	retVal->root = NIL;
 	retVal->size = 0;
@@ -80,36 +84,43 @@ rb_tree* cuRedBlackTreeNew(payload_functions functions) {
 	return retVal;
 }
 
+CU_DEFINE_DEFAULT_VALUES(cuRedBlackTreeNew,
+		,
+		NULL
+);
+
 void cuRedBlackTreeDestroy(CU_NOTNULL const rb_tree* tree, CU_NULLABLE const struct var_args* context) {
-	destroyRedBlackNode(tree->root, false, NULL);
+	if (!cuAllocatorReleasesInBulk(tree->allocator)) {
+		destroyRedBlackNode(tree, tree->root, false, NULL);
+	}
 	CU_FREE(tree);
 }
 
 void cuRedBlackTreeDestroyWithElements(CU_NOTNULL const rb_tree* tree, CU_NULLABLE const struct var_args* context) {
-	destroyRedBlackNode(tree->root, true, tree->functions.destroy);
+	destroyRedBlackNode(tree, tree->root, true, tree->functions.destroy);
 	CU_FREE(tree);
 }
 
-static void destroyRedBlackNode(CU_NOTNULL rb_node* n, bool withElements, CU_NULLABLE destructor d) {
+static void destroyRedBlackNode(CU_NOTNULL const rb_tree* tree, CU_NOTNULL rb_node* n, bool withElements, CU_NULLABLE destructor d) {
 	if (n == NIL) {
 		return;
 	}
 	if (n->left != NIL) {
-		destroyRedBlackNode(n->left, withElements, d);
+		destroyRedBlackNode(tree, n->left, withElements, d);
 	}
 	if (n->right != NIL) {
-		destroyRedBlackNode(n->right, withElements, d);
+		destroyRedBlackNode(tree, n->right, withElements, d);
 	}
 	if (withElements) {
 		d(n->payload, NULL); //TODO context null
 	}
-	CU_FREE(n);
+	CU_ALLOCATOR_FREE(tree->allocator, rb_node, n);
 }
 
 bool cuRedBlackTreeAddItem(CU_NOTNULL rb_tree* tree, CU_NULLABLE void* payload) {
 	rb_node* x = tree->root;
 	rb_node* y = NIL;
-	rb_node* z = newRedBlackNode(payload);
+	rb_node* z = newRedBlackNode(tree, payload);
 	while (x != NIL) {
 		y = x;
 		if (tree->functions.order(z->payload, y->payload) < 0) {
@@ -241,7 +252,7 @@ static bool _removeItemInRedBlackTree(CU_NOTNULL rb_tree* tree, CU_NULLABLE void
 	if (withElement) {
 		tree->functions.destroy(z->payload, NULL);
 	}
-	free(z);
+	CU_ALLOCATOR_FREE(tree->allocator, rb_node, z);
 
 	tree->size--;
 	return true;
@@ -281,7 +292,7 @@ static void redBlackDeleteFixUp(CU_NOTNULL rb_tree* tree, CU_NOTNULL rb_node* x)
 			if (w->color == RED) {
 				w->color = BLACK;
 				x->parent->color = RED;
-				leftRotate(tree, x->parent);
+				rightRotate(tree, x->parent);
 				w = x->parent->left;
 			}
 			if (w->right->color == BLACK && w->left->color == BLACK) {
@@ -499,11 +510,8 @@ static void rightRotate(CU_NOTNULL rb_tree* tree, CU_NOTNULL rb_node* y) {
 	y->parent = x;
 }
 
-static rb_node* newRedBlackNode(CU_NULLABLE const void* payload) {
-	rb_node* retVal = malloc(sizeof(rb_node));
-	if (retVal == NULL) {
-		ERROR_MALLOC();
-	}
+static rb_node* newRedBlackNode(CU_NOTNULL rb_tree* tree, CU_NULLABLE const void* payload) {
+	rb_node* retVal = CU_ALLOCATOR_NEW(tree->allocator, rb_node);
 
 	retVal->left = NIL;
 	retVal->right = NIL;
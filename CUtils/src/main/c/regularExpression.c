@@ -11,54 +11,85 @@
 #include "macros.h"
 #include "log.h"
 #include <string.h>
+#include <pthread.h>
 #include "errors.h"
+#include "defaultFunctions.h"
+#include "flat_hashtable.h"
+
+/**
+ * the number of groups ::cuRegularExpressionApply can handle without allocating memory
+ */
+#define REGEX_STACK_GROUPS 16
+
+struct cu_regex {
+	///the compiled regex
+	regex_t compiled;
+	///the string the regex has been compiled from
+	char* pattern;
+	///hash of ::cu_regex::pattern
+	unsigned long hash;
+	///number of handles referring to this regex, including the one of the cache
+	int references;
+	///the regex used just more recently than this one. NULL if this is the most recent one or if it is not in the cache
+	struct cu_regex* moreRecent;
+	///the regex used just less recently than this one. NULL if this is the least recent one or if it is not in the cache
+	struct cu_regex* lessRecent;
+	///the next regex in the cache whose pattern has the same hash of this one
+	struct cu_regex* nextSameHash;
+};
+
+/**
+ * The cache of ::cuRegularExpressionCacheGet
+ */
+static struct {
+	///protects all the other fields
+	pthread_mutex_t mutex;
+	///maps the hash of a pattern to the first regex in the cache with such hash. NULL if the cache has never been used
+	flat_ht* regexes;
+	///the regex used most recently
+	cu_regex* mostRecent;
+	///the regex used least recently. The next one to be evicted
+	cu_regex* leastRecent;
+	///number of regexes in the cache
+	size_t size;
+	///the maximum value of ::cache::size
+	size_t capacity;
+	unsigned long hits;
+	unsigned long misses;
+} cache = {PTHREAD_MUTEX_INITIALIZER, NULL, NULL, NULL, 0, CU_REGEX_CACHE_DEFAULT_CAPACITY, 0, 0};
 
 static int compileRegex(regex_t* regex, const char* regexString);
 static int executeRegex(regex_t* regex, const char* regexString, const char* testString, regmatch_t* capturingGroups, int capturingGroupsSize);
 static bool hasMatched(int reti);
-static bool hasNotMatched(int reti);
 static void destroyRegex(regex_t* regex, CU_NULLABLE const struct var_args* context);
 static char const *const getGroup(const char* testString, regmatch_t* groups, int groupNumber);
+static void markAsMostRecent(CU_NOTNULL cu_regex* regex);
+static void unlinkFromRecents(CU_NOTNULL cu_regex* regex);
+static void evictFromCache(CU_NOTNULL cu_regex* regex);
 
 bool cuRegularExpressionIsSatisfying(const char* restrict string, const char* restrict regex) {
-	regex_t regexSupport;
-	regmatch_t groups[2];
-	int reti;
-	char* size;
-	bool retVal;
-
-	compileRegex(&regexSupport, regex);
-	reti = executeRegex(&regexSupport, regex, string, NULL, 0);
-	if (hasMatched(reti)) {
-		retVal = true;
-	} else {
-		retVal = false;
-	}
-	destroyRegex(&regexSupport, NULL); //TODO context null
+	cu_regex* compiled = cuRegularExpressionCacheGet(regex);
+	bool retVal = cuRegularExpressionExecute(compiled, string, 0, NULL);
+	cuRegularExpressionDestroy(compiled, NULL);
 	return retVal;
 }
+
 bool cuRegularExpressionApply(const char* restrict string, const char* restrict regex, int groupSize, char const *const * * groups) {
-	int reti;
-	regex_t regexSupport;
-	regmatch_t* groupsSupport;
-	char size;
+	regmatch_t stackGroups[REGEX_STACK_GROUPS];
+	regmatch_t* groupsSupport = stackGroups;
 	bool retVal;
-	reti = compileRegex(&regexSupport, regex);
-	if (reti != 0) {
-		retVal = false;
-		return false;
-	}
 
-	groupsSupport = calloc(sizeof(regmatch_t), (groupSize + 1));
-	if (groupsSupport == NULL) {
-		ERROR_MALLOC();
+	cu_regex* compiled = cuRegularExpressionCacheGet(regex);
+	if ((groupSize + 1) > REGEX_STACK_GROUPS) {
+		groupsSupport = calloc(sizeof(regmatch_t), (groupSize + 1));
+		if (groupsSupport == NULL) {
+			ERROR_MALLOC();
+		}
 	}
-	reti = executeRegex(&regexSupport, regex, string, groupsSupport, groupSize + 1);
-	if (hasNotMatched(reti)) {
-		retVal = false;
+	retVal = cuRegularExpressionExecute(compiled, string, groupSize + 1, groupsSupport);
+	if (!retVal) {
 		goto exit;
 	}
-	retVal = true;
 
 	if (groupSize == 0) {
 		goto exit;
@@ -76,8 +107,10 @@ bool cuRegularExpressionApply(const char* restrict string, const char* restrict
 	*groups = arrayOfString;
 
 	exit:
-	free(groupsSupport);
-	destroyRegex(&regexSupport, NULL); //TODO context null
+	if (groupsSupport != stackGroups) {
+		free(groupsSupport);
+	}
+	cuRegularExpressionDestroy(compiled, NULL);
 	return retVal;
 }
 
@@ -90,6 +123,142 @@ void cuRegularExpressionDestroyGroupInfo(int groupSize, char const *const *const
 	free((void*) arrayOfString);
 }
 
+cu_regex* cuRegularExpressionCompile(CU_NOTNULL const char* regex) {
+	cu_regex* result = CU_MALLOC(cu_regex);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+	compileRegex(&result->compiled, regex);
+	result->pattern = strdup(regex);
+	if (result->pattern == NULL) {
+		ERROR_MALLOC();
+	}
+	result->hash = hashString(regex);
+	result->references = 1;
+	result->moreRecent = NULL;
+	result->lessRecent = NULL;
+	result->nextSameHash = NULL;
+
+	return result;
+}
+
+void cuRegularExpressionDestroy(CU_NOTNULL const cu_regex* regex, CU_NULLABLE const struct var_args* context) {
+	cu_regex* r = (cu_regex*) regex;
+	if (__sync_sub_and_fetch(&r->references, 1) == 0) {
+		destroyRegex(&r->compiled, context);
+		CU_FREE(r->pattern);
+		CU_FREE(r);
+	}
+}
+
+const char* cuRegularExpressionGetPattern(CU_NOTNULL const cu_regex* regex) {
+	return regex->pattern;
+}
+
+int cuRegularExpressionGetGroupsNumber(CU_NOTNULL const cu_regex* regex) {
+	return regex->compiled.re_nsub;
+}
+
+bool cuRegularExpressionExecute(CU_NOTNULL const cu_regex* regex, CU_NOTNULL const char* string, int groupsSize, CU_NULLABLE regmatch_t* groups) {
+	return hasMatched(executeRegex((regex_t*) &regex->compiled, regex->pattern, string, groups, groupsSize));
+}
+
+int cuRegularExpressionGetGroup(CU_NOTNULL const char* string, CU_NOTNULL const regmatch_t* groups, int groupNumber, CU_NOTNULL char* buffer, size_t bufferSize) {
+	if (groups[groupNumber].rm_so < 0) {
+		if (bufferSize > 0) {
+			buffer[0] = '\0';
+		}
+		return -1;
+	}
+
+	int length = groups[groupNumber].rm_eo - groups[groupNumber].rm_so;
+	if (bufferSize > 0) {
+		size_t copied = ((size_t)length < bufferSize) ? (size_t)length : bufferSize - 1;
+		memcpy(buffer, &string[groups[groupNumber].rm_so], copied);
+		buffer[copied] = '\0';
+	}
+	return length;
+}
+
+cu_regex* cuRegularExpressionCacheGet(CU_NOTNULL const char* regex) {
+	unsigned long hash = hashString(regex);
+	cu_regex* result;
+
+	pthread_mutex_lock(&cache.mutex);
+	if (cache.regexes == NULL) {
+		cache.regexes = cuFlatHTNew();
+	}
+	for (result = cuFlatHTGetItem(cache.regexes, hash); result != NULL; result = result->nextSameHash) {
+		if (strcmp(result->pattern, regex) == 0) {
+			break;
+		}
+	}
+
+	if (result != NULL) {
+		cache.hits++;
+		unlinkFromRecents(result);
+		markAsMostRecent(result);
+		__sync_add_and_fetch(&result->references, 1);
+	} else {
+		cache.misses++;
+		result = cuRegularExpressionCompile(regex);
+		if (cache.capacity > 0) {
+			//the reference of the cache
+			__sync_add_and_fetch(&result->references, 1);
+			result->nextSameHash = cuFlatHTGetItem(cache.regexes, hash);
+			cuFlatHTAddOrUpdateItem(cache.regexes, hash, result);
+			markAsMostRecent(result);
+			cache.size++;
+			while (cache.size > cache.capacity) {
+				evictFromCache(cache.leastRecent);
+			}
+		}
+	}
+	pthread_mutex_unlock(&cache.mutex);
+
+	return result;
+}
+
+void cuRegularExpressionCacheSetCapacity(size_t capacity) {
+	pthread_mutex_lock(&cache.mutex);
+	cache.capacity = capacity;
+	while (cache.size > cache.capacity) {
+		evictFromCache(cache.leastRecent);
+	}
+	pthread_mutex_unlock(&cache.mutex);
+}
+
+void cuRegularExpressionCacheClear() {
+	pthread_mutex_lock(&cache.mutex);
+	while (cache.size > 0) {
+		evictFromCache(cache.leastRecent);
+	}
+	cache.hits = 0;
+	cache.misses = 0;
+	pthread_mutex_unlock(&cache.mutex);
+}
+
+size_t cuRegularExpressionCacheGetSize() {
+	pthread_mutex_lock(&cache.mutex);
+	size_t result = cache.size;
+	pthread_mutex_unlock(&cache.mutex);
+	return result;
+}
+
+unsigned long cuRegularExpressionCacheGetHits() {
+	pthread_mutex_lock(&cache.mutex);
+	unsigned long result = cache.hits;
+	pthread_mutex_unlock(&cache.mutex);
+	return result;
+}
+
+unsigned long cuRegularExpressionCacheGetMisses() {
+	pthread_mutex_lock(&cache.mutex);
+	unsigned long result = cache.misses;
+	pthread_mutex_unlock(&cache.mutex);
+	return result;
+}
+
 /**
  * Compile a regex
  *
@@ -118,7 +287,7 @@ static int compileRegex(regex_t* regex, const char* regexString) {
  * @param[in] testString the string you want to test against the regex
  * @param[out] capturingGroups an array in the stack where the capturing groups can be stored. Set it NULL if our regex does not have any capturing group
  * @param[in] capturingGroupsSize the number of capturing groups in the regex
- * @return an int useful to understand the result of the regex. See ::hasMatched or ::hasNotMatched
+ * @return an int useful to understand the result of the regex. See ::hasMatched
  */
 static int executeRegex(regex_t* regex, const char* regexString, const char* testString, regmatch_t* capturingGroups, int capturingGroupsSize) {
 	int reti = regexec(regex, testString, capturingGroupsSize, capturingGroups, 0);
@@ -138,16 +307,6 @@ static bool hasMatched(int reti) {
 	return !reti;
 }
 
-/**
- * Check if the regex has not matched
- *
- * @param[in] reti the output of the function ::executeRegex
- * @return false if the regex has matched, true otherwise
- */
-static bool hasNotMatched(int reti) {
-	return reti || (reti == REG_NOMATCH);
-}
-
 /**
  * Clean up regex structure
  *
@@ -185,4 +344,71 @@ static char const *const getGroup(const char* testString, regmatch_t* groups, in
 	return retVal;
 }
 
+/**
+ * Put a regex at the head of the recently used list of the cache
+ *
+ * @pre the cache lock is held and @c regex is not in the list
+ *
+ * @param[inout] regex the regex just used
+ */
+static void markAsMostRecent(CU_NOTNULL cu_regex* regex) {
+	regex->moreRecent = NULL;
+	regex->lessRecent = cache.mostRecent;
+	if (cache.mostRecent != NULL) {
+		cache.mostRecent->moreRecent = regex;
+	}
+	cache.mostRecent = regex;
+	if (cache.leastRecent == NULL) {
+		cache.leastRecent = regex;
+	}
+}
+
+/**
+ * Remove a regex from the recently used list of the cache
+ *
+ * @pre the cache lock is held
+ *
+ * @param[inout] regex the regex to remove
+ */
+static void unlinkFromRecents(CU_NOTNULL cu_regex* regex) {
+	if (regex->moreRecent != NULL) {
+		regex->moreRecent->lessRecent = regex->lessRecent;
+	} else {
+		cache.mostRecent = regex->lessRecent;
+	}
+	if (regex->lessRecent != NULL) {
+		regex->lessRecent->moreRecent = regex->moreRecent;
+	} else {
+		cache.leastRecent = regex->moreRecent;
+	}
+	regex->moreRecent = NULL;
+	regex->lessRecent = NULL;
+}
 
+/**
+ * Remove a regex from the cache and drop the reference the cache has on it
+ *
+ * @pre the cache lock is held
+ *
+ * @param[inout] regex a regex in the cache
+ */
+static void evictFromCache(CU_NOTNULL cu_regex* regex) {
+	cu_regex* first = cuFlatHTGetItem(cache.regexes, regex->hash);
+	if (first == regex) {
+		if (regex->nextSameHash != NULL) {
+			cuFlatHTUpdateItem(cache.regexes, regex->hash, regex->nextSameHash);
+		} else {
+			cuFlatHTRemoveItem(cache.regexes, regex->hash);
+		}
+	} else {
+		while (first->nextSameHash != regex) {
+			first = first->nextSameHash;
+		}
+		first->nextSameHash = regex->nextSameHash;
+	}
+	regex->nextSameHash = NULL;
+
+	unlinkFromRecents(regex);
+	cache.size--;
+	cuRegularExpressionDestroy(regex, NULL);
+}
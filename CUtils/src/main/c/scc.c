@@ -8,6 +8,7 @@
 #include "scc.h"
 #include "macros.h"
 #include <math.h>
+#include <limits.h>
 #include "static_stack.h"
 #include "hashtable.h"
 #include "redBlackTree.h"
@@ -15,6 +16,8 @@
 #include "heap.h"
 #include "log.h"
 #include "errors.h"
+#include "csr_graph.h"
+#include "flat_hashtable.h"
 
 typedef list ht_edge_list;
 
@@ -41,6 +44,47 @@ struct scc_graph {
 	SCCHT* node2scc;
 };
 
+/**
+ * A frame of the DFS performed by ::performIterativeTarjan
+ */
+struct tarjan_frame {
+	///the dense index of the node whose successors are scanned
+	unsigned int index;
+	///the position in ::dense_successors::sinks of the next successor to scan
+	unsigned int next;
+	///the position in ::dense_successors::sinks of the edge whose sink is being visited in the frame above this one. UINT_MAX if there is no such frame
+	unsigned int pending;
+	///false if the node reaches a node discovered before it which is not in an scc yet
+	bool root;
+};
+
+/**
+ * The nodes of a graph mapped to dense indices
+ */
+struct dense_node_map {
+	///@c nodes[i] is the node with dense index @c i. Nodes are sorted by id
+	Node** nodes;
+	///maps a ::NodeId to its dense index plus 1. NULL if the ids of the graph go from 0 to <tt>size - 1</tt>: in this case the dense index is the id itself
+	flat_ht* indexOfId;
+};
+
+/**
+ * The successors of the nodes of a ::dense_node_map, stored in flat arrays
+ *
+ * The successors of the node with dense index @c i are in the positions from <tt>offsets[i]</tt> (included) to <tt>offsets[i+1]</tt> (excluded),
+ * in the same order they have in the successors hashtable of the node.
+ */
+struct dense_successors {
+	///@c included[i] is not 0 if the node with dense index @c i needs to be considered
+	unsigned char* included;
+	///the first position of the successors of each node, plus the total number of successors
+	unsigned int* offsets;
+	///the dense index of the sink of each edge
+	unsigned int* sinks;
+	///the edges themselves
+	Edge** edges;
+};
+
 typedef struct scc_data {
 	/**
 	 * Represents the nodes of the original graph inside the scc.
@@ -54,10 +98,19 @@ static void destroySCCData(const scc_data* sccData, CU_NULLABLE const struct var
 #define CU_FUNCTION_POINTER_destructor_void_destroySCCData_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
 static int getMinimum(int a, int b);
 static void performTarjan(scc_graph* sccGraph, const PredSuccGraph* graph, const bool_ht* included);
+static void performIterativeTarjan(scc_graph* sccGraph, const PredSuccGraph* graph, const bool_ht* included);
+static void initDenseNodeMap(struct dense_node_map* map, const PredSuccGraph* graph);
+static unsigned int getDenseIndex(const struct dense_node_map* map, const Node* n);
+static void initDenseSuccessors(struct dense_successors* successors, const struct dense_node_map* map, unsigned int size, const bool_ht* included);
+static void destroyDenseSuccessors(const struct dense_successors* successors);
+static int compareNodesById(const void* a, const void* b);
+static void pushInterSCCEdge(Edge*** edges, unsigned int* top, unsigned int* capacity, Edge* e);
+static void performParallelSCC(scc_graph* sccGraph, const PredSuccGraph* graph, const bool_ht* included, cu_parallel_thread_pool* pool, const csr_graph* snapshot);
+static void addInterSCCEdge(Node* sccSource, Node* sccSink, Edge* e);
 static void performTarjanDFS(scc_graph* sccGraph, const PredSuccGraph* graph, const bool_ht* included, Node* n, NodeId* nextSccNodeId, int* nextIndex, static_stack* nodeStack, int_ht* lowlink, int_ht* index, bool_ht* onStack, static_stack* interSCCEdgeStack, Node** sccCreated, bool* shouldStop);
 static int orderer_onId(const Node* n1, const Node* n2);
 
-scc_graph* cuStronglyConnectedComponentsGraphNew(const PredSuccGraph* graph, edge_traverser traverser, bool trackInterSCCEdges, const bool_ht* included) {
+scc_graph* cuStronglyConnectedComponentsGraphNew(const PredSuccGraph* graph, edge_traverser traverser, bool trackInterSCCEdges, const bool_ht* included, enum scc_algorithm algorithm, CU_NULLABLE cu_parallel_thread_pool* pool, CU_NULLABLE const csr_graph* snapshot) {
 	scc_graph* retVal = malloc(sizeof(scc_graph));
 	if (retVal == NULL) {
 		ERROR_MALLOC();
@@ -71,10 +124,36 @@ scc_graph* cuStronglyConnectedComponentsGraphNew(const PredSuccGraph* graph, edg
 	retVal->sccs->nodeFunctions.destroy = CU_AS_DESTRUCTOR(destroySCCData);
 	retVal->sccs->edgeFunctions.destroy = CU_AS_DESTRUCTOR(cuListDestroy);
 
-	performTarjan(retVal, graph, included);
+	switch (algorithm) {
+	case SCC_RECURSIVE_TARJAN: {
+		performTarjan(retVal, graph, included);
+		break;
+	}
+	case SCC_ITERATIVE_TARJAN: {
+		performIterativeTarjan(retVal, graph, included);
+		break;
+	}
+	case SCC_PARALLEL: {
+		performParallelSCC(retVal, graph, included, pool, snapshot);
+		break;
+	}
+	default: {
+		ERROR_UNHANDLED_CASE("scc_algorithm", algorithm);
+	}
+	}
 	return retVal;
 }
 
+CU_DEFINE_DEFAULT_VALUES(cuStronglyConnectedComponentsGraphNew,
+		,
+		,
+		,
+		,
+		SCC_RECURSIVE_TARJAN,
+		NULL,
+		NULL
+);
+
 void cuStronglyConnectedComponentsGraphDestroy(const scc_graph* _sccGraph, CU_NULLABLE const struct var_args* context) {
 	scc_graph* sccGraph = (scc_graph*) _sccGraph;
 	cuPredSuccGraphDestroyWithElements(sccGraph->sccs, context);
@@ -152,7 +231,7 @@ static scc_data* newSCCData() {
 		ERROR_MALLOC();
 	}
 
-	retVal->graphNodes = cuHeapNew(100, getSCCPayloadFunction());
+	retVal->graphNodes = cuHeapNew(CU_HEAP_UNBOUNDED, getSCCPayloadFunction());
 
 	return retVal;
 }
@@ -374,20 +453,7 @@ static void performTarjanDFS(scc_graph* sccGraph, const PredSuccGraph* graph, co
 #endif
 
 			debug("adding edges %d->%d to scc big edge", e->source->id, e->sink->id);
-			Edge* sccEdge = _cuPredSuccGraphGetEdge(sccSource, sccSink);
-			EdgeList* originalEdgeList = NULL;
-			if (sccEdge == NULL) {
-				//create the new edge between scc
-				originalEdgeList = cuListNew();
-				sccEdge = _cuPredSuccGraphAddEdge(sccSource, sccSink, originalEdgeList);
-				debug("added edge %d->%d with list %p list is %p", sccSource->id, sccSink->id, _cuPredSuccGraphGetEdge(sccSource, sccSink)->payload, originalEdgeList);
-			} else {
-				originalEdgeList = getEdgePayloadAs(sccEdge, EdgeList*);
-				debug("updating list %p", originalEdgeList);
-			}
-			//insert the edge inside the list
-			cuListAddTail(originalEdgeList, e);
-			debug("size of list is %d", cuListGetSize(originalEdgeList));
+			addInterSCCEdge(sccSource, sccSink, e);
 		} while (true);
 	}
 
@@ -398,3 +464,437 @@ static int getMinimum(int a, int b) {
 	return a < b ? a : b;
 }
 
+/**
+ * Compute the sccs of a graph via an iterative version of Pearce algorithm
+ *
+ * Pearce algorithm merges the index and the lowlink of Tarjan algorithm in a single value per node. The nodes which are not the root of their scc
+ * wait in a stack until their root has been completely visited.
+ * The successors are scanned in the same order of ::performTarjanDFS, so we create the same sccs, with the same ids, in the same order.
+ * The ids, the successors and the included nodes are mapped to flat arrays before the visit, so the visit itself doesn't look up any hashtable.
+ *
+ * @param[inout] sccGraph the sccgraph to build
+ * @param[in] graph the original graph \c sccGraph will be based upon
+ * @param[in] included an hashtable containing as keys the id of the nodes in \c graph. If the keys are presents, the nodes are considered within tarjan. Ignored otherwise
+ */
+static void performIterativeTarjan(scc_graph* sccGraph, const PredSuccGraph* graph, const bool_ht* included) {
+	unsigned int size = cuPredSuccGraphGetVertexNumber(graph);
+	struct dense_node_map map;
+	initDenseNodeMap(&map, graph);
+	struct dense_successors successors;
+	initDenseSuccessors(&successors, &map, size, included);
+
+	//rindex[i] is 0 if the node has not been discovered yet. Otherwise it is its discovery time, lowered to the minimum discovery time it reaches while it is not in an scc
+	unsigned int* rindex = calloc(size > 0 ? size : 1, sizeof(unsigned int));
+	//the i-th bit is set when the node with dense index i has been put in an scc
+	unsigned char* done = calloc((size / CHAR_BIT) + 1, sizeof(unsigned char));
+	struct tarjan_frame* callStack = malloc(sizeof(struct tarjan_frame) * (size > 0 ? size : 1));
+	//the nodes waiting for the root of their scc to be completely visited
+	unsigned int* waiting = malloc(sizeof(unsigned int) * (size > 0 ? size : 1));
+	//the edges leading to another scc, waiting for the scc of their source to be created
+	Edge** interSCCEdges = NULL;
+	unsigned int interSCCEdgesCapacity = 0;
+	if (rindex == NULL || done == NULL || callStack == NULL || waiting == NULL) {
+		ERROR_MALLOC();
+	}
+
+	unsigned int nextIndex = 1;
+	NodeId nextSccNodeId = 0;
+	unsigned int waitingTop = 0;
+	unsigned int interSCCEdgesTop = 0;
+	bool shouldStop = false;
+	for (unsigned int root=0; root<size && !shouldStop; root++) {
+		if (rindex[root] != 0) {
+			continue;
+		}
+		if (!successors.included[root]) {
+			continue;
+		}
+
+		unsigned int callTop = 0;
+		callStack[callTop].index = root;
+		callStack[callTop].next = successors.offsets[root];
+		callStack[callTop].pending = UINT_MAX;
+		callStack[callTop].root = true;
+		callTop++;
+		rindex[root] = nextIndex++;
+
+		while (callTop > 0 && !shouldStop) {
+			struct tarjan_frame* frame = &callStack[callTop - 1];
+			unsigned int v = frame->index;
+
+			if (frame->pending != UINT_MAX) {
+				//we have just finished visiting the sink of the pending edge
+				unsigned int w = successors.sinks[frame->pending];
+				if ((done[w / CHAR_BIT] & (1 << (w % CHAR_BIT))) != 0) {
+					//the visit has created the scc of the sink
+					if (sccGraph->trackInterSCCEdges) {
+						pushInterSCCEdge(&interSCCEdges, &interSCCEdgesTop, &interSCCEdgesCapacity, successors.edges[frame->pending]);
+					}
+				} else if (rindex[w] < rindex[v]) {
+					rindex[v] = rindex[w];
+					frame->root = false;
+				}
+				frame->pending = UINT_MAX;
+			}
+
+			if (frame->next < successors.offsets[v + 1]) {
+				unsigned int edgeIndex = frame->next++;
+				Edge* e = successors.edges[edgeIndex];
+				et_outcome et = sccGraph->traverser(e);
+				if (et == ET_TOIGNORE) {
+					continue;
+				} else if (et == ET_STOP) {
+					debug("we need to stop Tarjan algorithm");
+					shouldStop = true;
+					continue;
+				} else if (et != ET_TOANALYZE) {
+					ERROR_UNHANDLED_CASE("et_outcome", et);
+				}
+
+				unsigned int w = successors.sinks[edgeIndex];
+				if (rindex[w] == 0) {
+					frame->pending = edgeIndex;
+					callStack[callTop].index = w;
+					callStack[callTop].next = successors.offsets[w];
+					callStack[callTop].pending = UINT_MAX;
+					callStack[callTop].root = true;
+					callTop++;
+					rindex[w] = nextIndex++;
+				} else if ((done[w / CHAR_BIT] & (1 << (w % CHAR_BIT))) == 0) {
+					//the sink is in the current DFS, hence it is in the same scc of ours
+					if (rindex[w] < rindex[v]) {
+						rindex[v] = rindex[w];
+						frame->root = false;
+					}
+				} else if (sccGraph->trackInterSCCEdges) {
+					pushInterSCCEdge(&interSCCEdges, &interSCCEdgesTop, &interSCCEdgesCapacity, e);
+				}
+				continue;
+			}
+
+			//every successor of the node has been scanned
+			callTop--;
+			if (!frame->root) {
+				waiting[waitingTop++] = v;
+				continue;
+			}
+
+			Node* newScc = newPredSuccNode(nextSccNodeId, newSCCData(), false);
+			scc_data* sccData = getNodePayloadAs(newScc, scc_data*);
+			nextSccNodeId += 1;
+			cuHeapInsertItem(sccData->graphNodes, map.nodes[v]);
+			cuHTAddItem(sccGraph->node2scc, map.nodes[v]->id, newScc);
+			done[v / CHAR_BIT] |= (1 << (v % CHAR_BIT));
+			while (waitingTop > 0 && rindex[waiting[waitingTop - 1]] >= rindex[v]) {
+				unsigned int w = waiting[--waitingTop];
+				cuHeapInsertItem(sccData->graphNodes, map.nodes[w]);
+				cuHTAddItem(sccGraph->node2scc, map.nodes[w]->id, newScc);
+				done[w / CHAR_BIT] |= (1 << (w % CHAR_BIT));
+			}
+			_cuPredSuccGraphAddVertexInstanceInGraph(sccGraph->sccs, newScc);
+
+			while (interSCCEdgesTop > 0) {
+				Edge* e = interSCCEdges[interSCCEdgesTop - 1];
+				if (cuStronglyConnectedComponentsGetComponentOfNodeByInstance(sccGraph, e->source) != newScc) {
+					break;
+				}
+				interSCCEdgesTop--;
+				addInterSCCEdge(newScc, cuStronglyConnectedComponentsGetComponentOfNodeByInstance(sccGraph, e->sink), e);
+			}
+		}
+	}
+
+	if (interSCCEdges != NULL) {
+		free(interSCCEdges);
+	}
+	free(waiting);
+	free(callStack);
+	free(done);
+	free(rindex);
+	destroyDenseSuccessors(&successors);
+	free(map.nodes);
+	if (map.indexOfId != NULL) {
+		cuFlatHTDestroy(map.indexOfId, NULL);
+	}
+}
+
+/**
+ * Map the nodes of a graph to dense indices, sorted by id
+ *
+ * @param[out] map the map to initialize
+ * @param[in] graph the graph whose nodes we need to map
+ */
+static void initDenseNodeMap(struct dense_node_map* map, const PredSuccGraph* graph) {
+	unsigned int size = cuPredSuccGraphGetVertexNumber(graph);
+	map->nodes = malloc(sizeof(Node*) * (size > 0 ? size : 1));
+	if (map->nodes == NULL) {
+		ERROR_MALLOC();
+	}
+	map->indexOfId = NULL;
+
+	unsigned int i = 0;
+	bool dense = true;
+	for (HTCell* cell = _cuHTGetCell(graph->nodes); cell != NULL; cell = _cuHTCellGetNext(cell)) {
+		Node* n = _cuHTCellGetValue(cell);
+		map->nodes[i++] = n;
+		dense = dense && n->id < size;
+	}
+
+	if (dense) {
+		//ids are unique, so we can put each node in the cell of its id by swapping
+		for (i=0; i<size; i++) {
+			while (map->nodes[i]->id != i) {
+				Node* tmp = map->nodes[map->nodes[i]->id];
+				map->nodes[map->nodes[i]->id] = map->nodes[i];
+				map->nodes[i] = tmp;
+			}
+		}
+		return;
+	}
+
+	qsort(map->nodes, size, sizeof(Node*), compareNodesById);
+	map->indexOfId = cuFlatHTNew(cuPayloadFunctionsIntValue());
+	cuFlatHTReserve(map->indexOfId, size);
+	for (i=0; i<size; i++) {
+		cuFlatHTAddItem(map->indexOfId, map->nodes[i]->id, CU_CAST_INT2PTR(i + 1));
+	}
+}
+
+/**
+ * @param[in] map the map involved
+ * @param[in] n a node of the graph of @c map
+ * @return the dense index of @c n
+ */
+static unsigned int getDenseIndex(const struct dense_node_map* map, const Node* n) {
+	if (map->indexOfId == NULL) {
+		return n->id;
+	}
+	return (unsigned int)(CU_CAST_PTR2INT(cuFlatHTGetItem(map->indexOfId, n->id)) - 1);
+}
+
+/**
+ * Copy the successors of every node of a graph in flat arrays
+ *
+ * The edges going out of a node which is not included or going to a node which is not included are not copied at all.
+ * This is the only place where the ids of the sinks are mapped to their dense indices
+ *
+ * @param[out] successors the arrays to initialize
+ * @param[in] map the nodes of the graph mapped to dense indices
+ * @param[in] size the number of nodes in the graph
+ * @param[in] included an hashtable containing as keys the id of the nodes to consider. If NULL, all the nodes are considered
+ */
+static void initDenseSuccessors(struct dense_successors* successors, const struct dense_node_map* map, unsigned int size, const bool_ht* included) {
+	successors->included = malloc(sizeof(unsigned char) * (size > 0 ? size : 1));
+	successors->offsets = malloc(sizeof(unsigned int) * (size + 1));
+	if (successors->included == NULL || successors->offsets == NULL) {
+		ERROR_MALLOC();
+	}
+	unsigned int edgesNumber = 0;
+	for (unsigned int i=0; i<size; i++) {
+		successors->included[i] = included == NULL || cuHTGetItem(included, map->nodes[i]->id);
+		if (successors->included[i]) {
+			edgesNumber += cuHTGetSize(map->nodes[i]->successors);
+		}
+	}
+
+	successors->sinks = malloc(sizeof(unsigned int) * (edgesNumber > 0 ? edgesNumber : 1));
+	successors->edges = malloc(sizeof(Edge*) * (edgesNumber > 0 ? edgesNumber : 1));
+	if (successors->sinks == NULL || successors->edges == NULL) {
+		ERROR_MALLOC();
+	}
+	unsigned int next = 0;
+	for (unsigned int i=0; i<size; i++) {
+		successors->offsets[i] = next;
+		if (!successors->included[i]) {
+			continue;
+		}
+		for (HTCell* cell = _cuHTGetCell(map->nodes[i]->successors); cell != NULL; cell = _cuHTCellGetNext(cell)) {
+			Edge* e = _cuHTCellGetValue(cell);
+			unsigned int sink = getDenseIndex(map, e->sink);
+			if (successors->included[sink]) {
+				successors->sinks[next] = sink;
+				successors->edges[next] = e;
+				next++;
+			}
+		}
+	}
+	successors->offsets[size] = next;
+}
+
+/**
+ * Free the arrays built by ::initDenseSuccessors
+ *
+ * @param[in] successors the arrays to free
+ */
+static void destroyDenseSuccessors(const struct dense_successors* successors) {
+	free(successors->edges);
+	free(successors->sinks);
+	free(successors->offsets);
+	free(successors->included);
+}
+
+/**
+ * Push an edge on a stack, doubling its capacity if it is full
+ *
+ * @param[inout] edges the stack. It may be reallocated
+ * @param[inout] top the number of edges in the stack
+ * @param[inout] capacity the number of edges the stack can hold
+ * @param[in] e the edge to push
+ */
+static void pushInterSCCEdge(Edge*** edges, unsigned int* top, unsigned int* capacity, Edge* e) {
+	if (*top == *capacity) {
+		*capacity = (*capacity == 0) ? 16 : (*capacity * 2);
+		*edges = realloc(*edges, sizeof(Edge*) * (*capacity));
+		if (*edges == NULL) {
+			ERROR_MALLOC();
+		}
+	}
+	(*edges)[(*top)++] = e;
+}
+
+static int compareNodesById(const void* a, const void* b) {
+	NodeId ida = (*((Node* const*)a))->id;
+	NodeId idb = (*((Node* const*)b))->id;
+	return (ida > idb) - (ida < idb);
+}
+
+/**
+ * Compute the sccs of a graph via ::cuCSRGraphParallelComputeSCC
+ *
+ * @param[inout] sccGraph the sccgraph to build
+ * @param[in] graph the original graph \c sccGraph will be based upon
+ * @param[in] included an hashtable containing as keys the id of the nodes in \c graph. If the keys are presents, the nodes are considered. Ignored otherwise
+ * @param[inout] pool the workers computing the sccs. Can be NULL
+ * @param[in] snapshot a snapshot of \c graph. If NULL, it is created here
+ */
+static void performParallelSCC(scc_graph* sccGraph, const PredSuccGraph* graph, const bool_ht* included, cu_parallel_thread_pool* pool, const csr_graph* snapshot) {
+	const csr_graph* csr = snapshot != NULL ? snapshot : cuPredSuccGraphFreeze(graph);
+	bool* includedVertices = NULL;
+	bool* traversable = NULL;
+	unsigned int* components = NULL;
+	Node** sccs = NULL;
+
+	if (included != NULL) {
+		includedVertices = malloc(sizeof(bool) * (csr->size > 0 ? csr->size : 1));
+		if (includedVertices == NULL) {
+			ERROR_MALLOC();
+		}
+		for (unsigned int i=0; i<csr->size; i++) {
+			includedVertices[i] = cuHTGetItem(included, csr->ids[i]) != NULL;
+		}
+	}
+
+	//the traverser is not meant to be thread safe: we call it here once per edge
+	if (sccGraph->traverser != edge_traverser_alwaysAccept) {
+		traversable = malloc(sizeof(bool) * (csr->edgesNumber > 0 ? csr->edgesNumber : 1));
+		if (traversable == NULL) {
+			ERROR_MALLOC();
+		}
+		for (unsigned int i=0; i<csr->size; i++) {
+			CU_ITERATE_OVER_CSR_SUCCESSORS(csr, i, sink, e) {
+				traversable[e] = false;
+				if (includedVertices != NULL && (!includedVertices[i] || !includedVertices[sink])) {
+					continue;
+				}
+				et_outcome et = sccGraph->traverser(csr->edges[e]);
+				switch (et) {
+				case ET_TOANALYZE: {
+					traversable[e] = true;
+					break;
+				}
+				case ET_TOIGNORE: {
+					break;
+				}
+				case ET_STOP: {
+					debug("we need to stop the scc computation");
+					goto cleanup;
+				}
+				default: {
+					ERROR_UNHANDLED_CASE("et_outcome", et);
+				}
+				}
+			}
+		}
+	}
+
+	components = malloc(sizeof(unsigned int) * (csr->size > 0 ? csr->size : 1));
+	if (components == NULL) {
+		ERROR_MALLOC();
+	}
+	unsigned int sccsNumber = cuCSRGraphParallelComputeSCC(csr, includedVertices, traversable, pool, components);
+
+	sccs = malloc(sizeof(Node*) * (sccsNumber > 0 ? sccsNumber : 1));
+	if (sccs == NULL) {
+		ERROR_MALLOC();
+	}
+	for (unsigned int i=0; i<sccsNumber; i++) {
+		sccs[i] = newPredSuccNode(i, newSCCData(), false);
+		_cuPredSuccGraphAddVertexInstanceInGraph(sccGraph->sccs, sccs[i]);
+	}
+	for (unsigned int i=0; i<csr->size; i++) {
+		if (components[i] == UINT_MAX) {
+			continue;
+		}
+		Node* n = cuPredSuccGraphGetNodeById(graph, csr->ids[i]);
+		cuHeapInsertItem(getNodePayloadAs(sccs[components[i]], scc_data*)->graphNodes, n);
+		cuHTAddItem(sccGraph->node2scc, n->id, sccs[components[i]]);
+	}
+
+	if (sccGraph->trackInterSCCEdges) {
+		for (unsigned int i=0; i<csr->size; i++) {
+			if (components[i] == UINT_MAX) {
+				continue;
+			}
+			CU_ITERATE_OVER_CSR_SUCCESSORS(csr, i, sink, e) {
+				if (components[sink] == UINT_MAX || components[sink] == components[i]) {
+					continue;
+				}
+				if (traversable != NULL && !traversable[e]) {
+					continue;
+				}
+				addInterSCCEdge(sccs[components[i]], sccs[components[sink]], csr->edges[e]);
+			}
+		}
+	}
+
+	cleanup:
+	if (sccs != NULL) {
+		free(sccs);
+	}
+	if (components != NULL) {
+		free(components);
+	}
+	if (traversable != NULL) {
+		free(traversable);
+	}
+	if (includedVertices != NULL) {
+		free(includedVertices);
+	}
+	if (snapshot == NULL) {
+		cuCSRGraphDestroy(csr, NULL);
+	}
+}
+
+/**
+ * Add an edge of the original graph to the list of edges between 2 sccs
+ *
+ * @param[inout] sccSource the scc containing the source of \c e
+ * @param[inout] sccSink the scc containing the sink of \c e
+ * @param[in] e the edge of the original graph
+ */
+static void addInterSCCEdge(Node* sccSource, Node* sccSink, Edge* e) {
+	Edge* sccEdge = _cuPredSuccGraphGetEdge(sccSource, sccSink);
+	EdgeList* originalEdgeList = NULL;
+	if (sccEdge == NULL) {
+		//create the new edge between scc
+		originalEdgeList = cuListNew();
+		sccEdge = _cuPredSuccGraphAddEdge(sccSource, sccSink, originalEdgeList);
+		debug("added edge %d->%d with list %p list is %p", sccSource->id, sccSink->id, _cuPredSuccGraphGetEdge(sccSource, sccSink)->payload, originalEdgeList);
+	} else {
+		originalEdgeList = getEdgePayloadAs(sccEdge, EdgeList*);
+		debug("updating list %p", originalEdgeList);
+	}
+	//insert the edge inside the list
+	cuListAddTail(originalEdgeList, e);
+	debug("size of list is %d", cuListGetSize(originalEdgeList));
+}
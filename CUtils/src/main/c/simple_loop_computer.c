@@ -14,6 +14,9 @@
 #include "dynamic_array.h"
 #include "log.h"
 #include "errors.h"
+#include <limits.h>
+#include "csr_graph.h"
+#include "utility.h"
 
 typedef HT node_list_ht;
 typedef dynamic_1D_array bool_array;
@@ -50,9 +53,86 @@ typedef struct johnson_support {
 	bool_ht* included;
 } johnson_support;
 
+/**
+ * The set B of Johnson algorithm of a vertex, used by ::cuSimpleLoopComputerParallelVisitLoops
+ */
+struct simple_loop_b {
+	///the dense indices of the vertices to unblock when the owner of the set is unblocked
+	unsigned int* vertices;
+	unsigned int size;
+	unsigned int capacity;
+};
+
+/**
+ * A frame of the DFS performed by a worker of ::cuSimpleLoopComputerParallelVisitLoops
+ *
+ * The vertices of the frames on the stack are the current path from the root
+ */
+struct simple_loop_frame {
+	unsigned int vertex;
+	///the index of the next out edge of ::simple_loop_frame::vertex to follow
+	unsigned int nextEdge;
+	///true if a loop has been found from the vertex or the search from it has been cut by the maximum length
+	bool found;
+};
+
+/**
+ * An enumeration performed by ::cuSimpleLoopComputerParallelVisitLoops
+ */
+struct simple_loop_job {
+	const csr_graph* csr;
+	///the node of each dense index
+	Node** nodes;
+	///the edges which can be part of a loop. NULL if every edge can
+	const bool* traversable;
+	///the strongly connected component of each vertex
+	const unsigned int* components;
+	///the vertices which might be the minimum vertex of a loop
+	const unsigned int* roots;
+	unsigned int rootsNumber;
+	///the roots to process, one per chunk
+	cu_parallel_for loop;
+	unsigned int minLength;
+	///UINT_MAX if there is no limit
+	unsigned int maxLength;
+	///ULONG_MAX if there is no limit
+	unsigned long maxLoops;
+	cu_simple_loop_visitor visitor;
+	const struct var_args* context;
+	///serializes the calls to ::simple_loop_job::visitor
+	cu_mutex* mutex;
+	///the number of loops found so far. Updated atomically or while holding ::simple_loop_job::mutex
+	unsigned long loopsFound;
+	///true when the enumeration needs to stop
+	volatile bool stop;
+};
+
+/**
+ * The state of a worker of ::cuSimpleLoopComputerParallelVisitLoops
+ */
+struct simple_loop_worker {
+	///the root whose loops are being enumerated, plus 1
+	unsigned int stamp;
+	///the cells of ::simple_loop_worker::blocked and ::simple_loop_worker::b of a vertex are meaningful only if its stamp is ::simple_loop_worker::stamp
+	unsigned int* stamps;
+	unsigned char* blocked;
+	struct simple_loop_b* b;
+	struct simple_loop_frame* frames;
+	unsigned int* unblockStack;
+	///the loop passed to ::simple_loop_job::visitor
+	Node** loop;
+};
+
 static void unblock(bool_array* blocked, node_list_ht* b, NodeId u);
 static bool circuit(const PredSuccGraph* graph, const scc_graph* sccGraph, const scc* sccOfRoot, node_stack* stack, bool_array* blocked, node_list_ht* b, NodeId rootId, NodeId vId, loop_list* retVal);
 static void cricuit_finding_algorithm(johnson_support* support, const PredSuccGraph* graph, loop_list* retVal);
+static enum thread_loop_state visitLoopsTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va);
+static void visitLoopsFromRoot(struct simple_loop_job* job, struct simple_loop_worker* worker, unsigned int root);
+static void touchVertex(struct simple_loop_worker* worker, unsigned int vertex);
+static void unblockVertex(struct simple_loop_worker* worker, unsigned int vertex);
+static void addToB(struct simple_loop_worker* worker, unsigned int vertex, unsigned int blockedVertex);
+static void emitLoop(struct simple_loop_job* job, struct simple_loop_worker* worker, unsigned int length);
+static bool canBeInLoop(const struct simple_loop_job* job, unsigned int root, unsigned int edgeIndex, unsigned int sink);
 
 johnson_support* cuJohnsonSupportNew() {
 	johnson_support* retVal = malloc(sizeof (johnson_support));
@@ -111,6 +191,113 @@ loop_list* cuJohnsonSupportComputeSimpleLoops(johnson_support* support, const Pr
 	return retVal;
 }
 
+unsigned long cuSimpleLoopComputerParallelVisitLoops(CU_NOTNULL const PredSuccGraph* g, CU_NOTNULL edge_traverser t, CU_NULLABLE cu_parallel_thread_pool* pool, CU_NULLABLE cu_simple_loop_visitor visitor, CU_NULLABLE const struct var_args* context, unsigned int minLength, unsigned int maxLength, unsigned long maxLoops, CU_NULLABLE const csr_graph* snapshot) {
+	const csr_graph* csr = snapshot != NULL ? snapshot : cuPredSuccGraphFreeze(g);
+	bool* traversable = NULL;
+	unsigned int* components = NULL;
+	unsigned int* roots = NULL;
+	Node** nodes = NULL;
+	unsigned long result = 0;
+
+	//the traverser is not meant to be thread safe: we call it here once per edge
+	if (t != edge_traverser_alwaysAccept) {
+		traversable = cuUtilsMallocArray(csr->edgesNumber, sizeof(bool));
+		for (unsigned int i=0; i<csr->size; i++) {
+			for (unsigned int e=csr->successorOffsets[i]; e<csr->successorOffsets[i + 1]; e++) {
+				et_outcome et = t(csr->edges[e]);
+				switch (et) {
+				case ET_TOANALYZE: {
+					traversable[e] = true;
+					break;
+				}
+				case ET_TOIGNORE: {
+					traversable[e] = false;
+					break;
+				}
+				case ET_STOP: {
+					debug("we need to stop the loop enumeration");
+					goto cleanup;
+				}
+				default: {
+					ERROR_UNHANDLED_CASE("et_outcome", et);
+				}
+				}
+			}
+		}
+	}
+
+	components = cuUtilsMallocArray(csr->size, sizeof(unsigned int));
+	cuCSRGraphParallelComputeSCC(csr, NULL, traversable, pool, components);
+
+	struct simple_loop_job job;
+	job.csr = csr;
+	job.traversable = traversable;
+	job.components = components;
+
+	//a vertex is a root only if it can reach its component without going through lower vertices
+	roots = cuUtilsMallocArray(csr->size, sizeof(unsigned int));
+	job.roots = roots;
+	job.rootsNumber = 0;
+	for (unsigned int i=0; i<csr->size; i++) {
+		CU_ITERATE_OVER_CSR_SUCCESSORS(csr, i, sink, e) {
+			if (canBeInLoop(&job, i, e, sink)) {
+				roots[job.rootsNumber++] = i;
+				break;
+			}
+		}
+	}
+
+	nodes = cuUtilsMallocArray(csr->size, sizeof(Node*));
+	for (unsigned int i=0; i<csr->size; i++) {
+		nodes[i] = cuPredSuccGraphGetNodeById(g, csr->ids[i]);
+	}
+	job.nodes = nodes;
+	job.minLength = minLength;
+	job.maxLength = maxLength == 0 ? UINT_MAX : maxLength;
+	job.maxLoops = maxLoops == 0 ? ULONG_MAX : maxLoops;
+	job.visitor = visitor;
+	job.context = context;
+	job.mutex = cuMutexNew(false);
+	job.loopsFound = 0;
+	job.stop = false;
+
+	struct simple_loop_job* jobPtr = &job;
+	cuInitVarArgsOnStack(va, jobPtr);
+	cuParallelThreadPoolFor(pool, visitLoopsTask, va, &job.loop, job.rootsNumber);
+	cuMutexDestroy(job.mutex, NULL);
+	result = job.loopsFound;
+
+	cleanup:
+	if (nodes != NULL) {
+		free(nodes);
+	}
+	if (roots != NULL) {
+		free(roots);
+	}
+	if (components != NULL) {
+		free(components);
+	}
+	if (traversable != NULL) {
+		free(traversable);
+	}
+	if (snapshot == NULL) {
+		cuCSRGraphDestroy(csr, NULL);
+	}
+	return result;
+}
+
+CU_DEFINE_DEFAULT_VALUES(cuSimpleLoopComputerParallelVisitLoops,
+		,
+		,
+		NULL,
+		NULL,
+		NULL,
+		0,
+		0,
+		0,
+		NULL
+);
+
 payload_functions cuSimpleLoopComputerPayloadFunctionsLoop() {
 	payload_functions result;
 
@@ -251,3 +438,235 @@ static bool circuit(const PredSuccGraph* graph, const scc_graph* sccGraph, const
 
 	return f;
 }
+
+/**
+ * Enumerate the loops of the roots of a ::simple_loop_job until there are no more
+ */
+static enum thread_loop_state visitLoopsTask(CU_NULLABLE const cu_thread* thread, const struct var_args* va) {
+	struct simple_loop_job* job = cuVarArgsGetItem(va, 0, struct simple_loop_job*);
+	unsigned int size = job->csr->size;
+	struct simple_loop_worker worker;
+	worker.stamps = calloc(size > 0 ? size : 1, sizeof(unsigned int));
+	if (worker.stamps == NULL) {
+		ERROR_MALLOC();
+	}
+	worker.blocked = cuUtilsMallocArray(size, sizeof(unsigned char));
+	worker.b = calloc(size > 0 ? size : 1, sizeof(struct simple_loop_b));
+	if (worker.b == NULL) {
+		ERROR_MALLOC();
+	}
+	worker.frames = cuUtilsMallocArray(size, sizeof(struct simple_loop_frame));
+	worker.unblockStack = cuUtilsMallocArray(size, sizeof(unsigned int));
+	worker.loop = cuUtilsMallocArray(size, sizeof(Node*));
+
+	unsigned int root;
+	while (!job->stop && cuParallelForGetNextChunk(&job->loop, &root)) {
+		visitLoopsFromRoot(job, &worker, job->roots[root]);
+	}
+
+	for (unsigned int i=0; i<size; i++) {
+		if (worker.b[i].vertices != NULL) {
+			free(worker.b[i].vertices);
+		}
+	}
+	free(worker.loop);
+	free(worker.unblockStack);
+	free(worker.frames);
+	free(worker.b);
+	free(worker.blocked);
+	free(worker.stamps);
+	return TLS_STOP;
+}
+
+/**
+ * Enumerate the loops whose minimum vertex is @c root
+ *
+ * This is the function CIRCUIT of Johnson algorithm, with an explicit stack instead of recursion.
+ * When the search is cut by ::simple_loop_job::maxLength we can't tell whether the vertex reaches the root, so we treat it as if it did: the vertex
+ * is unblocked and can be visited again through a shorter path
+ *
+ * @param[inout] job the enumeration involved
+ * @param[inout] worker the state of the worker performing the search
+ * @param[in] root the dense index of the root
+ */
+static void visitLoopsFromRoot(struct simple_loop_job* job, struct simple_loop_worker* worker, unsigned int root) {
+	const csr_graph* csr = job->csr;
+	worker->stamp = root + 1;
+
+	touchVertex(worker, root);
+	worker->blocked[root] = true;
+	worker->frames[0].vertex = root;
+	worker->frames[0].nextEdge = csr->successorOffsets[root];
+	worker->frames[0].found = false;
+	unsigned int depth = 1;
+
+	while (depth > 0 && !job->stop) {
+		struct simple_loop_frame* frame = &worker->frames[depth - 1];
+		unsigned int v = frame->vertex;
+
+		// ******************** L1 ***************************
+		if (frame->nextEdge < csr->successorOffsets[v + 1]) {
+			unsigned int e = frame->nextEdge++;
+			unsigned int w = csr->successors[e];
+			if (!canBeInLoop(job, root, e, w)) {
+				continue;
+			}
+			if (w == root) {
+				//the path on the stack is a loop
+				emitLoop(job, worker, depth);
+				frame->found = true;
+				continue;
+			}
+			touchVertex(worker, w);
+			if (!worker->blocked[w]) {
+				if (depth == job->maxLength) {
+					//w may lead to the root, but the loop would be too long
+					frame->found = true;
+					continue;
+				}
+				worker->blocked[w] = true;
+				worker->frames[depth].vertex = w;
+				worker->frames[depth].nextEdge = csr->successorOffsets[w];
+				worker->frames[depth].found = false;
+				depth++;
+			}
+			continue;
+		}
+
+		// ******************** L2 ************************
+		depth--;
+		if (frame->found) {
+			unblockVertex(worker, v);
+			if (depth > 0) {
+				worker->frames[depth - 1].found = true;
+			}
+		} else {
+			CU_ITERATE_OVER_CSR_SUCCESSORS(csr, v, w, e) {
+				if (!canBeInLoop(job, root, e, w)) {
+					continue;
+				}
+				addToB(worker, w, v);
+			}
+		}
+	}
+}
+
+/**
+ * Reset the state of a vertex, if it has not been reached yet while enumerating the loops of the current root
+ *
+ * This avoids clearing the whole state of the worker for each root
+ *
+ * @param[inout] worker the worker involved
+ * @param[in] vertex the vertex involved
+ */
+static void touchVertex(struct simple_loop_worker* worker, unsigned int vertex) {
+	if (worker->stamps[vertex] == worker->stamp) {
+		return;
+	}
+	worker->stamps[vertex] = worker->stamp;
+	worker->blocked[vertex] = false;
+	worker->b[vertex].size = 0;
+}
+
+/**
+ * The function UNBLOCK of Johnson algorithm, with an explicit stack instead of recursion
+ *
+ * @param[inout] worker the worker involved
+ * @param[in] vertex the vertex to unblock
+ */
+static void unblockVertex(struct simple_loop_worker* worker, unsigned int vertex) {
+	unsigned int top = 0;
+	worker->blocked[vertex] = false;
+	worker->unblockStack[top++] = vertex;
+	while (top > 0) {
+		struct simple_loop_b* b = &worker->b[worker->unblockStack[--top]];
+		for (unsigned int i=0; i<b->size; i++) {
+			unsigned int w = b->vertices[i];
+			if (worker->blocked[w]) {
+				worker->blocked[w] = false;
+				worker->unblockStack[top++] = w;
+			}
+		}
+		b->size = 0;
+	}
+}
+
+/**
+ * Add a vertex to the set B of another one, if it is not there already
+ *
+ * @param[inout] worker the worker involved
+ * @param[in] vertex the vertex whose B needs to be updated
+ * @param[in] blockedVertex the vertex to unblock when @c vertex is unblocked
+ */
+static void addToB(struct simple_loop_worker* worker, unsigned int vertex, unsigned int blockedVertex) {
+	touchVertex(worker, vertex);
+	struct simple_loop_b* b = &worker->b[vertex];
+	for (unsigned int i=0; i<b->size; i++) {
+		if (b->vertices[i] == blockedVertex) {
+			return;
+		}
+	}
+	if (b->size == b->capacity) {
+		b->capacity = b->capacity == 0 ? 4 : (2 * b->capacity);
+		b->vertices = realloc(b->vertices, sizeof(unsigned int) * b->capacity);
+		if (b->vertices == NULL) {
+			ERROR_MALLOC();
+		}
+	}
+	b->vertices[b->size++] = blockedVertex;
+}
+
+/**
+ * Pass the path on the stack of a worker to the visitor of a ::simple_loop_job
+ *
+ * @param[inout] job the enumeration involved
+ * @param[inout] worker the worker who has found the loop
+ * @param[in] length the number of vertices in the loop
+ */
+static void emitLoop(struct simple_loop_job* job, struct simple_loop_worker* worker, unsigned int length) {
+	if (length < job->minLength) {
+		return;
+	}
+
+	if (job->visitor == NULL) {
+		unsigned long loopsFound;
+		do {
+			loopsFound = job->loopsFound;
+			if (loopsFound >= job->maxLoops) {
+				job->stop = true;
+				return;
+			}
+		} while (!__sync_bool_compare_and_swap(&job->loopsFound, loopsFound, loopsFound + 1));
+		if (loopsFound + 1 == job->maxLoops) {
+			job->stop = true;
+		}
+		return;
+	}
+
+	for (unsigned int i=0; i<length; i++) {
+		worker->loop[i] = job->nodes[worker->frames[i].vertex];
+	}
+	cuMutexLock(job->mutex);
+	if (!job->stop && job->loopsFound < job->maxLoops) {
+		job->loopsFound += 1;
+		if (!job->visitor(worker->loop, length, job->context) || job->loopsFound == job->maxLoops) {
+			job->stop = true;
+		}
+	}
+	cuMutexUnlock(job->mutex);
+}
+
+/**
+ * @param[in] job the enumeration involved
+ * @param[in] root the minimum vertex of the loops we are looking for
+ * @param[in] edgeIndex the index of an edge
+ * @param[in] sink the sink of the edge
+ * @return true if the edge can be part of a loop whose minimum vertex is @c root
+ */
+static bool canBeInLoop(const struct simple_loop_job* job, unsigned int root, unsigned int edgeIndex, unsigned int sink) {
+	if (job->traversable != NULL && !job->traversable[edgeIndex]) {
+		return false;
+	}
+	return sink >= root && job->components[sink] == job->components[root];
+}
+
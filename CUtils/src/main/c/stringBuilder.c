@@ -10,50 +10,84 @@
 #include "utility.h"
 #include "log.h"
 #include "errors.h"
-#include "errors.h"
 
 #include <stdarg.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+/**
+ * the maximum number of buffers written with a single \c writev call, if the system doesn't tell us
+ */
+#ifndef IOV_MAX
+#	define IOV_MAX 1024
+#endif
+
+/**
+ * A piece of string which has been filled in a rope string builder
+ */
+struct string_builder_chunk {
+	char* data;
+	///number of characters in ::string_builder_chunk::data. There is no '\0' terminator
+	size_t length;
+};
 
 struct string_builder {
 	/**
 	 * A pointer to the memory area where we're building the string
+	 *
+	 * In a rope builder, this is the last piece of the string
 	 */
 	CU_NULLABLE char* output;
 	/**
-	 * Length of the building string
+	 * Length of the string in ::string_builder::output
 	 *
 	 * Does **not** count the '\0' string terminator
 	 */
-	int length;
+	size_t length;
 	/**
 	 * size of the memory area pointed by ::string_builder::output
 	 */
-	int bufferSize;
+	size_t bufferSize;
 	/**
-	 * number of bytes we increase the area ::string_builder::output when it is filled
+	 * minimum number of bytes we increase the area ::string_builder::output when it is filled
 	 *
-	 * Always positive not 0
+	 * In a rope builder, this is the size of each chunk. Always positive not 0
+	 */
+	size_t resizeFactor;
+	/**
+	 * if true, when ::string_builder::output is filled, we don't enlarge it but we move it in ::string_builder::chunks
 	 */
-	int resizeFactor;
+	bool rope;
+	/**
+	 * the pieces of the string which come before ::string_builder::output. Always empty if the builder is not a rope
+	 */
+	struct string_builder_chunk* chunks;
+	///number of chunks in ::string_builder::chunks
+	int chunksNumber;
+	///number of cells allocated in ::string_builder::chunks
+	int chunksCapacity;
+	///sum of the lengths of ::string_builder::chunks
+	size_t chunksLength;
 };
 
-static void resizeOutput(CU_NOTNULL string_builder* sb);
-
-
+static string_builder* newStringBuilder(size_t resizeFactor, bool rope);
+static void ensureSpace(CU_NOTNULL string_builder* sb, size_t length);
+static void resizeOutput(CU_NOTNULL string_builder* sb, size_t bufferSize);
+static void sealOutput(CU_NOTNULL string_builder* sb);
+static void flattenChunks(CU_NOTNULL string_builder* sb);
+static void freeChunks(CU_NOTNULL string_builder* sb);
+static bool writeAll(int fd, struct iovec* iov, int iovcnt);
 
 string_builder* cuStringBulilderNew(CU_NULLABLE const char* startString, int resizeFactor) {
-	string_builder* sb = malloc(sizeof(string_builder));
-	if (sb == NULL) {
-		ERROR_MALLOC();
+	if (resizeFactor <= 0) {
+		ERROR_ON_CONSTRUCTION("string builder resize factor", "%d", resizeFactor);
 	}
-
-	sb->output = NULL;
-	sb->length = 0;
-	sb->bufferSize = 0;
-	sb->resizeFactor = 100;
+	string_builder* sb = newStringBuilder(resizeFactor, false);
 
 	if (startString != NULL) {
 		cuStringBuilderAppendString(sb, startString);
@@ -67,25 +101,45 @@ CU_DEFINE_DEFAULT_VALUES(cuStringBulilderNew,
         100
 );
 
+string_builder* cuStringBuilderNewRope(size_t chunkSize) {
+	return newStringBuilder(chunkSize, true);
+}
+
 void cuStringBuilderAppendString(CU_NOTNULL string_builder* sb, CU_NOTNULL const char* str) {
-	int strLength = strlen(str);
-	while (sb->bufferSize < (sb->length + strLength + 1)) {
-		resizeOutput(sb);
-	}
+	cuStringBuilderAppendStringWithLength(sb, str, strlen(str));
+}
 
-	strcpy(sb->output + sb->length, str);
-	sb->length += strLength;
+void cuStringBuilderAppendStringWithLength(CU_NOTNULL string_builder* sb, CU_NOTNULL const char* str, size_t length) {
+	ensureSpace(sb, length);
+	memcpy(sb->output + sb->length, str, length);
+	sb->length += length;
+	sb->output[sb->length] = '\0';
 }
 
 void cuStringBuilderAppendTemplate(CU_NOTNULL string_builder* sb, CU_NOTNULL const char* template, ...) {
-	char buffer[BUFFER_SIZE];
-
 	va_list vaList;
 	va_start(vaList, template);
-	int bytes = vsnprintf(buffer, BUFFER_SIZE, template, vaList);
+	cuStringBuilderAppendTemplateWithVaList(sb, template, vaList);
 	va_end(vaList);
+}
 
-	cuStringBuilderAppendString(sb, buffer);
+void cuStringBuilderAppendTemplateWithVaList(CU_NOTNULL string_builder* sb, CU_NOTNULL const char* template, va_list vaList) {
+	va_list copy;
+	//we try to print the string directly in the buffer. If it is too small, we enlarge it and we print the string again
+	ensureSpace(sb, 0);
+	va_copy(copy, vaList);
+	int bytes = vsnprintf(sb->output + sb->length, sb->bufferSize - sb->length, template, copy);
+	va_end(copy);
+	if (bytes < 0) {
+		ERROR_ON_APPLICATION("template", "%s", template, "string builder", "%p", sb);
+	}
+	if (((size_t) bytes) >= sb->bufferSize - sb->length) {
+		ensureSpace(sb, bytes);
+		va_copy(copy, vaList);
+		vsnprintf(sb->output + sb->length, bytes + 1, template, copy);
+		va_end(copy);
+	}
+	sb->length += bytes;
 }
 
 void appendStringToStringBuilder(CU_NOTNULL string_builder* sb, CU_NOTNULL const char* string) {
@@ -93,7 +147,10 @@ void appendStringToStringBuilder(CU_NOTNULL string_builder* sb, CU_NOTNULL const
 }
 
 void cuStringBuilderAppendChar(CU_NOTNULL string_builder* sb, char ch) {
-	cuStringBuilderAppendTemplate(sb, "%c", ch);
+	ensureSpace(sb, 1);
+	sb->output[sb->length] = ch;
+	sb->length += 1;
+	sb->output[sb->length] = '\0';
 }
 
 void cuStringBuilderAppendInt(CU_NOTNULL string_builder* sb, int i) {
@@ -112,46 +169,271 @@ void cuStringBuilderAppendLong(CU_NOTNULL string_builder* sb, long l) {
 	cuStringBuilderAppendTemplate(sb, "%ld", l);
 }
 
+void cuStringBuilderReserve(CU_NOTNULL string_builder* sb, size_t length) {
+	size_t current = cuStringBuilderGetLength(sb);
+	if (length > current) {
+		ensureSpace(sb, length - current);
+	}
+}
+
+size_t cuStringBuilderGetLength(CU_NOTNULL const string_builder* sb) {
+	return sb->chunksLength + sb->length;
+}
+
 char* cuStringBuilderGetString(CU_NOTNULL const string_builder* sb) {
+	//the string doesn't change: only the way it is stored does
+	flattenChunks((string_builder*) sb);
 	return sb->length > 0 ? sb->output : "";
 }
 
-void cuStringBuilderClear(CU_NOTNULL string_builder* sb) {
-	if (sb->output != NULL) {
-		free(sb->output);
-	}
+char* cuStringBuilderDetachString(CU_NOTNULL string_builder* sb) {
+	flattenChunks(sb);
+	ensureSpace(sb, 0);
+	char* retVal = sb->output;
+
 	sb->output = NULL;
 	sb->length = 0;
 	sb->bufferSize = 0;
+	return retVal;
+}
+
+bool cuStringBuilderWriteToFileDescriptor(CU_NOTNULL const string_builder* sb, int fd) {
+	struct iovec iov[IOV_MAX];
+	int iovcnt = 0;
+
+	for (int i=0; i<sb->chunksNumber; i++) {
+		iov[iovcnt].iov_base = sb->chunks[i].data;
+		iov[iovcnt].iov_len = sb->chunks[i].length;
+		iovcnt++;
+		if (iovcnt == IOV_MAX) {
+			if (!writeAll(fd, iov, iovcnt)) {
+				return false;
+			}
+			iovcnt = 0;
+		}
+	}
+	if (sb->length > 0) {
+		iov[iovcnt].iov_base = sb->output;
+		iov[iovcnt].iov_len = sb->length;
+		iovcnt++;
+	}
+	return writeAll(fd, iov, iovcnt);
+}
+
+bool cuStringBuilderWriteToFile(CU_NOTNULL const string_builder* sb, CU_NOTNULL FILE* f) {
+	for (int i=0; i<sb->chunksNumber; i++) {
+		if (fwrite(sb->chunks[i].data, sizeof(char), sb->chunks[i].length, f) != sb->chunks[i].length) {
+			return false;
+		}
+	}
+	return fwrite(sb->output, sizeof(char), sb->length, f) == sb->length;
+}
+
+void cuStringBuilderClear(CU_NOTNULL string_builder* sb) {
+	//the memory of the buffer is kept, so the builder can be reused without allocating it again
+	freeChunks(sb);
+	sb->length = 0;
+	if (sb->output != NULL) {
+		sb->output[0] = '\0';
+	}
 }
 
 void cuStringBulilderDestroy(CU_NOTNULL const string_builder* sb, CU_NULLABLE const struct var_args* context) {
+	freeChunks((string_builder*) sb);
+	CU_FREE(sb->chunks);
 	if (sb->output != NULL) {
 		CU_FREE(sb->output);
 	}
 	CU_FREE(sb);
 }
 
+/**
+ * Allocate a new empty string builder
+ *
+ * @param[in] resizeFactor see ::string_builder::resizeFactor
+ * @param[in] rope see ::string_builder::rope
+ * @return the string builder
+ */
+static string_builder* newStringBuilder(size_t resizeFactor, bool rope) {
+	if (resizeFactor == 0) {
+		ERROR_ON_CONSTRUCTION("string builder resize factor", "%zu", resizeFactor);
+	}
+	string_builder* sb = CU_MALLOC(string_builder);
+	if (sb == NULL) {
+		ERROR_MALLOC();
+	}
+
+	sb->output = NULL;
+	sb->length = 0;
+	sb->bufferSize = 0;
+	sb->resizeFactor = resizeFactor;
+	sb->rope = rope;
+	sb->chunks = NULL;
+	sb->chunksNumber = 0;
+	sb->chunksCapacity = 0;
+	sb->chunksLength = 0;
+
+	return sb;
+}
+
+/**
+ * Ensure ::string_builder::output can contain other \c length characters (plus the '\0' terminator)
+ *
+ * If the builder is not a rope, the buffer is enlarged geometrically, hence building a string costs linear time overall.
+ * Otherwise, if the buffer is not empty, it is moved in ::string_builder::chunks and a new buffer is allocated: the characters
+ * already in the builder are never copied.
+ *
+ * @param[inout] sb the string builder involved
+ * @param[in] length the number of characters we need to append
+ */
+static void ensureSpace(CU_NOTNULL string_builder* sb, size_t length) {
+	size_t needed = sb->length + length + 1;
+	if (needed <= sb->bufferSize) {
+		return;
+	}
+
+	if (sb->rope) {
+		if (sb->length > 0) {
+			sealOutput(sb);
+			needed = length + 1;
+		}
+		resizeOutput(sb, needed > sb->resizeFactor ? needed : sb->resizeFactor);
+	} else {
+		size_t bufferSize = sb->bufferSize + sb->resizeFactor;
+		if (bufferSize < 2 * sb->bufferSize) {
+			bufferSize = 2 * sb->bufferSize;
+		}
+		resizeOutput(sb, needed > bufferSize ? needed : bufferSize);
+	}
+}
+
 /**
  * Enalrge the memory pointed by ::string_builder::output
  *
  * Such pointer may change
  *
  * @param[inout] sb the strinb builder whose burffer we need to enlarge
+ * @param[in] bufferSize the new size of the buffer
  */
-static void resizeOutput(CU_NOTNULL string_builder* sb) {
-	char* newStr = calloc((sb->bufferSize + sb->resizeFactor), sizeof(char));
-	if (newStr == NULL) {
+static void resizeOutput(CU_NOTNULL string_builder* sb, size_t bufferSize) {
+	bool wasNull = sb->output == NULL;
+	sb->output = realloc(sb->output, bufferSize);
+	if (sb->output == NULL) {
 		ERROR_MALLOC();
 	}
+	if (wasNull) {
+		sb->output[0] = '\0';
+	}
+	sb->bufferSize = bufferSize;
+}
+
+/**
+ * Move ::string_builder::output at the end of ::string_builder::chunks
+ *
+ * After this call, the builder has no buffer
+ *
+ * @param[inout] sb the rope involved
+ */
+static void sealOutput(CU_NOTNULL string_builder* sb) {
+	if (sb->chunksNumber == sb->chunksCapacity) {
+		sb->chunksCapacity = sb->chunksCapacity == 0 ? 8 : 2 * sb->chunksCapacity;
+		sb->chunks = realloc(sb->chunks, sizeof(struct string_builder_chunk) * sb->chunksCapacity);
+		if (sb->chunks == NULL) {
+			ERROR_MALLOC();
+		}
+	}
+	sb->chunks[sb->chunksNumber].data = sb->output;
+	sb->chunks[sb->chunksNumber].length = sb->length;
+	sb->chunksNumber += 1;
+	sb->chunksLength += sb->length;
 
-	debug("output is \"%p\"", sb->output);
+	sb->output = NULL;
+	sb->length = 0;
+	sb->bufferSize = 0;
+}
+
+/**
+ * Join ::string_builder::chunks and ::string_builder::output in a single buffer
+ *
+ * The buffer is put in ::string_builder::output. Does nothing if there are no chunks
+ *
+ * @param[inout] sb the string builder involved
+ */
+static void flattenChunks(CU_NOTNULL string_builder* sb) {
+	if (sb->chunksNumber == 0) {
+		return;
+	}
+
+	size_t length = cuStringBuilderGetLength(sb);
+	char* output = malloc(length + 1);
+	if (output == NULL) {
+		ERROR_MALLOC();
+	}
+	size_t i = 0;
+	for (int j=0; j<sb->chunksNumber; j++) {
+		memcpy(output + i, sb->chunks[j].data, sb->chunks[j].length);
+		i += sb->chunks[j].length;
+	}
+	if (sb->length > 0) {
+		memcpy(output + i, sb->output, sb->length);
+	}
+	output[length] = '\0';
+
+	freeChunks(sb);
 	if (sb->output != NULL) {
-		debug("copying\"%s\" into newStr", sb->output);
-		strcpy(newStr, sb->output);
-		free(sb->output);
+		CU_FREE(sb->output);
+	}
+	sb->output = output;
+	sb->length = length;
+	sb->bufferSize = length + 1;
+}
+
+/**
+ * Release from memory all the ::string_builder::chunks
+ *
+ * The array containing them is kept
+ *
+ * @param[inout] sb the string builder involved
+ */
+static void freeChunks(CU_NOTNULL string_builder* sb) {
+	for (int i=0; i<sb->chunksNumber; i++) {
+		CU_FREE(sb->chunks[i].data);
 	}
-	sb->output = newStr;
-	sb->bufferSize += sb->resizeFactor;
+	sb->chunksNumber = 0;
+	sb->chunksLength = 0;
 }
 
+/**
+ * Write all the given buffers in a file descriptor
+ *
+ * Writes interrupted by a signal and partial writes are resumed
+ *
+ * @param[in] fd the file descriptor where to write
+ * @param[inout] iov the buffers to write. The array is altered
+ * @param[in] iovcnt the number of buffers in @c iov
+ * @return
+ *  @li true if all the buffers have been written;
+ *  @li false otherwise. @c errno is set accordingly
+ */
+static bool writeAll(int fd, struct iovec* iov, int iovcnt) {
+	while (iovcnt > 0) {
+		ssize_t written = writev(fd, iov, iovcnt);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		//skip the buffers fully written
+		while (iovcnt > 0 && ((size_t) written) >= iov->iov_len) {
+			written -= iov->iov_len;
+			iov++;
+			iovcnt--;
+		}
+		if (iovcnt > 0) {
+			iov->iov_base = ((char*) iov->iov_base) + written;
+			iov->iov_len -= written;
+		}
+	}
+	return true;
+}
@@ -9,18 +9,73 @@
 #include "topologicalOrder.h"
 #include "log.h"
 #include "errors.h"
+#include "csr_graph.h"
 
 static void doCormenTopologicalOrder(PredSuccGraph* graph, NodeList* output);
 static void doCormenTopologicalOrderRecursive(PredSuccGraph* graph, Node* n, NodeList* output);
+static void doKahnTopologicalOrder(const PredSuccGraph* graph, NodeList* output, const csr_graph* snapshot);
+static void doParallelLevelsTopologicalOrder(const PredSuccGraph* graph, NodeList* output, cu_parallel_thread_pool* pool, const csr_graph* snapshot);
 
-void cuStaticTopologicalOrderDoWith(to_impl implementation, PredSuccGraph* graph, NodeList* output) {
+void cuStaticTopologicalOrderDoWith(to_impl implementation, PredSuccGraph* graph, NodeList* output, CU_NULLABLE cu_parallel_thread_pool* pool, CU_NULLABLE const csr_graph* snapshot) {
 	switch (implementation) {
 	case TO_CORMEN:
 		doCormenTopologicalOrder(graph, output);
 		return;
+	case TO_KAHN:
+		doKahnTopologicalOrder(graph, output, snapshot);
+		return;
+	case TO_PARALLEL_LEVELS:
+		doParallelLevelsTopologicalOrder(graph, output, pool, snapshot);
+		return;
+	default:
+		ERROR_UNHANDLED_CASE("to_impl", implementation);
+	}
+}
+
+CU_DEFINE_DEFAULT_VALUES(cuStaticTopologicalOrderDoWith,
+		,
+		,
+		,
+		NULL,
+		NULL
+);
+
+int cuStaticTopologicalOrderComputeLevels(CU_NOTNULL const PredSuccGraph* graph, CU_NOTNULL list* output, CU_NULLABLE cu_parallel_thread_pool* pool, CU_NULLABLE const csr_graph* snapshot) {
+	const csr_graph* csr = snapshot != NULL ? snapshot : cuPredSuccGraphFreeze(graph);
+	unsigned int* order = malloc(sizeof(unsigned int) * (csr->size + 1));
+	unsigned int* levels = malloc(sizeof(unsigned int) * (csr->size + 1));
+	if (order == NULL || levels == NULL) {
+		ERROR_MALLOC();
+	}
+
+	unsigned int levelsNumber;
+	if (!cuCSRGraphParallelComputeTopologicalLevels(csr, pool, order, levels, &levelsNumber)) {
+		critical("we detected a cycle into the supposed DAG graph");
+		ERROR_APPLICATION_FAILED("topological ordering", "parallel levels", "graph", "graph");
 	}
+	for (unsigned int l=0; l<levelsNumber; l++) {
+		NodeList* level = cuListNew();
+		for (unsigned int i=levels[l]; i<levels[l+1]; i++) {
+			cuListAddTail(level, cuPredSuccGraphGetNodeById(graph, csr->ids[order[i]]));
+		}
+		cuListAddTail(output, level);
+	}
+
+	free(levels);
+	free(order);
+	if (snapshot == NULL) {
+		cuCSRGraphDestroy(csr, NULL);
+	}
+	return levelsNumber;
 }
 
+CU_DEFINE_DEFAULT_VALUES(cuStaticTopologicalOrderComputeLevels,
+		,
+		,
+		NULL,
+		NULL
+);
+
 //CORMEN
 
 #define CORMEN_WHITE 0
@@ -62,3 +117,49 @@ static void doCormenTopologicalOrderRecursive(PredSuccGraph* graph, Node* n, Nod
 }
 
 // END CORMEN
+
+//KAHN
+
+/**
+ * compute the topological order thanks to Kahn's algorithm, on a frozen copy of the graph (@c snapshot if not NULL)
+ */
+static void doKahnTopologicalOrder(const PredSuccGraph* graph, NodeList* output, const csr_graph* snapshot) {
+	const csr_graph* csr = snapshot != NULL ? snapshot : cuPredSuccGraphFreeze(graph);
+	unsigned int* order = malloc(sizeof(unsigned int) * (csr->size + 1));
+	if (order == NULL) {
+		ERROR_MALLOC();
+	}
+
+	if (!cuCSRGraphComputeTopologicalOrder(csr, order)) {
+		critical("we detected a cycle into the supposed DAG graph");
+		ERROR_APPLICATION_FAILED("topological ordering", "Kahn", "graph", "graph");
+	}
+	for (unsigned int i=0; i<csr->size; i++) {
+		cuListAddTail(output, cuPredSuccGraphGetNodeById(graph, csr->ids[order[i]]));
+	}
+
+	free(order);
+	if (snapshot == NULL) {
+		cuCSRGraphDestroy(csr, NULL);
+	}
+}
+
+// END KAHN
+
+//PARALLEL LEVELS
+
+/**
+ * compute the topological order level by level, exploiting the workers in @c pool, on a frozen copy of the graph (@c snapshot if not NULL)
+ */
+static void doParallelLevelsTopologicalOrder(const PredSuccGraph* graph, NodeList* output, cu_parallel_thread_pool* pool, const csr_graph* snapshot) {
+	list* levels = cuListNew();
+	cuStaticTopologicalOrderComputeLevels(graph, levels, pool, snapshot);
+	while (!cuListIsEmpty(levels)) {
+		NodeList* level = cuListPopFrom(levels);
+		cuListMoveContent(output, level);
+		cuListDestroy(level, NULL);
+	}
+	cuListDestroy(levels, NULL);
+}
+
+// END PARALLEL LEVELS
@@ -105,3 +105,14 @@ bool cuUtilsRangeInt(CU_NOTNULL const char* rangeStr, CU_NOTNULL int* restrict a
 bool cuUtilsRangeInt2(CU_NOTNULL const char* rangeStr, CU_NOTNULL struct cu_int_range* range) {
 	return cuUtilsRangeInt(rangeStr, &range->a, &range->b, &range->aIncluded, &range->bIncluded);
 }
+
+void* cuUtilsMallocArray(size_t cells, size_t cellSize) {
+	if (cellSize > 0 && cells > ((size_t)-1) / cellSize) {
+		ERROR_MALLOC();
+	}
+	void* result = malloc(cells > 0 ? cells * cellSize : 1);
+	if (result == NULL) {
+		ERROR_MALLOC();
+	}
+	return result;
+}
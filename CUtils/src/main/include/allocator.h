@@ -0,0 +1,284 @@
+/**
+ * @file
+ *
+ * Allocators the containers of the library can use to create their cells
+ *
+ * By default every container allocates each of its cells with a separate @c malloc and frees them one by one when it is destroyed.
+ * When a container holds millions of elements this is slow both while building it and while tearing it down.
+ * A ::cu_allocator let the container get its memory from somewhere else:
+ *
+ * @li ::cu_arena: a bump allocator. Allocating is just incrementing a pointer, freeing does nothing and all the memory
+ * 	is released at once with ::cuArenaReset or ::cuArenaDestroy;
+ * @li ::cu_slab: a pool of fixed-size blocks. Freed blocks go into a free list and are reused by the next allocations;
+ * @li ::cuAllocatorThreadCache: a @c malloc front end caching the freed blocks of small sizes in lists local to each thread,
+ * 	so that it can be shared among threads without any lock;
+ * @li ::cuAllocatorDefault: plain @c malloc and @c free;
+ *
+ * @code
+ * cu_arena* arena = cuArenaNew();
+ * list* l = cuListNew(cuPayloadFunctionsIntValue(), cuArenaGetAllocator(arena));
+ * for (int i=0; i<1000000; i++) {
+ * 	cuListAddTail(l, CU_CAST_INT2PTR(i));
+ * }
+ * //the cells are not freed one by one: the memory is given back only when the arena is destroyed
+ * cuListDestroy(l, NULL);
+ * cuArenaDestroy(arena, NULL);
+ * @endcode
+ *
+ * Containers accept a NULL allocator, meaning ::cuAllocatorDefault. The allocator needs to outlive every container using it.
+ * Clones of a container use the same allocator of the original one.
+ *
+ * @note
+ * only the cells of the containers are obtained from the allocator: the containers themselves and their internal arrays
+ * (e.g., the buckets of ::HT) are still allocated with @c malloc, so the containers still need to be destroyed before resetting the allocator.
+ *
+ * @author koldar
+ * @date Oct 16, 2026
+ */
+
+#ifndef ALLOCATOR_H_
+#define ALLOCATOR_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "macros.h"
+#include "var_args.h"
+
+/**
+ * An interface to a memory allocator
+ *
+ * Specific allocators embed this structure as their first field.
+ */
+typedef struct cu_allocator {
+	/**
+	 * Allocate a block of memory
+	 *
+	 * @param[inout] allocator the allocator involved
+	 * @param[in] size the size of the block to allocate
+	 * @return a block of at least @c size bytes, or NULL if there is no memory left
+	 */
+	void* (*allocate)(struct cu_allocator* allocator, size_t size);
+	/**
+	 * Release a block of memory
+	 *
+	 * @param[inout] allocator the allocator involved
+	 * @param[in] p a block previously returned by ::cu_allocator::allocate of this allocator
+	 * @param[in] size the size passed to ::cu_allocator::allocate when @c p has been allocated
+	 */
+	void (*deallocate)(struct cu_allocator* allocator, void* p, size_t size);
+	/**
+	 * true if ::cu_allocator::deallocate does nothing.
+	 *
+	 * Containers may use this flag to avoid visiting all their cells when they are destroyed
+	 */
+	bool releasesInBulk;
+} cu_allocator;
+
+/**
+ * A bump allocator
+ */
+typedef struct cu_arena cu_arena;
+
+/**
+ * A pool of blocks all with the same size
+ */
+typedef struct cu_slab cu_slab;
+
+/**
+ * @return an allocator using @c malloc and @c free. There is no need to destroy it
+ */
+CU_NOTNULL cu_allocator* cuAllocatorDefault();
+
+/**
+ * An allocator which caches in a list local to the calling thread the small blocks released.
+ *
+ * Blocks are allocated by @c malloc, so a block can be released by a thread different from the one which has allocated it.
+ * Blocks bigger than ::CU_ALLOCATOR_THREAD_CACHE_MAX_SIZE are not cached at all.
+ * The blocks cached by a thread are given back to the system when the thread terminates or when it calls ::cuAllocatorThreadCacheFlush.
+ *
+ * @return the allocator. There is no need to destroy it
+ */
+CU_NOTNULL cu_allocator* cuAllocatorThreadCache();
+
+/**
+ * the biggest block the allocator returned by ::cuAllocatorThreadCache caches
+ */
+#define CU_ALLOCATOR_THREAD_CACHE_MAX_SIZE 256
+
+/**
+ * Give back to the system all the blocks ::cuAllocatorThreadCache has cached for the calling thread
+ */
+void cuAllocatorThreadCacheFlush();
+
+/**
+ * Allocate a block with the given allocator
+ *
+ * @param[inout] allocator the allocator to use. NULL means ::cuAllocatorDefault
+ * @param[in] size the size of the block to allocate
+ * @return the block allocated. The function never returns NULL: if the allocation fails, the program is aborted
+ */
+CU_NOTNULL void* cuAllocatorAllocate(CU_NULLABLE cu_allocator* allocator, size_t size);
+
+/**
+ * Release a block allocated by ::cuAllocatorAllocate
+ *
+ * @param[inout] allocator the allocator which has allocated @c p. NULL means ::cuAllocatorDefault
+ * @param[in] p the block to release. Can be NULL
+ * @param[in] size the size passed to ::cuAllocatorAllocate when @c p has been allocated
+ */
+void cuAllocatorDeallocate(CU_NULLABLE cu_allocator* allocator, CU_NULLABLE const void* p, size_t size);
+
+/**
+ * @param[in] allocator the allocator involved. NULL means ::cuAllocatorDefault
+ * @return true if releasing the memory allocated by @c allocator is useless
+ */
+bool cuAllocatorReleasesInBulk(CU_NULLABLE const cu_allocator* allocator);
+
+/**
+ * Allocate a structure with the given allocator
+ *
+ * @code
+ * list_cell* cell = CU_ALLOCATOR_NEW(l->allocator, list_cell);
+ * @endcode
+ *
+ * @param[inout] allocator the ::cu_allocator to use. Can be NULL
+ * @param[in] type the type of the structure to allocate
+ */
+#define CU_ALLOCATOR_NEW(allocator, type) ((type*)cuAllocatorAllocate((allocator), sizeof(type)))
+
+/**
+ * Release a structure allocated via ::CU_ALLOCATOR_NEW
+ *
+ * @param[inout] allocator the ::cu_allocator used to allocate @c p
+ * @param[in] type the type of the structure to release
+ * @param[in] p the structure to release
+ */
+#define CU_ALLOCATOR_FREE(allocator, type, p) cuAllocatorDeallocate((allocator), (p), sizeof(type))
+
+/**
+ * Create a new arena
+ *
+ * The arena requests memory to the system in chunks of @c chunkSize bytes. Allocations bigger than @c chunkSize get a chunk on their own
+ *
+ * @param[in] chunkSize the size of each chunk
+ * @return the arena just created
+ */
+CU_NOTNULL cu_arena* cuArenaNew(size_t chunkSize);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(cu_arena*, cuArenaNew, size_t);
+#define cuArenaNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuArenaNew, 1, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuArenaNew,
+		64*1024
+);
+
+/**
+ * Destroy the arena and all the memory allocated from it
+ *
+ * @param[in] arena the arena to destroy
+ */
+void cuArenaDestroy(CU_NOTNULL const cu_arena* arena, CU_NULLABLE const struct var_args* context);
+#define CU_FUNCTION_POINTER_destructor_void_cuArenaDestroy_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
+
+/**
+ * Allocate a block from the arena
+ *
+ * Every block is aligned to the strictest alignment of the platform
+ *
+ * @param[inout] arena the arena involved
+ * @param[in] size the size of the block
+ * @return the block allocated
+ */
+CU_NOTNULL void* cuArenaAllocate(CU_NOTNULL cu_arena* arena, size_t size);
+
+/**
+ * Release all the blocks allocated from the arena at once
+ *
+ * The first chunk is kept for the next allocations, the others are given back to the system.
+ *
+ * @attention
+ * destroy the containers using the arena before resetting it: after the reset their cells are invalid
+ *
+ * @param[inout] arena the arena involved
+ */
+void cuArenaReset(CU_NOTNULL cu_arena* arena);
+
+/**
+ * @param[in] arena the arena involved
+ * @return the number of bytes allocated from the arena since its creation or its last reset
+ */
+size_t cuArenaGetAllocatedBytes(CU_NOTNULL const cu_arena* arena);
+
+/**
+ * @param[in] arena the arena involved
+ * @return an allocator using the arena. The allocator has the lifetime of the arena
+ */
+CU_NOTNULL cu_allocator* cuArenaGetAllocator(CU_NOTNULL cu_arena* arena);
+
+/**
+ * Create a new slab
+ *
+ * The slab requests to the system @c blocksPerChunk blocks at a time. Allocations bigger than @c blockSize are
+ * forwarded to @c malloc.
+ *
+ * @param[in] blockSize the size of each block of the slab
+ * @param[in] blocksPerChunk the number of blocks requested to the system at a time
+ * @return the slab just created
+ */
+CU_NOTNULL cu_slab* cuSlabNew(size_t blockSize, size_t blocksPerChunk);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(cu_slab*, cuSlabNew, size_t, size_t);
+#define cuSlabNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuSlabNew, 2, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuSlabNew,
+		,
+		1024
+);
+
+/**
+ * Destroy the slab and all the blocks allocated from it
+ *
+ * @param[in] slab the slab to destroy
+ */
+void cuSlabDestroy(CU_NOTNULL const cu_slab* slab, CU_NULLABLE const struct var_args* context);
+#define CU_FUNCTION_POINTER_destructor_void_cuSlabDestroy_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
+
+/**
+ * Allocate a block from the slab
+ *
+ * @param[inout] slab the slab involved
+ * @return a block of the size specified in ::cuSlabNew
+ */
+CU_NOTNULL void* cuSlabAllocate(CU_NOTNULL cu_slab* slab);
+
+/**
+ * Give back a block to the slab
+ *
+ * The block will be returned by the next ::cuSlabAllocate
+ *
+ * @param[inout] slab the slab involved
+ * @param[in] p a block allocated from @c slab
+ */
+void cuSlabFree(CU_NOTNULL cu_slab* slab, CU_NOTNULL const void* p);
+
+/**
+ * Release all the blocks allocated from the slab at once
+ *
+ * The chunks are kept for the next allocations.
+ *
+ * @attention
+ * destroy the containers using the slab before resetting it: after the reset their cells are invalid
+ *
+ * @param[inout] slab the slab involved
+ */
+void cuSlabReset(CU_NOTNULL cu_slab* slab);
+
+/**
+ * @param[in] slab the slab involved
+ * @return the size of each block of the slab
+ */
+size_t cuSlabGetBlockSize(CU_NOTNULL const cu_slab* slab);
+
+/**
+ * @param[in] slab the slab involved
+ * @return an allocator using the slab. The allocator has the lifetime of the slab
+ */
+CU_NOTNULL cu_allocator* cuSlabGetAllocator(CU_NOTNULL cu_slab* slab);
+
+#endif /* ALLOCATOR_H_ */
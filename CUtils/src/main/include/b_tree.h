@@ -0,0 +1,258 @@
+/**
+ * @file
+ *
+ * An ordered container implemented as a B+ tree
+ *
+ * The container has the same interface of ::rb_tree, but it is much more cache friendly: items are stored in the leaves,
+ * each leaf contains several items in a contiguous array and leaves are linked together. This means that:
+ *
+ * @li looking for an item touches a few nodes (a tree with 1 million items has about 4 levels);
+ * @li no node is allocated per item;
+ * @li ordered iterations and range scans walk the leaves sequentially;
+ *
+ * The size of the nodes can be tuned with ::CU_BTREE_NODE_SIZE.
+ *
+ * Like ::rb_tree, items are sorted via the ::orderer of the ::payload_functions and the same item can be added multiple times.
+ *
+ * @code
+ * b_tree* tree = cuBTreeNew(cuPayloadFunctionsIntValue());
+ * for (int i=0; i<100; i++) {
+ * 	cuBTreeAddItem(tree, CU_CAST_INT2PTR(i));
+ * }
+ * //print the items in [10, 20)
+ * CU_ITERATE_OVER_BTREE_RANGE(tree, CU_CAST_INT2PTR(10), CU_CAST_INT2PTR(20), item, void*) {
+ * 	printf("%d\n", CU_CAST_PTR2INT(item));
+ * }
+ * cuBTreeDestroy(tree, NULL);
+ * @endcode
+ *
+ * If you already have the items sorted, ::cuBTreeBulkLoad builds the tree in linear time.
+ *
+ * @author koldar
+ * @date Oct 16, 2026
+ */
+
+#ifndef B_TREE_H_
+#define B_TREE_H_
+
+#include <stdbool.h>
+#include "payload_functions.h"
+#include "typedefs.h"
+#include "macros.h"
+#include "allocator.h"
+#include "cutilsConfig.h"
+
+typedef struct b_tree b_tree;
+
+/**
+ * A position inside a ::b_tree
+ *
+ * @private
+ */
+typedef struct b_tree_cursor {
+	///the leaf containing the next item to return. NULL if there are no more items
+	const struct b_tree_node* leaf;
+	///the index of the next item to return inside ::b_tree_cursor::leaf
+	int index;
+	///if true, the iteration stops at the first item not less than ::b_tree_cursor::to
+	bool bounded;
+	const void* to;
+	///the last item returned
+	void* item;
+} b_tree_cursor;
+
+/**
+ * Creates a new B+ tree in the memory
+ *
+ * @param[in] functions set of functions to easily manage the payload. The ::orderer is used to sort the items
+ * @param[in] allocator the allocator used to create the nodes of the tree. NULL means @c malloc. See ::cu_allocator
+ * @return the instance of the tree
+ */
+b_tree* cuBTreeNew(payload_functions functions, CU_NULLABLE cu_allocator* allocator);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(b_tree*, cuBTreeNew, payload_functions, cu_allocator*);
+#define cuBTreeNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuBTreeNew, 2, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuBTreeNew,
+		,
+		NULL
+);
+
+/**
+ * Destroy the tree
+ *
+ * \note
+ * All the items in the tree **won't be released** from the memory at all!
+ * If you want to release them as well, use ::cuBTreeDestroyWithElements
+ *
+ * @param[in] tree the tree to free
+ * @param[in] context unused
+ */
+void cuBTreeDestroy(CU_NOTNULL const b_tree* tree, CU_NULLABLE const struct var_args* context);
+#define CU_FUNCTION_POINTER_destructor_void_cuBTreeDestroy_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
+
+/**
+ * like ::cuBTreeDestroy except that all items in the tree will be release from the memory as well
+ *
+ * @param[in] tree the tree to free
+ * @param[in] context passed to the destructor of the items
+ */
+void cuBTreeDestroyWithElements(CU_NOTNULL const b_tree* tree, CU_NULLABLE const struct var_args* context);
+#define CU_FUNCTION_POINTER_destructor_void_cuBTreeDestroyWithElements_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
+
+/**
+ * Adds an item inside the tree
+ *
+ * If the tree already contains items with the same order, @c payload is put after them
+ *
+ * @param[inout] tree the tree to alter
+ * @param[in] payload the item to add in the tree
+ * @return true
+ */
+bool cuBTreeAddItem(CU_NOTNULL b_tree* tree, CU_NULLABLE void* payload);
+
+/**
+ * Fill an empty tree with items already sorted
+ *
+ * This is much faster than adding the items one by one: the leaves are filled sequentially and the
+ * inner nodes are built bottom-up, in \f$ O(n) \f$.
+ *
+ * @pre
+ *  @li @c tree is empty;
+ *  @li @c items is sorted according to the ::orderer of the tree;
+ *
+ * @param[inout] tree the tree to fill
+ * @param[in] items the items to add. The array is not kept by the tree
+ * @param[in] n the number of items in @c items
+ */
+void cuBTreeBulkLoad(CU_NOTNULL b_tree* tree, CU_NOTNULL void* const* items, int n);
+
+/**
+ * @param[in] tree the tree to analyze
+ * @return the number of items inside the tree
+ */
+int cuBTreeGetSize(CU_NOTNULL const b_tree* tree);
+
+/**
+ * @param[in] tree the tree to analyze
+ * @return
+ *  \li true if the tree has no elements inside it;
+ *  \li false otherwise
+ */
+bool cuBTreeIsEmpty(CU_NOTNULL const b_tree* tree);
+
+/**
+ * @param[in] tree the tree to analyze
+ * @param[in] payload the item to look for
+ * @return
+ * 	\li true if \c tree has an item with the same order of \c payload;
+ * 	\li false otherwise
+ */
+bool cuBTreeContainsItem(CU_NOTNULL const b_tree* tree, CU_NULLABLE const void* payload);
+
+/**
+ * @param[in] tree the tree to analyze
+ * @return
+ * 	\li the minimum item inside the \c tree;
+ * 	\li NULL if the \c tree is empty
+ */
+void* cuBTreeGetMinimum(CU_NOTNULL const b_tree* tree);
+
+/**
+ * @param[in] tree the tree to analyze
+ * @return
+ * 	\li the maximum item inside the \c tree;
+ * 	\li NULL if the \c tree is empty
+ */
+void* cuBTreeGetMaximum(CU_NOTNULL const b_tree* tree);
+
+/**
+ * Removes an element from the \c tree
+ *
+ * If there are several items with the same order of @c payload, only one of them is removed
+ *
+ * @param[inout] tree the tree to alter
+ * @param[in] payload the item to look for
+ * @return
+ * 	\li true if the element has been found and has been removed in the tree;
+ * 	\li false if we couldn't find the \c paylaod in the tree
+ */
+bool cuBTreeRemoveItem(CU_NOTNULL b_tree* tree, CU_NULLABLE const void* payload);
+
+/**
+ * like ::cuBTreeRemoveItem but we release the item removed from the memory as well
+ *
+ * @param[inout] tree the tree to alter
+ * @param[in] payload the item to look for
+ * @return
+ * 	\li true if the element has been found and has been removed in the tree;
+ * 	\li false if we couldn't find the \c paylaod in the tree
+ */
+bool cuBTreeRemoveItemWithElement(CU_NOTNULL b_tree* tree, CU_NULLABLE const void* payload);
+
+/**
+ * @private
+ *
+ * @param[in] tree the tree to iterate over
+ * @return a cursor over all the items of the tree
+ */
+b_tree_cursor _cuBTreeGetFirstCursor(CU_NOTNULL const b_tree* tree);
+
+/**
+ * @private
+ *
+ * @param[in] tree the tree to iterate over
+ * @param[in] from the first item of the range, included
+ * @param[in] to the last item of the range, excluded
+ * @return a cursor over the items of the tree which are not less than @c from and less than @c to
+ */
+b_tree_cursor _cuBTreeGetRangeCursor(CU_NOTNULL const b_tree* tree, CU_NULLABLE const void* from, CU_NULLABLE const void* to);
+
+/**
+ * Move the cursor to the next item
+ *
+ * @private
+ *
+ * @param[in] tree the tree to iterate over
+ * @param[inout] cursor the cursor to move. If this function returns true, ::b_tree_cursor::item is the next item
+ * @return
+ *  @li true if there was another item;
+ *  @li false if the iteration is over
+ */
+bool _cuBTreeMoveCursor(CU_NOTNULL const b_tree* tree, CU_NOTNULL b_tree_cursor* cursor);
+
+/**
+ * Iterate over all the items in the tree, in ascending order
+ *
+ * \note
+ * The tree cannot be altered while iterating
+ *
+ * @param[in] atree the tree to iterate over
+ * @param[in] name the name of the variable containing the item
+ * @param[in] type the type of @c name
+ */
+#define CU_ITERATE_OVER_BTREE(atree, name, type) \
+	for (bool UV(treeloop)=true; UV(treeloop);) \
+		for (const b_tree* UV(tree)=(atree); UV(treeloop);) \
+			for (b_tree_cursor UV(cursor)=_cuBTreeGetFirstCursor(UV(tree)); UV(treeloop);) \
+				for (type name=(type)0; UV(treeloop); UV(treeloop)=false) \
+					for (; _cuBTreeMoveCursor(UV(tree), &UV(cursor)) && ((name=(type)UV(cursor).item), true); )
+
+/**
+ * Iterate over the items of the tree which are in [from, to), in ascending order
+ *
+ * \note
+ * The tree cannot be altered while iterating
+ *
+ * @param[in] atree the tree to iterate over
+ * @param[in] from the first item of the range, included
+ * @param[in] to the last item of the range, excluded
+ * @param[in] name the name of the variable containing the item
+ * @param[in] type the type of @c name
+ */
+#define CU_ITERATE_OVER_BTREE_RANGE(atree, from, to, name, type) \
+	for (bool UV(treeloop)=true; UV(treeloop);) \
+		for (const b_tree* UV(tree)=(atree); UV(treeloop);) \
+			for (b_tree_cursor UV(cursor)=_cuBTreeGetRangeCursor(UV(tree), (from), (to)); UV(treeloop);) \
+				for (type name=(type)0; UV(treeloop); UV(treeloop)=false) \
+					for (; _cuBTreeMoveCursor(UV(tree), &UV(cursor)) && ((name=(type)UV(cursor).item), true); )
+
+#endif /* B_TREE_H_ */
@@ -0,0 +1,187 @@
+/**
+ * @file
+ *
+ * A small framework to measure the throughput and the latency of pieces of code
+ *
+ * A ::cu_benchmark runs each case a few times without measuring it (warm-up) and then a fixed number of times measuring
+ * how long each run takes. The timings are summarized in a ::cu_benchmark_result, containing average, standard deviation and percentiles:
+ *
+ * @code
+ * static void* createList(int size, const struct var_args* context) {
+ * 	return cuListNew(cuPayloadFunctionsIntValue());
+ * }
+ *
+ * static void fillList(void* state, int size, const struct var_args* context) {
+ * 	for (int i=0; i<size; i++) {
+ * 		cuListAddTail(state, CU_CAST_INT2PTR(i));
+ * 	}
+ * }
+ *
+ * static void destroyList(void* state, const struct var_args* context) {
+ * 	cuListDestroy(state, NULL);
+ * }
+ *
+ * cu_benchmark* b = cuBenchmarkNew("list", 3, 10);
+ * for (int size=1000; size<=1000000; size *= 10) {
+ * 	cuBenchmarkRun(b, "list add tail", size, createList, fillList, destroyList, NULL);
+ * }
+ * cuBenchmarkPrint(b, stdout);
+ * cuBenchmarkSaveCSV(b, "list.csv");
+ * cuBenchmarkPlot(b, "list");
+ * cuBenchmarkDestroy(b, NULL);
+ * @endcode
+ *
+ * Only ::cu_benchmark_function is timed: the setup and the teardown of each run are not.
+ *
+ * @author koldar
+ * @date Oct 16, 2026
+ */
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "macros.h"
+#include "var_args.h"
+
+/**
+ * A collection of measurements
+ */
+typedef struct cu_benchmark cu_benchmark;
+
+/**
+ * The summary of the runs of a case of a benchmark
+ *
+ * Every time is in nanoseconds and refers to a whole run
+ */
+typedef struct cu_benchmark_result {
+	///name of the case. Owned by the benchmark
+	char* caseName;
+	///the size of the problem given to the case
+	int size;
+	///number of measured runs
+	int runs;
+	double average;
+	double standardDeviation;
+	double min;
+	double max;
+	///median
+	double p50;
+	double p90;
+	double p99;
+} cu_benchmark_result;
+
+/**
+ * Create the state a run of a case works on
+ *
+ * @param[in] size the size of the problem to generate
+ * @param[in] context the context passed to ::cuBenchmarkRun
+ * @return the state of the run. Can be NULL
+ */
+typedef void* (*cu_benchmark_setup)(int size, CU_NULLABLE const struct var_args* context);
+
+/**
+ * The code to measure
+ *
+ * @param[inout] state the value returned by the ::cu_benchmark_setup
+ * @param[in] size the size of the problem
+ * @param[in] context the context passed to ::cuBenchmarkRun
+ */
+typedef void (*cu_benchmark_function)(CU_NULLABLE void* state, int size, CU_NULLABLE const struct var_args* context);
+
+/**
+ * Release the state created by a ::cu_benchmark_setup
+ *
+ * @param[in] state the value returned by the ::cu_benchmark_setup
+ * @param[in] context the context passed to ::cuBenchmarkRun
+ */
+typedef void (*cu_benchmark_teardown)(CU_NULLABLE void* state, CU_NULLABLE const struct var_args* context);
+
+/**
+ * Create a new benchmark
+ *
+ * @param[in] name the name of the benchmark. Used as title of the plots
+ * @param[in] warmupRuns number of times each case is executed before starting measuring it
+ * @param[in] runs number of times each case is measured
+ * @return the benchmark just created
+ */
+CU_NOTNULL cu_benchmark* cuBenchmarkNew(CU_NOTNULL const char* name, int warmupRuns, int runs);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(cu_benchmark*, cuBenchmarkNew, const char*, int, int);
+#define cuBenchmarkNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuBenchmarkNew, 3, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuBenchmarkNew,
+		,
+		3,
+		10
+);
+
+/**
+ * Destroy the benchmark and all its results
+ *
+ * @param[in] b the benchmark to destroy
+ * @param[in] context unused
+ */
+void cuBenchmarkDestroy(CU_NOTNULL const cu_benchmark* b, CU_NULLABLE const struct var_args* context);
+#define CU_FUNCTION_POINTER_destructor_void_cuBenchmarkDestroy_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
+
+/**
+ * Measure a case of the benchmark
+ *
+ * Each run, warm-up included, calls @c setup, then @c function and then @c teardown. Only @c function is timed.
+ *
+ * @param[inout] b the benchmark involved
+ * @param[in] caseName the name of the case. It is copied
+ * @param[in] size the size of the problem given to the callbacks
+ * @param[in] setup the function creating the state of each run. If NULL, the state is NULL
+ * @param[in] function the code to measure
+ * @param[in] teardown the function releasing the state of each run. Can be NULL
+ * @param[in] context a value passed to all the callbacks
+ * @return the summary of the measurements. It is owned by @c b
+ */
+const cu_benchmark_result* cuBenchmarkRun(CU_NOTNULL cu_benchmark* b, CU_NOTNULL const char* caseName, int size, CU_NULLABLE cu_benchmark_setup setup, CU_NOTNULL cu_benchmark_function function, CU_NULLABLE cu_benchmark_teardown teardown, CU_NULLABLE const struct var_args* context);
+
+/**
+ * @param[in] b the benchmark involved
+ * @return the number of cases measured so far
+ */
+int cuBenchmarkGetResultsNumber(CU_NOTNULL const cu_benchmark* b);
+
+/**
+ * @param[in] b the benchmark involved
+ * @param[in] index the index of the result. Results are sorted by the time ::cuBenchmarkRun has been called
+ * @return the result requested
+ */
+CU_NOTNULL const cu_benchmark_result* cuBenchmarkGetResult(CU_NOTNULL const cu_benchmark* b, int index);
+
+/**
+ * Print a table with all the results
+ *
+ * @param[in] b the benchmark involved
+ * @param[inout] f the file where to write the table
+ */
+void cuBenchmarkPrint(CU_NOTNULL const cu_benchmark* b, CU_NOTNULL FILE* f);
+
+/**
+ * Save all the results in a csv file
+ *
+ * The csv has the columns @c benchmark, @c case, @c size, @c runs, @c average, @c stddev, @c min, @c p50, @c p90, @c p99, @c max and @c nsPerItem.
+ * Times are in nanoseconds.
+ *
+ * @param[in] b the benchmark involved
+ * @param[in] filePath the csv to create. It is overwritten if it exists
+ */
+void cuBenchmarkSaveCSV(CU_NOTNULL const cu_benchmark* b, CU_NOTNULL const char* filePath);
+
+/**
+ * Plot the results with gnuplot
+ *
+ * The plot has a series per case: the x axis is the size of the problem while the y axis is the average
+ * time required to process an element of the problem (i.e., the average time divided by the size).
+ * If the benchmark has no result yet, nothing is plotted
+ *
+ * @param[in] b the benchmark involved
+ * @param[in] output the name of the image to generate, without extension
+ */
+void cuBenchmarkPlot(CU_NOTNULL const cu_benchmark* b, CU_NOTNULL const char* output);
+
+#endif /* BENCHMARK_H_ */
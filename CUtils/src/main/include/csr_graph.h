@@ -0,0 +1,449 @@
+/**
+ * @file
+ *
+ * An immutable compressed sparse row (CSR) snapshot of a ::PredSuccGraph
+ *
+ * ::PredSuccGraph stores every node and every edge in a separate heap allocation and finds neighbours via hashtables: this is
+ * great when the graph changes, but algorithms reading the graph several times pay a lot of pointer chasing.
+ * A ::csr_graph remaps the vertices to dense indices (from 0 to <tt>size - 1</tt>) and stores the adjacency lists in contiguous arrays:
+ * the successors of the vertex @c i are <tt>successors[successorOffsets[i]]</tt> up to (excluded) <tt>successors[successorOffsets[i+1]]</tt>.
+ *
+ * @code
+ * PredSuccGraph* g = cuPredSuccGraphNew();
+ * //populate g
+ * csr_graph* csr = cuPredSuccGraphFreeze(g);
+ * unsigned int* components = malloc(sizeof(unsigned int) * csr->size);
+ * unsigned int sccs = cuCSRGraphComputeSCC(csr, components);
+ * CU_ITERATE_OVER_CSR_SUCCESSORS(csr, 0, sink, edgeIndex) {
+ * 	printf("%lu -> %lu\n", csr->ids[0], csr->ids[sink]);
+ * }
+ * free(components);
+ * cuCSRGraphDestroy(csr, NULL);
+ * @endcode
+ *
+ * @attention
+ * the snapshot does not copy the payloads of the nodes and of the edges, nor the edges themselves: they are shared with the original graph.
+ * So the snapshot is valid only as long as the original graph is not destroyed. Since the snapshot is not updated, altering the original graph
+ * won't be reflected in the snapshot: create a new one via ::cuPredSuccGraphFreeze
+ *
+ * @author koldar
+ * @date Oct 16, 2026
+ */
+
+#ifndef CSR_GRAPH_H_
+#define CSR_GRAPH_H_
+
+#include <stdbool.h>
+#include "macros.h"
+#include "var_args.h"
+#include "predsuccgraph.h"
+#include "flat_hashtable.h"
+#include "hashtable.h"
+#include "multithreading.h"
+
+/**
+ * A read only view of a ::PredSuccGraph with contiguous adjacency arrays
+ *
+ * All the arrays are indexed by the dense indices of the vertices, not by their ::NodeId
+ */
+typedef struct csr_graph {
+	///number of vertices
+	unsigned int size;
+	///number of edges
+	unsigned int edgesNumber;
+	///@c ids[i] is the ::NodeId of the vertex with dense index @c i. Ids are sorted ascending
+	NodeId* ids;
+	///maps a ::NodeId to its dense index plus 1. NULL if the snapshot has been mapped from a file: the ids are binary searched instead
+	flat_ht* indexOfId;
+	///@c vertexPayloads[i] is the payload of the vertex with dense index @c i
+	void** vertexPayloads;
+	///array of <tt>size + 1</tt> cells: the out edges of @c i are in <tt>[successorOffsets[i], successorOffsets[i+1])</tt>
+	unsigned int* successorOffsets;
+	///dense index of the sink of each edge. The sinks of a vertex are sorted ascending
+	unsigned int* successors;
+	///the payload of each edge
+	void** edgePayloads;
+	///the edge of the original graph each cell represents. NULL if the snapshot has been mapped from a file
+	Edge** edges;
+	///array of <tt>size + 1</tt> cells: the in edges of @c i are in <tt>[predecessorOffsets[i], predecessorOffsets[i+1])</tt>
+	unsigned int* predecessorOffsets;
+	///dense index of the source of each in edge
+	unsigned int* predecessors;
+	///index of each in edge inside ::csr_graph::successors, ::csr_graph::edgePayloads and ::csr_graph::edges
+	unsigned int* predecessorEdges;
+	///the file the arrays point into if the snapshot has been created by ::cuCSRGraphMap. NULL otherwise
+	void* mapping;
+	///number of bytes of ::csr_graph::mapping
+	size_t mappingSize;
+} csr_graph;
+
+/**
+ * The version of the files written by ::cuCSRGraphSave
+ *
+ * Increase it every time the layout of the file changes: ::cuCSRGraphMap refuses files with a different version
+ */
+#define CU_CSR_GRAPH_FILE_VERSION 1
+
+/**
+ * Create an immutable CSR snapshot of the given graph
+ *
+ * The predecessors are always available in the snapshot, even if @c g has been created without them.
+ *
+ * @param[in] g the graph to freeze
+ * @return a new snapshot of @c g. Destroy it via ::cuCSRGraphDestroy
+ */
+CU_NOTNULL csr_graph* cuPredSuccGraphFreeze(CU_NOTNULL const PredSuccGraph* g);
+
+/**
+ * Destroy the snapshot
+ *
+ * The original graph, its edges and its payloads are left untouched
+ *
+ * @param[in] g the snapshot to destroy. If it has been created by ::cuCSRGraphMap, the file is unmapped
+ */
+void cuCSRGraphDestroy(CU_NOTNULL const csr_graph* g, CU_NULLABLE const struct var_args* context);
+#define CU_FUNCTION_POINTER_destructor_void_cuCSRGraphDestroy_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
+
+/**
+ * Save the snapshot in a binary file which can be memory mapped via ::cuCSRGraphMap
+ *
+ * The file contains a versioned header, a checksum of the content and the arrays of the snapshot exactly as they are in memory,
+ * so the arrays are written with few large writes and no callback is involved.
+ *
+ * \attention
+ * payloads are stored by value, namely the pointers themselves are saved. This is fine if the payloads are integers (see ::CU_CAST_INT2PTR
+ * and ::cuPayloadFunctionsIntValue) or NULL, but pointers to other memory won't be valid anymore when the file is mapped
+ *
+ * @param[in] g the snapshot to save
+ * @param[in] filePath the file to create. If the file already exists, it is overwritten
+ */
+void cuCSRGraphSave(CU_NOTNULL const csr_graph* g, CU_NOTNULL const char* filePath);
+
+/**
+ * Open a file created by ::cuCSRGraphSave
+ *
+ * The file is memory mapped in read only mode and the arrays of the snapshot point directly into the mapping: no node, edge or hashtable
+ * is created, hence the snapshot can be used immediately even on huge graphs. The operating system loads the pages of the file only when the
+ * algorithms touch them.
+ *
+ * The returned snapshot has no ::csr_graph::indexOfId nor ::csr_graph::edges: ::cuCSRGraphGetIndexOfVertex uses a binary search and the
+ * traversers receive a temporary ::Edge whose vertices have only the id and the payload set.
+ * When you need to alter the graph, convert the snapshot with ::cuCSRGraphThaw.
+ *
+ * @code
+ * csr_graph* csr = cuCSRGraphMap("graph.bin");
+ * if (csr == NULL) {
+ * 	//not a valid graph file
+ * }
+ * //read only algorithms
+ * unsigned int sccs = cuCSRGraphComputeSCC(csr, components);
+ * //first write: we need a mutable graph
+ * PredSuccGraph* g = cuCSRGraphThaw(csr, false, cuPayloadFunctionsIntValue(), cuPayloadFunctionsIntValue());
+ * cuCSRGraphDestroy(csr, NULL);
+ * cuPredSuccGraphAddEdge(g, 1, 2, NULL);
+ * @endcode
+ *
+ * The structure of the snapshot is always validated, whatever @c verifyChecksum is: the offsets need to be non decreasing and within the edges
+ * and every dense index needs to be less than the number of vertices, so the algorithms never read outside the mapping. This reads the
+ * offsets, the ids and the indices of the file, but not the payloads.
+ *
+ * @param[in] filePath the file to open
+ * @param[in] verifyChecksum if true, the whole file is read in order to check its checksum as well. Disable it to avoid hashing the file at startup:
+ * 	a corruption of the payloads, or one which still leaves a well formed structure, is then not detected
+ * @return
+ *  @li the snapshot stored in the file;
+ *  @li NULL if the file is not a graph saved with the same ::CU_CSR_GRAPH_FILE_VERSION on a compatible machine, if it is truncated, if its
+ *  	structure is not well formed or if its checksum is wrong
+ */
+CU_NULLABLE csr_graph* cuCSRGraphMap(CU_NOTNULL const char* filePath, bool verifyChecksum);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(csr_graph*, cuCSRGraphMap, const char*, bool);
+#define cuCSRGraphMap(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuCSRGraphMap, 2, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuCSRGraphMap,
+		,
+		true
+);
+
+/**
+ * Create a mutable graph with the same vertices and edges of a snapshot
+ *
+ * The payloads are shared with the snapshot (they are not cloned). The snapshot can be destroyed after this call
+ *
+ * @param[in] g the snapshot to convert
+ * @param[in] enablePredecessors see ::cuPredSuccGraphNew
+ * @param[in] vertexPayload see ::cuPredSuccGraphNew
+ * @param[in] edgePayload see ::cuPredSuccGraphNew
+ * @return a new graph
+ */
+CU_NOTNULL PredSuccGraph* cuCSRGraphThaw(CU_NOTNULL const csr_graph* g, bool enablePredecessors, payload_functions vertexPayload, payload_functions edgePayload);
+
+/**
+ * @param[in] g the snapshot involved
+ * @param[in] id the id of a vertex in the original graph
+ * @return
+ *  @li the dense index of the vertex;
+ *  @li -1 if there is no vertex with id @c id
+ */
+long cuCSRGraphGetIndexOfVertex(CU_NOTNULL const csr_graph* g, NodeId id);
+
+/**
+ * @param[in] g the snapshot involved
+ * @param[in] index the dense index of a vertex
+ * @return the number of successors of the vertex
+ */
+unsigned int cuCSRGraphGetOutDegree(CU_NOTNULL const csr_graph* g, unsigned int index);
+
+/**
+ * @param[in] g the snapshot involved
+ * @param[in] index the dense index of a vertex
+ * @return the number of predecessors of the vertex
+ */
+unsigned int cuCSRGraphGetInDegree(CU_NOTNULL const csr_graph* g, unsigned int index);
+
+/**
+ * Visit the graph in breadth first order
+ *
+ * @param[in] g the snapshot to visit
+ * @param[in] source the dense index of the vertex where to start from
+ * @param[in] traverser a function telling if we can go through an edge. NULL means every edge can be traversed
+ * @param[out] order an array of at least @c g->size cells. When the function returns, it contains the dense indices of the vertices reached, in the order they have been visited
+ * @param[out] distances an array of at least @c g->size cells. When the function returns, it contains the number of edges between @c source and every vertex (-1 if the vertex is not reachable). Can be NULL
+ * @return the number of vertices visited (hence the number of cells of @c order populated)
+ */
+unsigned int cuCSRGraphBFS(CU_NOTNULL const csr_graph* g, unsigned int source, CU_NULLABLE bool (*traverser)(const Edge* edge), CU_NOTNULL unsigned int* order, CU_NULLABLE int* distances);
+
+/**
+ * A function telling if a visit can go through an edge
+ *
+ * It plays the role ::edge_traverser has in the algorithms working on a ::PredSuccGraph, but it only accepts or refuses an edge:
+ * there is no way to stop the whole visit from here (use a ::cu_bfs_level_visitor for that). Since it may be called by several workers at once,
+ * it needs to be thread safe
+ *
+ * @param[in] edge the edge to check
+ * @return true if the edge can be traversed
+ */
+typedef bool (*cu_bfs_edge_filter)(const Edge* edge);
+
+/**
+ * A function called by ::cuCSRGraphParallelBFS every time a level of the visit has been discovered
+ *
+ * @param[in] g the snapshot visited
+ * @param[in] level the distance between the source and all the vertices in @c frontier
+ * @param[in] frontier the dense indices of the vertices at distance @c level from the source. The order within a level is unspecified
+ * @param[in] frontierSize the number of cells in @c frontier
+ * @param[in] context the context passed to ::cuCSRGraphParallelBFS
+ * @return
+ *  @li true if the visit should go on with the next level;
+ *  @li false to stop the visit. @c frontier is the last level visited
+ */
+typedef bool (*cu_bfs_level_visitor)(CU_NOTNULL const csr_graph* g, int level, CU_NOTNULL const unsigned int* frontier, unsigned int frontierSize, CU_NULLABLE const struct var_args* context);
+
+/**
+ * Visit the graph in breadth first order, level by level, with several workers
+ *
+ * Each level is visited either top down (the workers scan the out edges of the frontier, claiming the sinks atomically) or bottom up
+ * (the workers scan the in edges of every vertex not reached yet, stopping at the first one coming from the frontier).
+ * The visit starts top down and switches to bottom up when the out edges of the frontier outnumber the edges left to explore (see ::CSR_BFS_ALPHA),
+ * namely when most of the edges scanned top down would lead to vertices already reached. It goes back to top down when the frontier shrinks below a fraction of the graph (see ::CSR_BFS_BETA).
+ * Since every level is visited as a whole, distances are the same of ::cuCSRGraphBFS, while the order of the vertices within a level is not.
+ *
+ * @code
+ * cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(16);
+ * int* distances = malloc(sizeof(int) * csr->size);
+ * cuCSRGraphParallelBFS(csr, 0, NULL, pool, NULL, distances);
+ * @endcode
+ *
+ * @attention
+ * @c traverser and @c visitor are called by the workers of @c pool at the same time, so they need to be thread safe
+ *
+ * @param[in] g the snapshot to visit
+ * @param[in] source the dense index of the vertex where to start from
+ * @param[in] traverser a function telling if we can go through an edge. NULL means every edge can be traversed
+ * @param[inout] pool the workers visiting each level. If NULL, the visit is performed by the calling thread
+ * @param[out] order an array of at least @c g->size cells. When the function returns, it contains the dense indices of the vertices reached, level after level. Can be NULL
+ * @param[out] distances an array of at least @c g->size cells. When the function returns, it contains the number of edges between @c source and every vertex (-1 if the vertex has not been reached). Can be NULL
+ * @param[out] parents an array of at least @c g->size cells. When the function returns, it contains the dense index of the vertex from which each vertex has been reached
+ * 	(@c source for @c source itself, @c UINT_MAX if the vertex has not been reached). Can be NULL
+ * @param[in] visitor a function called with every level, from the source onwards. NULL if you don't need it
+ * @param[in] context a value passed to @c visitor
+ * @return the number of vertices reached
+ */
+unsigned int cuCSRGraphParallelBFS(CU_NOTNULL const csr_graph* g, unsigned int source, CU_NULLABLE cu_bfs_edge_filter traverser, CU_NULLABLE cu_parallel_thread_pool* pool, CU_NULLABLE unsigned int* order, CU_NULLABLE int* distances, CU_NULLABLE unsigned int* parents, CU_NULLABLE cu_bfs_level_visitor visitor, CU_NULLABLE const struct var_args* context);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(unsigned int, cuCSRGraphParallelBFS, const csr_graph*, unsigned int, cu_bfs_edge_filter, cu_parallel_thread_pool*, unsigned int*, int*, unsigned int*, cu_bfs_level_visitor, const struct var_args*);
+#define cuCSRGraphParallelBFS(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuCSRGraphParallelBFS, 9, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuCSRGraphParallelBFS,
+		,
+		,
+		NULL,
+		NULL,
+		NULL,
+		NULL,
+		NULL,
+		NULL,
+		NULL
+);
+
+/**
+ * Compute the hop distance between a vertex and all the vertices reachable from it
+ *
+ * This is a convenience wrapper of ::cuCSRGraphParallelBFS: unless @c snapshot is given, the graph is frozen (see ::cuPredSuccGraphFreeze)
+ * by the calling thread at every call, which takes longer than the visit itself on large graphs. The bottom up steps can be used
+ * even if @c g has been created without predecessors.
+ * If you visit the same graph several times, freeze it once and pass the snapshot, or work directly on the snapshot with ::cuCSRGraphParallelBFS.
+ *
+ * @param[in] g the graph to visit
+ * @param[in] sourceId the id of the vertex where to start from
+ * @param[in] traverser a function telling if we can go through an edge. NULL means every edge can be traversed
+ * @param[inout] pool the workers visiting the graph. If NULL, the visit is performed by the calling thread
+ * @param[out] distances when the function returns, it maps the id of every vertex reached to its distance from @c sourceId. Can be NULL
+ * @param[out] parents when the function returns, it maps the id of every vertex reached to the id of the vertex from which it has been reached. Can be NULL
+ * @param[in] snapshot a snapshot of @c g, taken after its last change. If NULL, a new snapshot is created and destroyed within the call
+ * @return the number of vertices reachable from @c sourceId (@c sourceId included)
+ */
+unsigned int cuPredSuccGraphParallelBFS(CU_NOTNULL const PredSuccGraph* g, NodeId sourceId, CU_NULLABLE cu_bfs_edge_filter traverser, CU_NULLABLE cu_parallel_thread_pool* pool, CU_NULLABLE pint_ht* distances, CU_NULLABLE pint_ht* parents, CU_NULLABLE const csr_graph* snapshot);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(unsigned int, cuPredSuccGraphParallelBFS, const PredSuccGraph*, NodeId, cu_bfs_edge_filter, cu_parallel_thread_pool*, pint_ht*, pint_ht*, const csr_graph*);
+#define cuPredSuccGraphParallelBFS(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuPredSuccGraphParallelBFS, 7, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuPredSuccGraphParallelBFS,
+		,
+		,
+		NULL,
+		NULL,
+		NULL,
+		NULL,
+		NULL
+);
+
+/**
+ * Visit the graph in depth first order
+ *
+ * The visit is iterative, so it won't overflow the stack on deep graphs.
+ *
+ * @param[in] g the snapshot to visit
+ * @param[in] source the dense index of the vertex where to start from
+ * @param[in] traverser a function telling if we can go through an edge. NULL means every edge can be traversed
+ * @param[out] order an array of at least @c g->size cells. When the function returns, it contains the dense indices of the vertices reached, in preorder
+ * @return the number of vertices visited (hence the number of cells of @c order populated)
+ */
+unsigned int cuCSRGraphDFS(CU_NOTNULL const csr_graph* g, unsigned int source, CU_NULLABLE bool (*traverser)(const Edge* edge), CU_NOTNULL unsigned int* order);
+
+/**
+ * Check if one vertex is reachable from another one
+ *
+ * This is the CSR counterpart of ::cuPredSuccGraphIsVertexReachableFromVertex
+ *
+ * @param[in] g the snapshot involved
+ * @param[in] sourceId the id of the vertex where to start the reachability question
+ * @param[in] sinkId the id of the vertex to reach
+ * @param[in] traverser a function telling if we can go through an edge. NULL means every edge can be traversed
+ * @return
+ *  @li true if it exists a path from @c sourceId till @c sinkId;
+ *  @li false otherwise
+ */
+bool cuCSRGraphIsVertexReachableFromVertex(CU_NOTNULL const csr_graph* g, NodeId sourceId, NodeId sinkId, CU_NULLABLE bool (*traverser)(const Edge* edge));
+
+/**
+ * Compute the strongly connected components of the graph
+ *
+ * The implementation is an iterative version of Tarjan algorithm.
+ *
+ * @param[in] g the snapshot involved
+ * @param[out] components an array of at least @c g->size cells. When the function returns, @c components[i] is the
+ * 	component of the vertex with dense index @c i. Components are numbered in reverse topological order: if there is an edge from component @c a to component @c b, then <tt>a > b</tt>
+ * @return the number of strongly connected components
+ */
+unsigned int cuCSRGraphComputeSCC(CU_NOTNULL const csr_graph* g, CU_NOTNULL unsigned int* components);
+
+/**
+ * Compute the strongly connected components of the graph with several workers
+ *
+ * The implementation follows the Multistep approach:
+ * @li vertices with no in edge or no out edge left are trimmed away in parallel, since each of them is a component on its own;
+ * @li the component of the vertex with the most edges (usually the giant one) is computed as the intersection of a parallel forward and backward visit;
+ * @li the remaining components are found by colouring: every vertex takes the highest dense index reaching it, then the vertices
+ * 	with the same colour reaching back its root form a component. The backward visits of different colours are run by different workers;
+ * @li when only a few vertices are left, they are handled by Tarjan algorithm on the calling thread.
+ *
+ * Components are numbered exactly like ::cuCSRGraphComputeSCC, namely in reverse topological order. Among the numberings satisfying such constraint
+ * the one chosen does not depend on the workers, so the same graph always gets the same numbering.
+ *
+ * @param[in] g the snapshot involved
+ * @param[in] included an array of @c g->size cells telling which vertices are considered: the other ones and their edges are ignored. NULL means every vertex is considered
+ * @param[in] traversable an array of @c g->edgesNumber cells telling which edges can be traversed. NULL means every edge can be traversed
+ * @param[inout] pool the workers computing the components. If NULL, Tarjan algorithm is run on the calling thread
+ * @param[out] components an array of at least @c g->size cells. When the function returns, @c components[i] is the component of the vertex with dense
+ * 	index @c i (@c UINT_MAX if the vertex is not included)
+ * @return the number of strongly connected components
+ */
+unsigned int cuCSRGraphParallelComputeSCC(CU_NOTNULL const csr_graph* g, CU_NULLABLE const bool* included, CU_NULLABLE const bool* traversable, CU_NULLABLE cu_parallel_thread_pool* pool, CU_NOTNULL unsigned int* components);
+
+/**
+ * Compute a topological order of the graph
+ *
+ * The implementation is Kahn algorithm
+ *
+ * @param[in] g the snapshot involved
+ * @param[out] order an array of at least @c g->size cells. When the function returns true, it contains the dense indices of the vertices in topological order
+ * @return
+ *  @li true if @c g is a DAG (and thus @c order is populated);
+ *  @li false if @c g contains a cycle
+ */
+bool cuCSRGraphComputeTopologicalOrder(CU_NOTNULL const csr_graph* g, CU_NOTNULL unsigned int* order);
+
+/**
+ * Compute a topological order of the graph, split in levels, exploiting several threads
+ *
+ * The implementation is Kahn algorithm, processed level by level: the first level contains the vertices without in edges, while the level @c l+1 contains the
+ * vertices whose predecessors are all in the levels up to @c l. Hence the vertices in the same level are an antichain and can be processed concurrently.
+ * The workers share the vertices of a level and decrement the in degrees of their successors atomically.
+ * Each level is sorted by dense index, so the output does not depend on the number of workers.
+ *
+ * @param[in] g the snapshot involved
+ * @param[inout] pool the workers processing the levels. If NULL, the levels are processed by the calling thread
+ * @param[out] order an array of at least @c g->size cells. When the function returns true, it contains the dense indices of the vertices in topological order
+ * @param[out] levels an array of at least <tt>g->size + 1</tt> cells. When the function returns true, the level @c l is made up of the vertices from
+ * 	<tt>order[levels[l]]</tt> up to (excluded) <tt>order[levels[l+1]]</tt>
+ * @param[out] levelsNumber the number of levels computed
+ * @return
+ *  @li true if @c g is a DAG (and thus @c order and @c levels are populated);
+ *  @li false if @c g contains a cycle
+ */
+bool cuCSRGraphParallelComputeTopologicalLevels(CU_NOTNULL const csr_graph* g, CU_NULLABLE cu_parallel_thread_pool* pool, CU_NOTNULL unsigned int* order, CU_NOTNULL unsigned int* levels, CU_NOTNULL unsigned int* levelsNumber);
+
+/**
+ * Iterate over the out edges of a vertex
+ *
+ * @code
+ * CU_ITERATE_OVER_CSR_SUCCESSORS(csr, i, sink, edgeIndex) {
+ * 	printf("%u -> %u (payload %p)\n", i, sink, csr->edgePayloads[edgeIndex]);
+ * }
+ * @endcode
+ *
+ * @param[in] g the ::csr_graph involved
+ * @param[in] index the dense index of the source vertex
+ * @param[in] sinkName name of the variable of type <tt>unsigned int</tt> containing the dense index of the sink
+ * @param[in] edgeIndexName name of the variable of type <tt>unsigned int</tt> containing the index of the edge in the arrays of the snapshot
+ */
+#define CU_ITERATE_OVER_CSR_SUCCESSORS(g, index, sinkName, edgeIndexName) \
+	for (bool UV(csrLoop) = true; UV(csrLoop); ) \
+		for (const csr_graph* UV(csr) = (g); UV(csrLoop); ) \
+			for (unsigned int sinkName = 0; UV(csrLoop); UV(csrLoop) = false) \
+				for (unsigned int edgeIndexName = UV(csr)->successorOffsets[(index)], UV(end) = UV(csr)->successorOffsets[(index) + 1]; \
+					edgeIndexName < UV(end) && ((sinkName = UV(csr)->successors[edgeIndexName]), true); \
+					edgeIndexName++)
+
+/**
+ * Iterate over the in edges of a vertex
+ *
+ * @param[in] g the ::csr_graph involved
+ * @param[in] index the dense index of the sink vertex
+ * @param[in] sourceName name of the variable of type <tt>unsigned int</tt> containing the dense index of the source
+ * @param[in] edgeIndexName name of the variable of type <tt>unsigned int</tt> containing the index of the edge in the arrays of the snapshot
+ */
+#define CU_ITERATE_OVER_CSR_PREDECESSORS(g, index, sourceName, edgeIndexName) \
+	for (bool UV(csrLoop) = true; UV(csrLoop); ) \
+		for (const csr_graph* UV(csr) = (g); UV(csrLoop); ) \
+			for (unsigned int sourceName = 0, edgeIndexName = 0; UV(csrLoop); UV(csrLoop) = false) \
+				for (unsigned int UV(i) = UV(csr)->predecessorOffsets[(index)], UV(end) = UV(csr)->predecessorOffsets[(index) + 1]; \
+					UV(i) < UV(end) && ((sourceName = UV(csr)->predecessors[UV(i)]), (edgeIndexName = UV(csr)->predecessorEdges[UV(i)]), true); \
+					UV(i)++)
+
+#endif /* CSR_GRAPH_H_ */
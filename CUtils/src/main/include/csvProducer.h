@@ -16,6 +16,25 @@
  * cuCSVHelperDestroy(csvHelper);
  * @endcode
  *
+ * <h2>Buffered rows</h2>
+ *
+ * ::cuCSVHelperprintDataRow calls \c fprintf on every row, parsing the format each time. If you need to write lots of rows, use
+ * ::cuCSVHelperPrintRow or ::cuCSVHelperPrintRows instead: the type of each column is computed once from the template and
+ * the cells are formatted in a big buffer, which is written in the file only when it is full:
+ *
+ * @code
+ * csv_helper* csvHelper = cuCSVHelperNew("test.csv", ',', '\n', "%d %ld %.3f %s", {"a", "b", "c", "d"}, "w");
+ * //optional: use a 4MB buffer and write it in the file from another thread
+ * cuCSVHelperEnableBuffering(csvHelper, 4 << 20, true);
+ * cuCSVHelperPrintRow(csvHelper, 0, 4L, 0.5, "first data");
+ * csv_cell cells[] = {{.i = 1}, {.l = 5}, {.d = 1.5}, {.s = "second data"}, {.i = 2}, {.l = 6}, {.d = 2.5}, {.s = "third data"}};
+ * cuCSVHelperPrintRows(csvHelper, cells, 2);
+ * cuCSVHelperDestroy(csvHelper);
+ * @endcode
+ *
+ * The columns formatted as \c %d, \c %ld, \c %f or \c %.Nf (with N up to 9) don't use \c printf at all. The other formats are still supported
+ * via \c snprintf.
+ *
  * @date Dec 26, 2016
  * @author koldar
  */
@@ -28,6 +47,22 @@
 #include "macros.h"
 #include "var_args.h"
 
+/**
+ * The value of a cell printed with ::cuCSVHelperPrintRows
+ *
+ * The field to set depends on the format of the column in the template:
+ * @li \c i for the integer formats, like \c %d , \c %x or \c %c ;
+ * @li \c l for the long formats, like \c %ld ;
+ * @li \c d for the floating point formats, like \c %f or \c %g ;
+ * @li \c s for \c %s ;
+ */
+typedef union csv_cell {
+	int i;
+	long l;
+	double d;
+	const char* s;
+} csv_cell;
+
 /**
  * The main structure used to fully use the functions inside the module
  */
@@ -70,6 +105,10 @@ typedef struct csv_helper {
 	 * When using ::cuCSVHelperPrintSingleDataInRow, determine which is the column that we need to print
 	 */
 	int nextColumnIndex;
+	/**
+	 * The buffer where ::cuCSVHelperPrintRow and ::cuCSVHelperPrintRows format the rows. NULL if they have never been called
+	 */
+	struct csv_buffered_writer* writer;
 } csv_helper;
 
 
@@ -91,6 +130,8 @@ csv_helper* cuCSVHelperNew(const char* filePath, char delimiter, char carriageRe
 /**
  * Free the memory from the helper
  *
+ * The buffered rows are written in the file
+ *
  * @param[in] csvHelper the structure to remove from the memory
  */
 void cuCSVHelperDestroy(CU_NOTNULL const csv_helper* csvHelper, CU_NULLABLE const struct var_args* context);
@@ -104,9 +145,57 @@ void cuCSVHelperDestroy(CU_NOTNULL const csv_helper* csvHelper, CU_NULLABLE cons
  */
 void cuCSVHelperprintDataRow(csv_helper* csvHelper, ...);
 
+/**
+ * Set up the buffer used by ::cuCSVHelperPrintRow and ::cuCSVHelperPrintRows
+ *
+ * If this function is not called, the first buffered row creates a buffer of ::CU_CSV_BUFFER_SIZE bytes, flushed by the caller thread.
+ *
+ * \pre
+ * 	\li no row has been printed with ::cuCSVHelperPrintRow or ::cuCSVHelperPrintRows yet;
+ *
+ * @param[inout] csvHelper the helper to alter
+ * @param[in] bufferSize the size in bytes of the buffer. The bigger, the fewer writes are performed on the file
+ * @param[in] backgroundFlush if true, a full buffer is written in the file by a dedicated thread while the caller formats the next rows
+ * 	in a second buffer of the same size
+ */
+void cuCSVHelperEnableBuffering(CU_NOTNULL csv_helper* csvHelper, size_t bufferSize, bool backgroundFlush);
+
+/**
+ * Prints a data row inside the csv buffer
+ *
+ * Like ::cuCSVHelperprintDataRow, but the row is formatted in a buffer which is written in the file only when it is full.
+ *
+ * \pre
+ * 	\li the number and the types of the data are the ones of the template. See ::csv_cell for the types to use for each format;
+ *
+ * @param[inout] csvHelper the helper referencing a CSV file
+ * @param[in] ... the data to print
+ */
+void cuCSVHelperPrintRow(CU_NOTNULL csv_helper* csvHelper, ...);
+
+/**
+ * Prints several data rows inside the csv buffer
+ *
+ * @param[inout] csvHelper the helper referencing a CSV file
+ * @param[in] cells the cells of the rows, one row after the other. It contains \c rows times ::csv_helper::headerSize cells
+ * @param[in] rows the number of rows to print
+ */
+void cuCSVHelperPrintRows(CU_NOTNULL csv_helper* csvHelper, CU_NOTNULL const csv_cell* cells, int rows);
+
+/**
+ * Write all the buffered rows in the file
+ *
+ * When the function returns, the rows have been written and the file has been flushed
+ *
+ * @param[inout] csvHelper the helper referencing a CSV file
+ */
+void cuCSVHelperFlush(CU_NOTNULL csv_helper* csvHelper);
+
 /**
  * Print the CSV header inside ::csv_helper::csvFile if not already done
  *
+ * The rows still in the buffer are written in the file as well, so that they come before any row printed directly in the file.
+ *
  * @private
  * \note
  * 	\li if the header has been already printed into the file, nothing is performed
@@ -0,0 +1,210 @@
+/**
+ * @file
+ *
+ * Represents a module allowing you to read csv files
+ *
+ * The file is memory mapped and indexed once when the reader is created: after that, every field can be accessed in constant time
+ * as a view over the mapped file, without copying it. The module understands the files generated by ::csv_helper: the optional
+ * <tt>sep=</tt> preamble sets the delimiter and the first row is the header.
+ *
+ * @code
+ * cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+ * csv_reader* reader = cuCSVReaderNew("test.csv", pool);
+ * int value = cuCSVReaderGetColumnIndex(reader, "value");
+ * double sum = 0;
+ * for (int row=0; row<cuCSVReaderGetRowsNumber(reader); row++) {
+ * 	double d;
+ * 	if (cuCSVReaderGetDouble(reader, row, value, &d)) {
+ * 		sum += d;
+ * 	}
+ * }
+ * csv_field description = cuCSVReaderGetField(reader, 0, cuCSVReaderGetColumnIndex(reader, "description"));
+ * printf("%.*s\n", description.length, description.start);
+ * cuCSVReaderDestroy(reader, NULL);
+ * cuParallelThreadPoolDestroy(pool, NULL);
+ * @endcode
+ *
+ * The file is split in one chunk per worker of the pool: each worker looks for the row boundaries and the delimiters in its own chunk.
+ * The scan uses \c memchr, which is vectorised by the C library.
+ *
+ * \note
+ * Fields are not unquoted: a delimiter always ends a field. Empty lines are ignored and a '\\r' before the '\\n' is not part of the row.
+ *
+ * @date Oct 16, 2026
+ * @author koldar
+ */
+
+#ifndef CSVREADER_H_
+#define CSVREADER_H_
+
+#include <stdbool.h>
+#include "macros.h"
+#include "var_args.h"
+#include "multithreading.h"
+
+typedef struct csv_reader csv_reader;
+
+/**
+ * A field of a csv file
+ *
+ * The field is **not** terminated by '\\0': it points directly into the file
+ */
+typedef struct csv_field {
+	///the first character of the field
+	const char* start;
+	///the number of characters of the field
+	int length;
+} csv_field;
+
+/**
+ * Open and index a csv file
+ *
+ * @param[in] filePath the path of the csv file to read
+ * @param[inout] pool the workers used to index the file. If NULL, the file is indexed by the calling thread
+ * @param[in] delimiter the character between two fields. If the file starts with a <tt>sep=</tt> preamble, the preamble wins
+ * @param[in] hasHeader true if the first row contains the names of the columns
+ * @return the reader of the file
+ */
+csv_reader* cuCSVReaderNew(CU_NOTNULL const char* filePath, CU_NULLABLE cu_parallel_thread_pool* pool, char delimiter, bool hasHeader);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(csv_reader*, cuCSVReaderNew, const char*, cu_parallel_thread_pool*, char, bool);
+#define cuCSVReaderNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuCSVReaderNew, 4, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuCSVReaderNew,
+		,
+		NULL,
+		',',
+		true
+);
+
+/**
+ * Close the file and release the reader from the memory
+ *
+ * \attention
+ * After this call, all the ::csv_field fetched from the reader are not valid anymore
+ *
+ * @param[in] reader the reader to destroy
+ * @param[in] context unused
+ */
+void cuCSVReaderDestroy(CU_NOTNULL const csv_reader* reader, CU_NULLABLE const struct var_args* context);
+#define CU_FUNCTION_POINTER_destructor_void_cuCSVReaderDestroy_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
+
+/**
+ * @param[in] reader the reader involved
+ * @return the number of data rows in the file. The header is not counted
+ */
+int cuCSVReaderGetRowsNumber(CU_NOTNULL const csv_reader* reader);
+
+/**
+ * @param[in] reader the reader involved
+ * @return the number of columns in the file, namely the number of fields in the first row
+ */
+int cuCSVReaderGetColumnsNumber(CU_NOTNULL const csv_reader* reader);
+
+/**
+ * @param[in] reader the reader involved
+ * @return the character used to separate the fields of a row
+ */
+char cuCSVReaderGetDelimiter(CU_NOTNULL const csv_reader* reader);
+
+/**
+ * @param[in] reader the reader involved
+ * @param[in] column the index of the column
+ * @return
+ *  @li the name of the column;
+ *  @li NULL if the file has no header
+ */
+const char* cuCSVReaderGetColumnName(CU_NOTNULL const csv_reader* reader, int column);
+
+/**
+ * @param[in] reader the reader involved
+ * @param[in] name the name of a column
+ * @return
+ *  @li the index of the first column named @c name;
+ *  @li -1 if there is no such column
+ */
+int cuCSVReaderGetColumnIndex(CU_NOTNULL const csv_reader* reader, CU_NOTNULL const char* name);
+
+/**
+ * Get a field of the file
+ *
+ * If the row has less fields than the header, the missing fields are empty
+ *
+ * @param[in] reader the reader involved
+ * @param[in] row the index of the data row
+ * @param[in] column the index of the column
+ * @return a view over the field
+ */
+csv_field cuCSVReaderGetField(CU_NOTNULL const csv_reader* reader, int row, int column);
+
+/**
+ * Convert a field of the file into an integer
+ *
+ * @param[in] reader the reader involved
+ * @param[in] row the index of the data row
+ * @param[in] column the index of the column
+ * @param[out] output if the function returns \c true, the pointer is populated with the converted value
+ * @return
+ * 	\li true if we were able to convert the field;
+ * 	\li false otherwise
+ */
+bool cuCSVReaderGetInt(CU_NOTNULL const csv_reader* reader, int row, int column, CU_NOTNULL int* output);
+
+/**
+ * like ::cuCSVReaderGetInt but for long
+ *
+ * @param[in] reader the reader involved
+ * @param[in] row the index of the data row
+ * @param[in] column the index of the column
+ * @param[out] output if the function returns \c true, the pointer is populated with the converted value
+ * @return
+ * 	\li true if we were able to convert the field;
+ * 	\li false otherwise
+ */
+bool cuCSVReaderGetLong(CU_NOTNULL const csv_reader* reader, int row, int column, CU_NOTNULL long* output);
+
+/**
+ * like ::cuCSVReaderGetInt but for double
+ *
+ * @param[in] reader the reader involved
+ * @param[in] row the index of the data row
+ * @param[in] column the index of the column
+ * @param[out] output if the function returns \c true, the pointer is populated with the converted value
+ * @return
+ * 	\li true if we were able to convert the field;
+ * 	\li false otherwise
+ */
+bool cuCSVReaderGetDouble(CU_NOTNULL const csv_reader* reader, int row, int column, CU_NOTNULL double* output);
+
+/**
+ * Convert a whole column of the file into integers
+ *
+ * @param[in] reader the reader involved
+ * @param[in] column the index of the column
+ * @param[out] output an array of ::cuCSVReaderGetRowsNumber cells which will contain the values of the column.
+ * 	The cells whose field can't be converted are left untouched
+ * @return the number of fields which couldn't be converted
+ */
+int cuCSVReaderGetIntColumn(CU_NOTNULL const csv_reader* reader, int column, CU_NOTNULL int* output);
+
+/**
+ * like ::cuCSVReaderGetIntColumn but for long
+ *
+ * @param[in] reader the reader involved
+ * @param[in] column the index of the column
+ * @param[out] output an array of ::cuCSVReaderGetRowsNumber cells which will contain the values of the column.
+ * 	The cells whose field can't be converted are left untouched
+ * @return the number of fields which couldn't be converted
+ */
+int cuCSVReaderGetLongColumn(CU_NOTNULL const csv_reader* reader, int column, CU_NOTNULL long* output);
+
+/**
+ * like ::cuCSVReaderGetIntColumn but for double
+ *
+ * @param[in] reader the reader involved
+ * @param[in] column the index of the column
+ * @param[out] output an array of ::cuCSVReaderGetRowsNumber cells which will contain the values of the column.
+ * 	The cells whose field can't be converted are left untouched
+ * @return the number of fields which couldn't be converted
+ */
+int cuCSVReaderGetDoubleColumn(CU_NOTNULL const csv_reader* reader, int column, CU_NOTNULL double* output);
+
+#endif /* CSVREADER_H_ */
@@ -51,6 +51,31 @@
 #	define CUTILS_ARRAY_SIZE 1000
 #endif
 
+/**
+ * The size, in bytes, of a node of a ::b_tree
+ *
+ * It determines the fan-out of the tree: it should be a small multiple of the size of a cache line
+ */
+#ifndef CU_BTREE_NODE_SIZE
+#	define CU_BTREE_NODE_SIZE 512
+#endif
+
+/**
+ * The default size, in bytes, of the buffer used by a ::csv_helper when ::cuCSVHelperEnableBuffering is not called explicitly
+ */
+#ifndef CU_CSV_BUFFER_SIZE
+#	define CU_CSV_BUFFER_SIZE (1 << 20)
+#endif
+
+/**
+ * The number of doubles buffered by a ::plot_2d_helper writing binary data before writing them in the data file
+ *
+ * @see cuPlot2DHelperSetBinaryData
+ */
+#ifndef CU_PLOT_BUFFER_SIZE
+#	define CU_PLOT_BUFFER_SIZE (1 << 16)
+#endif
+
 ///@}
 
 #endif /* CUTILSCONFIG_H_ */
@@ -514,5 +514,17 @@ int cuDefaultFunctionsEvaluatorObject(const void* p, const struct var_args* va);
 
 unsigned long hashString(const char* str);
 
+/**
+ * Hash a string by its content
+ *
+ * \ingroup hashfunction
+ *
+ * @param[in] str the string to hash
+ * @param[in] context unused
+ * @return the hash of @c str, the same of ::hashString
+ */
+unsigned long cuDefaultFunctionsHashString(CU_NOTNULL const char* str, CU_NULLABLE const struct var_args* context);
+#define CU_FUNCTION_POINTER_hashfunction_t_unsigned_long_cuDefaultFunctionsHashString_voidConstPtr_var_argsConstPtr CU_HASHFUNCTION_ID
+
 
 #endif /* DEFAULTFUNCTIONS_H_ */
@@ -39,7 +39,7 @@ typedef HT EdgeHT;
  * @param[in] source the source of the edge
  * @param[in] sink the sink of the edge
  * @param[in] payload the label of the edge
- * @return an edge in the heap. Be sure to clear it out with ::destroyEdge when not needed anymore
+ * @return an edge allocated with the allocator of @c source. Be sure to clear it out with ::destroyEdge when not needed anymore
  */
 Edge* newEdge(const struct Node* restrict source, const struct Node* restrict sink, const void* payload);
 
@@ -71,7 +71,8 @@ Edge* cloneEdgeWithPayload(const Edge* e, cloner payloadCloner);
  * Destroy an edge
  *
  * \warning
- * The function <b>won't free</b> the memory for the soource nor the sink of the edges. It will simply remove the edge itself
+ * The function <b>won't free</b> the memory for the soource nor the sink of the edges. It will simply remove the edge itself.
+ * Since the edge is released with the allocator of its source, the source needs to be still in memory
  *
  * @param[in] e the edge to remove
  */
@@ -0,0 +1,358 @@
+/**
+ * @file
+ *
+ * An hashtable indexed by `unsigned long` which stores keys and values inline in a single array
+ *
+ * ::HT is a front end to uthash: each entry is a separately allocated ::HTCell and each lookup follows bucket chains.
+ * ::flat_ht implements the same key-value mapping with open addressing (Robin Hood hashing with backward shift deletion):
+ * all the entries live in one contiguous array, hence no allocation is performed per entry and lookups touch
+ * (almost always) a single cache line.
+ *
+ * Use this module when the keys are integers (e.g., node ids) and lookups are on the hot path.
+ *
+ * @code
+ * flat_ht* ht = cuFlatHTNew(cuPayloadFunctionsIntValue());
+ *
+ * cuFlatHTAddItem(ht, 1, CU_CAST_INT2PTR(5));
+ * cuFlatHTAddItem(ht, 5, CU_CAST_INT2PTR(127));
+ *
+ * int value = CU_CAST_PTR2INT(cuFlatHTGetItem(ht, 5)); //127
+ *
+ * CU_ITERATE_OVER_FLATHT(ht, key, value, int_ptr) {
+ * 	printf("%lu -> %d\n", key, CU_CAST_PTR2INT(value));
+ * }
+ *
+ * cuFlatHTDestroy(ht, NULL);
+ * @endcode
+ *
+ * Differences with ::HT:
+ * @li a key can be present at most once: ::cuFlatHTAddItem on an existing key updates the value;
+ * @li pointers to slots are invalidated by any insertion or removal (the array might be reallocated or shifted);
+ * @li entries cannot be removed while iterating over the hashtable;
+ *
+ * @author koldar
+ * @date Oct 16, 2026
+ */
+
+#ifndef FLAT_HASHTABLE_H_
+#define FLAT_HASHTABLE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "typedefs.h"
+#include "macros.h"
+#include "var_args.h"
+#include "payload_functions.h"
+
+/**
+ * A slot of the array of a ::flat_ht
+ *
+ * @private
+ */
+typedef struct flat_ht_slot {
+	///the key of the entry
+	unsigned long key;
+	///the value associated to ::flat_ht_slot::key
+	void* value;
+	/**
+	 * 0 if the slot is empty. Otherwise 1 + the distance between this slot and the slot where the key would be put if there were no collisions
+	 */
+	unsigned int distance;
+} flat_ht_slot;
+
+typedef struct flat_ht flat_ht;
+
+#define CU_STANDARD_CONTAINER_TYPE flat_ht
+#define CU_STANDARD_CONTAINER_SUFFIX flatht
+#include "standardContainer.xmacro.h"
+
+/**
+ * Create a new flat hashtable in memory
+ *
+ * @param[in] functions a set of functions used to easily manage the payload
+ * @return the new hashtable just created
+ */
+flat_ht* cuFlatHTNew(payload_functions functions);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(flat_ht*, cuFlatHTNew, payload_functions);
+#define cuFlatHTNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuFlatHTNew, 1, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuFlatHTNew,
+		cuPayloadFunctionsDefault()
+);
+
+/**
+ * Deallocate the memory occupied by this hash table
+ *
+ * @note
+ * the payload associated to this hashtable won't be removed at all
+ *
+ * @param[in] ht the hashtable to remove
+ * @param[in] context unused
+ */
+void cuFlatHTDestroy(CU_NOTNULL const flat_ht* ht, CU_NULLABLE const struct var_args* context);
+#define CU_FUNCTION_POINTER_destructor_void_cuFlatHTDestroy_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
+
+/**
+ * Like ::cuFlatHTDestroy but it destroys the payload of the hashtable as well
+ *
+ * @param[in] ht the hashtable to remove
+ * @param[in] context the context passed to the destructor of the payload
+ */
+void cuFlatHTDestroyWithElements(CU_NOTNULL const flat_ht* ht, CU_NULLABLE const struct var_args* context);
+#define CU_FUNCTION_POINTER_destructor_void_cuFlatHTDestroyWithElements_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
+
+/**
+ * Ensure the hashtable can contain @c size entries without reallocating its array
+ *
+ * Use it when you know in advance how many entries you're going to add
+ *
+ * @param[inout] ht the hashtable involved
+ * @param[in] size the number of entries the hashtable should be able to hold
+ */
+void cuFlatHTReserve(CU_NOTNULL flat_ht* ht, size_t size);
+
+/**
+ * \note
+ * This operation is a O(1)
+ *
+ * @param[in] ht the hash table involved
+ * @return the number of elements inside the hash table
+ */
+size_t cuFlatHTGetSize(CU_NOTNULL const flat_ht* ht);
+
+/**
+ * @param[in] ht the hash table involved
+ * @return the number of slots the hashtable has. It is always a power of 2 (or 0 if the hashtable has never contained anything)
+ */
+size_t cuFlatHTGetCapacity(CU_NOTNULL const flat_ht* ht);
+
+/**
+ * Chekc if the hash table contains no values
+ *
+ * @param[in] ht the hash table to consider
+ * @return
+ *  @li true if the hash table is empty;
+ *  @li false otherwise;
+ */
+bool cuFlatHTIsEmpty(CU_NOTNULL const flat_ht* ht);
+
+/**
+ * get an element in the hashtable, given a certain key
+ *
+ * @param[in] ht the hashtable where we want to look int
+ * @param[in] key the key associated to a certain element
+ * @return
+ * 	\li the element whose key is \c key;
+ * 	\li NULL if it isn't present in the hashtable;
+ */
+CU_NULLABLE void* cuFlatHTGetItem(CU_NOTNULL const flat_ht* ht, unsigned long key);
+
+/**
+ * @param[in] ht the ht involved
+ * @param[in] key the key involved
+ * @return
+ * 	\li true if there is a value within the hashtable whose key is \c key;
+ * 	\li false otheriwse
+ */
+bool cuFlatHTContainsItem(CU_NOTNULL const flat_ht* ht, unsigned long key);
+
+/**
+ * Insert or alter an element inside the hash table
+ *
+ * \attention
+ * After this operation the old data will be totally overwritten! Be sure to still have a backup reference
+ * of the previous object, otherwise memory leak will likely to happen!
+ *
+ * @param[inout] ht the hashtable to alter
+ * @param[in] key the key of the element to update
+ * @param[in] data the new data to overwrite the old one
+ * @return
+ * 	\li true if a new element is created;
+ * 	\li false if we overwrote the previous one
+ */
+bool cuFlatHTAddOrUpdateItem(CU_NOTNULL flat_ht* ht, unsigned long key, CU_NULLABLE const void* data);
+
+/**
+ * Add a key-value mapping within this hash table
+ *
+ * \note
+ * If @c key is already present, its value is overwritten (see ::cuFlatHTAddOrUpdateItem)
+ *
+ * @param[inout] ht the hash table where the mapping needs to be add
+ * @param[in] key the key to add in the hashtable
+ * @param[in] data the values associated to the key that needs to be added
+ */
+void cuFlatHTAddItem(CU_NOTNULL flat_ht* ht, unsigned long key, CU_NULLABLE const void* data);
+
+/**
+ * Updates the value indexed by \c key to a new value
+ *
+ * \note
+ * If there is no element indexed with \c key in the hashtable, this function does nothing
+ *
+ * @param[inout] ht the hashtable to alter
+ * @param[in] key the key referring to the element to update
+ * @param[in] data the new data that will replace the old one
+ * @return
+ * 	\li true if we have update with success the data;
+ * 	\li false if we couldn't find any slot indexed with \c key;
+ */
+bool cuFlatHTUpdateItem(CU_NOTNULL flat_ht* ht, unsigned long key, CU_NULLABLE const void* data);
+
+/**
+ * delete an item from the hash table
+ *
+ * The function does nothing if the hash table does not contain the key
+ *
+ * @param[inout] ht the hashtable involved
+ * @param[in] key the key associate to the value we need to remove
+ * @return
+ *  @li true if we have removed something;
+ *  @li false otherwise
+ */
+bool cuFlatHTRemoveItem(CU_NOTNULL flat_ht* ht, unsigned long key);
+
+/**
+ * like ::cuFlatHTRemoveItem but it will also remove from memory the value associated with @c key
+ *
+ * The value is removed via the payload functions of the hashtable
+ *
+ * @param[inout] ht the hashtable involved
+ * @param[in] key the key associate to the value we need to remove
+ * @return
+ *  @li true if we have removed something;
+ *  @li false otherwise
+ */
+bool cuFlatHTRemoveItemWithElement(CU_NOTNULL flat_ht* ht, unsigned long key);
+
+/**
+ * Clear all the elements inside the given hashtable.
+ *
+ * The capacity of the hashtable is kept, so it can be reused without reallocating.
+ * The values inside the hashtable won't be touched; however make sure
+ * you have other reference of them otherwise memory leak might happen
+ *
+ * @param[inout] ht the hashtable to clear
+ */
+void cuFlatHTClear(CU_NOTNULL flat_ht* ht);
+
+/**
+ * Like ::cuFlatHTClear but the values are released from memory via the payload functions of the hashtable
+ *
+ * @param[inout] ht the hashtable to clear
+ */
+void cuFlatHTClearWithElements(CU_NOTNULL flat_ht* ht);
+
+/**
+ * Fetch the first item the program can find within the hashtable.
+ *
+ * Nothing is said about what the software picks up: <b>don't assume it was the first one you have added in the hashtable!</b>
+ *
+ * @param[in] ht the ht involved
+ * @return
+ * 	\li an item inside the \c ht;
+ * 	\li NULL if the \c ht is empty;
+ */
+CU_NULLABLE void* cuFlatHTGetFirstItem(CU_NOTNULL const flat_ht* ht);
+
+/**
+ * Clone a specified hashtable
+ *
+ * Elements are cloned by reference. The clone is a single memcpy of the underlying array
+ *
+ * @param[in] ht the hastable to clone.
+ * @return the clone pointer
+ */
+CU_NOTNULL flat_ht* cuFlatHTClone(CU_NOTNULL const flat_ht* ht);
+#define CU_FUNCTION_POINTER_cloner_voidPtr_cuFlatHTClone_voidConstPtr CU_CLONER_ID
+
+/**
+ * @param[in] ht the hashtable to print
+ * @param[inout] buffer the place in memory where to save the string conversion of the hashtable
+ * @return the number of bytes the string conversion filled in the buffer
+ */
+int cuFlatHTBufferString(CU_NOTNULL const flat_ht* ht, CU_NOTNULL char* buffer);
+
+/**
+ * @private
+ *
+ * @param[in] ht the hashtable to handle
+ * @return
+ *  @li the first non empty slot of the hashtable;
+ *  @li NULL if the hashtable is empty
+ */
+CU_NULLABLE const flat_ht_slot* _cuFlatHTGetFirstSlot(CU_NOTNULL const flat_ht* ht);
+
+/**
+ * @private
+ *
+ * @param[in] ht the hashtable to handle
+ * @param[in] slot a non empty slot of @c ht
+ * @return
+ *  @li the first non empty slot after @c slot;
+ *  @li NULL if there is none
+ */
+CU_NULLABLE const flat_ht_slot* _cuFlatHTGetNextSlot(CU_NOTNULL const flat_ht* ht, CU_NOTNULL const flat_ht_slot* slot);
+
+/**
+ * Macro allowing you to go through every element of a flat hashtable
+ *
+ * The macro has the same semantic of ::CU_ITERATE_OVER_HASHTABLE
+ *
+ * @code
+ * flat_ht* ht = cuFlatHTNew(cuPayloadFunctionsDefault());
+ * cuFlatHTAddItem(ht, 5, "hello");
+ * cuFlatHTAddItem(ht, 7, "world");
+ * CU_ITERATE_OVER_FLATHT(ht, key, value, char*) {
+ * 	printf("string associated to key %ld: %s\n", key, value);
+ * }
+ * @endcode
+ *
+ * The order used is **not** garantueed.
+ *
+ * @attention
+ * you can't add or remove entries of @c ht within the loop
+ *
+ * @param[in] ht the hashtable you want to consider
+ * @param[in] keyName a variable identifier that will have type `unsigned long` containing, at each iteration, the key of an entry of the hashtable
+ * @param[in] valueName a variable identifier that will have type @c valueType containing, at each iteration, the value of the entry associated to the key @c keyName
+ * @param[in] valueType the type of value @c valueName
+ */
+#define CU_ITERATE_OVER_FLATHT(ht, keyName, valueName, valueType) \
+	for (bool UV(htLoop) = true; UV(htLoop);) \
+		for (const flat_ht *UV(flatHt) = (ht); UV(htLoop); ) \
+			for (const flat_ht_slot *UV(el) = _cuFlatHTGetFirstSlot(UV(flatHt)); UV(htLoop); ) \
+				for (unsigned long keyName = 0; UV(htLoop); ) \
+					for (valueType valueName = (valueType)0; UV(htLoop); UV(htLoop) = false) \
+						for ( \
+							keyName = UV(el) != NULL ? UV(el)->key : keyName, \
+							valueName = UV(el) != NULL ? ((valueType)UV(el)->value) : valueName \
+							; \
+							UV(el) != NULL \
+							; \
+							UV(el) = _cuFlatHTGetNextSlot(UV(flatHt), UV(el)), \
+							keyName = UV(el) != NULL ? UV(el)->key : keyName, \
+							valueName = UV(el) != NULL ? ((valueType)UV(el)->value) : valueName \
+						)
+
+/**
+ * Macro allowing you to go through every value of a flat hashtable
+ *
+ * The macro has the same semantic of ::CU_ITERATE_OVER_HT_VALUES
+ *
+ * @code
+ * CU_ITERATE_OVER_FLATHT_VALUES(ht, value, int*) {
+ * 	printf("value %d\n", *value);
+ * }
+ * @endcode
+ *
+ * @attention
+ * you can't add or remove entries of @c ht within the loop
+ *
+ * @param[in] ht the hashtable to go through
+ * @param[in] valueName the name of the variable that will contain a value in the iteration
+ * @param[in] valueType the type of \c valueName
+ */
+#define CU_ITERATE_OVER_FLATHT_VALUES(ht, valueName, valueType) \
+	CU_ITERATE_OVER_FLATHT(ht, UV(flatHtKey), valueName, valueType)
+
+#endif /* FLAT_HASHTABLE_H_ */
@@ -0,0 +1,75 @@
+/**
+ * @file
+ *
+ * Represents a module allowing you to populate a ::PredSuccGraph from the common textual graph formats
+ *
+ * The supported formats are:
+ * @li ::GFF_EDGE_LIST: one edge per line, <tt>source sink [weight]</tt>, separated by spaces or tabs. Lines starting with '#' or '%' are comments.
+ * 	The vertices are the ids appearing in the edges;
+ * @li ::GFF_DIMACS: the DIMACS shortest path format (<tt>.gr</tt>). The <tt>p sp n m</tt> line declares the vertices from 1 to @c n,
+ * 	each <tt>a source sink weight</tt> line is an edge;
+ * @li ::GFF_MATRIX_MARKET: a Matrix Market <tt>coordinate</tt> file. Each entry <tt>row column [value]</tt> is an edge from @c row to @c column,
+ * 	the vertices are the ids from 1 to the maximum between the rows and the columns. With a symmetric matrix, each off diagonal entry generates both edges.
+ *
+ * @code
+ * cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(8);
+ * PredSuccGraph* g = cuPredSuccGraphLoad("roads.gr", GFF_DIMACS, pool);
+ * long weight = CU_CAST_PTR2INT(cuPredSuccGraphGetEdgeInGraph(g, 1, 2)->payload);
+ * cuPredSuccGraphDestroyWithElements(g, NULL);
+ * cuParallelThreadPoolDestroy(pool, NULL);
+ * @endcode
+ *
+ * The file is memory mapped and split in one chunk per worker of the pool: each worker parses its own chunk into its own edge buffer.
+ * Then the vertices and the edges are added into the graph, with hashtables already sized for them.
+ *
+ * The integer weights are stored as the payloads of the edges (see ::CU_CAST_INT2PTR): the payloads of the graph are managed
+ * by ::cuPayloadFunctionsIntValue. Edges without weight or with a non integer weight have 0 as payload.
+ *
+ * @author koldar
+ * @date Oct 16, 2026
+ */
+
+#ifndef GRAPH_LOADER_H_
+#define GRAPH_LOADER_H_
+
+#include <stdbool.h>
+#include "macros.h"
+#include "predsuccgraph.h"
+#include "multithreading.h"
+
+/**
+ * The textual formats ::cuPredSuccGraphLoad can read
+ */
+enum graph_file_format {
+	///whitespace separated edge list
+	GFF_EDGE_LIST,
+	///DIMACS shortest path format
+	GFF_DIMACS,
+	///Matrix Market coordinate format
+	GFF_MATRIX_MARKET
+};
+
+/**
+ * Load a graph from a textual file
+ *
+ * If the file contains the same edge several times, the last one wins
+ *
+ * @param[in] filePath the file to read
+ * @param[in] format the format of the file
+ * @param[inout] pool the workers used to parse the file. If NULL, the file is parsed by the calling thread
+ * @param[in] enablePredecessors see ::cuPredSuccGraphNew
+ * @return
+ *  @li the graph in the file;
+ *  @li NULL if the file is not compliant with @c format
+ */
+CU_NULLABLE PredSuccGraph* cuPredSuccGraphLoad(CU_NOTNULL const char* filePath, enum graph_file_format format, CU_NULLABLE cu_parallel_thread_pool* pool, bool enablePredecessors);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(PredSuccGraph*, cuPredSuccGraphLoad, const char*, enum graph_file_format, cu_parallel_thread_pool*, bool);
+#define cuPredSuccGraphLoad(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuPredSuccGraphLoad, 4, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuPredSuccGraphLoad,
+		,
+		,
+		NULL,
+		false
+);
+
+#endif /* GRAPH_LOADER_H_ */
@@ -4,7 +4,24 @@
  * An hash set is an implementation of a set.
  *
  * A set is an unordered group of elements. You can check if an element belong to the set in O(1).
- * This module implement the set via an hashtable.
+ * This module implement the set via an open addressing hashtable (Robin Hood hashing with backward shift deletion):
+ * the items are stored, together with their hash, in a single array. No memory is allocated per item and removals
+ * never leave tombstones behind.
+ *
+ * By default items are compared by their pointer value, which is what you need for sets of integers
+ * (see ::cuPayloadFunctionsIntValue) or sets of objects compared by identity. If you pass a ::hashfunction_t to ::cuHashSetNew,
+ * the items are hashed with it and compared with ::payload_functions::compare: 2 strings (or structures) with the same content
+ * but living at different addresses are then the same item:
+ *
+ * @code
+ * payload_functions functions = cuPayloadFunctionsString();
+ * functions.compare = CU_AS_COMPARER(cuDefaultFunctionsComparatorString);
+ * string_hash_set* s = cuHashSetNew(functions, CU_AS_HASHFUNCTION(cuDefaultFunctionsHashString));
+ * char buffer[10];
+ * strcpy(buffer, "hello");
+ * cuHashSetAddItem(s, "hello");
+ * cuHashSetContainsItem(s, buffer); //true
+ * @endcode
  *
  * Common usage as follows:
  *
@@ -30,12 +47,32 @@
 #define HASH_SET_H_
 
 #include <stdbool.h>
-#include "hashtable.h"
+#include <stddef.h>
+#include "macros.h"
+#include "typedefs.h"
 #include "payload_functions.h"
 #include "var_args.h"
 
 typedef struct hash_set hash_set;
 
+/**
+ * The position of an iteration over a ::hash_set
+ *
+ * @private
+ */
+typedef struct hash_set_cursor {
+	///the next slot to examine
+	size_t next;
+	///the number of slots still to examine
+	size_t remaining;
+	///the slot containing the last item returned
+	size_t current;
+	///the last item returned
+	const void* item;
+	///true if ::hash_set_cursor::item has been set
+	bool returned;
+} hash_set_cursor;
+
 /**
  * A set containining, instead of \c void*, the actual int paylaod
  */
@@ -52,10 +89,18 @@ typedef hash_set string_hash_set;
 /**
  * Initialize an hash set
  *
- * @param[in] functions support function to manage the payload of this container
+ * @param[in] functions support function to manage the payload of this container. If @c hash is not NULL,
+ * 	::payload_functions::compare is used to check whether 2 items are the same
+ * @param[in] hash the function used to hash the items. If NULL, items are hashed and compared by their pointer value
  * @return the set desired
  */
-hash_set* cuHashSetNew(payload_functions functions);
+hash_set* cuHashSetNew(payload_functions functions, CU_NULLABLE hashfunction_t hash);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(hash_set*, cuHashSetNew, payload_functions, hashfunction_t);
+#define cuHashSetNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuHashSetNew, 2, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuHashSetNew,
+		cuPayloadFunctionsDefault(),
+		NULL
+);
 
 /**
  * Adds an item inside the set
@@ -68,6 +113,17 @@ hash_set* cuHashSetNew(payload_functions functions);
  */
 bool cuHashSetAddItem(CU_NOTNULL hash_set* set, const void* item);
 
+/**
+ * Fetch the item of the set equal to a given one
+ *
+ * Useful to intern values: the returned item is the one added in the set, not @c item
+ *
+ * @param[in] set the set to manage
+ * @param[in] item the item to look for
+ * @return the item in the set equal to @c item, or NULL if there is no such item
+ */
+CU_NULLABLE void* cuHashSetGetItem(CU_NOTNULL const hash_set* set, const void* item);
+
 /**
  * Check if \c item is inside the set
  *
@@ -112,6 +168,14 @@ void cuHashSetDestroy(CU_NOTNULL const hash_set* set, CU_NULLABLE const struct v
 void cuHashSetDestroyWithElements(CU_NOTNULL const hash_set* set, CU_NULLABLE const struct var_args* context);
 #define CU_FUNCTION_POINTER_destructor_void_ccuHashSetDestroyWithElements_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
 
+/**
+ * Make sure the set can contain a number of items without rehashing
+ *
+ * @param[inout] set the set to manage
+ * @param[in] size the number of items the set needs to contain
+ */
+void cuHashSetReserve(CU_NOTNULL hash_set* set, size_t size);
+
 /**
  * the size of the set
  *
@@ -231,15 +295,28 @@ hash_set* cuHashSetClone(CU_NOTNULL const hash_set* set);
 void* cuHashSetGetAnItem(CU_NOTNULL const hash_set* set);
 
 /**
- * Get the hashtable under this set implementation
+ * Start an iteration over the set
  *
- * \note
- * protected function. Shouldn't be used at all
+ * @private
  *
- * @param[in] set the set to manage
- * @return the hash table representing the set
+ * @param[in] set the set to iterate over
+ * @return the cursor to pass to ::_cuHashSetMoveCursor
  */
-HT* _cuHashSetGetUnderlyingHashTable(CU_NOTNULL const hash_set* set);
+hash_set_cursor _cuHashSetGetFirstCursor(CU_NOTNULL const hash_set* set);
+
+/**
+ * Move the cursor to the next item of the set
+ *
+ * The iteration starts right after an empty slot: since removals shift back only the items of the same cluster,
+ * removing the item under the cursor moves in its slot only items which have not been visited yet.
+ *
+ * @private
+ *
+ * @param[in] set the set to iterate over
+ * @param[inout] cursor the cursor to move
+ * @return true if the cursor has been moved on an item, false if the iteration is over
+ */
+bool _cuHashSetMoveCursor(CU_NOTNULL const hash_set* set, CU_NOTNULL hash_set_cursor* cursor);
 
 /**
  * Macro to comfortably loop over the values inside the set
@@ -247,7 +324,7 @@ HT* _cuHashSetGetUnderlyingHashTable(CU_NOTNULL const hash_set* set);
  * @code
  * hash_set set = cuHashSetNew(...);
  * //add some values in "set"
- * CU_ITERATE_OVER_HASHSET(set, var, double) {
+ * CU_ITERATE_OVER_HASHSET(set, var, double*) {
  * 	//var will be of type "double*"
  * 	printf("the set contains %f\n", *var);
  * }
@@ -256,33 +333,38 @@ HT* _cuHashSetGetUnderlyingHashTable(CU_NOTNULL const hash_set* set);
  * \note
  * the ordering of iteration is **not garantueed to be deterministic**.
  *
+ * @attention
+ * while iterating you can remove the current item (and only it). Do not add items.
+ *
  * @param[in] aset the set to loop over
  * @param[in] name the name of the variable which will contain the value to iterate over
- * @param[in] type the type the variable \c name will have within the cycle. It will always be a pointer of \c type.
+ * @param[in] type the type the variable \c name will have within the cycle
  */
 #define CU_ITERATE_OVER_HASHSET(aset, name, type) \
 	for (bool UV(setloop)=true; UV(setloop); ) \
 		for (const hash_set* UV(set)=(aset); UV(setloop); ) \
-			for (const HT* UV(ht)=_cuHashSetGetUnderlyingHashTable(UV(set)); UV(setloop); UV(setloop)=false) \
-				CU_ITERATE_OVER_HT_VALUES(UV(ht), name, type)
+			for (hash_set_cursor UV(cursor)=_cuHashSetGetFirstCursor(UV(set)); UV(setloop); ) \
+				for (type name = (type)0; UV(setloop); UV(setloop)=false) \
+					for ( \
+						; \
+						_cuHashSetMoveCursor(UV(set), &UV(cursor)) && ((name = (type)UV(cursor).item), true) \
+						; \
+					)
 
 /**
  * Macro to comfortably loop over the values inside the set
  *
- * This allows you to add elements while looping as well
+ * Same as ::CU_ITERATE_OVER_HASHSET: it is kept for the code removing the current item while iterating
  *
  * @note
  * the order of iteration is **not garantueed to be deterministic**.
  *
  * @param[in] aset the set to loop over
  * @param[in] name the name of the variable which will contain the value to iterate over
- * @param[in] type the type the variable \c name will have within the cycle. It will always be a pointer of \c type.
+ * @param[in] type the type the variable \c name will have within the cycle
  */
 #define CU_VARIABLE_ITERATE_OVER_HASHSET(aset, name, type) \
-	for (bool UV(setloop)=true; UV(setloop); ) \
-		for (hash_set* UV(set)=((hash_set*)aset); UV(setloop); ) \
-			for (HT* UV(ht)=_cuHashSetGetUnderlyingHashTable(UV(set)); UV(setloop); UV(setloop)=false) \
-				CU_ITERATE_OVER_HT_VALUES(UV(ht), name, type)
+	CU_ITERATE_OVER_HASHSET(aset, name, type)
 
 
 #endif /* HASH_SET_H_ */
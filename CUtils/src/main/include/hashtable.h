@@ -35,6 +35,7 @@
 #include "macros.h"
 #include "var_args.h"
 #include "payload_functions.h"
+#include "allocator.h"
 
 /**
  * A structure representing a cell of the hash table
@@ -64,13 +65,15 @@ typedef HT int_ht_in_ht;
  * Create a new hashtable in memory
  *
  * @param[in] functions a set of functions used to easily manage the payload
+ * @param[in] allocator the allocator used to create the cells of the hashtable. NULL means @c malloc. See ::cu_allocator
  * @return the new hashtable just created
  */
-HT* cuHTNew(payload_functions functions);
-CU_DECLARE_FUNCTION_WITH_DEFAULTS(HT*, cuHTNew, payload_functions);
-#define cuHTNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuHTNew, 1, __VA_ARGS__)
+HT* cuHTNew(payload_functions functions, CU_NULLABLE cu_allocator* allocator);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(HT*, cuHTNew, payload_functions, cu_allocator*);
+#define cuHTNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuHTNew, 2, __VA_ARGS__)
 CU_DECLARE_DEFAULT_VALUES(cuHTNew,
-		cuPayloadFunctionsDefault()
+		cuPayloadFunctionsDefault(),
+		NULL
 );
 
 /**
@@ -136,6 +139,17 @@ bool cuHTAddOrUpdateItem(CU_NOTNULL HT* ht, unsigned long key, CU_NULLABLE const
  */
 bool cuHTUpdateItem(CU_NOTNULL HT* ht, unsigned long key, CU_NULLABLE const void* data);
 
+/**
+ * Ensure the hash table has enough buckets for @c size entries
+ *
+ * Use it when you know in advance how many entries you're going to add: the hash table won't need to rehash its entries while growing.
+ * If the hash table is empty, the buckets are allocated when the first entry is added
+ *
+ * @param[inout] ht the hash table involved
+ * @param[in] size the number of entries the hash table should be able to hold
+ */
+void cuHTReserve(CU_NOTNULL HT* ht, int size);
+
 /**
  * Add a key-value mapping within this hash table
  *
@@ -188,6 +202,9 @@ void cuHTDestroyCell(CU_NOTNULL HT* ht, CU_NOTNULL HTCell* htCell);
 /**
  * like ::cuHTDestroyCell but it delete from the memory also the element inside the cell
  *
+ * @attention
+ * the cell is released with @c free, so use this function only on hashtables without a ::cu_allocator
+ *
  * @param[in] htCell the cell to remove from the memory
  * @param[in] d the destructor to use to remove the data inside the \c htCell
  * @see cuHTDestroyCell
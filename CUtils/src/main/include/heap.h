@@ -7,6 +7,16 @@
  * The implementation is actually a min-heap implementation. However, by setting payload_functions function correctly, one can easily transform
  * it into a max-heap.
  *
+ * The heap is stored in an array which grows on demand. If you already have all the items, ::cuHeapNewFromArray and ::cuHeapInsertItems
+ * build the heap in linear time, while ::cuHeapPopK extracts the @c k least items at once:
+ *
+ * @code
+ * heap* h = cuHeapNewFromArray(CU_HEAP_UNBOUNDED, cuPayloadFunctionsIntValue(), items, n);
+ * void* best[10];
+ * int found = cuHeapPopK(h, 10, best);
+ * cuHeapDestroy(h, NULL);
+ * @endcode
+ *
  * @date Jun 2, 2017
  * @author koldar
  */
@@ -26,15 +36,35 @@ typedef struct heap heap;
  */
 typedef heap int_heap;
 
+/**
+ * Value of the maximum size of an heap which can contain any number of elements
+ */
+#define CU_HEAP_UNBOUNDED 0
+
 /**
  * Initialize the heap
  *
- * @param[in] maxSize the maximum number of elements that can be added inside the heap
+ * The memory of the heap is allocated on demand, so a big @c maxSize doesn't cost anything until the elements are actually added
+ *
+ * @param[in] maxSize the maximum number of elements that can be added inside the heap. ::CU_HEAP_UNBOUNDED if there is no limit
  * @param[in] functions a set of function which can easily represents the paylaod of the container
  * @return the heap requested
  */
 heap* cuHeapNew(int maxSize, payload_functions functions);
 
+/**
+ * Initialize the heap with the given elements
+ *
+ * The heap is built in \f$ O(n) \f$ (Floyd's algorithm), rather than in \f$ O(n \log_2 n) \f$ as adding the items one by one
+ *
+ * @param[in] maxSize the maximum number of elements that can be added inside the heap. ::CU_HEAP_UNBOUNDED if there is no limit
+ * @param[in] functions a set of function which can easily represents the paylaod of the container
+ * @param[in] items the elements to put in the heap. The array is not kept by the heap
+ * @param[in] n the number of elements in @c items. It can't be greater than @c maxSize
+ * @return the heap requested
+ */
+heap* cuHeapNewFromArray(int maxSize, payload_functions functions, CU_NOTNULL void* const* items, int n);
+
 /**
  * Destroy an heap
  *
@@ -68,7 +98,7 @@ void cuHeapClear(CU_NOTNULL heap* h);
 /**
  * Adds an item inside the heap
  *
- * If the item is already present inside the heap, the function does nothing
+ * The heap can contain several items with the same order. Adding an item takes \f$ O(\log_2 n) \f$ time
  *
  * \attention
  * The function will do nothing if the heap is full
@@ -81,6 +111,24 @@ void cuHeapClear(CU_NOTNULL heap* h);
  */
 bool cuHeapInsertItem(CU_NOTNULL heap* h, const CU_NULLABLE void* item);
 
+/**
+ * Adds several items inside the heap
+ *
+ * If the items are many compared to the size of the heap, the whole heap is rebuilt in \f$ O(n + k) \f$ time,
+ * otherwise each item is inserted in \f$ O(\log_2 (n + k)) \f$ time.
+ *
+ * \attention
+ * The function will do nothing if the heap can't contain all the items
+ *
+ * @param[in] h the heap to alter
+ * @param[in] items the elements to add in the heap. The array is not kept by the heap
+ * @param[in] k the number of elements in @c items
+ * @return
+ * 	\li true if the items have been added in the heap;
+ * 	\li false if the heap would have exceeded its maximum size
+ */
+bool cuHeapInsertItems(CU_NOTNULL heap* h, CU_NOTNULL void* const* items, int k);
+
 /**
  * @param[in] h the heap involved
  * @return
@@ -91,7 +139,7 @@ bool cuHeapIsEmpty(CU_NOTNULL const heap* h);
 /**
  * @param[in] h the heap involved
  * @return
- * 	\li true if the heap can't contain any more elements
+ * 	\li true if the heap can't contain any more elements. An heap with ::CU_HEAP_UNBOUNDED maximum size is never full
  */
 bool cuHeapIsFull(CU_NOTNULL const heap* h);
 
@@ -108,7 +156,7 @@ void* cuHeapPeekMinItem(CU_NOTNULL const heap* h);
 /**
  * Removes the minimum value in the heap.
  *
- * This operation takes \f$ O(n log_2 {n}) \f$ time
+ * This operation takes \f$ O(\log_2 {n}) \f$ time
  *
  * @param[in] h the heap where we want to remove the item from
  * @return
@@ -117,6 +165,18 @@ void* cuHeapPeekMinItem(CU_NOTNULL const heap* h);
  */
 void* cuHeapRemoveMinItem(CU_NOTNULL heap* h);
 
+/**
+ * Removes the @c k least values in the heap
+ *
+ * This operation takes \f$ O(k \log_2 {n}) \f$ time. The heap is left valid, so it can be used to fetch the next @c k items as well.
+ *
+ * @param[inout] h the heap where we want to remove the items from
+ * @param[in] k the number of items to remove
+ * @param[out] output an array of at least @c k cells which will contain the removed items, in ascending order
+ * @return the number of items removed. It is less than @c k only if the heap had less than @c k items
+ */
+int cuHeapPopK(CU_NOTNULL heap* h, int k, CU_NOTNULL void** output);
+
 /**
  * @param[in] h the heap to analyze
  * @return the number of elements inside the heap
@@ -125,13 +185,15 @@ int cuHeapGetSize(CU_NOTNULL const heap* h);
 
 /**
  * @param[in] h the heap to analyze
- * @return the maximum number of elements the heap can contain
+ * @return the maximum number of elements the heap can contain or ::CU_HEAP_UNBOUNDED if there is no limit
  */
 int cuHeapGetMaxSize(CU_NOTNULL const heap* h);
 
 /**
  * Check if the heap contains an object
  *
+ * The subtrees whose root is greater than @c item are not explored
+ *
  * @param[in] h the heap to analyze
  * @param[in] item the item to look for
  * @return
@@ -174,7 +236,11 @@ heap* cuHeapClone(CU_NOTNULL const heap* h);
 /**
  * Move all the elements inside an heap into another one
  *
- * After this operation, \c src will be empty;
+ * After this operation, \c src will be empty. The elements are moved with ::cuHeapInsertItems, hence merging two heaps of similar size
+ * takes linear time.
+ *
+ * \attention
+ * It is an error if \c dst can't contain all the elements
  *
  * @param[inout] dst the heap that will receive all the elements of \c src;
  * @param[inout] src the heap that will offer all its elements to \c dst;
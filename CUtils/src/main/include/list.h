@@ -29,6 +29,8 @@
 #include "macros.h"
 #include "payload_functions.h"
 #include "var_args.h"
+#include "allocator.h"
+#include "multithreading.h"
 
 typedef struct list_cell list_cell;
 
@@ -54,13 +56,16 @@ typedef struct list list;
  *
  * Use ::cuListDestroy or ::cuListDestroyWithElement to release the memory from the list
  *
+ * @param[in] payloadFunctions functions used to manage the payloads of the list
+ * @param[in] allocator the allocator used to create the cells of the list. NULL means @c malloc. See ::cu_allocator
  * @return the list requested
  */
-list* cuListNew(payload_functions payloadFunctions);
-CU_DECLARE_FUNCTION_WITH_DEFAULTS(list*, cuListNew, payload_functions);
-#define cuListNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuListNew, 1, __VA_ARGS__)
+list* cuListNew(payload_functions payloadFunctions, CU_NULLABLE cu_allocator* allocator);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(list*, cuListNew, payload_functions, cu_allocator*);
+#define cuListNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuListNew, 2, __VA_ARGS__)
 CU_DECLARE_DEFAULT_VALUES(cuListNew,
-	cuPayloadFunctionsDefault()
+	cuPayloadFunctionsDefault(),
+	NULL
 );
 
 
@@ -182,7 +187,8 @@ int cuListGetSize(CU_NOTNULL const list* l);
 /**
  * Adds all the elements of \c src into \c dst
  *
- * The @c src elements will be put on the tail of @c dst. The operation is a \f$ O(1) \f$ time.
+ * The @c src elements will be put on the tail of @c dst. The operation is a \f$ O(1) \f$ time if the lists
+ * share the same ::cu_allocator, \f$ O(n) \f$ otherwise.
  *
  * \note
  * After this function, \c src will be empty
@@ -542,20 +548,57 @@ void cuListRemoveItemInListCell(CU_NOTNULL list* l, CU_NOTNULL list_cell** restr
 /**
  * **Alter** the list order by scrambling the elements
  *
- * For example if the list is \f$[1,2,3]\f$ after calling this function the list may have become \f$[3,1,2]\f$
+ * For example if the list is \f$[1,2,3]\f$ after calling this function the list may have become \f$[3,1,2]\f$.
+ * Every permutation is equally likely. The seed of the permutation is taken from @c rand, so
+ * the result can be reproduced via @c srand.
+ *
+ * @note
+ * O(n) time. The function allocates a temporary array of n pointers
  *
  * @param[inout] l the list to scramble
  */
 void cuListScramble(CU_NOTNULL list* l);
 
+/**
+ * **Alter** the list order by scrambling the elements with a given seed
+ *
+ * Like ::cuListScramble, but it does not use nor alter the state of @c rand: 2 lists with the same size scrambled
+ * with the same seed undergo the same permutation.
+ *
+ * @param[inout] l the list to scramble
+ * @param[in] seed the seed of the permutation
+ */
+void cuListScrambleWithSeed(CU_NOTNULL list* l, unsigned long seed);
+
 /**
  * **Alter** the list order by order the element in a certain way
  *
+ * The sort is stable: elements which @c order deems equal keep their relative order.
+ *
+ * @note
+ * O(n log n) time and no additional memory: the function relinks the cells of the list, without moving the payloads
+ * nor allocating anything
+ *
  * @param[inout] l the list to change
  * @param[in] order the function to use to establish which will be the order to use to reorganize the list itself
  */
 void cuListSort(CU_NOTNULL list* l, orderer order);
 
+/**
+ * Like ::cuListSort, but the list is sorted by several threads
+ *
+ * The list is split into one sublist per worker of the pool; the sublists are sorted concurrently and then
+ * merged pairwise, again concurrently. Short lists are sorted by the calling thread.
+ *
+ * @note
+ * the call is blocking: when the function returns the list is sorted
+ *
+ * @param[inout] l the list to change
+ * @param[in] order the function to use to sort the list. It needs to be callable from any thread
+ * @param[inout] pool the workers sorting the list
+ */
+void cuListParallelSort(CU_NOTNULL list* l, orderer order, CU_NOTNULL cu_parallel_thread_pool* pool);
+
 /**
  * Get a random item in the given list
  *
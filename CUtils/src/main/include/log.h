@@ -21,6 +21,16 @@
  * \li <tt>gX(cmds, format, ...)</tt> (*g* stands for "general"): use if you want to execute something before actuallly logging. If the log is disabled, cmds are not executed at all;
  * \li <tt>bX(format, ...)</tt>(*b* stands for "buffer"): provides a buffer of char you can use only in your logging code. The buffer is named \c log_buffer.
  *
+ * Each log entry is given to every registered ::log_appender. By default there is a single appender writing on the standard output.
+ * Appenders are added with ::addLogAppender: the module provides appenders writing on the standard output (::cuLogAppenderStdOutNew),
+ * on a file with rotation (::cuLogAppenderFileNew) and in memory (::cuLogAppenderMemoryNew).
+ *
+ * By default the appenders are called by the thread logging. After ::enableAsyncLogging, the threads logging only format the message
+ * and push it in a lock-free ring buffer: a background thread pops the entries and gives them to the appenders.
+ *
+ * The configuration functions (::setLevel, ::excludeLogger, ::addLogAppender, ::enableAsyncLogging and so on) are not thread safe:
+ * call them before starting logging from several threads.
+ *
  * @date Dec 23, 2016
  * @author koldar
  */
@@ -28,6 +38,11 @@
 #ifndef LOG_H_
 #define LOG_H_
 
+#include <stddef.h>
+#include "macros.h"
+
+struct var_args;
+
 /**
  * Enable this to improve log performance
  *
@@ -41,7 +56,13 @@
  * \example
  * Use this to trash away logs like LogLevel::LOG_DEBUG or LogLevel::LOG_FINE
  */
-#ifdef QUICK_LOG
+#ifndef QUICK_LOG
+#	ifdef NDEBUG
+		//release builds do not contain debug logs at all
+#		define QUICK_LOG __LOG_FINEST
+#	else
+#		define QUICK_LOG __LOG_ALL
+#	endif
 #endif
 
 #define __LOG_ALL		0
@@ -104,20 +125,152 @@ typedef void (*appenderFunction)(const char*, const char*, const int, const LogL
  */
 void __generic_log_function(const LogLevel level, const char* absoluteFilePath, const char* functionName, const int lineNo, int logBufferSize, char* logBuffer, const char* format, ...);
 void setLevel(LogLevel level);
+/**
+ * Avoid to print everything coming from a particular logger
+ *
+ * Loggers are identified by the hash of their name, so checking whether a logger is excluded costs O(1)
+ *
+ * @param[in] logger the logger (i.e., the basename of a file) that from this time until ::includeLogger call won't be tracked down at all
+ */
 void excludeLogger(const char* logger);
+/**
+ * Include in the logging the logs coming from this logger
+ *
+ * @param[in] logger the logger to include in the log output
+ */
 void includeLogger(const char* logger);
 void clearExcludedLoggers();
 
+/**
+ * A destination of the log entries
+ *
+ * Specific appenders embed this structure as their first field.
+ */
+typedef struct log_appender {
+	/**
+	 * Store a log entry
+	 *
+	 * @param[inout] appender the appender involved
+	 * @param[in] fileName the basename of the file where the log has been called
+	 * @param[in] functionName the function where the log has been called
+	 * @param[in] lineNo the line where the log has been called
+	 * @param[in] level the level of the log
+	 * @param[in] message the message of the log
+	 */
+	void (*append)(struct log_appender* appender, const char* fileName, const char* functionName, int lineNo, LogLevel level, const char* message);
+	/**
+	 * Make sure the entries appended are actually stored. Can be NULL
+	 *
+	 * Called after every entry when logging synchronously and after every batch of entries when logging asynchronously
+	 *
+	 * @param[inout] appender the appender involved
+	 */
+	void (*flush)(struct log_appender* appender);
+	/**
+	 * Release the resources of the appender. Can be NULL
+	 *
+	 * @param[inout] appender the appender involved
+	 */
+	void (*destroy)(struct log_appender* appender);
+} log_appender;
+
+/**
+ * the maximum number of appenders which can be registered at the same time
+ */
+#define LOG_MAX_APPENDERS 8
+
 /**
  * Clear all the appenders added up until now
+ *
+ * The appenders are destroyed. After this call the logs are not written anywhere
  */
 void clearAppenders();
 /**
  * Add a new appender to the appenders list
  *
- * \todo at the moment, only an appender per time is available
+ * @param[in] appender the function to call for each log entry
+ */
+void addAppender(appenderFunction appender);
+/**
+ * Add a new appender to the appenders list
+ *
+ * @param[in] appender the appender to add. The log module takes the ownership of it: it will be destroyed by ::clearAppenders
  */
-void addAppender(appenderFunction);
+void addLogAppender(CU_NOTNULL log_appender* appender);
+
+/**
+ * @return an appender writing the log entries on the standard output
+ */
+CU_NOTNULL log_appender* cuLogAppenderStdOutNew();
+
+/**
+ * An appender writing the log entries in a file
+ *
+ * When the file would become bigger than @c maxBytes, it is rotated: @c path is renamed to "path.1", "path.1" to "path.2" and so on,
+ * up to "path.maxFiles". The oldest file is removed. Then a new empty @c path file is created.
+ *
+ * @param[in] path the file where to write the log entries. If it already exists, the entries are appended to it
+ * @param[in] maxBytes the maximum size of the file. 0 to never rotate it
+ * @param[in] maxFiles the number of rotated files to keep
+ * @return the appender. The program is aborted if the file cannot be opened
+ */
+CU_NOTNULL log_appender* cuLogAppenderFileNew(CU_NOTNULL const char* path, size_t maxBytes, int maxFiles);
+
+/**
+ * An appender keeping in memory the last log entries
+ *
+ * @param[in] capacity the number of log entries to keep
+ * @return the appender
+ */
+CU_NOTNULL log_appender* cuLogAppenderMemoryNew(int capacity);
+
+/**
+ * @param[in] appender an appender created with ::cuLogAppenderMemoryNew
+ * @return the number of log entries kept by the appender
+ */
+int cuLogAppenderMemoryGetSize(CU_NOTNULL log_appender* appender);
+
+/**
+ * Copy an entry kept by a memory appender
+ *
+ * The entry has the same format of the ones written by ::cuLogAppenderStdOutNew, without the newline
+ *
+ * @param[in] appender an appender created with ::cuLogAppenderMemoryNew
+ * @param[in] index the index of the entry. 0 is the oldest entry kept
+ * @param[out] buffer where to copy the entry. It is always terminated by '\0'
+ * @param[in] bufferSize the size of @c buffer
+ */
+void cuLogAppenderMemoryGetEntry(CU_NOTNULL log_appender* appender, int index, CU_NOTNULL char* buffer, size_t bufferSize);
+
+/**
+ * Destroy an appender not registered via ::addLogAppender
+ *
+ * @param[in] appender the appender to destroy
+ * @param[in] context unused
+ */
+void cuLogAppenderDestroy(CU_NOTNULL const log_appender* appender, CU_NULLABLE const struct var_args* context);
+#define CU_FUNCTION_POINTER_destructor_void_cuLogAppenderDestroy_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
+
+/**
+ * Write the log entries from a background thread
+ *
+ * After this call, logging a message only formats it and pushes it into a lock-free ring buffer. If the buffer is full,
+ * the thread logging waits for the background thread to make room.
+ * The entries still in the buffer are written when the program exits.
+ *
+ * @param[in] capacity the number of entries the ring buffer can hold. Rounded up to a power of 2
+ */
+void enableAsyncLogging(int capacity);
+
+/**
+ * Write every pending log entry and go back to write the log entries from the thread logging them
+ */
+void disableAsyncLogging();
+
+/**
+ * Wait until every log entry logged so far has been given to the appenders and the appenders have been flushed
+ */
+void flushLogs();
 
 #ifndef LOG_BUFFER
 #	define LOG_BUFFER __cutils_log_buffer
@@ -128,7 +281,10 @@ void addAppender(appenderFunction);
 #	define LOG_BUFFER_SIZE 300
 #endif
 
-extern char __default_log_buffer[LOG_BUFFER_SIZE];
+/**
+ * The buffer where the simple log macros format their message. Each thread has its own one
+ */
+extern __thread char __default_log_buffer[LOG_BUFFER_SIZE];
 
 
 /**
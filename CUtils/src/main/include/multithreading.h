@@ -7,6 +7,7 @@
  * @li an easy thread wrapper;
  * @li locking mehcanism;
  * @li conditions;
+ * @li thread pools;
  *
  * <h2>Threads</h2>
  *
@@ -39,6 +40,11 @@
  *
  * Conditions are implemented via ::cu_condition. The implementation is based from <a href="https://computing.llnl.gov/tutorials/pthreads/">here</a>.
  *
+ * <h2>Thread pool</h2>
+ *
+ * A work-stealing pool is implemented via ::cu_parallel_thread_pool. Tasks are ::cu_runnable submitted with ::cuParallelThreadPoolSubmit,
+ * which returns a ::cu_future you can wait on.
+ *
  *
  * @author koldar
  * @date May 14, 2018
@@ -290,18 +296,191 @@ void cuConditionLockUntilVerified(CU_NOTNULL cu_condition* cond);
 void cuConditionLockVerifySingleThread(CU_NOTNULL cu_condition* cond);
 
 typedef struct cu_parallel_thread_pool cu_parallel_thread_pool;
+typedef struct cu_future cu_future;
+
+/**
+ * Creates a new thread pool
+ *
+ * Every worker of the pool owns a double ended queue of tasks: the worker pushes and pops tasks from the bottom
+ * of its own queue while idle workers steal the oldest tasks from the top of the queues of the other workers.
+ * Workers with nothing to do sleep until some new task is submitted.
+ *
+ * @note
+ * the workers are started immediately
+ *
+ * @param[in] totalThreads the number of workers to create. If non positive, we will create a worker for each online core
+ * @return a thread pool ready to accept tasks
+ */
+cu_parallel_thread_pool* cuParallelThreadPoolNew(int totalThreads);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(cu_parallel_thread_pool*, cuParallelThreadPoolNew, int);
+#define cuParallelThreadPoolNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuParallelThreadPoolNew, 1, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuParallelThreadPoolNew,
+		0
+);
+
+/**
+ * Destroy the thread pool
+ *
+ * The function waits until every submitted task has been completed, then it stops and joins all the workers.
+ *
+ * @note
+ * this function is a **blocking operation**!
+ *
+ * @param[in] pool the pool to destroy
+ */
+void cuParallelThreadPoolDestroy(CU_NOTNULL const cu_parallel_thread_pool* pool, CU_NULLABLE const struct var_args* context);
+#define CU_FUNCTION_POINTER_destructor_void_cuParallelThreadPoolDestroy_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
+
+/**
+ * the number of workers inside the pool
+ *
+ * @param[in] pool the pool involved
+ * @return the number of threads the pool has
+ */
+int cuParallelThreadPoolGetThreadsNumber(CU_NOTNULL const cu_parallel_thread_pool* pool);
+
+/**
+ * Submit a new task to the pool
+ *
+ * The task is a ::cu_runnable: the thread passed to it is the worker executing it, so you can
+ * use ::cuThreadIsStopHasBeenRequest to cooperate with the pool. If @c runnable returns ::TLS_CONTINUE the task is put back
+ * in the queue and executed again later (possibly by another worker); if it returns ::TLS_STOP the task is completed.
+ *
+ * If called from inside a task of the same pool, the new task is pushed in the queue of the current worker (so it is likely to
+ * be executed with hot caches); otherwise the tasks are distributed among the workers in a round robin fashion.
+ *
+ * @code
+ * enum thread_loop_state square(CU_NOTNULL const cu_thread* thread, const struct var_args* va) {
+ * 	int* a = cuVarArgsGetItem(va, 0, int*);
+ * 	*a = (*a) * (*a);
+ * 	return TLS_STOP;
+ * }
+ *
+ * int a = 5;
+ * cuInitVarArgsOnStack(va, &a);
+ * cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+ * cu_future* future = cuParallelThreadPoolSubmit(pool, square, va);
+ * cuFutureWait(future, -1);
+ * //a is 25
+ * cuFutureDestroy(future, NULL);
+ * cuParallelThreadPoolDestroy(pool, NULL);
+ * @endcode
+ *
+ * @param[inout] pool the pool where to execute the task
+ * @param[in] runnable the code to execute
+ * @param[in] varargs the variadic argument to call @c runnable with. **This variable must be still present when the task is executed**; UB otherwise
+ * @return an handle of the task. Dispose it with ::cuFutureDestroy when you don't need it anymore. The task is executed even if the handle is destroyed early
+ */
+cu_future* cuParallelThreadPoolSubmit(CU_NOTNULL cu_parallel_thread_pool* pool, CU_NOTNULL cu_runnable runnable, CU_NULLABLE const struct var_args* varargs);
+
+/**
+ * Wait until every task submitted to the pool has been completed
+ *
+ * @attention
+ * don't call this function inside a task of the same pool: the calling task would wait for itself
+ *
+ * @param[in] pool the pool involved
+ * @param[in] msToWait the maximum number of milliseconds to wait. If negative we will wait indefinitely
+ * @return
+ *  @li true if all the tasks have been completed;
+ *  @li false if the timeout expired before
+ */
+bool cuParallelThreadPoolWaitAll(CU_NOTNULL cu_parallel_thread_pool* pool, long msToWait);
+
+/**
+ * The chunks of a loop executed by ::cuParallelThreadPoolFor
+ *
+ * Put it in the structure the tasks of the loop share: the tasks fetch the chunks to process via ::cuParallelForGetNextChunk
+ */
+typedef struct cu_parallel_for {
+	///number of chunks of the loop
+	unsigned int chunksNumber;
+	///the next chunk to process. Updated atomically
+	unsigned int next;
+} cu_parallel_for;
+
+/**
+ * Execute a loop split in chunks with the workers of a pool and wait for its completion
+ *
+ * @c task is submitted once per worker, but never more times than the chunks. Each execution fetches the chunks via ::cuParallelForGetNextChunk
+ * until there is none left, so the faster workers process more chunks and each execution can keep its own state (e.g., a local buffer) across
+ * the chunks it processes. If @c pool is NULL or there is only one chunk, @c task is executed once by the calling thread, with a NULL thread.
+ *
+ * @code
+ * struct job {
+ * 	cu_parallel_for loop;
+ * 	int* array;
+ * };
+ *
+ * enum thread_loop_state doubleChunks(const cu_thread* thread, const struct var_args* va) {
+ * 	struct job* job = cuVarArgsGetItem(va, 0, struct job*);
+ * 	unsigned int chunk;
+ * 	while (cuParallelForGetNextChunk(&job->loop, &chunk)) {
+ * 		for (int i=chunk*1024; i<(chunk+1)*1024; i++) {
+ * 			job->array[i] *= 2;
+ * 		}
+ * 	}
+ * 	return TLS_STOP;
+ * }
+ *
+ * struct job* jobPtr = &job;
+ * cuInitVarArgsOnStack(va, jobPtr);
+ * cuParallelThreadPoolFor(pool, doubleChunks, va, &job.loop, 100);
+ * @endcode
+ *
+ * @param[inout] pool the workers executing the loop. Can be NULL
+ * @param[in] task the code processing the chunks. It needs to return ::TLS_STOP
+ * @param[in] va the arguments of @c task
+ * @param[inout] loop the chunks of the loop. It is reset by this function
+ * @param[in] chunksNumber the number of chunks of the loop
+ */
+void cuParallelThreadPoolFor(CU_NULLABLE cu_parallel_thread_pool* pool, CU_NOTNULL cu_runnable task, CU_NULLABLE const struct var_args* va, CU_NOTNULL cu_parallel_for* loop, unsigned int chunksNumber);
 
-//TODO doc
-cu_parallel_thread_pool* cuNewParallelThreadPool(int totalThreads, CU_NOTNULL cu_runnable runnable, const var_args* va);
+/**
+ * Fetch the next chunk of a loop executed by ::cuParallelThreadPoolFor
+ *
+ * @param[inout] loop the loop involved
+ * @param[out] chunk when the function returns true, the index of the chunk the caller needs to process
+ * @return
+ *  @li true if the caller got a chunk;
+ *  @li false if all the chunks have already been handed out
+ */
+bool cuParallelForGetNextChunk(CU_NOTNULL cu_parallel_for* loop, CU_NOTNULL unsigned int* chunk);
 
-//TODO doc
-void cuParallelThreadPoolRequestStart(CU_NOTNULL cu_parallel_thread_pool* executor);
+/**
+ * Wait until the task associated to the given future has been completed
+ *
+ * If called from inside a task of the same pool, the current worker executes other tasks while waiting, so
+ * fork-join algorithms do not deadlock the pool.
+ *
+ * @param[in] future the handle of the task to wait
+ * @param[in] msToWait the maximum number of milliseconds to wait. If negative we will wait indefinitely
+ * @return
+ *  @li true if the task has been completed;
+ *  @li false if the timeout expired before
+ */
+bool cuFutureWait(CU_NOTNULL cu_future* future, long msToWait);
 
-//TODO doc
-void* cuParallelThreadPoolWaitResult(CU_NOTNULL cu_parallel_thread_pool* executor, long msToWait, void* defaultValue);
+/**
+ * check if the task associated to the given future has been completed
+ *
+ * @param[in] future the handle of the task to check
+ * @return
+ *  @li true if the task has been completed;
+ *  @li false otherwise
+ */
+bool cuFutureIsDone(CU_NOTNULL const cu_future* future);
 
-//TODO doc
-void* cuDestroyParallelThreadPool(CU_NOTNULL cu_parallel_thread_pool* executor);
+/**
+ * Release the handle of a task
+ *
+ * @note
+ * if the task is still running, it won't be cancelled: it is only the handle which is released.
+ *
+ * @param[in] future the handle to release
+ */
+void cuFutureDestroy(CU_NOTNULL const cu_future* future, CU_NULLABLE const struct var_args* context);
+#define CU_FUNCTION_POINTER_destructor_void_cuFutureDestroy_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
 
 
 #endif /* MULTITHREADING_H_ */
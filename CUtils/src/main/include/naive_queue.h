@@ -18,6 +18,8 @@
 #include "typedefs.h"
 #include "payload_functions.h"
 #include "var_args.h"
+#include "macros.h"
+#include "allocator.h"
 
 typedef struct naive_queue naive_queue;
 
@@ -34,9 +36,18 @@ typedef struct naive_queue_cell naive_queue_cell;
  * @param[in] functions a set of functions allowing you to easily interact with the payload
  * @param[in] f an evaluation function used to set the priority of each element in the queu
  * @param[in] va context of f function. May be NULL
+ * @param[in] allocator the allocator used to create the cells of the queue. NULL means @c malloc. See ::cu_allocator
  * @return a new naive queue initialized in the heap;
  */
-naive_queue* cuNaiveQueueNew(payload_functions functions, evaluator_function f, CU_NULLABLE const var_args* va);
+naive_queue* cuNaiveQueueNew(payload_functions functions, evaluator_function f, CU_NULLABLE const var_args* va, CU_NULLABLE cu_allocator* allocator);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(naive_queue*, cuNaiveQueueNew, payload_functions, evaluator_function, const var_args*, cu_allocator*);
+#define cuNaiveQueueNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuNaiveQueueNew, 4, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuNaiveQueueNew,
+		,
+		,
+		,
+		NULL
+);
 
 /**
  * destroy the naive queue from the memory
@@ -32,6 +32,7 @@
 #include "utility.h"
 #include "hashtable.h"
 #include "hash_set.h"
+#include "allocator.h"
 
 struct PredSuccGraph;
 
@@ -84,6 +85,10 @@ typedef struct Node {
 	 * the payload associated to this node. Can be NULL
 	 */
 	void* payload;
+	/**
+	 * where the node, its hashtables and its outgoing edges are allocated. NULL means malloc
+	 */
+	CU_NULLABLE cu_allocator* allocator;
 } Node;
 
 /**
@@ -101,9 +106,18 @@ Node* newNode(const NodeId id);
  * @param[in] id the id of the node to create
  * @param[in] payload the data to assign to this node
  * @param[in] predecessorsEnable true if we want to keep trace of the predecessor of a node as well: false otherwise;
+ * @param[in] allocator the allocator used to create the node, its hashtables and the edges going out from it. NULL means @c malloc
  * @return a new instance of the node
  */
-Node* newPredSuccNode(NodeId id, CU_NULLABLE const void* payload, bool predecessorsEnable);
+Node* newPredSuccNode(NodeId id, CU_NULLABLE const void* payload, bool predecessorsEnable, CU_NULLABLE cu_allocator* allocator);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(Node*, newPredSuccNode, NodeId, const void*, bool, cu_allocator*);
+#define newPredSuccNode(...) CU_CALL_FUNCTION_WITH_DEFAULTS(newPredSuccNode, 4, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(newPredSuccNode,
+		,
+		,
+		,
+		NULL
+);
 
 /**
  * Like ::newNode but it set also the payload
@@ -90,6 +90,40 @@ void cuPlot2DHelperSetGrid(CU_NOTNULL plot_2d_helper* helper, bool grid);
  */
 void cuPlot2DHelperCreateDataCSV(CU_NOTNULL plot_2d_helper* helper, bool create);
 
+/**
+ * Store the points in a binary data file rather than in a textual one
+ *
+ * Each point is written as a sequence of doubles (the x followed by the y of every series) and the points are
+ * buffered in memory (see ::CU_PLOT_BUFFER_SIZE) before being written. Gnuplot reads the file with
+ * <tt>binary format="%double..."</tt>, so neither the values are formatted nor gnuplot needs to parse them.
+ * Use this with series containing millions of points.
+ *
+ * \note
+ * This should be called before adding any points in the graph!
+ *
+ * @param[inout] helper the helper involved
+ * @param[in] binary true if you want a binary data file, false for a textual one (the default)
+ */
+void cuPlot2DHelperSetBinaryData(CU_NOTNULL plot_2d_helper* helper, bool binary);
+
+/**
+ * Reduce the points stored in the data file
+ *
+ * The points added are grouped in at most @c buckets buckets of consecutive points: for each bucket and each series
+ * we keep only the points where the series has its minimum and its maximum. When all the buckets are full, adjacent buckets are merged,
+ * hence the bucket width doubles. In this way the data file depends on the resolution of the plot and not on the number of points added,
+ * while the peaks of each series are still visible in the plot.
+ *
+ * The reduced points are written in the data file when the plot is generated.
+ *
+ * \note
+ * This should be called after adding all the series but before adding any points in the graph!
+ *
+ * @param[inout] helper the helper involved
+ * @param[in] buckets the maximum number of buckets. A good value is the width in pixel of the plot. 0 disables the reduction (the default)
+ */
+void cuPlot2DHelperSetDownsampling(CU_NOTNULL plot_2d_helper* helper, int buckets);
+
 /**
  * set label for x axis
  *
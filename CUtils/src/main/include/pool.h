@@ -1,29 +1,178 @@
-/*
+/**
  * @file
  *
  * An implementation of the Pool pattern
  *
- *  Created on: Jul 29, 2019
- *      Author: koldar
+ * A pool hands out elements of a fixed size and takes them back when they are no longer needed. Released elements
+ * are kept by the pool and handed out again by the next acquisitions, so after the pool has been warmed up acquiring
+ * and releasing an element costs O(1) and never touches @c malloc:
+ *
+ * @code
+ * struct pool* p = cuPoolNew(point, 1024, NULL);
+ * //allocate the first 4096 elements right away
+ * cuPoolReserve(p, 4096);
+ * point* pt = cuPoolAcquire(p);
+ * pt->x = 5;
+ * cuPoolRelease(p, pt);
+ * cuPoolDestroy(p, NULL);
+ * @endcode
+ *
+ * The pool is owned by the thread which has created it. ::cuPoolRelease can be called by any thread, even while the owner
+ * is acquiring elements: the elements released by the other threads are pushed in a LIFO and are handed out
+ * again once the owner has used up its own free elements. All the other functions need to be called by the owner.
+ *
+ * The pool can also be used to intern values: ::cuPoolAddItem copies a value in an element of the pool only if
+ * an equal value is not already there, while ::cuPoolHasItem tells whether a value has been added. Values are hashed
+ * with the ::hashfunction_t given to ::_cuPoolNew and compared byte by byte.
+ *
+ * @date Jul 29, 2019
+ * @author koldar
  */
 
 #ifndef POOL_H_
 #define POOL_H_
 
+#include <stdbool.h>
+#include <stddef.h>
+#include "macros.h"
+#include "typedefs.h"
 #include "var_args.h"
 
 struct pool;
 
-struct pool* _cuPoolNew(int poolSize, size_t elementSize, hashfunction_t hashFunction);
+/**
+ * Create a new pool
+ *
+ * @param[in] poolSize the number of elements the pool allocates at once when it runs out of free elements.
+ * 	The pool grows by at least this amount, doubling its capacity if it is bigger
+ * @param[in] elementSize the size of every element of the pool
+ * @param[in] hashFunction the function used to hash the values given to ::cuPoolAddItem and ::cuPoolHasItem.
+ * 	If NULL, the bytes of the values are hashed
+ * @return the pool just created. It contains no element
+ */
+CU_NOTNULL struct pool* _cuPoolNew(int poolSize, size_t elementSize, CU_NULLABLE hashfunction_t hashFunction);
 
-void cuPoolDestroy(const struct pool* p);
+/**
+ * Create a new pool of elements of the given type
+ *
+ * @param[in] type the type of the elements of the pool
+ * @param[in] poolSize the number of elements the pool allocates at once
+ * @param[in] hashFunction the function used to hash values. Can be NULL
+ * @see _cuPoolNew
+ */
+#define cuPoolNew(type, poolSize, hashFunction) _cuPoolNew((poolSize), sizeof(type), (hashFunction))
+
+/**
+ * Destroy the pool
+ *
+ * Every element of the pool is released, including the ones still acquired.
+ *
+ * @param[in] p the pool to destroy
+ * @param[in] context unused
+ */
+void cuPoolDestroy(CU_NOTNULL const struct pool* p, CU_NULLABLE const struct var_args* context);
+#define CU_FUNCTION_POINTER_destructor_void_cuPoolDestroy_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
 
-void cuPoolDestroyWithElements(const struct pool* p, CU_NULLABLE const struct var_args* context);
+/**
+ * Get an element from the pool
+ *
+ * If no element is free, the pool allocates a new batch of elements.
+ *
+ * @param[inout] p the pool involved
+ * @return an element of the pool. Its content is undefined
+ */
+CU_NOTNULL void* cuPoolAcquire(CU_NOTNULL struct pool* p);
 
-void cuPoolAddItem(const struct pool* p, CU_NULLABLE const void* item);
+/**
+ * Give back an element to the pool
+ *
+ * The function can be called concurrently by several threads. The owner of the pool releases its
+ * elements without any atomic operation. The other threads push the element in a LIFO shared with the owner: it is lock-free
+ * on platforms with a double-word compare and swap, otherwise it is guarded by a spin lock held only for the push.
+ *
+ * @attention
+ * do not release an element returned by ::cuPoolAddItem: use ::cuPoolRemoveItem instead
+ *
+ * @param[inout] p the pool involved
+ * @param[in] element an element returned by ::cuPoolAcquire of @c p
+ */
+void cuPoolRelease(CU_NOTNULL struct pool* p, CU_NOTNULL const void* element);
 
-void cuPoolClear(const struct pool* p);
+/**
+ * Make sure the pool has at least a given number of free elements
+ *
+ * Use it to allocate all the elements upfront, before a phase where acquisitions need to be fast
+ *
+ * @param[inout] p the pool involved
+ * @param[in] elements the number of elements which should be acquirable without allocating memory
+ */
+void cuPoolReserve(CU_NOTNULL struct pool* p, size_t elements);
 
-bool cuPoolHasItem(const struct pool* p, const void* item, CU_NULLABLE const);
+/**
+ * Add a copy of a value in the pool
+ *
+ * @param[inout] p the pool involved
+ * @param[in] item the value to add. It needs to be as big as the elements of the pool
+ * @param[in] context additional data passed to the hash function of the pool
+ * @return the element of the pool containing a copy of @c item. If an equal value was already added,
+ * 	the element containing such value
+ */
+CU_NOTNULL void* cuPoolAddItem(CU_NOTNULL struct pool* p, CU_NOTNULL const void* item, CU_NULLABLE const struct var_args* context);
+
+/**
+ * Check if a value has been added to the pool
+ *
+ * @param[in] p the pool involved
+ * @param[in] item the value to look for. It needs to be as big as the elements of the pool
+ * @param[in] context additional data passed to the hash function of the pool
+ * @return true if a value equal to @c item has been added via ::cuPoolAddItem, false otherwise
+ */
+bool cuPoolHasItem(CU_NOTNULL const struct pool* p, CU_NOTNULL const void* item, CU_NULLABLE const struct var_args* context);
+
+/**
+ * Remove a value added via ::cuPoolAddItem
+ *
+ * The element containing the value is given back to the pool
+ *
+ * @param[inout] p the pool involved
+ * @param[in] item the value to remove. It needs to be as big as the elements of the pool
+ * @param[in] context additional data passed to the hash function of the pool
+ * @return true if the value was in the pool, false otherwise
+ */
+bool cuPoolRemoveItem(CU_NOTNULL struct pool* p, CU_NOTNULL const void* item, CU_NULLABLE const struct var_args* context);
+
+/**
+ * Give back to the pool all its elements
+ *
+ * Both the acquired elements and the added values are released. The memory is not given back to the system
+ *
+ * @param[inout] p the pool to clear
+ */
+void cuPoolClear(CU_NOTNULL struct pool* p);
+
+/**
+ * @param[in] p the pool involved
+ * @return the size of every element of the pool
+ */
+size_t cuPoolGetElementSize(CU_NOTNULL const struct pool* p);
+
+/**
+ * @param[in] p the pool involved
+ * @return the number of elements the pool has allocated so far, either in use or not
+ */
+size_t cuPoolGetCapacity(CU_NOTNULL const struct pool* p);
+
+/**
+ * @param[in] p the pool involved
+ * @return the number of elements acquired or added and not yet released
+ */
+size_t cuPoolGetInUse(CU_NOTNULL const struct pool* p);
+
+/**
+ * @param[in] p the pool involved
+ * @return the maximum number of elements which have been in use at the same time since the pool creation or
+ * 	since the last ::cuPoolClear
+ */
+size_t cuPoolGetHighWaterMark(CU_NOTNULL const struct pool* p);
 
 #endif /* POOL_H_ */
@@ -40,6 +40,10 @@ typedef struct PredSuccGraph {
 	 * it's a strategy that will increase the amount of memory and CPU needed
 	 */
 	bool enablePredecessors;
+	/**
+	 * where the nodes and the edges of the graph are allocated. NULL means malloc
+	 */
+	CU_NULLABLE cu_allocator* allocator;
 	//TODO remove
 //	/**
 //	 * The function to use to compare the payload of 2 nodes
@@ -101,15 +105,18 @@ typedef struct PredSuccGraph {
  * @param[in] enablePredecessors true if you want that every nodes stores not only its successors, but also its predecessors;
  * @param[in] vertexPayload payload functions used to easily manage the payload of each vertex
  * @param[in] edgePaylaod paylaod functions used to easily manage paylaod of each edge
+ * @param[in] allocator the allocator used to create the nodes and the edges of the graph. NULL means @c malloc. See ::cu_allocator.
+ * 	With an arena, building a graph does not call @c malloc for each node and each edge and destroying it does not call @c free for each of them
  * @return an instance of the newly created graph
  */
-PredSuccGraph* cuPredSuccGraphNew(bool enablePredecessors, payload_functions vertexPayload, payload_functions edgePayload);
-CU_DECLARE_FUNCTION_WITH_DEFAULTS(PredSuccGraph*, cuPredSuccGraphNew, bool, payload_functions, payload_functions);
-#define cuPredSuccGraphNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuPredSuccGraphNew, 3, __VA_ARGS__)
+PredSuccGraph* cuPredSuccGraphNew(bool enablePredecessors, payload_functions vertexPayload, payload_functions edgePayload, CU_NULLABLE cu_allocator* allocator);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(PredSuccGraph*, cuPredSuccGraphNew, bool, payload_functions, payload_functions, cu_allocator*);
+#define cuPredSuccGraphNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuPredSuccGraphNew, 4, __VA_ARGS__)
 CU_DECLARE_DEFAULT_VALUES(cuPredSuccGraphNew,
         false,
 		cuPayloadFunctionsDefault(),
-		cuPayloadFunctionsDefault()
+		cuPayloadFunctionsDefault(),
+		NULL
 );
 
 /**
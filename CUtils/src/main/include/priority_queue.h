@@ -4,14 +4,18 @@
  * Implements a priority queue using a function evaluation on the nodes.
  *
  * Objects with low evaluation are fetched first.
- * The implementation uses an heap to implement the queue.
+ * The implementation uses a d-ary heap (4-ary by default) stored in a contiguous array to implement the queue: a bigger arity
+ * makes the heap shallower and the children of a node adjacent in memory, at the cost of more comparisons when popping.
+ *
+ * The queue keeps track of where every payload is, so ::cuPriorityQueueChangePriority and ::cuPriorityQueueRemoveItem are
+ * \f$O(\log n)\f$ out of the box. Payloads are identified by their address.
  *
  * There are some optimization to be aware of:
  *  - fast add insertion: normally when adding item in the queue, you nee dto specify both value to add and its priority with ::cuPriorityQueueAddItem .
  *  	However, you can firstly call ::cuPriorityQueueEnableFastAddOperation to set a default evaluation function and call ::cuPriorityQueueAddItem1 to
  *  	automatically generate the priority level;
- *  - fast contain operation: during contains, we look in the whole head for the requested data. However, if you call ::cuPriorityQueueEnableFastContainOperation
- *  	you will be able to inject a function that we will call instead. You should use this function to store the ::priority_queue_cell storing your data
+ *  - fast contain operation: if you call ::cuPriorityQueueEnableFastContainOperation
+ *  	you will be able to inject a function that we will call instead of the builtin lookup. You should use this function to store the ::priority_queue_cell storing your data
  *
  *
  *
@@ -28,6 +32,8 @@
 #include "var_args.h"
 #include "payload_functions.h"
 #include "list.h"
+#include "macros.h"
+#include "allocator.h"
 
 
 typedef struct priority_queue priority_queue;
@@ -68,9 +74,18 @@ typedef void (*queue_addItem)(CU_NOTNULL priority_queue* q, CU_NULLABLE const vo
  * initialize an empty queue without any optimizations
  *
  * @param[in] p a structure containing several methods used to handle the payload of the queue
+ * @param[in] arity the number of children each node of the heap has. Needs to be at least 2
+ * @param[in] allocator the allocator used to create the cells of the queue. NULL means @c malloc. See ::cu_allocator
  * @return an instance of the queue
  */
-CU_NOTNULL priority_queue* cuPriorityQueueNew(payload_functions p);
+CU_NOTNULL priority_queue* cuPriorityQueueNew(payload_functions p, unsigned int arity, CU_NULLABLE cu_allocator* allocator);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(priority_queue*, cuPriorityQueueNew, payload_functions, unsigned int, cu_allocator*);
+#define cuPriorityQueueNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuPriorityQueueNew, 3, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuPriorityQueueNew,
+		cuPayloadFunctionsDefault(),
+		4,
+		NULL
+);
 
 /**
  * Destroy the queue. The items in the queue won't be released
@@ -228,9 +243,9 @@ void* cuPriorityQueueFindItem(CU_NOTNULL const priority_queue* q, finder f, CU_N
  * minimum no search will ever be started since no items can have a score less than the top ones. This will return false
  * even if @c data is indeed stored in the queue but has a different evaluation score.
  *
- * The function is faster than ::cuPriorityQueueContainsItem1
+ * Items with the same address of @c data are found in constant time; otherwise the whole queue is scanned with the compare function of the payload
  *
- * if ::cuQueueSetFindOperation has been called, the quicker version of containment will be invoked instead
+ * if ::cuPriorityQueueEnableFastContainOperation has been called, the quicker version of containment will be invoked instead
  *
  *
  * @param[in] q the queue to analyze
@@ -245,10 +260,10 @@ bool cuPriorityQueueContainsItem0(CU_NOTNULL const priority_queue* q, CU_NULLABL
  * Check if the queue contains an item
  *
  * @note
- * This function is **much slower** than ::cuPriorityQueueContainsItem0 when :cuQueueSetFindOperation has not been called.
+ * Items with the same address of @c data are found in constant time; otherwise the whole queue is scanned with the compare function of the payload.
  * The function will return sound results no matter the priority
  *
- * if ::cuQueueSetFindOperation has been called, the quicker version of containment will be invoked instead
+ * if ::cuPriorityQueueEnableFastContainOperation has been called, the quicker version of containment will be invoked instead
  *
  * @param[in] q the queue involved
  * @param[in] data the data we need to check
@@ -262,20 +277,24 @@ bool cuPriorityQueueContainsItem1(CU_NOTNULL const priority_queue* q, CU_NULLABL
 /**
  * update the priority of the given data
  *
+ * The operation is \f$O(\log n)\f$.
+ *
  * @pre
- *  @li ::cuPriorityQueueNew initialized with @c enableUpdatePriorityOperation set to @true
+ *  @li @c data is inside the queue. If @c data has been added multiple times, only one of its occurences is updated
  *
  * @param[inout] q the involved
  * @param[in] data the data whose priority needs to be updated
  * @param[in] newPriority a number which represents the new priority @c data has
+ * @return the previous priority of @c data
  */
-int cuPriorityQueueChangePriority(CU_NOTNULL priority_queue* q, CU_NULLABLE const void* data, long newPriority);
+long cuPriorityQueueChangePriority(CU_NOTNULL priority_queue* q, CU_NULLABLE const void* data, long newPriority);
 
 /**
  * retrieve the item inside the queue and removes it
  *
+ * The operation is \f$O(\log n)\f$.
+ *
  * @pre
- *  @li ::cuPriorityQueueNew initialized with @c enableUpdatePriorityOperation set to @true
  *  @li queue not empty and containing @c data
  *
  * @param[inout] q the queue involved
@@ -287,7 +306,7 @@ void cuPriorityQueueRemoveItem(CU_NOTNULL priority_queue* q, CU_NULLABLE const v
  * @param[in] qc the cell containing a data
  * @return the priority of this queue cell
  */
-int cuPriorityQueueCellGetPriority(CU_NOTNULL const struct priority_queue_cell* qc);
+long cuPriorityQueueCellGetPriority(CU_NOTNULL const struct priority_queue_cell* qc);
 
 /**
  * generate on the heap a list from queue
@@ -345,6 +364,12 @@ CU_NULLABLE queue_findItem cuPriorityQueueGetFindItemOperation(CU_NOTNULL const
  */
 CU_NULLABLE queue_addItem cuPriorityQueueGetAddItemOperation(CU_NOTNULL const priority_queue* q);
 
+/**
+ * @param[in] q the queue involved
+ * @return the number of children each node of the heap has
+ */
+unsigned int cuPriorityQueueGetArity(CU_NOTNULL const priority_queue* q);
+
 /**
  * fetch the item with lowest priority in the queue without removing it from the queue
  *
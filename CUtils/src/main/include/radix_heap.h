@@ -0,0 +1,208 @@
+/**
+ * @file
+ *
+ * A monotone priority queue for integer priorities, implemented as a radix heap
+ *
+ * The queue has the same interface of ::naive_queue, but it requires the workload to be <b>monotone</b>:
+ * you can't add an item whose evaluation is less than the evaluation of the last item peeked or popped.
+ * This is the case of Dijkstra's algorithm with non negative integer weights, of Dial's algorithm and of BFS layers.
+ *
+ * Items are stored in 33 buckets. Bucket 0 contains the items with the same evaluation of the last item extracted,
+ * bucket @c i contains the items whose evaluation differs from it starting from the @c i -th bit.
+ * When bucket 0 is empty, the first non empty bucket is redistributed in the lower buckets.
+ * Each item is moved at most 32 times, hence adding an item is \f$ O(1) \f$ while popping it is amortized \f$ O(\log C) \f$,
+ * where @c C is the difference between the greatest and the smallest evaluation in the queue.
+ * Each bucket is an array, so there are no allocations per item.
+ *
+ * @code
+ * radix_heap* q = cuRadixHeapNew(cuPayloadFunctionsIntValue());
+ * cuRadixHeapAddItemWithEvaluation(q, CU_CAST_INT2PTR(source), 0);
+ * while (!cuRadixHeapIsEmpty(q)) {
+ * 	int distance = cuRadixHeapPeekEvaluation(q);
+ * 	int vertex = CU_CAST_PTR2INT(cuRadixHeapPopItem(q, void*));
+ * 	...
+ * }
+ * cuRadixHeapDestroy(q, NULL);
+ * @endcode
+ *
+ * Items with the same evaluation are popped in no particular order.
+ *
+ * @author koldar
+ * @date Oct 16, 2026
+ */
+
+#ifndef RADIX_HEAP_H_
+#define RADIX_HEAP_H_
+
+#include <stdbool.h>
+#include "typedefs.h"
+#include "payload_functions.h"
+#include "var_args.h"
+#include "macros.h"
+
+typedef struct radix_heap radix_heap;
+
+/**
+ * A radix heap containing integers
+ */
+typedef radix_heap int_radix_heap;
+
+/**
+ * Initialize a new radix heap
+ *
+ * @param[in] functions a set of functions allowing you to easily interact with the payload
+ * @param[in] f an evaluation function used to set the priority of each element added with ::cuRadixHeapAddItem.
+ * 	If NULL, items can be added only via ::cuRadixHeapAddItemWithEvaluation
+ * @param[in] va context of f function. May be NULL
+ * @return a new radix heap initialized in the heap
+ */
+radix_heap* cuRadixHeapNew(payload_functions functions, CU_NULLABLE evaluator_function f, CU_NULLABLE const var_args* va);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(radix_heap*, cuRadixHeapNew, payload_functions, evaluator_function, const var_args*);
+#define cuRadixHeapNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuRadixHeapNew, 3, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuRadixHeapNew,
+		,
+		NULL,
+		NULL
+);
+
+/**
+ * destroy the radix heap from the memory
+ *
+ * \note
+ * the items within the queue won't be touched
+ *
+ * @param[in] h the queue to dispose of
+ * @param[in] context unused
+ */
+void cuRadixHeapDestroy(CU_NOTNULL const radix_heap* h, CU_NULLABLE const struct var_args* context);
+#define CU_FUNCTION_POINTER_destructor_void_cuRadixHeapDestroy_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
+
+/**
+ * destroy the radix heap from the memory **and** its elements
+ *
+ * @param[in] h the queue to dispose of
+ * @param[in] context passed to the destructor of the payload
+ */
+void cuRadixHeapDestroyWithElements(CU_NOTNULL const radix_heap* h, CU_NULLABLE const struct var_args* context);
+#define CU_FUNCTION_POINTER_destructor_void_cuRadixHeapDestroyWithElements_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
+
+/**
+ * Add a new item within the queue
+ *
+ * The priority of the item is computed via the ::evaluator_function given at construction time
+ *
+ * @pre
+ *  @li the queue has an ::evaluator_function;
+ *  @li the evaluation of @c el is not less than the evaluation of the last item peeked or popped;
+ *
+ * @param[inout] h the queue to update
+ * @param[in] el the element to add
+ */
+void cuRadixHeapAddItem(CU_NOTNULL radix_heap* h, CU_NULLABLE const void* el);
+
+/**
+ * Add a new item within the queue with the given priority
+ *
+ * @pre
+ *  @li @c evaluation is not less than the evaluation of the last item peeked or popped;
+ *
+ * @param[inout] h the queue to update
+ * @param[in] el the element to add
+ * @param[in] evaluation the priority of @c el. The lower, the sooner it will be popped
+ */
+void cuRadixHeapAddItemWithEvaluation(CU_NOTNULL radix_heap* h, CU_NULLABLE const void* el, int evaluation);
+
+/**
+ * peek the item with the lowest evaluation
+ *
+ * @private
+ *
+ * @param[in] h the queue involved
+ * @return the first item of the queue or NULL if the queue is empty
+ */
+CU_NULLABLE void* _cuRadixHeapPeekItem(CU_NOTNULL const radix_heap* h);
+
+/**
+ * get **and** removes from the queue the item with the lowest evaluation
+ *
+ * @private
+ *
+ * @param[inout] h the queue involved
+ * @return the first item of the queue or NULL if the queue is empty
+ */
+CU_NULLABLE void* _cuRadixHeapPopItem(CU_NOTNULL radix_heap* h);
+
+/**
+ * the evaluation of the item ::cuRadixHeapPeekItem would return
+ *
+ * @pre
+ *  @li @c h not empty
+ *
+ * @param[in] h the queue involved
+ * @return the lowest evaluation in the queue
+ */
+int cuRadixHeapPeekEvaluation(CU_NOTNULL const radix_heap* h);
+
+/**
+ * Check if the queue is empty
+ *
+ * @param[in] h the queue to check
+ * @return
+ * 	\li true if the queue is empty;
+ * 	\li false otherwise;
+ */
+bool cuRadixHeapIsEmpty(CU_NOTNULL const radix_heap* h);
+
+/**
+ * get the number of element within the queue
+ *
+ * @param[in] h the queue to check
+ * @return the number of elements within the queue
+ */
+int cuRadixHeapGetSize(CU_NOTNULL const radix_heap* h);
+
+/**
+ * Clear all the elements within the queue
+ *
+ * After this call, items with any evaluation can be added again. The memory of the buckets is kept
+ *
+ * @param[inout] h the queue to flush
+ */
+void cuRadixHeapClear(CU_NOTNULL radix_heap* h);
+
+/**
+ * Like ::cuRadixHeapClear but the payloads are destroyed as well
+ *
+ * @param[inout] h the queue to flush
+ */
+void cuRadixHeapClearWithElements(CU_NOTNULL radix_heap* h);
+
+/**
+ * get the item with the lowest evaluation
+ *
+ * @code
+ * h = cuRadixHeapNew(...);
+ * struct point* p = cuRadixHeapPeekItem(h, struct point*);
+ * @endcode
+ *
+ * @param[in] h the queue whose head we need to peek
+ * @param[in] type the type of the returned value of this function
+ * @return the head of the queue
+ */
+#define cuRadixHeapPeekItem(h, type) ((type)(_cuRadixHeapPeekItem(h)))
+
+/**
+ * get the item with the lowest evaluation and removes it from the queue
+ *
+ * @code
+ * h = cuRadixHeapNew(...);
+ * struct point* p = cuRadixHeapPopItem(h, struct point*);
+ * @endcode
+ *
+ * @param[inout] h the queue whose head we need to pop
+ * @param[in] type the type of the returned value of this function
+ * @return the head of the queue
+ */
+#define cuRadixHeapPopItem(h, type) ((type)(_cuRadixHeapPopItem(h)))
+
+#endif /* RADIX_HEAP_H_ */
@@ -30,6 +30,7 @@
 #include "payload_functions.h"
 #include "typedefs.h"
 #include "macros.h"
+#include "allocator.h"
 
 
 typedef struct rb_tree rb_tree;
@@ -38,9 +39,16 @@ typedef struct rb_tree rb_tree;
  * Creates a new red black tree in the memory
  *
  * @param[in] functions set of functions to easily manage the payload
+ * @param[in] allocator the allocator used to create the nodes of the tree. NULL means @c malloc. See ::cu_allocator
  * @return the instance of the red black tree
  */
-rb_tree* cuRedBlackTreeNew(payload_functions functions);
+rb_tree* cuRedBlackTreeNew(payload_functions functions, CU_NULLABLE cu_allocator* allocator);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(rb_tree*, cuRedBlackTreeNew, payload_functions, cu_allocator*);
+#define cuRedBlackTreeNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuRedBlackTreeNew, 2, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuRedBlackTreeNew,
+		,
+		NULL
+);
 
 /**
  * Destroy the tree
@@ -14,6 +14,22 @@
  * @li There aren't available shortcuts like <tt>\\d<tt> or <tt>\\w</tt>: use classes. For further information see <a href="https://www.regular-expressions.info/posixbrackets.html">here</a>
  * @li There isn't the operator "+", so you need to manually create it with "*" (e.g., "a+" can be encoded with "aa*")
  *
+ * Compiling a regular expression is far more expensive than executing it. If you apply the same regex many times,
+ * compile it once with ::cuRegularExpressionCompile and use ::cuRegularExpressionExecute:
+ *
+ * @code
+ * cu_regex* regex = cuRegularExpressionCompile("!" CU_RE_CG(CU_RE_WORD) "!");
+ * regmatch_t groups[2];
+ * char word[20];
+ * if (cuRegularExpressionExecute(regex, "ciao !Mondo!", 2, groups)) {
+ * 	cuRegularExpressionGetGroup("ciao !Mondo!", groups, 1, word, 20);
+ * }
+ * cuRegularExpressionDestroy(regex, NULL);
+ * @endcode
+ *
+ * ::cuRegularExpressionApply and ::cuRegularExpressionIsSatisfying do not compile the regex at every call either:
+ * they fetch it from a process-wide cache of the most recently used regular expressions (see ::cuRegularExpressionCacheGet).
+ *
  * @date May 18, 2017
  * @author koldar
  */
@@ -23,9 +39,21 @@
 
 #include <regex.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "macros.h"
 #include "var_args.h"
 
+/**
+ * A compiled regular expression
+ */
+typedef struct cu_regex cu_regex;
+
+/**
+ * the maximum number of regular expressions the cache of ::cuRegularExpressionCacheGet holds, unless changed with
+ * ::cuRegularExpressionCacheSetCapacity
+ */
+#define CU_REGEX_CACHE_DEFAULT_CAPACITY 32
+
 /**
  * Represents a digit
  */
@@ -140,4 +168,105 @@ bool cuRegularExpressionIsSatisfying(CU_NOTNULL const char* restrict string, CU_
  */
 void cuRegularExpressionDestroyGroupInfo(int groupSize, CU_NOTNULL char const *const *const * groups);
 
+/**
+ * Compile a regular expression
+ *
+ * If the regex is malformed, the program is aborted
+ *
+ * @param[in] regex the regular expression
+ * @return the compiled regular expression. Release it with ::cuRegularExpressionDestroy
+ */
+CU_NOTNULL cu_regex* cuRegularExpressionCompile(CU_NOTNULL const char* regex);
+
+/**
+ * Release a compiled regular expression
+ *
+ * The compiled regex is actually freed only when all the handles referring to it have been released
+ *
+ * @param[in] regex a handle returned by ::cuRegularExpressionCompile or ::cuRegularExpressionCacheGet
+ * @param[in] context unused
+ */
+void cuRegularExpressionDestroy(CU_NOTNULL const cu_regex* regex, CU_NULLABLE const struct var_args* context);
+#define CU_FUNCTION_POINTER_destructor_void_cuRegularExpressionDestroy_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
+
+/**
+ * @param[in] regex the regex involved
+ * @return the string the regex has been compiled from
+ */
+CU_NOTNULL const char* cuRegularExpressionGetPattern(CU_NOTNULL const cu_regex* regex);
+
+/**
+ * @param[in] regex the regex involved
+ * @return the number of capturing groups in the regex
+ */
+int cuRegularExpressionGetGroupsNumber(CU_NOTNULL const cu_regex* regex);
+
+/**
+ * Apply a compiled regex on a string
+ *
+ * The function does not allocate anything: the positions of the capturing groups are written in @c groups,
+ * which is usually an array on the stack. Use ::cuRegularExpressionGetGroup to extract the groups.
+ * A compiled regex can be executed by several threads at the same time.
+ *
+ * @param[in] regex the regex to execute
+ * @param[in] string the string to apply the regex on
+ * @param[in] groupsSize the number of cells of @c groups. The cell 0 is the whole match, the cell @c i the i-th capturing group
+ * @param[out] groups where to store the position of the groups. Can be NULL if @c groupsSize is 0
+ * @return true if @c string matches the regex, false otherwise
+ */
+bool cuRegularExpressionExecute(CU_NOTNULL const cu_regex* regex, CU_NOTNULL const char* string, int groupsSize, CU_NULLABLE regmatch_t* groups);
+
+/**
+ * Copy a group found by ::cuRegularExpressionExecute in a buffer
+ *
+ * @param[in] string the string passed to ::cuRegularExpressionExecute
+ * @param[in] groups the groups populated by ::cuRegularExpressionExecute
+ * @param[in] groupNumber the group to copy. 0 is the whole match
+ * @param[out] buffer where to copy the group. The string is always terminated by '\0', truncating it if needed
+ * @param[in] bufferSize the size of @c buffer
+ * @return the length of the group, even if it has been truncated, or -1 if the group has not matched anything
+ */
+int cuRegularExpressionGetGroup(CU_NOTNULL const char* string, CU_NOTNULL const regmatch_t* groups, int groupNumber, CU_NOTNULL char* buffer, size_t bufferSize);
+
+/**
+ * Fetch a compiled regular expression from a process-wide cache
+ *
+ * The cache keeps the regular expressions used most recently: when it is full, the least recently used
+ * regex is evicted. The cache can be used by several threads at the same time.
+ *
+ * @param[in] regex the regular expression
+ * @return the compiled regular expression. Release it with ::cuRegularExpressionDestroy.
+ * 	The handle stays valid even if the regex is evicted from the cache
+ */
+CU_NOTNULL cu_regex* cuRegularExpressionCacheGet(CU_NOTNULL const char* regex);
+
+/**
+ * Change the number of regular expressions the cache can hold
+ *
+ * If the cache contains more regular expressions, the least recently used are evicted
+ *
+ * @param[in] capacity the new capacity. 0 disables the cache
+ */
+void cuRegularExpressionCacheSetCapacity(size_t capacity);
+
+/**
+ * Evict every regular expression from the cache and reset its counters
+ */
+void cuRegularExpressionCacheClear();
+
+/**
+ * @return the number of regular expressions currently in the cache
+ */
+size_t cuRegularExpressionCacheGetSize();
+
+/**
+ * @return the number of calls to ::cuRegularExpressionCacheGet which have found the regex in the cache
+ */
+unsigned long cuRegularExpressionCacheGetHits();
+
+/**
+ * @return the number of calls to ::cuRegularExpressionCacheGet which have compiled the regex
+ */
+unsigned long cuRegularExpressionCacheGetMisses();
+
 #endif /* REGULAREXPRESSION_H_ */
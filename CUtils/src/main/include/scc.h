@@ -11,6 +11,8 @@
 #include "predsuccgraph.h"
 #include "hashtable.h"
 #include "heap.h"
+#include "multithreading.h"
+#include "csr_graph.h"
 
 /**
  * Represents the possible return value of the function ::edge_traverser
@@ -46,17 +48,66 @@ typedef Node scc;
 typedef heap node_heap;
 typedef struct scc_graph scc_graph;
 
+/**
+ * The algorithms ::cuStronglyConnectedComponentsGraphNew can use to compute the sccs
+ */
+enum scc_algorithm {
+	/**
+	 * Recursive Tarjan algorithm working directly on the graph
+	 */
+	SCC_RECURSIVE_TARJAN,
+	/**
+	 * Pearce variant of Tarjan algorithm, with an explicit stack instead of recursion.
+	 *
+	 * Before the visit, the nodes are mapped to dense indices and their included successors are copied in flat arrays, so the visit
+	 * doesn't look up any hashtable and it can't overflow the call stack on deep graphs. The copy requires memory proportional to the number of edges.
+	 * The successors are visited in the same order of ::SCC_RECURSIVE_TARJAN, so the sccs, their ids and the inter scc edges are exactly the same
+	 */
+	SCC_ITERATIVE_TARJAN,
+	/**
+	 * The graph is frozen (see ::cuPredSuccGraphFreeze) and the sccs are computed by ::cuCSRGraphParallelComputeSCC.
+	 * The freeze is performed by the calling thread at every call, unless a snapshot is passed to ::cuStronglyConnectedComponentsGraphNew:
+	 * when the graph does not change between several computations, freeze it once.
+	 *
+	 * The ::edge_traverser is called on every edge between included nodes, by the calling thread, before the computation begins.
+	 * If it returns ::ET_STOP, the computation does not start at all and the ::scc_graph is left empty.
+	 * The sccs are numbered in reverse topological order, like ::SCC_RECURSIVE_TARJAN does, but the numbers may differ since the Tarjan algorithms depend
+	 * on the order of the successors in the hashtables
+	 */
+	SCC_PARALLEL
+};
+
 /**
  * Creates a graph containing the sccs of the given \c graph
  *
+ * @code
+ * cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(16);
+ * scc_graph* sccGraph = cuStronglyConnectedComponentsGraphNew(graph, edge_traverser_alwaysAccept, true, NULL, SCC_PARALLEL, pool);
+ * @endcode
+ *
  * @param[in] graph the graph we want to compute the sccs from
  * @param[in] traverser a function telling us if we need to traverse an edge or not
  * @param[in] trackInterSCCEdges if true, we will create a ::scc_graph containing edges between 2 different sccs as well. Otherwise we will create only the sccs
  * @param[in] included contains an hashtable indexed by the nodes ids. If a node id is inside the hastable, the node will be considered during tarjan algorithm, otherwise the software will
  * 				ignoring it_ in this way you can compute SCCs on a subgraph of the given \c graph. The parameter can be NULL: if so, the whole graph will be analyzed
+ * @param[in] algorithm the algorithm used to compute the sccs
+ * @param[inout] pool the workers used by ::SCC_PARALLEL. Ignored by the other algorithms. If NULL, ::SCC_PARALLEL works on the calling thread
+ * @param[in] snapshot a snapshot of @c graph created by ::cuPredSuccGraphFreeze after its last change, used by ::SCC_PARALLEL. Ignored by the other algorithms.
+ * 	If NULL, ::SCC_PARALLEL creates a new snapshot and destroys it within the call
  * @return an instance of the ::scc_graph
  */
-scc_graph* cuStronglyConnectedComponentsGraphNew(const PredSuccGraph* graph, edge_traverser traverser, bool trackInterSCCEdges, const bool_ht* included);
+scc_graph* cuStronglyConnectedComponentsGraphNew(const PredSuccGraph* graph, edge_traverser traverser, bool trackInterSCCEdges, const bool_ht* included, enum scc_algorithm algorithm, CU_NULLABLE cu_parallel_thread_pool* pool, CU_NULLABLE const csr_graph* snapshot);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(scc_graph*, cuStronglyConnectedComponentsGraphNew, const PredSuccGraph*, edge_traverser, bool, const bool_ht*, enum scc_algorithm, cu_parallel_thread_pool*, const csr_graph*);
+#define cuStronglyConnectedComponentsGraphNew(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuStronglyConnectedComponentsGraphNew, 7, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuStronglyConnectedComponentsGraphNew,
+		,
+		,
+		,
+		,
+		SCC_RECURSIVE_TARJAN,
+		NULL,
+		NULL
+);
 
 void cuStronglyConnectedComponentsGraphDestroy(const scc_graph* sccGraph, CU_NULLABLE const struct var_args* context);
 #define CU_FUNCTION_POINTER_destructor_void_cuStronglyConnectedComponentsGraphDestroy_voidConstPtr_var_argsConstPtr CU_DESTRUCTOR_ID
@@ -11,6 +11,9 @@
 #include "predsuccgraph.h"
 #include "scc.h"
 #include "var_args.h"
+#include "macros.h"
+#include "multithreading.h"
+#include "csr_graph.h"
 
 /**
  * a list of nodes ::Node
@@ -34,6 +37,75 @@ void cuJohnsonSupportDestroy(johnson_support* support, CU_NULLABLE const struct
 
 loop_list* cuJohnsonSupportComputeSimpleLoops(johnson_support* support, const PredSuccGraph* g, edge_traverser t);
 
+/**
+ * A function called by ::cuSimpleLoopComputerParallelVisitLoops every time a simple loop has been found
+ *
+ * @param[in] loop the nodes of the loop, in order, starting from the node with the minimum id. The last node has an edge going to the first one.
+ * 	The array is valid only during the call
+ * @param[in] length the number of nodes in @c loop
+ * @param[in] context the context passed to ::cuSimpleLoopComputerParallelVisitLoops
+ * @return
+ *  @li true if the enumeration should go on;
+ *  @li false to stop the enumeration
+ */
+typedef bool (*cu_simple_loop_visitor)(CU_NOTNULL Node* const* loop, unsigned int length, CU_NULLABLE const struct var_args* context);
+
+/**
+ * Enumerate the simple loops of a graph exploiting several threads, without storing them
+ *
+ * The implementation is Johnson algorithm, partitioned by root: the loops whose minimum node is @c s are the loops through @c s in the subgraph
+ * made up of the nodes of the strongly connected component of @c s whose id is greater than @c s. So the roots are shared among the workers,
+ * each of them with its own @c blocked and @c B state, and the components are computed only once (see ::cuCSRGraphParallelComputeSCC).
+ * The enumeration works on a ::csr_graph: unless @c snapshot is given, the calling thread freezes @c g at every call, so freeze it once
+ * if you enumerate the loops of the same graph several times.
+ *
+ * Since loops are handed to @c visitor as soon as they are found, the memory used does not depend on the number of loops. Use @c maxLength to
+ * prune the search on large components and @c maxLoops to stop after the first loops have been found.
+ *
+ * @code
+ * static bool printLoop(Node* const* loop, unsigned int length, const struct var_args* context) {
+ * 	for (unsigned int i=0; i<length; i++) {
+ * 		printf("%lu ", loop[i]->id);
+ * 	}
+ * 	printf("\n");
+ * 	return true;
+ * }
+ *
+ * cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(8);
+ * unsigned long loops = cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_alwaysAccept, pool, printLoop);
+ * @endcode
+ *
+ * @attention
+ * @c visitor is called by the workers of @c pool, but never by 2 of them at the same time. The order of the loops depends on the workers: if
+ * @c pool is NULL, the loops are found root after root, by increasing id of the root
+ *
+ * @param[in] g the graph where we want to look for loops
+ * @param[in] t the function telling which edges can be part of a loop. It is called once per edge, on the calling thread, before the enumeration begins:
+ * 	if it returns ::ET_STOP, no loop is enumerated at all
+ * @param[inout] pool the workers enumerating the loops. If NULL, the loops are enumerated by the calling thread
+ * @param[in] visitor the function receiving the loops. If NULL, the loops are only counted
+ * @param[in] context an additional value passed to @c visitor
+ * @param[in] minLength the loops with less than @c minLength nodes are not passed to @c visitor nor counted
+ * @param[in] maxLength the loops with more than @c maxLength nodes are not looked for. 0 means there is no limit
+ * @param[in] maxLoops the enumeration stops after @c maxLoops loops. 0 means there is no limit
+ * @param[in] snapshot a snapshot of @c g created by ::cuPredSuccGraphFreeze after its last change. If NULL, a new snapshot is created and destroyed within the call
+ * @return the number of loops passed to @c visitor
+ */
+unsigned long cuSimpleLoopComputerParallelVisitLoops(CU_NOTNULL const PredSuccGraph* g, CU_NOTNULL edge_traverser t, CU_NULLABLE cu_parallel_thread_pool* pool, CU_NULLABLE cu_simple_loop_visitor visitor, CU_NULLABLE const struct var_args* context, unsigned int minLength, unsigned int maxLength, unsigned long maxLoops, CU_NULLABLE const csr_graph* snapshot);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(unsigned long, cuSimpleLoopComputerParallelVisitLoops, const PredSuccGraph*, edge_traverser, cu_parallel_thread_pool*, cu_simple_loop_visitor, const struct var_args*, unsigned int, unsigned int, unsigned long, const csr_graph*);
+#define cuSimpleLoopComputerParallelVisitLoops(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuSimpleLoopComputerParallelVisitLoops, 9, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuSimpleLoopComputerParallelVisitLoops,
+		,
+		,
+		NULL,
+		NULL,
+		NULL,
+		0,
+		0,
+		0,
+		NULL
+);
+
 /**
  * Compute a set fo functions to easily manage the paylaod of a container when ::loop are the payload
  *
@@ -14,6 +14,13 @@
  * cuStringBulilderDestroy(sb);
  * ```
  *
+ * The buffer grows geometrically, so building a string of @c n characters takes \f$ O(n) \f$ time overall. If you know the final size
+ * of the string in advance, ::cuStringBuilderReserve avoids any reallocation. When the string is complete, ::cuStringBuilderDetachString
+ * gives you the buffer without copying it.
+ *
+ * For very big strings which are only written in a file, ::cuStringBuilderNewRope creates a builder that never moves the characters
+ * already appended: the string is stored in several chunks, which ::cuStringBuilderWriteToFileDescriptor writes with a single \c writev .
+ *
  * @date Feb 27, 2017
  * @author koldar
  */
@@ -22,6 +29,9 @@
 #define STRINGBUILDER_H_
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
 #include "macros.h"
 #include "var_args.h"
 
@@ -31,7 +41,8 @@ typedef struct string_builder string_builder;
  * Initialize a new string builder
  *
  * @param[in] startString the string to initialize with the string builder. NULL if you don't want to intialize it with anything. Defaults to ""
- * @param[in] resizeFactor if the buffer is filled, we enlarge it by such quantity. Positive non zero. Defaults to 100
+ * @param[in] resizeFactor if the buffer is filled, we enlarge it by at least such quantity. The buffer size is at least doubled anyway.
+ * 	Positive non zero. Defaults to 100
  * @return the ::string_builder just initialized
  */
 string_builder* cuStringBulilderNew(CU_NULLABLE const char* startString, int resizeFactor);
@@ -42,6 +53,17 @@ CU_DECLARE_DEFAULT_VALUES(cuStringBulilderNew,
         100
 );
 
+/**
+ * Initialize a new string builder which stores the string in several chunks
+ *
+ * When a chunk is filled, a new one is allocated: the characters in the previous chunks are never moved.
+ * The chunks are joined in a single buffer only if you call ::cuStringBuilderGetString or ::cuStringBuilderDetachString.
+ *
+ * @param[in] chunkSize the size of each chunk. If a single append is bigger, its chunk is bigger as well. Positive non zero
+ * @return the ::string_builder just initialized
+ */
+string_builder* cuStringBuilderNewRope(size_t chunkSize);
+
 /**
  * Appends a string into the builder
  *
@@ -52,6 +74,15 @@ CU_DECLARE_DEFAULT_VALUES(cuStringBulilderNew,
  */
 void cuStringBuilderAppendString(CU_NOTNULL string_builder* sb, CU_NOTNULL const char* string);
 
+/**
+ * like ::cuStringBuilderAppendString but the length of the string is known
+ *
+ * @param[inout] sb the string builder to alter
+ * @param[in] string the characters to append to the ::string_builder. They don't need to be terminated by '\0'
+ * @param[in] length the number of characters in @c string to append
+ */
+void cuStringBuilderAppendStringWithLength(CU_NOTNULL string_builder* sb, CU_NOTNULL const char* string, size_t length);
+
 /**
  * like ::cuStringBuilderAppendString but it accepts a \c printf like var arguments
  *
@@ -61,6 +92,15 @@ void cuStringBuilderAppendString(CU_NOTNULL string_builder* sb, CU_NOTNULL const
  */
 void cuStringBuilderAppendTemplate(CU_NOTNULL string_builder* sb, CU_NOTNULL const char* template, ...);
 
+/**
+ * like ::cuStringBuilderAppendTemplate but it accepts a \c va_list
+ *
+ * @param[inout] sb the string builder to alter
+ * @param[in] template the string to append to the ::string_builder
+ * @param[in] vaList the variable argument to add inside the \c template. It is not consumed
+ */
+void cuStringBuilderAppendTemplateWithVaList(CU_NOTNULL string_builder* sb, CU_NOTNULL const char* template, va_list vaList);
+
 /**
  * Appends a character into the builder
  *
@@ -101,20 +141,75 @@ void cuStringBuilderAppendDouble(CU_NOTNULL string_builder* sb, double d);
  */
 void cuStringBuilderAppendLong(CU_NOTNULL string_builder* sb, long l);
 
+/**
+ * Ensure the builder can contain a string of the given length without allocating memory
+ *
+ * @param[inout] sb the string builder to alter
+ * @param[in] length the length of the string, excluding the '\0' terminator
+ */
+void cuStringBuilderReserve(CU_NOTNULL string_builder* sb, size_t length);
+
+/**
+ * @param[in] sb the string builder
+ * @return the length of the string built so far
+ */
+size_t cuStringBuilderGetLength(CU_NOTNULL const string_builder* sb);
+
 /**
  * Get the string built so far by this structure
  *
  * @note
  * The return value is passed **by reference**, so any changes to the return value will change the builder as well
  *
+ * \attention
+ * In a rope builder, this call joins all the chunks in a single buffer
+ *
  * @param[in] sb the string builder
  * @return the string built so far
  */
 char* cuStringBuilderGetString(CU_NOTNULL const string_builder* sb);
 
+/**
+ * Get the string built so far and removes it from the builder
+ *
+ * The buffer of the builder is given to the caller without copying it. After this call the builder is empty and it can be used again.
+ *
+ * @param[inout] sb the string builder
+ * @return the string built so far. You need to free it with ::CU_FREE
+ */
+char* cuStringBuilderDetachString(CU_NOTNULL string_builder* sb);
+
+/**
+ * Write the string built so far in a file descriptor
+ *
+ * The chunks of a rope builder are written with \c writev , without joining them
+ *
+ * @param[in] sb the string builder
+ * @param[in] fd the file descriptor where to write the string
+ * @return
+ *  @li true if the whole string has been written;
+ *  @li false otherwise. \c errno is set accordingly
+ */
+bool cuStringBuilderWriteToFileDescriptor(CU_NOTNULL const string_builder* sb, int fd);
+
+/**
+ * Write the string built so far in a file
+ *
+ * The chunks of a rope builder are written one after the other, without joining them
+ *
+ * @param[in] sb the string builder
+ * @param[in] f the file where to write the string
+ * @return
+ *  @li true if the whole string has been written;
+ *  @li false otherwise
+ */
+bool cuStringBuilderWriteToFile(CU_NOTNULL const string_builder* sb, CU_NOTNULL FILE* f);
+
 /**
  * Clear the content of the string buiilder
  *
+ * The memory of the builder is kept, so filling it again doesn't need to allocate it
+ *
  * @param[inout] sb the builder to clear
  */
 void cuStringBuilderClear(CU_NOTNULL string_builder* sb);
@@ -15,13 +15,30 @@
 #include "predsuccgraph.h"
 #include "node.h"
 #include "list.h"
+#include "macros.h"
+#include "multithreading.h"
+#include "csr_graph.h"
 
 /**
  * List all the possible implementation this module can offer of topological sorts
  */
 typedef enum {
 	///**static** algorithm described <a href="https://en.wikipedia.org/wiki/Topological_sorting#Depth-first_search">here</a>
-	TO_CORMEN
+	TO_CORMEN,
+	/**
+	 * Iterative algorithm described <a href="https://en.wikipedia.org/wiki/Topological_sorting#Kahn's_algorithm">here</a>.
+	 *
+	 * The graph is frozen (see ::cuPredSuccGraphFreeze), so all the state is local to the call: it can be used on graphs of any size and
+	 * by several threads at once. The freeze is performed at every call, unless a snapshot is passed to ::cuStaticTopologicalOrderDoWith
+	 */
+	TO_KAHN,
+	/**
+	 * Kahn algorithm processed level by level by several threads (see ::cuCSRGraphParallelComputeTopologicalLevels).
+	 *
+	 * The nodes are ordered level after level: use ::cuStaticTopologicalOrderComputeLevels to know where each level begins.
+	 * Like ::TO_KAHN, the graph is frozen at every call unless a snapshot is passed
+	 */
+	TO_PARALLEL_LEVELS
 } to_impl;
 
 /**
@@ -33,8 +50,55 @@ typedef enum {
  * @param[in] implementation a number representing the implementation you want to use to compute the static topological order
  * @param[in] graph the graph where we need to compute the static topological order on
  * @param[in] output a node list specifying the order obtained
+ * @param[inout] pool the workers used by ::TO_PARALLEL_LEVELS. Ignored by the other implementations. If NULL, everything is computed by the calling thread
+ * @param[in] snapshot a snapshot of \c graph created by ::cuPredSuccGraphFreeze after its last change, used by ::TO_KAHN and ::TO_PARALLEL_LEVELS.
+ * 	If NULL, they create a new snapshot and destroy it within the call
  */
-void cuStaticTopologicalOrderDoWith(to_impl implementation, PredSuccGraph* graph, NodeList* output);
+void cuStaticTopologicalOrderDoWith(to_impl implementation, PredSuccGraph* graph, NodeList* output, CU_NULLABLE cu_parallel_thread_pool* pool, CU_NULLABLE const csr_graph* snapshot);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(void, cuStaticTopologicalOrderDoWith, to_impl, PredSuccGraph*, NodeList*, cu_parallel_thread_pool*, const csr_graph*);
+#define cuStaticTopologicalOrderDoWith(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuStaticTopologicalOrderDoWith, 5, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuStaticTopologicalOrderDoWith,
+		,
+		,
+		,
+		NULL,
+		NULL
+);
+
+/**
+ * Compute the static topological order of a DAG, grouping the nodes in levels
+ *
+ * The first level contains the nodes without predecessors, while every other level contains the nodes whose predecessors are all in the previous levels.
+ * Hence no node of a level can reach another node of the same level (i.e., each level is an antichain): the nodes of a level can be processed
+ * concurrently as soon as the previous levels have been processed. Within a level, the nodes are sorted by id.
+ *
+ * This is a convenience wrapper of ::cuCSRGraphParallelComputeTopologicalLevels: unless @c snapshot is given, the graph is frozen at every call.
+ *
+ * @code
+ * list* levels = cuListNew();
+ * cuStaticTopologicalOrderComputeLevels(graph, levels, pool);
+ * CU_ITERATE_OVER_LIST(levels, cell, level, NodeList*) {
+ * 	//process level
+ * 	cuListDestroy(level, NULL);
+ * }
+ * cuListDestroy(levels, NULL);
+ * @endcode
+ *
+ * @param[in] graph the graph where we need to compute the levels. The function stops the program if it is not a DAG
+ * @param[inout] output a list where we append the levels, in order. Each level is a new ::NodeList the caller needs to destroy
+ * @param[inout] pool the workers computing the levels. If NULL, the levels are computed by the calling thread
+ * @param[in] snapshot a snapshot of @c graph created by ::cuPredSuccGraphFreeze after its last change. If NULL, a new snapshot is created and destroyed within the call
+ * @return the number of levels appended to @c output
+ */
+int cuStaticTopologicalOrderComputeLevels(CU_NOTNULL const PredSuccGraph* graph, CU_NOTNULL list* output, CU_NULLABLE cu_parallel_thread_pool* pool, CU_NULLABLE const csr_graph* snapshot);
+CU_DECLARE_FUNCTION_WITH_DEFAULTS(int, cuStaticTopologicalOrderComputeLevels, const PredSuccGraph*, list*, cu_parallel_thread_pool*, const csr_graph*);
+#define cuStaticTopologicalOrderComputeLevels(...) CU_CALL_FUNCTION_WITH_DEFAULTS(cuStaticTopologicalOrderComputeLevels, 4, __VA_ARGS__)
+CU_DECLARE_DEFAULT_VALUES(cuStaticTopologicalOrderComputeLevels,
+		,
+		,
+		NULL,
+		NULL
+);
 
 
 
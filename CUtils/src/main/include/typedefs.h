@@ -161,7 +161,7 @@ typedef unsigned long (*hashfunction_t)(CU_NULLABLE const void* obj, CU_NULLABLE
  * The operation will compile time fail if a macro compliant with ::CU_ENSURE_FUNCTION_POINTER is not provided
  */
 #define CU_AS_HASHFUNCTION(...) (CU_ENSURE_FUNCTION_POINTER( \
-		CU_HASHFUNCTION_ID, container_t, \
+		CU_HASHFUNCTION_ID, hashfunction_t, \
 		unsigned_long, \
 		__VA_ARGS__, \
 		CU_FT_CONST_PTR(void), CU_FT_CONST_PTR(var_args)))
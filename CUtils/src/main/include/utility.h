@@ -96,4 +96,16 @@ bool cuUtilsRangeInt(CU_NOTNULL const char* rangeStr, CU_NOTNULL int* restrict a
  */
 bool cuUtilsRangeInt2(CU_NOTNULL const char* rangeStr, CU_NOTNULL struct cu_int_range* range);
 
+/**
+ * like malloc, but it allocates an array and handles the allocation failure
+ *
+ * @post
+ *  @li if @c cells times @c cellSize overflows or malloc fails, an error is raised
+ *
+ * @param[in] cells number of cells of the array
+ * @param[in] cellSize size of each cell
+ * @return the array allocated (never NULL, even if @c cells is 0)
+ */
+void* cuUtilsMallocArray(size_t cells, size_t cellSize);
+
 #endif /* UTILITY_H_ */
@@ -5,17 +5,25 @@
 
 CuSuite* CuProjectSuite();
 CuSuite* CuHTSuite();
+CuSuite* CuFlatHTSuite();
 CuSuite* CuGraphSuite();
+CuSuite* CuCSRGraphSuite();
+CuSuite* CuGraphLoaderSuite();
+CuSuite* CuAllocatorSuite();
+CuSuite* CuPoolSuite();
+CuSuite* CuBenchmarkSuite();
 CuSuite* CuStackSuite();
 CuSuite* CuSimpleLoopComputerSuite();
 CuSuite* CuStringBuilderSuite();
 CuSuite* CuRegexSuite();
 CuSuite* CuCSVSuite();
+CuSuite* CuCSVReaderSuite();
 CuSuite* CuPlotProducerSuite();
 CuSuite* CuTopologicalOrderSuite();
 CuSuite* CuHeapSuite();
 CuSuite* CuBinarySearchTreeSuite();
 CuSuite* CuRedBlackTreeSuite();
+CuSuite* CuBTreeSuite();
 CuSuite* CuSCCSuite();
 CuSuite* CuLogSuite();
 CuSuite* CuMacroSuite();
@@ -27,6 +35,7 @@ CuSuite* CuSpaceMeasurementSuite();
 CuSuite* CuHashSetSuite();
 CuSuite* CuVarArgSuite();
 CuSuite* CuNaiveQueueSuite();
+CuSuite* CuRadixHeapSuite();
 CuSuite* CuOnlineStatisticPoolSuite();
 CuSuite* CuColorsSuite();
 CuSuite* CuMultiTrheadingSuite();
@@ -83,16 +92,24 @@ void RunAllTests(void)
 
 	addSuite(CuProjectSuite());
 	addSuite(CuHTSuite());
+	addSuite(CuFlatHTSuite());
 	addSuite(CuGraphSuite());
+	addSuite(CuCSRGraphSuite());
+	addSuite(CuGraphLoaderSuite());
+	addSuite(CuAllocatorSuite());
+	addSuite(CuPoolSuite());
+	addSuite(CuBenchmarkSuite());
 	addSuite(CuStackSuite());
 	addSuite(CuStringBuilderSuite());
 	CuSuite* regex = addSuite(CuRegexSuite());
 	addSuite(CuCSVSuite());
+	addSuite(CuCSVReaderSuite());
 	addSuite(CuPlotProducerSuite());
 	addSuite(CuTopologicalOrderSuite());
 	addSuite(CuHeapSuite());
 	addSuite(CuBinarySearchTreeSuite());
 	addSuite(CuRedBlackTreeSuite());
+	addSuite(CuBTreeSuite());
 	addSuite(CuSCCSuite());
 	addSuite(CuLogSuite());
 	CuSuite* macro = addSuite(CuMacroSuite());
@@ -105,6 +122,7 @@ void RunAllTests(void)
 	addSuite(CuHashSetSuite());
 	addSuite(CuVarArgSuite());
 	addSuite(CuNaiveQueueSuite());
+	addSuite(CuRadixHeapSuite());
 	CuSuite* osp = addSuite(CuOnlineStatisticPoolSuite());
 	CuSuite* colors = addSuite(CuColorsSuite());
 	addSuite(CuStackTraceSuite());
@@ -0,0 +1,309 @@
+/*
+ * allocatorTest.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: koldar
+ */
+
+#include "CuTest.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include "allocator.h"
+#include "list.h"
+#include "hashtable.h"
+#include "redBlackTree.h"
+#include "priority_queue.h"
+#include "naive_queue.h"
+#include "predsuccgraph.h"
+#include "multithreading.h"
+#include "timeMeasurement.h"
+#include "log.h"
+
+///test cuArenaAllocate
+void test_arena_01(CuTest* tc) {
+	cu_arena* arena = cuArenaNew(256);
+
+	char* a = cuArenaAllocate(arena, 3);
+	char* b = cuArenaAllocate(arena, 20);
+	assert(((uintptr_t)a) % 16 == 0);
+	assert(((uintptr_t)b) % 16 == 0);
+	assert(a != b);
+	memset(a, 'a', 3);
+	memset(b, 'b', 20);
+	assert(a[2] == 'a');
+	assert(cuArenaGetAllocatedBytes(arena) == 16 + 32);
+
+	//more than a chunk
+	for (int i=0; i<100; i++) {
+		int* p = cuArenaAllocate(arena, sizeof(int));
+		*p = i;
+	}
+	//bigger than a chunk
+	char* big = cuArenaAllocate(arena, 1000);
+	memset(big, 0, 1000);
+
+	cuArenaReset(arena);
+	assert(cuArenaGetAllocatedBytes(arena) == 0);
+	//the first chunk is reused
+	assert(cuArenaAllocate(arena, 3) == a);
+
+	cuArenaDestroy(arena, NULL);
+}
+
+///test cuSlabAllocate and cuSlabFree
+void test_slab_01(CuTest* tc) {
+	cu_slab* slab = cuSlabNew(24, 4);
+	void* blocks[10];
+
+	assert(cuSlabGetBlockSize(slab) == 24);
+	for (int i=0; i<10; i++) {
+		blocks[i] = cuSlabAllocate(slab);
+		memset(blocks[i], i, 24);
+	}
+	for (int i=0; i<10; i++) {
+		for (int j=i+1; j<10; j++) {
+			assert(blocks[i] != blocks[j]);
+		}
+	}
+
+	//freed blocks are reused
+	cuSlabFree(slab, blocks[3]);
+	cuSlabFree(slab, blocks[7]);
+	assert(cuSlabAllocate(slab) == blocks[7]);
+	assert(cuSlabAllocate(slab) == blocks[3]);
+
+	//after a reset the chunks are reused
+	cuSlabReset(slab);
+	assert(cuSlabAllocate(slab) == blocks[0]);
+
+	//allocations bigger than the block size are forwarded to malloc
+	cu_allocator* allocator = cuSlabGetAllocator(slab);
+	void* big = cuAllocatorAllocate(allocator, 100);
+	memset(big, 0, 100);
+	cuAllocatorDeallocate(allocator, big, 100);
+
+	cuSlabDestroy(slab, NULL);
+}
+
+static enum thread_loop_state useThreadCache(CU_NOTNULL const cu_thread* thread, const struct var_args* va) {
+	cu_allocator* allocator = cuAllocatorThreadCache();
+	void* blocks[100];
+
+	for (int round=0; round<100; round++) {
+		for (int i=0; i<100; i++) {
+			size_t size = 1 + (i * 7) % 300;
+			blocks[i] = cuAllocatorAllocate(allocator, size);
+			memset(blocks[i], i, size);
+		}
+		for (int i=0; i<100; i++) {
+			cuAllocatorDeallocate(allocator, blocks[i], 1 + (i * 7) % 300);
+		}
+	}
+	return TLS_STOP;
+}
+
+///test cuAllocatorThreadCache from several threads
+void test_threadCache_01(CuTest* tc) {
+	cu_allocator* allocator = cuAllocatorThreadCache();
+
+	void* a = cuAllocatorAllocate(allocator, 10);
+	cuAllocatorDeallocate(allocator, a, 10);
+	//the block is cached and reused by blocks of the same size class
+	assert(cuAllocatorAllocate(allocator, 16) == a);
+	cuAllocatorDeallocate(allocator, a, 16);
+
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+	for (int i=0; i<8; i++) {
+		cu_future* f = cuParallelThreadPoolSubmit(pool, useThreadCache, NULL);
+		cuFutureDestroy(f, NULL);
+	}
+	cuParallelThreadPoolDestroy(pool, NULL);
+
+	cuAllocatorThreadCacheFlush();
+}
+
+///test the containers on an arena
+void test_allocatorAwareContainers_01(CuTest* tc) {
+	cu_arena* arena = cuArenaNew();
+	cu_allocator* allocator = cuArenaGetAllocator(arena);
+
+	list* l = cuListNew(cuPayloadFunctionsIntValue(), allocator);
+	HT* ht = cuHTNew(cuPayloadFunctionsIntValue(), allocator);
+	rb_tree* tree = cuRedBlackTreeNew(cuPayloadFunctionsIntValue(), allocator);
+	priority_queue* q = cuPriorityQueueNew(cuPayloadFunctionsIntValue(), 4, allocator);
+
+	for (int i=0; i<1000; i++) {
+		cuListAddTail(l, CU_CAST_INT2PTR(i));
+		cuHTAddItem(ht, i, CU_CAST_INT2PTR(i));
+		cuRedBlackTreeAddItem(tree, CU_CAST_INT2PTR(i));
+		cuPriorityQueueAddItem(q, CU_CAST_INT2PTR(i), 1000 - i);
+	}
+	assert(cuListGetSize(l) == 1000);
+	assert(cuHTGetSize(ht) == 1000);
+	assert(cuRedBlackTreeGetSize(tree) == 1000);
+	assert(cuRedBlackTreeContainsItem(tree, CU_CAST_INT2PTR(500)));
+	assert(CU_CAST_PTR2INT(cuPriorityQueuePopItem(q, void*)) == 999);
+
+	//cells go back to the arena only when it is reset
+	cuListPopFrom(l);
+	cuHTRemoveItem(ht, 0);
+	cuRedBlackTreeRemoveItem(tree, CU_CAST_INT2PTR(0));
+	assert(cuHTGetSize(ht) == 999);
+
+	//a clone uses the same allocator
+	list* clone = cuListClone(l);
+	assert(cuListGetSize(clone) == 999);
+	//moving cells between lists with different allocators copies them
+	list* other = cuListNew(cuPayloadFunctionsIntValue());
+	cuListMoveContent(other, clone);
+	assert(cuListGetSize(other) == 999);
+	assert(cuListIsEmpty(clone));
+	cuListDestroy(other, NULL);
+
+	cuListDestroy(clone, NULL);
+	cuListDestroy(l, NULL);
+	cuHTDestroy(ht, NULL);
+	cuRedBlackTreeDestroy(tree, NULL);
+	cuPriorityQueueDestroy(q, NULL);
+	cuArenaDestroy(arena, NULL);
+}
+
+static int evaluateInteger(const void* x, const struct var_args* va) {
+	return CU_CAST_PTR2INT(x);
+}
+
+///test the containers on a slab
+void test_allocatorAwareContainers_02(CuTest* tc) {
+	cu_slab* slab = cuSlabNew(64);
+	cu_allocator* allocator = cuSlabGetAllocator(slab);
+
+	naive_queue* nq = cuNaiveQueueNew(cuPayloadFunctionsIntValue(), CU_AS_EVALUATOR(evaluateInteger), NULL, allocator);
+	for (int i=0; i<100; i++) {
+		cuNaiveQueueAddItem(nq, CU_CAST_INT2PTR(100 - i));
+	}
+	assert(cuNaiveQueuePopItem(nq, long) == 1);
+	cuNaiveQueueClear(nq);
+	assert(cuNaiveQueueGetSize(nq) == 0);
+	cuNaiveQueueDestroy(nq, NULL);
+
+	PredSuccGraph* g = cuPredSuccGraphNew(true, cuPayloadFunctionsIntValue(), cuPayloadFunctionsIntValue(), allocator);
+	for (int i=0; i<50; i++) {
+		cuPredSuccGraphAddNodeInGraphById(g, i, NULL);
+	}
+	for (int i=0; i<49; i++) {
+		cuPredSuccGraphAddEdge(g, i, i+1, NULL);
+	}
+	cuPredSuccGraphRemoveEdge(g, 10, 11, false);
+	assert(!cuPredSuccGraphContainsEdgeInGraph(g, 10, 11));
+	assert(cuPredSuccGraphContainsEdgeInGraph(g, 11, 12));
+	PredSuccGraph* clone = cuPredSuccGraphClone(g);
+	assert(cuPredSuccGraphContainsEdgeInGraph(clone, 11, 12));
+	cuPredSuccGraphDestroyWithElements(clone, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+
+	cuSlabDestroy(slab, NULL);
+}
+
+static int destroyedPayloads = 0;
+
+static void countDestroyedPayload(CU_NULLABLE const void* payload, CU_NULLABLE const struct var_args* context) {
+	destroyedPayloads++;
+}
+
+///destroying the containers of an arena still destroys every payload
+void test_allocatorAwareContainers_03(CuTest* tc) {
+	cu_arena* arena = cuArenaNew();
+	cu_allocator* allocator = cuArenaGetAllocator(arena);
+	payload_functions functions = cuPayloadFunctionsIntValue();
+	functions.destroy = countDestroyedPayload;
+
+	destroyedPayloads = 0;
+	list* l = cuListNew(functions, allocator);
+	for (int i=0; i<100; i++) {
+		cuListAddTail(l, CU_CAST_INT2PTR(i));
+	}
+	cuListClearWithElements(l);
+	assert(destroyedPayloads == 100);
+	assert(cuListIsEmpty(l));
+	for (int i=0; i<50; i++) {
+		cuListAddHead(l, CU_CAST_INT2PTR(i));
+	}
+	cuListDestroyWithElement(l, NULL);
+	assert(destroyedPayloads == 150);
+
+	destroyedPayloads = 0;
+	naive_queue* nq = cuNaiveQueueNew(functions, CU_AS_EVALUATOR(evaluateInteger), NULL, allocator);
+	for (int i=0; i<100; i++) {
+		cuNaiveQueueAddItem(nq, CU_CAST_INT2PTR(100 - i));
+	}
+	cuNaiveQueueClearWithElements(nq);
+	assert(destroyedPayloads == 100);
+	assert(cuNaiveQueueGetSize(nq) == 0);
+	for (int i=0; i<10; i++) {
+		cuNaiveQueueAddItem(nq, CU_CAST_INT2PTR(i));
+	}
+	cuNaiveQueueDestroyWithElements(nq, NULL);
+	assert(destroyedPayloads == 110);
+
+	//nothing to destroy: the cells are not visited at all
+	naive_queue* empty = cuNaiveQueueNew(cuPayloadFunctionsIntValue(), CU_AS_EVALUATOR(evaluateInteger), NULL, allocator);
+	cuNaiveQueueAddItem(empty, CU_CAST_INT2PTR(5));
+	cuNaiveQueueDestroyWithElements(empty, NULL);
+
+	cuArenaDestroy(arena, NULL);
+}
+
+static long buildAndDestroyGraph(CU_NULLABLE cu_allocator* allocator, int vertices, int edgesPerVertex) {
+	PredSuccGraph* g = cuPredSuccGraphNew(false, cuPayloadFunctionsIntValue(), cuPayloadFunctionsIntValue(), allocator);
+	for (int i=0; i<vertices; i++) {
+		cuPredSuccGraphAddNodeInGraphById(g, i, NULL);
+	}
+	for (int i=0; i<vertices; i++) {
+		for (int j=1; j<=edgesPerVertex; j++) {
+			cuPredSuccGraphAddEdge(g, i, (i + j * 7) % vertices, NULL);
+		}
+	}
+	long result = cuPredSuccGraphGetEdgesNumber(g);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+	return result;
+}
+
+///compare building and tearing down a graph with malloc and with an arena
+void test_benchmarkGraphAllocation(CuTest* tc) {
+	const int vertices = 20000;
+	const int edgesPerVertex = 10;
+	long edges = 0;
+
+	CU_PROFILE_TIME_CODE(withMalloc, TM_MICRO) {
+		edges += buildAndDestroyGraph(NULL, vertices, edgesPerVertex);
+	}
+	cu_arena* arena = cuArenaNew(1024*1024);
+	CU_PROFILE_TIME_CODE(withArena, TM_MICRO) {
+		edges -= buildAndDestroyGraph(cuArenaGetAllocator(arena), vertices, edgesPerVertex);
+		cuArenaReset(arena);
+	}
+	cuArenaDestroy(arena, NULL);
+	CU_PROFILE_TIME_CODE(withThreadCache, TM_MICRO) {
+		buildAndDestroyGraph(cuAllocatorThreadCache(), vertices, edgesPerVertex);
+	}
+	cuAllocatorThreadCacheFlush();
+
+	assert(edges == 0);
+	critical("graph with %d vertices and %d edges (us) | malloc: %ld arena: %ld thread cache: %ld", vertices, vertices * edgesPerVertex, withMalloc, withArena, withThreadCache);
+}
+
+CuSuite* CuAllocatorSuite() {
+	CuSuite* suite = CuSuiteNew();
+
+	SUITE_ADD_TEST(suite, test_arena_01);
+	SUITE_ADD_TEST(suite, test_slab_01);
+	SUITE_ADD_TEST(suite, test_threadCache_01);
+	SUITE_ADD_TEST(suite, test_allocatorAwareContainers_01);
+	SUITE_ADD_TEST(suite, test_allocatorAwareContainers_02);
+	SUITE_ADD_TEST(suite, test_allocatorAwareContainers_03);
+
+	SUITE_ADD_TEST(suite, test_benchmarkGraphAllocation);
+
+	return suite;
+}
@@ -0,0 +1,183 @@
+/*
+ * bTreeTest.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: koldar
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include "CuTest.h"
+#include "b_tree.h"
+#include "log.h"
+
+static int compareInts(const void* a, const void* b) {
+	return *(const int*)a - *(const int*)b;
+}
+
+/**
+ * check the tree contains exactly the given items, sorted
+ */
+static void assertSameItems(const b_tree* tree, const int* sorted, int n) {
+	int i = 0;
+	assert(cuBTreeGetSize(tree) == n);
+	CU_ITERATE_OVER_BTREE(tree, item, void*) {
+		assert(i < n);
+		assert(CU_CAST_PTR2INT(item) == sorted[i]);
+		i++;
+	}
+	assert(i == n);
+	if (n > 0) {
+		assert(CU_CAST_PTR2INT(cuBTreeGetMinimum(tree)) == sorted[0]);
+		assert(CU_CAST_PTR2INT(cuBTreeGetMaximum(tree)) == sorted[n - 1]);
+	}
+}
+
+void test_cuBTree_01(CuTest* tc) {
+	b_tree* tree = cuBTreeNew(cuPayloadFunctionsIntValue());
+
+	assert(cuBTreeIsEmpty(tree));
+	assert(cuBTreeGetMinimum(tree) == NULL);
+	assert(cuBTreeGetMaximum(tree) == NULL);
+	assert(!cuBTreeContainsItem(tree, CU_CAST_INT2PTR(5)));
+	CU_ITERATE_OVER_BTREE(tree, item, void*) {
+		assert(false);
+	}
+
+	cuBTreeAddItem(tree, CU_CAST_INT2PTR(5));
+	cuBTreeAddItem(tree, CU_CAST_INT2PTR(3));
+	cuBTreeAddItem(tree, CU_CAST_INT2PTR(8));
+	assert(cuBTreeGetSize(tree) == 3);
+	assert(cuBTreeContainsItem(tree, CU_CAST_INT2PTR(5)));
+	assert(!cuBTreeContainsItem(tree, CU_CAST_INT2PTR(4)));
+	assert(CU_CAST_PTR2INT(cuBTreeGetMinimum(tree)) == 3);
+	assert(CU_CAST_PTR2INT(cuBTreeGetMaximum(tree)) == 8);
+
+	assert(cuBTreeRemoveItem(tree, CU_CAST_INT2PTR(5)));
+	assert(!cuBTreeRemoveItem(tree, CU_CAST_INT2PTR(5)));
+	assert(cuBTreeGetSize(tree) == 2);
+
+	cuBTreeDestroy(tree, NULL);
+}
+
+///random additions and removals, with duplicates, compared with a sorted array
+void test_cuBTree_02(CuTest* tc) {
+	b_tree* tree = cuBTreeNew(cuPayloadFunctionsIntValue());
+	const int n = 50000;
+	int* values = malloc(sizeof(int) * n);
+	unsigned int seed = 3;
+
+	for (int i=0; i<n; i++) {
+		values[i] = rand_r(&seed) % (n / 4);
+		cuBTreeAddItem(tree, CU_CAST_INT2PTR(values[i]));
+	}
+	qsort(values, n, sizeof(int), compareInts);
+	assertSameItems(tree, values, n);
+
+	//remove every other item: duplicates are removed one at a time
+	int remaining = 0;
+	for (int i=0; i<n; i++) {
+		if ((i % 2) == 0) {
+			assert(cuBTreeRemoveItem(tree, CU_CAST_INT2PTR(values[i])));
+		} else {
+			values[remaining++] = values[i];
+		}
+	}
+	assertSameItems(tree, values, remaining);
+	for (int i=0; i<remaining; i++) {
+		assert(cuBTreeContainsItem(tree, CU_CAST_INT2PTR(values[i])));
+	}
+
+	//remove everything in random order
+	for (int i=remaining-1; i>0; i--) {
+		int j = rand_r(&seed) % (i + 1);
+		int tmp = values[i];
+		values[i] = values[j];
+		values[j] = tmp;
+	}
+	for (int i=0; i<remaining; i++) {
+		assert(cuBTreeRemoveItem(tree, CU_CAST_INT2PTR(values[i])));
+	}
+	assert(cuBTreeIsEmpty(tree));
+	assert(!cuBTreeRemoveItem(tree, CU_CAST_INT2PTR(values[0])));
+
+	//the tree can be used again
+	cuBTreeAddItem(tree, CU_CAST_INT2PTR(1));
+	assert(cuBTreeContainsItem(tree, CU_CAST_INT2PTR(1)));
+
+	CU_FREE(values);
+	cuBTreeDestroy(tree, NULL);
+}
+
+///bulk load and range scans
+void test_cuBTree_03(CuTest* tc) {
+	b_tree* tree = cuBTreeNew(cuPayloadFunctionsIntValue());
+	const int n = 100000;
+	void** items = malloc(sizeof(void*) * n);
+	int* values = malloc(sizeof(int) * n);
+
+	for (int i=0; i<n; i++) {
+		//only even numbers
+		values[i] = 2 * i;
+		items[i] = CU_CAST_INT2PTR(values[i]);
+	}
+	cuBTreeBulkLoad(tree, items, n);
+	assertSameItems(tree, values, n);
+	assert(cuBTreeContainsItem(tree, CU_CAST_INT2PTR(1000)));
+	assert(!cuBTreeContainsItem(tree, CU_CAST_INT2PTR(1001)));
+
+	int expected = 1000;
+	CU_ITERATE_OVER_BTREE_RANGE(tree, CU_CAST_INT2PTR(999), CU_CAST_INT2PTR(2000), item, void*) {
+		assert(CU_CAST_PTR2INT(item) == expected);
+		expected += 2;
+	}
+	assert(expected == 2000);
+
+	//ranges outside the tree
+	CU_ITERATE_OVER_BTREE_RANGE(tree, CU_CAST_INT2PTR(2 * n), CU_CAST_INT2PTR(3 * n), item, void*) {
+		assert(false);
+	}
+	CU_ITERATE_OVER_BTREE_RANGE(tree, CU_CAST_INT2PTR(-10), CU_CAST_INT2PTR(0), item, void*) {
+		assert(false);
+	}
+
+	//the bulk loaded tree can be updated like any other tree
+	for (int i=0; i<n; i+=3) {
+		assert(cuBTreeRemoveItem(tree, CU_CAST_INT2PTR(values[i])));
+	}
+	cuBTreeAddItem(tree, CU_CAST_INT2PTR(1001));
+	assert(cuBTreeContainsItem(tree, CU_CAST_INT2PTR(1001)));
+	assert(!cuBTreeContainsItem(tree, CU_CAST_INT2PTR(0)));
+	assert(cuBTreeGetSize(tree) == n - (n + 2) / 3 + 1);
+
+	CU_FREE(items);
+	CU_FREE(values);
+	cuBTreeDestroy(tree, NULL);
+}
+
+///nodes allocated with an arena
+void test_cuBTree_04(CuTest* tc) {
+	cu_arena* arena = cuArenaNew();
+	b_tree* tree = cuBTreeNew(cuPayloadFunctionsIntValue(), cuArenaGetAllocator(arena));
+
+	for (int i=10000; i>0; i--) {
+		cuBTreeAddItem(tree, CU_CAST_INT2PTR(i));
+	}
+	assert(cuBTreeGetSize(tree) == 10000);
+	assert(CU_CAST_PTR2INT(cuBTreeGetMinimum(tree)) == 1);
+	assert(CU_CAST_PTR2INT(cuBTreeGetMaximum(tree)) == 10000);
+
+	cuBTreeDestroy(tree, NULL);
+	cuArenaDestroy(arena, NULL);
+}
+
+CuSuite* CuBTreeSuite() {
+	CuSuite* suite = CuSuiteNew();
+
+	SUITE_ADD_TEST(suite, test_cuBTree_01);
+	SUITE_ADD_TEST(suite, test_cuBTree_02);
+	SUITE_ADD_TEST(suite, test_cuBTree_03);
+	SUITE_ADD_TEST(suite, test_cuBTree_04);
+
+	return suite;
+}
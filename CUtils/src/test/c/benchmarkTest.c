@@ -0,0 +1,125 @@
+/*
+ * benchmarkTest.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: koldar
+ */
+
+#include "CuTest.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "benchmark.h"
+#include "macros.h"
+
+static int setups = 0;
+static int calls = 0;
+static int teardowns = 0;
+
+static void* countSetup(int size, const struct var_args* context) {
+	setups++;
+	return &calls;
+}
+
+static void countCall(void* state, int size, const struct var_args* context) {
+	if (state != NULL) {
+		(*(int*)state)++;
+	}
+	volatile long sum = 0;
+	for (int i=0; i<size; i++) {
+		sum += i;
+	}
+}
+
+static void countTeardown(void* state, const struct var_args* context) {
+	teardowns++;
+}
+
+///test the runs and the statistics computed
+void test_benchmark_01(CuTest* tc) {
+	cu_benchmark* b = cuBenchmarkNew("test", 2, 20);
+
+	const cu_benchmark_result* r = cuBenchmarkRun(b, "sum", 1000, countSetup, countCall, countTeardown, NULL);
+	//warm-up runs are executed as well
+	assert(setups == 22);
+	assert(calls == 22);
+	assert(teardowns == 22);
+
+	assert(strcmp(r->caseName, "sum") == 0);
+	assert(r->size == 1000);
+	assert(r->runs == 20);
+	assert(r->min <= r->p50);
+	assert(r->p50 <= r->p90);
+	assert(r->p90 <= r->p99);
+	assert(r->p99 <= r->max);
+	assert(r->min <= r->average && r->average <= r->max);
+	assert(r->standardDeviation >= 0);
+
+	//setup and teardown are optional
+	cuBenchmarkRun(b, "sum", 10000, NULL, countCall, NULL, NULL);
+	assert(calls == 22);
+	assert(cuBenchmarkGetResultsNumber(b) == 2);
+	assert(cuBenchmarkGetResult(b, 0) == r);
+	assert(cuBenchmarkGetResult(b, 1)->size == 10000);
+
+	cuBenchmarkDestroy(b, NULL);
+}
+
+///test the reports
+void test_benchmark_02(CuTest* tc) {
+	cu_benchmark* b = cuBenchmarkNew("report");
+	char line[200];
+
+	for (int size=10; size<=1000; size *= 10) {
+		cuBenchmarkRun(b, "first", size, countSetup, countCall, countTeardown, NULL);
+		cuBenchmarkRun(b, "second", size, countSetup, countCall, countTeardown, NULL);
+	}
+	cuBenchmarkPrint(b, stdout);
+
+	cuBenchmarkSaveCSV(b, "/tmp/cutilsBenchmarkTest.csv");
+	FILE* f = fopen("/tmp/cutilsBenchmarkTest.csv", "r");
+	assert(f != NULL);
+	int lines = 0;
+	while (fgets(line, 200, f) != NULL) {
+		lines++;
+		if (lines == 2) {
+			assert(strstr(line, "benchmark,case,size,runs,average") == line);
+		}
+		if (lines == 3) {
+			assert(strstr(line, "report,first,10,10,") == line);
+		}
+	}
+	fclose(f);
+	remove("/tmp/cutilsBenchmarkTest.csv");
+	//separator line, header and 6 results
+	assert(lines == 8);
+
+	cuBenchmarkPlot(b, __func__);
+
+	//the table reports the tail latency as well
+	f = tmpfile();
+	assert(f != NULL);
+	cuBenchmarkPrint(b, f);
+	rewind(f);
+	assert(fgets(line, 200, f) != NULL);
+	assert(fgets(line, 200, f) != NULL);
+	assert(strstr(line, " p99 ") != NULL);
+	fclose(f);
+
+	cuBenchmarkDestroy(b, NULL);
+
+	//nothing to plot
+	cu_benchmark* empty = cuBenchmarkNew("empty");
+	cuBenchmarkPrint(empty, stdout);
+	cuBenchmarkPlot(empty, "test_benchmark_02_empty");
+	cuBenchmarkDestroy(empty, NULL);
+}
+
+CuSuite* CuBenchmarkSuite() {
+	CuSuite* suite = CuSuiteNew();
+
+	SUITE_ADD_TEST(suite, test_benchmark_01);
+	SUITE_ADD_TEST(suite, test_benchmark_02);
+
+	return suite;
+}
@@ -0,0 +1,588 @@
+/*
+ * csrGraphTest.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: koldar
+ */
+
+#include "CuTest.h"
+#include <stdlib.h>
+#include <assert.h>
+#include "predsuccgraph.h"
+#include "csr_graph.h"
+#include "scc.h"
+#include "timeMeasurement.h"
+#include "random_utils.h"
+#include "log.h"
+#include "multithreading.h"
+#include <stdio.h>
+#include <unistd.h>
+#include <limits.h>
+
+/**
+ * Creates the graph:
+ *
+ * 10 -> 20 -> 30 -> 10 (a cycle)
+ * 30 -> 40 -> 50
+ * 60 (isolated)
+ */
+static PredSuccGraph* createGraph() {
+	PredSuccGraph* g = cuPredSuccGraphNew(false, cuPayloadFunctionsIntValue(), cuPayloadFunctionsIntValue());
+
+	for (int i=1; i<=6; i++) {
+		cuPredSuccGraphAddNodeInGraphById(g, i*10, CU_CAST_INT2PTR(i));
+	}
+	cuPredSuccGraphAddEdge(g, 10, 20, CU_CAST_INT2PTR(1));
+	cuPredSuccGraphAddEdge(g, 20, 30, CU_CAST_INT2PTR(2));
+	cuPredSuccGraphAddEdge(g, 30, 10, CU_CAST_INT2PTR(3));
+	cuPredSuccGraphAddEdge(g, 30, 40, CU_CAST_INT2PTR(4));
+	cuPredSuccGraphAddEdge(g, 40, 50, CU_CAST_INT2PTR(5));
+
+	return g;
+}
+
+static PredSuccGraph* createRandomGraph(int vertices, int edges) {
+	PredSuccGraph* g = cuPredSuccGraphNew();
+
+	for (int i=0; i<vertices; i++) {
+		cuPredSuccGraphAddNodeInGraphById(g, i, NULL);
+	}
+	for (int i=0; i<edges; i++) {
+		int source = rand() % vertices;
+		int sink = rand() % vertices;
+		if (!cuPredSuccGraphContainsEdgeInGraph(g, source, sink)) {
+			cuPredSuccGraphAddEdge(g, source, sink, NULL);
+		}
+	}
+
+	return g;
+}
+
+static bool noEdgeFrom30(const Edge* e) {
+	return e->source->id != 30;
+}
+
+static bool noEdgeWithSumMultipleOf3(const Edge* e) {
+	return ((e->source->id + e->sink->id) % 3) != 0;
+}
+
+/**
+ * A ::cu_bfs_level_visitor counting the vertices of each level and stopping after the level in the second item of the context
+ */
+static bool countLevelVertices(const csr_graph* g, int level, const unsigned int* frontier, unsigned int frontierSize, const struct var_args* context) {
+	int* levelSizes = cuVarArgsGetItem(context, 0, int*);
+	int lastLevel = cuVarArgsGetItem(context, 1, int);
+	levelSizes[level] = frontierSize;
+	return level < lastLevel;
+}
+
+///test the layout of the snapshot
+void testCSRGraph01(CuTest* tc) {
+	PredSuccGraph* g = createGraph();
+	csr_graph* csr = cuPredSuccGraphFreeze(g);
+
+	assert(csr->size == 6);
+	assert(csr->edgesNumber == 5);
+	for (int i=0; i<6; i++) {
+		assert(csr->ids[i] == (i+1)*10);
+		assert(cuCSRGraphGetIndexOfVertex(csr, (i+1)*10) == i);
+		assert(CU_CAST_PTR2INT(csr->vertexPayloads[i]) == i + 1);
+	}
+	assert(cuCSRGraphGetIndexOfVertex(csr, 70) == -1);
+
+	assert(cuCSRGraphGetOutDegree(csr, 2) == 2);
+	assert(cuCSRGraphGetInDegree(csr, 0) == 1);
+	assert(cuCSRGraphGetOutDegree(csr, 5) == 0);
+	assert(cuCSRGraphGetInDegree(csr, 5) == 0);
+
+	int sum = 0;
+	CU_ITERATE_OVER_CSR_SUCCESSORS(csr, 2, sink, e) {
+		sum += sink;
+		assert(csr->edges[e]->sink->id == csr->ids[sink]);
+		assert(csr->edgePayloads[e] == csr->edges[e]->payload);
+	}
+	//30 goes to 10 and 40
+	assert(sum == 0 + 3);
+
+	sum = 0;
+	CU_ITERATE_OVER_CSR_PREDECESSORS(csr, 0, source, e) {
+		sum += source;
+		assert(CU_CAST_PTR2INT(csr->edgePayloads[e]) == 3);
+	}
+	assert(sum == 2);
+
+	cuCSRGraphDestroy(csr, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+///test BFS and DFS
+void testCSRGraph02(CuTest* tc) {
+	PredSuccGraph* g = createGraph();
+	csr_graph* csr = cuPredSuccGraphFreeze(g);
+	unsigned int order[6];
+	int distances[6];
+
+	assert(cuCSRGraphBFS(csr, 0, NULL, order, distances) == 5);
+	assert(order[0] == 0);
+	assert(order[4] == 4);
+	assert(distances[0] == 0);
+	assert(distances[2] == 2);
+	assert(distances[4] == 4);
+	assert(distances[5] == -1);
+
+	assert(cuCSRGraphBFS(csr, 0, noEdgeFrom30, order, NULL) == 3);
+
+	assert(cuCSRGraphDFS(csr, 1, NULL, order) == 5);
+	assert(order[0] == 1);
+	assert(order[1] == 2);
+	assert(order[2] == 0);
+	assert(order[3] == 3);
+	assert(order[4] == 4);
+
+	assert(cuCSRGraphDFS(csr, 5, NULL, order) == 1);
+
+	cuCSRGraphDestroy(csr, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+///test reachability
+void testCSRGraph03(CuTest* tc) {
+	PredSuccGraph* g = createGraph();
+	csr_graph* csr = cuPredSuccGraphFreeze(g);
+
+	assert(cuCSRGraphIsVertexReachableFromVertex(csr, 10, 50, NULL));
+	assert(cuCSRGraphIsVertexReachableFromVertex(csr, 40, 50, NULL));
+	assert(!cuCSRGraphIsVertexReachableFromVertex(csr, 50, 10, NULL));
+	assert(!cuCSRGraphIsVertexReachableFromVertex(csr, 10, 60, NULL));
+	assert(!cuCSRGraphIsVertexReachableFromVertex(csr, 10, 50, noEdgeFrom30));
+
+	cuCSRGraphDestroy(csr, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+///test SCC
+void testCSRGraph04(CuTest* tc) {
+	PredSuccGraph* g = createGraph();
+	csr_graph* csr = cuPredSuccGraphFreeze(g);
+	unsigned int components[6];
+
+	assert(cuCSRGraphComputeSCC(csr, components) == 4);
+	assert(components[0] == components[1]);
+	assert(components[1] == components[2]);
+	assert(components[3] != components[0]);
+	assert(components[4] != components[3]);
+	//reverse topological order
+	assert(components[0] > components[3]);
+	assert(components[3] > components[4]);
+
+	cuCSRGraphDestroy(csr, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+///test topological order
+void testCSRGraph05(CuTest* tc) {
+	PredSuccGraph* g = createGraph();
+	unsigned int order[6];
+
+	csr_graph* csr = cuPredSuccGraphFreeze(g);
+	assert(!cuCSRGraphComputeTopologicalOrder(csr, order));
+	cuCSRGraphDestroy(csr, NULL);
+
+	cuPredSuccGraphRemoveEdge(g, 30, 10, false);
+	csr = cuPredSuccGraphFreeze(g);
+	assert(cuCSRGraphComputeTopologicalOrder(csr, order));
+	unsigned int position[6];
+	for (int i=0; i<6; i++) {
+		position[order[i]] = i;
+	}
+	for (unsigned int i=0; i<csr->size; i++) {
+		CU_ITERATE_OVER_CSR_SUCCESSORS(csr, i, sink, e) {
+			assert(position[i] < position[sink]);
+		}
+	}
+	cuCSRGraphDestroy(csr, NULL);
+
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+///test empty graphs
+void testCSRGraph06(CuTest* tc) {
+	PredSuccGraph* g = cuPredSuccGraphNew();
+	csr_graph* csr = cuPredSuccGraphFreeze(g);
+	unsigned int order[1];
+
+	assert(csr->size == 0);
+	assert(csr->edgesNumber == 0);
+	assert(cuCSRGraphComputeSCC(csr, order) == 0);
+	assert(cuCSRGraphComputeTopologicalOrder(csr, order));
+
+	cuCSRGraphDestroy(csr, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+///compare SCC and reachability on the snapshot against the ones of the original graph
+void testCSRGraph07(CuTest* tc) {
+	srand(0);
+	const int vertices = 900;
+	PredSuccGraph* g = createRandomGraph(vertices, 800);
+	csr_graph* csr = cuPredSuccGraphFreeze(g);
+	unsigned int* components = malloc(sizeof(unsigned int) * vertices);
+
+	scc_graph* sccGraph = cuStronglyConnectedComponentsGraphNew(g, edge_traverser_alwaysAccept, false, NULL);
+	unsigned int sccs = cuCSRGraphComputeSCC(csr, components);
+	assert(sccs == cuPredSuccGraphGetVertexNumber(cuStronglyConnectedComponentsGraphAsPredSuccGraph(sccGraph)));
+	for (int i=0; i<vertices; i++) {
+		NodeId expected = cuStronglyConnectedComponentsGetComponentOfNode(sccGraph, i)->id;
+		for (int j=i+1; j<vertices; j+=37) {
+			bool sameScc = cuStronglyConnectedComponentsGetComponentOfNode(sccGraph, j)->id == expected;
+			assert(sameScc == (components[i] == components[j]));
+		}
+	}
+	cuStronglyConnectedComponentsGraphDestroy(sccGraph, NULL);
+
+	const int queries = 200;
+	int reachable = 0;
+	CU_PROFILE_TIME_CODE(original, TM_MICRO) {
+		for (int i=0; i<queries; i++) {
+			reachable += cuPredSuccGraphIsVertexReachableFromVertex(g, i, vertices - 1 - i, cuAlwaysTraverse);
+		}
+	}
+	CU_PROFILE_TIME_CODE(snapshot, TM_MICRO) {
+		for (int i=0; i<queries; i++) {
+			reachable -= cuCSRGraphIsVertexReachableFromVertex(csr, i, vertices - 1 - i, NULL);
+		}
+	}
+	assert(reachable == 0);
+	critical("%d reachability queries (us) | PredSuccGraph: %ld csr_graph: %ld", queries, original, snapshot);
+
+	free(components);
+	cuCSRGraphDestroy(csr, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+///a saved snapshot can be mapped and used like the original one
+void testCSRGraph08(CuTest* tc) {
+	PredSuccGraph* g = createGraph();
+	csr_graph* csr = cuPredSuccGraphFreeze(g);
+	cuCSRGraphSave(csr, "testCSRGraph08.bin");
+
+	csr_graph* mapped = cuCSRGraphMap("testCSRGraph08.bin");
+	assert(mapped != NULL);
+	assert(mapped->size == csr->size);
+	assert(mapped->edgesNumber == csr->edgesNumber);
+	assert(mapped->edges == NULL);
+	for (unsigned int i=0; i<csr->size; i++) {
+		assert(mapped->ids[i] == csr->ids[i]);
+		assert(mapped->vertexPayloads[i] == csr->vertexPayloads[i]);
+		assert(cuCSRGraphGetIndexOfVertex(mapped, csr->ids[i]) == i);
+		assert(cuCSRGraphGetOutDegree(mapped, i) == cuCSRGraphGetOutDegree(csr, i));
+		assert(cuCSRGraphGetInDegree(mapped, i) == cuCSRGraphGetInDegree(csr, i));
+	}
+	assert(cuCSRGraphGetIndexOfVertex(mapped, 5) == -1);
+	assert(cuCSRGraphGetIndexOfVertex(mapped, 70) == -1);
+	for (unsigned int e=0; e<csr->edgesNumber; e++) {
+		assert(mapped->successors[e] == csr->successors[e]);
+		assert(mapped->edgePayloads[e] == csr->edgePayloads[e]);
+		assert(mapped->predecessors[e] == csr->predecessors[e]);
+		assert(mapped->predecessorEdges[e] == csr->predecessorEdges[e]);
+	}
+
+	//algorithms work on the mapping, traversers included
+	unsigned int order[6];
+	unsigned int components[6];
+	assert(cuCSRGraphBFS(mapped, 0, NULL, order, NULL) == 5);
+	assert(cuCSRGraphBFS(mapped, 0, noEdgeFrom30, order, NULL) == 3);
+	assert(cuCSRGraphComputeSCC(mapped, components) == 4);
+	assert(!cuCSRGraphIsVertexReachableFromVertex(mapped, 10, 50, noEdgeFrom30));
+	assert(cuCSRGraphIsVertexReachableFromVertex(mapped, 10, 50, NULL));
+
+	//the first write needs a mutable graph
+	PredSuccGraph* thawed = cuCSRGraphThaw(mapped, false, cuPayloadFunctionsIntValue(), cuPayloadFunctionsIntValue());
+	cuCSRGraphDestroy(mapped, NULL);
+	assert(cuPredSuccGraphGetVertexNumber(thawed) == 6);
+	int edges = 0;
+	for (int i=1; i<=6; i++) {
+		edges += cuPredSuccGraphGetNodeOutDegree(thawed, i*10);
+	}
+	assert(edges == 5);
+	assert(CU_CAST_PTR2INT(cuPredSuccGraphGetNodeById(thawed, 40)->payload) == 4);
+	assert(CU_CAST_PTR2INT(cuPredSuccGraphGetEdgeInGraph(thawed, 30, 10)->payload) == 3);
+	cuPredSuccGraphAddEdge(thawed, 50, 60, CU_CAST_INT2PTR(6));
+	assert(cuPredSuccGraphIsVertexReachableFromVertex(thawed, 10, 60, cuAlwaysTraverse));
+
+	cuPredSuccGraphDestroyWithElements(thawed, NULL);
+	cuCSRGraphDestroy(csr, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+///files which are not valid graphs are refused
+/**
+ * Save the snapshot and overwrite a value in the file
+ *
+ * @param[in] csr the snapshot to save
+ * @param[in] path the file to create
+ * @param[in] offset the position of the value to overwrite in the file
+ * @param[in] value the value to write
+ */
+static void saveCorrupted(const csr_graph* csr, const char* path, long offset, unsigned int value) {
+	cuCSRGraphSave(csr, path);
+	FILE* f = fopen(path, "r+b");
+	assert(f != NULL);
+	fseek(f, offset, SEEK_SET);
+	assert(fwrite(&value, sizeof(value), 1, f) == 1);
+	fclose(f);
+}
+
+void testCSRGraph09(CuTest* tc) {
+	srand(0);
+	PredSuccGraph* g = createRandomGraph(1000, 3000);
+	csr_graph* csr = cuPredSuccGraphFreeze(g);
+	unsigned int* order = malloc(sizeof(unsigned int) * csr->size);
+	unsigned int reachable = cuCSRGraphBFS(csr, 0, NULL, order, NULL);
+	cuCSRGraphSave(csr, "testCSRGraph09.bin");
+
+	//where the arrays are in the file
+	csr_graph* mapped = cuCSRGraphMap("testCSRGraph09.bin");
+	assert(mapped != NULL);
+	const char* base = mapped->mapping;
+	long successorOffset = ((const char*) &mapped->successorOffsets[500]) - base;
+	long successor = ((const char*) &mapped->successors[10]) - base;
+	long predecessorEdge = ((const char*) &mapped->predecessorEdges[20]) - base;
+	long id = ((const char*) &mapped->ids[1]) - base;
+	long edgePayload = ((const char*) &mapped->edgePayloads[0]) - base;
+	cuCSRGraphDestroy(mapped, NULL);
+
+	//a corrupted structure is refused even without the checksum
+	saveCorrupted(csr, "testCSRGraph09.bin", successorOffset, csr->edgesNumber + 5);
+	assert(cuCSRGraphMap("testCSRGraph09.bin", false) == NULL);
+	saveCorrupted(csr, "testCSRGraph09.bin", successorOffset, csr->successorOffsets[499] - 1);
+	assert(cuCSRGraphMap("testCSRGraph09.bin", false) == NULL);
+	saveCorrupted(csr, "testCSRGraph09.bin", successor, 1000000);
+	assert(cuCSRGraphMap("testCSRGraph09.bin", false) == NULL);
+	saveCorrupted(csr, "testCSRGraph09.bin", predecessorEdge, csr->edgesNumber);
+	assert(cuCSRGraphMap("testCSRGraph09.bin", false) == NULL);
+	saveCorrupted(csr, "testCSRGraph09.bin", id, 0);
+	assert(cuCSRGraphMap("testCSRGraph09.bin", false) == NULL);
+
+	//a corrupted payload is detected only by the checksum, and leaves the structure usable
+	saveCorrupted(csr, "testCSRGraph09.bin", edgePayload, 0xFF);
+	assert(cuCSRGraphMap("testCSRGraph09.bin") == NULL);
+	csr_graph* unchecked = cuCSRGraphMap("testCSRGraph09.bin", false);
+	assert(unchecked != NULL);
+	assert(unchecked->edgePayloads[0] != NULL);
+	assert(cuCSRGraphBFS(unchecked, 0, NULL, order, NULL) == reachable);
+	cuCSRGraphDestroy(unchecked, NULL);
+
+	//a truncated file
+	FILE* f = fopen("testCSRGraph09.bin", "rb");
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fclose(f);
+	assert(truncate("testCSRGraph09.bin", size - 8) == 0);
+	assert(cuCSRGraphMap("testCSRGraph09.bin", false) == NULL);
+
+	//not a graph at all
+	f = fopen("testCSRGraph09.bin", "w");
+	fprintf(f, "this is not a graph, but it is long enough to contain a header");
+	fclose(f);
+	assert(cuCSRGraphMap("testCSRGraph09.bin") == NULL);
+
+	remove("testCSRGraph09.bin");
+	free(order);
+	cuCSRGraphDestroy(csr, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+///test the parallel BFS on a small graph
+void testCSRGraph10(CuTest* tc) {
+	PredSuccGraph* g = createGraph();
+	csr_graph* csr = cuPredSuccGraphFreeze(g);
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+	unsigned int order[6];
+	int distances[6];
+	unsigned int parents[6];
+
+	assert(cuCSRGraphParallelBFS(csr, 0, NULL, pool, order, distances, parents) == 5);
+	assert(order[0] == 0);
+	assert(distances[0] == 0 && distances[1] == 1 && distances[2] == 2 && distances[3] == 3 && distances[4] == 4 && distances[5] == -1);
+	assert(parents[0] == 0 && parents[1] == 0 && parents[2] == 1 && parents[3] == 2 && parents[4] == 3 && parents[5] == UINT_MAX);
+	assert(cuCSRGraphParallelBFS(csr, 0, noEdgeFrom30, pool) == 3);
+	assert(cuCSRGraphParallelBFS(csr, 5) == 1);
+
+	int levelSizes[6] = {0, 0, 0, 0, 0, 0};
+	int* levelSizesPtr = levelSizes;
+	int lastLevel = 1;
+	cuInitVarArgsOnStack(context, levelSizesPtr, lastLevel);
+	assert(cuCSRGraphParallelBFS(csr, 2, NULL, NULL, NULL, NULL, NULL, countLevelVertices, context) == 3);
+	assert(levelSizes[0] == 1 && levelSizes[1] == 2 && levelSizes[2] == 0);
+	lastLevel = 10;
+	cuInitVarArgsOnStack(context2, levelSizesPtr, lastLevel);
+	assert(cuCSRGraphParallelBFS(csr, 2, NULL, pool, NULL, NULL, NULL, countLevelVertices, context2) == 5);
+	assert(levelSizes[0] == 1 && levelSizes[1] == 2 && levelSizes[2] == 2 && levelSizes[3] == 0);
+
+	pint_ht* vertexDistances = cuHTNew(cuPayloadFunctionsIntValue());
+	pint_ht* vertexParents = cuHTNew(cuPayloadFunctionsIntValue());
+	assert(cuPredSuccGraphParallelBFS(g, 20, NULL, pool, vertexDistances, vertexParents) == 5);
+	assert(cuHTGetSize(vertexDistances) == 5);
+	assert(CU_CAST_PTR2INT(cuHTGetItem(vertexDistances, 20)) == 0);
+	assert(CU_CAST_PTR2INT(cuHTGetItem(vertexDistances, 50)) == 3);
+	assert(!cuHTContainsItem(vertexDistances, 60));
+	assert(CU_CAST_PTR2INT(cuHTGetItem(vertexParents, 20)) == 20);
+	assert(CU_CAST_PTR2INT(cuHTGetItem(vertexParents, 10)) == 30);
+	//the snapshot we already have is reused
+	cuHTClear(vertexDistances);
+	assert(cuPredSuccGraphParallelBFS(g, 30, noEdgeFrom30, pool, vertexDistances, NULL, csr) == 1);
+	assert(cuHTGetSize(vertexDistances) == 1);
+	cuHTDestroy(vertexDistances, NULL);
+	cuHTDestroy(vertexParents, NULL);
+
+	cuParallelThreadPoolDestroy(pool, NULL);
+	cuCSRGraphDestroy(csr, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+///the parallel BFS gives the same distances of the sequential one on a graph large enough to be visited bottom up
+void testCSRGraph11(CuTest* tc) {
+	srand(0);
+	const int vertices = 50000;
+	PredSuccGraph* g = createRandomGraph(vertices, 16 * vertices);
+	csr_graph* csr = cuPredSuccGraphFreeze(g);
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+	unsigned int* order = malloc(sizeof(unsigned int) * vertices);
+	int* expected = malloc(sizeof(int) * vertices);
+	int* distances = malloc(sizeof(int) * vertices);
+	unsigned int* parents = malloc(sizeof(unsigned int) * vertices);
+	assert(order != NULL && expected != NULL && distances != NULL && parents != NULL);
+
+	bool (*traversers[])(const Edge*) = {NULL, noEdgeWithSumMultipleOf3};
+	for (int t=0; t<2; t++) {
+		unsigned int reached = cuCSRGraphBFS(csr, 0, traversers[t], order, expected);
+		assert(cuCSRGraphParallelBFS(csr, 0, traversers[t], pool, order, distances, parents) == reached);
+		assert(cuCSRGraphParallelBFS(csr, 0, traversers[t], NULL, NULL, NULL, NULL) == reached);
+		for (int i=0; i<vertices; i++) {
+			assert(distances[i] == expected[i]);
+			if (distances[i] > 0) {
+				Edge* e = cuPredSuccGraphGetEdgeInGraph(g, csr->ids[parents[i]], csr->ids[i]);
+				assert(e != NULL);
+				assert(traversers[t] == NULL || traversers[t](e));
+				assert(distances[parents[i]] == distances[i] - 1);
+			}
+		}
+		//levels are contiguous in the order
+		for (unsigned int i=1; i<reached; i++) {
+			assert(distances[order[i - 1]] <= distances[order[i]]);
+		}
+	}
+
+	free(order);
+	free(expected);
+	free(distances);
+	free(parents);
+	cuParallelThreadPoolDestroy(pool, NULL);
+	cuCSRGraphDestroy(csr, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+///the parallel SCC finds the same components of the sequential one, numbered in reverse topological order whatever the workers
+void testCSRGraph12(CuTest* tc) {
+	srand(0);
+	const int triangles = 20000;
+	const int chain = 10000;
+	const int vertices = 3 * triangles + chain;
+	PredSuccGraph* g = cuPredSuccGraphNew();
+	for (int i=0; i<vertices; i++) {
+		cuPredSuccGraphAddNodeInGraphById(g, i, NULL);
+	}
+	for (int i=0; i<triangles; i++) {
+		cuPredSuccGraphAddEdge(g, 3*i, 3*i + 1, NULL);
+		cuPredSuccGraphAddEdge(g, 3*i + 1, 3*i + 2, NULL);
+		cuPredSuccGraphAddEdge(g, 3*i + 2, 3*i, NULL);
+	}
+	for (int i=0; i<2*triangles; i++) {
+		int source = rand() % (3 * triangles);
+		int sink = rand() % (3 * triangles);
+		if (!cuPredSuccGraphContainsEdgeInGraph(g, source, sink)) {
+			cuPredSuccGraphAddEdge(g, source, sink, NULL);
+		}
+	}
+	//a chain going towards lower ids, which needs to be trimmed one vertex after the other
+	for (int i=vertices - 1; i>3 * triangles; i--) {
+		cuPredSuccGraphAddEdge(g, i, i - 1, NULL);
+	}
+	cuPredSuccGraphAddEdge(g, 3 * triangles, 0, NULL);
+
+	csr_graph* csr = cuPredSuccGraphFreeze(g);
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+	unsigned int* expected = malloc(sizeof(unsigned int) * vertices);
+	unsigned int* components = malloc(sizeof(unsigned int) * vertices);
+	unsigned int* serial = malloc(sizeof(unsigned int) * vertices);
+	unsigned int* mapping = malloc(sizeof(unsigned int) * vertices);
+	bool* included = malloc(sizeof(bool) * vertices);
+	bool* traversable = malloc(sizeof(bool) * csr->edgesNumber);
+	assert(expected != NULL && components != NULL && serial != NULL && mapping != NULL && included != NULL && traversable != NULL);
+
+	unsigned int sccs = cuCSRGraphComputeSCC(csr, expected);
+	assert(cuCSRGraphParallelComputeSCC(csr, NULL, NULL, pool, components) == sccs);
+	assert(cuCSRGraphParallelComputeSCC(csr, NULL, NULL, NULL, serial) == sccs);
+	for (unsigned int i=0; i<sccs; i++) {
+		mapping[i] = UINT_MAX;
+	}
+	for (int i=0; i<vertices; i++) {
+		assert(components[i] == serial[i]);
+		if (mapping[expected[i]] == UINT_MAX) {
+			mapping[expected[i]] = components[i];
+		}
+		assert(mapping[expected[i]] == components[i]);
+		CU_ITERATE_OVER_CSR_SUCCESSORS(csr, i, sink, e) {
+			assert(components[i] >= components[sink]);
+		}
+	}
+
+	for (int i=0; i<vertices; i++) {
+		included[i] = (i % 5) != 0;
+		CU_ITERATE_OVER_CSR_SUCCESSORS(csr, i, sink, e) {
+			traversable[e] = noEdgeWithSumMultipleOf3(csr->edges[e]);
+		}
+	}
+	sccs = cuCSRGraphParallelComputeSCC(csr, included, traversable, pool, components);
+	assert(cuCSRGraphParallelComputeSCC(csr, included, traversable, NULL, serial) == sccs);
+	for (int i=0; i<vertices; i++) {
+		assert(components[i] == serial[i]);
+		assert(included[i] == (components[i] != UINT_MAX));
+		if (!included[i]) {
+			continue;
+		}
+		CU_ITERATE_OVER_CSR_SUCCESSORS(csr, i, sink, e) {
+			assert(!included[sink] || !traversable[e] || components[i] >= components[sink]);
+		}
+	}
+
+	free(expected);
+	free(components);
+	free(serial);
+	free(mapping);
+	free(included);
+	free(traversable);
+	cuParallelThreadPoolDestroy(pool, NULL);
+	cuCSRGraphDestroy(csr, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+CuSuite* CuCSRGraphSuite() {
+	CuSuite* suite = CuSuiteNew();
+
+	SUITE_ADD_TEST(suite, testCSRGraph01);
+	SUITE_ADD_TEST(suite, testCSRGraph02);
+	SUITE_ADD_TEST(suite, testCSRGraph03);
+	SUITE_ADD_TEST(suite, testCSRGraph04);
+	SUITE_ADD_TEST(suite, testCSRGraph05);
+	SUITE_ADD_TEST(suite, testCSRGraph06);
+	SUITE_ADD_TEST(suite, testCSRGraph07);
+	SUITE_ADD_TEST(suite, testCSRGraph08);
+	SUITE_ADD_TEST(suite, testCSRGraph09);
+	SUITE_ADD_TEST(suite, testCSRGraph10);
+	SUITE_ADD_TEST(suite, testCSRGraph11);
+	SUITE_ADD_TEST(suite, testCSRGraph12);
+
+	return suite;
+}
@@ -0,0 +1,144 @@
+/*
+ * csvReaderTest.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: koldar
+ */
+
+#include <assert.h>
+#include "CuTest.h"
+#include "csvReader.h"
+#include "csvProducer.h"
+#include "multithreading.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @param[in] field the field to check
+ * @param[in] expected the content the field should have
+ * @return true if the field contains exactly @c expected
+ */
+static bool isFieldEqualTo(csv_field field, const char* expected) {
+	return field.length == strlen(expected) && strncmp(field.start, expected, field.length) == 0;
+}
+
+///read a file generated by csv_helper, with its preamble and header
+void testCSVReader01(CuTest* tc) {
+	const char* header[] = {"id", "value", "name"};
+	csv_helper* helper = cuCSVHelperNew("testCSVReader01", ';', '\n', "%d %.3f %s", header, "w");
+	cuCSVHelperEnableBuffering(helper, CU_CSV_BUFFER_SIZE, false);
+	for (int i=0; i<1000; i++) {
+		cuCSVHelperPrintRow(helper, i, i * 0.5, (i % 2) == 0 ? "even" : "odd");
+	}
+	cuCSVHelperDestroy(helper, NULL);
+
+	csv_reader* reader = cuCSVReaderNew("testCSVReader01.csv");
+	assert(cuCSVReaderGetDelimiter(reader) == ';');
+	assert(cuCSVReaderGetRowsNumber(reader) == 1000);
+	assert(cuCSVReaderGetColumnsNumber(reader) == 3);
+	assert(strcmp(cuCSVReaderGetColumnName(reader, 0), "id") == 0);
+	assert(strcmp(cuCSVReaderGetColumnName(reader, 2), "name") == 0);
+	assert(cuCSVReaderGetColumnIndex(reader, "value") == 1);
+	assert(cuCSVReaderGetColumnIndex(reader, "foo") == -1);
+
+	assert(isFieldEqualTo(cuCSVReaderGetField(reader, 0, 2), "even"));
+	assert(isFieldEqualTo(cuCSVReaderGetField(reader, 999, 2), "odd"));
+	assert(isFieldEqualTo(cuCSVReaderGetField(reader, 3, 1), "1.500"));
+
+	int ids[1000];
+	double values[1000];
+	assert(cuCSVReaderGetIntColumn(reader, 0, ids) == 0);
+	assert(cuCSVReaderGetDoubleColumn(reader, 1, values) == 0);
+	for (int i=0; i<1000; i++) {
+		assert(ids[i] == i);
+		assert(values[i] == i * 0.5);
+	}
+	int n;
+	assert(!cuCSVReaderGetInt(reader, 0, 2, &n));
+
+	cuCSVReaderDestroy(reader, NULL);
+}
+
+///no preamble, no header, CRLF, empty lines, ragged rows and no newline at the end of the file
+void testCSVReader02(CuTest* tc) {
+	FILE* f = fopen("testCSVReader02.csv", "w");
+	assert(f != NULL);
+	fprintf(f, "1,a,10\r\n\n2,,20\r\n3,c\n\r\n4,d,40,extra\n5,e,50");
+	fclose(f);
+
+	csv_reader* reader = cuCSVReaderNew("testCSVReader02.csv", NULL, ',', false);
+	assert(cuCSVReaderGetRowsNumber(reader) == 5);
+	assert(cuCSVReaderGetColumnsNumber(reader) == 3);
+	assert(cuCSVReaderGetColumnName(reader, 0) == NULL);
+	assert(cuCSVReaderGetColumnIndex(reader, "1") == -1);
+
+	assert(isFieldEqualTo(cuCSVReaderGetField(reader, 0, 2), "10"));
+	assert(isFieldEqualTo(cuCSVReaderGetField(reader, 1, 1), ""));
+	assert(isFieldEqualTo(cuCSVReaderGetField(reader, 2, 1), "c"));
+	assert(isFieldEqualTo(cuCSVReaderGetField(reader, 2, 2), ""));
+	assert(isFieldEqualTo(cuCSVReaderGetField(reader, 3, 2), "40"));
+	assert(isFieldEqualTo(cuCSVReaderGetField(reader, 4, 2), "50"));
+
+	long values[5] = {0, 0, -1, 0, 0};
+	assert(cuCSVReaderGetLongColumn(reader, 2, values) == 1);
+	assert(values[0] == 10 && values[1] == 20 && values[2] == -1 && values[3] == 40 && values[4] == 50);
+
+	cuCSVReaderDestroy(reader, NULL);
+
+	//an empty file
+	f = fopen("testCSVReader02.csv", "w");
+	assert(f != NULL);
+	fclose(f);
+	reader = cuCSVReaderNew("testCSVReader02.csv");
+	assert(cuCSVReaderGetRowsNumber(reader) == 0);
+	assert(cuCSVReaderGetColumnsNumber(reader) == 0);
+	cuCSVReaderDestroy(reader, NULL);
+}
+
+///a file big enough to be indexed by several workers gives the same result of the sequential indexing
+void testCSVReader03(CuTest* tc) {
+	const char* header[] = {"id", "square", "name"};
+	csv_helper* helper = cuCSVHelperNew("testCSVReader03", ',', '\n', "%d %ld %s", header, "w");
+	cuCSVHelperEnableBuffering(helper, CU_CSV_BUFFER_SIZE, false);
+	const int rows = 300000;
+	for (int i=0; i<rows; i++) {
+		cuCSVHelperPrintRow(helper, i, ((long) i) * i, (i % 7) == 0 ? "" : "name");
+	}
+	cuCSVHelperDestroy(helper, NULL);
+
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+	csv_reader* parallel = cuCSVReaderNew("testCSVReader03.csv", pool);
+	csv_reader* sequential = cuCSVReaderNew("testCSVReader03.csv", NULL);
+
+	assert(cuCSVReaderGetRowsNumber(parallel) == rows);
+	assert(cuCSVReaderGetRowsNumber(sequential) == rows);
+	long* squares = malloc(sizeof(long) * rows);
+	assert(squares != NULL);
+	assert(cuCSVReaderGetLongColumn(parallel, cuCSVReaderGetColumnIndex(parallel, "square"), squares) == 0);
+	for (int i=0; i<rows; i++) {
+		assert(squares[i] == ((long) i) * i);
+		for (int j=0; j<3; j++) {
+			csv_field p = cuCSVReaderGetField(parallel, i, j);
+			csv_field s = cuCSVReaderGetField(sequential, i, j);
+			assert(p.start == s.start - cuCSVReaderGetField(sequential, 0, 0).start + cuCSVReaderGetField(parallel, 0, 0).start);
+			assert(p.length == s.length);
+		}
+		assert(cuCSVReaderGetField(parallel, i, 2).length == ((i % 7) == 0 ? 0 : 4));
+	}
+	free(squares);
+
+	cuCSVReaderDestroy(parallel, NULL);
+	cuCSVReaderDestroy(sequential, NULL);
+	cuParallelThreadPoolDestroy(pool, NULL);
+}
+
+CuSuite* CuCSVReaderSuite() {
+	CuSuite* suite = CuSuiteNew();
+
+	SUITE_ADD_TEST(suite, testCSVReader01);
+	SUITE_ADD_TEST(suite, testCSVReader02);
+	SUITE_ADD_TEST(suite, testCSVReader03);
+
+	return suite;
+}
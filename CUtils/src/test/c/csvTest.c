@@ -9,6 +9,26 @@
 #include "CuTest.h"
 #include "log.h"
 #include "csvProducer.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+/**
+ * @param[in] filePath the file to read
+ * @return the content of the file. Needs to be freed
+ */
+static char* readWholeFile(const char* filePath) {
+	FILE* f = fopen(filePath, "r");
+	assert(f != NULL);
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	rewind(f);
+	char* retVal = malloc(size + 1);
+	assert(fread(retVal, sizeof(char), size, f) == size);
+	retVal[size] = '\0';
+	fclose(f);
+	return retVal;
+}
 
 
 void testcsvProducer01(CuTest* tc) {
@@ -51,11 +71,119 @@ void testcsvProducer02(CuTest* tc) {
 	cuCSVHelperDestroy(csvHelper, NULL);
 }
 
+///buffered rows produce the same file of cuCSVHelperprintDataRow
+void testcsvProducer03(CuTest* tc) {
+	const char* header[] = {"int", "long", "fixed", "string", "double", "padded", "hex"};
+	const char* template = "%d %ld %.2f %s %f %5.2f %x";
+	const char* strings[] = {"a", "", "hello world"};
+
+	csv_helper* expected = cuCSVHelperNew("testcsvProducer03Expected", ';', '\n', template, header, "w");
+	csv_helper* row = cuCSVHelperNew("testcsvProducer03Row", ';', '\n', template, header, "w");
+	csv_helper* rows = cuCSVHelperNew("testcsvProducer03Rows", ';', '\n', template, header, "w");
+	//a very small buffer, flushed lots of times
+	cuCSVHelperEnableBuffering(rows, 64, false);
+
+	csv_cell cells[7];
+	for (int i=-500; i<500; i++) {
+		long l = i == -500 ? LONG_MIN : (i == 499 ? LONG_MAX : ((long) i) * 1000003L);
+		double fixed = i * 1.37 - 50;
+		double d = i / 7.0;
+		cuCSVHelperprintDataRow(expected, i, l, fixed, strings[(i + 500) % 3], d, d, i);
+		cuCSVHelperPrintRow(row, i, l, fixed, strings[(i + 500) % 3], d, d, i);
+		cells[0].i = i; cells[1].l = l; cells[2].d = fixed; cells[3].s = strings[(i + 500) % 3]; cells[4].d = d; cells[5].d = d; cells[6].i = i;
+		cuCSVHelperPrintRows(rows, cells, 1);
+	}
+
+	cuCSVHelperDestroy(expected, NULL);
+	cuCSVHelperDestroy(row, NULL);
+	cuCSVHelperDestroy(rows, NULL);
+
+	char* expectedContent = readWholeFile("testcsvProducer03Expected.csv");
+	char* rowContent = readWholeFile("testcsvProducer03Row.csv");
+	char* rowsContent = readWholeFile("testcsvProducer03Rows.csv");
+	assert(strncmp(expectedContent, "sep=;\nint;long;fixed;string;double;padded;hex\n", 46) == 0);
+	assert(strcmp(expectedContent, rowContent) == 0);
+	assert(strcmp(expectedContent, rowsContent) == 0);
+
+	free(expectedContent);
+	free(rowContent);
+	free(rowsContent);
+}
+
+///background flush, cells bigger than the buffer and rows printed directly in the file
+void testcsvProducer04(CuTest* tc) {
+	const char* header[] = {"id", "value", "name"};
+	char big[1000];
+	memset(big, 'x', sizeof(big) - 1);
+	big[sizeof(big) - 1] = '\0';
+
+	csv_helper* expected = cuCSVHelperNew("testcsvProducer04Expected", ',', '\n', "%d %.3f %s", header, "w");
+	csv_helper* actual = cuCSVHelperNew("testcsvProducer04Actual", ',', '\n', "%d %.3f %s", header, "w");
+	cuCSVHelperEnableBuffering(actual, 256, true);
+
+	csv_cell cells[3 * 10];
+	for (int i=0; i<100000; i++) {
+		const char* name = (i % 10000) == 0 ? big : "name";
+		cuCSVHelperprintDataRow(expected, i, i * 0.001, name);
+		cells[3 * (i % 10) + 0].i = i;
+		cells[3 * (i % 10) + 1].d = i * 0.001;
+		cells[3 * (i % 10) + 2].s = name;
+		if ((i % 10) == 9) {
+			cuCSVHelperPrintRows(actual, cells, 10);
+		}
+	}
+	//a row printed directly in the file goes after the buffered ones
+	cuCSVHelperprintDataRow(expected, -1, -1.0, "last");
+	cuCSVHelperprintDataRow(actual, -1, -1.0, "last");
+	cuCSVHelperPrintRow(expected, -2, -2.0, "buffered");
+	cuCSVHelperPrintRow(actual, -2, -2.0, "buffered");
+
+	cuCSVHelperFlush(actual);
+	cuCSVHelperDestroy(expected, NULL);
+	cuCSVHelperDestroy(actual, NULL);
+
+	char* expectedContent = readWholeFile("testcsvProducer04Expected.csv");
+	char* actualContent = readWholeFile("testcsvProducer04Actual.csv");
+	assert(strcmp(expectedContent, actualContent) == 0);
+
+	free(expectedContent);
+	free(actualContent);
+}
+
+///values exactly (or almost exactly) halfway between two printable numbers are rounded like printf
+void testcsvProducer05(CuTest* tc) {
+	const char* header[] = {"zero", "two", "six"};
+	//0.125, 0.375, 2.5 are exactly halfway; 2.675 and 1.005 are stored a bit below the half, 1.0000005 a bit above
+	const double values[] = {0.5, 1.5, 2.5, -0.5, -2.5, 0.125, 0.375, -0.125, 2.675, 1.005, 1.0000005, 0.0000005, 0.0000015, -0.0, -0.001, 1e15 + 0.5};
+
+	csv_helper* expected = cuCSVHelperNew("testcsvProducer05Expected", ',', '\n', "%.0f %.2f %f", header, "w");
+	csv_helper* actual = cuCSVHelperNew("testcsvProducer05Actual", ',', '\n', "%.0f %.2f %f", header, "w");
+	for (int i=0; i<sizeof(values)/sizeof(values[0]); i++) {
+		cuCSVHelperprintDataRow(expected, values[i], values[i], values[i]);
+		cuCSVHelperPrintRow(actual, values[i], values[i], values[i]);
+	}
+	cuCSVHelperDestroy(expected, NULL);
+	cuCSVHelperDestroy(actual, NULL);
+
+	char* expectedContent = readWholeFile("testcsvProducer05Expected.csv");
+	char* actualContent = readWholeFile("testcsvProducer05Actual.csv");
+	assert(strcmp(expectedContent, actualContent) == 0);
+	//halfway values go to the even digit
+	assert(strstr(actualContent, "\n0,0.50,0.500000\n2,1.50,1.500000\n2,2.50,2.500000\n") != NULL);
+	assert(strstr(actualContent, "\n0,0.12,0.125000\n") != NULL);
+
+	free(expectedContent);
+	free(actualContent);
+}
+
 CuSuite* CuCSVSuite() {
 	CuSuite* suite = CuSuiteNew();
 
 	SUITE_ADD_TEST(suite, testcsvProducer01);
 	SUITE_ADD_TEST(suite, testcsvProducer02);
+	SUITE_ADD_TEST(suite, testcsvProducer03);
+	SUITE_ADD_TEST(suite, testcsvProducer04);
+	SUITE_ADD_TEST(suite, testcsvProducer05);
 
 	return suite;
 }
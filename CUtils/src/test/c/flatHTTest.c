@@ -0,0 +1,242 @@
+/*
+ * flatHTTest.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: koldar
+ */
+
+#include "CuTest.h"
+#include "flat_hashtable.h"
+#include "hashtable.h"
+#include "timeMeasurement.h"
+#include "log.h"
+#include "macros.h"
+#include <assert.h>
+#include <string.h>
+
+///test cuFlatHTNew
+void testFlatHT01(CuTest* tc) {
+	flat_ht* ht = cuFlatHTNew();
+
+	assert(cuFlatHTGetSize(ht) == 0);
+	assert(cuFlatHTIsEmpty(ht));
+	assert(cuFlatHTGetItem(ht, 5) == NULL);
+	assert(cuFlatHTGetFirstItem(ht) == NULL);
+
+	cuFlatHTDestroy(ht, NULL);
+}
+
+///test add, update and remove
+void testFlatHT02(CuTest* tc) {
+	flat_ht* ht = cuFlatHTNew(cuPayloadFunctionsIntValue());
+
+	cuFlatHTAddItem(ht, 5, CU_CAST_INT2PTR(3));
+	assert(cuFlatHTGetSize(ht) == 1);
+	assert(cuFlatHTContainsItem(ht, 5));
+	assert(!cuFlatHTContainsItem(ht, 6));
+	assert(CU_CAST_PTR2INT(cuFlatHTGetItem(ht, 5)) == 3);
+
+	assert(cuFlatHTAddOrUpdateItem(ht, 5, CU_CAST_INT2PTR(4)) == false);
+	assert(cuFlatHTGetSize(ht) == 1);
+	assert(CU_CAST_PTR2INT(cuFlatHTGetItem(ht, 5)) == 4);
+
+	assert(cuFlatHTUpdateItem(ht, 6, CU_CAST_INT2PTR(4)) == false);
+	assert(cuFlatHTUpdateItem(ht, 5, CU_CAST_INT2PTR(7)) == true);
+	assert(CU_CAST_PTR2INT(cuFlatHTGetItem(ht, 5)) == 7);
+
+	assert(cuFlatHTRemoveItem(ht, 6) == false);
+	assert(cuFlatHTRemoveItem(ht, 5) == true);
+	assert(cuFlatHTGetSize(ht) == 0);
+	assert(!cuFlatHTContainsItem(ht, 5));
+
+	cuFlatHTDestroy(ht, NULL);
+}
+
+///test growth and removal with lots of keys
+void testFlatHT03(CuTest* tc) {
+	flat_ht* ht = cuFlatHTNew(cuPayloadFunctionsIntValue());
+	const int n = 10000;
+
+	for (int i=0; i<n; i++) {
+		cuFlatHTAddItem(ht, i * 16, CU_CAST_INT2PTR(i));
+	}
+	assert(cuFlatHTGetSize(ht) == n);
+	assert(cuFlatHTGetCapacity(ht) >= n);
+	for (int i=0; i<n; i++) {
+		assert(CU_CAST_PTR2INT(cuFlatHTGetItem(ht, i * 16)) == i);
+		assert(!cuFlatHTContainsItem(ht, i * 16 + 1));
+	}
+
+	//remove half of the keys: the others need to be still reachable
+	for (int i=0; i<n; i+=2) {
+		assert(cuFlatHTRemoveItem(ht, i * 16));
+	}
+	assert(cuFlatHTGetSize(ht) == n/2);
+	for (int i=0; i<n; i++) {
+		assert(cuFlatHTContainsItem(ht, i * 16) == (i % 2 == 1));
+	}
+
+	cuFlatHTClear(ht);
+	assert(cuFlatHTIsEmpty(ht));
+	assert(cuFlatHTGetCapacity(ht) >= n);
+	assert(!cuFlatHTContainsItem(ht, 16));
+
+	cuFlatHTDestroy(ht, NULL);
+}
+
+///test cuFlatHTReserve
+void testFlatHT04(CuTest* tc) {
+	flat_ht* ht = cuFlatHTNew(cuPayloadFunctionsIntValue());
+
+	cuFlatHTReserve(ht, 1000);
+	size_t capacity = cuFlatHTGetCapacity(ht);
+	assert(capacity >= 1000);
+	for (int i=0; i<1000; i++) {
+		cuFlatHTAddItem(ht, i, CU_CAST_INT2PTR(i));
+	}
+	assert(cuFlatHTGetCapacity(ht) == capacity);
+
+	cuFlatHTDestroy(ht, NULL);
+}
+
+///test cuFlatHTClone and cuFlatHTBufferString
+void testFlatHT05(CuTest* tc) {
+	flat_ht* ht = cuFlatHTNew(cuPayloadFunctionsIntValue());
+	char buffer[BUFFER_SIZE];
+
+	cuFlatHTBufferString(ht, buffer);
+	assert(strcmp(buffer, "{}") == 0);
+
+	cuFlatHTAddItem(ht, 1, CU_CAST_INT2PTR(10));
+	cuFlatHTAddItem(ht, 2, CU_CAST_INT2PTR(20));
+
+	flat_ht* clone = cuFlatHTClone(ht);
+	cuFlatHTRemoveItem(ht, 1);
+	assert(cuFlatHTGetSize(clone) == 2);
+	assert(CU_CAST_PTR2INT(cuFlatHTGetItem(clone, 1)) == 10);
+	assert(CU_CAST_PTR2INT(cuFlatHTGetItem(clone, 2)) == 20);
+
+	cuFlatHTBufferString(ht, buffer);
+	assert(strcmp(buffer, "{<2: 20>}") == 0);
+
+	cuFlatHTDestroy(clone, NULL);
+	cuFlatHTDestroy(ht, NULL);
+}
+
+///test cuFlatHTDestroyWithElements
+void testFlatHT06(CuTest* tc) {
+	flat_ht* ht = cuFlatHTNew(cuPayloadFunctionsIntPtr());
+
+	for (int i=0; i<100; i++) {
+		int* p = CU_MALLOC(int);
+		*p = i;
+		cuFlatHTAddItem(ht, i, p);
+	}
+	assert(cuFlatHTRemoveItemWithElement(ht, 50));
+	assert(cuFlatHTGetSize(ht) == 99);
+
+	cuFlatHTDestroyWithElements(ht, NULL);
+}
+
+void test_CU_ITERATE_OVER_FLATHT_01(CuTest* tc) {
+	flat_ht* ht = cuFlatHTNew(cuPayloadFunctionsIntValue());
+
+	int sum = 0;
+	CU_ITERATE_OVER_FLATHT(ht, key, value, long) {
+		sum += value;
+	}
+	assert(sum == 0);
+
+	unsigned long keySum = 0;
+	for (int i=1; i<=100; i++) {
+		cuFlatHTAddItem(ht, i, CU_CAST_INT2PTR(i*2));
+	}
+	CU_ITERATE_OVER_FLATHT(ht, key, value, long) {
+		keySum += key;
+		sum += value;
+	}
+	assert(keySum == 5050);
+	assert(sum == 10100);
+
+	sum = 0;
+	CU_ITERATE_OVER_FLATHT_VALUES(ht, value, long) {
+		sum += value;
+	}
+	assert(sum == 10100);
+
+	cuFlatHTDestroy(ht, NULL);
+}
+
+///compare ::HT and ::flat_ht on inserting, successful lookups, failed lookups and removals
+void test_benchmarkFlatHTvsHT(CuTest* tc) {
+	const int n = 200000;
+	long sum = 0;
+
+	HT* ht = cuHTNew();
+	CU_PROFILE_TIME_CODE(htInsert, TM_MICRO) {
+		for (int i=0; i<n; i++) {
+			cuHTAddItem(ht, 2*i, CU_CAST_INT2PTR(i));
+		}
+	}
+	CU_PROFILE_TIME_CODE(htHit, TM_MICRO) {
+		for (int i=0; i<n; i++) {
+			sum += CU_CAST_PTR2INT(cuHTGetItem(ht, 2*i));
+		}
+	}
+	CU_PROFILE_TIME_CODE(htMiss, TM_MICRO) {
+		for (int i=0; i<n; i++) {
+			sum += cuHTContainsItem(ht, 2*i + 1);
+		}
+	}
+	CU_PROFILE_TIME_CODE(htDelete, TM_MICRO) {
+		for (int i=0; i<n; i++) {
+			cuHTRemoveItem(ht, 2*i);
+		}
+	}
+	cuHTDestroy(ht, NULL);
+
+	flat_ht* flat = cuFlatHTNew(cuPayloadFunctionsIntValue());
+	CU_PROFILE_TIME_CODE(flatInsert, TM_MICRO) {
+		for (int i=0; i<n; i++) {
+			cuFlatHTAddItem(flat, 2*i, CU_CAST_INT2PTR(i));
+		}
+	}
+	CU_PROFILE_TIME_CODE(flatHit, TM_MICRO) {
+		for (int i=0; i<n; i++) {
+			sum -= CU_CAST_PTR2INT(cuFlatHTGetItem(flat, 2*i));
+		}
+	}
+	CU_PROFILE_TIME_CODE(flatMiss, TM_MICRO) {
+		for (int i=0; i<n; i++) {
+			sum += cuFlatHTContainsItem(flat, 2*i + 1);
+		}
+	}
+	CU_PROFILE_TIME_CODE(flatDelete, TM_MICRO) {
+		for (int i=0; i<n; i++) {
+			cuFlatHTRemoveItem(flat, 2*i);
+		}
+	}
+	assert(cuFlatHTIsEmpty(flat));
+	cuFlatHTDestroy(flat, NULL);
+
+	assert(sum == 0);
+	critical("%d keys (us) | HT: insert=%ld hit=%ld miss=%ld delete=%ld", n, htInsert, htHit, htMiss, htDelete);
+	critical("%d keys (us) | flat_ht: insert=%ld hit=%ld miss=%ld delete=%ld", n, flatInsert, flatHit, flatMiss, flatDelete);
+}
+
+CuSuite* CuFlatHTSuite() {
+	CuSuite* suite = CuSuiteNew();
+
+	SUITE_ADD_TEST(suite, testFlatHT01);
+	SUITE_ADD_TEST(suite, testFlatHT02);
+	SUITE_ADD_TEST(suite, testFlatHT03);
+	SUITE_ADD_TEST(suite, testFlatHT04);
+	SUITE_ADD_TEST(suite, testFlatHT05);
+	SUITE_ADD_TEST(suite, testFlatHT06);
+
+	SUITE_ADD_TEST(suite, test_CU_ITERATE_OVER_FLATHT_01);
+
+	SUITE_ADD_TEST(suite, test_benchmarkFlatHTvsHT);
+
+	return suite;
+}
@@ -0,0 +1,300 @@
+/*
+ * graphLoaderTest.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: koldar
+ */
+
+#include <assert.h>
+#include "CuTest.h"
+#include "graph_loader.h"
+#include "multithreading.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @param[in] filename the file to create
+ * @param[in] content what to write in the file
+ */
+static void writeFile(const char* filename, const char* content) {
+	FILE* f = fopen(filename, "w");
+	assert(f != NULL);
+	fprintf(f, "%s", content);
+	fclose(f);
+}
+
+/**
+ * @param[in] g the graph involved
+ * @param[in] source the id of the source
+ * @param[in] sink the id of the sink
+ * @return the weight of the edge
+ */
+static long getWeight(const PredSuccGraph* g, NodeId source, NodeId sink) {
+	Edge* e = cuPredSuccGraphGetEdgeInGraph(g, source, sink);
+	assert(e != NULL);
+	return CU_CAST_PTR2INT(e->payload);
+}
+
+/**
+ * @param[in] g the graph involved
+ * @param[in] vertices the number of vertices of the graph. Their ids go from 1 to @c vertices
+ * @return the number of edges in the graph
+ */
+static int getEdgesNumber(const PredSuccGraph* g, NodeId vertices) {
+	int result = 0;
+	for (NodeId id=1; id<=vertices; id++) {
+		result += cuPredSuccGraphGetNodeOutDegree(g, id);
+	}
+	return result;
+}
+
+///an edge list with comments, empty lines, CRLF, optional and non integer weights
+void testGraphLoader01(CuTest* tc) {
+	writeFile("testGraphLoader01.txt",
+			"# a comment\n"
+			"% another comment\n"
+			"1 2 5\r\n"
+			"\n"
+			"1\t3\n"
+			"  2 3 -4\n"
+			"3 1000000 7\n"
+			"2 3 6\n"
+			"3 1 2.5"
+	);
+
+	PredSuccGraph* g = cuPredSuccGraphLoad("testGraphLoader01.txt", GFF_EDGE_LIST);
+	assert(g != NULL);
+	assert(cuPredSuccGraphGetVertexNumber(g) == 4);
+	assert(cuPredSuccGraphGetNodeOutDegree(g, 1) == 2);
+	assert(cuPredSuccGraphGetNodeOutDegree(g, 2) == 1);
+	assert(cuPredSuccGraphGetNodeOutDegree(g, 3) == 2);
+	assert(cuPredSuccGraphGetNodeOutDegree(g, 1000000) == 0);
+	assert(getWeight(g, 1, 2) == 5);
+	assert(getWeight(g, 1, 3) == 0);
+	//the last edge wins
+	assert(getWeight(g, 2, 3) == 6);
+	assert(getWeight(g, 3, 1000000) == 7);
+	assert(getWeight(g, 3, 1) == 0);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+
+	//malformed files
+	writeFile("testGraphLoader01.txt", "1 2\n3 x\n");
+	assert(cuPredSuccGraphLoad("testGraphLoader01.txt", GFF_EDGE_LIST) == NULL);
+	writeFile("testGraphLoader01.txt", "1 2\n-3 4\n");
+	assert(cuPredSuccGraphLoad("testGraphLoader01.txt", GFF_EDGE_LIST) == NULL);
+
+	//an empty file
+	writeFile("testGraphLoader01.txt", "");
+	g = cuPredSuccGraphLoad("testGraphLoader01.txt", GFF_EDGE_LIST);
+	assert(g != NULL);
+	assert(cuPredSuccGraphGetVertexNumber(g) == 0);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+///a DIMACS file declares the vertices, even the ones without edges
+void testGraphLoader02(CuTest* tc) {
+	writeFile("testGraphLoader02.gr",
+			"c 9th DIMACS Implementation Challenge\n"
+			"c\n"
+			"p sp 6 4\n"
+			"c arcs\n"
+			"a 1 2 10\n"
+			"a 2 3 20\n"
+			"a 2 1 30\n"
+			"a 6 1 -40\n"
+	);
+
+	PredSuccGraph* g = cuPredSuccGraphLoad("testGraphLoader02.gr", GFF_DIMACS, NULL, true);
+	assert(g != NULL);
+	assert(cuPredSuccGraphGetVertexNumber(g) == 6);
+	assert(getEdgesNumber(g, 6) == 4);
+	assert(cuPredSuccGraphGetNodeOutDegree(g, 4) == 0);
+	assert(cuPredSuccGraphGetNodeOutDegree(g, 5) == 0);
+	assert(getWeight(g, 1, 2) == 10);
+	assert(getWeight(g, 2, 3) == 20);
+	assert(getWeight(g, 2, 1) == 30);
+	assert(getWeight(g, 6, 1) == -40);
+	assert(cuPredSuccGraphGetEdgeInGraph(g, 1, 6) == NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+
+	//an arc with a vertex not declared
+	writeFile("testGraphLoader02.gr", "p sp 3 2\na 1 2 1\na 2 4 1\n");
+	assert(cuPredSuccGraphLoad("testGraphLoader02.gr", GFF_DIMACS) == NULL);
+	writeFile("testGraphLoader02.gr", "p sp 3 2\na 1 2 1\na 0 2 1\n");
+	assert(cuPredSuccGraphLoad("testGraphLoader02.gr", GFF_DIMACS) == NULL);
+}
+
+///Matrix Market files, with different fields and symmetries
+void testGraphLoader03(CuTest* tc) {
+	writeFile("testGraphLoader03.mtx",
+			"%%MatrixMarket matrix coordinate integer symmetric\n"
+			"% a comment\n"
+			"4 4 3\n"
+			"1 1 4\n"
+			"2 1 5\n"
+			"3 2 -6\n"
+	);
+	PredSuccGraph* g = cuPredSuccGraphLoad("testGraphLoader03.mtx", GFF_MATRIX_MARKET);
+	assert(g != NULL);
+	assert(cuPredSuccGraphGetVertexNumber(g) == 4);
+	assert(getEdgesNumber(g, 4) == 5);
+	assert(getWeight(g, 1, 1) == 4);
+	assert(getWeight(g, 2, 1) == 5);
+	assert(getWeight(g, 1, 2) == 5);
+	assert(getWeight(g, 3, 2) == -6);
+	assert(getWeight(g, 2, 3) == -6);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+
+	writeFile("testGraphLoader03.mtx",
+			"%%MatrixMarket matrix coordinate integer skew-symmetric\n"
+			"3 3 1\n"
+			"2 1 5\n"
+	);
+	g = cuPredSuccGraphLoad("testGraphLoader03.mtx", GFF_MATRIX_MARKET);
+	assert(g != NULL);
+	assert(getWeight(g, 2, 1) == 5);
+	assert(getWeight(g, 1, 2) == -5);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+
+	//rectangular matrices have a vertex per row and per column
+	writeFile("testGraphLoader03.mtx",
+			"%%MatrixMarket matrix coordinate real general\n"
+			"2 5 2\n"
+			"1 5 0.5\n"
+			"2 1 1e3\n"
+	);
+	g = cuPredSuccGraphLoad("testGraphLoader03.mtx", GFF_MATRIX_MARKET);
+	assert(g != NULL);
+	assert(cuPredSuccGraphGetVertexNumber(g) == 5);
+	assert(getEdgesNumber(g, 5) == 2);
+	assert(getWeight(g, 1, 5) == 0);
+	assert(getWeight(g, 2, 1) == 0);
+	assert(cuPredSuccGraphGetEdgeInGraph(g, 5, 1) == NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+
+	writeFile("testGraphLoader03.mtx",
+			"%%MatrixMarket matrix coordinate pattern general\n"
+			"3 3 2\n"
+			"1 2\n"
+			"2 3\n"
+	);
+	g = cuPredSuccGraphLoad("testGraphLoader03.mtx", GFF_MATRIX_MARKET);
+	assert(g != NULL);
+	assert(getEdgesNumber(g, 3) == 2);
+	assert(getWeight(g, 1, 2) == 0);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+
+	//dense matrices aren't graphs
+	writeFile("testGraphLoader03.mtx", "%%MatrixMarket matrix array real general\n2 2\n1\n2\n3\n4\n");
+	assert(cuPredSuccGraphLoad("testGraphLoader03.mtx", GFF_MATRIX_MARKET) == NULL);
+	writeFile("testGraphLoader03.mtx", "1 2\n");
+	assert(cuPredSuccGraphLoad("testGraphLoader03.mtx", GFF_MATRIX_MARKET) == NULL);
+	writeFile("testGraphLoader03.mtx", "%%MatrixMarket matrix coordinate pattern general\n% no size line\n");
+	assert(cuPredSuccGraphLoad("testGraphLoader03.mtx", GFF_MATRIX_MARKET) == NULL);
+}
+
+///a file big enough to be parsed by several workers gives the same graph of the sequential parsing
+void testGraphLoader04(CuTest* tc) {
+	const int vertices = 50000;
+	const int edgesPerVertex = 10;
+	FILE* f = fopen("testGraphLoader04.txt", "w");
+	assert(f != NULL);
+	fprintf(f, "# generated\n");
+	for (int i=0; i<vertices; i++) {
+		for (int j=1; j<=edgesPerVertex; j++) {
+			fprintf(f, "%d %d %d\n", i, (i * 7 + j * 13) % vertices, i - j);
+		}
+	}
+	fclose(f);
+
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+	PredSuccGraph* parallel = cuPredSuccGraphLoad("testGraphLoader04.txt", GFF_EDGE_LIST, pool, true);
+	PredSuccGraph* sequential = cuPredSuccGraphLoad("testGraphLoader04.txt", GFF_EDGE_LIST, NULL, true);
+	assert(parallel != NULL);
+	assert(sequential != NULL);
+
+	assert(cuPredSuccGraphGetVertexNumber(parallel) == vertices);
+	assert(cuPredSuccGraphGetVertexNumber(sequential) == vertices);
+	assert(cuPredSuccGraphGetEdgesNumber(parallel) == vertices * edgesPerVertex);
+	assert(cuPredSuccGraphGetEdgesNumber(sequential) == vertices * edgesPerVertex);
+	for (int i=0; i<vertices; i++) {
+		assert(cuPredSuccGraphGetNodeOutDegree(parallel, i) == edgesPerVertex);
+		assert(cuPredSuccGraphGetNodeOutDegree(sequential, i) == edgesPerVertex);
+		for (int j=1; j<=edgesPerVertex; j++) {
+			NodeId sink = (i * 7 + j * 13) % vertices;
+			assert(getWeight(parallel, i, sink) == i - j);
+			assert(getWeight(sequential, i, sink) == i - j);
+		}
+	}
+
+	cuPredSuccGraphDestroyWithElements(parallel, NULL);
+	cuPredSuccGraphDestroyWithElements(sequential, NULL);
+	cuParallelThreadPoolDestroy(pool, NULL);
+}
+
+/**
+ * Check that the predecessors of every vertex are exactly the edges going into it
+ *
+ * @param[in] g the graph involved
+ * @param[in] vertices the number of vertices of the graph. Their ids go from 1 to @c vertices
+ * @return the number of edges found walking the predecessors
+ */
+static int checkPredecessors(const PredSuccGraph* g, NodeId vertices) {
+	int result = 0;
+	for (NodeId id=1; id<=vertices; id++) {
+		Node* sink = cuPredSuccGraphGetNodeById(g, id);
+		CU_ITERATE_OVER_HT_VALUES(sink->predecessors, e, Edge*) {
+			assert(e->sink == sink);
+			assert(cuPredSuccGraphGetEdgeInGraph(g, e->source->id, id) == e);
+			result++;
+		}
+	}
+	return result;
+}
+
+///duplicated edges with predecessors enabled
+void testGraphLoader05(CuTest* tc) {
+	writeFile("testGraphLoader05.txt",
+			"1 2 5\n"
+			"2 3 1\n"
+			"1 2 6\n"
+			"3 1 2\n"
+			"1 2 7\n"
+	);
+	PredSuccGraph* g = cuPredSuccGraphLoad("testGraphLoader05.txt", GFF_EDGE_LIST, NULL, true);
+	assert(g != NULL);
+	assert(getEdgesNumber(g, 3) == 3);
+	assert(getWeight(g, 1, 2) == 7);
+	assert(checkPredecessors(g, 3) == 3);
+	assert(cuPredSuccGraphGetPredecessorNumberOfVertex(g, 2) == 1);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+
+	//a symmetric matrix listing both triangles
+	writeFile("testGraphLoader05.mtx",
+			"%%MatrixMarket matrix coordinate integer symmetric\n"
+			"3 3 4\n"
+			"2 1 5\n"
+			"1 2 5\n"
+			"3 2 -6\n"
+			"2 3 -6\n"
+	);
+	g = cuPredSuccGraphLoad("testGraphLoader05.mtx", GFF_MATRIX_MARKET, NULL, true);
+	assert(g != NULL);
+	assert(getEdgesNumber(g, 3) == 4);
+	assert(checkPredecessors(g, 3) == 4);
+	assert(cuPredSuccGraphGetPredecessorNumberOfVertex(g, 2) == 2);
+	assert(getWeight(g, 2, 3) == -6);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+CuSuite* CuGraphLoaderSuite() {
+	CuSuite* suite = CuSuiteNew();
+
+	SUITE_ADD_TEST(suite, testGraphLoader01);
+	SUITE_ADD_TEST(suite, testGraphLoader02);
+	SUITE_ADD_TEST(suite, testGraphLoader03);
+	SUITE_ADD_TEST(suite, testGraphLoader04);
+	SUITE_ADD_TEST(suite, testGraphLoader05);
+
+	return suite;
+}
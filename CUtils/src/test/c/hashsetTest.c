@@ -6,10 +6,13 @@
  */
 
 #include <assert.h>
+#include <string.h>
+#include <stdio.h>
 #include "CuTest.h"
 #include "payload_functions.h"
 #include "hash_set.h"
 #include "log.h"
+#include "defaultFunctions.h"
 
 void testHashSet01(CuTest* tc) {
 	pint_hash_set* intSet = cuHashSetNew(cuPayloadFunctionsIntValue());
@@ -300,6 +303,154 @@ void test_cuHashSetGetAnItem_03(CuTest* tc) {
 	cuHashSetDestroyWithElements(a, NULL);
 }
 
+///strings are compared by content when a hash function is given
+void test_cuHashSetContentHashing_01(CuTest* tc) {
+	char a[10];
+	char b[10];
+	strcpy(a, "hello");
+	strcpy(b, "hello");
+
+	hash_set* set = cuHashSetNew(cuPayloadFunctionsString(), CU_AS_HASHFUNCTION(cuDefaultFunctionsHashString));
+
+	assert(cuHashSetAddItem(set, a));
+	assert(!cuHashSetAddItem(set, b));
+	assert(cuHashSetGetSize(set) == 1);
+	assert(cuHashSetContainsItem(set, "hello"));
+	assert(!cuHashSetContainsItem(set, "world"));
+	//the item stored is the first one added
+	assert(cuHashSetGetItem(set, b) == a);
+	assert(cuHashSetGetItem(set, "world") == NULL);
+
+	cuHashSetRemoveItem(set, b);
+	assert(cuHashSetIsEmpty(set));
+
+	cuHashSetDestroy(set, NULL);
+}
+
+///without a hash function, items are compared by pointer
+void test_cuHashSetContentHashing_02(CuTest* tc) {
+	char a[10];
+	char b[10];
+	strcpy(a, "hello");
+	strcpy(b, "hello");
+
+	hash_set* set = cuHashSetNew(cuPayloadFunctionsString());
+
+	assert(cuHashSetAddItem(set, a));
+	assert(cuHashSetAddItem(set, b));
+	assert(cuHashSetGetSize(set) == 2);
+
+	cuHashSetDestroy(set, NULL);
+}
+
+///many items, reserve, the value 0 and removal of the current item while iterating
+void test_cuHashSetManyItems_01(CuTest* tc) {
+	pint_hash_set* set = cuHashSetNew(cuPayloadFunctionsIntValue());
+	cuHashSetReserve(set, 10000);
+
+	for (int i=0; i<10000; i++) {
+		assert(cuHashSetAddItem(set, CU_CAST_INT2PTR(i)));
+	}
+	assert(cuHashSetGetSize(set) == 10000);
+	assert(cuHashSetContainsItem(set, CU_CAST_INT2PTR(0)));
+	assert(!cuHashSetContainsItem(set, CU_CAST_INT2PTR(10000)));
+
+	int visited = 0;
+	CU_VARIABLE_ITERATE_OVER_HASHSET(set, item, void*) {
+		visited++;
+		if ((CU_CAST_PTR2INT(item) % 3) != 0) {
+			cuHashSetRemoveItem(set, item);
+		}
+	}
+	assert(visited == 10000);
+	assert(cuHashSetGetSize(set) == 3334);
+	for (int i=0; i<10000; i++) {
+		assert(cuHashSetContainsItem(set, CU_CAST_INT2PTR(i)) == ((i % 3) == 0));
+	}
+
+	//break works inside the iteration
+	visited = 0;
+	CU_ITERATE_OVER_HASHSET(set, item, void*) {
+		visited++;
+		if (visited == 10) {
+			break;
+		}
+	}
+	assert(visited == 10);
+
+	cuHashSetClear(set);
+	assert(cuHashSetIsEmpty(set));
+	CU_ITERATE_OVER_HASHSET(set, item, void*) {
+		assert(false);
+	}
+
+	cuHashSetDestroy(set, NULL);
+}
+
+///clones keep the hash function of the original
+void test_cuHashSetClone_01(CuTest* tc) {
+	payload_functions functions = cuPayloadFunctionsString();
+	functions.clone = CU_AS_CLONER(cuDefaultFunctionsClonerString);
+	functions.destroy = CU_AS_DESTRUCTOR(cuDefaultFunctionsDestructorObject);
+	hash_set* set = cuHashSetNew(functions, CU_AS_HASHFUNCTION(cuDefaultFunctionsHashString));
+	char buffer[20];
+
+	for (int i=0; i<100; i++) {
+		sprintf(buffer, "item%d", i);
+		cuHashSetAddItem(set, strdup(buffer));
+	}
+	hash_set* clone = cuHashSetClone(set);
+	assert(cuHashSetGetSize(clone) == 100);
+	assert(cuHashSetContainsItem(clone, "item42"));
+	assert(cuHashSetGetItem(clone, "item42") != cuHashSetGetItem(set, "item42"));
+
+	hash_set* other = cuHashSetNew(cuPayloadFunctionsString(), CU_AS_HASHFUNCTION(cuDefaultFunctionsHashString));
+	cuHashSetAddItem(other, "item42");
+	cuHashSetAddItem(other, "item1000");
+	hash_set* intersection = cuHashSetGetIntersectionOfHashSets(clone, other, false);
+	assert(cuHashSetGetSize(intersection) == 1);
+	assert(cuHashSetContainsItem(intersection, "item42"));
+
+	cuHashSetDestroy(intersection, NULL);
+	cuHashSetDestroy(other, NULL);
+	cuHashSetDestroyWithElements(clone, NULL);
+	cuHashSetDestroyWithElements(set, NULL);
+}
+
+///deep clones of a set comparing its items by identity can find their own items
+void test_cuHashSetClone_02(CuTest* tc) {
+	payload_functions functions = cuPayloadFunctionsString();
+	functions.clone = CU_AS_CLONER(cuDefaultFunctionsClonerString);
+	functions.destroy = CU_AS_DESTRUCTOR(cuDefaultFunctionsDestructorObject);
+	hash_set* set = cuHashSetNew(functions);
+	char buffer[20];
+
+	for (int i=0; i<100; i++) {
+		sprintf(buffer, "item%d", i);
+		cuHashSetAddItem(set, strdup(buffer));
+	}
+	hash_set* clone = cuHashSetClone(set);
+	assert(cuHashSetGetSize(clone) == 100);
+
+	int found = 0;
+	CU_ITERATE_OVER_HASHSET(clone, item, char*) {
+		assert(!cuHashSetContainsItem(set, item));
+		assert(cuHashSetContainsItem(clone, item));
+		assert(cuHashSetGetItem(clone, item) == item);
+		found++;
+	}
+	assert(found == 100);
+
+	char* item = cuHashSetGetAnItem(clone);
+	cuHashSetRemoveItem(clone, item);
+	assert(cuHashSetGetSize(clone) == 99);
+	assert(!cuHashSetContainsItem(clone, item));
+	free(item);
+
+	cuHashSetDestroyWithElements(clone, NULL);
+	cuHashSetDestroyWithElements(set, NULL);
+}
+
 CuSuite* CuHashSetSuite() {
 	CuSuite* suite = CuSuiteNew();
 
@@ -320,6 +471,11 @@ CuSuite* CuHashSetSuite() {
 	SUITE_ADD_TEST(suite, test_cuHashSetGetAnItem_02);
 	SUITE_ADD_TEST(suite, test_cuHashSetGetAnItem_03);
 
+	SUITE_ADD_TEST(suite, test_cuHashSetContentHashing_01);
+	SUITE_ADD_TEST(suite, test_cuHashSetContentHashing_02);
+	SUITE_ADD_TEST(suite, test_cuHashSetManyItems_01);
+	SUITE_ADD_TEST(suite, test_cuHashSetClone_01);
+	SUITE_ADD_TEST(suite, test_cuHashSetClone_02);
 
 
 	return suite;
@@ -363,6 +363,99 @@ void testmoveHeapElements02(CuTest* tc) {
 	cuHeapDestroy(dst, NULL);
 }
 
+///an unbounded heap grows on demand and keeps items with the same order
+void testunboundedHeap01(CuTest* tc) {
+	heap* h = cuHeapNew(CU_HEAP_UNBOUNDED, cuPayloadFunctionsIntValue());
+
+	srand(0);
+	for (int i=0; i<1000; i++) {
+		assert(cuHeapInsertItem(h, CU_CAST_INT2PTR(rand() % 100)));
+	}
+
+	assert(cuHeapGetSize(h) == 1000);
+	assert(cuHeapGetMaxSize(h) == CU_HEAP_UNBOUNDED);
+	assert(!cuHeapIsFull(h));
+
+	int previous = -1;
+	for (int i=0; i<1000; i++) {
+		int current = CU_CAST_PTR2INT(cuHeapRemoveMinItem(h));
+		assert(previous <= current);
+		previous = current;
+	}
+	assert(cuHeapIsEmpty(h));
+	assert(cuHeapRemoveMinItem(h) == NULL);
+
+	cuHeapDestroy(h, NULL);
+}
+
+///test cuHeapNewFromArray
+void testnewHeapFromArray01(CuTest* tc) {
+	void* items[500];
+	for (int i=0; i<500; i++) {
+		items[i] = CU_CAST_INT2PTR((i * 37) % 500);
+	}
+
+	heap* h = cuHeapNewFromArray(CU_HEAP_UNBOUNDED, cuPayloadFunctionsIntValue(), items, 500);
+
+	assert(cuHeapGetSize(h) == 500);
+	for (int i=0; i<500; i++) {
+		assert(CU_CAST_PTR2INT(cuHeapRemoveMinItem(h)) == i);
+	}
+
+	cuHeapDestroy(h, NULL);
+}
+
+///test cuHeapInsertItems, both when the heap is rebuilt and when the items are inserted one by one
+void testinsertItemsInHeap01(CuTest* tc) {
+	heap* h = cuHeapNew(100, cuPayloadFunctionsIntValue());
+	void* items[60];
+	for (int i=0; i<60; i++) {
+		items[i] = CU_CAST_INT2PTR(100 - i);
+	}
+
+	//heap rebuilt
+	assert(cuHeapInsertItems(h, items, 40));
+	assert(cuHeapGetSize(h) == 40);
+	assert(CU_CAST_PTR2INT(cuHeapPeekMinItem(h)) == 61);
+	//items inserted one by one
+	assert(cuHeapInsertItems(h, &items[40], 20));
+	assert(cuHeapGetSize(h) == 60);
+	assert(CU_CAST_PTR2INT(cuHeapPeekMinItem(h)) == 41);
+	//too many items
+	assert(!cuHeapInsertItems(h, items, 41));
+	assert(cuHeapGetSize(h) == 60);
+
+	for (int i=41; i<=100; i++) {
+		assert(CU_CAST_PTR2INT(cuHeapRemoveMinItem(h)) == i);
+	}
+
+	cuHeapDestroy(h, NULL);
+}
+
+///test cuHeapPopK
+void testpopKFromHeap01(CuTest* tc) {
+	heap* h = cuHeapNew(CU_HEAP_UNBOUNDED, cuPayloadFunctionsIntValue());
+	for (int i=0; i<100; i++) {
+		cuHeapInsertItem(h, CU_CAST_INT2PTR((i * 13) % 100));
+	}
+
+	void* output[100];
+	assert(cuHeapPopK(h, 10, output) == 10);
+	for (int i=0; i<10; i++) {
+		assert(CU_CAST_PTR2INT(output[i]) == i);
+	}
+	assert(cuHeapGetSize(h) == 90);
+
+	assert(cuHeapPopK(h, 100, output) == 90);
+	for (int i=0; i<90; i++) {
+		assert(CU_CAST_PTR2INT(output[i]) == i + 10);
+	}
+	assert(cuHeapIsEmpty(h));
+	assert(cuHeapPopK(h, 10, output) == 0);
+
+	cuHeapDestroy(h, NULL);
+}
+
 CuSuite* CuHeapSuite() {
 	CuSuite* suite = CuSuiteNew();
 
@@ -378,6 +471,10 @@ CuSuite* CuHeapSuite() {
 	SUITE_ADD_TEST(suite, testcloneHeap01);
 	SUITE_ADD_TEST(suite, testmoveHeapElements01);
 	SUITE_ADD_TEST(suite, testmoveHeapElements02);
+	SUITE_ADD_TEST(suite, testunboundedHeap01);
+	SUITE_ADD_TEST(suite, testnewHeapFromArray01);
+	SUITE_ADD_TEST(suite, testinsertItemsInHeap01);
+	SUITE_ADD_TEST(suite, testpopKFromHeap01);
 
 
 	return suite;
@@ -123,6 +123,27 @@ void testHT05(CuTest* tc) {
 	cuHTDestroy(ht, NULL);
 }
 
+void testHT06(CuTest* tc) {
+	HT* ht = cuHTNew();
+
+	//reserve while the hash table is empty and while it has some entries
+	cuHTReserve(ht, 1000);
+	for (int i=0; i<500; i++) {
+		cuHTAddItem(ht, i, CU_CAST_INT2PTR(i));
+	}
+	cuHTReserve(ht, 100000);
+	for (int i=500; i<10000; i++) {
+		cuHTAddItem(ht, i, CU_CAST_INT2PTR(i));
+	}
+
+	assert(cuHTGetSize(ht) == 10000);
+	for (int i=0; i<10000; i++) {
+		assert(CU_CAST_PTR2INT(cuHTGetItem(ht, i)) == i);
+	}
+
+	cuHTDestroy(ht, NULL);
+}
+
 void testHT_sameid(CuTest* tc) {
 	CU_WITH(int_ht* ht = cuHTNew())(cuHTDestroyWithElements2(ht, NULL)) {
 		int a = 5;
@@ -307,6 +328,7 @@ CuSuite* CuHTSuite() {
 	SUITE_ADD_TEST(suite, testHT03);
 	SUITE_ADD_TEST(suite, testHT04);
 	SUITE_ADD_TEST(suite, testHT05);
+	SUITE_ADD_TEST(suite, testHT06);
 
 	SUITE_ADD_TEST(suite, test_CU_ITERATE_OVER_HASHTABLE_01);
 	SUITE_ADD_TEST(suite, test_CU_ITERATE_OVER_HASHTABLE_02);
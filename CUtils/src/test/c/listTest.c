@@ -13,6 +13,8 @@
 #include "macros.h"
 #include "defaultFunctions.h"
 #include "log.h"
+#include "multithreading.h"
+#include "timeMeasurement.h"
 
 
 static bool testFindNumberLambda(const CU_PDOC(int*) _c, const var_args* va) {
@@ -963,6 +965,233 @@ void test_cuListRemoveHeadAndDestroyItem_04(CuTest* tc) {
 	}
 }
 
+struct keyed_item {
+	int key;
+	int index;
+};
+
+static int orderKeyedItems(const void* a, const void* b) {
+	return ((const struct keyed_item*)a)->key - ((const struct keyed_item*)b)->key;
+}
+
+static int orderIntValues(const void* a, const void* b) {
+	long x = CU_CAST_PTR2INT(a);
+	long y = CU_CAST_PTR2INT(b);
+	return (x > y) - (x < y);
+}
+
+static bool isListSorted(const list* l, orderer order) {
+	void* previous = NULL;
+	bool first = true;
+	CU_ITERATE_OVER_LIST(l, cell, value, void*) {
+		if (!first && order(previous, value) > 0) {
+			return false;
+		}
+		previous = value;
+		first = false;
+	}
+	return true;
+}
+
+///sort keeps equal elements in their original order
+void test_cuListSort_01(CuTest* tc) {
+	struct keyed_item items[1000];
+	list* l = cuListNew(cuPayloadFunctionsIntValue());
+
+	cuListSort(l, orderKeyedItems);
+	assert(cuListIsEmpty(l));
+
+	for (int i=0; i<1000; i++) {
+		items[i].key = (i * 37) % 10;
+		items[i].index = i;
+		cuListAddTail(l, &items[i]);
+	}
+	cuListSort(l, orderKeyedItems);
+
+	assert(cuListGetSize(l) == 1000);
+	assert(((struct keyed_item*)cuListGetTail0(l))->key == 9);
+	struct keyed_item* previous = NULL;
+	CU_ITERATE_OVER_LIST(l, cell, item, struct keyed_item*) {
+		if (previous != NULL) {
+			assert(previous->key <= item->key);
+			if (previous->key == item->key) {
+				assert(previous->index < item->index);
+			}
+		}
+		previous = item;
+	}
+	//the list is still usable
+	cuListAddTail(l, &items[0]);
+	assert(cuListGetTail0(l) == &items[0]);
+
+	cuListDestroy(l, NULL);
+}
+
+///scramble produces a permutation of the list
+void test_cuListScramble_01(CuTest* tc) {
+	list* a = cuListNew(cuPayloadFunctionsIntValue());
+	list* b = cuListNew(cuPayloadFunctionsIntValue());
+	for (int i=0; i<500; i++) {
+		cuListAddTail(a, CU_CAST_INT2PTR(i));
+		cuListAddTail(b, CU_CAST_INT2PTR(i));
+	}
+
+	cuListScrambleWithSeed(a, 42);
+	cuListScrambleWithSeed(b, 42);
+	assert(cuListGetSize(a) == 500);
+	assert(!isListSorted(a, orderIntValues));
+	for (int i=0; i<500; i++) {
+		assert(cuListGetNthItem(a, i, long) == cuListGetNthItem(b, i, long));
+	}
+	assert(cuListGetTail0(a) == cuListGetTail0(b));
+
+	cuListScramble(b);
+	cuListSort(a, orderIntValues);
+	cuListSort(b, orderIntValues);
+	for (int i=0; i<500; i++) {
+		assert(cuListGetNthItem(a, i, long) == i);
+		assert(cuListGetNthItem(b, i, long) == i);
+	}
+
+	//every position is equally likely: the first element ends up in the first half about half of the times
+	int inFirstHalf = 0;
+	list* small = cuListNew(cuPayloadFunctionsIntValue());
+	for (int i=0; i<10; i++) {
+		cuListAddTail(small, CU_CAST_INT2PTR(i));
+	}
+	for (int seed=0; seed<2000; seed++) {
+		cuListScrambleWithSeed(small, seed);
+		for (int i=0; i<5; i++) {
+			if (cuListGetNthItem(small, i, long) == 0) {
+				inFirstHalf++;
+			}
+		}
+	}
+	assert(inFirstHalf > 850 && inFirstHalf < 1150);
+
+	cuListDestroy(small, NULL);
+	cuListDestroy(a, NULL);
+	cuListDestroy(b, NULL);
+}
+
+///parallel sort gives the same result of the sequential one
+void test_cuListParallelSort_01(CuTest* tc) {
+	const int size = 50000;
+	struct keyed_item* items = malloc(sizeof(struct keyed_item) * size);
+	list* l = cuListNew(cuPayloadFunctionsIntValue());
+	for (int i=0; i<size; i++) {
+		items[i].key = (i * 7919) % 1000;
+		items[i].index = i;
+		cuListAddTail(l, &items[i]);
+	}
+
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(3);
+	cuListParallelSort(l, orderKeyedItems, pool);
+	cuParallelThreadPoolDestroy(pool, NULL);
+
+	assert(cuListGetSize(l) == size);
+	struct keyed_item* previous = NULL;
+	int count = 0;
+	CU_ITERATE_OVER_LIST(l, cell, item, struct keyed_item*) {
+		if (previous != NULL) {
+			assert(previous->key < item->key || (previous->key == item->key && previous->index < item->index));
+		}
+		previous = item;
+		count++;
+	}
+	assert(count == size);
+	assert(cuListGetTail0(l) == previous);
+
+	cuListDestroy(l, NULL);
+	free(items);
+}
+
+/**
+ * The exchange sort cuListSort used to implement. It is run on an array, so it is even faster than the original
+ */
+static void exchangeSort(list* l, orderer order) {
+	int size = cuListGetSize(l);
+	void** payloads = malloc(sizeof(void*) * size);
+	int i = 0;
+	CU_ITERATE_OVER_LIST(l, cell, payload, void*) {
+		payloads[i++] = payload;
+	}
+	for (int a=0; a<size; a++) {
+		for (int b=a+1; b<size; b++) {
+			if (order(payloads[a], payloads[b]) > 0) {
+				void* tmp = payloads[a];
+				payloads[a] = payloads[b];
+				payloads[b] = tmp;
+			}
+		}
+	}
+	cuListClear(l);
+	for (i=0; i<size; i++) {
+		cuListAddTail(l, payloads[i]);
+	}
+	free(payloads);
+}
+
+static list* createScrambledList(int size, int seed) {
+	list* l = cuListNew(cuPayloadFunctionsIntValue());
+	for (int i=0; i<size; i++) {
+		cuListAddTail(l, CU_CAST_INT2PTR(i));
+	}
+	cuListScrambleWithSeed(l, seed);
+	return l;
+}
+
+///show how sorting scales with the size of the list
+void test_benchmarkListSort(CuTest* tc) {
+	const int small = 5000;
+	const int big = 4 * small;
+
+	list* l = createScrambledList(small, 1);
+	CU_PROFILE_TIME_CODE(exchangeSmall, TM_MICRO) {
+		exchangeSort(l, orderIntValues);
+	}
+	assert(isListSorted(l, orderIntValues));
+	cuListDestroy(l, NULL);
+
+	l = createScrambledList(big, 1);
+	CU_PROFILE_TIME_CODE(exchangeBig, TM_MICRO) {
+		exchangeSort(l, orderIntValues);
+	}
+	cuListDestroy(l, NULL);
+
+	l = createScrambledList(small, 1);
+	CU_PROFILE_TIME_CODE(mergeSmall, TM_MICRO) {
+		cuListSort(l, orderIntValues);
+	}
+	assert(isListSorted(l, orderIntValues));
+	cuListDestroy(l, NULL);
+
+	l = createScrambledList(big, 1);
+	CU_PROFILE_TIME_CODE(mergeBig, TM_MICRO) {
+		cuListSort(l, orderIntValues);
+	}
+	cuListDestroy(l, NULL);
+
+	const int huge = 500000;
+	l = createScrambledList(huge, 1);
+	CU_PROFILE_TIME_CODE(mergeHuge, TM_MICRO) {
+		cuListSort(l, orderIntValues);
+	}
+	CU_PROFILE_TIME_CODE(scrambleHuge, TM_MICRO) {
+		cuListScramble(l);
+	}
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+	CU_PROFILE_TIME_CODE(parallelHuge, TM_MICRO) {
+		cuListParallelSort(l, orderIntValues, pool);
+	}
+	cuParallelThreadPoolDestroy(pool, NULL);
+	assert(isListSorted(l, orderIntValues));
+	cuListDestroy(l, NULL);
+
+	critical("sorting %d and %d elements (us) | exchange sort: %ld %ld merge sort: %ld %ld", small, big, exchangeSmall, exchangeBig, mergeSmall, mergeBig);
+	critical("%d elements (us) | merge sort: %ld parallel merge sort: %ld scramble: %ld", huge, mergeHuge, parallelHuge, scrambleHuge);
+}
+
 CuSuite* CuProjectSuite() {
 	CuSuite* suite = CuSuiteNew();
 
@@ -1002,6 +1231,11 @@ CuSuite* CuProjectSuite() {
 	SUITE_ADD_TEST(suite, test_cuListRemoveHeadAndDestroyItem_03);
 	SUITE_ADD_TEST(suite, test_cuListRemoveHeadAndDestroyItem_04);
 
+	SUITE_ADD_TEST(suite, test_cuListSort_01);
+	SUITE_ADD_TEST(suite, test_cuListScramble_01);
+	SUITE_ADD_TEST(suite, test_cuListParallelSort_01);
+	SUITE_ADD_TEST(suite, test_benchmarkListSort);
+
 
 
 	return suite;
@@ -10,6 +10,9 @@
 #include <assert.h>
 #include "CuTest.h"
 #include <stdio.h>
+#include <string.h>
+#include "multithreading.h"
+#include "timeMeasurement.h"
 
 void testLog01(CuTest* tc) {
 	debug("hello");
@@ -49,6 +52,239 @@ void testLog03(CuTest* tc) {
 	info("looking for >= or > constraints to convert in <= or <");
 }
 
+///test the memory appender
+void testLog04(CuTest* tc) {
+	char entry[200];
+	log_appender* memory = cuLogAppenderMemoryNew(3);
+
+	clearAppenders();
+	addLogAppender(memory);
+	for (int i=0; i<5; i++) {
+		critical("entry %d", i);
+	}
+	assert(cuLogAppenderMemoryGetSize(memory) == 3);
+	//only the last 3 entries are kept
+	cuLogAppenderMemoryGetEntry(memory, 0, entry, 200);
+	assert(strstr(entry, "logTest.c:testLog04:") == entry);
+	assert(strstr(entry, "[CRITICAL] entry 2") != NULL);
+	cuLogAppenderMemoryGetEntry(memory, 2, entry, 200);
+	assert(strstr(entry, "[CRITICAL] entry 4") != NULL);
+
+	clearAppenders();
+	addLogAppender(cuLogAppenderStdOutNew());
+}
+
+static int functionAppenderCalls = 0;
+
+static void countLogs(const char* fileName, const char* functionName, const int lineNo, const LogLevel level, const char* message) {
+	functionAppenderCalls++;
+}
+
+///test several appenders and excluded loggers
+void testLog05(CuTest* tc) {
+	log_appender* memory1 = cuLogAppenderMemoryNew(10);
+	log_appender* memory2 = cuLogAppenderMemoryNew(10);
+
+	clearAppenders();
+	addLogAppender(memory1);
+	addLogAppender(memory2);
+	addAppender(countLogs);
+	critical("hello");
+	assert(cuLogAppenderMemoryGetSize(memory1) == 1);
+	assert(cuLogAppenderMemoryGetSize(memory2) == 1);
+	assert(functionAppenderCalls == 1);
+
+	excludeLogger("anotherFile.c");
+	excludeLogger("logTest.c");
+	critical("hello");
+	assert(cuLogAppenderMemoryGetSize(memory1) == 1);
+	includeLogger("logTest.c");
+	critical("hello");
+	assert(cuLogAppenderMemoryGetSize(memory1) == 2);
+	excludeLogger("logTest.c");
+	clearExcludedLoggers();
+	critical("hello");
+	assert(cuLogAppenderMemoryGetSize(memory1) == 3);
+	assert(functionAppenderCalls == 3);
+
+	clearAppenders();
+	addLogAppender(cuLogAppenderStdOutNew());
+}
+
+///test the rotation of the file appender
+void testLog06(CuTest* tc) {
+	const char* path = "/tmp/cutilsLogTest.log";
+	remove(path);
+	remove("/tmp/cutilsLogTest.log.1");
+	remove("/tmp/cutilsLogTest.log.2");
+	remove("/tmp/cutilsLogTest.log.3");
+
+	clearAppenders();
+	addLogAppender(cuLogAppenderFileNew(path, 200, 2));
+	for (int i=0; i<30; i++) {
+		critical("a line long enough to fill the file in a few entries %d", i);
+	}
+	clearAppenders();
+	addLogAppender(cuLogAppenderStdOutNew());
+
+	FILE* f = fopen(path, "r");
+	assert(f != NULL);
+	fclose(f);
+	f = fopen("/tmp/cutilsLogTest.log.2", "r");
+	assert(f != NULL);
+	fclose(f);
+	//only 2 rotated files are kept
+	assert(fopen("/tmp/cutilsLogTest.log.3", "r") == NULL);
+
+	remove(path);
+	remove("/tmp/cutilsLogTest.log.1");
+	remove("/tmp/cutilsLogTest.log.2");
+}
+
+static enum thread_loop_state logFromThread(CU_NOTNULL const cu_thread* thread, const struct var_args* va) {
+	for (int i=0; i<250; i++) {
+		critical("message %d", i);
+	}
+	return TLS_STOP;
+}
+
+///test asynchronous logging from several threads
+void testLog07(CuTest* tc) {
+	log_appender* memory = cuLogAppenderMemoryNew(2000);
+
+	clearAppenders();
+	addLogAppender(memory);
+	enableAsyncLogging(64);
+
+	cuInitVarArgsOnStack(va, NULL);
+	cu_parallel_thread_pool* threads = cuParallelThreadPoolNew(4);
+	cu_future* futures[4];
+	for (int i=0; i<4; i++) {
+		futures[i] = cuParallelThreadPoolSubmit(threads, logFromThread, va);
+	}
+	for (int i=0; i<4; i++) {
+		cuFutureWait(futures[i], -1);
+		cuFutureDestroy(futures[i], NULL);
+	}
+	cuParallelThreadPoolDestroy(threads, NULL);
+	flushLogs();
+	assert(cuLogAppenderMemoryGetSize(memory) == 1000);
+
+	critical("last message");
+	disableAsyncLogging();
+	assert(cuLogAppenderMemoryGetSize(memory) == 1001);
+
+	clearAppenders();
+	addLogAppender(cuLogAppenderStdOutNew());
+}
+
+///test the file appender when several threads log and rotate at the same time
+void testLog08(CuTest* tc) {
+	const char* path = "/tmp/cutilsLogTest08.log";
+	char rotated[100];
+
+	clearAppenders();
+	addLogAppender(cuLogAppenderFileNew(path, 4000, 1000));
+
+	cuInitVarArgsOnStack(va, NULL);
+	cu_parallel_thread_pool* threads = cuParallelThreadPoolNew(4);
+	cu_future* futures[4];
+	for (int i=0; i<4; i++) {
+		futures[i] = cuParallelThreadPoolSubmit(threads, logFromThread, va);
+	}
+	for (int i=0; i<4; i++) {
+		cuFutureWait(futures[i], -1);
+		cuFutureDestroy(futures[i], NULL);
+	}
+	cuParallelThreadPoolDestroy(threads, NULL);
+	clearAppenders();
+	addLogAppender(cuLogAppenderStdOutNew());
+
+	//every message has been written exactly once, in the current file or in one of the rotated ones
+	int lines = 0;
+	for (int i=0; i<=1000; i++) {
+		if (i == 0) {
+			snprintf(rotated, sizeof(rotated), "%s", path);
+		} else {
+			snprintf(rotated, sizeof(rotated), "%s.%d", path, i);
+		}
+		FILE* f = fopen(rotated, "r");
+		if (f == NULL) {
+			continue;
+		}
+		int c;
+		while ((c = fgetc(f)) != EOF) {
+			if (c == '\n') {
+				lines++;
+			}
+		}
+		fclose(f);
+		remove(rotated);
+	}
+	assert(lines == 1000);
+}
+
+static enum thread_loop_state logUntilStopped(CU_NOTNULL const cu_thread* thread, const struct var_args* va) {
+	volatile bool* stop = cuVarArgsGetItem(va, 0, volatile bool*);
+	int i = 0;
+	while (!*stop) {
+		critical("message %d", i++);
+	}
+	return TLS_STOP;
+}
+
+///flushLogs needs to return even if another thread never stops logging
+void testLog09(CuTest* tc) {
+	log_appender* memory = cuLogAppenderMemoryNew(10);
+	volatile bool stop = false;
+
+	clearAppenders();
+	addLogAppender(memory);
+	enableAsyncLogging(64);
+
+	cuInitVarArgsOnStack(va, &stop);
+	cu_parallel_thread_pool* threads = cuParallelThreadPoolNew(1);
+	cu_future* future = cuParallelThreadPoolSubmit(threads, logUntilStopped, va);
+	for (int i=0; i<100; i++) {
+		critical("flushing %d", i);
+		flushLogs();
+	}
+	stop = true;
+	cuFutureWait(future, -1);
+	cuFutureDestroy(future, NULL);
+	cuParallelThreadPoolDestroy(threads, NULL);
+
+	disableAsyncLogging();
+	clearAppenders();
+	addLogAppender(cuLogAppenderStdOutNew());
+}
+
+///compare synchronous and asynchronous logging on a file
+void testLogBenchmark(CuTest* tc) {
+	const char* path = "/tmp/cutilsLogBenchmark.log";
+	const int messages = 20000;
+
+	clearAppenders();
+	addLogAppender(cuLogAppenderFileNew(path, 0, 0));
+	CU_PROFILE_TIME_CODE(sync, TM_MICRO) {
+		for (int i=0; i<messages; i++) {
+			critical("benchmark message %d", i);
+		}
+	}
+	enableAsyncLogging(4096);
+	CU_PROFILE_TIME_CODE(async, TM_MICRO) {
+		for (int i=0; i<messages; i++) {
+			critical("benchmark message %d", i);
+		}
+	}
+	disableAsyncLogging();
+	clearAppenders();
+	addLogAppender(cuLogAppenderStdOutNew());
+	remove(path);
+
+	critical("%d messages (us) | sync: %ld async: %ld", messages, sync, async);
+}
+
 CuSuite* CuLogSuite() {
 	CuSuite* suite = CuSuiteNew();
 
@@ -56,6 +292,14 @@ CuSuite* CuLogSuite() {
 	SUITE_ADD_TEST(suite, testLog01);
 	SUITE_ADD_TEST(suite, testLog02);
 	SUITE_ADD_TEST(suite, testLog03);
+	SUITE_ADD_TEST(suite, testLog04);
+	SUITE_ADD_TEST(suite, testLog05);
+	SUITE_ADD_TEST(suite, testLog06);
+	SUITE_ADD_TEST(suite, testLog07);
+	SUITE_ADD_TEST(suite, testLog08);
+	SUITE_ADD_TEST(suite, testLog09);
+
+	SUITE_ADD_TEST(suite, testLogBenchmark);
 
 	return suite;
 }
@@ -10,6 +10,8 @@
 #include "log.h"
 #include "string_utils.h"
 #include <unistd.h>
+#include <string.h>
+#include <assert.h>
 
 enum thread_loop_state run01(CU_NOTNULL const cu_thread* thread, const struct var_args* va) {
 	int* a = cuVarArgsGetItem(va, 0, int*);
@@ -212,6 +214,173 @@ void test_multithreading_05(CuTest* tc) {
 	}
 }
 
+enum thread_loop_state increment(CU_NOTNULL const cu_thread* thread, const struct var_args* va) {
+	int* a = cuVarArgsGetItem(va, 0, int*);
+	__sync_add_and_fetch(a, 1);
+	return TLS_STOP;
+}
+
+///test thread pool with lots of small tasks
+void test_threadPool_01(CuTest* tc) {
+	int a = 0;
+	cuInitVarArgsOnStack(va, &a);
+
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+	assert(cuParallelThreadPoolGetThreadsNumber(pool) == 4);
+	for (int i=0; i<1000; i++) {
+		cuFutureDestroy(cuParallelThreadPoolSubmit(pool, increment, va), NULL);
+	}
+	assert(cuParallelThreadPoolWaitAll(pool, -1));
+	assert(a == 1000);
+
+	cuParallelThreadPoolDestroy(pool, NULL);
+}
+
+enum thread_loop_state sleepAndSet(CU_NOTNULL const cu_thread* thread, const struct var_args* va) {
+	int* a = cuVarArgsGetItem(va, 0, int*);
+	usleep(300000);
+	*a = 5;
+	return TLS_STOP;
+}
+
+///test timeouts
+void test_threadPool_02(CuTest* tc) {
+	int a = 0;
+	cuInitVarArgsOnStack(va, &a);
+
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew();
+	assert(cuParallelThreadPoolGetThreadsNumber(pool) > 0);
+
+	cu_future* future = cuParallelThreadPoolSubmit(pool, sleepAndSet, va);
+	assert(cuFutureWait(future, 10) == false);
+	assert(cuParallelThreadPoolWaitAll(pool, 10) == false);
+	assert(cuFutureWait(future, 5000) == true);
+	assert(cuFutureIsDone(future));
+	assert(a == 5);
+	assert(cuParallelThreadPoolWaitAll(pool, 10) == true);
+
+	cuFutureDestroy(future, NULL);
+	cuParallelThreadPoolDestroy(pool, NULL);
+}
+
+enum thread_loop_state fibonacci(CU_NOTNULL const cu_thread* thread, const struct var_args* va) {
+	cu_parallel_thread_pool* pool = cuVarArgsGetItem(va, 0, cu_parallel_thread_pool*);
+	int n = cuVarArgsGetItem(va, 1, int);
+	int* result = cuVarArgsGetItem(va, 2, int*);
+
+	if (n < 2) {
+		*result = n;
+		return TLS_STOP;
+	}
+
+	int a;
+	int b;
+	cuInitVarArgsOnStack(va1, pool, n - 1, &a);
+	cuInitVarArgsOnStack(va2, pool, n - 2, &b);
+	cu_future* f1 = cuParallelThreadPoolSubmit(pool, fibonacci, va1);
+	cu_future* f2 = cuParallelThreadPoolSubmit(pool, fibonacci, va2);
+	cuFutureWait(f1, -1);
+	cuFutureWait(f2, -1);
+	cuFutureDestroy(f1, NULL);
+	cuFutureDestroy(f2, NULL);
+
+	*result = a + b;
+	return TLS_STOP;
+}
+
+///test tasks submitting and waiting other tasks
+void test_threadPool_03(CuTest* tc) {
+	int result = 0;
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(2);
+	cuInitVarArgsOnStack(va, pool, 15, &result);
+
+	cu_future* future = cuParallelThreadPoolSubmit(pool, fibonacci, va);
+	assert(cuFutureWait(future, -1));
+	assert(result == 610);
+
+	cuFutureDestroy(future, NULL);
+	cuParallelThreadPoolDestroy(pool, NULL);
+}
+
+enum thread_loop_state countUpTo3(CU_NOTNULL const cu_thread* thread, const struct var_args* va) {
+	int* a = cuVarArgsGetItem(va, 0, int*);
+	*a += 1;
+	return *a < 3 ? TLS_CONTINUE : TLS_STOP;
+}
+
+///test tasks which needs to be executed several times
+void test_threadPool_04(CuTest* tc) {
+	int a = 0;
+	int b = 0;
+	cuInitVarArgsOnStack(va1, &a);
+	cuInitVarArgsOnStack(va2, &b);
+
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(3);
+	cu_future* f1 = cuParallelThreadPoolSubmit(pool, countUpTo3, va1);
+	cu_future* f2 = cuParallelThreadPoolSubmit(pool, countUpTo3, va2);
+	//destroying the pool waits for all the tasks
+	cuParallelThreadPoolDestroy(pool, NULL);
+
+	assert(cuFutureIsDone(f1));
+	assert(cuFutureIsDone(f2));
+	assert(a == 3);
+	assert(b == 3);
+
+	cuFutureDestroy(f1, NULL);
+	cuFutureDestroy(f2, NULL);
+}
+
+static enum thread_loop_state markChunks(CU_NULLABLE const cu_thread* thread, const struct var_args* va) {
+	cu_parallel_for* loop = cuVarArgsGetItem(va, 0, cu_parallel_for*);
+	int* visits = cuVarArgsGetItem(va, 1, int*);
+	int* executions = cuVarArgsGetItem(va, 2, int*);
+	__sync_fetch_and_add(executions, 1);
+	unsigned int chunk;
+	while (cuParallelForGetNextChunk(loop, &chunk)) {
+		__sync_fetch_and_add(&visits[chunk], 1);
+	}
+	return TLS_STOP;
+}
+
+///test the loops split in chunks
+void test_threadPool_05(CuTest* tc) {
+	cu_parallel_for loop;
+	int visits[100];
+	int executions;
+	cu_parallel_for* loopPtr = &loop;
+	int* visitsPtr = visits;
+	int* executionsPtr = &executions;
+	cuInitVarArgsOnStack(va, loopPtr, visitsPtr, executionsPtr);
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+
+	//every chunk is processed exactly once, by at most a task per worker
+	memset(visits, 0, sizeof(visits));
+	executions = 0;
+	cuParallelThreadPoolFor(pool, markChunks, va, &loop, 100);
+	for (int i=0; i<100; i++) {
+		assert(visits[i] == 1);
+	}
+	assert(executions >= 1 && executions <= 4);
+
+	//less chunks than workers
+	memset(visits, 0, sizeof(visits));
+	executions = 0;
+	cuParallelThreadPoolFor(pool, markChunks, va, &loop, 2);
+	assert(visits[0] == 1 && visits[1] == 1 && visits[2] == 0);
+	assert(executions == 2);
+
+	//without a pool the calling thread does everything
+	memset(visits, 0, sizeof(visits));
+	executions = 0;
+	cuParallelThreadPoolFor(NULL, markChunks, va, &loop, 100);
+	for (int i=0; i<100; i++) {
+		assert(visits[i] == 1);
+	}
+	assert(executions == 1);
+
+	cuParallelThreadPoolDestroy(pool, NULL);
+}
+
 CuSuite* CuMultiTrheadingSuite() {
 	CuSuite* suite = CuSuiteNew();
 
@@ -221,5 +390,11 @@ CuSuite* CuMultiTrheadingSuite() {
 	SUITE_ADD_TEST(suite, test_multithreading_04);
 	SUITE_ADD_TEST(suite, test_multithreading_05);
 
+	SUITE_ADD_TEST(suite, test_threadPool_01);
+	SUITE_ADD_TEST(suite, test_threadPool_02);
+	SUITE_ADD_TEST(suite, test_threadPool_03);
+	SUITE_ADD_TEST(suite, test_threadPool_04);
+	SUITE_ADD_TEST(suite, test_threadPool_05);
+
 	return suite;
 }
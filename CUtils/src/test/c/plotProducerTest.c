@@ -13,6 +13,26 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include "csvReader.h"
+
+/**
+ * @param[in] filePath the file to read
+ * @return the content of the file. Needs to be freed
+ */
+static char* readWholeFile(const char* filePath) {
+	FILE* f = fopen(filePath, "r");
+	assert(f != NULL);
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	rewind(f);
+	char* retVal = malloc(size + 1);
+	assert(fread(retVal, sizeof(char), size, f) == size);
+	retVal[size] = '\0';
+	fclose(f);
+	return retVal;
+}
 
 
 void testPlot2DProducer01(CuTest* tc) {
@@ -253,6 +273,88 @@ void testPlot2DProducer11(CuTest* tc) {
 	}
 }
 
+///binary data files contain the same points of the textual ones
+void testPlot2DProducer12(CuTest* tc) {
+	plot_2d_helper* text = cuPlot2DHelperNew("testPlot2DProducer12Text");
+	plot_2d_helper* binary = cuPlot2DHelperNew("testPlot2DProducer12Binary");
+	cuPlot2DHelperSetBinaryData(binary, true);
+
+	cuPlot2DHelperAddSeries(text, "x/2", PS_LINES);
+	cuPlot2DHelperAddSeries(text, "x/4", PS_LINES);
+	cuPlot2DHelperAddSeries(binary, "x/2", PS_LINES);
+	cuPlot2DHelperAddSeries(binary, "x/4", PS_LINES);
+	cuPlot2DHelperCreateDataCSV(text, true);
+	cuPlot2DHelperCreateDataCSV(binary, true);
+
+	//more values than the buffer of the binary helper. The values can be represented exactly with 3 decimals
+	for (int i=0; i<100000; i++) {
+		cuPlot2DHelperAddPoints(text, i, (double[]){i / 2.0, i / 4.0});
+		cuPlot2DHelperAddPoint(binary, i, i / 2.0);
+		cuPlot2DHelperAddPoint(binary, i, i / 4.0);
+	}
+
+	cuPlot2DHelperPlot(text);
+	cuPlot2DHelperPlot(binary);
+	cuPlot2DHelperDestroy(text, NULL);
+	cuPlot2DHelperDestroy(binary, NULL);
+
+	char* textContent = readWholeFile("testPlot2DProducer12Text.plotdata.csv");
+	char* binaryContent = readWholeFile("testPlot2DProducer12Binary.plotdata.csv");
+	assert(strcmp(textContent, binaryContent) == 0);
+	free(textContent);
+	free(binaryContent);
+}
+
+///the downsampling keeps few points, but the peaks of every series are still there
+void testPlot2DProducer13(CuTest* tc) {
+	const int points = 1000000;
+	const int buckets = 100;
+	plot_2d_helper* helper = cuPlot2DHelperNew(__func__);
+	cuPlot2DHelperSetBinaryData(helper, true);
+	cuPlot2DHelperAddSeries(helper, "spike", PS_LINES);
+	cuPlot2DHelperAddSeries(helper, "-x", PS_LINES);
+	cuPlot2DHelperSetDownsampling(helper, buckets);
+	cuPlot2DHelperCreateDataCSV(helper, true);
+
+	for (int i=0; i<points; i++) {
+		cuPlot2DHelperAddPoints(helper, i, (double[]){i == 777777 ? 1000 : (i % 10), -i});
+	}
+
+	cuPlot2DHelperPlot(helper);
+	cuPlot2DHelperDestroy(helper, NULL);
+
+	csv_reader* reader = cuCSVReaderNew("testPlot2DProducer13.plotdata.csv");
+	int rows = cuCSVReaderGetRowsNumber(reader);
+	assert(rows > buckets / 2);
+	assert(rows <= buckets * 2 * 2);
+
+	double* xs = malloc(sizeof(double) * rows);
+	double* spikes = malloc(sizeof(double) * rows);
+	double* minus = malloc(sizeof(double) * rows);
+	assert(cuCSVReaderGetDoubleColumn(reader, 0, xs) == 0);
+	assert(cuCSVReaderGetDoubleColumn(reader, 1, spikes) == 0);
+	assert(cuCSVReaderGetDoubleColumn(reader, 2, minus) == 0);
+	bool spikeFound = false;
+	for (int i=0; i<rows; i++) {
+		if (i > 0) {
+			assert(xs[i - 1] < xs[i]);
+		}
+		assert(minus[i] == -xs[i]);
+		if (spikes[i] == 1000) {
+			assert(xs[i] == 777777);
+			spikeFound = true;
+		}
+	}
+	assert(spikeFound);
+	assert(xs[0] == 0);
+	assert(xs[rows - 1] == points - 1);
+
+	free(xs);
+	free(spikes);
+	free(minus);
+	cuCSVReaderDestroy(reader, NULL);
+}
+
 CuSuite* CuPlotProducerSuite() {
 	CuSuite* suite = CuSuiteNew();
 
@@ -267,6 +369,8 @@ CuSuite* CuPlotProducerSuite() {
 	SUITE_ADD_TEST(suite, testPlot2DProducer09);
 	SUITE_ADD_TEST(suite, testPlot2DProducer10);
 	SUITE_ADD_TEST(suite, testPlot2DProducer11);
+	SUITE_ADD_TEST(suite, testPlot2DProducer12);
+	SUITE_ADD_TEST(suite, testPlot2DProducer13);
 
 	return suite;
 }
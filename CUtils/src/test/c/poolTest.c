@@ -0,0 +1,271 @@
+/*
+ * poolTest.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: koldar
+ */
+
+#include "CuTest.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pool.h"
+#include "multithreading.h"
+#include "timeMeasurement.h"
+#include "log.h"
+
+typedef struct point {
+	int x;
+	int y;
+	int z;
+} point;
+
+static unsigned long hashPoint(const void* obj, const struct var_args* context) {
+	const point* p = obj;
+	return p->x * 31 + p->y;
+}
+
+///test acquire, release and statistics
+void test_pool_01(CuTest* tc) {
+	struct pool* p = cuPoolNew(point, 4, NULL);
+	point* points[10];
+
+	assert(cuPoolGetElementSize(p) == sizeof(point));
+	assert(cuPoolGetCapacity(p) == 0);
+	for (int i=0; i<10; i++) {
+		points[i] = cuPoolAcquire(p);
+		assert(((uintptr_t)points[i]) % 16 == 0);
+		points[i]->x = i;
+	}
+	for (int i=0; i<10; i++) {
+		for (int j=i+1; j<10; j++) {
+			assert(points[i] != points[j]);
+		}
+		assert(points[i]->x == i);
+	}
+	assert(cuPoolGetInUse(p) == 10);
+	assert(cuPoolGetHighWaterMark(p) == 10);
+	//4, then 4 again, then doubled
+	assert(cuPoolGetCapacity(p) == 16);
+
+	//released elements are reused
+	cuPoolRelease(p, points[3]);
+	cuPoolRelease(p, points[7]);
+	assert(cuPoolGetInUse(p) == 8);
+	assert(cuPoolGetHighWaterMark(p) == 10);
+	assert(cuPoolAcquire(p) == points[7]);
+	assert(cuPoolAcquire(p) == points[3]);
+	assert(cuPoolGetCapacity(p) == 16);
+
+	cuPoolClear(p);
+	assert(cuPoolGetInUse(p) == 0);
+	assert(cuPoolGetHighWaterMark(p) == 0);
+	assert(cuPoolGetCapacity(p) == 16);
+
+	cuPoolDestroy(p, NULL);
+}
+
+///test cuPoolReserve
+void test_pool_02(CuTest* tc) {
+	struct pool* p = cuPoolNew(point, 4, NULL);
+
+	cuPoolReserve(p, 100);
+	assert(cuPoolGetCapacity(p) == 100);
+	for (int i=0; i<60; i++) {
+		cuPoolAcquire(p);
+	}
+	//40 are still free
+	cuPoolReserve(p, 30);
+	assert(cuPoolGetCapacity(p) == 100);
+	cuPoolReserve(p, 50);
+	assert(cuPoolGetCapacity(p) == 110);
+	for (int i=0; i<50; i++) {
+		cuPoolAcquire(p);
+	}
+	assert(cuPoolGetCapacity(p) == 110);
+	assert(cuPoolGetHighWaterMark(p) == 110);
+
+	cuPoolDestroy(p, NULL);
+}
+
+///test the membership functions
+void test_pool_03(CuTest* tc) {
+	struct pool* p = cuPoolNew(point, 8, hashPoint);
+	point a = {1, 2, 3};
+	point b = {1, 2, 4};
+	point c = {2, 3, 4};
+
+	assert(!cuPoolHasItem(p, &a, NULL));
+	point* pa = cuPoolAddItem(p, &a, NULL);
+	assert(pa != &a);
+	assert(memcmp(pa, &a, sizeof(point)) == 0);
+	assert(cuPoolHasItem(p, &a, NULL));
+	//b has the same hash of a
+	assert(!cuPoolHasItem(p, &b, NULL));
+	point* pb = cuPoolAddItem(p, &b, NULL);
+	assert(pb != pa);
+	assert(cuPoolAddItem(p, &c, NULL) != pb);
+	assert(cuPoolAddItem(p, &a, NULL) == pa);
+	assert(cuPoolGetInUse(p) == 3);
+
+	assert(cuPoolRemoveItem(p, &a, NULL));
+	assert(!cuPoolRemoveItem(p, &a, NULL));
+	assert(!cuPoolHasItem(p, &a, NULL));
+	assert(cuPoolHasItem(p, &b, NULL));
+	assert(cuPoolGetInUse(p) == 2);
+
+	cuPoolClear(p);
+	assert(!cuPoolHasItem(p, &b, NULL));
+	assert(!cuPoolHasItem(p, &c, NULL));
+
+	cuPoolDestroy(p, NULL);
+
+	//without hash function the bytes are hashed
+	p = cuPoolNew(long, 8, NULL);
+	long value = 5;
+	cuPoolAddItem(p, &value, NULL);
+	assert(cuPoolHasItem(p, &value, NULL));
+	value = 6;
+	assert(!cuPoolHasItem(p, &value, NULL));
+	cuPoolDestroy(p, NULL);
+}
+
+struct release_job {
+	struct pool* p;
+	void** elements;
+	int size;
+	int next;
+};
+
+static enum thread_loop_state releaseElements(CU_NOTNULL const cu_thread* thread, const struct var_args* va) {
+	struct release_job* job = cuVarArgsGetItem(va, 0, struct release_job*);
+	int i;
+	while ((i = __sync_fetch_and_add(&job->next, 1)) < job->size) {
+		cuPoolRelease(job->p, job->elements[i]);
+	}
+	return TLS_STOP;
+}
+
+///test releasing elements from several threads
+void test_pool_04(CuTest* tc) {
+	const int elements = 20000;
+	struct release_job job = {cuPoolNew(point, 1024, NULL), malloc(sizeof(void*) * elements), elements, 0};
+
+	for (int i=0; i<elements; i++) {
+		job.elements[i] = cuPoolAcquire(job.p);
+	}
+	size_t capacity = cuPoolGetCapacity(job.p);
+
+	struct release_job* jobPtr = &job;
+	cuInitVarArgsOnStack(va, jobPtr);
+	cu_parallel_thread_pool* threads = cuParallelThreadPoolNew(4);
+	cu_future* futures[4];
+	for (int i=0; i<4; i++) {
+		futures[i] = cuParallelThreadPoolSubmit(threads, releaseElements, va);
+	}
+	for (int i=0; i<4; i++) {
+		cuFutureWait(futures[i], -1);
+		cuFutureDestroy(futures[i], NULL);
+	}
+	cuParallelThreadPoolDestroy(threads, NULL);
+
+	assert(cuPoolGetInUse(job.p) == 0);
+	//every element is back: acquiring them again does not grow the pool
+	for (int i=0; i<elements; i++) {
+		job.elements[i] = cuPoolAcquire(job.p);
+	}
+	assert(cuPoolGetCapacity(job.p) == capacity);
+
+	free(job.elements);
+	cuPoolDestroy(job.p, NULL);
+}
+
+///the elements released by other threads and not fetched yet by the owner do not count in the high water mark
+void test_pool_05(CuTest* tc) {
+	const int elements = 100;
+	struct release_job job = {cuPoolNew(point, 1024, NULL), malloc(sizeof(void*) * elements), 60, 0};
+
+	for (int i=0; i<elements; i++) {
+		job.elements[i] = cuPoolAcquire(job.p);
+	}
+	assert(cuPoolGetHighWaterMark(job.p) == 100);
+
+	struct release_job* jobPtr = &job;
+	cuInitVarArgsOnStack(va, jobPtr);
+	cu_parallel_thread_pool* threads = cuParallelThreadPoolNew(2);
+	cu_future* futures[2];
+	for (int i=0; i<2; i++) {
+		futures[i] = cuParallelThreadPoolSubmit(threads, releaseElements, va);
+	}
+	for (int i=0; i<2; i++) {
+		cuFutureWait(futures[i], -1);
+		cuFutureDestroy(futures[i], NULL);
+	}
+	cuParallelThreadPoolDestroy(threads, NULL);
+	assert(cuPoolGetInUse(job.p) == 40);
+
+	//the owner still has free elements of its own, so the remote ones are not fetched
+	for (int i=0; i<30; i++) {
+		cuPoolAcquire(job.p);
+	}
+	assert(cuPoolGetInUse(job.p) == 70);
+	assert(cuPoolGetHighWaterMark(job.p) == 100);
+	for (int i=0; i<40; i++) {
+		cuPoolAcquire(job.p);
+	}
+	assert(cuPoolGetHighWaterMark(job.p) == 110);
+
+	free(job.elements);
+	cuPoolDestroy(job.p, NULL);
+}
+
+///compare the pool with malloc
+void test_benchmarkPool(CuTest* tc) {
+	const int rounds = 200;
+	const int elements = 1000;
+	void* buffer[1000];
+	struct pool* p = cuPoolNew(point, elements, NULL);
+	cuPoolReserve(p, elements);
+
+	CU_PROFILE_TIME_CODE(withMalloc, TM_MICRO) {
+		for (int round=0; round<rounds; round++) {
+			for (int i=0; i<elements; i++) {
+				buffer[i] = malloc(sizeof(point));
+				((point*)buffer[i])->x = i;
+			}
+			for (int i=0; i<elements; i++) {
+				free(buffer[i]);
+			}
+		}
+	}
+	CU_PROFILE_TIME_CODE(withPool, TM_MICRO) {
+		for (int round=0; round<rounds; round++) {
+			for (int i=0; i<elements; i++) {
+				buffer[i] = cuPoolAcquire(p);
+				((point*)buffer[i])->x = i;
+			}
+			for (int i=0; i<elements; i++) {
+				cuPoolRelease(p, buffer[i]);
+			}
+		}
+	}
+
+	assert(cuPoolGetCapacity(p) == elements);
+	critical("%d acquire/release (us) | malloc: %ld pool: %ld", rounds * elements, withMalloc, withPool);
+	cuPoolDestroy(p, NULL);
+}
+
+CuSuite* CuPoolSuite() {
+	CuSuite* suite = CuSuiteNew();
+
+	SUITE_ADD_TEST(suite, test_pool_01);
+	SUITE_ADD_TEST(suite, test_pool_02);
+	SUITE_ADD_TEST(suite, test_pool_03);
+	SUITE_ADD_TEST(suite, test_pool_04);
+	SUITE_ADD_TEST(suite, test_pool_05);
+
+	SUITE_ADD_TEST(suite, test_benchmarkPool);
+
+	return suite;
+}
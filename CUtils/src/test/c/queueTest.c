@@ -12,7 +12,11 @@
 #include "priority_queue.h"
 #include "defaultFunctions.h"
 #include <stdint.h>
+#include <limits.h>
 #include "string_utils.h"
+#include "timeMeasurement.h"
+#include "log.h"
+#include <stdlib.h>
 
 
 void testQueue01(CuTest* tc) {
@@ -311,6 +315,203 @@ void test_cuQueueChangePriority_01(CuTest* tc) {
 	}
 }
 
+///test a queue pops items in order for several arities
+void test_cuPriorityQueueNew_arity_01(CuTest* tc) {
+	const int n = 1000;
+	long* priorities = malloc(sizeof(long) * n);
+
+	srand(0);
+	for (int i=0; i<n; i++) {
+		priorities[i] = rand() % 100;
+	}
+
+	for (unsigned int arity=2; arity<=8; arity++) {
+		priority_queue* q = cuPriorityQueueNew(cuPayloadFunctionsIntValue(), arity);
+		assert(cuPriorityQueueGetArity(q) == arity);
+		for (int i=0; i<n; i++) {
+			cuPriorityQueueAddItem(q, CU_CAST_INT2PTR(i), priorities[i]);
+		}
+		assert(cuPriorityQueueGetSize(q) == n);
+
+		long previous = -1;
+		while (!cuPriorityQueueIsEmpty(q)) {
+			int i = CU_CAST_PTR2INT(cuPriorityQueuePopItem(q, void*));
+			assert(priorities[i] >= previous);
+			previous = priorities[i];
+		}
+		cuPriorityQueueDestroy(q, NULL);
+	}
+
+	free(priorities);
+}
+
+///test change priority and removal without the user-provided lookup functions
+void test_cuPriorityQueueRemoveItem_01(CuTest* tc) {
+	priority_queue* q = cuPriorityQueueNew(cuPayloadFunctionsIntValue());
+
+	for (int i=1; i<=100; i++) {
+		cuPriorityQueueAddItem(q, CU_CAST_INT2PTR(i), i);
+	}
+
+	assert(cuPriorityQueueChangePriority(q, CU_CAST_INT2PTR(50), 0) == 50);
+	assert(CU_CAST_PTR2INT(cuPriorityQueuePeekItem(q, void*)) == 50);
+	assert(cuPriorityQueueChangePriority(q, CU_CAST_INT2PTR(50), 200) == 0);
+	assert(CU_CAST_PTR2INT(cuPriorityQueuePeekItem(q, void*)) == 1);
+
+	//remove all the odd items
+	for (int i=1; i<=100; i+=2) {
+		cuPriorityQueueRemoveItem(q, CU_CAST_INT2PTR(i));
+	}
+	assert(cuPriorityQueueGetSize(q) == 50);
+	assert(!cuPriorityQueueContainsItem1(q, CU_CAST_INT2PTR(1)));
+	assert(cuPriorityQueueContainsItem1(q, CU_CAST_INT2PTR(2)));
+
+	for (int i=2; i<=100; i+=2) {
+		if (i == 50) {
+			continue;
+		}
+		assert(CU_CAST_PTR2INT(cuPriorityQueuePopItem(q, void*)) == i);
+	}
+	assert(CU_CAST_PTR2INT(cuPriorityQueuePopItem(q, void*)) == 50);
+	assert(cuPriorityQueueIsEmpty(q));
+
+	cuPriorityQueueDestroy(q, NULL);
+}
+
+///priorities outside the range of int
+void test_cuPriorityQueueChangePriority_02(CuTest* tc) {
+	const long big = ((long) INT_MAX) + 10;
+	priority_queue* q = cuPriorityQueueNew(cuPayloadFunctionsIntValue());
+
+	cuPriorityQueueAddItem(q, CU_CAST_INT2PTR(1), big);
+	cuPriorityQueueAddItem(q, CU_CAST_INT2PTR(2), big + 1);
+	cuPriorityQueueAddItem(q, CU_CAST_INT2PTR(3), big + 2);
+	assert(CU_CAST_PTR2INT(cuPriorityQueuePeekItem(q, void*)) == 1);
+
+	//the truncated priorities would be negative
+	assert(cuPriorityQueueChangePriority(q, CU_CAST_INT2PTR(1), big + 5) == big);
+	assert(CU_CAST_PTR2INT(cuPriorityQueuePeekItem(q, void*)) == 2);
+	assert(cuPriorityQueueChangePriority(q, CU_CAST_INT2PTR(3), big - 1) == big + 2);
+	assert(CU_CAST_PTR2INT(cuPriorityQueuePeekItem(q, void*)) == 3);
+	assert(cuPriorityQueueChangePriority(q, CU_CAST_INT2PTR(2), 2 * big) == big + 1);
+
+	assert(CU_CAST_PTR2INT(cuPriorityQueuePopItem(q, void*)) == 3);
+	assert(CU_CAST_PTR2INT(cuPriorityQueuePopItem(q, void*)) == 1);
+	assert(CU_CAST_PTR2INT(cuPriorityQueuePopItem(q, void*)) == 2);
+
+	cuPriorityQueueDestroy(q, NULL);
+}
+
+
+struct grid_vertex {
+	int id;
+	long distance;
+	bool closed;
+	struct priority_queue_cell* inQueue;
+};
+
+#define CU_FUNCTION_POINTER_queue_findItem_priority_queue_cell_gridVertexGetQueueCell_priority_queueConstPtr_voidConstPtr CU_QUEUE_FINDITEM_ID
+static struct priority_queue_cell* gridVertexGetQueueCell(priority_queue* q, CU_NOTNULL struct grid_vertex* v) {
+	return v->inQueue;
+}
+
+#define CU_FUNCTION_POINTER_queue_addItem_void_gridVertexAddItem_priority_queuePtr_voidPtr_priority_queue_cellPtr CU_QUEUE_ADDITEM_ID
+static void gridVertexAddItem(CU_NOTNULL priority_queue* q, CU_NOTNULL struct grid_vertex* v, CU_NOTNULL struct priority_queue_cell* qc) {
+	v->inQueue = qc;
+}
+
+/**
+ * weight of the edge between 2 adjacent cells of the grid: a deterministic number in [1,9]
+ */
+static long gridWeight(int a, int b) {
+	unsigned int x = (unsigned int)(a * 73856093) ^ (unsigned int)(b * 19349663);
+	return 1 + (x % 9);
+}
+
+/**
+ * Run Dijkstra on a 4-connected grid using the queue for the frontier
+ *
+ * @return the number of queue operations performed
+ */
+static long dijkstraOnGrid(priority_queue* q, struct grid_vertex* vertices, int width, int height) {
+	long operations = 0;
+	for (int i=0; i<width*height; i++) {
+		vertices[i].id = i;
+		vertices[i].distance = -1;
+		vertices[i].closed = false;
+		vertices[i].inQueue = NULL;
+	}
+
+	vertices[0].distance = 0;
+	cuPriorityQueueAddItem(q, &vertices[0], 0);
+	operations++;
+	while (!cuPriorityQueueIsEmpty(q)) {
+		struct grid_vertex* v = cuPriorityQueuePopItem(q, struct grid_vertex*);
+		operations++;
+		v->closed = true;
+		int x = v->id % width;
+		int y = v->id / width;
+		int neighbours[4] = {
+				x > 0 ? v->id - 1 : -1,
+				x < width - 1 ? v->id + 1 : -1,
+				y > 0 ? v->id - width : -1,
+				y < height - 1 ? v->id + width : -1
+		};
+		for (int i=0; i<4; i++) {
+			if (neighbours[i] < 0) {
+				continue;
+			}
+			struct grid_vertex* n = &vertices[neighbours[i]];
+			if (n->closed) {
+				continue;
+			}
+			long distance = v->distance + gridWeight(v->id, n->id);
+			if (n->distance < 0) {
+				n->distance = distance;
+				cuPriorityQueueAddItem(q, n, distance);
+				operations++;
+			} else if (distance < n->distance) {
+				n->distance = distance;
+				cuPriorityQueueChangePriority(q, n, distance);
+				operations++;
+			}
+		}
+	}
+
+	return operations;
+}
+
+/**
+ * Dijkstra trace: insert, pop-min and decrease-key on a 4-connected grid
+ *
+ * Only the array heap is timed, with and without the user-provided lookup functions: the pointer tree it replaced is not in the tree anymore,
+ * so this is not a comparison against it
+ */
+void test_benchmarkDijkstra(CuTest* tc) {
+	const int width = 300;
+	const int height = 300;
+	struct grid_vertex* vertices = malloc(sizeof(struct grid_vertex) * width * height);
+	long operations;
+
+	priority_queue* q = cuPriorityQueueNew(cuPayloadFunctionsDefault());
+	CU_PROFILE_TIME_CODE(elapsed, TM_MICRO) {
+		operations = dijkstraOnGrid(q, vertices, width, height);
+	}
+	long distance = vertices[width*height - 1].distance;
+	cuPriorityQueueDestroy(q, NULL);
+
+	//same trace, but with the user-provided lookup functions
+	q = cuPriorityQueueNew(cuPayloadFunctionsDefault());
+	cuPriorityQueueEnableFastContainOperation(q, CU_QUEUE_AS_FINDITEM(gridVertexGetQueueCell), CU_QUEUE_AS_ADDITEM(gridVertexAddItem));
+	CU_PROFILE_TIME_CODE(elapsedWithCallbacks, TM_MICRO) {
+		dijkstraOnGrid(q, vertices, width, height);
+	}
+	assert(vertices[width*height - 1].distance == distance);
+	cuPriorityQueueDestroy(q, NULL);
+
+	critical("dijkstra on %dx%d grid: %ld queue operations in %ld us (%ld us with user lookup functions)", width, height, operations, elapsed, elapsedWithCallbacks);
+	free(vertices);
+}
 
 CuSuite* CuQueueSuite() {
 	CuSuite* suite = CuSuiteNew();
@@ -325,8 +526,11 @@ CuSuite* CuQueueSuite() {
 	SUITE_ADD_TEST(suite, test_find_01);
 	SUITE_ADD_TEST(suite, test_cuQueueAddItem1_01);
 	SUITE_ADD_TEST(suite, test_cuQueueChangePriority_01);
+	SUITE_ADD_TEST(suite, test_cuPriorityQueueNew_arity_01);
+	SUITE_ADD_TEST(suite, test_cuPriorityQueueRemoveItem_01);
+	SUITE_ADD_TEST(suite, test_cuPriorityQueueChangePriority_02);
 
-
+	SUITE_ADD_TEST(suite, test_benchmarkDijkstra);
 
 	return suite;
 }
@@ -0,0 +1,133 @@
+/*
+ * radixHeapTest.c
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: koldar
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include "CuTest.h"
+#include "radix_heap.h"
+#include "log.h"
+
+static int evaluateInteger(const int _x) {
+	return 10 + CU_CAST_PTR2INT(_x);
+}
+
+static int compareInts(const void* a, const void* b) {
+	return *(const int*)a - *(const int*)b;
+}
+
+void test_cuRadixHeap_01(CuTest* tc) {
+	int_radix_heap* h = cuRadixHeapNew(cuPayloadFunctionsIntValue(), CU_AS_EVALUATOR(evaluateInteger), NULL);
+
+	assert(cuRadixHeapIsEmpty(h));
+	assert(cuRadixHeapPeekItem(h, void*) == NULL);
+	assert(cuRadixHeapPopItem(h, void*) == NULL);
+
+	cuRadixHeapAddItem(h, CU_CAST_INT2PTR(3));
+	cuRadixHeapAddItem(h, CU_CAST_INT2PTR(1));
+	cuRadixHeapAddItem(h, CU_CAST_INT2PTR(2));
+	assert(cuRadixHeapGetSize(h) == 3);
+
+	assert(cuRadixHeapPeekItem(h, intptr_t) == 1);
+	assert(cuRadixHeapPeekEvaluation(h) == 11);
+	assert(cuRadixHeapGetSize(h) == 3);
+	assert(cuRadixHeapPopItem(h, intptr_t) == 1);
+	//items with the same evaluation of the last popped one can still be added
+	cuRadixHeapAddItem(h, CU_CAST_INT2PTR(1));
+	assert(cuRadixHeapPopItem(h, intptr_t) == 1);
+	assert(cuRadixHeapPopItem(h, intptr_t) == 2);
+	assert(cuRadixHeapPopItem(h, intptr_t) == 3);
+	assert(cuRadixHeapIsEmpty(h));
+
+	cuRadixHeapDestroy(h, NULL);
+}
+
+///negative evaluations and clear
+void test_cuRadixHeap_02(CuTest* tc) {
+	radix_heap* h = cuRadixHeapNew(cuPayloadFunctionsIntValue());
+
+	cuRadixHeapAddItemWithEvaluation(h, CU_CAST_INT2PTR(1), 5);
+	cuRadixHeapAddItemWithEvaluation(h, CU_CAST_INT2PTR(2), -7);
+	cuRadixHeapAddItemWithEvaluation(h, CU_CAST_INT2PTR(3), 0);
+	cuRadixHeapAddItemWithEvaluation(h, CU_CAST_INT2PTR(4), -2000000000);
+
+	assert(cuRadixHeapPeekEvaluation(h) == -2000000000);
+	assert(cuRadixHeapPopItem(h, intptr_t) == 4);
+	assert(cuRadixHeapPeekEvaluation(h) == -7);
+	assert(cuRadixHeapPopItem(h, intptr_t) == 2);
+	assert(cuRadixHeapPopItem(h, intptr_t) == 3);
+
+	cuRadixHeapClear(h);
+	assert(cuRadixHeapIsEmpty(h));
+	//after a clear, the heap is not monotone anymore
+	cuRadixHeapAddItemWithEvaluation(h, CU_CAST_INT2PTR(5), -10);
+	assert(cuRadixHeapPopItem(h, intptr_t) == 5);
+
+	cuRadixHeapDestroy(h, NULL);
+}
+
+///a random monotone workload: we simulate a Dijkstra where each extracted item generates new items with greater evaluations
+void test_cuRadixHeap_03(CuTest* tc) {
+	radix_heap* h = cuRadixHeapNew(cuPayloadFunctionsIntValue());
+	const int n = 100000;
+	unsigned int seed = 5;
+	int added = 0;
+	int popped = 0;
+	int last = 0;
+
+	cuRadixHeapAddItemWithEvaluation(h, CU_CAST_INT2PTR(0), 0);
+	added++;
+	while (!cuRadixHeapIsEmpty(h)) {
+		int evaluation = cuRadixHeapPeekEvaluation(h);
+		int item = CU_CAST_PTR2INT(cuRadixHeapPopItem(h, void*));
+		//items store their evaluation
+		assert(item == evaluation);
+		assert(evaluation >= last);
+		last = evaluation;
+		popped++;
+
+		for (int i=0; i<3 && added < n; i++) {
+			int next = evaluation + (rand_r(&seed) % 1000);
+			cuRadixHeapAddItemWithEvaluation(h, CU_CAST_INT2PTR(next), next);
+			added++;
+		}
+	}
+	assert(popped == n);
+
+	cuRadixHeapDestroy(h, NULL);
+}
+
+///monotone workload compared with a sorted array
+void test_cuRadixHeap_04(CuTest* tc) {
+	radix_heap* h = cuRadixHeapNew(cuPayloadFunctionsIntValue());
+	const int n = 10000;
+	int values[n];
+	unsigned int seed = 7;
+
+	for (int i=0; i<n; i++) {
+		values[i] = rand_r(&seed) % 100000 - 50000;
+		cuRadixHeapAddItemWithEvaluation(h, CU_CAST_INT2PTR(values[i]), values[i]);
+	}
+	qsort(values, n, sizeof(int), compareInts);
+	for (int i=0; i<n; i++) {
+		assert(cuRadixHeapPeekEvaluation(h) == values[i]);
+		assert(CU_CAST_PTR2INT(cuRadixHeapPopItem(h, void*)) == values[i]);
+	}
+	assert(cuRadixHeapIsEmpty(h));
+
+	cuRadixHeapDestroy(h, NULL);
+}
+
+CuSuite* CuRadixHeapSuite() {
+	CuSuite* suite = CuSuiteNew();
+
+	SUITE_ADD_TEST(suite, test_cuRadixHeap_01);
+	SUITE_ADD_TEST(suite, test_cuRadixHeap_02);
+	SUITE_ADD_TEST(suite, test_cuRadixHeap_03);
+	SUITE_ADD_TEST(suite, test_cuRadixHeap_04);
+
+	return suite;
+}
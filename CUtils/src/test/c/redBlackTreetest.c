@@ -189,6 +189,39 @@ void testRedBlackTree07(CuTest* tc) {
 	cuRedBlackTreeDestroyWithElements(tree, NULL);
 }
 
+///remove many items in random order: exercises every case of the removal fix up
+void testRedBlackTree08(CuTest* tc) {
+	rb_tree* tree = cuRedBlackTreeNew(cuPayloadFunctionsIntValue());
+	const int n = 1000;
+	int keys[n];
+	unsigned int seed = 11;
+
+	for (int i=0; i<n; i++) {
+		keys[i] = i;
+	}
+	for (int i=n-1; i>0; i--) {
+		int j = rand_r(&seed) % (i + 1);
+		int tmp = keys[i];
+		keys[i] = keys[j];
+		keys[j] = tmp;
+	}
+	for (int i=0; i<n; i++) {
+		cuRedBlackTreeAddItem(tree, CU_CAST_INT2PTR(keys[i]));
+	}
+	for (int i=n-1; i>0; i--) {
+		int j = rand_r(&seed) % (i + 1);
+		int tmp = keys[i];
+		keys[i] = keys[j];
+		keys[j] = tmp;
+	}
+	for (int i=0; i<n; i++) {
+		assert(cuRedBlackTreeRemoveItem(tree, CU_CAST_INT2PTR(keys[i])));
+		assert(!cuRedBlackTreeContainsItem(tree, CU_CAST_INT2PTR(keys[i])));
+	}
+	assert(cuRedBlackTreeIsEmpty(tree));
+
+	cuRedBlackTreeDestroy(tree, NULL);
+}
 
 CuSuite* CuRedBlackTreeSuite() {
 	CuSuite* suite = CuSuiteNew();
@@ -200,6 +233,7 @@ CuSuite* CuRedBlackTreeSuite() {
 	SUITE_ADD_TEST(suite, testRedBlackTree05);
 	SUITE_ADD_TEST(suite, testRedBlackTree06);
 	SUITE_ADD_TEST(suite, testRedBlackTree07);
+	SUITE_ADD_TEST(suite, testRedBlackTree08);
 
 	return suite;
 }
@@ -12,6 +12,8 @@
 #include <string.h>
 #include "string_utils.h"
 #include "log.h"
+#include "multithreading.h"
+#include "timeMeasurement.h"
 
 ///Test simple regex
 void testRegex01(CuTest* tc) {
@@ -90,6 +92,134 @@ void testRegex07(CuTest* tc) {
 	assert(r == true);
 }
 
+//test compiled regex
+void testRegex08(CuTest* tc) {
+	cu_regex* regex = cuRegularExpressionCompile("!" CU_RE_CG(CU_RE_WORD) "!" CU_RE_CG("x*"));
+	regmatch_t groups[3];
+	char buffer[20];
+
+	assert(cuRegularExpressionGetGroupsNumber(regex) == 2);
+	assert(isStrEqual(cuRegularExpressionGetPattern(regex), "!" CU_RE_CG(CU_RE_WORD) "!" CU_RE_CG("x*")));
+	assert(!cuRegularExpressionExecute(regex, "ciao Mondo", 3, groups));
+	assert(cuRegularExpressionExecute(regex, "ciao !Mondo!", 0, NULL));
+	assert(cuRegularExpressionExecute(regex, "ciao !Mondo!", 3, groups));
+	assert(cuRegularExpressionGetGroup("ciao !Mondo!", groups, 0, buffer, 20) == 7);
+	assert(isStrEqual(buffer, "!Mondo!"));
+	assert(cuRegularExpressionGetGroup("ciao !Mondo!", groups, 1, buffer, 20) == 5);
+	assert(isStrEqual(buffer, "Mondo"));
+	assert(cuRegularExpressionGetGroup("ciao !Mondo!", groups, 2, buffer, 20) == 0);
+	assert(isStrEqual(buffer, ""));
+	//truncation
+	assert(cuRegularExpressionGetGroup("ciao !Mondo!", groups, 1, buffer, 3) == 5);
+	assert(isStrEqual(buffer, "Mo"));
+
+	cuRegularExpressionDestroy(regex, NULL);
+}
+
+//test the cache
+void testRegex09(CuTest* tc) {
+	cuRegularExpressionCacheClear();
+	cuRegularExpressionCacheSetCapacity(2);
+
+	cu_regex* a = cuRegularExpressionCacheGet("a*b");
+	assert(cuRegularExpressionCacheGetMisses() == 1);
+	assert(cuRegularExpressionCacheGet("a*b") == a);
+	cuRegularExpressionDestroy(a, NULL);
+	assert(cuRegularExpressionCacheGetHits() == 1);
+	assert(cuRegularExpressionIsSatisfying("aab", "b$"));
+	assert(cuRegularExpressionCacheGetSize() == 2);
+
+	//"a*b" is the least recently used
+	assert(cuRegularExpressionIsSatisfying("aab", "c*"));
+	assert(cuRegularExpressionCacheGetSize() == 2);
+	assert(cuRegularExpressionCacheGetMisses() == 3);
+	//a is still valid after the eviction
+	assert(cuRegularExpressionExecute(a, "aab", 0, NULL));
+	assert(cuRegularExpressionIsSatisfying("aab", "a*b"));
+	assert(cuRegularExpressionCacheGetMisses() == 4);
+	cuRegularExpressionDestroy(a, NULL);
+
+	//"c*" is the most recent one
+	assert(cuRegularExpressionIsSatisfying("aab", "c*"));
+	assert(cuRegularExpressionCacheGetHits() == 2);
+
+	//no cache at all
+	cuRegularExpressionCacheSetCapacity(0);
+	assert(cuRegularExpressionCacheGetSize() == 0);
+	assert(cuRegularExpressionIsSatisfying("aab", "c*"));
+	assert(cuRegularExpressionCacheGetSize() == 0);
+
+	cuRegularExpressionCacheSetCapacity(CU_REGEX_CACHE_DEFAULT_CAPACITY);
+	cuRegularExpressionCacheClear();
+	assert(cuRegularExpressionCacheGetHits() == 0);
+}
+
+static enum thread_loop_state applyRegexes(CU_NOTNULL const cu_thread* thread, const struct var_args* va) {
+	static const char* patterns[] = {"o[0-9]*r", "H" CU_RE_CG("e*") "l", "!$", "^Hello"};
+	for (int i=0; i<2000; i++) {
+		const char *const * groups = NULL;
+		assert(cuRegularExpressionApply("Hello wo123rld!", patterns[i % 4], i % 4 == 1 ? 1 : 0, &groups));
+		if (i % 4 == 1) {
+			assert(isStrEqual(groups[1], "e"));
+			cuRegularExpressionDestroyGroupInfo(1, &groups);
+		}
+	}
+	return TLS_STOP;
+}
+
+//test the cache from several threads, with a cache smaller than the patterns used
+void testRegex10(CuTest* tc) {
+	cuRegularExpressionCacheClear();
+	cuRegularExpressionCacheSetCapacity(3);
+
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+	for (int i=0; i<4; i++) {
+		cuFutureDestroy(cuParallelThreadPoolSubmit(pool, applyRegexes, NULL), NULL);
+	}
+	cuParallelThreadPoolWaitAll(pool, -1);
+	cuParallelThreadPoolDestroy(pool, NULL);
+
+	assert(cuRegularExpressionCacheGetHits() + cuRegularExpressionCacheGetMisses() == 8000);
+	assert(cuRegularExpressionCacheGetSize() == 3);
+
+	cuRegularExpressionCacheSetCapacity(CU_REGEX_CACHE_DEFAULT_CAPACITY);
+	cuRegularExpressionCacheClear();
+}
+
+//compare compiling the regex at every call with the cache and with a precompiled regex
+void testRegexBenchmark(CuTest* tc) {
+	const int calls = 20000;
+	const char* pattern = "^" CU_RE_CG(CU_RE_NUMBER) CU_RE_SPACE CU_RE_CG(CU_RE_WORD) "$";
+	const char* line = "12345 hello";
+	int matches = 0;
+
+	cuRegularExpressionCacheClear();
+	CU_PROFILE_TIME_CODE(compiled, TM_MICRO) {
+		for (int i=0; i<calls; i++) {
+			cu_regex* regex = cuRegularExpressionCompile(pattern);
+			matches += cuRegularExpressionExecute(regex, line, 0, NULL);
+			cuRegularExpressionDestroy(regex, NULL);
+		}
+	}
+	CU_PROFILE_TIME_CODE(cached, TM_MICRO) {
+		for (int i=0; i<calls; i++) {
+			matches -= cuRegularExpressionIsSatisfying(line, pattern);
+		}
+	}
+	cu_regex* regex = cuRegularExpressionCompile(pattern);
+	CU_PROFILE_TIME_CODE(precompiled, TM_MICRO) {
+		for (int i=0; i<calls; i++) {
+			matches += cuRegularExpressionExecute(regex, line, 0, NULL);
+		}
+	}
+	cuRegularExpressionDestroy(regex, NULL);
+
+	assert(matches == calls);
+	assert(cuRegularExpressionCacheGetMisses() == 1);
+	critical("%d matches (us) | compile every time: %ld cache: %ld precompiled: %ld", calls, compiled, cached, precompiled);
+	cuRegularExpressionCacheClear();
+}
+
 CuSuite* CuRegexSuite() {
 	CuSuite* suite = CuSuiteNew();
 
@@ -100,6 +230,11 @@ CuSuite* CuRegexSuite() {
 	SUITE_ADD_TEST(suite, testRegex05);
 	SUITE_ADD_TEST(suite, testRegex06);
 	SUITE_ADD_TEST(suite, testRegex07);
+	SUITE_ADD_TEST(suite, testRegex08);
+	SUITE_ADD_TEST(suite, testRegex09);
+	SUITE_ADD_TEST(suite, testRegex10);
+
+	SUITE_ADD_TEST(suite, testRegexBenchmark);
 
 	return suite;
 }
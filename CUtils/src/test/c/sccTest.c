@@ -11,6 +11,7 @@
 #include "predsuccgraph.h"
 #include "log.h"
 #include "scc.h"
+#include "multithreading.h"
 
 void testSCC01(CuTest* tc) {
 	PredSuccGraph* g = cuPredSuccGraphNew();
@@ -187,6 +188,209 @@ void testSCC04(CuTest* tc) {
 	cuPredSuccGraphDestroyWithElements(g, NULL);
 }
 
+void testSCC05(CuTest* tc) {
+	excludeLogger("redBlackTree.c");
+
+	PredSuccGraph* g = cuPredSuccGraphNew();
+
+	cuPredSuccGraphAddNodeInGraphById(g, 0, NULL);
+	cuPredSuccGraphAddNodeInGraphById(g, 1, NULL);
+	cuPredSuccGraphAddNodeInGraphById(g, 2, NULL);
+	cuPredSuccGraphAddNodeInGraphById(g, 3, NULL);
+	cuPredSuccGraphAddNodeInGraphById(g, 4, NULL);
+
+	cuPredSuccGraphAddEdge(g, 0, 1, NULL);
+	cuPredSuccGraphAddEdge(g, 1, 2, NULL);
+	cuPredSuccGraphAddEdge(g, 2, 0, NULL);
+
+	cuPredSuccGraphAddEdge(g, 3, 4, NULL);
+	cuPredSuccGraphAddEdge(g, 4, 3, NULL);
+
+	cuPredSuccGraphAddEdge(g, 4, 2, NULL);
+	cuPredSuccGraphAddEdge(g, 4, 0, NULL);
+	cuPredSuccGraphAddEdge(g, 3, 1, NULL);
+
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+	scc_graph* sccGraph = cuStronglyConnectedComponentsGraphNew(g, edge_traverser_alwaysAccept, true, NULL, SCC_PARALLEL, pool);
+
+	assert(cuPredSuccGraphGetVertexNumber(cuStronglyConnectedComponentsGraphAsPredSuccGraph(sccGraph)) == 2);
+	assert(cuStronglyConnectedComponentsIsNodeInside(sccGraph, 0, 0));
+	assert(cuStronglyConnectedComponentsIsNodeInside(sccGraph, 1, 0));
+	assert(cuStronglyConnectedComponentsIsNodeInside(sccGraph, 2, 0));
+	assert(cuStronglyConnectedComponentsIsNodeInside(sccGraph, 3, 1));
+	assert(cuStronglyConnectedComponentsIsNodeInside(sccGraph, 4, 1));
+	assert(cuStronglyConnectedComponentsGetNodeWithMinimumId(cuStronglyConnectedComponentsGetComponentOfNode(sccGraph, 4))->id == 3);
+
+	int sum = 0;
+	int edgesNumber = 0;
+	Node* scc1 = cuPredSuccGraphGetNodeById(cuStronglyConnectedComponentsGraphAsPredSuccGraph(sccGraph), 1);
+	assert(cuStronglyConnectedComponentsGraphGetNumberOfNodes(scc1) == 2);
+	CU_ITERATE_OVER_HT_VALUES(scc1->successors, e, Edge*) {
+		edgesNumber += 1;
+		sum += cuListGetSize(getEdgePayloadAs(e, EdgeList*));
+	}
+	assert(edgesNumber == 1);
+	assert(sum == 3);
+
+	//an existing snapshot gives the same sccs
+	csr_graph* csr = cuPredSuccGraphFreeze(g);
+	scc_graph* fromSnapshot = cuStronglyConnectedComponentsGraphNew(g, edge_traverser_alwaysAccept, true, NULL, SCC_PARALLEL, pool, csr);
+	cuCSRGraphDestroy(csr, NULL);
+	assert(cuPredSuccGraphGetVertexNumber(cuStronglyConnectedComponentsGraphAsPredSuccGraph(fromSnapshot)) == 2);
+	for (NodeId id=0; id<5; id++) {
+		assert(cuStronglyConnectedComponentsIsNodeInside(fromSnapshot, id, id < 3 ? 0 : 1));
+	}
+	cuStronglyConnectedComponentsGraphDestroy(fromSnapshot, NULL);
+
+	cuStronglyConnectedComponentsGraphDestroy(sccGraph, NULL);
+	cuParallelThreadPoolDestroy(pool, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+static et_outcome edge_traverser_noEdgeFrom4(Edge* e) {
+	return e->source->id == 4 ? ET_TOIGNORE : ET_TOANALYZE;
+}
+
+/**
+ * Builds a graph with nodes from 0 to @c vertices - 1 and @c edges random edges (duplicates are dropped)
+ *
+ * @param[out] included a set containing every node whose id is not a multiple of 7
+ */
+static PredSuccGraph* newRandomGraph(int vertices, int edges, bool_ht** included) {
+	srand(0);
+
+	PredSuccGraph* g = cuPredSuccGraphNew();
+	for (int i=0; i<vertices; i++) {
+		cuPredSuccGraphAddNodeInGraphById(g, i, NULL);
+	}
+	for (int i=0; i<edges; i++) {
+		int source = rand() % vertices;
+		int sink = rand() % vertices;
+		if (!cuPredSuccGraphContainsEdgeInGraph(g, source, sink)) {
+			cuPredSuccGraphAddEdge(g, source, sink, NULL);
+		}
+	}
+	*included = cuHTNew();
+	for (int i=0; i<vertices; i++) {
+		if ((i % 7) != 0) {
+			cuHTAddItem(*included, i, CU_CAST_BOOL2PTR(true));
+		}
+	}
+	return g;
+}
+
+///the parallel algorithm builds the same sccs of Tarjan, with the traverser and the included nodes
+void testSCC06(CuTest* tc) {
+	excludeLogger("redBlackTree.c");
+	const int vertices = 900;
+	bool_ht* included = NULL;
+	PredSuccGraph* g = newRandomGraph(vertices, vertices, &included);
+
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+	scc_graph* expected = cuStronglyConnectedComponentsGraphNew(g, edge_traverser_noEdgeFrom4, true, included);
+	scc_graph* actual = cuStronglyConnectedComponentsGraphNew(g, edge_traverser_noEdgeFrom4, true, included, SCC_PARALLEL, pool);
+
+	PredSuccGraph* expectedSccs = cuStronglyConnectedComponentsGraphAsPredSuccGraph(expected);
+	PredSuccGraph* actualSccs = cuStronglyConnectedComponentsGraphAsPredSuccGraph(actual);
+	assert(cuPredSuccGraphGetVertexNumber(expectedSccs) == cuPredSuccGraphGetVertexNumber(actualSccs));
+	assert(cuPredSuccGraphGetEdgesNumber(expectedSccs) == cuPredSuccGraphGetEdgesNumber(actualSccs));
+	for (int i=0; i<vertices; i++) {
+		scc* s = cuStronglyConnectedComponentsGetComponentOfNode(actual, i);
+		if ((i % 7) == 0) {
+			assert(s == NULL);
+			continue;
+		}
+		assert(cuStronglyConnectedComponentsGraphGetNumberOfNodes(s) == cuStronglyConnectedComponentsGraphGetNumberOfNodes(cuStronglyConnectedComponentsGetComponentOfNode(expected, i)));
+		for (int j=i+1; j<vertices; j+=13) {
+			if ((j % 7) == 0) {
+				continue;
+			}
+			bool expectedSame = cuStronglyConnectedComponentsGetComponentOfNode(expected, i) == cuStronglyConnectedComponentsGetComponentOfNode(expected, j);
+			assert(expectedSame == (s == cuStronglyConnectedComponentsGetComponentOfNode(actual, j)));
+		}
+	}
+
+	cuStronglyConnectedComponentsGraphDestroy(expected, NULL);
+	cuStronglyConnectedComponentsGraphDestroy(actual, NULL);
+	cuParallelThreadPoolDestroy(pool, NULL);
+	cuHTDestroy(included, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+void testSCC07(CuTest* tc) {
+	excludeLogger("redBlackTree.c");
+	const int vertices = 900;
+	bool_ht* included = NULL;
+	PredSuccGraph* g = newRandomGraph(vertices, 2*vertices, &included);
+
+	for (int run=0; run<2; run++) {
+		scc_graph* expected = cuStronglyConnectedComponentsGraphNew(g, edge_traverser_noEdgeFrom4, true, run == 0 ? NULL : included);
+		scc_graph* actual = cuStronglyConnectedComponentsGraphNew(g, edge_traverser_noEdgeFrom4, true, run == 0 ? NULL : included, SCC_ITERATIVE_TARJAN);
+
+		PredSuccGraph* expectedSccs = cuStronglyConnectedComponentsGraphAsPredSuccGraph(expected);
+		PredSuccGraph* actualSccs = cuStronglyConnectedComponentsGraphAsPredSuccGraph(actual);
+		assert(cuPredSuccGraphGetVertexNumber(expectedSccs) == cuPredSuccGraphGetVertexNumber(actualSccs));
+		assert(cuPredSuccGraphGetEdgesNumber(expectedSccs) == cuPredSuccGraphGetEdgesNumber(actualSccs));
+		for (int i=0; i<vertices; i++) {
+			scc* expectedScc = cuStronglyConnectedComponentsGetComponentOfNode(expected, i);
+			scc* actualScc = cuStronglyConnectedComponentsGetComponentOfNode(actual, i);
+			if (expectedScc == NULL) {
+				assert(actualScc == NULL);
+				continue;
+			}
+			//the sccs are numbered in the same way
+			assert(expectedScc->id == actualScc->id);
+			assert(cuStronglyConnectedComponentsGraphGetNumberOfNodes(expectedScc) == cuStronglyConnectedComponentsGraphGetNumberOfNodes(actualScc));
+		}
+		CU_ITERATE_OVER_HT_VALUES(expectedSccs->nodes, n, Node*) {
+			CU_ITERATE_OVER_HT_VALUES(n->successors, e, Edge*) {
+				Edge* actualEdge = cuPredSuccGraphGetEdgeInGraph(actualSccs, e->source->id, e->sink->id);
+				assert(actualEdge != NULL);
+				assert(cuListGetSize(getEdgePayloadAs(e, EdgeList*)) == cuListGetSize(getEdgePayloadAs(actualEdge, EdgeList*)));
+			}
+		}
+
+		cuStronglyConnectedComponentsGraphDestroy(expected, NULL);
+		cuStronglyConnectedComponentsGraphDestroy(actual, NULL);
+	}
+
+	cuHTDestroy(included, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+void testSCC08(CuTest* tc) {
+	excludeLogger("redBlackTree.c");
+
+	//a single cycle far deeper than the recursive tarjan could handle. Ids are sparse, so the nodes need to be remapped
+	const int vertices = 100000;
+	PredSuccGraph* g = cuPredSuccGraphNew();
+	for (int i=0; i<vertices; i++) {
+		cuPredSuccGraphAddNodeInGraphById(g, 3*i + 5, NULL);
+	}
+	for (int i=0; i<vertices; i++) {
+		cuPredSuccGraphAddEdge(g, 3*i + 5, 3*((i + 1) % vertices) + 5, NULL);
+	}
+	//a tail leading into the cycle
+	cuPredSuccGraphAddNodeInGraphById(g, 1, NULL);
+	cuPredSuccGraphAddNodeInGraphById(g, 2, NULL);
+	cuPredSuccGraphAddEdge(g, 1, 2, NULL);
+	cuPredSuccGraphAddEdge(g, 2, 5 + 3*(vertices/2), NULL);
+
+	scc_graph* sccGraph = cuStronglyConnectedComponentsGraphNew(g, edge_traverser_alwaysAccept, true, NULL, SCC_ITERATIVE_TARJAN);
+
+	assert(cuPredSuccGraphGetVertexNumber(cuStronglyConnectedComponentsGraphAsPredSuccGraph(sccGraph)) == 3);
+	assert(cuPredSuccGraphGetEdgesNumber(cuStronglyConnectedComponentsGraphAsPredSuccGraph(sccGraph)) == 2);
+	scc* cycle = cuStronglyConnectedComponentsGetComponentOfNode(sccGraph, 5);
+	assert(cuStronglyConnectedComponentsGraphGetNumberOfNodes(cycle) == vertices);
+	assert(cycle->id == 0);
+	assert(cuStronglyConnectedComponentsGetComponentOfNode(sccGraph, 2)->id == 1);
+	assert(cuStronglyConnectedComponentsGetComponentOfNode(sccGraph, 1)->id == 2);
+	assert(cuStronglyConnectedComponentsGetNodeWithMinimumId(cycle)->id == 5);
+
+	cuStronglyConnectedComponentsGraphDestroy(sccGraph, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
 CuSuite* CuSCCSuite() {
 	CuSuite* suite = CuSuiteNew();
 
@@ -194,6 +398,10 @@ CuSuite* CuSCCSuite() {
 	SUITE_ADD_TEST(suite, testSCC02);
 	SUITE_ADD_TEST(suite, testSCC03);
 	SUITE_ADD_TEST(suite, testSCC04);
+	SUITE_ADD_TEST(suite, testSCC05);
+	SUITE_ADD_TEST(suite, testSCC06);
+	SUITE_ADD_TEST(suite, testSCC07);
+	SUITE_ADD_TEST(suite, testSCC08);
 
 
 	return suite;
@@ -11,6 +11,7 @@
 #include "simple_loops_computer.h"
 #include "log.h"
 #include "defaultFunctions.h"
+#include "multithreading.h"
 
 ///no loops
 void testSimpleLoopComputer01(CuTest* tc) {
@@ -234,6 +235,155 @@ void testSimpleLoopComputer04(CuTest* tc) {
 	cuPredSuccGraphDestroyWithElements(g, NULL);
 }
 
+/**
+ * Count the loops by length and check that each of them is a loop of the graph starting from its minimum node
+ */
+static bool countLoopsByLength(Node* const* loop, unsigned int length, const struct var_args* context) {
+	int* loopsByLength = cuVarArgsGetItem(context, 0, int*);
+	for (unsigned int i=0; i<length; i++) {
+		assert(loop[0]->id <= loop[i]->id);
+		assert(_cuPredSuccGraphGetEdge(loop[i], loop[(i + 1) % length]) != NULL);
+	}
+	loopsByLength[length] += 1;
+	return true;
+}
+
+static bool stopAtFirstLoop(Node* const* loop, unsigned int length, const struct var_args* context) {
+	return false;
+}
+
+static et_outcome edge_traverser_no2To0(Edge* e) {
+	if (e->source->id == 2 && e->sink->id == 0) {
+		return ET_TOIGNORE;
+	}
+	return ET_TOANALYZE;
+}
+
+///test graph in https://youtu.be/johyrWospv0, enumerated in parallel
+void testSimpleLoopComputer05(CuTest* tc) {
+	PredSuccGraph* g = cuPredSuccGraphNew();
+
+	for (NodeId i=0; i<9; i++) {
+		cuPredSuccGraphAddNodeInGraphById(g, i, NULL);
+	}
+
+	cuPredSuccGraphAddEdge(g, 0, 1, NULL);
+	cuPredSuccGraphAddEdge(g, 0, 4, NULL);
+	cuPredSuccGraphAddEdge(g, 0, 7, NULL);
+	cuPredSuccGraphAddEdge(g, 1, 2, NULL);
+	cuPredSuccGraphAddEdge(g, 1, 8, NULL);
+	cuPredSuccGraphAddEdge(g, 1, 6, NULL);
+	cuPredSuccGraphAddEdge(g, 2, 1, NULL);
+	cuPredSuccGraphAddEdge(g, 2, 0, NULL);
+	cuPredSuccGraphAddEdge(g, 2, 5, NULL);
+	cuPredSuccGraphAddEdge(g, 2, 3, NULL);
+	cuPredSuccGraphAddEdge(g, 3, 4, NULL);
+	cuPredSuccGraphAddEdge(g, 4, 1, NULL);
+	cuPredSuccGraphAddEdge(g, 5, 3, NULL);
+	cuPredSuccGraphAddEdge(g, 7, 8, NULL);
+	cuPredSuccGraphAddEdge(g, 8, 7, NULL);
+
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+	int loopsByLength[10] = {0};
+	int* loopsByLengthPtr = loopsByLength;
+	cuInitVarArgsOnStack(va, loopsByLengthPtr);
+
+	assert(cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_alwaysAccept, pool, countLoopsByLength, va) == 6);
+	assert(loopsByLength[2] == 2);
+	assert(loopsByLength[3] == 1);
+	assert(loopsByLength[4] == 2);
+	assert(loopsByLength[5] == 1);
+
+	assert(cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_alwaysAccept) == 6);
+	assert(cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_alwaysAccept, pool, NULL, NULL, 3) == 4);
+	assert(cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_alwaysAccept, pool, NULL, NULL, 0, 3) == 3);
+	assert(cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_alwaysAccept, NULL, NULL, NULL, 3, 4) == 3);
+	assert(cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_alwaysAccept, pool, NULL, NULL, 0, 0, 2) == 2);
+	assert(cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_alwaysAccept, pool, stopAtFirstLoop) == 1);
+	//without 2->0 only the loops 1 2, 7 8, 1 2 3 4 and 1 2 5 3 4 are left
+	assert(cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_no2To0, pool) == 4);
+	//a snapshot can be shared among several enumerations
+	csr_graph* csr = cuPredSuccGraphFreeze(g);
+	assert(cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_alwaysAccept, pool, NULL, NULL, 0, 0, 0, csr) == 6);
+	assert(cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_no2To0, pool, NULL, NULL, 0, 0, 0, csr) == 4);
+	cuCSRGraphDestroy(csr, NULL);
+
+	cuParallelThreadPoolDestroy(pool, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+///complete graph: the loops with k nodes are n!/(k*(n-k)!)
+void testSimpleLoopComputer06(CuTest* tc) {
+	const int vertices = 7;
+	PredSuccGraph* g = cuPredSuccGraphNew();
+	for (int i=0; i<vertices; i++) {
+		cuPredSuccGraphAddNodeInGraphById(g, i, NULL);
+	}
+	for (int i=0; i<vertices; i++) {
+		for (int j=0; j<vertices; j++) {
+			if (i != j) {
+				cuPredSuccGraphAddEdge(g, i, j, NULL);
+			}
+		}
+	}
+
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+	int loopsByLength[vertices + 1];
+	for (int i=0; i<=vertices; i++) {
+		loopsByLength[i] = 0;
+	}
+	int* loopsByLengthPtr = loopsByLength;
+	cuInitVarArgsOnStack(va, loopsByLengthPtr);
+
+	assert(cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_alwaysAccept, pool, countLoopsByLength, va) == 2365);
+	assert(loopsByLength[2] == 21);
+	assert(loopsByLength[3] == 70);
+	assert(loopsByLength[4] == 210);
+	assert(loopsByLength[5] == 504);
+	assert(loopsByLength[6] == 840);
+	assert(loopsByLength[7] == 720);
+	assert(cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_alwaysAccept, NULL) == 2365);
+	assert(cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_alwaysAccept, pool, NULL, NULL, 0, 4) == 301);
+	assert(cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_alwaysAccept, pool, NULL, NULL, 0, 0, 1000) == 1000);
+
+	//a self loop is a loop as well
+	cuPredSuccGraphAddEdge(g, 3, 3, NULL);
+	assert(cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_alwaysAccept, pool) == 2366);
+
+	cuParallelThreadPoolDestroy(pool, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+///same loops of ::cuJohnsonSupportComputeSimpleLoops
+void testSimpleLoopComputer07(CuTest* tc) {
+	srand(0);
+	const int vertices = 40;
+	PredSuccGraph* g = cuPredSuccGraphNew();
+	johnson_support* support = cuJohnsonSupportNew();
+	for (int i=0; i<vertices; i++) {
+		cuPredSuccGraphAddNodeInGraphById(g, i, NULL);
+	}
+	for (int i=0; i<2*vertices; i++) {
+		int source = rand() % vertices;
+		int sink = rand() % vertices;
+		if (source != sink && !cuPredSuccGraphContainsEdgeInGraph(g, source, sink)) {
+			cuPredSuccGraphAddEdge(g, source, sink, NULL);
+		}
+	}
+
+	loop_list* simpleLoops = cuJohnsonSupportComputeSimpleLoops(support, g, edge_traverser_alwaysAccept);
+	assert(cuListGetSize(simpleLoops) > 0);
+
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+	assert(cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_alwaysAccept, NULL) == cuListGetSize(simpleLoops));
+	assert(cuSimpleLoopComputerParallelVisitLoops(g, edge_traverser_alwaysAccept, pool) == cuListGetSize(simpleLoops));
+
+	cuParallelThreadPoolDestroy(pool, NULL);
+	cuListDestroyWithElement(simpleLoops, NULL);
+	cuJohnsonSupportDestroy(support, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
 CuSuite* CuSimpleLoopComputerSuite() {
 	CuSuite* suite = CuSuiteNew();
 
@@ -241,6 +391,9 @@ CuSuite* CuSimpleLoopComputerSuite() {
 	//	SUITE_ADD_TEST(suite, testSimpleLoopComputer02);
 	//	SUITE_ADD_TEST(suite, testSimpleLoopComputer03);
 	SUITE_ADD_TEST(suite, testSimpleLoopComputer04);
+	SUITE_ADD_TEST(suite, testSimpleLoopComputer05);
+	SUITE_ADD_TEST(suite, testSimpleLoopComputer06);
+	SUITE_ADD_TEST(suite, testSimpleLoopComputer07);
 
 
 	return suite;
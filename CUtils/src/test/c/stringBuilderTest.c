@@ -10,6 +10,9 @@
 #include "CuTest.h"
 #include "log.h"
 #include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
 
 void testStringBuilder01(CuTest* tc) {
 	string_builder* sb = cuStringBulilderNew(NULL, 3);
@@ -63,6 +66,93 @@ void testStringBuilder05(CuTest* tc) {
 	cuStringBulilderDestroy(sb, NULL);
 }
 
+///templates longer than BUFFER_SIZE and lots of appends
+void testStringBuilder06(CuTest* tc) {
+	string_builder* sb = cuStringBulilderNew(NULL, 3);
+	char* big = malloc(3 * BUFFER_SIZE + 1);
+	memset(big, 'a', 3 * BUFFER_SIZE);
+	big[3 * BUFFER_SIZE] = '\0';
+
+	cuStringBuilderAppendTemplate(sb, "<%s>", big);
+	assert(cuStringBuilderGetLength(sb) == 3 * BUFFER_SIZE + 2);
+	assert(strncmp(cuStringBuilderGetString(sb) + 1, big, 3 * BUFFER_SIZE) == 0);
+
+	cuStringBuilderClear(sb);
+	for (int i=0; i<10000; i++) {
+		cuStringBuilderAppendChar(sb, 'a' + (i % 26));
+	}
+	assert(cuStringBuilderGetLength(sb) == 10000);
+	assert(strlen(cuStringBuilderGetString(sb)) == 10000);
+	assert(cuStringBuilderGetString(sb)[9999] == 'a' + (9999 % 26));
+
+	free(big);
+	cuStringBulilderDestroy(sb, NULL);
+}
+
+///test cuStringBuilderReserve, cuStringBuilderAppendStringWithLength and cuStringBuilderDetachString
+void testStringBuilder07(CuTest* tc) {
+	string_builder* sb = cuStringBulilderNew("x=");
+	cuStringBuilderReserve(sb, 1000);
+	cuStringBuilderAppendStringWithLength(sb, "12345", 3);
+	cuStringBuilderAppendInt(sb, 4);
+	assert(cuStringBuilderGetLength(sb) == 6);
+
+	char* str = cuStringBuilderDetachString(sb);
+	assert(strcmp(str, "x=1234") == 0);
+	assert(cuStringBuilderGetLength(sb) == 0);
+	assert(strcmp(cuStringBuilderGetString(sb), "") == 0);
+
+	cuStringBuilderAppendString(sb, "again");
+	assert(strcmp(cuStringBuilderGetString(sb), "again") == 0);
+
+	char* empty = cuStringBuilderDetachString(sb);
+	free(empty);
+	empty = cuStringBuilderDetachString(sb);
+	assert(strcmp(empty, "") == 0);
+
+	free(empty);
+	free(str);
+	cuStringBulilderDestroy(sb, NULL);
+}
+
+///rope builder
+void testStringBuilder08(CuTest* tc) {
+	string_builder* sb = cuStringBuilderNewRope(16);
+	char expected[1000];
+	int length = 0;
+	for (int i=0; i<100; i++) {
+		cuStringBuilderAppendTemplate(sb, "%d,", i);
+		length += sprintf(&expected[length], "%d,", i);
+	}
+	assert(cuStringBuilderGetLength(sb) == length);
+
+	FILE* f = tmpfile();
+	assert(cuStringBuilderWriteToFileDescriptor(sb, fileno(f)));
+	cuStringBuilderAppendString(sb, "end");
+	assert(cuStringBuilderWriteToFile(sb, f));
+	fflush(f);
+
+	char actual[1000];
+	rewind(f);
+	size_t read = fread(actual, sizeof(char), 1000 - 1, f);
+	actual[read] = '\0';
+	fclose(f);
+	assert(read == 2 * length + 3);
+	assert(strncmp(actual, expected, length) == 0);
+	assert(strncmp(actual + length, expected, length) == 0);
+	assert(strcmp(actual + 2 * length, "end") == 0);
+
+	strcat(expected, "end");
+	assert(strcmp(cuStringBuilderGetString(sb), expected) == 0);
+	cuStringBuilderAppendString(sb, "!");
+	strcat(expected, "!");
+	assert(strcmp(cuStringBuilderGetString(sb), expected) == 0);
+
+	cuStringBuilderClear(sb);
+	assert(strcmp(cuStringBuilderGetString(sb), "") == 0);
+	cuStringBulilderDestroy(sb, NULL);
+}
+
 CuSuite* CuStringBuilderSuite() {
 	CuSuite* suite = CuSuiteNew();
 
@@ -71,6 +161,9 @@ CuSuite* CuStringBuilderSuite() {
 	SUITE_ADD_TEST(suite, testStringBuilder03);
 	SUITE_ADD_TEST(suite, testStringBuilder04);
 	SUITE_ADD_TEST(suite, testStringBuilder05);
+	SUITE_ADD_TEST(suite, testStringBuilder06);
+	SUITE_ADD_TEST(suite, testStringBuilder07);
+	SUITE_ADD_TEST(suite, testStringBuilder08);
 
 	return suite;
 }
@@ -10,6 +10,8 @@
 #include "topologicalOrder.h"
 #include <assert.h>
 #include "log.h"
+#include "hashtable.h"
+#include "multithreading.h"
 
 void testCormen01(CuTest* tc) {
 	PredSuccGraph* g = cuPredSuccGraphNew();
@@ -113,11 +115,180 @@ void testCormen02(CuTest* tc) {
 	cuPredSuccGraphDestroyWithElements(g, NULL);
 }
 
+/**
+ * @return true if every edge of @c g goes from a node to another one coming after it in @c output
+ */
+static bool isTopologicalOrder(const PredSuccGraph* g, NodeList* output) {
+	if (cuListGetSize(output) != cuPredSuccGraphGetVertexNumber(g)) {
+		return false;
+	}
+	int_ht* positions = cuHTNew();
+	int i = 0;
+	CU_ITERATE_OVER_LIST(output, cell, n, Node*) {
+		//positions start from 1, so they cannot be confused with NULL
+		cuHTAddItem(positions, n->id, CU_CAST_INT2PTR(i + 1));
+		i++;
+	}
+	bool result = true;
+	CU_ITERATE_OVER_HT_VALUES(g->nodes, n, Node*) {
+		CU_ITERATE_OVER_HT_VALUES(n->successors, e, Edge*) {
+			if (CU_CAST_PTR2INT(cuHTGetItem(positions, e->source->id)) >= CU_CAST_PTR2INT(cuHTGetItem(positions, e->sink->id))) {
+				result = false;
+			}
+		}
+	}
+	cuHTDestroy(positions, NULL);
+	return result;
+}
+
+void testKahn01(CuTest* tc) {
+	PredSuccGraph* g = cuPredSuccGraphNew();
+
+	cuPredSuccGraphAddNodeInGraphById(g, 0, NULL);
+	cuPredSuccGraphAddNodeInGraphById(g, 1, NULL);
+	cuPredSuccGraphAddNodeInGraphById(g, 2, NULL);
+	cuPredSuccGraphAddNodeInGraphById(g, 3, NULL);
+	cuPredSuccGraphAddNodeInGraphById(g, 4, NULL);
+
+	cuPredSuccGraphAddEdge(g, 3, 2, NULL);
+	cuPredSuccGraphAddEdge(g, 2, 4, NULL);
+	cuPredSuccGraphAddEdge(g, 2, 0, NULL);
+	cuPredSuccGraphAddEdge(g, 3, 1, NULL);
+
+	NodeList* output = cuListNew();
+	cuStaticTopologicalOrderDoWith(TO_KAHN, g, output);
+
+	assert(isTopologicalOrder(g, output));
+	assert(((Node*)cuListGetNthItem(output, 0, Node*))->id == 3);
+
+	cuListDestroy(output, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+void testParallelLevels01(CuTest* tc) {
+	PredSuccGraph* g = cuPredSuccGraphNew();
+
+	cuPredSuccGraphAddNodeInGraphById(g, 0, NULL);
+	cuPredSuccGraphAddNodeInGraphById(g, 1, NULL);
+	cuPredSuccGraphAddNodeInGraphById(g, 2, NULL);
+	cuPredSuccGraphAddNodeInGraphById(g, 3, NULL);
+	cuPredSuccGraphAddNodeInGraphById(g, 4, NULL);
+
+	cuPredSuccGraphAddEdge(g, 3, 2, NULL);
+	cuPredSuccGraphAddEdge(g, 2, 4, NULL);
+	cuPredSuccGraphAddEdge(g, 2, 0, NULL);
+	cuPredSuccGraphAddEdge(g, 3, 1, NULL);
+
+	list* levels = cuListNew();
+	assert(cuStaticTopologicalOrderComputeLevels(g, levels) == 3);
+
+	NodeList* level = cuListGetNthItem(levels, 0, NodeList*);
+	assert(cuListGetSize(level) == 1);
+	assert(((Node*)cuListGetNthItem(level, 0, Node*))->id == 3);
+	level = cuListGetNthItem(levels, 1, NodeList*);
+	assert(cuListGetSize(level) == 2);
+	assert(((Node*)cuListGetNthItem(level, 0, Node*))->id == 1);
+	assert(((Node*)cuListGetNthItem(level, 1, Node*))->id == 2);
+	level = cuListGetNthItem(levels, 2, NodeList*);
+	assert(cuListGetSize(level) == 2);
+	assert(((Node*)cuListGetNthItem(level, 0, Node*))->id == 0);
+	assert(((Node*)cuListGetNthItem(level, 1, Node*))->id == 4);
+
+	CU_ITERATE_OVER_LIST(levels, cell, l, NodeList*) {
+		cuListDestroy(l, NULL);
+	}
+	cuListDestroy(levels, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
+void testParallelLevels02(CuTest* tc) {
+	srand(0);
+
+	//a random DAG far larger than what Cormen implementation can handle: edges always go from lower ids to higher ones
+	const int vertices = 100000;
+	PredSuccGraph* g = cuPredSuccGraphNew();
+	for (int i=0; i<vertices; i++) {
+		cuPredSuccGraphAddNodeInGraphById(g, i, NULL);
+	}
+	for (int i=0; i<3*vertices; i++) {
+		int source = rand() % vertices;
+		int sink = source + 1 + (rand() % 50);
+		if (sink < vertices && !cuPredSuccGraphContainsEdgeInGraph(g, source, sink)) {
+			cuPredSuccGraphAddEdge(g, source, sink, NULL);
+		}
+	}
+
+	NodeList* kahn = cuListNew();
+	cuStaticTopologicalOrderDoWith(TO_KAHN, g, kahn);
+	assert(isTopologicalOrder(g, kahn));
+
+	cu_parallel_thread_pool* pool = cuParallelThreadPoolNew(4);
+	NodeList* sequential = cuListNew();
+	NodeList* parallel = cuListNew();
+	cuStaticTopologicalOrderDoWith(TO_PARALLEL_LEVELS, g, sequential);
+	cuStaticTopologicalOrderDoWith(TO_PARALLEL_LEVELS, g, parallel, pool);
+	assert(isTopologicalOrder(g, parallel));
+	//an existing snapshot gives the same order
+	csr_graph* csr = cuPredSuccGraphFreeze(g);
+	NodeList* fromSnapshot = cuListNew();
+	cuStaticTopologicalOrderDoWith(TO_PARALLEL_LEVELS, g, fromSnapshot, pool, csr);
+	assert(cuListGetSize(fromSnapshot) == cuListGetSize(parallel));
+	list_cell* snapshotCell = _cuListGetHeadCell(fromSnapshot);
+	CU_ITERATE_OVER_LIST(parallel, cell, n, Node*) {
+		assert(_cuListGetPayloadOfCell(snapshotCell) == n);
+		snapshotCell = _cuListGetNextOfCell(snapshotCell);
+	}
+	cuListDestroy(fromSnapshot, NULL);
+	//the order does not depend on the workers
+	assert(cuListGetSize(sequential) == cuListGetSize(parallel));
+	list_cell* expectedCell = _cuListGetHeadCell(sequential);
+	CU_ITERATE_OVER_LIST(parallel, cell, n, Node*) {
+		assert(_cuListGetPayloadOfCell(expectedCell) == n);
+		expectedCell = _cuListGetNextOfCell(expectedCell);
+	}
+
+	//no node can reach another one in the same level
+	list* levels = cuListNew();
+	int levelsNumber = cuStaticTopologicalOrderComputeLevels(g, levels, pool, csr);
+	cuCSRGraphDestroy(csr, NULL);
+	assert(levelsNumber == cuListGetSize(levels));
+	int_ht* levelOfNode = cuHTNew();
+	int l = 0;
+	int nodes = 0;
+	CU_ITERATE_OVER_LIST(levels, cell, level, NodeList*) {
+		CU_ITERATE_OVER_LIST(level, cell2, n, Node*) {
+			cuHTAddItem(levelOfNode, n->id, CU_CAST_INT2PTR(l + 1));
+			nodes++;
+		}
+		l++;
+	}
+	assert(nodes == vertices);
+	CU_ITERATE_OVER_HT_VALUES(g->nodes, n, Node*) {
+		CU_ITERATE_OVER_HT_VALUES(n->successors, e, Edge*) {
+			assert(CU_CAST_PTR2INT(cuHTGetItem(levelOfNode, e->source->id)) < CU_CAST_PTR2INT(cuHTGetItem(levelOfNode, e->sink->id)));
+		}
+	}
+
+	CU_ITERATE_OVER_LIST(levels, cell, level, NodeList*) {
+		cuListDestroy(level, NULL);
+	}
+	cuListDestroy(levels, NULL);
+	cuHTDestroy(levelOfNode, NULL);
+	cuListDestroy(kahn, NULL);
+	cuListDestroy(sequential, NULL);
+	cuListDestroy(parallel, NULL);
+	cuParallelThreadPoolDestroy(pool, NULL);
+	cuPredSuccGraphDestroyWithElements(g, NULL);
+}
+
 CuSuite* CuTopologicalOrderSuite() {
 	CuSuite* suite = CuSuiteNew();
 
 	SUITE_ADD_TEST(suite, testCormen01);
 	SUITE_ADD_TEST(suite, testCormen02);
+	SUITE_ADD_TEST(suite, testKahn01);
+	SUITE_ADD_TEST(suite, testParallelLevels01);
+	SUITE_ADD_TEST(suite, testParallelLevels02);
 
 	return suite;
 }
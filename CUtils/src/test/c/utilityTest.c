@@ -116,6 +116,20 @@ void test_parseRangeInt_07(CuTest* tc) {
 	assert(b == 3);
 }
 
+void test_mallocArray_01(CuTest* tc) {
+	//an empty array is still a valid pointer
+	int* empty = cuUtilsMallocArray(0, sizeof(int));
+	assert(empty != NULL);
+	free(empty);
+
+	int* array = cuUtilsMallocArray(100, sizeof(int));
+	for (int i=0; i<100; i++) {
+		array[i] = i;
+	}
+	assert(array[99] == 99);
+	free(array);
+}
+
 
 
 CuSuite* CuUtilitySuite() {
@@ -128,6 +142,7 @@ CuSuite* CuUtilitySuite() {
 	SUITE_ADD_TEST(suite, test_parseRangeInt_05);
 	SUITE_ADD_TEST(suite, test_parseRangeInt_06);
 	SUITE_ADD_TEST(suite, test_parseRangeInt_07);
+	SUITE_ADD_TEST(suite, test_mallocArray_01);
 
 	return suite;
 }